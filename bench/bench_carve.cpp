@@ -0,0 +1,99 @@
+// Digital Workshop - Benchmarks: heightmap rasterization, toolpath generation and G-code output
+
+#include <benchmark/benchmark.h>
+
+#include "bench_datasets.h"
+#include "core/carve/gcode_export.h"
+#include "core/carve/heightmap.h"
+#include "core/carve/toolpath_generator.h"
+#include "core/cnc/cnc_tool.h"
+
+using namespace dw;
+
+namespace {
+
+carve::Heightmap buildHeightmap(const bench::TerrainMesh& mesh, f32 resolutionMm) {
+    carve::HeightmapConfig config;
+    config.resolutionMm = resolutionMm;
+    carve::Heightmap heightmap;
+    heightmap.build(mesh.vertices, mesh.indices, mesh.boundsMin, mesh.boundsMax, config);
+    return heightmap;
+}
+
+VtdbToolGeometry makeTool(VtdbToolType type) {
+    VtdbToolGeometry tool;
+    tool.tool_type = type;
+    tool.diameter = 3.175;
+    tool.included_angle = 60.0;
+    tool.tip_radius = type == VtdbToolType::BallNose ? tool.diameter * 0.5 : 0.0;
+    return tool;
+}
+
+} // namespace
+
+// range(0): triangles, range(1): grid resolution in hundredths of a mm
+static void BM_HeightmapBuild(benchmark::State& state) {
+    const auto mesh = bench::makeTerrain(static_cast<usize>(state.range(0)));
+    const f32 resolution = static_cast<f32>(state.range(1)) / 100.0f;
+
+    i64 cells = 0;
+    for (auto _ : state) {
+        auto heightmap = buildHeightmap(mesh, resolution);
+        cells = static_cast<i64>(heightmap.cols()) * heightmap.rows();
+        benchmark::DoNotOptimize(heightmap.maxZ());
+    }
+    state.counters["cells"] = static_cast<f64>(cells);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_HeightmapBuild)
+    ->Args({100000, 25})
+    ->Args({1000000, 25})
+    ->Args({250000, 10})
+    ->Unit(benchmark::kMillisecond);
+
+// range(0): VtdbToolType
+static void BM_ToolpathFinishing(benchmark::State& state) {
+    const auto heightmap = buildHeightmap(bench::makeTerrain(250000), 0.25f);
+    const auto tool = makeTool(static_cast<VtdbToolType>(state.range(0)));
+    carve::ToolpathConfig config;
+    config.axis = carve::ScanAxis::XThenY;
+
+    i64 points = 0;
+    for (auto _ : state) {
+        carve::ToolpathGenerator generator;
+        auto path =
+            generator.generateFinishing(heightmap, config, static_cast<f32>(tool.diameter), tool);
+        points = static_cast<i64>(path.points.size());
+        benchmark::DoNotOptimize(path.points.data());
+    }
+    state.counters["points"] = static_cast<f64>(points);
+    state.SetItemsProcessed(state.iterations() * points);
+}
+BENCHMARK(BM_ToolpathFinishing)
+    ->ArgName("tool")
+    ->Arg(static_cast<int>(VtdbToolType::VBit))
+    ->Arg(static_cast<int>(VtdbToolType::BallNose))
+    ->Arg(static_cast<int>(VtdbToolType::EndMill))
+    ->Unit(benchmark::kMillisecond);
+
+// Finishing path on the same terrain, formatted to G-code text in memory
+static void BM_GcodeGenerate(benchmark::State& state) {
+    const auto heightmap = buildHeightmap(bench::makeTerrain(250000), 0.25f);
+    const auto tool = makeTool(VtdbToolType::BallNose);
+    carve::ToolpathConfig config;
+    config.axis = carve::ScanAxis::XThenY;
+    carve::ToolpathGenerator generator;
+    carve::MultiPassToolpath toolpath;
+    toolpath.finishing =
+        generator.generateFinishing(heightmap, config, static_cast<f32>(tool.diameter), tool);
+
+    usize bytes = 0;
+    for (auto _ : state) {
+        const std::string gcode = carve::generateGcode(toolpath, config, "terrain", "ball");
+        bytes = gcode.size();
+        benchmark::DoNotOptimize(gcode.data());
+    }
+    state.counters["points"] = static_cast<f64>(toolpath.finishing.points.size());
+    state.SetBytesProcessed(state.iterations() * static_cast<i64>(bytes));
+}
+BENCHMARK(BM_GcodeGenerate)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,88 @@
+// Digital Workshop - Benchmarks: end-to-end G-code streaming
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <sstream>
+#include <thread>
+
+#include "bench_datasets.h"
+#include "core/cnc/cnc_controller.h"
+#include "core/cnc/grbl_emulator.h"
+
+using namespace dw;
+
+namespace {
+
+template <typename Done>
+bool waitFor(Done done, int timeoutMs) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (!done()) {
+        if (std::chrono::steady_clock::now() >= deadline)
+            return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+} // namespace
+
+// Streams a raster carve through CncController into the GRBL emulator over a
+// pty (arg 0) or TCP (arg 1). Motion runs 25x real time to keep runs short;
+// at that speed the job is still machine-limited, so wall time tracks the
+// emulated motion and starved_ms (time the planner sat empty mid-job) is the
+// number that exposes a host falling behind.
+static void BM_GrblStream(benchmark::State& state) {
+    const bool tcp = state.range(0) != 0;
+
+    std::vector<std::string> lines;
+    std::istringstream program(bench::makeGCode(300));
+    for (std::string line; std::getline(program, line);)
+        lines.push_back(line);
+
+    GrblEmulatorConfig config;
+    config.timeScale = 25.0f;
+
+    GrblEmulatorStats stats;
+    f64 seconds = 0.0;
+    for (auto _ : state) {
+        GrblEmulator emulator(config);
+        CncController cnc(nullptr);
+        bool connected = false;
+        if (tcp) {
+            const int port = emulator.listenTcp();
+            connected = port > 0 && cnc.connectTcp("127.0.0.1", port);
+        } else {
+            const std::string device = emulator.openPty();
+            connected = !device.empty() && cnc.connect(device, config.baudRate);
+        }
+        if (!connected || !waitFor([&cnc]() { return cnc.isConnected(); }, 3000)) {
+            state.SkipWithError("could not connect to the emulator");
+            break;
+        }
+
+        emulator.resetStats();
+        const auto start = std::chrono::steady_clock::now();
+        cnc.startStream(lines);
+        // Done once every line is acknowledged and the planner has run dry
+        const bool finished = waitFor([&cnc]() { return !cnc.isStreaming(); }, 30000) &&
+                              waitFor([&emulator]() { return emulator.isIdle(); }, 30000);
+        const f64 elapsed = std::chrono::duration<f64>(std::chrono::steady_clock::now() - start).count();
+        state.SetIterationTime(elapsed);
+        stats = emulator.stats();
+        seconds += elapsed;
+        cnc.disconnect();
+        if (!finished || cnc.streamProgress().errorCount > 0) {
+            state.SkipWithError("stream did not complete");
+            break;
+        }
+    }
+
+    const auto iterations = static_cast<f64>(std::max<benchmark::IterationCount>(state.iterations(), 1));
+    state.counters["lines_per_s"] = seconds > 0.0 ? static_cast<f64>(lines.size()) * iterations / seconds : 0.0;
+    state.counters["starved_ms"] = stats.starvedSeconds * 1000.0 / static_cast<f64>(config.timeScale);
+    state.counters["starvations"] = stats.starvations;
+    state.counters["rx_overflow"] = static_cast<f64>(stats.rxOverflowBytes);
+    state.counters["peak_rx"] = static_cast<f64>(stats.peakRxUsed);
+}
+BENCHMARK(BM_GrblStream)->Arg(0)->Arg(1)->Iterations(1)->UseManualTime()->Unit(benchmark::kMillisecond);
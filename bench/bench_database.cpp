@@ -0,0 +1,118 @@
+// Digital Workshop - Benchmarks: model repository on an in-memory database
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+
+#include "bench_datasets.h"
+#include "core/database/database.h"
+#include "core/database/model_repository.h"
+#include "core/database/schema.h"
+
+using namespace dw;
+
+namespace {
+
+// Fresh in-memory library with `rows` models
+struct Library {
+    Database db;
+    std::unique_ptr<ModelRepository> repo;
+
+    bool open(usize rows) {
+        if (!db.open(":memory:") || !Schema::initialize(db))
+            return false;
+        repo = std::make_unique<ModelRepository>(db);
+        Transaction txn(db);
+        for (usize i = 0; i < rows; ++i)
+            if (!repo->insert(bench::makeModelRecord(i)))
+                return false;
+        return txn.commit();
+    }
+};
+
+} // namespace
+
+// Batch insert inside one transaction, as the import pipeline does
+static void BM_ModelRepositoryInsert(benchmark::State& state) {
+    const auto rows = static_cast<usize>(state.range(0));
+    std::vector<ModelRecord> records;
+    records.reserve(rows);
+    for (usize i = 0; i < rows; ++i)
+        records.push_back(bench::makeModelRecord(i));
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        Library library;
+        if (!library.open(0)) {
+            state.SkipWithError("failed to open database");
+            break;
+        }
+        state.ResumeTiming();
+
+        Transaction txn(library.db);
+        for (const auto& record : records)
+            benchmark::DoNotOptimize(library.repo->insert(record));
+        if (!txn.commit()) {
+            state.SkipWithError("commit failed");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ModelRepositoryInsert)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+static void BM_ModelRepositoryFindByHash(benchmark::State& state) {
+    const auto rows = static_cast<usize>(state.range(0));
+    Library library;
+    if (!library.open(rows)) {
+        state.SkipWithError("failed to populate database");
+        return;
+    }
+
+    usize i = 0;
+    for (auto _ : state) {
+        auto hash = bench::makeModelRecord(i++ % rows).hash;
+        benchmark::DoNotOptimize(library.repo->findByHash(hash));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ModelRepositoryFindByHash)->Arg(10000);
+
+// Walks the whole library in browse order, one keyset page at a time
+static void BM_ModelRepositoryFindPage(benchmark::State& state) {
+    const auto rows = static_cast<usize>(state.range(0));
+    Library library;
+    if (!library.open(rows)) {
+        state.SkipWithError("failed to populate database");
+        return;
+    }
+
+    for (auto _ : state) {
+        ModelPageQuery query;
+        usize seen = 0;
+        for (;;) {
+            auto page = library.repo->findPage(query);
+            seen += page.rows.size();
+            if (!page.next)
+                break;
+            query.after = page.next;
+        }
+        benchmark::DoNotOptimize(seen);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ModelRepositoryFindPage)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+static void BM_ModelRepositorySearchFTS(benchmark::State& state) {
+    const auto rows = static_cast<usize>(state.range(0));
+    Library library;
+    if (!library.open(rows)) {
+        state.SkipWithError("failed to populate database");
+        return;
+    }
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(library.repo->searchFTS("model_12*"));
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ModelRepositorySearchFTS)->Arg(10000);
@@ -0,0 +1,251 @@
+#include "bench_datasets.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+namespace dw {
+namespace bench {
+
+namespace {
+
+// Terrain height at grid coordinate (x, y): smooth relief plus small noise
+f32 terrainZ(f32 x, f32 y, Rng& rng) {
+    return 6.0f + std::sin(x * 0.07f) * std::cos(y * 0.05f) * 4.0f +
+           std::sin((x + y) * 0.21f) * 0.8f + rng.uniform(-0.05f, 0.05f);
+}
+
+// Grid side length for about `triangles` triangles (two per cell)
+u32 gridCells(usize triangles) {
+    auto n = static_cast<u32>(std::sqrt(static_cast<f64>(triangles) / 2.0));
+    return n > 0 ? n : 1;
+}
+
+// Heights for an (n+1)^2 vertex grid at 0.5 mm spacing
+std::vector<f32> terrainHeights(u32 n, u64 seed) {
+    Rng rng(seed);
+    std::vector<f32> heights(static_cast<usize>(n + 1) * (n + 1));
+    for (u32 y = 0; y <= n; ++y)
+        for (u32 x = 0; x <= n; ++x)
+            heights[static_cast<usize>(y) * (n + 1) + x] =
+                terrainZ(static_cast<f32>(x), static_cast<f32>(y), rng);
+    return heights;
+}
+
+constexpr f32 kGridSpacingMm = 0.5f;
+
+// Calls fn(a, b, c) for the two triangles of every grid cell
+template <typename Fn> void forEachTriangle(u32 n, const std::vector<f32>& heights, Fn&& fn) {
+    auto at = [&](u32 x, u32 y) {
+        return Vec3{static_cast<f32>(x) * kGridSpacingMm, static_cast<f32>(y) * kGridSpacingMm,
+                    heights[static_cast<usize>(y) * (n + 1) + x]};
+    };
+    for (u32 y = 0; y < n; ++y) {
+        for (u32 x = 0; x < n; ++x) {
+            fn(at(x, y), at(x + 1, y), at(x + 1, y + 1));
+            fn(at(x, y), at(x + 1, y + 1), at(x, y + 1));
+        }
+    }
+}
+
+Vec3 faceNormal(const Vec3& a, const Vec3& b, const Vec3& c) {
+    Vec3 n = glm::cross(b - a, c - a);
+    f32 len = glm::length(n);
+    return len > 0.0f ? n / len : Vec3{0.0f, 0.0f, 1.0f};
+}
+
+// printf into `out` followed by a newline
+void appendLine(std::string& out, const char* format, ...) {
+    char buf[160];
+    va_list args;
+    va_start(args, format);
+    int n = std::vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+    if (n > 0)
+        out.append(buf, static_cast<usize>(std::min(n, static_cast<int>(sizeof(buf)) - 1)));
+    out += '\n';
+}
+
+} // namespace
+
+std::string makeGCode(usize lines, u64 seed) {
+    Rng rng(seed);
+    std::string out;
+    out.reserve(lines * 28);
+
+    appendLine(out, "(Synthetic raster carve, seed %llu)", static_cast<unsigned long long>(seed));
+    appendLine(out, "G21 G90 G17");
+    appendLine(out, "M3 S18000");
+    appendLine(out, "G0 Z5.000");
+
+    usize emitted = 4;
+    f32 y = 0.0f;
+    int pass = 0;
+    while (emitted < lines) {
+        bool forward = (pass % 2) == 0;
+        appendLine(out, "G0 X%.3f Y%.3f", forward ? 0.0 : 300.0, static_cast<f64>(y));
+        appendLine(out, "G1 Z%.3f F300", static_cast<f64>(-rng.uniform(0.5f, 3.0f)));
+        emitted += 2;
+
+        // One pass: 200 cutting moves along X with a varying depth
+        for (int i = 1; i <= 200 && emitted < lines; ++i, ++emitted) {
+            f32 x = forward ? static_cast<f32>(i) * 1.5f : 300.0f - static_cast<f32>(i) * 1.5f;
+            f32 z = -1.5f + std::sin(x * 0.05f + y * 0.1f) * 1.2f + rng.uniform(-0.02f, 0.02f);
+            if (i == 1)
+                appendLine(out, "G1 X%.3f Z%.3f F1200", static_cast<f64>(x), static_cast<f64>(z));
+            else if (i % 50 == 0)
+                appendLine(out, "G2 X%.3f Y%.3f I0.750 J0.000", static_cast<f64>(x),
+                           static_cast<f64>(y));
+            else
+                appendLine(out, "G1 X%.3f Z%.3f", static_cast<f64>(x), static_cast<f64>(z));
+        }
+        if (emitted < lines) {
+            appendLine(out, "G0 Z5.000");
+            ++emitted;
+        }
+        if (pass % 25 == 0 && emitted < lines) {
+            appendLine(out, "(pass %d)", pass);
+            ++emitted;
+        }
+        y += 0.4f;
+        ++pass;
+    }
+    appendLine(out, "M5");
+    appendLine(out, "M30");
+    return out;
+}
+
+TerrainMesh makeTerrain(usize triangles, u64 seed) {
+    u32 n = gridCells(triangles);
+    auto heights = terrainHeights(n, seed);
+
+    TerrainMesh mesh;
+    mesh.vertices.reserve(heights.size());
+    mesh.boundsMin = Vec3{0.0f, 0.0f, heights[0]};
+    const f32 extent = static_cast<f32>(n) * kGridSpacingMm;
+    mesh.boundsMax = Vec3{extent, extent, heights[0]};
+    for (u32 y = 0; y <= n; ++y) {
+        for (u32 x = 0; x <= n; ++x) {
+            f32 z = heights[static_cast<usize>(y) * (n + 1) + x];
+            mesh.vertices.emplace_back(Vec3{static_cast<f32>(x) * kGridSpacingMm,
+                                            static_cast<f32>(y) * kGridSpacingMm, z});
+            mesh.boundsMin.z = std::min(mesh.boundsMin.z, z);
+            mesh.boundsMax.z = std::max(mesh.boundsMax.z, z);
+        }
+    }
+
+    mesh.indices.reserve(static_cast<usize>(n) * n * 6);
+    for (u32 y = 0; y < n; ++y) {
+        for (u32 x = 0; x < n; ++x) {
+            u32 i0 = y * (n + 1) + x;
+            u32 i1 = i0 + 1;
+            u32 i2 = i0 + n + 2;
+            u32 i3 = i0 + n + 1;
+            mesh.indices.insert(mesh.indices.end(), {i0, i1, i2, i0, i2, i3});
+        }
+    }
+    return mesh;
+}
+
+ByteBuffer makeBinaryStl(usize triangles, u64 seed) {
+    u32 n = gridCells(triangles);
+    auto heights = terrainHeights(n, seed);
+    u32 count = n * n * 2;
+
+    ByteBuffer out(84 + static_cast<usize>(count) * 50, 0);
+    std::memcpy(out.data(), "dw_benchmarks synthetic terrain", 31);
+    std::memcpy(out.data() + 80, &count, sizeof(count));
+
+    usize offset = 84;
+    forEachTriangle(n, heights, [&](const Vec3& a, const Vec3& b, const Vec3& c) {
+        Vec3 normal = faceNormal(a, b, c);
+        const f32 floats[12] = {normal.x, normal.y, normal.z, a.x, a.y, a.z,
+                                b.x,      b.y,      b.z,      c.x, c.y, c.z};
+        std::memcpy(out.data() + offset, floats, sizeof(floats));
+        offset += 50; // 48 bytes of floats + 2-byte attribute (zero)
+    });
+    return out;
+}
+
+std::string makeAsciiStl(usize triangles, u64 seed) {
+    u32 n = gridCells(triangles);
+    auto heights = terrainHeights(n, seed);
+
+    std::string out;
+    out.reserve(static_cast<usize>(n) * n * 2 * 250);
+    out += "solid terrain\n";
+    forEachTriangle(n, heights, [&](const Vec3& a, const Vec3& b, const Vec3& c) {
+        Vec3 normal = faceNormal(a, b, c);
+        appendLine(out, "  facet normal %e %e %e", static_cast<f64>(normal.x),
+                   static_cast<f64>(normal.y), static_cast<f64>(normal.z));
+        out += "    outer loop\n";
+        for (const Vec3* v : {&a, &b, &c})
+            appendLine(out, "      vertex %e %e %e", static_cast<f64>(v->x),
+                       static_cast<f64>(v->y), static_cast<f64>(v->z));
+        out += "    endloop\n  endfacet\n";
+    });
+    out += "endsolid terrain\n";
+    return out;
+}
+
+ByteBuffer makeBytes(usize size, u64 seed) {
+    Rng rng(seed);
+    ByteBuffer out(size);
+    usize i = 0;
+    for (; i + 8 <= size; i += 8) {
+        u64 word = rng.next();
+        std::memcpy(out.data() + i, &word, 8);
+    }
+    for (; i < size; ++i)
+        out[i] = static_cast<u8>(rng.next());
+    return out;
+}
+
+std::vector<optimizer::Part> makeParts(usize count, u64 seed) {
+    Rng rng(seed);
+    std::vector<optimizer::Part> parts;
+    parts.reserve(count);
+    for (usize i = 0; i < count; ++i) {
+        // Round to 5 mm like real cut lists; many panels and a few long rails
+        f32 width = std::round(rng.uniform(60.0f, 600.0f) / 5.0f) * 5.0f;
+        f32 height = std::round(rng.uniform(40.0f, 400.0f) / 5.0f) * 5.0f;
+        if (i % 7 == 0) {
+            width = std::round(rng.uniform(1200.0f, 2300.0f) / 5.0f) * 5.0f;
+            height = std::round(rng.uniform(40.0f, 120.0f) / 5.0f) * 5.0f;
+        }
+        parts.emplace_back(static_cast<i64>(i + 1), "Part " + std::to_string(i + 1), width, height,
+                           rng.range(1, 4));
+        parts.back().canRotate = (i % 5) != 0;
+    }
+    return parts;
+}
+
+std::vector<optimizer::Sheet> makeSheets(usize count) {
+    optimizer::Sheet sheet(2440.0f, 1220.0f, 65.0f);
+    sheet.name = "8x4 Plywood";
+    return std::vector<optimizer::Sheet>(count, sheet);
+}
+
+ModelRecord makeModelRecord(usize index) {
+    Rng rng(index + 1);
+    ModelRecord rec;
+    char hash[17];
+    std::snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(rng.next()));
+    rec.hash = hash;
+    rec.name = "model_" + std::to_string(index);
+    rec.filePath = "/library/models/" + rec.name + ".stl";
+    rec.fileFormat = (index % 3) == 0 ? "obj" : "stl";
+    rec.fileSize = 1024 + rng.next() % (64u << 20);
+    rec.triangleCount = static_cast<u32>(100 + rng.next() % 2000000);
+    rec.vertexCount = rec.triangleCount / 2 + 2;
+    rec.boundsMin = Vec3{0.0f};
+    rec.boundsMax = Vec3{rng.uniform(10.0f, 300.0f), rng.uniform(10.0f, 300.0f),
+                         rng.uniform(5.0f, 80.0f)};
+    rec.tags = {index % 2 ? "relief" : "sign", "batch" + std::to_string(index % 10)};
+    return rec;
+}
+
+} // namespace bench
+} // namespace dw
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "core/database/model_repository.h"
+#include "core/mesh/vertex.h"
+#include "core/optimizer/sheet.h"
+#include "core/types.h"
+
+// Deterministic synthetic datasets for dw_benchmarks.
+//
+// Every generator is a pure function of its size and seed, using a local
+// splitmix64 stream rather than <random> distributions (whose output differs
+// between standard libraries), so results stay comparable across machines
+// and against the stored baseline.
+
+namespace dw {
+namespace bench {
+
+// splitmix64: tiny, fast, identical everywhere
+class Rng {
+  public:
+    explicit Rng(u64 seed) : m_state(seed) {}
+
+    u64 next() {
+        u64 z = (m_state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // Uniform in [lo, hi)
+    f32 uniform(f32 lo, f32 hi) {
+        return lo + static_cast<f32>(static_cast<f64>(next() >> 40) / 16777216.0) * (hi - lo);
+    }
+
+    // Uniform in [lo, hi]
+    int range(int lo, int hi) {
+        return lo + static_cast<int>(next() % static_cast<u64>(hi - lo + 1));
+    }
+
+  private:
+    u64 m_state;
+};
+
+// Carving-style program of about `lines` lines: raster passes of G1 moves with
+// feeds and rapids between passes, plus occasional arcs and comments
+std::string makeGCode(usize lines, u64 seed = 1);
+
+// Welded height-field terrain with about `triangles` triangles
+struct TerrainMesh {
+    std::vector<Vertex> vertices;
+    std::vector<u32> indices;
+    Vec3 boundsMin{0.0f};
+    Vec3 boundsMax{0.0f};
+};
+TerrainMesh makeTerrain(usize triangles, u64 seed = 1);
+
+// Unwelded triangle soup of the same terrain, as STL files store it
+ByteBuffer makeBinaryStl(usize triangles, u64 seed = 1);
+std::string makeAsciiStl(usize triangles, u64 seed = 1);
+
+// Random bytes for hashing
+ByteBuffer makeBytes(usize size, u64 seed = 1);
+
+// Cabinet-style cut list: `count` distinct parts, 1-4 of each
+std::vector<optimizer::Part> makeParts(usize count, u64 seed = 1);
+
+// `count` full 2440 x 1220 mm sheets (the optimizers use one entry per sheet)
+std::vector<optimizer::Sheet> makeSheets(usize count);
+
+// Plausible library row; hash and name are unique per index
+ModelRecord makeModelRecord(usize index);
+
+} // namespace bench
+} // namespace dw
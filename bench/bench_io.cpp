@@ -0,0 +1,70 @@
+// Digital Workshop - Benchmarks: G-code parsing, STL loading, hashing
+
+#include <benchmark/benchmark.h>
+
+#include "bench_datasets.h"
+#include "core/gcode/gcode_parser.h"
+#include "core/loaders/stl_loader.h"
+#include "core/mesh/hash.h"
+
+using namespace dw;
+
+static void BM_GCodeParse(benchmark::State& state) {
+    const auto lines = static_cast<usize>(state.range(0));
+    const std::string program = bench::makeGCode(lines);
+
+    for (auto _ : state) {
+        gcode::Parser parser;
+        auto parsed = parser.parse(program);
+        benchmark::DoNotOptimize(parsed.commands.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * static_cast<i64>(program.size()));
+}
+BENCHMARK(BM_GCodeParse)->Arg(10000)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_STLLoadBinary(benchmark::State& state) {
+    const ByteBuffer data = bench::makeBinaryStl(static_cast<usize>(state.range(0)));
+
+    for (auto _ : state) {
+        STLLoader loader;
+        auto result = loader.loadFromBuffer(data);
+        if (!result) {
+            state.SkipWithError(result.error.c_str());
+            break;
+        }
+        benchmark::DoNotOptimize(result.mesh.get());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * static_cast<i64>(data.size()));
+}
+BENCHMARK(BM_STLLoadBinary)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_STLLoadAscii(benchmark::State& state) {
+    const std::string text = bench::makeAsciiStl(static_cast<usize>(state.range(0)));
+    const ByteBuffer data(text.begin(), text.end());
+
+    for (auto _ : state) {
+        STLLoader loader;
+        auto result = loader.loadFromBuffer(data);
+        if (!result) {
+            state.SkipWithError(result.error.c_str());
+            break;
+        }
+        benchmark::DoNotOptimize(result.mesh.get());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * static_cast<i64>(data.size()));
+}
+BENCHMARK(BM_STLLoadAscii)->Arg(50000)->Unit(benchmark::kMillisecond);
+
+static void BM_HashComputeBuffer(benchmark::State& state) {
+    const ByteBuffer data = bench::makeBytes(static_cast<usize>(state.range(0)));
+
+    for (auto _ : state) {
+        auto digest = hash::computeBuffer(data);
+        benchmark::DoNotOptimize(digest.data());
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_HashComputeBuffer)->Arg(4 << 10)->Arg(1 << 20)->Arg(64 << 20);
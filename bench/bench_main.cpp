@@ -0,0 +1,35 @@
+// Digital Workshop - Performance benchmark suite
+//
+// Google Benchmark driver for the hot paths: G-code parsing, STL loading,
+// hashing, heightmap rasterization, toolpath generation, cut list
+// optimization, the model repository and G-code streaming to an emulated
+// GRBL controller. Inputs come from the deterministic generators in
+// bench_datasets.h, so runs are comparable over time.
+//
+//   dw_benchmarks [--benchmark_filter=REGEX] [--benchmark_repetitions=N]
+//                 [--benchmark_out=results.json --benchmark_out_format=json]
+//
+// Compare a run against the stored baseline (exit code 1 on regression; the
+// first Release run on a machine records the baseline instead):
+//
+//   python3 bench/compare_benchmarks.py bench/baseline.json results.json
+//
+// The `bench_compare` build target does both.
+
+#include <benchmark/benchmark.h>
+
+#include "core/utils/log.h"
+#include "core/utils/trace.h"
+
+int main(int argc, char** argv) {
+    // Keep loader/database chatter and trace recording out of the timings
+    dw::log::setLevel(dw::log::Level::Error);
+    dw::trace::setEnabled(false);
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
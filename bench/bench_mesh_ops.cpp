@@ -0,0 +1,151 @@
+// Digital Workshop - Mesh operation microbenchmark
+//
+// Times the data-parallel Mesh operations on synthetic 1M and 10M triangle
+// meshes (welded grid and unwelded STL-style soup), single-threaded versus the
+// default parallel thread count.
+//
+//   dw_bench_mesh [--small] [--repeats N]
+//     --small      skip the 10M triangle meshes
+//     --repeats N  timed runs per operation (median is reported, default 5)
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "core/mesh/mesh.h"
+#include "core/mesh/mesh_kernels.h"
+#include "core/threading/parallel_for.h"
+
+using namespace dw;
+
+namespace {
+
+// Welded height-field grid with about `triangles` triangles
+Mesh makeGrid(usize triangles) {
+    const auto n = static_cast<u32>(std::sqrt(static_cast<f64>(triangles) / 2.0));
+    std::vector<Vertex> verts;
+    std::vector<u32> idx;
+    verts.reserve(static_cast<usize>(n + 1) * (n + 1));
+    idx.reserve(static_cast<usize>(n) * n * 6);
+    for (u32 y = 0; y <= n; ++y) {
+        for (u32 x = 0; x <= n; ++x) {
+            f32 fx = static_cast<f32>(x) * 0.1f;
+            f32 fy = static_cast<f32>(y) * 0.1f;
+            verts.emplace_back(Vec3{fx, fy, std::sin(fx * 0.7f) * std::cos(fy * 0.3f) * 4.0f});
+        }
+    }
+    for (u32 y = 0; y < n; ++y) {
+        for (u32 x = 0; x < n; ++x) {
+            u32 a = y * (n + 1) + x;
+            u32 b = a + 1;
+            u32 c = a + n + 2;
+            u32 d = a + n + 1;
+            idx.insert(idx.end(), {a, b, c, a, c, d});
+        }
+    }
+    return Mesh(std::move(verts), std::move(idx));
+}
+
+// The same surface unwelded (one vertex per corner, identity indices)
+Mesh makeSoup(const Mesh& grid) {
+    std::vector<Vertex> verts;
+    std::vector<u32> idx;
+    verts.reserve(grid.indices().size());
+    idx.reserve(grid.indices().size());
+    for (u32 i : grid.indices()) {
+        idx.push_back(static_cast<u32>(verts.size()));
+        verts.push_back(grid.vertices()[i]);
+    }
+    return Mesh(std::move(verts), std::move(idx));
+}
+
+f64 medianMs(int repeats, const std::function<void()>& op) {
+    std::vector<f64> samples;
+    for (int i = 0; i < repeats; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        op();
+        auto end = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<f64, std::milli>(end - start).count());
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+void runSuite(const char* label, const Mesh& source, int repeats, usize threads) {
+    // Work on one copy; every operation below is safe to repeat in place
+    Mesh mesh = source.clone();
+    Mat4 rotate(1.0f);
+    rotate[0] = Vec4{0.0f, 1.0f, 0.0f, 0.0f};
+    rotate[1] = Vec4{-1.0f, 0.0f, 0.0f, 0.0f};
+
+    struct Op {
+        const char* name;
+        std::function<void()> run;
+    };
+    std::vector<Op> ops = {
+        {"recalculateBounds", [&] { mesh.recalculateBounds(); }},
+        {"recalculateNormals", [&] { mesh.recalculateNormals(); }},
+        {"transform", [&] { mesh.transform(rotate); }},
+        {"generatePlanarUVs", [&] { mesh.generatePlanarUVs(15.0f); }},
+        {"validate", [&] { (void)mesh.validate(); }},
+        {"validateGeometry", [&] { (void)mesh.validateGeometry(); }},
+        {"autoOrient", [&] {
+             (void)mesh.autoOrient();
+             mesh.revertAutoOrient();
+         }},
+    };
+
+    for (const auto& op : ops) {
+        setParallelThreadCount(1);
+        f64 serial = medianMs(repeats, op.run);
+        setParallelThreadCount(threads);
+        f64 parallel = medianMs(repeats, op.run);
+        std::printf("%-12s %-20s %10.2f ms %10.2f ms %7.2fx\n",
+                    label,
+                    op.name,
+                    serial,
+                    parallel,
+                    parallel > 0.0 ? serial / parallel : 0.0);
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bool small = false;
+    int repeats = 5;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--small") == 0) {
+            small = true;
+        } else if (std::strcmp(argv[i], "--repeats") == 0 && i + 1 < argc) {
+            repeats = std::max(1, std::atoi(argv[++i]));
+        }
+    }
+
+    const usize threads = parallelThreadCount();
+    std::printf("threads: %zu, simd: %s, repeats: %d\n",
+                threads,
+                mesh_kernels::simdEnabled() ? "sse2" : "scalar",
+                repeats);
+    std::printf("%-12s %-20s %13s %13s %8s\n", "mesh", "operation", "1 thread", "parallel", "speedup");
+
+    std::vector<usize> sizes = {1000000};
+    if (!small) {
+        sizes.push_back(10000000);
+    }
+    for (usize triangles : sizes) {
+        const std::string tag = std::to_string(triangles / 1000000) + "M";
+        Mesh grid = makeGrid(triangles);
+        runSuite((tag + " welded").c_str(), grid, repeats, threads);
+        Mesh soup = makeSoup(grid);
+        grid.clear();
+        runSuite((tag + " soup").c_str(), soup, repeats, threads);
+    }
+    return 0;
+}
@@ -0,0 +1,90 @@
+// Digital Workshop - Benchmarks: cut list optimizers
+
+#include <benchmark/benchmark.h>
+
+#include "bench_datasets.h"
+#include "core/optimizer/cut_optimizer.h"
+#include "core/optimizer/multi_stock_optimizer.h"
+
+using namespace dw;
+
+namespace {
+
+// `reuse` keeps one optimizer across iterations, as repeated trials do
+void runOptimizer(benchmark::State& state, optimizer::Algorithm algorithm, bool reuse = false) {
+    const auto parts = bench::makeParts(static_cast<usize>(state.range(0)));
+    // Enough stock for every part; roughly one sheet per ten parts gets used
+    const auto sheets = bench::makeSheets(parts.size());
+
+    auto makeOptimizer = [algorithm]() {
+        auto optimizer = optimizer::CutOptimizer::create(algorithm);
+        optimizer->setKerf(3.2f);
+        optimizer->setMargin(10.0f);
+        return optimizer;
+    };
+    auto shared = makeOptimizer();
+
+    i64 placed = 0;
+    int sheetsUsed = 0;
+    for (auto _ : state) {
+        auto optimizer = reuse ? nullptr : makeOptimizer();
+        auto plan = (reuse ? shared : optimizer)->optimize(parts, sheets);
+        placed = 0;
+        for (const auto& sheet : plan.sheets)
+            placed += static_cast<i64>(sheet.placements.size());
+        sheetsUsed = plan.sheetsUsed;
+        benchmark::DoNotOptimize(plan.totalWasteArea);
+    }
+    if (placed == 0)
+        state.SkipWithError("no parts placed");
+    state.counters["placed"] = static_cast<f64>(placed);
+    state.counters["sheets"] = sheetsUsed;
+    state.SetItemsProcessed(state.iterations() * placed);
+}
+
+} // namespace
+
+static void BM_BinPacker(benchmark::State& state) {
+    runOptimizer(state, optimizer::Algorithm::FirstFitDecreasing);
+}
+BENCHMARK(BM_BinPacker)->Arg(50)->Arg(250)->Arg(1000)->Unit(benchmark::kMillisecond);
+
+static void BM_GuillotineOptimizer(benchmark::State& state) {
+    runOptimizer(state, optimizer::Algorithm::Guillotine);
+}
+BENCHMARK(BM_GuillotineOptimizer)->Arg(50)->Arg(250)->Arg(1000)->Unit(benchmark::kMillisecond);
+
+static void BM_GuillotineOptimizerReused(benchmark::State& state) {
+    runOptimizer(state, optimizer::Algorithm::Guillotine, true);
+}
+BENCHMARK(BM_GuillotineOptimizerReused)->Arg(50)->Arg(250)->Arg(1000)->Unit(benchmark::kMillisecond);
+
+// Whole-project cut list: three materials, each with four stock sizes to choose from
+static void BM_MultiStockOptimizer(benchmark::State& state) {
+    auto parts = bench::makeParts(static_cast<usize>(state.range(0)));
+    for (usize i = 0; i < parts.size(); ++i)
+        parts[i].materialId = static_cast<i64>(1 + i % 3);
+
+    std::vector<optimizer::Sheet> stock = {
+        optimizer::Sheet(2440.0f, 1220.0f, 52.0f),
+        optimizer::Sheet(1830.0f, 1220.0f, 41.0f),
+        optimizer::Sheet(1220.0f, 1220.0f, 29.0f),
+        optimizer::Sheet(1220.0f, 610.0f, 16.0f),
+    };
+    std::vector<optimizer::MaterialGroup> materials = {
+        {1, "Plywood", {}, stock},
+        {2, "MDF", {}, stock},
+        {3, "Birch", {}, stock},
+    };
+
+    int sheetsUsed = 0;
+    for (auto _ : state) {
+        auto result = optimizer::optimizeMultiStock(parts, materials, optimizer::Algorithm::Guillotine,
+                                                    true, 3.2f, 10.0f);
+        sheetsUsed = result.totalSheetsUsed;
+        benchmark::DoNotOptimize(result.totalCost);
+    }
+    state.counters["sheets"] = sheetsUsed;
+    state.SetItemsProcessed(state.iterations() * static_cast<i64>(parts.size()));
+}
+BENCHMARK(BM_MultiStockOptimizer)->Arg(250)->Arg(1000)->Unit(benchmark::kMillisecond)->UseRealTime();
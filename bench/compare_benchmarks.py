@@ -0,0 +1,169 @@
+#!/usr/bin/env python3
+"""Digital Workshop - Benchmark regression check
+
+Compares two Google Benchmark JSON files (dw_benchmarks --benchmark_out=...
+--benchmark_out_format=json) and flags benchmarks that got slower than the
+threshold. When a file holds repetitions, the median aggregate is used if
+present, otherwise the mean of the iteration runs.
+
+By default each benchmark is compared on the time it declares: wall time for
+UseRealTime()/UseManualTime() and multithreaded benchmarks (their names end in
+/real_time or /manual_time, or report threads > 1), CPU time otherwise.
+
+    compare_benchmarks.py BASELINE CURRENT [--threshold 0.10] [--metric auto]
+    compare_benchmarks.py BASELINE CURRENT --update   # overwrite BASELINE
+
+Exit status: 0 = no regressions, 1 = at least one regression, 2 = bad input.
+Baselines are machine-specific: generate bench/baseline.json with the in-tree
+Release build (DW_BUILD_BENCHMARKS=ON, which builds Google Benchmark itself)
+on the multi-core machine that runs the comparison. A missing baseline is
+written from the current results; a baseline from a debug library build or a
+machine with a different core count is rejected.
+"""
+
+import argparse
+import json
+import os
+import shutil
+import sys
+
+TIME_UNIT_NS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def load_results(path):
+    try:
+        with open(path, encoding="utf-8") as f:
+            return json.load(f)
+    except (OSError, ValueError) as e:
+        print(f"error: cannot read {path}: {e}", file=sys.stderr)
+        sys.exit(2)
+
+
+def declared_metric(bench):
+    """The time a benchmark asked to be measured by."""
+    name = bench.get("run_name", bench["name"])
+    if name.endswith(("/real_time", "/manual_time")) or bench.get("threads", 1) > 1:
+        return "real_time"
+    return "cpu_time"
+
+
+def check_context(baseline, current):
+    """Returns a reason the baseline cannot be compared against, or None."""
+    base_ctx = baseline.get("context", {})
+    if base_ctx.get("library_build_type") != "release":
+        return ("baseline was not produced by a Release build of Google Benchmark "
+                f"(library_build_type: {base_ctx.get('library_build_type')})")
+    base_cpus = base_ctx.get("num_cpus")
+    cur_cpus = current.get("context", {}).get("num_cpus")
+    if base_cpus != cur_cpus:
+        return f"baseline was recorded on {base_cpus} CPUs, this run on {cur_cpus}"
+    return None
+
+
+def load_times(data, metric):
+    """Returns {benchmark name: time in ns} for one results file."""
+    medians = {}
+    runs = {}
+    for bench in data.get("benchmarks", []):
+        if bench.get("error_occurred"):
+            continue
+        name = bench.get("run_name", bench["name"])
+        key = declared_metric(bench) if metric == "auto" else metric
+        ns = bench[key] * TIME_UNIT_NS[bench.get("time_unit", "ns")]
+        if bench.get("run_type") == "aggregate":
+            if bench.get("aggregate_name") == "median":
+                medians[name] = ns
+        else:
+            runs.setdefault(name, []).append(ns)
+
+    times = {name: sum(values) / len(values) for name, values in runs.items()}
+    times.update(medians)
+    return times
+
+
+def format_ns(ns):
+    for unit, scale in (("s", 1e9), ("ms", 1e6), ("us", 1e3)):
+        if ns >= scale:
+            return f"{ns / scale:.3f} {unit}"
+    return f"{ns:.1f} ns"
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Flag benchmark regressions against a baseline")
+    parser.add_argument("baseline", help="stored baseline JSON")
+    parser.add_argument("current", help="results JSON from this run")
+    parser.add_argument("--threshold", type=float, default=0.10,
+                        help="relative slowdown that counts as a regression (default 0.10)")
+    parser.add_argument("--metric", choices=("auto", "cpu_time", "real_time"), default="auto",
+                        help="time to compare (default: the one each benchmark declares)")
+    parser.add_argument("--update", action="store_true",
+                        help="replace the baseline with the current results after comparing")
+    args = parser.parse_args()
+
+    current_data = load_results(args.current)
+    current = load_times(current_data, args.metric)
+    if not current:
+        print(f"error: no benchmark results in {args.current}", file=sys.stderr)
+        return 2
+    recording = args.update or not os.path.exists(args.baseline)
+    if recording and current_data.get("context", {}).get("library_build_type") != "release":
+        print("error: refusing to record a baseline from a non-Release Google Benchmark build",
+              file=sys.stderr)
+        return 2
+    if not os.path.exists(args.baseline):
+        shutil.copyfile(args.current, args.baseline)
+        print(f"No baseline yet; recorded {args.current} as {args.baseline}")
+        return 0
+
+    baseline_data = load_results(args.baseline)
+    problem = check_context(baseline_data, current_data)
+    if problem and args.update:
+        shutil.copyfile(args.current, args.baseline)
+        print(f"Baseline replaced ({problem}): {args.baseline}")
+        return 0
+    if problem:
+        print(f"error: {problem}; regenerate {args.baseline} on this machine "
+              "from the Release build (--update)", file=sys.stderr)
+        return 2
+    baseline = load_times(baseline_data, args.metric)
+
+    width = max(len(name) for name in set(baseline) | set(current))
+    print(f"{'Benchmark':<{width}}  {'Baseline':>12}  {'Current':>12}  {'Change':>8}")
+    print("-" * (width + 40))
+
+    regressions = []
+    for name in sorted(set(baseline) | set(current), key=lambda n: (n not in baseline, n)):
+        if name not in current:
+            print(f"{name:<{width}}  {format_ns(baseline[name]):>12}  {'missing':>12}")
+            continue
+        if name not in baseline:
+            print(f"{name:<{width}}  {'new':>12}  {format_ns(current[name]):>12}")
+            continue
+
+        change = current[name] / baseline[name] - 1.0 if baseline[name] > 0 else 0.0
+        flag = ""
+        if change > args.threshold:
+            flag = "  REGRESSION"
+            regressions.append(name)
+        elif change < -args.threshold:
+            flag = "  faster"
+        print(f"{name:<{width}}  {format_ns(baseline[name]):>12}  {format_ns(current[name]):>12}"
+              f"  {change * 100:+7.1f}%{flag}")
+
+    print()
+    if regressions:
+        print(f"{len(regressions)} regression(s) beyond {args.threshold * 100:.0f}%:")
+        for name in regressions:
+            print(f"  {name}")
+    else:
+        print(f"No regressions beyond {args.threshold * 100:.0f}%")
+
+    if args.update:
+        shutil.copyfile(args.current, args.baseline)
+        print(f"Baseline updated: {args.baseline}")
+        return 0
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
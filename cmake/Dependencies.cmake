@@ -218,6 +218,20 @@ if(DW_BUILD_TESTS)
     FetchContent_MakeAvailable(googletest)
 endif()
 
+# Google Benchmark (for dw_benchmarks only)
+if(DW_BUILD_BENCHMARKS)
+    FetchContent_Declare(
+        benchmark
+        GIT_REPOSITORY https://github.com/google/benchmark.git
+        GIT_TAG v1.8.3
+        GIT_SHALLOW TRUE
+    )
+    set(BENCHMARK_ENABLE_TESTING OFF CACHE BOOL "" FORCE)
+    set(BENCHMARK_ENABLE_GTEST_TESTS OFF CACHE BOOL "" FORCE)
+    set(BENCHMARK_ENABLE_INSTALL OFF CACHE BOOL "" FORCE)
+    FetchContent_MakeAvailable(benchmark)
+endif()
+
 # GraphQLite - SQLite extension for Cypher graph queries
 # Downloaded as pre-built shared library, loaded at runtime via sqlite3_load_extension()
 option(DW_ENABLE_GRAPHQLITE "Download and bundle GraphQLite extension for graph queries" ON)
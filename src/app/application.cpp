@@ -4,6 +4,7 @@
 
 #include "app/application.h"
 
+#include <chrono>
 #include <cmath>
 #include <cstdio>
 #include <filesystem>
@@ -42,6 +43,7 @@
 #include "core/import/import_log.h"
 #include "core/import/import_queue.h"
 #include "core/library/library_manager.h"
+#include "core/mesh/mesh_cache.h"
 #include "core/materials/gemini_descriptor_service.h"
 #include "core/materials/gemini_material_service.h"
 #include "core/materials/material_manager.h"
@@ -53,6 +55,7 @@
 #include "core/utils/log.h"
 #include "core/utils/startup_timer.h"
 #include "core/utils/thread_utils.h"
+#include "core/utils/trace.h"
 #include "managers/config_manager.h"
 #include "managers/file_io_manager.h"
 #include "managers/ui_manager.h"
@@ -67,6 +70,11 @@
 
 namespace dw {
 
+namespace {
+// Per-frame slice for main-thread callbacks; the rest waits for the next frame
+constexpr std::chrono::microseconds kMainThreadQueueBudget{4000};
+} // namespace
+
 // Explicit destructors needed for unique_ptr of incomplete types
 Application::Application() {}
 Application::~Application() {
@@ -298,8 +306,13 @@ bool Application::init(bool diagnosticMode) {
             log::infof("App", "Cleaned up %d orphaned temp file(s) from prior session", orphansCleaned);
         }
 
+        // Welded/reordered meshes keyed by source hash, so reopening skips parsing
+        m_meshCache = std::make_unique<MeshCache>(MeshCache::defaultDir());
+        m_libraryManager->setMeshCache(m_meshCache.get());
+
         // Project export/import manager (.dwproj archives) (EXPORT-01/02)
-        m_projectExportManager = std::make_unique<ProjectExportManager>(*m_database);
+        m_projectExportManager =
+            std::make_unique<ProjectExportManager>(*m_database, m_storageManager.get());
 
         // My Toolbox (curated tool subset from .vtdb library)
         m_toolboxRepo = std::make_unique<ToolboxRepository>(*m_database);
@@ -334,6 +347,7 @@ bool Application::init(bool diagnosticMode) {
 
         m_importLog = std::make_unique<ImportLog>(Config::instance().getSupportDir() / ".import-log");
         m_importQueue->setImportLog(m_importLog.get());
+        m_importQueue->setMeshCache(m_meshCache.get());
 
         m_backgroundTagger = std::make_unique<BackgroundTagger>(
             *m_connectionPool, m_libraryManager.get(), m_descriptorService.get());
@@ -422,7 +436,9 @@ int Application::run() {
         return 1;
     }
     m_running = true;
+    trace::setThreadName("Main");
     while (m_running) {
+        DW_TRACE_FRAME();
         processEvents();
         update();
         render();
@@ -466,6 +482,7 @@ auto Application::mainThreadQueue() -> MainThreadQueue& {
 }
 
 void Application::processEvents() {
+    DW_TRACE_ZONE("Events");
     std::vector<std::string> droppedFiles;
     SDL_Event event;
     while (SDL_PollEvent(&event) != 0) {
@@ -498,8 +515,13 @@ void Application::processEvents() {
 }
 
 void Application::update() {
-    if (m_mainThreadQueue)
-        m_mainThreadQueue->processAll();
+    DW_TRACE_ZONE("Update");
+    if (m_mainThreadQueue) {
+        DW_TRACE_COUNTER("Main thread queue", m_mainThreadQueue->size());
+        m_mainThreadQueue->process(kMainThreadQueueBudget);
+        DW_TRACE_COUNTER("Main thread queue latency (ms)",
+                         m_mainThreadQueue->stats().lastMaxLatencyMs);
+    }
     m_fileIOManager->processCompletedImports(m_uiManager->viewportPanel(),
                                              m_uiManager->propertiesPanel(),
                                              m_uiManager->libraryPanel(),
@@ -547,6 +569,7 @@ void Application::update() {
 }
 
 void Application::render() {
+    DW_TRACE_ZONE("Render");
     ImGui_ImplOpenGL3_NewFrame();
     ImGui_ImplSDL2_NewFrame();
     ImGui::NewFrame();
@@ -582,7 +605,10 @@ void Application::render() {
 
     m_uiManager->handleKeyboardShortcuts();
     m_uiManager->renderMenuBar();
-    m_uiManager->renderPanels();
+    {
+        DW_TRACE_ZONE("Panels");
+        m_uiManager->renderPanels();
+    }
     m_uiManager->renderBackgroundUI(ImGui::GetIO().DeltaTime, &m_loadingState);
     m_uiManager->renderRestartPopup([this]() { m_configManager->relaunchApp(); });
     m_uiManager->renderAboutDialog();
@@ -595,7 +621,10 @@ void Application::render() {
     glClearColor(bgColor.x, bgColor.y, bgColor.z, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT);
     ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
-    SDL_GL_SwapWindow(m_window);
+    {
+        DW_TRACE_ZONE("Swap");
+        SDL_GL_SwapWindow(m_window);
+    }
 
     if (ImGui::GetIO().ConfigFlags & ImGuiConfigFlags_ViewportsEnable) {
         ImGui::UpdatePlatformWindows();
@@ -657,6 +686,7 @@ void Application::shutdown() {
     m_thumbnailGenerator.reset();
     m_projectManager.reset();
     m_libraryManager.reset();
+    m_meshCache.reset();
     m_projectExportManager.reset();
     m_graphManager.reset(); // Must be destroyed before m_database
     m_database.reset();
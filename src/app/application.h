@@ -28,6 +28,7 @@ class ThumbnailGenerator;
 class ImportQueue;
 class MainThreadQueue;
 class StorageManager;
+class MeshCache;
 class MaterialManager;
 class CostRepository;
 class RateCategoryRepository;
@@ -138,6 +139,7 @@ class Application {
     std::unique_ptr<ImportLog> m_importLog;
     std::unique_ptr<BackgroundTagger> m_backgroundTagger;
     std::unique_ptr<StorageManager> m_storageManager;
+    std::unique_ptr<MeshCache> m_meshCache;
 
     // UI Manager - owns all panels, dialogs, visibility state
     std::unique_ptr<UIManager> m_uiManager;
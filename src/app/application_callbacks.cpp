@@ -7,7 +7,6 @@
 #include "core/database/connection_pool.h"
 #include "core/database/model_repository.h"
 #include "core/library/library_manager.h"
-#include "core/loaders/loader_factory.h"
 #include "core/loaders/texture_loader.h"
 #include "core/materials/material_archive.h"
 #include "core/materials/material_manager.h"
@@ -71,25 +70,26 @@ void Application::onModelSelected(int64_t modelId) {
     auto storedOrientYaw = record->orientYaw;
     auto storedOrientMatrix = record->orientMatrix;
     auto storedCamera = record->cameraState;
+    ModelRecord recordCopy = *record;
 
     m_loadThread = std::thread(
-        [this, filePath, name, gen, modelId, storedOrientYaw, storedOrientMatrix, storedCamera]() {
-            auto loadResult = LoaderFactory::load(filePath);
-            if (!loadResult) { m_loadingState.reset(); return; }
-            loadResult.mesh->setName(name);
+        [this, recordCopy, filePath, name, gen, modelId, storedOrientYaw, storedOrientMatrix,
+         storedCamera]() {
+            // Served from the optimized mesh cache when available; no DB access
+            auto mesh = m_libraryManager->loadMesh(recordCopy);
+            if (!mesh) { m_loadingState.reset(); return; }
             f32 orientYaw = 0.0f;
             if (Config::instance().getAutoOrient()) {
                 if (storedOrientYaw && storedOrientMatrix) {
-                    loadResult.mesh->applyStoredOrient(*storedOrientMatrix);
+                    mesh->applyStoredOrient(*storedOrientMatrix);
                     orientYaw = *storedOrientYaw;
                 } else {
-                    orientYaw = loadResult.mesh->autoOrient();
+                    orientYaw = mesh->autoOrient();
                     ScopedConnection conn(*m_connectionPool);
                     ModelRepository repo(*conn);
-                    repo.updateOrient(modelId, orientYaw, loadResult.mesh->getOrientMatrix());
+                    repo.updateOrient(modelId, orientYaw, mesh->getOrientMatrix());
                 }
             }
-            auto mesh = loadResult.mesh;
             m_mainThreadQueue->enqueue([this, mesh, name, filePath, gen, orientYaw, storedCamera]() {
                 if (gen != m_loadingState.generation.load()) return;
                 m_loadingState.reset();
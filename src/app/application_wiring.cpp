@@ -180,6 +180,7 @@ void Application::wireLibraryPanel() {
     if (!m_uiManager->libraryPanel())
         return;
 
+    m_uiManager->libraryPanel()->setMainThreadQueue(m_mainThreadQueue.get());
     m_uiManager->libraryPanel()->setProjectManager(m_projectManager.get());
     m_uiManager->libraryPanel()->setOnGCodeAddToProject(
         [this](const std::vector<int64_t>& gcodeIds) {
@@ -402,7 +403,6 @@ void Application::regenerateSingleThumbnail(int64_t modelId) {
             bool ok = generateMaterialThumbnail(modelId, *mesh);
             if (m_uiManager->libraryPanel()) {
                 m_uiManager->libraryPanel()->invalidateThumbnail(modelId);
-                m_uiManager->libraryPanel()->refresh();
             }
             ToastManager::instance().show(
                 ok ? ToastType::Success : ToastType::Error,
@@ -455,8 +455,6 @@ void Application::regenerateBatchThumbnails(const std::vector<int64_t>& modelIds
         }
         m_mainThreadQueue->enqueue([this, progressDlg]() {
             progressDlg->finish();
-            if (m_uiManager->libraryPanel())
-                m_uiManager->libraryPanel()->refresh();
             ToastManager::instance().show(
                 ToastType::Success, "Thumbnails Updated", "Batch regeneration complete");
         });
@@ -494,7 +492,6 @@ void Application::wireTagDialog() {
     });
     tagDlg->setOnSave([this](int64_t modelId, const DescriptorResult& result) {
         persistTagResults(m_libraryManager.get(), modelId, result);
-        m_uiManager->libraryPanel()->refresh();
         m_uiManager->libraryPanel()->invalidateThumbnail(modelId);
         if (m_uiManager->propertiesPanel()) {
             auto updated = m_libraryManager->getModel(modelId);
@@ -541,7 +538,6 @@ void Application::handleTagImage(const std::vector<int64_t>& modelIds) {
             mtq->enqueue([libMgr, libPanel, modelId, modelName, result]() {
                 if (result.success) {
                     persistTagResults(libMgr, modelId, result);
-                    libPanel->refresh();
                     libPanel->invalidateThumbnail(modelId);
                     ToastManager::instance().show(ToastType::Success, "Tagged", result.title);
                     log::infof("App", "Tagged %s as: %s",
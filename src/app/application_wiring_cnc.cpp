@@ -2,6 +2,8 @@
 
 #include "app/application.h"
 
+#include <map>
+#include <set>
 #include <string>
 
 #include "core/cnc/cnc_controller.h"
@@ -79,11 +81,26 @@ void Application::wireCncPanels() {
         gcp->setProjectManager(m_projectManager.get());
         gcp->setCncController(m_cncController.get());
         gcp->setToolDatabase(m_toolDatabase.get());
+        gcp->setMainThreadQueue(m_mainThreadQueue.get());
 
         // Forward program load/clear to viewport for toolpath rendering + simulation
         gcp->setOnProgramLoaded([this](const gcode::Program& prog) {
             if (auto* vp = m_uiManager->viewportPanel()) {
                 vp->setGCodeProgram(prog);
+
+                // Cutter shapes for the stock preview from the tool library
+                std::map<int, carve::ToolProfile> profiles;
+                if (m_toolDatabase) {
+                    std::set<int> toolNumbers;
+                    for (const auto& seg : prog.path)
+                        toolNumbers.insert(seg.toolNumber);
+                    for (int t : toolNumbers) {
+                        if (auto geom = m_toolDatabase->findGeometryByToolNumber(t))
+                            profiles[t] = carve::ToolProfile::fromGeometry(*geom);
+                    }
+                }
+                vp->setSimToolProfiles(std::move(profiles), carve::ToolProfile::flat(3.175f));
+
                 // Compute segment times for viewport simulation
                 gcode::Analyzer analyzer;
                 analyzer.setMachineProfile(Config::instance().getActiveMachineProfile());
@@ -95,6 +112,8 @@ void Application::wireCncPanels() {
             if (auto* vp = m_uiManager->viewportPanel())
                 vp->clearGCodeProgram();
         });
+        if (auto* vp = m_uiManager->viewportPanel())
+            vp->setOnGCodeLinePicked([gcp](int line) { gcp->showLine(line); });
 
         // Gather CNC panel pointers
         auto* csp = m_uiManager->cncStatusPanel();
@@ -133,6 +152,12 @@ void Application::wireCncPanels() {
             }
         }
 
+        // Stock deviation export compares against the Direct Carve target
+        if (vpp) {
+            vpp->setCarveJob(m_carveJob.get());
+            vpp->setFileDialog(m_uiManager->fileDialog());
+        }
+
         // Set CncController on CNC panels
         if (csp) csp->setCncController(m_cncController.get());
         if (jogp) jogp->setCncController(m_cncController.get());
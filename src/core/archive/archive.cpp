@@ -7,19 +7,34 @@
 #include <fstream>
 #include <system_error>
 
+#include <miniz.h>
+
+#include "../export/zip_stream_writer.h"
 #include "../utils/file_utils.h"
 #include "../utils/log.h"
 
 namespace dw {
 
 // Simple archive format without external dependencies
-// Format: Header + File entries
-// Each entry: path_len(4) + path + size(8) + data
+//
+// v1: Header + entries, each path_len(4) + path + size(8) + data
+// v2: Header + entry data + TOC + trailer
+//     TOC entry: path_len(4) + path + offset(8) + stored_size(8) + size(8)
+//                + crc32(4) + compression(1)
+//     Trailer:   toc_offset(8) + entry_count(4) + TOC_MAGIC(4), at end of file
 
 namespace {
 
-constexpr uint32_t MAGIC = 0x44575000; // "DWP\0"
-constexpr uint32_t VERSION = 1;
+constexpr uint32_t MAGIC = 0x44575000;     // "DWP\0"
+constexpr uint32_t TOC_MAGIC = 0x54505744; // "DWPT"
+constexpr uint32_t VERSION = 2;
+constexpr uint32_t MAX_PATH_LENGTH = 4096;
+constexpr size_t STREAM_BUFFER_SIZE = 64 * 1024;
+// Smallest TOC entry: an empty path plus the fixed fields
+constexpr uint64_t MIN_TOC_ENTRY_SIZE = 4 + 8 + 8 + 8 + 4 + 1;
+
+constexpr uint8_t COMPRESSION_NONE = 0;
+constexpr uint8_t COMPRESSION_DEFLATE = 1;
 
 struct ArchiveHeader {
     uint32_t magic = MAGIC;
@@ -28,6 +43,16 @@ struct ArchiveHeader {
     uint32_t reserved = 0;
 };
 
+struct ArchiveTrailer {
+    uint64_t tocOffset = 0;
+    uint32_t entryCount = 0;
+    uint32_t magic = TOC_MAGIC;
+};
+
+bool writeU8(std::ostream& out, uint8_t value) {
+    return out.write(reinterpret_cast<const char*>(&value), sizeof(value)).good();
+}
+
 bool writeU32(std::ostream& out, uint32_t value) {
     return out.write(reinterpret_cast<const char*>(&value), sizeof(value)).good();
 }
@@ -36,6 +61,10 @@ bool writeU64(std::ostream& out, uint64_t value) {
     return out.write(reinterpret_cast<const char*>(&value), sizeof(value)).good();
 }
 
+bool readU8(std::istream& in, uint8_t& value) {
+    return !in.read(reinterpret_cast<char*>(&value), sizeof(value)).fail();
+}
+
 bool readU32(std::istream& in, uint32_t& value) {
     return !in.read(reinterpret_cast<char*>(&value), sizeof(value)).fail();
 }
@@ -44,6 +73,15 @@ bool readU64(std::istream& in, uint64_t& value) {
     return !in.read(reinterpret_cast<char*>(&value), sizeof(value)).fail();
 }
 
+bool readPath(std::istream& in, std::string& path) {
+    uint32_t pathLen = 0;
+    if (!readU32(in, pathLen) || pathLen > MAX_PATH_LENGTH) {
+        return false;
+    }
+    path.resize(pathLen);
+    return !in.read(path.data(), pathLen).fail();
+}
+
 std::vector<std::string> collectFiles(const std::string& dir) {
     std::vector<std::string> files;
     std::error_code ec;
@@ -52,6 +90,8 @@ std::vector<std::string> collectFiles(const std::string& dir) {
             files.push_back(entry.path().string());
         }
     }
+    // Deterministic archive layout regardless of directory iteration order
+    std::sort(files.begin(), files.end());
     return files;
 }
 
@@ -64,10 +104,277 @@ std::string makeRelativePath(const std::string& basePath, const std::string& ful
     return rel.generic_string();
 }
 
+// Stream one file into the archive, deflating if requested. Fills in the
+// entry's sizes and checksum; offset must already be set.
+bool writeEntryData(std::ostream& out,
+                    const std::string& sourcePath,
+                    bool useDeflate,
+                    ArchiveEntry& entry,
+                    std::string& error) {
+    std::ifstream in(sourcePath, std::ios::binary);
+    if (!in) {
+        error = "Failed to read file: " + sourcePath;
+        return false;
+    }
+
+    std::vector<unsigned char> inBuf(STREAM_BUFFER_SIZE);
+    std::vector<unsigned char> outBuf(useDeflate ? STREAM_BUFFER_SIZE : 0);
+    uint32_t crc = MZ_CRC32_INIT;
+    uint64_t written = 0;
+
+    mz_stream stream{};
+    if (useDeflate && mz_deflateInit(&stream, MZ_DEFAULT_COMPRESSION) != MZ_OK) {
+        error = "Failed to initialize compression";
+        return false;
+    }
+
+    bool ok = true;
+    bool done = false;
+    while (ok && !done) {
+        in.read(reinterpret_cast<char*>(inBuf.data()), static_cast<std::streamsize>(inBuf.size()));
+        auto count = static_cast<size_t>(in.gcount());
+        if (in.bad()) {
+            error = "Failed to read file: " + sourcePath;
+            ok = false;
+            break;
+        }
+        done = in.eof();
+        entry.uncompressedSize += count;
+        crc = static_cast<uint32_t>(mz_crc32(crc, inBuf.data(), count));
+
+        if (!useDeflate) {
+            ok = out.write(reinterpret_cast<const char*>(inBuf.data()),
+                           static_cast<std::streamsize>(count))
+                     .good();
+            written += count;
+            continue;
+        }
+
+        stream.next_in = inBuf.data();
+        stream.avail_in = static_cast<unsigned int>(count);
+        int flush = done ? MZ_FINISH : MZ_NO_FLUSH;
+        int status = MZ_OK;
+        do {
+            stream.next_out = outBuf.data();
+            stream.avail_out = static_cast<unsigned int>(outBuf.size());
+            status = mz_deflate(&stream, flush);
+            if (status != MZ_OK && status != MZ_STREAM_END && status != MZ_BUF_ERROR) {
+                error = "Compression failed: " + sourcePath;
+                ok = false;
+                break;
+            }
+            size_t produced = outBuf.size() - stream.avail_out;
+            if (!out.write(reinterpret_cast<const char*>(outBuf.data()),
+                           static_cast<std::streamsize>(produced))) {
+                ok = false;
+                break;
+            }
+            written += produced;
+        } while (stream.avail_out == 0 || (done && status != MZ_STREAM_END));
+    }
+
+    if (useDeflate) {
+        mz_deflateEnd(&stream);
+    }
+    if (ok && !out) {
+        error = "Failed to write archive data";
+        ok = false;
+    }
+
+    entry.compressedSize = written;
+    entry.compressed = useDeflate;
+    entry.checksum = crc;
+    return ok;
+}
+
+// Stream an entry's data (the input must be positioned at entry.offset) to
+// out, inflating and verifying the checksum as needed
+bool copyEntryData(std::istream& in,
+                   const ArchiveEntry& entry,
+                   bool verifyChecksum,
+                   std::ostream& out,
+                   std::string& error) {
+    std::vector<unsigned char> inBuf(STREAM_BUFFER_SIZE);
+    std::vector<unsigned char> outBuf(entry.compressed ? STREAM_BUFFER_SIZE : 0);
+    uint32_t crc = MZ_CRC32_INIT;
+    uint64_t remaining = entry.compressedSize;
+    uint64_t produced = 0;
+
+    mz_stream stream{};
+    if (entry.compressed && mz_inflateInit(&stream) != MZ_OK) {
+        error = "Failed to initialize decompression";
+        return false;
+    }
+
+    bool ok = true;
+    bool finished = !entry.compressed;
+    while (ok && remaining > 0) {
+        auto count = static_cast<size_t>(std::min<uint64_t>(remaining, inBuf.size()));
+        if (!in.read(reinterpret_cast<char*>(inBuf.data()), static_cast<std::streamsize>(count))) {
+            error = "Unexpected end of archive in " + entry.path;
+            ok = false;
+            break;
+        }
+        remaining -= count;
+
+        if (!entry.compressed) {
+            crc = static_cast<uint32_t>(mz_crc32(crc, inBuf.data(), count));
+            ok = out.write(reinterpret_cast<const char*>(inBuf.data()),
+                           static_cast<std::streamsize>(count))
+                     .good();
+            produced += count;
+            continue;
+        }
+
+        stream.next_in = inBuf.data();
+        stream.avail_in = static_cast<unsigned int>(count);
+        while (ok && stream.avail_in > 0 && !finished) {
+            stream.next_out = outBuf.data();
+            stream.avail_out = static_cast<unsigned int>(outBuf.size());
+            int status = mz_inflate(&stream, MZ_NO_FLUSH);
+            if (status != MZ_OK && status != MZ_STREAM_END) {
+                error = "Corrupt compressed data in " + entry.path;
+                ok = false;
+                break;
+            }
+            size_t bytes = outBuf.size() - stream.avail_out;
+            crc = static_cast<uint32_t>(mz_crc32(crc, outBuf.data(), bytes));
+            ok = out.write(reinterpret_cast<const char*>(outBuf.data()),
+                           static_cast<std::streamsize>(bytes))
+                     .good();
+            produced += bytes;
+            finished = status == MZ_STREAM_END;
+        }
+    }
+
+    if (entry.compressed) {
+        mz_inflateEnd(&stream);
+    }
+    if (!ok) {
+        if (error.empty()) {
+            error = "Failed to write " + entry.path;
+        }
+        return false;
+    }
+    if (!finished || produced != entry.uncompressedSize) {
+        error = "Size mismatch in " + entry.path;
+        return false;
+    }
+    if (verifyChecksum && crc != entry.checksum) {
+        error = "Checksum mismatch in " + entry.path;
+        return false;
+    }
+    return true;
+}
+
+// Read the header and entry index. v2 seeks to the TOC; v1 walks the
+// entries, skipping over their data.
+bool readIndex(std::istream& in,
+               ArchiveHeader& header,
+               std::vector<ArchiveEntry>& entries,
+               std::string& error) {
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!in || header.magic != MAGIC) {
+        error = "Invalid archive format";
+        return false;
+    }
+    if (header.version > VERSION || header.version == 0) {
+        error = "Unsupported archive version";
+        return false;
+    }
+
+    if (header.version == 1) {
+        for (uint32_t i = 0; i < header.entryCount; ++i) {
+            ArchiveEntry entry;
+            if (!readPath(in, entry.path)) {
+                error = "Failed to read path length";
+                return false;
+            }
+            if (!readU64(in, entry.uncompressedSize)) {
+                error = "Failed to read content size";
+                return false;
+            }
+            entry.compressedSize = entry.uncompressedSize; // No compression
+            entry.offset = static_cast<uint64_t>(in.tellg());
+            in.seekg(static_cast<std::streamoff>(entry.uncompressedSize), std::ios::cur);
+            entries.push_back(std::move(entry));
+        }
+        return true;
+    }
+
+    ArchiveTrailer trailer;
+    in.seekg(-static_cast<std::streamoff>(sizeof(trailer)), std::ios::end);
+    in.read(reinterpret_cast<char*>(&trailer), sizeof(trailer));
+    if (!in || trailer.magic != TOC_MAGIC) {
+        error = "Archive table of contents is missing";
+        return false;
+    }
+
+    // The TOC runs from tocOffset up to the trailer; reject counts it cannot hold
+    // before trusting them with an allocation
+    const auto tocEnd = static_cast<uint64_t>(in.tellg()) - sizeof(trailer);
+    if (trailer.tocOffset > tocEnd ||
+        trailer.entryCount > (tocEnd - trailer.tocOffset) / MIN_TOC_ENTRY_SIZE) {
+        error = "Corrupt archive table of contents";
+        return false;
+    }
+
+    in.seekg(static_cast<std::streamoff>(trailer.tocOffset));
+    entries.reserve(trailer.entryCount);
+    for (uint32_t i = 0; i < trailer.entryCount; ++i) {
+        ArchiveEntry entry;
+        uint8_t compression = COMPRESSION_NONE;
+        if (!readPath(in, entry.path) || !readU64(in, entry.offset) ||
+            !readU64(in, entry.compressedSize) || !readU64(in, entry.uncompressedSize) ||
+            !readU32(in, entry.checksum) || !readU8(in, compression) ||
+            compression > COMPRESSION_DEFLATE) {
+            error = "Corrupt archive table of contents";
+            return false;
+        }
+        entry.compressed = compression == COMPRESSION_DEFLATE;
+        if (entry.offset + entry.compressedSize > trailer.tocOffset) {
+            error = "Corrupt archive table of contents";
+            return false;
+        }
+        entries.push_back(std::move(entry));
+    }
+    return true;
+}
+
+// Seek to an entry and stream it into a file, creating parent directories
+bool extractEntry(std::istream& in,
+                  const ArchiveEntry& entry,
+                  bool verifyChecksum,
+                  const std::string& outputPath,
+                  std::string& error) {
+    Path parentDir = file::getParent(outputPath);
+    if (!parentDir.empty() && !file::createDirectories(parentDir)) {
+        error = "Failed to create directory: " + parentDir.string();
+        return false;
+    }
+
+    std::ofstream out(outputPath, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        error = "Failed to write file: " + outputPath;
+        return false;
+    }
+
+    in.clear();
+    in.seekg(static_cast<std::streamoff>(entry.offset));
+    if (!copyEntryData(in, entry, verifyChecksum, out, error)) {
+        out.close();
+        std::error_code ec;
+        fs::remove(outputPath, ec);
+        return false;
+    }
+    return true;
+}
+
 } // namespace
 
 ArchiveResult ProjectArchive::create(const std::string& archivePath,
-                                     const std::string& projectDir) {
+                                     const std::string& projectDir,
+                                     ArchiveCompression compression) {
     if (!file::isDirectory(projectDir)) {
         return ArchiveResult::fail("Project directory does not exist: " + projectDir);
     }
@@ -84,40 +391,57 @@ ArchiveResult ProjectArchive::create(const std::string& archivePath,
         return ArchiveResult::fail("Failed to create archive file: " + archivePath);
     }
 
-    // Write header
+    // Write header (the entry count is patched once files are written)
     ArchiveHeader header;
-    header.entryCount = static_cast<uint32_t>(files.size());
     out.write(reinterpret_cast<const char*>(&header), sizeof(header));
 
+    std::vector<ArchiveEntry> entries;
     std::vector<std::string> archivedFiles;
 
-    // Write each file
+    // Write each file's data
     for (const auto& filePath : files) {
-        std::string relativePath = makeRelativePath(projectDir, filePath);
+        ArchiveEntry entry;
+        entry.path = makeRelativePath(projectDir, filePath);
+        entry.offset = static_cast<uint64_t>(out.tellp());
+
+        std::string extension = fs::path(filePath).extension().string();
+        bool useDeflate = compression == ArchiveCompression::Deflate &&
+                          !ZipStreamWriter::isPrecompressed(extension);
 
-        // Read file content
-        auto content = file::readBinary(filePath);
-        if (!content) {
-            log::warningf("Archive", "Failed to read file: %s", filePath.c_str());
+        std::string error;
+        if (!writeEntryData(out, filePath, useDeflate, entry, error)) {
+            if (!out) {
+                return ArchiveResult::fail(error);
+            }
+            // Unreadable source: drop what was written for it
+            log::warningf("Archive", "%s", error.c_str());
+            out.seekp(static_cast<std::streamoff>(entry.offset));
             continue;
         }
 
-        // Write path
-        uint32_t pathLen = static_cast<uint32_t>(relativePath.length());
-        if (!writeU32(out, pathLen)) {
-            return ArchiveResult::fail("Failed to write path length");
-        }
-        out.write(relativePath.c_str(), pathLen);
+        archivedFiles.push_back(entry.path);
+        entries.push_back(std::move(entry));
+    }
 
-        // Write content
-        uint64_t contentSize = content->size();
-        if (!writeU64(out, contentSize)) {
-            return ArchiveResult::fail("Failed to write content size");
+    // Write table of contents and trailer
+    ArchiveTrailer trailer;
+    trailer.tocOffset = static_cast<uint64_t>(out.tellp());
+    trailer.entryCount = static_cast<uint32_t>(entries.size());
+    for (const auto& entry : entries) {
+        auto pathLen = static_cast<uint32_t>(entry.path.length());
+        if (!writeU32(out, pathLen) || !out.write(entry.path.c_str(), pathLen) ||
+            !writeU64(out, entry.offset) || !writeU64(out, entry.compressedSize) ||
+            !writeU64(out, entry.uncompressedSize) || !writeU32(out, entry.checksum) ||
+            !writeU8(out, entry.compressed ? COMPRESSION_DEFLATE : COMPRESSION_NONE)) {
+            return ArchiveResult::fail("Failed to write table of contents");
         }
-        out.write(reinterpret_cast<const char*>(content->data()), contentSize);
-
-        archivedFiles.push_back(relativePath);
     }
+    out.write(reinterpret_cast<const char*>(&trailer), sizeof(trailer));
+    auto archiveSize = static_cast<uint64_t>(out.tellp());
+
+    header.entryCount = trailer.entryCount;
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
 
     out.close();
 
@@ -125,6 +449,12 @@ ArchiveResult ProjectArchive::create(const std::string& archivePath,
         return ArchiveResult::fail("Failed to finalize archive");
     }
 
+    // A skipped final file can leave stale bytes past the trailer
+    std::error_code ec;
+    if (fs::file_size(archivePath, ec) != archiveSize && !ec) {
+        fs::resize_file(archivePath, archiveSize, ec);
+    }
+
     log::infof("Archive", "Created with %zu files: %s", archivedFiles.size(), archivePath.c_str());
 
     return ArchiveResult::ok(std::move(archivedFiles));
@@ -137,16 +467,18 @@ ArchiveResult ProjectArchive::extract(const std::string& archivePath,
         return ArchiveResult::fail("Failed to open archive: " + archivePath);
     }
 
-    // Read header
     ArchiveHeader header;
-    in.read(reinterpret_cast<char*>(&header), sizeof(header));
-
-    if (header.magic != MAGIC) {
-        return ArchiveResult::fail("Invalid archive format");
+    std::vector<ArchiveEntry> entries;
+    std::string error;
+    if (!readIndex(in, header, entries, error)) {
+        return ArchiveResult::fail(error);
     }
 
-    if (header.version > VERSION) {
-        return ArchiveResult::fail("Unsupported archive version");
+    // Security check: prevent path traversal
+    for (const auto& entry : entries) {
+        if (entry.path.find("..") != std::string::npos) {
+            return ArchiveResult::fail("Security error: path traversal detected");
+        }
     }
 
     // Create output directory
@@ -157,48 +489,12 @@ ArchiveResult ProjectArchive::extract(const std::string& archivePath,
     std::vector<std::string> extractedFiles;
 
     // Extract each file
-    for (uint32_t i = 0; i < header.entryCount; ++i) {
-        // Read path
-        uint32_t pathLen = 0;
-        if (!readU32(in, pathLen) || pathLen > 4096) {
-            return ArchiveResult::fail("Failed to read path length");
-        }
-
-        std::string relativePath(pathLen, '\0');
-        in.read(relativePath.data(), pathLen);
-
-        // Security check: prevent path traversal
-        if (relativePath.find("..") != std::string::npos) {
-            return ArchiveResult::fail("Security error: path traversal detected");
-        }
-
-        // Read content size
-        uint64_t contentSize = 0;
-        if (!readU64(in, contentSize)) {
-            return ArchiveResult::fail("Failed to read content size");
+    for (const auto& entry : entries) {
+        std::string outputPath = outputDir + "/" + entry.path;
+        if (!extractEntry(in, entry, header.version >= 2, outputPath, error)) {
+            return ArchiveResult::fail(error);
         }
-
-        // Read content
-        std::vector<uint8_t> content(contentSize);
-        in.read(reinterpret_cast<char*>(content.data()), contentSize);
-
-        // Create output path
-        std::string outputPath = outputDir + "/" + relativePath;
-
-        // Create parent directories
-        Path parentDir = file::getParent(outputPath);
-        if (!parentDir.empty()) {
-            if (!file::createDirectories(parentDir)) {
-                return ArchiveResult::fail("Failed to create directory: " + parentDir.string());
-            }
-        }
-
-        // Write file
-        if (!file::writeBinary(outputPath, content)) {
-            return ArchiveResult::fail("Failed to write file: " + outputPath);
-        }
-
-        extractedFiles.push_back(relativePath);
+        extractedFiles.push_back(entry.path);
     }
 
     log::infof("Archive", "Extracted %zu files to: %s", extractedFiles.size(), outputDir.c_str());
@@ -206,47 +502,48 @@ ArchiveResult ProjectArchive::extract(const std::string& archivePath,
     return ArchiveResult::ok(std::move(extractedFiles));
 }
 
-std::vector<ArchiveEntry> ProjectArchive::list(const std::string& archivePath) {
-    std::vector<ArchiveEntry> entries;
-
+ArchiveResult ProjectArchive::extractFile(const std::string& archivePath,
+                                          const std::string& entryPath,
+                                          const std::string& outputPath) {
     std::ifstream in(archivePath, std::ios::binary);
     if (!in) {
-        return entries;
+        return ArchiveResult::fail("Failed to open archive: " + archivePath);
     }
 
-    // Read header
     ArchiveHeader header;
-    in.read(reinterpret_cast<char*>(&header), sizeof(header));
-
-    if (header.magic != MAGIC) {
-        return entries;
+    std::vector<ArchiveEntry> entries;
+    std::string error;
+    if (!readIndex(in, header, entries, error)) {
+        return ArchiveResult::fail(error);
     }
 
-    // Read entries
-    for (uint32_t i = 0; i < header.entryCount; ++i) {
-        ArchiveEntry entry;
-
-        // Read path
-        uint32_t pathLen = 0;
-        if (!readU32(in, pathLen) || pathLen > 4096) {
-            break;
-        }
-
-        entry.path.resize(pathLen);
-        in.read(entry.path.data(), pathLen);
+    auto it = std::find_if(entries.begin(), entries.end(), [&](const ArchiveEntry& entry) {
+        return entry.path == entryPath;
+    });
+    if (it == entries.end()) {
+        return ArchiveResult::fail("Entry not found in archive: " + entryPath);
+    }
 
-        // Read content size
-        if (!readU64(in, entry.uncompressedSize)) {
-            break;
-        }
-        entry.compressedSize = entry.uncompressedSize; // No compression
+    if (!extractEntry(in, *it, header.version >= 2, outputPath, error)) {
+        return ArchiveResult::fail(error);
+    }
+    return ArchiveResult::ok({entryPath});
+}
 
-        // Skip content
-        in.seekg(entry.uncompressedSize, std::ios::cur);
+std::vector<ArchiveEntry> ProjectArchive::list(const std::string& archivePath) {
+    std::vector<ArchiveEntry> entries;
 
-        entries.push_back(std::move(entry));
+    std::ifstream in(archivePath, std::ios::binary);
+    if (!in) {
+        return entries;
     }
 
+    // A truncated v1 archive still lists the entries read before the damage
+    ArchiveHeader header;
+    std::string error;
+    if (!readIndex(in, header, entries, error) && header.version != 1) {
+        entries.clear();
+    }
     return entries;
 }
 
@@ -259,7 +556,17 @@ bool ProjectArchive::isValidArchive(const std::string& archivePath) {
     ArchiveHeader header;
     in.read(reinterpret_cast<char*>(&header), sizeof(header));
 
-    return header.magic == MAGIC && header.version <= VERSION;
+    if (!in || header.magic != MAGIC || header.version == 0 || header.version > VERSION) {
+        return false;
+    }
+    if (header.version == 1) {
+        return true;
+    }
+
+    ArchiveTrailer trailer;
+    in.seekg(-static_cast<std::streamoff>(sizeof(trailer)), std::ios::end);
+    in.read(reinterpret_cast<char*>(&trailer), sizeof(trailer));
+    return in && trailer.magic == TOC_MAGIC;
 }
 
 } // namespace dw
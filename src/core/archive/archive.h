@@ -11,9 +11,15 @@ struct ArchiveEntry {
     std::string path;
     uint64_t uncompressedSize = 0;
     uint64_t compressedSize = 0;
+    uint64_t offset = 0;   // Start of the entry's data in the archive
+    uint32_t checksum = 0; // CRC-32 of the uncompressed data (v2 only)
+    bool compressed = false;
     bool isDirectory = false;
 };
 
+// Per-entry compression when creating an archive
+enum class ArchiveCompression { None, Deflate };
+
 // Result of archive operations
 struct ArchiveResult {
     bool success = false;
@@ -28,14 +34,27 @@ struct ArchiveResult {
 };
 
 // Archive format for project export
+//
+// Version 2 writes a header, the entry data, then a table of contents and a
+// fixed-size trailer pointing at it, so listing reads only the TOC and a
+// single entry extracts with one seek. Entries are streamed through
+// fixed-size buffers and optionally deflated (already-compressed formats are
+// always stored). Version 1 archives (sequential, uncompressed) stay readable.
 class ProjectArchive {
   public:
     // Create a new archive for writing
-    static ArchiveResult create(const std::string& archivePath, const std::string& projectDir);
+    static ArchiveResult create(const std::string& archivePath,
+                                const std::string& projectDir,
+                                ArchiveCompression compression = ArchiveCompression::Deflate);
 
     // Extract an archive
     static ArchiveResult extract(const std::string& archivePath, const std::string& outputDir);
 
+    // Extract one entry (archive-relative path) to outputPath
+    static ArchiveResult extractFile(const std::string& archivePath,
+                                     const std::string& entryPath,
+                                     const std::string& outputPath);
+
     // List contents of an archive
     static std::vector<ArchiveEntry> list(const std::string& archivePath);
 
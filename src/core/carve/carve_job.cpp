@@ -3,6 +3,8 @@
 #include "island_detector.h"
 #include "toolpath_generator.h"
 
+#include <algorithm>
+#include <chrono>
 #include <stdexcept>
 
 namespace dw {
@@ -10,6 +12,7 @@ namespace carve {
 
 CarveJob::~CarveJob()
 {
+    cancelToolpath();
     cancel();
     if (m_future.valid()) {
         m_future.wait();
@@ -20,10 +23,13 @@ void CarveJob::startHeightmap(const std::vector<Vertex>& vertices,
                                const std::vector<u32>& indices,
                                const ModelFitter& fitter,
                                const FitParams& fitParams,
-                               const HeightmapConfig& hmConfig)
+                               const HeightmapConfig& hmConfig,
+                               f32 previewToolAngleDeg)
 {
-    // Wait for any previous job to finish
+    // A new request supersedes the one in flight: stop it, then wait
+    cancelToolpath();
     if (m_future.valid()) {
+        m_cancelled.store(true, std::memory_order_release);
         m_future.wait();
     }
 
@@ -31,6 +37,13 @@ void CarveJob::startHeightmap(const std::vector<Vertex>& vertices,
     m_progress.store(0.0f, std::memory_order_release);
     m_cancelled.store(false, std::memory_order_release);
     m_error.clear();
+    m_toolpathStages.clear();
+    {
+        std::lock_guard<std::mutex> lock(m_previewMutex);
+        m_preview = Preview{Heightmap{}, {}, {}, 0.0f, m_preview.revision + 1};
+        m_previewAnalyzedAt = 0.0f;
+        m_previewRowsMerged = 0;
+    }
 
     // Transform vertices using ModelFitter
     std::vector<Vertex> transformed;
@@ -55,15 +68,35 @@ void CarveJob::startHeightmap(const std::vector<Vertex>& vertices,
         [this, verts = std::move(capturedVerts),
          idxs = std::move(capturedIndices),
          cfg = capturedConfig,
-         bMin = boundsMin, bMax = boundsMax]() {
+         bMin = boundsMin, bMax = boundsMax,
+         angle = previewToolAngleDeg]() {
 
         try {
+            auto checkCancelled = [this](f32) {
+                if (m_cancelled.load(std::memory_order_acquire)) {
+                    throw std::runtime_error("Cancelled");
+                }
+            };
+
+            // Coarse pass first so analysis can be previewed right away;
+            // skipped when the requested grid is already about that small
+            const f32 span = std::max(bMax.x - bMin.x, bMax.y - bMin.y);
+            const f32 previewRes = span / static_cast<f32>(kPreviewCells);
+            if (previewRes > cfg.resolutionMm * 2.0f) {
+                HeightmapConfig previewCfg = cfg;
+                previewCfg.resolutionMm = previewRes;
+                Heightmap coarse;
+                coarse.build(verts, idxs, bMin, bMax, previewCfg, checkCancelled);
+                publishPreview(std::move(coarse), angle);
+            }
+
             m_heightmap.build(verts, idxs, bMin, bMax, cfg,
-                [this](f32 p) {
+                [this, checkCancelled](f32 p) {
                     m_progress.store(p, std::memory_order_release);
-                    if (m_cancelled.load(std::memory_order_acquire)) {
-                        throw std::runtime_error("Cancelled");
-                    }
+                    checkCancelled(p);
+                },
+                [this](const Heightmap& partial, int rowBegin, int rowEnd) {
+                    refinePreview(partial, rowBegin, rowEnd);
                 });
 
             if (m_cancelled.load(std::memory_order_acquire)) {
@@ -82,6 +115,69 @@ void CarveJob::startHeightmap(const std::vector<Vertex>& vertices,
     });
 }
 
+void CarveJob::publishPreview(Heightmap coarse, f32 toolAngleDeg)
+{
+    // Analysis runs outside the lock; the grid is small
+    Preview next;
+    next.curvature = analyzeCurvature(coarse);
+    next.islands = detectIslands(coarse, toolAngleDeg);
+    next.heightmap = std::move(coarse);
+
+    std::lock_guard<std::mutex> lock(m_previewMutex);
+    next.revision = m_preview.revision + 1;
+    m_preview = std::move(next);
+    m_previewToolAngle = toolAngleDeg;
+    m_previewAnalyzedAt = 0.0f;
+    m_previewRowsMerged = 0;
+}
+
+void CarveJob::refinePreview(const Heightmap& partial, int rowBegin, int rowEnd)
+{
+    // Heightmap::build serializes tile callbacks and this thread is the only
+    // writer, so the analysis can run on a copy while the UI keeps reading
+    constexpr f32 kReanalyzeStep = 0.25f;
+    Heightmap snapshot;
+    f32 toolAngle = 0.0f;
+    {
+        std::lock_guard<std::mutex> lock(m_previewMutex);
+        if (m_preview.heightmap.empty()) {
+            return;
+        }
+        m_preview.heightmap.resampleRows(partial, rowBegin, rowEnd);
+        m_previewRowsMerged += rowEnd - rowBegin;
+        m_preview.refined = static_cast<f32>(m_previewRowsMerged) /
+                            static_cast<f32>(std::max(1, partial.rows()));
+        ++m_preview.revision;
+
+        // Re-run the (cheap) coarse analysis every quarter of refinement
+        if (m_preview.refined - m_previewAnalyzedAt < kReanalyzeStep &&
+            m_previewRowsMerged < partial.rows()) {
+            return;
+        }
+        snapshot = m_preview.heightmap;
+        toolAngle = m_previewToolAngle;
+        m_previewAnalyzedAt = m_preview.refined;
+    }
+
+    CurvatureResult curvature = analyzeCurvature(snapshot);
+    IslandResult islands = detectIslands(snapshot, toolAngle);
+
+    std::lock_guard<std::mutex> lock(m_previewMutex);
+    m_preview.curvature = std::move(curvature);
+    m_preview.islands = std::move(islands);
+    ++m_preview.revision;
+}
+
+bool CarveJob::previewSince(u32 revision, Preview& out) const
+{
+    std::lock_guard<std::mutex> lock(m_previewMutex);
+    if (m_preview.heightmap.empty() || m_preview.revision == revision) {
+        return false;
+    }
+    out = m_preview;
+    return true;
+}
+
 CarveJobState CarveJob::state() const
 {
     return m_state.load(std::memory_order_acquire);
@@ -115,7 +211,9 @@ void CarveJob::setReady()
 
 bool CarveJob::loadHeightmap(const std::string& path)
 {
+    cancelToolpath();
     if (!m_heightmap.load(path)) return false;
+    m_toolpathStages.clear();
     setReady();
     return true;
 }
@@ -135,8 +233,10 @@ void CarveJob::analyzeHeightmap(f32 toolAngleDeg)
     if (m_state.load(std::memory_order_acquire) != CarveJobState::Ready) {
         return;
     }
+    cancelToolpath();
     m_curvature = analyzeCurvature(m_heightmap);
     m_islands = detectIslands(m_heightmap, toolAngleDeg);
+    m_toolpathStages.clearClearing();
     m_analyzed = true;
 }
 
@@ -144,36 +244,114 @@ void CarveJob::generateToolpath(const ToolpathConfig& config,
                                  const VtdbToolGeometry& finishTool,
                                  const VtdbToolGeometry* clearTool)
 {
+    cancelToolpath();
+    if (!m_analyzed) {
+        return;
+    }
+    m_toolpath = buildToolpath(config, finishTool, clearTool);
+}
+
+void CarveJob::startToolpath(const ToolpathConfig& config,
+                              const VtdbToolGeometry& finishTool,
+                              const VtdbToolGeometry* clearTool)
+{
+    cancelToolpath();
     if (!m_analyzed) {
         return;
     }
 
+    m_toolpathProgress.store(0.0f, std::memory_order_release);
+    m_toolpathCancelled.store(false, std::memory_order_release);
+
+    const bool withClearing = clearTool != nullptr;
+    const VtdbToolGeometry clearCopy = clearTool ? *clearTool : VtdbToolGeometry{};
+    m_toolpathFuture = std::async(std::launch::async,
+        [this, config, finishTool, clearCopy, withClearing]() {
+            return buildToolpath(config, finishTool, withClearing ? &clearCopy : nullptr);
+        });
+}
+
+bool CarveJob::toolpathBusy() const
+{
+    return m_toolpathFuture.valid() &&
+           m_toolpathFuture.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+}
+
+f32 CarveJob::toolpathProgress() const
+{
+    return m_toolpathProgress.load(std::memory_order_acquire);
+}
+
+void CarveJob::cancelToolpath()
+{
+    if (!m_toolpathFuture.valid()) {
+        return;
+    }
+    m_toolpathCancelled.store(true, std::memory_order_release);
+    m_toolpathFuture.wait();
+    m_toolpathFuture = std::future<MultiPassToolpath>{};
+}
+
+bool CarveJob::collectToolpath()
+{
+    if (!m_toolpathFuture.valid() ||
+        m_toolpathFuture.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return false;
+    }
+    try {
+        m_toolpath = m_toolpathFuture.get();
+        return true;
+    } catch (const std::exception&) {
+        return false; // Cancelled
+    }
+}
+
+MultiPassToolpath CarveJob::buildToolpath(const ToolpathConfig& config,
+                                          const VtdbToolGeometry& finishTool,
+                                          const VtdbToolGeometry* clearTool)
+{
+    MultiPassToolpath result;
     ToolpathGenerator gen;
 
+    // Finishing dominates; clearing (when there is any) gets the last stretch
+    const bool clearing = clearTool && !m_islands.islands.empty();
+    const f32 finishShare = clearing ? 0.8f : 1.0f;
+    auto reportFrom = [this](f32 base, f32 share) {
+        return [this, base, share](f32 p) {
+            m_toolpathProgress.store(base + p * share, std::memory_order_release);
+            if (m_toolpathCancelled.load(std::memory_order_acquire)) {
+                throw std::runtime_error("Cancelled");
+            }
+        };
+    };
+
     // Use flat_diameter when available (end mills); fall back to full diameter
     // for V-bits and ball noses where flat_diameter is 0
     const f32 tipDia = (finishTool.flat_diameter > 0.0)
         ? static_cast<f32>(finishTool.flat_diameter)
         : static_cast<f32>(finishTool.diameter);
 
-    m_toolpath.finishing = gen.generateFinishing(
-        m_heightmap, config, tipDia, finishTool);
+    gen.setProgressCallback(reportFrom(0.0f, finishShare));
+    result.finishing = gen.generateFinishing(
+        m_heightmap, config, tipDia, finishTool, m_toolpathStages);
 
-    if (clearTool && !m_islands.islands.empty()) {
-        m_toolpath.clearing = gen.generateClearing(
+    if (clearing) {
+        gen.setProgressCallback(reportFrom(finishShare, 1.0f - finishShare));
+        result.clearing = gen.generateClearing(
             m_heightmap, m_islands, config,
-            static_cast<f32>(clearTool->diameter));
-        m_toolpath.totalTimeSec =
-            m_toolpath.finishing.estimatedTimeSec +
-            m_toolpath.clearing.estimatedTimeSec;
-        m_toolpath.totalLineCount =
-            m_toolpath.finishing.lineCount +
-            m_toolpath.clearing.lineCount;
+            static_cast<f32>(clearTool->diameter), m_toolpathStages);
+        result.totalTimeSec =
+            result.finishing.estimatedTimeSec +
+            result.clearing.estimatedTimeSec;
+        result.totalLineCount =
+            result.finishing.lineCount +
+            result.clearing.lineCount;
     } else {
-        m_toolpath.clearing = Toolpath{};
-        m_toolpath.totalTimeSec = m_toolpath.finishing.estimatedTimeSec;
-        m_toolpath.totalLineCount = m_toolpath.finishing.lineCount;
+        result.totalTimeSec = result.finishing.estimatedTimeSec;
+        result.totalLineCount = result.finishing.lineCount;
     }
+    m_toolpathProgress.store(1.0f, std::memory_order_release);
+    return result;
 }
 
 const MultiPassToolpath& CarveJob::toolpath() const
@@ -8,11 +8,13 @@
 #include "model_fitter.h"
 #include "surface_analysis.h"
 #include "carve_streamer.h"
+#include "toolpath_generator.h"
 #include "toolpath_types.h"
 
 #include <atomic>
 #include <future>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -35,12 +37,31 @@ public:
     CarveJob(const CarveJob&) = delete;
     CarveJob& operator=(const CarveJob&) = delete;
 
-    // Start heightmap generation (non-blocking)
+    // Start heightmap generation (non-blocking). Cancels a build still in
+    // flight. A coarse preview (longest side kPreviewCells) is built and
+    // analyzed with previewToolAngleDeg first, then refined from the
+    // full-resolution tiles as they finish.
     void startHeightmap(const std::vector<Vertex>& vertices,
                         const std::vector<u32>& indices,
                         const ModelFitter& fitter,
                         const FitParams& fitParams,
-                        const HeightmapConfig& hmConfig);
+                        const HeightmapConfig& hmConfig,
+                        f32 previewToolAngleDeg = 90.0f);
+
+    static constexpr int kPreviewCells = 256;
+
+    // Coarse-to-fine preview of the heightmap being computed
+    struct Preview {
+        Heightmap heightmap;
+        CurvatureResult curvature;
+        IslandResult islands;
+        f32 refined = 0.0f; // Fraction of full-resolution rows merged in
+        u32 revision = 0;
+    };
+
+    // Copy the preview into `out` if it changed since `revision` (0 = never
+    // seen). False when there is nothing newer.
+    bool previewSince(u32 revision, Preview& out) const;
 
     // Poll state (call from main thread)
     CarveJobState state() const;
@@ -64,12 +85,28 @@ public:
     // Run analysis after heightmap (call from main thread, fast)
     void analyzeHeightmap(f32 toolAngleDeg);
 
-    // Toolpath generation
+    // Toolpath generation (blocking). Intermediate stages are cached, so
+    // repeat calls only redo the work the changed settings affect.
     void generateToolpath(const ToolpathConfig& config,
                           const VtdbToolGeometry& finishTool,
                           const VtdbToolGeometry* clearTool);
+    const ToolpathStages& toolpathStages() const { return m_toolpathStages; }
     const MultiPassToolpath& toolpath() const;
 
+    // Same, on a background thread (non-blocking); cancels one in flight.
+    // toolpath() keeps the previous result until collectToolpath() adopts
+    // the new one.
+    void startToolpath(const ToolpathConfig& config,
+                       const VtdbToolGeometry& finishTool,
+                       const VtdbToolGeometry* clearTool);
+    bool toolpathBusy() const;
+    f32 toolpathProgress() const;   // [0.0, 1.0]
+    void cancelToolpath();          // Returns once the worker has stopped
+
+    // Main thread: take a finished background result. True when toolpath()
+    // changed; false while busy, after a cancel, or with nothing pending.
+    bool collectToolpath();
+
     // Start streaming the generated toolpath
     void startStreaming(CncController* cnc);
 
@@ -77,6 +114,12 @@ public:
     CarveStreamer* streamer();
 
 private:
+    MultiPassToolpath buildToolpath(const ToolpathConfig& config,
+                                    const VtdbToolGeometry& finishTool,
+                                    const VtdbToolGeometry* clearTool);
+    void publishPreview(Heightmap coarse, f32 toolAngleDeg);
+    void refinePreview(const Heightmap& partial, int rowBegin, int rowEnd);
+
     std::atomic<CarveJobState> m_state{CarveJobState::Idle};
     std::atomic<f32> m_progress{0.0f};
     std::atomic<bool> m_cancelled{false};
@@ -84,10 +127,23 @@ private:
     CurvatureResult m_curvature;
     IslandResult m_islands;
     MultiPassToolpath m_toolpath;
+    ToolpathStages m_toolpathStages; // Cleared when the heightmap or islands change
     bool m_analyzed = false;
     std::string m_error;
     std::future<void> m_future;
     std::unique_ptr<CarveStreamer> m_streamer;
+
+    // Background toolpath; the worker owns m_toolpathStages while it runs
+    std::future<MultiPassToolpath> m_toolpathFuture;
+    std::atomic<f32> m_toolpathProgress{0.0f};
+    std::atomic<bool> m_toolpathCancelled{false};
+
+    // Guarded by m_previewMutex; written by the build thread only
+    mutable std::mutex m_previewMutex;
+    Preview m_preview;
+    f32 m_previewToolAngle = 90.0f;
+    f32 m_previewAnalyzedAt = 0.0f; // `refined` when the preview was last analyzed
+    int m_previewRowsMerged = 0;
 };
 
 } // namespace carve
@@ -2,33 +2,9 @@
 
 #include "../cnc/cnc_controller.h"
 
-#include <cstdio>
-
 namespace dw {
 namespace carve {
 
-namespace {
-
-// Format float with minimal trailing zeros (consistent with gcode_export.cpp)
-std::string fmt(f32 v)
-{
-    char buf[32];
-    std::snprintf(buf, sizeof(buf), "%.3f", static_cast<double>(v));
-    std::string s(buf);
-    auto dot = s.find('.');
-    if (dot != std::string::npos) {
-        auto last = s.find_last_not_of('0');
-        if (last == dot) {
-            s.erase(dot + 2); // Keep at least one decimal
-        } else {
-            s.erase(last + 1);
-        }
-    }
-    return s;
-}
-
-} // anonymous namespace
-
 void CarveStreamer::setCncController(CncController* cnc)
 {
     m_cnc = cnc;
@@ -41,7 +17,8 @@ void CarveStreamer::start(const MultiPassToolpath& toolpath,
     m_config = config;
     m_pointIndex = 0;
     m_lineNumber = 0;
-    m_lastFeedRate = -1.0f;
+    m_writer.clear();
+    m_writer.resetModalState();
     m_aborted.store(false, std::memory_order_release);
     m_paused.store(false, std::memory_order_release);
 
@@ -128,7 +105,7 @@ std::string CarveStreamer::nextLine()
     if (m_phase == Phase::Postamble) {
         std::string line;
         if (m_pointIndex == 0) {
-            line = "G0 Z" + fmt(m_config.safeZMm);
+            line = formatRetract(m_config.safeZMm);
         } else if (m_pointIndex == 1) {
             line = "M5";
         } else {
@@ -201,29 +178,36 @@ f32 CarveStreamer::progressFraction() const
     return static_cast<f32>(m_lineNumber) / static_cast<f32>(m_totalLines);
 }
 
-std::string CarveStreamer::formatRapid(const Vec3& pos) const
+std::string CarveStreamer::formatRapid(const Vec3& pos)
 {
-    return "G0 X" + fmt(pos.x) + " Y" + fmt(pos.y) + " Z" + fmt(pos.z);
+    m_writer.rapid(pos);
+    return takeLine();
 }
 
 std::string CarveStreamer::formatLinear(const Vec3& pos, f32 feedRate)
 {
-    std::string line = "G1 X" + fmt(pos.x) + " Y" + fmt(pos.y) + " Z" + fmt(pos.z);
-    if (feedRate != m_lastFeedRate) {
-        line += " F" + fmt(feedRate);
-        m_lastFeedRate = feedRate;
-    }
-    return line;
+    m_writer.linear(pos, feedRate);
+    return takeLine();
 }
 
-std::string CarveStreamer::preamble() const
+std::string CarveStreamer::formatRetract(f32 z)
 {
-    return "G90 G21";
+    m_writer.retractTo(z);
+    return takeLine();
 }
 
-std::string CarveStreamer::postamble() const
+std::string CarveStreamer::takeLine()
 {
-    return "G0 Z" + fmt(m_config.safeZMm) + "\nM5\nM30";
+    // The writer holds just this line; drop its newline
+    const std::string& text = m_writer.text();
+    std::string line(text.data(), text.size() - 1);
+    m_writer.clear();
+    return line;
+}
+
+std::string CarveStreamer::preamble() const
+{
+    return "G90 G21";
 }
 
 } // namespace carve
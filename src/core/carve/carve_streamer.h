@@ -1,6 +1,7 @@
 #pragma once
 
 #include "toolpath_types.h"
+#include "../gcode/gcode_writer.h"
 
 #include <atomic>
 #include <string>
@@ -13,7 +14,8 @@ namespace carve {
 
 // Streams toolpath to CncController point-by-point.
 // Generates G-code from toolpath data on demand, avoiding
-// building a complete file in memory.
+// building a complete file in memory. Lines are formatted by the same
+// gcode::GcodeWriter as exportGcode(), modal words suppressed alike.
 class CarveStreamer {
 public:
     CarveStreamer() = default;
@@ -58,8 +60,8 @@ private:
     int m_lineNumber = 0;
     int m_totalLines = 0;
 
-    // Feed rate tracking for modal optimization
-    f32 m_lastFeedRate = -1.0f;
+    // Formats each line; carries modal words over between lines
+    gcode::GcodeWriter m_writer;
 
     // State
     std::atomic<bool> m_running{false};
@@ -67,10 +69,11 @@ private:
     std::atomic<bool> m_aborted{false};
 
     // G-code generation helpers
-    std::string formatRapid(const Vec3& pos) const;
+    std::string formatRapid(const Vec3& pos);
     std::string formatLinear(const Vec3& pos, f32 feedRate);
+    std::string formatRetract(f32 z);
+    std::string takeLine();
     std::string preamble() const;
-    std::string postamble() const;
 };
 
 } // namespace carve
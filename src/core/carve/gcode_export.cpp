@@ -1,121 +1,159 @@
 #include "gcode_export.h"
 
-#include <cmath>
-#include <cstdio>
+#include <algorithm>
 #include <fstream>
-#include <sstream>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+#include "../gcode/gcode_writer.h"
+#include "../threading/parallel_for.h"
+#include "../utils/trace.h"
 
 namespace dw {
 namespace carve {
 
 namespace {
 
-// Format float with minimal trailing zeros (e.g., 5.0 not 5.000000)
-std::string fmt(f32 v)
+using gcode::GcodeWriter;
+
+// Receives finished text in program order (null: keep it all in the writer)
+using TextSink = std::function<void(std::string_view)>;
+
+// Passes are formatted in chunks of this many points, several chunks at a time
+constexpr usize kChunkPoints = 16384;
+constexpr usize kChunksPerWave = 16;
+
+// Buffered text is handed to the sink in blocks of at least this size
+constexpr usize kFlushBytes = usize{1} << 20;
+
+void flushIfFull(GcodeWriter& out, const TextSink& sink)
 {
-    char buf[32];
-    std::snprintf(buf, sizeof(buf), "%.3f", static_cast<double>(v));
-    // Trim trailing zeros after decimal
-    std::string s(buf);
-    auto dot = s.find('.');
-    if (dot != std::string::npos) {
-        auto last = s.find_last_not_of('0');
-        if (last == dot) {
-            s.erase(dot + 2);  // Keep at least one decimal
-        } else {
-            s.erase(last + 1);
-        }
+    if (sink && out.text().size() >= kFlushBytes) {
+        sink(out.text());
+        out.clear();
     }
-    return s;
 }
 
-void writeHeader(std::ostringstream& out,
+void writeMove(GcodeWriter& out, const ToolpathPoint& pt, f32 feedRate)
+{
+    if (pt.rapid) {
+        out.rapid(pt.position);
+    } else {
+        out.linear(pt.position, feedRate);
+    }
+}
+
+void writeHeader(GcodeWriter& out,
                  const std::string& modelName,
                  const std::string& toolName,
                  const ToolpathConfig& config)
 {
-    out << "(Direct Carve - generated by Digital Workshop)\n";
-    out << "(Model: " << modelName << ")\n";
-    out << "(Tool: " << toolName << ")\n";
-    out << "(Feed: " << fmt(config.feedRateMmMin)
-        << " mm/min, Plunge: " << fmt(config.plungeRateMmMin) << " mm/min)\n";
-    out << "(Safe Z: " << fmt(config.safeZMm) << " mm)\n";
+    out.line("(Direct Carve - generated by Digital Workshop)");
+    out.line("(Model: " + modelName + ")");
+    out.line("(Tool: " + toolName + ")");
+    out.line("(Feed: " + GcodeWriter::formatNumber(config.feedRateMmMin) +
+             " mm/min, Plunge: " + GcodeWriter::formatNumber(config.plungeRateMmMin) + " mm/min)");
+    out.line("(Safe Z: " + GcodeWriter::formatNumber(config.safeZMm) + " mm)");
 }
 
-void writePreamble(std::ostringstream& out)
+void writePreamble(GcodeWriter& out)
 {
-    out << "G90 G21 (absolute, metric)\n";
+    out.line("G90 G21 (absolute, metric)");
 }
 
-void writeToolpath(std::ostringstream& out,
+void writeToolpath(GcodeWriter& out,
                    const Toolpath& path,
                    const ToolpathConfig& config,
                    const std::string& passLabel,
-                   bool& feedDeclared)
+                   const TextSink& sink)
 {
     if (path.points.empty()) return;
 
-    out << "(" << passLabel << " - " << path.lineCount << " lines, ~"
-        << fmt(path.estimatedTimeSec / 60.0f) << " min)\n";
-
-    for (const auto& pt : path.points) {
-        if (pt.rapid) {
-            out << "G0"
-                << " X" << fmt(pt.position.x)
-                << " Y" << fmt(pt.position.y)
-                << " Z" << fmt(pt.position.z)
-                << "\n";
-        } else {
-            out << "G1"
-                << " X" << fmt(pt.position.x)
-                << " Y" << fmt(pt.position.y)
-                << " Z" << fmt(pt.position.z);
-            if (!feedDeclared) {
-                out << " F" << fmt(config.feedRateMmMin);
-                feedDeclared = true;
+    out.line("(" + passLabel + " - " + std::to_string(path.lineCount) + " lines, ~" +
+             GcodeWriter::formatNumber(path.estimatedTimeSec / 60.0f) + " min)");
+
+    const auto& points = path.points;
+    const f32 feedRate = config.feedRateMmMin;
+    const usize count = points.size();
+    const usize firstChunkEnd = std::min(count, kChunkPoints);
+
+    // Modal state entering any point is the previous point, plus the feed
+    // once the pass has cut, so chunks after the first format independently
+    const f32 feedBefore = out.feedRate();
+    const usize firstCut = static_cast<usize>(
+        std::find_if(points.begin(), points.end(), [](const ToolpathPoint& p) { return !p.rapid; }) -
+        points.begin());
+
+    for (usize i = 0; i < firstChunkEnd; ++i) {
+        writeMove(out, points[i], feedRate);
+        flushIfFull(out, sink);
+    }
+    if (firstChunkEnd == count) return;
+
+    const usize chunkCount = (count + kChunkPoints - 1) / kChunkPoints;
+    std::vector<GcodeWriter> chunks(std::min(kChunksPerWave, chunkCount - 1));
+    for (usize wave = 1; wave < chunkCount; wave += kChunksPerWave) {
+        const usize waveEnd = std::min(chunkCount, wave + kChunksPerWave);
+        parallelFor(waveEnd - wave, 1, [&](usize begin, usize end) {
+            for (usize c = begin; c < end; ++c) {
+                const usize first = (wave + c) * kChunkPoints;
+                const usize last = std::min(count, first + kChunkPoints);
+                const ToolpathPoint& prev = points[first - 1];
+                GcodeWriter& chunk = chunks[c];
+                chunk.clear();
+                chunk.setModalState(prev.position, prev.rapid, firstCut < first ? feedRate : feedBefore);
+                for (usize i = first; i < last; ++i)
+                    writeMove(chunk, points[i], feedRate);
             }
-            out << "\n";
+        });
+        for (usize c = 0; c < waveEnd - wave; ++c) {
+            out.append(chunks[c].text());
+            flushIfFull(out, sink);
         }
     }
+    out.setModalState(points.back().position, points.back().rapid,
+                      firstCut < count ? feedRate : feedBefore);
 }
 
-void writeFooter(std::ostringstream& out, f32 safeZ)
+void writeFooter(GcodeWriter& out, f32 safeZ)
 {
-    out << "G0 Z" << fmt(safeZ) << "\n";
-    out << "M5\n";
-    out << "M30\n";
+    out.retractTo(safeZ);
+    out.line("M5");
+    out.line("M30");
 }
 
-} // anonymous namespace
-
-std::string generateGcode(const MultiPassToolpath& toolpath,
-                          const ToolpathConfig& config,
-                          const std::string& modelName,
-                          const std::string& toolName)
+void writeProgram(GcodeWriter& out,
+                  const MultiPassToolpath& toolpath,
+                  const ToolpathConfig& config,
+                  const std::string& modelName,
+                  const std::string& toolName,
+                  const TextSink& sink)
 {
-    std::ostringstream out;
-
+    DW_TRACE_ZONE("G-code export");
     writeHeader(out, modelName, toolName, config);
     writePreamble(out);
 
     // Safe Z retract before starting
-    out << "G0 Z" << fmt(config.safeZMm) << "\n";
+    out.retractTo(config.safeZMm);
 
-    bool feedDeclared = false;
-
-    // Clearing pass first (if present)
-    if (!toolpath.clearing.points.empty()) {
-        writeToolpath(out, toolpath.clearing, config, "Clearing pass", feedDeclared);
-    }
-
-    // Finishing pass
-    if (!toolpath.finishing.points.empty()) {
-        writeToolpath(out, toolpath.finishing, config, "Finishing pass", feedDeclared);
-    }
+    // Clearing pass first (if present), then finishing
+    writeToolpath(out, toolpath.clearing, config, "Clearing pass", sink);
+    writeToolpath(out, toolpath.finishing, config, "Finishing pass", sink);
 
     writeFooter(out, config.safeZMm);
+}
 
-    return out.str();
+} // anonymous namespace
+
+std::string generateGcode(const MultiPassToolpath& toolpath,
+                          const ToolpathConfig& config,
+                          const std::string& modelName,
+                          const std::string& toolName)
+{
+    GcodeWriter out;
+    writeProgram(out, toolpath, config, modelName, toolName, nullptr);
+    return out.takeText();
 }
 
 bool exportGcode(const std::string& path,
@@ -124,12 +162,16 @@ bool exportGcode(const std::string& path,
                  const std::string& modelName,
                  const std::string& toolName)
 {
-    std::string gcode = generateGcode(toolpath, config, modelName, toolName);
-
     std::ofstream file(path, std::ios::out | std::ios::trunc);
     if (!file.is_open()) return false;
 
-    file << gcode;
+    auto write = [&file](std::string_view text) {
+        file.write(text.data(), static_cast<std::streamsize>(text.size()));
+    };
+    GcodeWriter out;
+    out.reserve(kFlushBytes + kChunkPoints * 64);
+    writeProgram(out, toolpath, config, modelName, toolName, write);
+    write(out.text());
     return file.good();
 }
 
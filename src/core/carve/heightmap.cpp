@@ -3,8 +3,13 @@
 #include <algorithm>
 #include <cmath>
 #include <cstring>
+#include <exception>
 #include <fstream>
 #include <limits>
+#include <mutex>
+
+#include "../threading/parallel_for.h"
+#include "../utils/trace.h"
 
 namespace dw {
 namespace carve {
@@ -112,41 +117,73 @@ f32 Heightmap::castRay(f32 rayX, f32 rayY,
     return (bestZ > -std::numeric_limits<f32>::max()) ? bestZ : defaultZ;
 }
 
-// ---- Grid construction (row-by-row) ----
+// ---- Grid construction (parallel row tiles) ----
+
+// Rows per parallel tile; also the granularity of progress and tile callbacks
+static constexpr usize kTileRows = 16;
+
 void Heightmap::buildGrid(const std::vector<TriPos>& tris,
                           const SpatialBins& bins,
-                          std::function<void(f32)> progress) {
+                          std::function<void(f32)> progress,
+                          TileCallback onTile) {
     m_grid.assign(static_cast<usize>(m_cols * m_rows), m_minZ);
     m_minZ = std::numeric_limits<f32>::max();
     m_maxZ = -std::numeric_limits<f32>::max();
 
-    const int progressInterval = std::max(1, m_rows / 100);
-
-    for (int row = 0; row < m_rows; ++row) {
-        const f32 worldY = m_boundsMin.y + static_cast<f32>(row) * m_resolution;
-        const int binRow = std::min(
-            bins.binRows - 1,
-            static_cast<int>((worldY - m_boundsMin.y) / bins.binSize));
-
-        for (int col = 0; col < m_cols; ++col) {
-            const f32 worldX = m_boundsMin.x + static_cast<f32>(col) * m_resolution;
-            const int binCol = std::min(
-                bins.binCols - 1,
-                static_cast<int>((worldX - m_boundsMin.x) / bins.binSize));
+    std::mutex callbackMutex;
+    std::exception_ptr failure;
+    int rowsDone = 0;
 
-            const auto& bucket =
-                bins.bins[static_cast<usize>(binRow * bins.binCols + binCol)];
-            const f32 z = castRay(worldX, worldY, tris, bucket, m_defaultZ);
+    parallelFor(static_cast<usize>(m_rows), kTileRows, [&](usize begin, usize end) {
+        {
+            std::lock_guard<std::mutex> lock(callbackMutex);
+            if (failure)
+                return; // Cancelled or failed: skip the remaining tiles
+        }
 
-            m_grid[static_cast<usize>(row * m_cols + col)] = z;
-            if (z < m_minZ) m_minZ = z;
-            if (z > m_maxZ) m_maxZ = z;
+        f32 tileMin = std::numeric_limits<f32>::max();
+        f32 tileMax = -std::numeric_limits<f32>::max();
+        for (int row = static_cast<int>(begin); row < static_cast<int>(end); ++row) {
+            const f32 worldY = m_boundsMin.y + static_cast<f32>(row) * m_resolution;
+            const int binRow = std::min(
+                bins.binRows - 1,
+                static_cast<int>((worldY - m_boundsMin.y) / bins.binSize));
+
+            for (int col = 0; col < m_cols; ++col) {
+                const f32 worldX = m_boundsMin.x + static_cast<f32>(col) * m_resolution;
+                const int binCol = std::min(
+                    bins.binCols - 1,
+                    static_cast<int>((worldX - m_boundsMin.x) / bins.binSize));
+
+                const auto& bucket =
+                    bins.bins[static_cast<usize>(binRow * bins.binCols + binCol)];
+                const f32 z = castRay(worldX, worldY, tris, bucket, m_defaultZ);
+
+                m_grid[static_cast<usize>(row * m_cols + col)] = z;
+                tileMin = std::min(tileMin, z);
+                tileMax = std::max(tileMax, z);
+            }
         }
 
-        if (progress && (row % progressInterval == 0 || row == m_rows - 1)) {
-            progress(static_cast<f32>(row + 1) / static_cast<f32>(m_rows));
+        std::lock_guard<std::mutex> lock(callbackMutex);
+        m_minZ = std::min(m_minZ, tileMin);
+        m_maxZ = std::max(m_maxZ, tileMax);
+        rowsDone += static_cast<int>(end - begin);
+        if (failure)
+            return;
+        try {
+            if (onTile)
+                onTile(*this, static_cast<int>(begin), static_cast<int>(end));
+            if (progress)
+                progress(static_cast<f32>(rowsDone) / static_cast<f32>(m_rows));
+        } catch (...) {
+            failure = std::current_exception();
         }
-    }
+    });
+
+    if (failure)
+        std::rethrow_exception(failure);
+    m_pyramid.build(m_grid.data(), m_cols, m_rows);
 }
 
 // ---- Public API ----
@@ -154,7 +191,52 @@ void Heightmap::build(const std::vector<Vertex>& vertices,
                       const std::vector<u32>& indices,
                       const Vec3& boundsMin, const Vec3& boundsMax,
                       const HeightmapConfig& config,
-                      std::function<void(f32)> progress) {
+                      std::function<void(f32)> progress,
+                      TileCallback onTile) {
+    DW_TRACE_ZONE("Heightmap build");
+    if (!beginBuild(boundsMin, boundsMax, indices.size(), config))
+        return;
+
+    // Build TriPos array from indexed vertices
+    const usize triCount = indices.size() / 3;
+    std::vector<TriPos> tris;
+    tris.reserve(triCount);
+    for (usize i = 0; i < triCount; ++i) {
+        tris.push_back(makeTriPos(vertices[indices[i * 3 + 0]].position,
+                                  vertices[indices[i * 3 + 1]].position,
+                                  vertices[indices[i * 3 + 2]].position));
+    }
+
+    auto bins = binTriangles(tris, boundsMin, boundsMax);
+    buildGrid(tris, bins, std::move(progress), std::move(onTile));
+}
+
+void Heightmap::build(const CompactMesh& mesh,
+                      const Vec3& boundsMin, const Vec3& boundsMax,
+                      const HeightmapConfig& config,
+                      std::function<void(f32)> progress,
+                      TileCallback onTile) {
+    DW_TRACE_ZONE("Heightmap build");
+    if (!beginBuild(boundsMin, boundsMax, mesh.indexCount(), config))
+        return;
+
+    // Dequantize straight into TriPos; the full-precision mesh is never materialized
+    const u32 triCount = mesh.triangleCount();
+    std::vector<TriPos> tris;
+    tris.reserve(triCount);
+    for (u32 i = 0; i < triCount; ++i) {
+        tris.push_back(makeTriPos(mesh.position(mesh.index(i * 3 + 0)),
+                                  mesh.position(mesh.index(i * 3 + 1)),
+                                  mesh.position(mesh.index(i * 3 + 2))));
+    }
+
+    auto bins = binTriangles(tris, boundsMin, boundsMax);
+    buildGrid(tris, bins, std::move(progress), std::move(onTile));
+}
+
+bool Heightmap::beginBuild(const Vec3& boundsMin, const Vec3& boundsMax,
+                           usize indexCount,
+                           const HeightmapConfig& config) {
     m_boundsMin = boundsMin;
     m_boundsMax = boundsMax;
     m_resolution = config.resolutionMm;
@@ -163,39 +245,31 @@ void Heightmap::build(const std::vector<Vertex>& vertices,
     const f32 spanX = boundsMax.x - boundsMin.x;
     const f32 spanY = boundsMax.y - boundsMin.y;
 
-    if (spanX < 1e-6f || spanY < 1e-6f || indices.size() < 3) {
+    m_pyramid.clear();
+    if (spanX < 1e-6f || spanY < 1e-6f || indexCount < 3) {
         m_grid.clear();
         m_cols = 0;
         m_rows = 0;
         m_minZ = 0.0f;
         m_maxZ = 0.0f;
-        return;
+        return false;
     }
 
     m_cols = std::max(1, static_cast<int>(std::ceil(spanX / m_resolution)));
     m_rows = std::max(1, static_cast<int>(std::ceil(spanY / m_resolution)));
+    return true;
+}
 
-    // Build TriPos array from indexed vertices
-    const usize triCount = indices.size() / 3;
-    std::vector<TriPos> tris;
-    tris.reserve(triCount);
-    for (usize i = 0; i < triCount; ++i) {
-        const Vec3& a = vertices[indices[i * 3 + 0]].position;
-        const Vec3& b = vertices[indices[i * 3 + 1]].position;
-        const Vec3& c = vertices[indices[i * 3 + 2]].position;
-        TriPos tp;
-        tp.a = a;
-        tp.b = b;
-        tp.c = c;
-        tp.minX = std::min({a.x, b.x, c.x});
-        tp.maxX = std::max({a.x, b.x, c.x});
-        tp.minY = std::min({a.y, b.y, c.y});
-        tp.maxY = std::max({a.y, b.y, c.y});
-        tris.push_back(tp);
-    }
-
-    auto bins = binTriangles(tris, boundsMin, boundsMax);
-    buildGrid(tris, bins, std::move(progress));
+Heightmap::TriPos Heightmap::makeTriPos(const Vec3& a, const Vec3& b, const Vec3& c) {
+    TriPos tp;
+    tp.a = a;
+    tp.b = b;
+    tp.c = c;
+    tp.minX = std::min({a.x, b.x, c.x});
+    tp.maxX = std::max({a.x, b.x, c.x});
+    tp.minY = std::min({a.y, b.y, c.y});
+    tp.maxY = std::max({a.y, b.y, c.y});
+    return tp;
 }
 
 f32 Heightmap::at(int col, int row) const {
@@ -241,6 +315,73 @@ f32 Heightmap::atMm(f32 x, f32 y) const {
     return top * (1.0f - ty) + bot * ty;
 }
 
+Heightmap Heightmap::fromGrid(int cols, int rows, f32 resolution,
+                             const Vec3& boundsMin, const Vec3& boundsMax,
+                             std::vector<f32> grid) {
+    Heightmap hm;
+    if (cols <= 0 || rows <= 0 ||
+        grid.size() != static_cast<usize>(cols) * static_cast<usize>(rows))
+        return hm;
+
+    hm.m_cols = cols;
+    hm.m_rows = rows;
+    hm.m_resolution = resolution;
+    hm.m_boundsMin = boundsMin;
+    hm.m_boundsMax = boundsMax;
+    hm.m_grid = std::move(grid);
+    const auto [lo, hi] = std::minmax_element(hm.m_grid.begin(), hm.m_grid.end());
+    hm.m_minZ = *lo;
+    hm.m_maxZ = *hi;
+    hm.m_pyramid.build(hm.m_grid.data(), cols, rows);
+    return hm;
+}
+
+void Heightmap::resampleRows(const Heightmap& source, int rowBegin, int rowEnd) {
+    if (empty() || source.empty() || rowBegin >= rowEnd)
+        return;
+
+    const f32 srcRes = source.resolution();
+    const Vec3 srcMin = source.boundsMin();
+    for (int row = 0; row < m_rows; ++row) {
+        const f32 worldY = m_boundsMin.y + static_cast<f32>(row) * m_resolution;
+        const int srcRow = static_cast<int>(std::lround((worldY - srcMin.y) / srcRes));
+        if (srcRow < rowBegin || srcRow >= rowEnd || srcRow >= source.rows())
+            continue;
+        for (int col = 0; col < m_cols; ++col) {
+            const f32 worldX = m_boundsMin.x + static_cast<f32>(col) * m_resolution;
+            const int srcCol = std::clamp(
+                static_cast<int>(std::lround((worldX - srcMin.x) / srcRes)), 0, source.cols() - 1);
+            m_grid[static_cast<usize>(row * m_cols + col)] = source.at(srcCol, srcRow);
+        }
+    }
+
+    const auto [lo, hi] = std::minmax_element(m_grid.begin(), m_grid.end());
+    m_minZ = *lo;
+    m_maxZ = *hi;
+    m_pyramid.build(m_grid.data(), m_cols, m_rows);
+}
+
+void Heightmap::cellRange(f32 x0, f32 y0, f32 x1, f32 y1,
+                          int& col0, int& row0, int& col1, int& row1) const {
+    // atMm() blends the cell at floor(f) with its +1 neighbor
+    col0 = static_cast<int>(std::floor((std::min(x0, x1) - m_boundsMin.x) / m_resolution));
+    row0 = static_cast<int>(std::floor((std::min(y0, y1) - m_boundsMin.y) / m_resolution));
+    col1 = static_cast<int>(std::floor((std::max(x0, x1) - m_boundsMin.x) / m_resolution)) + 1;
+    row1 = static_cast<int>(std::floor((std::max(y0, y1) - m_boundsMin.y) / m_resolution)) + 1;
+}
+
+f32 Heightmap::minBoundMm(f32 x0, f32 y0, f32 x1, f32 y1) const {
+    int col0 = 0, row0 = 0, col1 = 0, row1 = 0;
+    cellRange(x0, y0, x1, y1, col0, row0, col1, row1);
+    return m_pyramid.minBound(col0, row0, col1, row1);
+}
+
+f32 Heightmap::maxBoundMm(f32 x0, f32 y0, f32 x1, f32 y1) const {
+    int col0 = 0, row0 = 0, col1 = 0, row1 = 0;
+    cellRange(x0, y0, x1, y1, col0, row0, col1, row1);
+    return m_pyramid.maxBound(col0, row0, col1, row1);
+}
+
 // ---- Persistence: binary .dwhm format ----
 
 static constexpr u32 DWHM_MAGIC   = 0x4D485744; // "DWHM"
@@ -273,6 +414,7 @@ bool Heightmap::save(const std::string& path) const {
 bool Heightmap::load(const std::string& path) {
     std::ifstream f(path, std::ios::binary);
     if (!f.is_open()) return false;
+    m_pyramid.clear();
 
     u32 magic = 0, version = 0;
     f.read(reinterpret_cast<char*>(&magic), 4);
@@ -293,8 +435,11 @@ bool Heightmap::load(const std::string& path) {
     m_grid.resize(count);
     f.read(reinterpret_cast<char*>(m_grid.data()),
            static_cast<std::streamsize>(count * sizeof(f32)));
+    if (!f.good())
+        return false;
 
-    return f.good();
+    m_pyramid.build(m_grid.data(), m_cols, m_rows);
+    return true;
 }
 
 bool Heightmap::exportPng(const std::string& path) const {
@@ -1,7 +1,9 @@
 #pragma once
 
+#include "../mesh/compact_mesh.h"
 #include "../mesh/vertex.h"
 #include "../types.h"
+#include "heightmap_pyramid.h"
 
 #include <functional>
 #include <string>
@@ -17,20 +19,45 @@ struct HeightmapConfig {
 
 class Heightmap {
   public:
+    /// Receives grid rows [rowBegin, rowEnd) as soon as they are final. Only
+    /// those rows of the partial heightmap may be read inside the callback.
+    using TileCallback = std::function<void(const Heightmap& partial, int rowBegin, int rowEnd)>;
+
     Heightmap() = default;
 
-    /// Build from mesh vertex/index data (caller manages threading).
+    /// Build from mesh vertex/index data. Rows are ray cast in parallel tiles;
+    /// the progress and tile callbacks are serialized, and an exception thrown
+    /// from either stops the remaining tiles and propagates out of build().
     /// @param vertices  Mesh vertex array
     /// @param indices   Triangle indices (groups of 3)
     /// @param boundsMin Minimum corner of mesh AABB
     /// @param boundsMax Maximum corner of mesh AABB
     /// @param config    Grid resolution and default Z
     /// @param progress  Optional callback receiving [0.0, 1.0]
+    /// @param onTile    Optional callback receiving each finished row tile
     void build(const std::vector<Vertex>& vertices,
                const std::vector<u32>& indices,
                const Vec3& boundsMin, const Vec3& boundsMax,
                const HeightmapConfig& config,
-               std::function<void(f32)> progress = nullptr);
+               std::function<void(f32)> progress = nullptr,
+               TileCallback onTile = nullptr);
+
+    /// Build from a quantized mesh, decoding positions per triangle
+    void build(const CompactMesh& mesh,
+               const Vec3& boundsMin, const Vec3& boundsMax,
+               const HeightmapConfig& config,
+               std::function<void(f32)> progress = nullptr,
+               TileCallback onTile = nullptr);
+
+    /// Wrap an existing row-major grid (cols * rows values)
+    static Heightmap fromGrid(int cols, int rows, f32 resolution,
+                              const Vec3& boundsMin, const Vec3& boundsMax,
+                              std::vector<f32> grid);
+
+    /// Overwrite the cells whose centers fall on rows [rowBegin, rowEnd) of a
+    /// finer heightmap over the same bounds, point-sampling it. Used to stream
+    /// a full-resolution build into a coarse preview.
+    void resampleRows(const Heightmap& source, int rowBegin, int rowEnd);
 
     // Grid accessors
     f32 at(int col, int row) const;
@@ -46,6 +73,12 @@ class Heightmap {
     f32 minZ() const { return m_minZ; }
     f32 maxZ() const { return m_maxZ; }
 
+    // Conservative bounds of atMm() over the world rectangle [x0, x1] x [y0, y1],
+    // answered from the min/max pyramid in constant time
+    f32 minBoundMm(f32 x0, f32 y0, f32 x1, f32 y1) const;
+    f32 maxBoundMm(f32 x0, f32 y0, f32 x1, f32 y1) const;
+    const HeightmapPyramid& pyramid() const { return m_pyramid; }
+
     // Persistence — binary .dwhm format (Digital Workshop HeightMap)
     // Header: magic(4) + version(4) + cols(4) + rows(4) + resolution(4)
     //         + boundsMin(12) + boundsMax(12) + minZ(4) + maxZ(4) = 52 bytes
@@ -71,9 +104,19 @@ class Heightmap {
         f32 binSize = 1.0f;
     };
 
+    // Set up grid dimensions; false (and an empty grid) for degenerate input
+    bool beginBuild(const Vec3& boundsMin, const Vec3& boundsMax,
+                    usize indexCount,
+                    const HeightmapConfig& config);
+    static TriPos makeTriPos(const Vec3& a, const Vec3& b, const Vec3& c);
+
     void buildGrid(const std::vector<TriPos>& tris,
                    const SpatialBins& bins,
-                   std::function<void(f32)> progress);
+                   std::function<void(f32)> progress,
+                   TileCallback onTile);
+    // Grid cells whose bilinear footprint covers the world rectangle
+    void cellRange(f32 x0, f32 y0, f32 x1, f32 y1,
+                   int& col0, int& row0, int& col1, int& row1) const;
     static SpatialBins binTriangles(const std::vector<TriPos>& tris,
                                     const Vec3& boundsMin,
                                     const Vec3& boundsMax);
@@ -91,6 +134,7 @@ class Heightmap {
     f32 m_minZ = 0.0f;
     f32 m_maxZ = 0.0f;
     f32 m_defaultZ = 0.0f;
+    HeightmapPyramid m_pyramid;
 };
 
 } // namespace carve
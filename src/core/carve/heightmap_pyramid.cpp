@@ -0,0 +1,121 @@
+#include "heightmap_pyramid.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace dw {
+namespace carve {
+
+namespace {
+
+// Query rectangles span at most this many cells per axis at the chosen level
+constexpr int kQuerySpan = 4;
+
+} // namespace
+
+void HeightmapPyramid::clear() {
+    m_levels.clear();
+    m_baseCols = 0;
+    m_baseRows = 0;
+}
+
+void HeightmapPyramid::build(const f32* grid, int cols, int rows) {
+    clear();
+    if (!grid || cols <= 0 || rows <= 0)
+        return;
+    m_baseCols = cols;
+    m_baseRows = rows;
+
+    // Level 1 straight from the base grid, then halve until a single cell
+    int srcCols = cols;
+    int srcRows = rows;
+    const f32* srcMin = grid;
+    const f32* srcMax = grid;
+    do {
+        Level level;
+        level.cols = (srcCols + 1) / 2;
+        level.rows = (srcRows + 1) / 2;
+        const auto count = static_cast<usize>(level.cols) * static_cast<usize>(level.rows);
+        level.minZ.resize(count);
+        level.maxZ.resize(count);
+
+        auto src = [srcCols](int r, int c) {
+            return static_cast<usize>(r) * static_cast<usize>(srcCols) + static_cast<usize>(c);
+        };
+        for (int r = 0; r < level.rows; ++r) {
+            const int r0 = r * 2;
+            const int r1 = std::min(r0 + 1, srcRows - 1);
+            for (int c = 0; c < level.cols; ++c) {
+                const int c0 = c * 2;
+                const int c1 = std::min(c0 + 1, srcCols - 1);
+                const usize dst =
+                    static_cast<usize>(r) * static_cast<usize>(level.cols) + static_cast<usize>(c);
+                level.minZ[dst] = std::min({srcMin[src(r0, c0)], srcMin[src(r0, c1)],
+                                            srcMin[src(r1, c0)], srcMin[src(r1, c1)]});
+                level.maxZ[dst] = std::max({srcMax[src(r0, c0)], srcMax[src(r0, c1)],
+                                            srcMax[src(r1, c0)], srcMax[src(r1, c1)]});
+            }
+        }
+
+        m_levels.push_back(std::move(level));
+        const Level& made = m_levels.back();
+        srcCols = made.cols;
+        srcRows = made.rows;
+        srcMin = made.minZ.data();
+        srcMax = made.maxZ.data();
+    } while (srcCols > 1 || srcRows > 1);
+}
+
+int HeightmapPyramid::pickLevel(int& col0, int& row0, int& col1, int& row1) const {
+    col0 = std::clamp(col0, 0, m_baseCols - 1);
+    col1 = std::clamp(col1, 0, m_baseCols - 1);
+    row0 = std::clamp(row0, 0, m_baseRows - 1);
+    row1 = std::clamp(row1, 0, m_baseRows - 1);
+    if (col1 < col0)
+        std::swap(col0, col1);
+    if (row1 < row0)
+        std::swap(row0, row1);
+
+    int index = 0;
+    int shift = 1;
+    while (index + 1 < levelCount() &&
+           ((col1 >> shift) - (col0 >> shift) >= kQuerySpan ||
+            (row1 >> shift) - (row0 >> shift) >= kQuerySpan)) {
+        ++index;
+        ++shift;
+    }
+    col0 >>= shift;
+    col1 >>= shift;
+    row0 >>= shift;
+    row1 >>= shift;
+    return index;
+}
+
+f32 HeightmapPyramid::minBound(int col0, int row0, int col1, int row1) const {
+    if (empty())
+        return std::numeric_limits<f32>::lowest();
+    const Level& level = m_levels[static_cast<usize>(pickLevel(col0, row0, col1, row1))];
+    f32 result = std::numeric_limits<f32>::max();
+    for (int r = row0; r <= row1; ++r) {
+        const f32* row = &level.minZ[static_cast<usize>(r) * static_cast<usize>(level.cols)];
+        for (int c = col0; c <= col1; ++c)
+            result = std::min(result, row[c]);
+    }
+    return result;
+}
+
+f32 HeightmapPyramid::maxBound(int col0, int row0, int col1, int row1) const {
+    if (empty())
+        return std::numeric_limits<f32>::max();
+    const Level& level = m_levels[static_cast<usize>(pickLevel(col0, row0, col1, row1))];
+    f32 result = std::numeric_limits<f32>::lowest();
+    for (int r = row0; r <= row1; ++r) {
+        const f32* row = &level.maxZ[static_cast<usize>(r) * static_cast<usize>(level.cols)];
+        for (int c = col0; c <= col1; ++c)
+            result = std::max(result, row[c]);
+    }
+    return result;
+}
+
+} // namespace carve
+} // namespace dw
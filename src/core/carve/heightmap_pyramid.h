@@ -0,0 +1,50 @@
+#pragma once
+
+#include "../types.h"
+
+#include <vector>
+
+namespace dw {
+namespace carve {
+
+// Min/max mip chain over a row-major height grid.
+//
+// Level k (k >= 1) stores, for each 2^k x 2^k block of base cells, the lowest
+// and highest height in the block (partial blocks at the right/bottom edges
+// cover what is left). Rectangle queries read at most 4 x 4 cells of the
+// coarsest level that keeps the rectangle that small, so they return
+// conservative bounds in O(1) rather than exact extrema.
+class HeightmapPyramid {
+  public:
+    HeightmapPyramid() = default;
+
+    // Rebuild from a cols x rows grid; an empty grid clears the pyramid
+    void build(const f32* grid, int cols, int rows);
+    void clear();
+
+    bool empty() const { return m_levels.empty(); }
+    int levelCount() const { return static_cast<int>(m_levels.size()); }
+
+    // Bounds over base cells [col0, col1] x [row0, row1] (inclusive, clamped to
+    // the grid): every height in the rectangle lies in [minBound, maxBound]
+    f32 minBound(int col0, int row0, int col1, int row1) const;
+    f32 maxBound(int col0, int row0, int col1, int row1) const;
+
+  private:
+    struct Level {
+        int cols = 0;
+        int rows = 0;
+        std::vector<f32> minZ;
+        std::vector<f32> maxZ;
+    };
+
+    // Level index and clamped cell range covering the base rectangle
+    int pickLevel(int& col0, int& row0, int& col1, int& row1) const;
+
+    std::vector<Level> m_levels; // m_levels[0] is mip level 1 (2x2 blocks)
+    int m_baseCols = 0;
+    int m_baseRows = 0;
+};
+
+} // namespace carve
+} // namespace dw
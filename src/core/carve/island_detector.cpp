@@ -3,13 +3,35 @@
 #include <algorithm>
 #include <cmath>
 #include <limits>
-#include <queue>
+
+#include "../threading/parallel_for.h"
 
 namespace dw {
 namespace carve {
 
 namespace {
 
+// Rows per parallel band; bands are labeled independently and stitched after
+constexpr usize ROW_GRAIN = 64;
+// Columns per chunk of the vertical distance pass (row-major inner loop)
+constexpr usize COL_GRAIN = 256;
+
+constexpr u32 FAR = std::numeric_limits<u32>::max() / 4;
+
+// Maximal horizontal run of buried cells
+struct Run {
+    int row = 0;
+    int colBegin = 0;
+    int colEnd = 0;
+};
+
+// Per-run statistics gathered during the distance transform
+struct RunStats {
+    f32 minZ = std::numeric_limits<f32>::max();
+    f32 maxZ = std::numeric_limits<f32>::lowest();
+    f32 maxDist2 = 0.0f; // Squared distance (cells) to the nearest accessible cell
+};
+
 // Compute burial mask: 1 = buried (tool can't reach), 0 = accessible
 std::vector<u8> computeBurialMask(const Heightmap& hm, f32 toolAngleDeg) {
     const int cols = hm.cols();
@@ -18,66 +40,77 @@ std::vector<u8> computeBurialMask(const Heightmap& hm, f32 toolAngleDeg) {
 
     // Half-angle taper slope: how much Z the taper covers per unit XY distance
     const f32 halfAngleRad = (toolAngleDeg * 0.5f) * (3.14159265f / 180.0f);
-    const f32 taperSlope = std::tan(halfAngleRad);
+    const f32 reach = res * std::tan(halfAngleRad);
 
-    std::vector<u8> mask(static_cast<usize>(cols * rows), 1);  // Start all buried
+    // Start all buried
+    std::vector<u8> mask(static_cast<usize>(cols) * static_cast<usize>(rows), 1);
 
-    // A cell is accessible if from at least one cardinal neighbor,
-    // the height difference is within what the taper can reach
     const int dx[] = {-1, 1, 0, 0};
     const int dy[] = {0, 0, -1, 1};
 
+    // A cell is accessible if from at least one cardinal neighbor, the height
+    // difference is within what the taper can reach. Rows are independent.
+    parallelFor(static_cast<usize>(rows), ROW_GRAIN, [&](usize begin, usize end) {
+        for (int row = static_cast<int>(begin); row < static_cast<int>(end); ++row) {
+            u8* maskRow = mask.data() + static_cast<usize>(row) * static_cast<usize>(cols);
+            for (int col = 0; col < cols; ++col) {
+                // Border cells are always accessible (open edge)
+                if (col == 0 || col == cols - 1 || row == 0 || row == rows - 1) {
+                    maskRow[col] = 0;
+                    continue;
+                }
+                const f32 z = hm.at(col, row);
+                for (int d = 0; d < 4; ++d) {
+                    if (hm.at(col + dx[d], row + dy[d]) - z <= reach) {
+                        maskRow[col] = 0;
+                        break;
+                    }
+                }
+            }
+        }
+    });
+
+    // Propagate accessibility from every accessible cell: a buried cell becomes
+    // accessible if an accessible neighbor can reach it. Reachability does not
+    // depend on visit order, so a flat index stack replaces the BFS queue, and
+    // only accessible cells bordering a buried one need seeding.
+    auto index = [cols](int c, int r) {
+        return static_cast<usize>(r) * static_cast<usize>(cols) + static_cast<usize>(c);
+    };
+    std::vector<u32> stack;
     for (int row = 0; row < rows; ++row) {
         for (int col = 0; col < cols; ++col) {
-            const f32 z = hm.at(col, row);
-            // Border cells are always accessible (open edge)
-            if (col == 0 || col == cols - 1 || row == 0 || row == rows - 1) {
-                mask[static_cast<usize>(row * cols + col)] = 0;
+            if (mask[index(col, row)] != 0)
                 continue;
-            }
             for (int d = 0; d < 4; ++d) {
                 const int nc = col + dx[d];
                 const int nr = row + dy[d];
-                const f32 nz = hm.at(nc, nr);
-                // The taper can access this cell if neighbor is higher by
-                // at most taperSlope * distance
-                if (nz - z <= res * taperSlope) {
-                    mask[static_cast<usize>(row * cols + col)] = 0;
+                if (nc >= 0 && nc < cols && nr >= 0 && nr < rows && mask[index(nc, nr)] != 0) {
+                    stack.push_back(static_cast<u32>(index(col, row)));
                     break;
                 }
             }
         }
     }
 
-    // Propagate accessibility: BFS from all accessible cells
-    // A buried cell becomes accessible if an accessible neighbor can reach it
-    std::queue<std::pair<int, int>> queue;
-    for (int row = 0; row < rows; ++row) {
-        for (int col = 0; col < cols; ++col) {
-            if (mask[static_cast<usize>(row * cols + col)] == 0) {
-                queue.push({col, row});
-            }
-        }
-    }
-
-    while (!queue.empty()) {
-        auto [c, r] = queue.front();
-        queue.pop();
+    while (!stack.empty()) {
+        const u32 cell = stack.back();
+        stack.pop_back();
+        const int c = static_cast<int>(cell % static_cast<u32>(cols));
+        const int r = static_cast<int>(cell / static_cast<u32>(cols));
         const f32 z = hm.at(c, r);
         for (int d = 0; d < 4; ++d) {
             const int nc = c + dx[d];
             const int nr = r + dy[d];
-            if (nc < 0 || nc >= cols || nr < 0 || nr >= rows) {
+            if (nc < 0 || nc >= cols || nr < 0 || nr >= rows)
                 continue;
-            }
-            if (mask[static_cast<usize>(nr * cols + nc)] == 0) {
-                continue;  // Already accessible
-            }
-            const f32 nz = hm.at(nc, nr);
+            const usize nidx = index(nc, nr);
+            if (mask[nidx] == 0)
+                continue; // Already accessible
             // Check if accessible cell at z can reach buried cell at nz
-            if (nz - z <= res * taperSlope) {
-                mask[static_cast<usize>(nr * cols + nc)] = 0;
-                queue.push({nc, nr});
+            if (hm.at(nc, nr) - z <= reach) {
+                mask[nidx] = 0;
+                stack.push_back(static_cast<u32>(nidx));
             }
         }
     }
@@ -85,101 +118,203 @@ std::vector<u8> computeBurialMask(const Heightmap& hm, f32 toolAngleDeg) {
     return mask;
 }
 
-// Flood-fill connected buried regions into islands
-std::vector<std::vector<std::pair<int, int>>> floodFillIslands(
-    const std::vector<u8>& burialMask, int cols, int rows) {
-    std::vector<std::vector<std::pair<int, int>>> groups;
-    std::vector<bool> visited(static_cast<usize>(cols * rows), false);
-
-    const int dx[] = {-1, 1, 0, 0};
-    const int dy[] = {0, 0, -1, 1};
-
-    for (int row = 0; row < rows; ++row) {
-        for (int col = 0; col < cols; ++col) {
-            const auto idx = static_cast<usize>(row * cols + col);
-            if (burialMask[idx] == 0 || visited[idx]) {
+// Extract row runs of buried cells; rowStart[r]..rowStart[r + 1] index row r's runs
+std::vector<Run> extractRuns(const std::vector<u8>& mask, int cols, int rows,
+                             std::vector<usize>& rowStart) {
+    auto scanRow = [&](int row, Run* out) {
+        const u8* maskRow = mask.data() + static_cast<usize>(row) * static_cast<usize>(cols);
+        usize count = 0;
+        int col = 0;
+        while (col < cols) {
+            if (maskRow[col] == 0) {
+                ++col;
                 continue;
             }
-            // BFS flood-fill
-            std::vector<std::pair<int, int>> group;
-            std::queue<std::pair<int, int>> queue;
-            queue.push({col, row});
-            visited[idx] = true;
-
-            while (!queue.empty()) {
-                auto [c, r] = queue.front();
-                queue.pop();
-                group.push_back({c, r});
-                for (int d = 0; d < 4; ++d) {
-                    const int nc = c + dx[d];
-                    const int nr = r + dy[d];
-                    if (nc < 0 || nc >= cols || nr < 0 || nr >= rows) {
-                        continue;
-                    }
-                    const auto nidx = static_cast<usize>(nr * cols + nc);
-                    if (burialMask[nidx] == 0 || visited[nidx]) {
-                        continue;
-                    }
-                    visited[nidx] = true;
-                    queue.push({nc, nr});
-                }
-            }
-            groups.push_back(std::move(group));
+            const int begin = col;
+            while (col < cols && maskRow[col] != 0)
+                ++col;
+            if (out)
+                out[count] = Run{row, begin, col};
+            ++count;
         }
+        return count;
+    };
+
+    rowStart.assign(static_cast<usize>(rows) + 1, 0);
+    parallelFor(static_cast<usize>(rows), ROW_GRAIN, [&](usize begin, usize end) {
+        for (usize row = begin; row < end; ++row)
+            rowStart[row + 1] = scanRow(static_cast<int>(row), nullptr);
+    });
+    for (usize row = 0; row < static_cast<usize>(rows); ++row)
+        rowStart[row + 1] += rowStart[row];
+
+    std::vector<Run> runs(rowStart.back());
+    parallelFor(static_cast<usize>(rows), ROW_GRAIN, [&](usize begin, usize end) {
+        for (usize row = begin; row < end; ++row)
+            scanRow(static_cast<int>(row), runs.data() + rowStart[row]);
+    });
+    return runs;
+}
+
+// Union-find over runs. The root of a set is always its smallest run index,
+// i.e. the component's first run in raster order.
+u32 findRoot(std::vector<u32>& parent, u32 i) {
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]]; // Path halving
+        i = parent[i];
     }
-    return groups;
+    return i;
 }
 
-// BFS from island boundary inward to find maximum interior distance
-f32 maxDistanceFromRim(const std::vector<std::pair<int, int>>& cells,
-                       const std::vector<u8>& burialMask, int cols, int rows, f32 res) {
-    // Build a set for fast lookup
-    std::vector<int> dist(static_cast<usize>(cols * rows), -1);
-    std::queue<std::pair<int, int>> queue;
+void unite(std::vector<u32>& parent, u32 a, u32 b) {
+    a = findRoot(parent, a);
+    b = findRoot(parent, b);
+    if (a < b)
+        parent[b] = a;
+    else if (b < a)
+        parent[a] = b;
+}
 
-    const int dx[] = {-1, 1, 0, 0};
-    const int dy[] = {0, 0, -1, 1};
+// Join 4-connected runs of two adjacent rows (column ranges that overlap)
+void uniteRows(const std::vector<Run>& runs, const std::vector<usize>& rowStart,
+               std::vector<u32>& parent, usize upper, usize lower) {
+    usize a = rowStart[upper];
+    usize b = rowStart[lower];
+    const usize aEnd = rowStart[upper + 1];
+    const usize bEnd = rowStart[lower + 1];
+    while (a < aEnd && b < bEnd) {
+        if (runs[a].colBegin < runs[b].colEnd && runs[b].colBegin < runs[a].colEnd)
+            unite(parent, static_cast<u32>(a), static_cast<u32>(b));
+        if (runs[a].colEnd < runs[b].colEnd)
+            ++a;
+        else
+            ++b;
+    }
+}
 
-    // Find boundary cells (island cells adjacent to non-island)
-    for (const auto& [c, r] : cells) {
-        bool isBoundary = false;
-        for (int d = 0; d < 4; ++d) {
-            const int nc = c + dx[d];
-            const int nr = r + dy[d];
-            if (nc < 0 || nc >= cols || nr < 0 || nr >= rows ||
-                burialMask[static_cast<usize>(nr * cols + nc)] == 0) {
-                isBoundary = true;
-                break;
+// Label connected buried regions. Returns the component of each run; components
+// are numbered in raster order of their first cell.
+std::vector<int> labelRuns(const std::vector<Run>& runs, const std::vector<usize>& rowStart,
+                           int rows, int& componentCount) {
+    std::vector<u32> parent(runs.size());
+    for (usize i = 0; i < parent.size(); ++i)
+        parent[i] = static_cast<u32>(i);
+
+    // Each band only touches its own runs, so bands label in parallel...
+    parallelFor(static_cast<usize>(rows), ROW_GRAIN, [&](usize begin, usize end) {
+        for (usize row = begin + 1; row < end; ++row)
+            uniteRows(runs, rowStart, parent, row - 1, row);
+    });
+    // ...and the seams between bands are stitched afterwards
+    for (usize row = ROW_GRAIN; row < static_cast<usize>(rows); row += ROW_GRAIN)
+        uniteRows(runs, rowStart, parent, row - 1, row);
+
+    std::vector<int> component(runs.size());
+    componentCount = 0;
+    for (usize i = 0; i < runs.size(); ++i) {
+        const u32 root = findRoot(parent, static_cast<u32>(i));
+        component[i] = root == i ? componentCount++ : component[root];
+    }
+    return component;
+}
+
+// Exact squared Euclidean distance transform (Felzenszwalb-Huttenlocher) of
+// the buried mask: distance in cells from each buried cell to the nearest
+// accessible cell, with everything outside the grid counting as accessible.
+// Only the per-run maxima are kept, together with the run's Z range.
+std::vector<RunStats> measureRuns(const Heightmap& hm,
+                                  const std::vector<u8>& mask,
+                                  const std::vector<Run>& runs,
+                                  const std::vector<usize>& rowStart) {
+    const int cols = hm.cols();
+    const int rows = hm.rows();
+    const usize stride = static_cast<usize>(cols);
+
+    // Vertical pass: distance to the nearest accessible cell in the same column.
+    // Column chunks sweep rows in order so the inner loop stays contiguous.
+    std::vector<u32> vertical(stride * static_cast<usize>(rows));
+    parallelFor(stride, COL_GRAIN, [&](usize begin, usize end) {
+        for (int row = 0; row < rows; ++row) {
+            const usize base = static_cast<usize>(row) * stride;
+            for (usize col = begin; col < end; ++col) {
+                if (mask[base + col] == 0)
+                    vertical[base + col] = 0;
+                else
+                    vertical[base + col] =
+                        row == 0 ? 1 : std::min(vertical[base - stride + col] + 1, FAR);
             }
         }
-        if (isBoundary) {
-            dist[static_cast<usize>(r * cols + c)] = 0;
-            queue.push({c, r});
+        for (int row = rows - 1; row >= 0; --row) {
+            const usize base = static_cast<usize>(row) * stride;
+            for (usize col = begin; col < end; ++col) {
+                const u32 below = row == rows - 1 ? 1 : vertical[base + stride + col] + 1;
+                vertical[base + col] = std::min(vertical[base + col], below);
+            }
         }
-    }
+    });
+
+    // Horizontal pass per row: lower envelope of parabolas x -> (x - q)^2 + g(q)^2
+    std::vector<RunStats> stats(runs.size());
+    parallelFor(static_cast<usize>(rows), ROW_GRAIN, [&](usize begin, usize end) {
+        std::vector<f32> dist2(stride);
+        std::vector<int> apex(stride);
+        std::vector<f32> boundary(stride + 1);
+        for (usize row = begin; row < end; ++row) {
+            if (rowStart[row] == rowStart[row + 1])
+                continue; // Nothing buried in this row
+            const u32* g = vertical.data() + row * stride;
+            auto height = [g](int q) {
+                const f32 v = static_cast<f32>(g[q]);
+                return v * v;
+            };
+
+            int k = -1;
+            for (int q = 0; q < cols; ++q) {
+                if (g[q] >= FAR)
+                    continue;
+                const f32 fq = height(q) + static_cast<f32>(q) * static_cast<f32>(q);
+                f32 s = 0.0f;
+                while (k >= 0) {
+                    const int p = apex[static_cast<usize>(k)];
+                    s = (fq - height(p) - static_cast<f32>(p) * static_cast<f32>(p)) /
+                        (2.0f * static_cast<f32>(q - p));
+                    if (s > boundary[static_cast<usize>(k)])
+                        break;
+                    --k;
+                }
+                ++k;
+                apex[static_cast<usize>(k)] = q;
+                boundary[static_cast<usize>(k)] = k == 0 ? std::numeric_limits<f32>::lowest() : s;
+                boundary[static_cast<usize>(k) + 1] = std::numeric_limits<f32>::max();
+            }
 
-    int maxDist = 0;
-    while (!queue.empty()) {
-        auto [c, r] = queue.front();
-        queue.pop();
-        const int curDist = dist[static_cast<usize>(r * cols + c)];
-        for (int d = 0; d < 4; ++d) {
-            const int nc = c + dx[d];
-            const int nr = r + dy[d];
-            if (nc < 0 || nc >= cols || nr < 0 || nr >= rows) {
-                continue;
+            int j = 0;
+            for (int x = 0; x < cols; ++x) {
+                // Outside the grid is accessible: virtual cells at -1 and cols
+                const f32 toEdge = static_cast<f32>(std::min(x + 1, cols - x));
+                f32 best = toEdge * toEdge;
+                if (k >= 0) {
+                    while (boundary[static_cast<usize>(j) + 1] < static_cast<f32>(x))
+                        ++j;
+                    const int q = apex[static_cast<usize>(j)];
+                    const f32 d = static_cast<f32>(x - q);
+                    best = std::min(best, d * d + height(q));
+                }
+                dist2[static_cast<usize>(x)] = best;
             }
-            const auto nidx = static_cast<usize>(nr * cols + nc);
-            if (burialMask[nidx] == 0 || dist[nidx] >= 0) {
-                continue;
+
+            for (usize i = rowStart[row]; i < rowStart[row + 1]; ++i) {
+                RunStats& rs = stats[i];
+                for (int col = runs[i].colBegin; col < runs[i].colEnd; ++col) {
+                    const f32 z = hm.at(col, static_cast<int>(row));
+                    rs.minZ = std::min(rs.minZ, z);
+                    rs.maxZ = std::max(rs.maxZ, z);
+                    rs.maxDist2 = std::max(rs.maxDist2, dist2[static_cast<usize>(col)]);
+                }
             }
-            dist[nidx] = curDist + 1;
-            maxDist = std::max(maxDist, curDist + 1);
-            queue.push({nc, nr});
         }
-    }
-
-    return static_cast<f32>(maxDist) * res;
+    });
+    return stats;
 }
 
 } // namespace
@@ -187,87 +322,133 @@ f32 maxDistanceFromRim(const std::vector<std::pair<int, int>>& cells,
 IslandResult detectIslands(const Heightmap& heightmap,
                            f32 toolAngleDeg,
                            f32 minIslandAreaMm2) {
-    IslandResult result;
-
     if (heightmap.empty()) {
-        return result;
+        return IslandResult{};
     }
 
-    const int cols = heightmap.cols();
-    const int rows = heightmap.rows();
-    const f32 res = heightmap.resolution();
-    const f32 cellArea = res * res;
-
     // Step 1: Compute burial mask
     auto burialMask = computeBurialMask(heightmap, toolAngleDeg);
 
-    // Step 2: Flood-fill islands
-    auto groups = floodFillIslands(burialMask, cols, rows);
+    return labelIslands(heightmap, burialMask, minIslandAreaMm2);
+}
 
-    // Step 3: Classify and filter islands
-    result.islandMask.assign(static_cast<usize>(cols * rows), -1);
-    result.maskCols = cols;
-    result.maskRows = rows;
+IslandResult labelIslands(const Heightmap& heightmap,
+                          const std::vector<u8>& burialMask,
+                          f32 minIslandAreaMm2) {
+    IslandResult result;
 
-    int islandId = 0;
-    const Vec3 boundsMin = heightmap.boundsMin();
+    const int cols = heightmap.cols();
+    const int rows = heightmap.rows();
+    if (heightmap.empty() ||
+        burialMask.size() != static_cast<usize>(cols) * static_cast<usize>(rows)) {
+        return result;
+    }
 
-    for (auto& group : groups) {
-        const f32 area = static_cast<f32>(group.size()) * cellArea;
-        if (area < minIslandAreaMm2) {
-            continue;
-        }
+    const f32 res = heightmap.resolution();
+    const f32 cellArea = res * res;
 
+    // Step 2: Label connected buried runs
+    std::vector<usize> rowStart;
+    auto runs = extractRuns(burialMask, cols, rows, rowStart);
+    int componentCount = 0;
+    auto component = labelRuns(runs, rowStart, rows, componentCount);
+
+    // Step 3: Filter by area; surviving islands keep raster order of first cell
+    std::vector<usize> cellCounts(static_cast<usize>(componentCount), 0);
+    for (usize i = 0; i < runs.size(); ++i)
+        cellCounts[static_cast<usize>(component[i])] +=
+            static_cast<usize>(runs[i].colEnd - runs[i].colBegin);
+
+    std::vector<int> islandOf(static_cast<usize>(componentCount), -1);
+    for (int c = 0; c < componentCount; ++c) {
+        const f32 area = static_cast<f32>(cellCounts[static_cast<usize>(c)]) * cellArea;
+        if (area < minIslandAreaMm2)
+            continue;
+        islandOf[static_cast<usize>(c)] = static_cast<int>(result.islands.size());
         Island island;
-        island.id = islandId;
-        island.cells = std::move(group);
+        island.id = islandOf[static_cast<usize>(c)];
         island.areaMm2 = area;
+        result.islands.push_back(std::move(island));
+    }
+
+    result.islandMask.assign(static_cast<usize>(cols) * static_cast<usize>(rows), -1);
+    result.maskCols = cols;
+    result.maskRows = rows;
+    if (result.islands.empty())
+        return result;
 
-        // Compute depth, centroid, bounds
+    // Step 4: Distance transform and per-run Z range
+    auto runStats = measureRuns(heightmap, burialMask, runs, rowStart);
+
+    // Step 5: Fold runs into their islands
+    struct Accum {
+        f64 sumX = 0.0;
+        f64 sumY = 0.0;
+        int minCol = std::numeric_limits<int>::max();
+        int maxCol = std::numeric_limits<int>::lowest();
+        int minRow = std::numeric_limits<int>::max();
+        int maxRow = std::numeric_limits<int>::lowest();
         f32 minZ = std::numeric_limits<f32>::max();
         f32 maxZ = std::numeric_limits<f32>::lowest();
-        f32 sumX = 0.0f;
-        f32 sumY = 0.0f;
-        f32 bMinX = std::numeric_limits<f32>::max();
-        f32 bMinY = std::numeric_limits<f32>::max();
-        f32 bMaxX = std::numeric_limits<f32>::lowest();
-        f32 bMaxY = std::numeric_limits<f32>::lowest();
-
-        for (const auto& [c, r] : island.cells) {
-            const f32 z = heightmap.at(c, r);
-            minZ = std::min(minZ, z);
-            maxZ = std::max(maxZ, z);
-
-            const f32 wx = boundsMin.x + static_cast<f32>(c) * res;
-            const f32 wy = boundsMin.y + static_cast<f32>(r) * res;
-            sumX += wx;
-            sumY += wy;
-            bMinX = std::min(bMinX, wx);
-            bMinY = std::min(bMinY, wy);
-            bMaxX = std::max(bMaxX, wx);
-            bMaxY = std::max(bMaxY, wy);
-
-            result.islandMask[static_cast<usize>(r * cols + c)] = islandId;
-        }
-
-        island.minZ = minZ;
-        island.maxZ = maxZ;
-        island.depth = maxZ - minZ;
+        f32 maxDist2 = 0.0f;
+    };
+    std::vector<Accum> accum(result.islands.size());
+    const Vec3 boundsMin = heightmap.boundsMin();
 
-        const auto cellCount = static_cast<f32>(island.cells.size());
-        island.centroid = Vec2(sumX / cellCount, sumY / cellCount);
-        island.boundsMin = Vec2(bMinX, bMinY);
-        island.boundsMax = Vec2(bMaxX, bMaxY);
+    for (usize i = 0; i < runs.size(); ++i) {
+        const int id = islandOf[static_cast<usize>(component[i])];
+        if (id < 0)
+            continue;
+        const Run& run = runs[i];
+        const f64 count = static_cast<f64>(run.colEnd - run.colBegin);
+        Accum& acc = accum[static_cast<usize>(id)];
+        // Sum of cell X over the run: count * x0 + res * (sum of column indices)
+        const f64 colSum = 0.5 * static_cast<f64>(run.colBegin + run.colEnd - 1) * count;
+        acc.sumX += count * static_cast<f64>(boundsMin.x) + static_cast<f64>(res) * colSum;
+        acc.sumY += count * (static_cast<f64>(boundsMin.y) +
+                             static_cast<f64>(run.row) * static_cast<f64>(res));
+        acc.minCol = std::min(acc.minCol, run.colBegin);
+        acc.maxCol = std::max(acc.maxCol, run.colEnd - 1);
+        acc.minRow = std::min(acc.minRow, run.row);
+        acc.maxRow = std::max(acc.maxRow, run.row);
+        acc.minZ = std::min(acc.minZ, runStats[i].minZ);
+        acc.maxZ = std::max(acc.maxZ, runStats[i].maxZ);
+        acc.maxDist2 = std::max(acc.maxDist2, runStats[i].maxDist2);
+        result.islands[static_cast<usize>(id)].spans.push_back({run.row, run.colBegin, run.colEnd});
+    }
 
-        // Minimum clearing tool diameter
-        const f32 maxDist = maxDistanceFromRim(
-            island.cells, burialMask, cols, rows, res);
+    for (usize id = 0; id < result.islands.size(); ++id) {
+        Island& island = result.islands[id];
+        const Accum& acc = accum[id];
+        island.minZ = acc.minZ;
+        island.maxZ = acc.maxZ;
+        island.depth = acc.maxZ - acc.minZ;
+
+        const auto cellCount = static_cast<f64>(island.cellCount());
+        island.centroid = Vec2(static_cast<f32>(acc.sumX / cellCount),
+                               static_cast<f32>(acc.sumY / cellCount));
+        island.boundsMin = Vec2(boundsMin.x + static_cast<f32>(acc.minCol) * res,
+                                boundsMin.y + static_cast<f32>(acc.minRow) * res);
+        island.boundsMax = Vec2(boundsMin.x + static_cast<f32>(acc.maxCol) * res,
+                                boundsMin.y + static_cast<f32>(acc.maxRow) * res);
+
+        // Minimum clearing tool diameter: twice the deepest interior distance,
+        // measured from the rim cells (which sit one cell from accessible ground)
+        const f32 maxDist = std::max(0.0f, std::sqrt(acc.maxDist2) - 1.0f) * res;
         island.minClearDiameter = 2.0f * maxDist;
-
-        result.islands.push_back(std::move(island));
-        ++islandId;
     }
 
+    parallelFor(static_cast<usize>(rows), ROW_GRAIN, [&](usize begin, usize end) {
+        for (usize i = rowStart[begin]; i < rowStart[end]; ++i) {
+            const int id = islandOf[static_cast<usize>(component[i])];
+            if (id < 0)
+                continue;
+            int* maskRow = result.islandMask.data() +
+                           static_cast<usize>(runs[i].row) * static_cast<usize>(cols);
+            std::fill(maskRow + runs[i].colBegin, maskRow + runs[i].colEnd, id);
+        }
+    });
+
     return result;
 }
 
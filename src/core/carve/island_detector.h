@@ -3,15 +3,21 @@
 #include "../types.h"
 #include "heightmap.h"
 
-#include <utility>
 #include <vector>
 
 namespace dw {
 namespace carve {
 
+// Horizontal run of island cells: columns [colBegin, colEnd) of one grid row
+struct IslandSpan {
+    int row = 0;
+    int colBegin = 0;
+    int colEnd = 0;
+};
+
 struct Island {
     int id = 0;
-    std::vector<std::pair<int, int>> cells;  // (col, row) grid positions
+    std::vector<IslandSpan> spans; // Row-major run-length cells
     f32 minZ = 0.0f;           // Deepest point in island
     f32 maxZ = 0.0f;           // Shallowest point (entry rim)
     f32 depth = 0.0f;          // maxZ - minZ
@@ -19,6 +25,13 @@ struct Island {
     f32 minClearDiameter = 0.0f; // Min clearing tool diameter (mm)
     Vec2 centroid;              // Center position in world coords
     Vec2 boundsMin, boundsMax;  // Bounding box in world coords
+
+    usize cellCount() const {
+        usize count = 0;
+        for (const auto& span : spans)
+            count += static_cast<usize>(span.colEnd - span.colBegin);
+        return count;
+    }
 };
 
 struct IslandResult {
@@ -34,9 +47,19 @@ struct IslandResult {
 //   A cell is "buried" if surrounding height exceeds what
 //   the taper can reach at that XY distance.
 // minIslandAreaMm2: ignore islands smaller than this (mm^2)
+// Labeling is union-find over row runs and minClearDiameter comes from one
+// exact Euclidean distance transform of the whole mask; both run over row
+// bands in parallel, so the cost is linear in grid size, not islands x grid.
 IslandResult detectIslands(const Heightmap& heightmap,
                            f32 toolAngleDeg,
                            f32 minIslandAreaMm2 = 1.0f);
 
+// Group a burial mask (row-major, heightmap-sized, non-zero = buried) into
+// islands. detectIslands() builds the mask from the tool taper and hands it
+// here; cells outside the grid count as accessible.
+IslandResult labelIslands(const Heightmap& heightmap,
+                          const std::vector<u8>& burialMask,
+                          f32 minIslandAreaMm2 = 1.0f);
+
 } // namespace carve
 } // namespace dw
@@ -0,0 +1,526 @@
+#include "stock_simulator.h"
+
+#include "../threading/parallel_for.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+
+namespace dw {
+namespace carve {
+
+namespace {
+
+constexpr f32 kInf = std::numeric_limits<f32>::infinity();
+constexpr f32 kPi = 3.14159265f;
+
+// Segments gathered per parallel pass; bounded so checkpoints stay on schedule
+constexpr usize SWEEP_BATCH = 4096;
+// Grid rows per parallel chunk
+constexpr usize ROW_GRAIN = 8;
+// Snapshots kept across the whole program when scrubbing backwards
+constexpr usize MAX_CHECKPOINTS = 8;
+constexpr usize MIN_CHECKPOINT_INTERVAL = 256;
+// Golden-section steps per convex piece of a segment (interval shrinks 0.618^n)
+constexpr int PROFILE_SEARCH_STEPS = 20;
+
+f32 slopeForAngle(f32 includedAngleDeg) {
+    const f32 half = includedAngleDeg * 0.5f;
+    if (half <= 0.0f || half >= 90.0f)
+        return 0.0f;
+    return 1.0f / std::tan(half * kPi / 180.0f);
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// ToolProfile
+// ---------------------------------------------------------------------------
+
+ToolProfile ToolProfile::flat(f32 diameterMm, f32 cornerRadiusMm) {
+    ToolProfile p;
+    p.shape = Shape::Flat;
+    p.radius = std::max(diameterMm * 0.5f, 1e-3f);
+    p.tipRadius = std::clamp(cornerRadiusMm, 0.0f, p.radius);
+    return p;
+}
+
+ToolProfile ToolProfile::ball(f32 diameterMm) {
+    ToolProfile p;
+    p.shape = Shape::Ball;
+    p.radius = std::max(diameterMm * 0.5f, 1e-3f);
+    p.tipRadius = p.radius;
+    return p;
+}
+
+ToolProfile ToolProfile::vBit(f32 diameterMm, f32 includedAngleDeg, f32 flatDiameterMm) {
+    ToolProfile p;
+    p.shape = Shape::VBit;
+    p.radius = std::max(diameterMm * 0.5f, 1e-3f);
+    p.flatRadius = std::clamp(flatDiameterMm * 0.5f, 0.0f, p.radius);
+    p.slope = slopeForAngle(includedAngleDeg);
+    if (p.slope <= 0.0f)
+        return flat(diameterMm); // Degenerate angle: treat as flat bottom
+    return p;
+}
+
+ToolProfile ToolProfile::fromGeometry(const VtdbToolGeometry& tool) {
+    const f32 scale = (tool.units == VtdbUnits::Imperial) ? 25.4f : 1.0f;
+    const f32 d = static_cast<f32>(tool.diameter) * scale;
+    const f32 tip = static_cast<f32>(tool.tip_radius) * scale;
+    if (d <= 0.0f)
+        return ToolProfile{};
+
+    switch (tool.tool_type) {
+    case VtdbToolType::BallNose:
+        return ball(tip > 0.0f ? std::min(tip * 2.0f, d) : d);
+    case VtdbToolType::TaperedBallNose: {
+        ToolProfile p = ball(d);
+        if (tip > 0.0f && tip < p.radius) {
+            p.tipRadius = tip;
+            p.slope = slopeForAngle(static_cast<f32>(tool.included_angle));
+            if (p.slope <= 0.0f)
+                p.radius = tip; // No taper angle: only the ball cuts
+        }
+        return p;
+    }
+    case VtdbToolType::VBit:
+        return vBit(d,
+                    static_cast<f32>(tool.included_angle),
+                    static_cast<f32>(tool.flat_diameter) * scale);
+    case VtdbToolType::Drill:
+        return vBit(d, tool.included_angle > 0.0 ? static_cast<f32>(tool.included_angle) : 118.0f);
+    case VtdbToolType::Radiused:
+        return flat(d, tip);
+    case VtdbToolType::EndMill:
+    default:
+        return flat(d);
+    }
+}
+
+f32 ToolProfile::heightAt(f32 r) const {
+    r = std::clamp(r, 0.0f, radius);
+    switch (shape) {
+    case Shape::Ball: {
+        const f32 R = tipRadius;
+        if (r <= R)
+            return R - std::sqrt(std::max(0.0f, R * R - r * r));
+        return R + (r - R) * slope;
+    }
+    case Shape::VBit:
+        return r <= flatRadius ? 0.0f : (r - flatRadius) * slope;
+    case Shape::Flat:
+    default: {
+        const f32 inner = radius - tipRadius;
+        if (r <= inner)
+            return 0.0f;
+        const f32 dr = r - inner;
+        return tipRadius - std::sqrt(std::max(0.0f, tipRadius * tipRadius - dr * dr));
+    }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// StockConfig / DirtyRegion
+// ---------------------------------------------------------------------------
+
+StockConfig StockConfig::fromProgram(const gcode::Program& program, f32 marginMm) {
+    StockConfig config;
+    if (program.path.empty())
+        return config;
+
+    f32 feedTop = -kInf;
+    for (const auto& seg : program.path) {
+        if (!seg.isRapid)
+            feedTop = std::max({feedTop, seg.start.z, seg.end.z});
+    }
+    const f32 top = (program.boundsMin.z < 0.0f || feedTop == -kInf) ? 0.0f : feedTop;
+
+    config.min = Vec3{program.boundsMin.x - marginMm,
+                      program.boundsMin.y - marginMm,
+                      std::min(program.boundsMin.z, top) - 1.0f};
+    config.max = Vec3{program.boundsMax.x + marginMm, program.boundsMax.y + marginMm, top};
+    return config;
+}
+
+void DirtyRegion::include(int c0, int r0, int c1, int r1) {
+    if (c1 <= c0 || r1 <= r0)
+        return;
+    if (empty()) {
+        col0 = c0;
+        row0 = r0;
+        col1 = c1;
+        row1 = r1;
+        return;
+    }
+    col0 = std::min(col0, c0);
+    row0 = std::min(row0, r0);
+    col1 = std::max(col1, c1);
+    row1 = std::max(row1, r1);
+}
+
+// ---------------------------------------------------------------------------
+// StockSimulator
+// ---------------------------------------------------------------------------
+
+void StockSimulator::reset(const StockConfig& config) {
+    const f32 sizeX = std::max(config.max.x - config.min.x, 0.0f);
+    const f32 sizeY = std::max(config.max.y - config.min.y, 0.0f);
+
+    f32 res = config.resolutionMm;
+    if (res <= 0.0f) {
+        const int cap = std::max(config.maxCellsPerSide, 1);
+        res = std::max(std::max(sizeX, sizeY) / static_cast<f32>(cap), 0.01f);
+    }
+
+    m_resolution = res;
+    m_cols = std::max(1, static_cast<int>(std::ceil(sizeX / res)));
+    m_rows = std::max(1, static_cast<int>(std::ceil(sizeY / res)));
+    m_top = config.max.z;
+    m_bottom = std::min(config.min.z, config.max.z);
+    m_origin = Vec3{config.min.x + res * 0.5f, config.min.y + res * 0.5f, m_top};
+
+    m_heights.assign(static_cast<usize>(m_cols) * static_cast<usize>(m_rows), m_top);
+    m_applied = 0;
+    m_partial = 0.0f;
+    m_checkpoints.clear();
+    markAllDirty();
+}
+
+void StockSimulator::setProgram(const gcode::Program& program) {
+    m_path = program.path;
+    m_checkpointInterval =
+        std::max(MIN_CHECKPOINT_INTERVAL, (m_path.size() + MAX_CHECKPOINTS - 1) / MAX_CHECKPOINTS);
+    m_checkpoints.clear();
+    std::fill(m_heights.begin(), m_heights.end(), m_top);
+    m_applied = 0;
+    m_partial = 0.0f;
+    markAllDirty();
+}
+
+void StockSimulator::setToolProfiles(std::map<int, ToolProfile> byToolNumber,
+                                     const ToolProfile& fallback) {
+    m_tools = std::move(byToolNumber);
+    m_fallbackTool = fallback;
+    // Already-cut stock was made with the old tools
+    m_checkpoints.clear();
+    std::fill(m_heights.begin(), m_heights.end(), m_top);
+    m_applied = 0;
+    m_partial = 0.0f;
+    markAllDirty();
+}
+
+const ToolProfile& StockSimulator::toolFor(int toolNumber) const {
+    auto it = m_tools.find(toolNumber);
+    return it != m_tools.end() ? it->second : m_fallbackTool;
+}
+
+void StockSimulator::simulateTo(usize segmentIndex, f32 progress) {
+    if (m_heights.empty())
+        return;
+
+    segmentIndex = std::min(segmentIndex, m_path.size());
+    progress = segmentIndex < m_path.size() ? std::clamp(progress, 0.0f, 1.0f) : 0.0f;
+
+    if (segmentIndex < m_applied || (segmentIndex == m_applied && progress < m_partial))
+        restoreBefore(segmentIndex);
+
+    // A partially cut segment is simply re-swept in full: cutting is a min, so
+    // overlapping sweeps are idempotent
+    applyRange(m_applied, segmentIndex);
+
+    if (progress > 0.0f) {
+        const auto& seg = m_path[segmentIndex];
+        Vec3 end = seg.start + (seg.end - seg.start) * progress;
+        std::vector<SegmentSweep> sweep(1);
+        if (makeSweep(seg, end, sweep[0]))
+            applySweeps(sweep);
+    }
+    m_partial = progress;
+}
+
+void StockSimulator::restoreBefore(usize segmentIndex) {
+    auto it = m_checkpoints.upper_bound(segmentIndex);
+    if (it != m_checkpoints.begin()) {
+        --it;
+        m_heights = it->second;
+        m_applied = it->first;
+    } else {
+        std::fill(m_heights.begin(), m_heights.end(), m_top);
+        m_applied = 0;
+    }
+    m_partial = 0.0f;
+    markAllDirty();
+}
+
+void StockSimulator::applyRange(usize begin, usize end) {
+    std::vector<SegmentSweep> sweeps;
+    sweeps.reserve(std::min(end - std::min(begin, end), SWEEP_BATCH));
+
+    const usize interval = std::max<usize>(m_checkpointInterval, 1);
+    usize i = begin;
+    while (i < end) {
+        // Stop each batch at the next checkpoint boundary so snapshots are exact
+        usize next = (i / interval + 1) * interval;
+        usize batchEnd = std::min({end, next, i + SWEEP_BATCH});
+
+        sweeps.clear();
+        for (; i < batchEnd; ++i) {
+            SegmentSweep sweep;
+            if (makeSweep(m_path[i], m_path[i].end, sweep))
+                sweeps.push_back(sweep);
+        }
+        applySweeps(sweeps);
+        m_applied = batchEnd;
+
+        if (m_applied % interval == 0 && m_checkpoints.count(m_applied) == 0)
+            m_checkpoints.emplace(m_applied, m_heights);
+    }
+    m_partial = 0.0f;
+}
+
+bool StockSimulator::makeSweep(const gcode::PathSegment& seg,
+                               const Vec3& end,
+                               SegmentSweep& out) const {
+    // Stock only ever gets lower, so anything above the original top is air
+    if (std::min(seg.start.z, end.z) >= m_top)
+        return false;
+
+    const ToolProfile& tool = toolFor(seg.toolNumber);
+    const f32 R = tool.radius;
+    const f32 inv = 1.0f / m_resolution;
+
+    const f32 minX = std::min(seg.start.x, end.x) - R - m_origin.x;
+    const f32 maxX = std::max(seg.start.x, end.x) + R - m_origin.x;
+    const f32 minY = std::min(seg.start.y, end.y) - R - m_origin.y;
+    const f32 maxY = std::max(seg.start.y, end.y) + R - m_origin.y;
+
+    out.col0 = std::max(0, static_cast<int>(std::ceil(minX * inv)));
+    out.col1 = std::min(m_cols, static_cast<int>(std::floor(maxX * inv)) + 1);
+    out.row0 = std::max(0, static_cast<int>(std::ceil(minY * inv)));
+    out.row1 = std::min(m_rows, static_cast<int>(std::floor(maxY * inv)) + 1);
+    if (out.col1 <= out.col0 || out.row1 <= out.row0)
+        return false;
+
+    out.a = seg.start;
+    out.b = end;
+    out.tool = &tool;
+    return true;
+}
+
+f32 StockSimulator::cutHeight(const SegmentSweep& sweep, f32 x, f32 y) const {
+    const ToolProfile& tool = *sweep.tool;
+    const f32 R = tool.radius;
+    const f32 dx = sweep.b.x - sweep.a.x;
+    const f32 dy = sweep.b.y - sweep.a.y;
+    const f32 dz = sweep.b.z - sweep.a.z;
+    const f32 cx = x - sweep.a.x;
+    const f32 cy = y - sweep.a.y;
+    const f32 c = cx * cx + cy * cy;
+    const f32 aa = dx * dx + dy * dy;
+
+    // Plunge or retract: the cutter stays over one XY point
+    if (aa < 1e-12f) {
+        if (c > R * R)
+            return kInf;
+        return std::min(sweep.a.z, sweep.b.z) + tool.heightAt(std::sqrt(c));
+    }
+
+    // Parameter interval where this cell is under the cutter: |C - tD|^2 <= R^2
+    const f32 bb = cx * dx + cy * dy;
+    const f32 disc = bb * bb - aa * (c - R * R);
+    if (disc < 0.0f)
+        return kInf;
+    const f32 sq = std::sqrt(disc);
+    const f32 t0 = std::max(0.0f, (bb - sq) / aa);
+    const f32 t1 = std::min(1.0f, (bb + sq) / aa);
+    if (t0 > t1)
+        return kInf;
+
+    const bool flatBottom = tool.shape == ToolProfile::Shape::Flat && tool.tipRadius <= 0.0f;
+    if (flatBottom)
+        return sweep.a.z + dz * (dz > 0.0f ? t0 : t1);
+
+    // z(t) + h(d(t)) is convex in t wherever h is convex (linear + convex), so a
+    // golden-section search finds the lowest point of the cutter over the cell
+    auto surfaceAt = [&](f32 t) {
+        const f32 d2 = std::max(0.0f, aa * t * t - 2.0f * bb * t + c);
+        return sweep.a.z + dz * t + tool.heightAt(std::sqrt(d2));
+    };
+    if (dz == 0.0f)
+        return surfaceAt(std::clamp(bb / aa, t0, t1));
+
+    auto lowestOn = [&](f32 lo, f32 hi) {
+        constexpr f32 kGolden = 0.618034f;
+        f32 m1 = hi - kGolden * (hi - lo);
+        f32 m2 = lo + kGolden * (hi - lo);
+        f32 f1 = surfaceAt(m1);
+        f32 f2 = surfaceAt(m2);
+        for (int i = 0; i < PROFILE_SEARCH_STEPS; ++i) {
+            if (f1 < f2) {
+                hi = m2;
+                m2 = m1;
+                f2 = f1;
+                m1 = hi - kGolden * (hi - lo);
+                f1 = surfaceAt(m1);
+            } else {
+                lo = m1;
+                m1 = m2;
+                f1 = f2;
+                m2 = lo + kGolden * (hi - lo);
+                f2 = surfaceAt(m2);
+            }
+        }
+        return std::min(f1, f2);
+    };
+
+    // A tapered ball is not convex where the ball meets the taper (vertical
+    // tangent at tipRadius), so the sweep can have a second local minimum there.
+    // Split the interval where the cell crosses that radius and search each
+    // convex piece on its own.
+    f32 breaks[4] = {t0, t1, t1, t1};
+    int breakCount = 2;
+    if (tool.shape == ToolProfile::Shape::Ball && tool.tipRadius < R && tool.slope > 0.0f) {
+        const f32 tipDisc = bb * bb - aa * (c - tool.tipRadius * tool.tipRadius);
+        if (tipDisc > 0.0f) {
+            const f32 tipSq = std::sqrt(tipDisc);
+            for (f32 t : {(bb - tipSq) / aa, (bb + tipSq) / aa}) {
+                if (t > t0 && t < t1)
+                    breaks[breakCount++] = t;
+            }
+            std::sort(breaks, breaks + breakCount);
+        }
+    }
+
+    f32 lowest = surfaceAt(t1);
+    for (int i = 0; i + 1 < breakCount; ++i)
+        lowest = std::min({lowest, surfaceAt(breaks[i]), lowestOn(breaks[i], breaks[i + 1])});
+    return lowest;
+}
+
+void StockSimulator::applySweeps(const std::vector<SegmentSweep>& sweeps) {
+    if (sweeps.empty())
+        return;
+
+    int row0 = m_rows;
+    int row1 = 0;
+    for (const auto& s : sweeps) {
+        row0 = std::min(row0, s.row0);
+        row1 = std::max(row1, s.row1);
+        m_dirty.include(s.col0, s.row0, s.col1, s.row1);
+    }
+
+    // Bands of rows are independent, and min() makes segment order irrelevant
+    parallelFor(static_cast<usize>(row1 - row0), ROW_GRAIN, [&](usize begin, usize end) {
+        const int bandLo = row0 + static_cast<int>(begin);
+        const int bandHi = row0 + static_cast<int>(end);
+        for (const auto& s : sweeps) {
+            const int r0 = std::max(bandLo, s.row0);
+            const int r1 = std::min(bandHi, s.row1);
+            for (int r = r0; r < r1; ++r) {
+                const f32 y = m_origin.y + static_cast<f32>(r) * m_resolution;
+                f32* row = m_heights.data() + static_cast<usize>(r) * static_cast<usize>(m_cols);
+                for (int col = s.col0; col < s.col1; ++col) {
+                    const f32 x = m_origin.x + static_cast<f32>(col) * m_resolution;
+                    const f32 z = std::max(cutHeight(s, x, y), m_bottom);
+                    if (z < row[col])
+                        row[col] = z;
+                }
+            }
+        }
+    });
+}
+
+void StockSimulator::markAllDirty() {
+    m_dirty = DirtyRegion{0, 0, m_cols, m_rows};
+}
+
+DirtyRegion StockSimulator::takeDirtyRegion() {
+    DirtyRegion region = m_dirty;
+    m_dirty = DirtyRegion{};
+    return region;
+}
+
+std::vector<f32> StockSimulator::deviationMap(const Heightmap& target,
+                                              f32 toleranceMm,
+                                              DeviationStats* stats) const {
+    std::vector<f32> deviation(m_heights.size(), std::numeric_limits<f32>::quiet_NaN());
+    DeviationStats s;
+    f64 absSum = 0.0;
+    bool first = true;
+
+    if (!target.empty()) {
+        const Vec3 tMin = target.boundsMin();
+        const Vec3 tMax = target.boundsMax();
+        for (int r = 0; r < m_rows; ++r) {
+            const f32 y = m_origin.y + static_cast<f32>(r) * m_resolution;
+            if (y < tMin.y || y > tMax.y)
+                continue;
+            for (int c = 0; c < m_cols; ++c) {
+                const f32 x = m_origin.x + static_cast<f32>(c) * m_resolution;
+                if (x < tMin.x || x > tMax.x)
+                    continue;
+                const usize i = static_cast<usize>(r) * static_cast<usize>(m_cols) +
+                                static_cast<usize>(c);
+                const f32 d = m_heights[i] - target.atMm(x, y);
+                deviation[i] = d;
+
+                s.minDeviation = first ? d : std::min(s.minDeviation, d);
+                s.maxDeviation = first ? d : std::max(s.maxDeviation, d);
+                first = false;
+                absSum += std::abs(static_cast<f64>(d));
+                if (d < -toleranceMm)
+                    ++s.gougeCells;
+                ++s.comparedCells;
+            }
+        }
+    }
+
+    if (s.comparedCells > 0)
+        s.meanAbsDeviation = static_cast<f32>(absSum / static_cast<f64>(s.comparedCells));
+    if (stats)
+        *stats = s;
+    return deviation;
+}
+
+bool StockSimulator::exportDeviation(const Heightmap& target,
+                                     const std::string& path,
+                                     f32 rangeMm) const {
+    if (m_heights.empty() || target.empty())
+        return false;
+
+    // Same convention as Heightmap::exportPng: always a dependency-free format
+    std::string actualPath = path;
+    auto dotPos = actualPath.rfind('.');
+    if (dotPos != std::string::npos)
+        actualPath = actualPath.substr(0, dotPos) + ".ppm";
+    else
+        actualPath += ".ppm";
+
+    std::ofstream f(actualPath, std::ios::binary);
+    if (!f.is_open())
+        return false;
+
+    const auto deviation = deviationMap(target);
+    const f32 range = rangeMm > 1e-6f ? rangeMm : 1.0f;
+
+    // P6 binary PPM, row 0 first (matches the heightmap export)
+    f << "P6\n" << m_cols << " " << m_rows << "\n255\n";
+    for (f32 d : deviation) {
+        u8 rgb[3] = {64, 64, 64}; // Outside the target
+        if (!std::isnan(d)) {
+            const f32 s = std::clamp(d / range, -1.0f, 1.0f);
+            const f32 fade = 1.0f - std::abs(s);
+            const auto channel = [](f32 v) { return static_cast<u8>(v * 255.0f + 0.5f); };
+            rgb[0] = s < 0.0f ? channel(fade) : 255;
+            rgb[1] = channel(fade);
+            rgb[2] = s > 0.0f ? channel(fade) : 255;
+        }
+        f.write(reinterpret_cast<const char*>(rgb), 3);
+    }
+    return f.good();
+}
+
+} // namespace carve
+} // namespace dw
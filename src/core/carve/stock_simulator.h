@@ -0,0 +1,162 @@
+#pragma once
+
+#include "../cnc/cnc_tool.h"
+#include "../gcode/gcode_types.h"
+#include "../types.h"
+#include "heightmap.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace dw {
+namespace carve {
+
+// Axisymmetric cutter profile in mm, measured from the tool tip.
+struct ToolProfile {
+    enum class Shape {
+        Flat,     // End mill (optionally with corner radius)
+        Ball,     // Ball nose (optionally tapered above the ball)
+        VBit      // Cone, optionally with a flat tip
+    };
+
+    Shape shape = Shape::Flat;
+    f32 radius = 1.5875f;  // Cutting radius at full diameter
+    f32 tipRadius = 0.0f;  // Ball radius (Ball) or corner radius (Flat)
+    f32 flatRadius = 0.0f; // Flat tip radius (VBit)
+    f32 slope = 0.0f;      // Flank rise per mm of radius (VBit, tapered Ball)
+
+    static ToolProfile flat(f32 diameterMm, f32 cornerRadiusMm = 0.0f);
+    static ToolProfile ball(f32 diameterMm);
+    static ToolProfile vBit(f32 diameterMm, f32 includedAngleDeg, f32 flatDiameterMm = 0.0f);
+
+    // Profile for a tool library geometry (imperial dimensions converted to mm)
+    static ToolProfile fromGeometry(const VtdbToolGeometry& tool);
+
+    // Height of the cutting surface above the tip at radial distance r <= radius
+    f32 heightAt(f32 r) const;
+};
+
+// Stock block the program is cut from, in program coordinates (mm).
+struct StockConfig {
+    Vec3 min{0.0f};
+    Vec3 max{0.0f};            // max.z is the stock top
+    f32 resolutionMm = 0.0f;   // Cell size; 0 picks one from maxCellsPerSide
+    int maxCellsPerSide = 512; // Upper bound when resolution is automatic
+
+    // Stock covering the program's XY extent plus margin. The top is Z0 when
+    // the program cuts below zero, otherwise the highest feed-move Z.
+    static StockConfig fromProgram(const gcode::Program& program, f32 marginMm);
+};
+
+// Cell rectangle touched since the last takeDirtyRegion() (half-open)
+struct DirtyRegion {
+    int col0 = 0;
+    int row0 = 0;
+    int col1 = 0;
+    int row1 = 0;
+
+    bool empty() const { return col1 <= col0 || row1 <= row0; }
+    void include(int c0, int r0, int c1, int r1);
+};
+
+// Summary of stock minus target height over the cells the target covers
+struct DeviationStats {
+    f32 minDeviation = 0.0f;  // Most negative = deepest gouge
+    f32 maxDeviation = 0.0f;  // Most material left behind
+    f32 meanAbsDeviation = 0.0f;
+    usize gougeCells = 0;     // Cells cut below target by more than the tolerance
+    usize comparedCells = 0;
+};
+
+// Z-map material removal: sweeps cutter profiles along a G-code path over a
+// heightfield of the stock top (one height per cell, which is exact for
+// 3-axis work without undercuts).
+//
+// Cutting is a per-cell min, so it commutes: segments are applied in batches
+// with the grid split into row bands across threads, and the result does not
+// depend on thread count. Going backwards restores the nearest checkpoint and
+// replays forward, so scrubbing costs at most one checkpoint interval.
+class StockSimulator {
+  public:
+    void reset(const StockConfig& config);
+
+    // Path to simulate; resets the stock to uncut
+    void setProgram(const gcode::Program& program);
+
+    // Cutters by T-number; segments with unknown tools use the fallback
+    void setToolProfiles(std::map<int, ToolProfile> byToolNumber, const ToolProfile& fallback);
+
+    // Remove material for segments [0, segmentIndex) plus `progress` (0..1) of
+    // segmentIndex. Works in either direction.
+    void simulateTo(usize segmentIndex, f32 progress = 0.0f);
+
+    // Cells changed since the previous call (the whole grid after a rewind)
+    DirtyRegion takeDirtyRegion();
+
+    // Grid accessors (row-major, row = Y)
+    int cols() const { return m_cols; }
+    int rows() const { return m_rows; }
+    f32 resolution() const { return m_resolution; }
+    Vec3 origin() const { return m_origin; }  // Center of cell (0, 0) at stock top
+    f32 stockTop() const { return m_top; }
+    f32 stockBottom() const { return m_bottom; }
+    f32 at(int col, int row) const {
+        return m_heights[static_cast<usize>(row) * static_cast<usize>(m_cols) +
+                         static_cast<usize>(col)];
+    }
+    const std::vector<f32>& heights() const { return m_heights; }
+    bool empty() const { return m_heights.empty(); }
+    usize simulatedSegments() const { return m_applied; }
+
+    // Per-cell stock minus target height (NaN where the target has no data).
+    // Negative values are gouges; tolerance only affects stats.gougeCells.
+    std::vector<f32> deviationMap(const Heightmap& target,
+                                  f32 toleranceMm = 0.01f,
+                                  DeviationStats* stats = nullptr) const;
+
+    // Color deviation image: blue = gouge, white = on target, red = material
+    // left, saturating at +/- rangeMm. Written as binary PPM (no image deps).
+    bool exportDeviation(const Heightmap& target, const std::string& path, f32 rangeMm) const;
+
+  private:
+    struct SegmentSweep {
+        Vec3 a;
+        Vec3 b;
+        const ToolProfile* tool = nullptr;
+        int col0, row0, col1, row1;  // Affected cells (half-open)
+    };
+
+    void restoreBefore(usize segmentIndex);
+    void applyRange(usize begin, usize end);
+    void applySweeps(const std::vector<SegmentSweep>& sweeps);
+    bool makeSweep(const gcode::PathSegment& seg, const Vec3& end, SegmentSweep& out) const;
+    f32 cutHeight(const SegmentSweep& sweep, f32 x, f32 y) const;
+    void markAllDirty();
+
+    const ToolProfile& toolFor(int toolNumber) const;
+
+    std::vector<gcode::PathSegment> m_path;
+    std::map<int, ToolProfile> m_tools;
+    ToolProfile m_fallbackTool;
+
+    std::vector<f32> m_heights;
+    int m_cols = 0;
+    int m_rows = 0;
+    f32 m_resolution = 0.1f;
+    Vec3 m_origin{0.0f};
+    f32 m_top = 0.0f;
+    f32 m_bottom = 0.0f;
+
+    usize m_applied = 0;     // Segments fully applied
+    f32 m_partial = 0.0f;    // Fraction of segment m_applied applied on top
+
+    // Grid snapshots at multiples of m_checkpointInterval (index -> heights)
+    std::map<usize, std::vector<f32>> m_checkpoints;
+    usize m_checkpointInterval = 0;
+
+    DirtyRegion m_dirty;
+};
+
+} // namespace carve
+} // namespace dw
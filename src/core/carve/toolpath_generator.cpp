@@ -2,8 +2,15 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <limits>
 #include <set>
 
+#include "surface_analysis.h"
+
+#include "../threading/parallel_for.h"
+#include "../utils/trace.h"
+
 namespace dw {
 namespace carve {
 
@@ -19,6 +26,55 @@ f32 stepoverPercent(StepoverPreset preset)
     return 12.0f;
 }
 
+// ---------------------------------------------------------------------------
+// Cached stages
+// ---------------------------------------------------------------------------
+
+bool ToolpathStages::SurfaceKey::operator==(const SurfaceKey& o) const
+{
+    return heightmap == o.heightmap && cols == o.cols && rows == o.rows &&
+           toolType == o.toolType && diameter == o.diameter &&
+           tipRadius == o.tipRadius && includedAngle == o.includedAngle &&
+           scanResolution == o.scanResolution;
+}
+
+bool ToolpathStages::SamplingKey::operator==(const SamplingKey& o) const
+{
+    return axis == o.axis && direction == o.direction && stepoverMm == o.stepoverMm;
+}
+
+bool ToolpathStages::ClearingKey::operator==(const ClearingKey& o) const
+{
+    return heightmap == o.heightmap && toolDiameter == o.toolDiameter &&
+           safeZ == o.safeZ && leadIn == o.leadIn;
+}
+
+void ToolpathStages::clear()
+{
+    clearFinishing();
+    clearClearing();
+}
+
+void ToolpathStages::clearFinishing()
+{
+    m_surfaceValid = false;
+    m_lines.clear();
+    m_samplingValid = false;
+    m_scanLines.clear();
+    m_scanLineCount = 0;
+    m_decimationValid = false;
+    m_curvatureValid = false;
+    m_linkValid = false;
+    m_feedValid = false;
+    m_finishing = Toolpath{};
+}
+
+void ToolpathStages::clearClearing()
+{
+    m_clearingValid = false;
+    m_clearing = Toolpath{};
+}
+
 // ---------------------------------------------------------------------------
 // Public API
 // ---------------------------------------------------------------------------
@@ -28,42 +84,119 @@ Toolpath ToolpathGenerator::generateFinishing(const Heightmap& heightmap,
                                                f32 toolTipDiameter,
                                                const VtdbToolGeometry& tool)
 {
-    Toolpath path;
-    if (heightmap.empty() || toolTipDiameter <= 0.0f) return path;
+    ToolpathStages stages;
+    return generateFinishing(heightmap, config, toolTipDiameter, tool, stages);
+}
+
+Toolpath ToolpathGenerator::generateFinishing(const Heightmap& heightmap,
+                                               const ToolpathConfig& config,
+                                               f32 toolTipDiameter,
+                                               const VtdbToolGeometry& tool,
+                                               ToolpathStages& stages)
+{
+    DW_TRACE_ZONE("Toolpath finishing");
+    stages.m_linesComputed = 0;
+    stages.m_linesReused = 0;
+    if (heightmap.empty() || toolTipDiameter <= 0.0f) return Toolpath{};
 
     f32 pct = (config.customStepoverPct > 0.0f)
                   ? config.customStepoverPct
                   : stepoverPercent(config.stepoverPreset);
     f32 stepoverMm = toolTipDiameter * pct / 100.0f;
-    if (stepoverMm <= 0.0f) return path;
-
-    switch (config.axis) {
-        case ScanAxis::XOnly:
-            generateScanLines(path, heightmap, config, stepoverMm, true);
-            break;
-        case ScanAxis::YOnly:
-            generateScanLines(path, heightmap, config, stepoverMm, false);
-            break;
-        case ScanAxis::XThenY:
-            generateScanLines(path, heightmap, config, stepoverMm, true);
-            generateScanLines(path, heightmap, config, stepoverMm, false);
-            break;
-        case ScanAxis::YThenX:
-            generateScanLines(path, heightmap, config, stepoverMm, false);
-            generateScanLines(path, heightmap, config, stepoverMm, true);
-            break;
+    if (stepoverMm <= 0.0f) return Toolpath{};
+
+    // Stage 1: compensated surface (filled lazily by sampling)
+    ToolpathStages::SurfaceKey surfaceKey;
+    surfaceKey.heightmap = &heightmap;
+    surfaceKey.cols = heightmap.cols();
+    surfaceKey.rows = heightmap.rows();
+    surfaceKey.toolType = tool.tool_type;
+    surfaceKey.diameter = tool.diameter;
+    surfaceKey.tipRadius = tool.tip_radius;
+    surfaceKey.includedAngle = tool.included_angle;
+    surfaceKey.scanResolution = (config.scanResolutionMm > 0.0f)
+                                    ? config.scanResolutionMm
+                                    : heightmap.resolution();
+    if (!stages.m_surfaceValid || !(stages.m_surfaceKey == surfaceKey)) {
+        stages.clearFinishing();
+        stages.m_surfaceKey = surfaceKey;
+        stages.m_surfaceValid = true;
     }
 
-    // Apply tool offset compensation to all cutting points
-    for (auto& pt : path.points) {
-        if (!pt.rapid) {
-            f32 offset = toolOffset(heightmap, pt.position.x, pt.position.y, tool);
-            pt.position.z += offset;
+    // Stage 2: scan-line sampling
+    const ToolpathStages::SamplingKey samplingKey{config.axis, config.direction, stepoverMm};
+    if (!stages.m_samplingValid || !(stages.m_samplingKey == samplingKey)) {
+        DW_TRACE_ZONE("Toolpath sampling");
+        // Invalid until compensation finishes, in case progress cancels it
+        stages.m_samplingValid = false;
+        stages.m_decimationValid = false;
+        stages.m_scanLines.clear();
+        stages.m_scanLineCount = 0;
+        switch (config.axis) {
+            case ScanAxis::XOnly:
+                sampleScanLines(stages, heightmap, config, stepoverMm, true);
+                break;
+            case ScanAxis::YOnly:
+                sampleScanLines(stages, heightmap, config, stepoverMm, false);
+                break;
+            case ScanAxis::XThenY:
+                sampleScanLines(stages, heightmap, config, stepoverMm, true);
+                sampleScanLines(stages, heightmap, config, stepoverMm, false);
+                break;
+            case ScanAxis::YThenX:
+                sampleScanLines(stages, heightmap, config, stepoverMm, false);
+                sampleScanLines(stages, heightmap, config, stepoverMm, true);
+                break;
         }
+        compensateScanLines(stages, heightmap, tool);
+        stages.m_samplingKey = samplingKey;
+        stages.m_samplingValid = true;
     }
 
-    computeMetrics(path, config);
-    return path;
+    // Stage 3: point decimation
+    if (!stages.m_decimationValid || stages.m_tolerance != config.toleranceMm) {
+        stages.m_linkValid = false;
+        decimateScanLines(stages, heightmap, config.toleranceMm);
+        stages.m_tolerance = config.toleranceMm;
+        stages.m_decimationValid = true;
+    }
+
+    // Stage 4: linking and retracts
+    if (!stages.m_linkValid || stages.m_linkSafeZ != config.safeZMm) {
+        linkScanLines(stages, heightmap, config);
+        stages.m_linkSafeZ = config.safeZMm;
+        stages.m_linkValid = true;
+        stages.m_feedValid = false;
+    }
+
+    // Stage 5: feed assignment
+    if (!stages.m_feedValid || stages.m_feedRate != config.feedRateMmMin) {
+        computeMetrics(stages.m_finishing, config);
+        stages.m_feedRate = config.feedRateMmMin;
+        stages.m_feedValid = true;
+    }
+
+    return stages.m_finishing;
+}
+
+Toolpath ToolpathGenerator::generateClearing(const Heightmap& heightmap,
+                                              const IslandResult& islands,
+                                              const ToolpathConfig& config,
+                                              f32 toolDiameter,
+                                              ToolpathStages& stages)
+{
+    const ToolpathStages::ClearingKey key{&heightmap, toolDiameter,
+                                          config.safeZMm, config.leadInMm};
+    if (!stages.m_clearingValid || !(stages.m_clearingKey == key)) {
+        stages.m_clearing = generateClearing(heightmap, islands, config, toolDiameter);
+        stages.m_clearingKey = key;
+        stages.m_clearingValid = true;
+    } else if (stages.m_clearingFeedRate != config.feedRateMmMin) {
+        // Only feeds changed: the cut geometry stands
+        computeMetrics(stages.m_clearing, config);
+    }
+    stages.m_clearingFeedRate = config.feedRateMmMin;
+    return stages.m_clearing;
 }
 
 Toolpath ToolpathGenerator::generateClearing(const Heightmap& heightmap,
@@ -71,6 +204,7 @@ Toolpath ToolpathGenerator::generateClearing(const Heightmap& heightmap,
                                               const ToolpathConfig& config,
                                               f32 toolDiameter)
 {
+    DW_TRACE_ZONE("Toolpath clearing");
     Toolpath path;
     if (heightmap.empty() || toolDiameter <= 0.0f) return path;
     if (islands.islands.empty()) return path;
@@ -79,12 +213,39 @@ Toolpath ToolpathGenerator::generateClearing(const Heightmap& heightmap,
     const f32 stepdownMm = toolDiameter;         // Max depth per pass
     const f32 toolRadius = toolDiameter * 0.5f;
 
+    // Each island starts with a retract of its own ahead of its first line
+    std::vector<ClearingLine> lines;
+    int pendingRetracts = 0;
     for (const auto& island : islands.islands) {
-        addRetract(path, config.safeZMm);
-        clearIslandRegion(path, heightmap, islands, island,
-                          config, stepoverMm, stepdownMm, toolRadius);
+        const usize first = lines.size();
+        planIslandRegion(lines, island, stepoverMm, stepdownMm, toolRadius);
+        ++pendingRetracts;
+        if (lines.size() > first) {
+            lines[first].leadingRetracts += pendingRetracts;
+            pendingRetracts = 0;
+        }
     }
 
+    // Lines only need the previous end point for their leading retracts, so
+    // their moves are built independently and stitched in order
+    std::vector<Toolpath> buffers(lines.size());
+    runBatched(lines.size(), 64, [&](usize begin, usize end) {
+        for (usize i = begin; i < end; ++i)
+            clearIslandLine(buffers[i], heightmap, islands, lines[i], config);
+    });
+
+    usize total = 0;
+    for (const auto& buffer : buffers) total += buffer.points.size() + 2;
+    path.points.reserve(total);
+    for (usize i = 0; i < lines.size(); ++i) {
+        for (int r = 0; r < lines[i].leadingRetracts; ++r)
+            addRetract(path, config.safeZMm);
+        const auto& points = buffers[i].points;
+        path.points.insert(path.points.end(), points.begin(), points.end());
+    }
+    for (int r = 0; r < pendingRetracts; ++r)
+        addRetract(path, config.safeZMm);
+
     computeMetrics(path, config);
     return path;
 }
@@ -93,18 +254,12 @@ Toolpath ToolpathGenerator::generateClearing(const Heightmap& heightmap,
 // Island clearing
 // ---------------------------------------------------------------------------
 
-void ToolpathGenerator::clearIslandRegion(Toolpath& path,
-                                           const Heightmap& heightmap,
-                                           const IslandResult& islands,
-                                           const Island& island,
-                                           const ToolpathConfig& config,
-                                           f32 stepoverMm,
-                                           f32 stepdownMm,
-                                           f32 toolRadius)
+void ToolpathGenerator::planIslandRegion(std::vector<ClearingLine>& lines,
+                                          const Island& island,
+                                          f32 stepoverMm,
+                                          f32 stepdownMm,
+                                          f32 toolRadius) const
 {
-    const f32 res = heightmap.resolution();
-    const Vec3 bmin = heightmap.boundsMin();
-
     // Island bounding box with tool radius margin
     const f32 xMin = island.boundsMin.x - toolRadius;
     const f32 xMax = island.boundsMax.x + toolRadius;
@@ -130,52 +285,73 @@ void ToolpathGenerator::clearIslandRegion(Toolpath& path,
             const f32 y = yMin + static_cast<f32>(lineIdx) * stepoverMm;
             if (y > yMax) break;
 
-            bool inIsland = false;
-            addRetract(path, config.safeZMm);
-
-            const int numPoints = std::max(
-                1, static_cast<int>((xMax - xMin) / res) + 1);
-
-            for (int ptIdx = 0; ptIdx < numPoints; ++ptIdx) {
-                const f32 x = xMin + static_cast<f32>(ptIdx) * res;
-
-                // Check island mask membership
-                const int col = static_cast<int>((x - bmin.x) / res);
-                const int row = static_cast<int>((y - bmin.y) / res);
-                bool cellInIsland = false;
-                if (col >= 0 && col < islands.maskCols &&
-                    row >= 0 && row < islands.maskRows) {
-                    cellInIsland =
-                        (islands.islandMask[row * islands.maskCols + col]
-                         == island.id);
-                }
+            ClearingLine line;
+            line.island = &island;
+            line.y = y;
+            line.cutZ = cutZ;
+            line.xMin = xMin;
+            line.xMax = xMax;
+            lines.push_back(line);
+        }
+    }
+}
 
-                if (cellInIsland && !inIsland) {
-                    // Entering island: ramp down over lead-in distance
-                    addRapidTo(path, {x, y, config.safeZMm});
-                    const f32 rampEnd = std::min(
-                        x + config.leadInMm, xMax);
-                    addCutTo(path, {x, y, island.maxZ});
-                    addCutTo(path, {rampEnd, y, cutZ});
-                    inIsland = true;
-                } else if (cellInIsland && inIsland) {
-                    // Inside island: cut at depth or surface (whichever higher)
-                    const f32 surfaceZ = heightmap.atMm(x, y);
-                    const f32 z = std::max(cutZ, surfaceZ);
-                    addCutTo(path, {x, y, z});
-                } else if (!cellInIsland && inIsland) {
-                    // Exiting island: ramp up over lead-out distance
-                    addCutTo(path, {x, y, island.maxZ});
-                    addCutTo(path, {x + config.leadInMm, y, config.safeZMm});
-                    inIsland = false;
-                }
-                // Not in island and not entering: skip (no cut)
-            }
+void ToolpathGenerator::clearIslandLine(Toolpath& path,
+                                         const Heightmap& heightmap,
+                                         const IslandResult& islands,
+                                         const ClearingLine& line,
+                                         const ToolpathConfig& config)
+{
+    const f32 res = heightmap.resolution();
+    const Vec3 bmin = heightmap.boundsMin();
+    const Island& island = *line.island;
+    const f32 y = line.y;
+    const f32 cutZ = line.cutZ;
+    const f32 xMin = line.xMin;
+    const f32 xMax = line.xMax;
+
+    bool inIsland = false;
+    const int numPoints = std::max(
+        1, static_cast<int>((xMax - xMin) / res) + 1);
+
+    for (int ptIdx = 0; ptIdx < numPoints; ++ptIdx) {
+        const f32 x = xMin + static_cast<f32>(ptIdx) * res;
+
+        // Check island mask membership
+        const int col = static_cast<int>((x - bmin.x) / res);
+        const int row = static_cast<int>((y - bmin.y) / res);
+        bool cellInIsland = false;
+        if (col >= 0 && col < islands.maskCols &&
+            row >= 0 && row < islands.maskRows) {
+            cellInIsland =
+                (islands.islandMask[row * islands.maskCols + col]
+                 == island.id);
+        }
 
-            if (inIsland) {
-                addRetract(path, config.safeZMm);
-            }
+        if (cellInIsland && !inIsland) {
+            // Entering island: ramp down over lead-in distance
+            addRapidTo(path, {x, y, config.safeZMm});
+            const f32 rampEnd = std::min(
+                x + config.leadInMm, xMax);
+            addCutTo(path, {x, y, island.maxZ});
+            addCutTo(path, {rampEnd, y, cutZ});
+            inIsland = true;
+        } else if (cellInIsland && inIsland) {
+            // Inside island: cut at depth or surface (whichever higher)
+            const f32 surfaceZ = heightmap.atMm(x, y);
+            const f32 z = std::max(cutZ, surfaceZ);
+            addCutTo(path, {x, y, z});
+        } else if (!cellInIsland && inIsland) {
+            // Exiting island: ramp up over lead-out distance
+            addCutTo(path, {x, y, island.maxZ});
+            addCutTo(path, {x + config.leadInMm, y, config.safeZMm});
+            inIsland = false;
         }
+        // Not in island and not entering: skip (no cut)
+    }
+
+    if (inIsland) {
+        addRetract(path, config.safeZMm);
     }
 }
 
@@ -183,24 +359,29 @@ void ToolpathGenerator::clearIslandRegion(Toolpath& path,
 // Scan-line generation
 // ---------------------------------------------------------------------------
 
-void ToolpathGenerator::generateScanLines(Toolpath& path,
-                                           const Heightmap& heightmap,
-                                           const ToolpathConfig& config,
-                                           f32 stepoverMm,
-                                           bool primaryAxis)
+void ToolpathGenerator::runBatched(usize count, usize batch,
+                                   const std::function<void(usize begin, usize end)>& body)
+{
+    batch = std::max<usize>(batch, 1);
+    for (usize start = 0; start < count; start += batch) {
+        const usize end = std::min(count, start + batch);
+        parallelFor(end - start, 1, [&](usize b, usize e) { body(start + b, start + e); });
+        if (m_onProgress) m_onProgress(static_cast<f32>(end) / static_cast<f32>(count));
+    }
+}
+
+void ToolpathGenerator::sampleScanLines(ToolpathStages& stages,
+                                         const Heightmap& heightmap,
+                                         const ToolpathConfig& config,
+                                         f32 stepoverMm,
+                                         bool primaryAxis)
 {
     const Vec3 bmin = heightmap.boundsMin();
     const Vec3 bmax = heightmap.boundsMax();
-    const f32 hmRes = heightmap.resolution();
-    const f32 res = (config.scanResolutionMm > 0.0f)
-                        ? config.scanResolutionMm
-                        : hmRes;
 
     // Axis mapping:
     //   primaryAxis==true  -> scan along X, step along Y
     //   primaryAxis==false -> scan along Y, step along X
-    const f32 scanMin  = primaryAxis ? bmin.x : bmin.y;
-    const f32 scanMax  = primaryAxis ? bmax.x : bmax.y;
     const f32 stepMin  = primaryAxis ? bmin.y : bmin.x;
     const f32 stepMax  = primaryAxis ? bmax.y : bmax.x;
 
@@ -208,7 +389,7 @@ void ToolpathGenerator::generateScanLines(Toolpath& path,
     if (stepExtent <= 0.0f || stepoverMm <= 0.0f) return;
 
     const int numLines = std::max(1, static_cast<int>(stepExtent / stepoverMm) + 1);
-    path.scanLineCount += numLines;
+    stages.m_scanLineCount += numLines;
 
     for (int lineIdx = 0; lineIdx < numLines; ++lineIdx) {
         const f32 stepPos = stepMin + static_cast<f32>(lineIdx) * stepoverMm;
@@ -228,32 +409,223 @@ void ToolpathGenerator::generateScanLines(Toolpath& path,
                 break;
         }
 
+        ToolpathStages::ScanLine line;
+        line.primaryAxis = primaryAxis;
+        line.forward = forward;
+        line.stepPos = stepPos;
+        stages.m_scanLines.push_back(line);
+    }
+}
+
+namespace {
+
+// Line cache key: scan axis and the exact bits of the line position
+u64 scanLineKey(bool primaryAxis, f32 stepPos)
+{
+    u32 stepBits = 0;
+    std::memcpy(&stepBits, &stepPos, sizeof(stepBits));
+    return (primaryAxis ? (u64{1} << 32) : u64{0}) | stepBits;
+}
+
+} // namespace
+
+void ToolpathGenerator::compensateScanLines(ToolpathStages& stages,
+                                             const Heightmap& heightmap,
+                                             const VtdbToolGeometry& tool)
+{
+    DW_TRACE_ZONE("Toolpath compensation");
+
+    // Serve what the cache has; the rest is computed in parallel, one line
+    // per task, then stored in line order
+    std::vector<usize> pending;
+    for (usize i = 0; i < stages.m_scanLines.size(); ++i) {
+        auto& line = stages.m_scanLines[i];
+        auto it = stages.m_lines.find(scanLineKey(line.primaryAxis, line.stepPos));
+        if (it != stages.m_lines.end()) {
+            line.z = &it->second;
+            ++stages.m_linesReused;
+        } else {
+            pending.push_back(i);
+        }
+    }
+
+    const f32 res = stages.m_surfaceKey.scanResolution;
+    std::vector<std::vector<f32>> computed(pending.size());
+    runBatched(pending.size(), 32, [&](usize begin, usize end) {
+        for (usize p = begin; p < end; ++p) {
+            const auto& line = stages.m_scanLines[pending[p]];
+            computed[p] = compensatedLine(heightmap, tool, res, line.stepPos, line.primaryAxis);
+        }
+    });
+
+    for (usize p = 0; p < pending.size(); ++p) {
+        auto& line = stages.m_scanLines[pending[p]];
+        auto& stored = stages.m_lines[scanLineKey(line.primaryAxis, line.stepPos)];
+        if (stored.empty()) {
+            stored = std::move(computed[p]);
+            ++stages.m_linesComputed;
+        }
+        line.z = &stored;
+    }
+}
+
+std::vector<f32> ToolpathGenerator::compensatedLine(const Heightmap& heightmap,
+                                                    const VtdbToolGeometry& tool,
+                                                    f32 scanResolution,
+                                                    f32 stepPos,
+                                                    bool primaryAxis) const
+{
+    const Vec3 bmin = heightmap.boundsMin();
+    const Vec3 bmax = heightmap.boundsMax();
+    const f32 res = scanResolution;
+    const f32 scanMin = primaryAxis ? bmin.x : bmin.y;
+    const f32 scanMax = primaryAxis ? bmax.x : bmax.y;
+
+    // Points along the scan line at scan resolution, in increasing order;
+    // Z is the heightmap raised by the tool offset at each point
+    const int numPoints = std::max(
+        1, static_cast<int>((scanMax - scanMin) / res) + 1);
+    std::vector<f32> zs(static_cast<usize>(numPoints));
+    for (int idx = 0; idx < numPoints; ++idx) {
+        const f32 scanPos = scanMin + static_cast<f32>(idx) * res;
+        const f32 x = primaryAxis ? scanPos : stepPos;
+        const f32 y = primaryAxis ? stepPos : scanPos;
+        f32 z = heightmap.atMm(x, y);
+        z += toolOffset(heightmap, x, y, tool);
+        zs[static_cast<usize>(idx)] = z;
+    }
+    return zs;
+}
+
+namespace {
+
+// Tightest local tolerance, as a fraction of the configured one
+constexpr f32 kMinToleranceScale = 0.25f;
+
+// Greedy chord fit over one line: from each kept sample, extend the chord as
+// far as every skipped sample stays within its own tolerance of it. Keeps the
+// first and last sample; indices come out in increasing order. O(n): each
+// chord test is checked against the slope window narrowed by the samples
+// already skipped.
+void decimateLine(const std::vector<f32>& zs,
+                  const std::vector<f32>& tolerance,
+                  std::vector<u32>& kept)
+{
+    kept.clear();
+    const usize n = zs.size();
+    if (n == 0) return;
+    kept.push_back(0);
+    usize anchor = 0;
+    while (anchor + 1 < n) {
+        f32 lo = std::numeric_limits<f32>::lowest();
+        f32 hi = std::numeric_limits<f32>::max();
+        usize end = anchor + 1;
+        for (usize j = anchor + 1; j < n; ++j) {
+            const f32 run = static_cast<f32>(j - anchor);
+            const f32 rise = zs[j] - zs[anchor];
+            const f32 slope = rise / run;
+            if (slope < lo || slope > hi) break;
+            end = j;
+            lo = std::max(lo, (rise - tolerance[j]) / run);
+            hi = std::min(hi, (rise + tolerance[j]) / run);
+        }
+        kept.push_back(static_cast<u32>(end));
+        anchor = end;
+    }
+}
+
+} // namespace
+
+void ToolpathGenerator::decimateScanLines(ToolpathStages& stages,
+                                           const Heightmap& heightmap,
+                                           f32 toleranceMm)
+{
+    if (toleranceMm <= 0.0f) {
+        for (auto& line : stages.m_scanLines) line.kept.clear();
+        return;
+    }
+    DW_TRACE_ZONE("Toolpath decimation");
+
+    // Cells curving tighter than the surface's average concave radius (either
+    // sign) get a proportionally tighter tolerance, so detail survives there
+    if (!stages.m_curvatureValid) {
+        stages.m_curvatureRadius = analyzeCurvature(heightmap).avgConcaveRadius;
+        stages.m_curvatureValid = true;
+    }
+    const f32 refRadius = stages.m_curvatureRadius;
+    const Vec3 bmin = heightmap.boundsMin();
+    const f32 res = stages.m_surfaceKey.scanResolution;
+    const f32 cellSize = heightmap.resolution();
+
+    parallelFor(stages.m_scanLines.size(), 4, [&](usize begin, usize end) {
+        std::vector<f32> tolerance;
+        for (usize i = begin; i < end; ++i) {
+            auto& line = stages.m_scanLines[i];
+            const auto& zs = *line.z;
+            tolerance.assign(zs.size(), toleranceMm);
+            if (refRadius > 0.0f) {
+                const f32 stepMin = line.primaryAxis ? bmin.y : bmin.x;
+                const int stepCell = static_cast<int>((line.stepPos - stepMin) / cellSize);
+                for (usize k = 0; k < zs.size(); ++k) {
+                    const int scanCell = static_cast<int>(static_cast<f32>(k) * res / cellSize);
+                    const f32 radius = std::abs(line.primaryAxis
+                        ? computeLocalRadius(heightmap, scanCell, stepCell)
+                        : computeLocalRadius(heightmap, stepCell, scanCell));
+                    if (radius > 0.0f && radius < refRadius)
+                        tolerance[k] *= std::max(kMinToleranceScale, radius / refRadius);
+                }
+            }
+            decimateLine(zs, tolerance, line.kept);
+        }
+    });
+}
+
+void ToolpathGenerator::linkScanLines(ToolpathStages& stages,
+                                       const Heightmap& heightmap,
+                                       const ToolpathConfig& config)
+{
+    const Vec3 bmin = heightmap.boundsMin();
+    const Vec3 bmax = heightmap.boundsMax();
+    const f32 res = stages.m_surfaceKey.scanResolution;
+
+    Toolpath& path = stages.m_finishing;
+    path = Toolpath{};
+    path.scanLineCount = stages.m_scanLineCount;
+
+    usize total = 0;
+    for (const auto& line : stages.m_scanLines)
+        total += (line.kept.empty() ? line.z->size() : line.kept.size()) + 2;
+    path.points.reserve(total);
+
+    for (const auto& line : stages.m_scanLines) {
+        const f32 scanMin = line.primaryAxis ? bmin.x : bmin.y;
+        const f32 scanMax = line.primaryAxis ? bmax.x : bmax.y;
+
         // Retract before moving to next line
         addRetract(path, config.safeZMm);
 
         // Rapid to start of line
-        f32 startScan = forward ? scanMin : scanMax;
+        f32 startScan = line.forward ? scanMin : scanMax;
         Vec3 startPos;
-        if (primaryAxis) {
-            startPos = {startScan, stepPos, config.safeZMm};
+        if (line.primaryAxis) {
+            startPos = {startScan, line.stepPos, config.safeZMm};
         } else {
-            startPos = {stepPos, startScan, config.safeZMm};
+            startPos = {line.stepPos, startScan, config.safeZMm};
         }
         addRapidTo(path, startPos);
 
-        // Generate points along scan line at heightmap resolution
-        const int numPoints = std::max(
-            1, static_cast<int>((scanMax - scanMin) / res) + 1);
-
+        const auto& zs = *line.z;
+        const int numPoints = static_cast<int>(line.kept.empty() ? zs.size() : line.kept.size());
+        path.sampledPointCount += static_cast<int>(zs.size());
+        path.cutPointCount += numPoints;
         for (int ptIdx = 0; ptIdx < numPoints; ++ptIdx) {
-            const int idx = forward ? ptIdx : (numPoints - 1 - ptIdx);
+            const int order = line.forward ? ptIdx : (numPoints - 1 - ptIdx);
+            const int idx = line.kept.empty() ? order : static_cast<int>(line.kept[static_cast<usize>(order)]);
             const f32 scanPos = scanMin + static_cast<f32>(idx) * res;
 
-            f32 x = primaryAxis ? scanPos : stepPos;
-            f32 y = primaryAxis ? stepPos : scanPos;
-            f32 z = heightmap.atMm(x, y);
-
-            addCutTo(path, {x, y, z});
+            f32 x = line.primaryAxis ? scanPos : line.stepPos;
+            f32 y = line.primaryAxis ? line.stepPos : scanPos;
+            addCutTo(path, {x, y, zs[static_cast<usize>(idx)]});
         }
     }
 }
@@ -408,15 +780,27 @@ f32 ToolpathGenerator::ballNoseOffset(const Heightmap& heightmap,
     // On a flat surface, the offset is R (tool center above contact by R)
     f32 maxContactZ = centerZ + R;
 
-    for (int di = -steps; di <= steps; ++di) {
-        for (int dj = -steps; dj <= steps; ++dj) {
+    // Nothing under the ball rises above the center: the flat answer is exact
+    const f32 reach = static_cast<f32>(steps) * res;
+    if (heightmap.maxBoundMm(x - reach, y - reach, x + reach, y + reach) <= centerZ)
+        return maxContactZ - centerZ;
+
+    for (int dj = -steps; dj <= steps; ++dj) {
+        const f32 dy = static_cast<f32>(dj) * res;
+        const f32 rowLift2 = R * R - dy * dy;
+        if (rowLift2 < 0.0f) continue;
+
+        // Skip rows that cannot beat the current contact, even at full lift
+        const f32 ny = y + dy;
+        if (heightmap.maxBoundMm(x - reach, ny, x + reach, ny) + std::sqrt(rowLift2) <=
+            maxContactZ) continue;
+
+        for (int di = -steps; di <= steps; ++di) {
             const f32 dx = static_cast<f32>(di) * res;
-            const f32 dy = static_cast<f32>(dj) * res;
             const f32 r2 = dx * dx + dy * dy;
             if (r2 > R * R) continue;
 
             const f32 nx = x + dx;
-            const f32 ny = y + dy;
             if (nx < bmin.x || nx > bmax.x ||
                 ny < bmin.y || ny > bmax.y) continue;
 
@@ -446,14 +830,22 @@ f32 ToolpathGenerator::endMillOffset(const Heightmap& heightmap,
     const f32 centerZ = heightmap.atMm(x, y);
     f32 maxZ = centerZ;
 
-    for (int di = -steps; di <= steps; ++di) {
-        for (int dj = -steps; dj <= steps; ++dj) {
+    // Rows whose pyramid bound cannot exceed the running maximum are skipped;
+    // on flats and peaks the first (whole-footprint) query settles it
+    const f32 reach = static_cast<f32>(steps) * res;
+    if (heightmap.maxBoundMm(x - reach, y - reach, x + reach, y + reach) <= centerZ)
+        return 0.0f;
+
+    for (int dj = -steps; dj <= steps; ++dj) {
+        const f32 dy = static_cast<f32>(dj) * res;
+        const f32 ny = y + dy;
+        if (heightmap.maxBoundMm(x - reach, ny, x + reach, ny) <= maxZ) continue;
+
+        for (int di = -steps; di <= steps; ++di) {
             const f32 dx = static_cast<f32>(di) * res;
-            const f32 dy = static_cast<f32>(dj) * res;
             if (dx * dx + dy * dy > R * R) continue;
 
             const f32 nx = x + dx;
-            const f32 ny = y + dy;
             if (nx < bmin.x || nx > bmax.x ||
                 ny < bmin.y || ny > bmax.y) continue;
 
@@ -5,37 +5,176 @@
 #include "toolpath_types.h"
 #include "../cnc/cnc_tool.h"
 
+#include <functional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace dw {
 namespace carve {
 
+// Memoized intermediate results of toolpath generation, reused across calls.
+// Each stage is keyed by the settings it depends on, and a call reruns only
+// the stages from the first changed input down:
+//   compensated surface  tool geometry, scan resolution
+//   scan-line sampling   axis, direction, stepover
+//   point decimation     tolerance
+//   linking / retracts   safe Z
+//   feed assignment      feed rate
+// Compensated heights are kept per scan line, so re-sampling reuses every
+// line position computed before. The owner calls clear() when the heightmap
+// changes and clearClearing() when the islands do.
+class ToolpathStages {
+  public:
+    ToolpathStages() = default;
+    // Scan lines point into the line cache, so copies would dangle
+    ToolpathStages(const ToolpathStages&) = delete;
+    ToolpathStages& operator=(const ToolpathStages&) = delete;
+
+    void clear();
+    void clearClearing();
+
+    // Finishing scan lines compensated / served from cache by the last call
+    int linesComputed() const { return m_linesComputed; }
+    int linesReused() const { return m_linesReused; }
+
+  private:
+    friend class ToolpathGenerator;
+
+    void clearFinishing();
+
+    struct SurfaceKey {
+        const Heightmap* heightmap = nullptr;
+        int cols = 0;
+        int rows = 0;
+        VtdbToolType toolType = VtdbToolType::EndMill;
+        f64 diameter = 0.0;
+        f64 tipRadius = 0.0;
+        f64 includedAngle = 0.0;
+        f32 scanResolution = 0.0f;
+        bool operator==(const SurfaceKey& o) const;
+    };
+    struct SamplingKey {
+        ScanAxis axis = ScanAxis::XOnly;
+        MillDirection direction = MillDirection::Alternating;
+        f32 stepoverMm = 0.0f;
+        bool operator==(const SamplingKey& o) const;
+    };
+    struct ScanLine {
+        bool primaryAxis = true;
+        bool forward = true;
+        f32 stepPos = 0.0f;
+        const std::vector<f32>* z = nullptr; // Compensated Z in scan order
+        std::vector<u32> kept;               // Indices into z left by decimation (empty = all)
+    };
+    struct ClearingKey {
+        const Heightmap* heightmap = nullptr;
+        f32 toolDiameter = 0.0f;
+        f32 safeZ = 0.0f;
+        f32 leadIn = 0.0f;
+        bool operator==(const ClearingKey& o) const;
+    };
+
+    // Finishing: compensated surface, keyed by (axis, stepPos bits)
+    bool m_surfaceValid = false;
+    SurfaceKey m_surfaceKey;
+    std::unordered_map<u64, std::vector<f32>> m_lines;
+    int m_linesComputed = 0;
+    int m_linesReused = 0;
+
+    // Finishing: sampling
+    bool m_samplingValid = false;
+    SamplingKey m_samplingKey;
+    std::vector<ScanLine> m_scanLines;
+    int m_scanLineCount = 0;
+
+    // Finishing: decimation, with the surface's reference radius for refinement
+    bool m_decimationValid = false;
+    f32 m_tolerance = 0.0f;
+    bool m_curvatureValid = false;
+    f32 m_curvatureRadius = 0.0f;
+
+    // Finishing: linking and feeds
+    bool m_linkValid = false;
+    f32 m_linkSafeZ = 0.0f;
+    bool m_feedValid = false;
+    f32 m_feedRate = 0.0f;
+    Toolpath m_finishing;
+
+    // Clearing: geometry, then feeds
+    bool m_clearingValid = false;
+    ClearingKey m_clearingKey;
+    f32 m_clearingFeedRate = 0.0f;
+    Toolpath m_clearing;
+};
+
+// Scan lines and clearing passes are generated in parallel into per-line
+// buffers and stitched in order, so output is the same for any thread count.
 class ToolpathGenerator {
   public:
+    // Called on the calling thread between batches of lines with the fraction
+    // of the current pass done. Throw from it to cancel; cached stages stay
+    // consistent and the next call picks up from there.
+    using ProgressCallback = std::function<void(f32)>;
+    void setProgressCallback(ProgressCallback onProgress) { m_onProgress = std::move(onProgress); }
+
     // Generate finishing toolpath from heightmap with tool offset compensation
     Toolpath generateFinishing(const Heightmap& heightmap,
                                const ToolpathConfig& config,
                                f32 toolTipDiameter,
                                const VtdbToolGeometry& tool);
 
+    // Same, reusing and updating the cached stages
+    Toolpath generateFinishing(const Heightmap& heightmap,
+                               const ToolpathConfig& config,
+                               f32 toolTipDiameter,
+                               const VtdbToolGeometry& tool,
+                               ToolpathStages& stages);
+
     // Generate clearing toolpath for islands only
     Toolpath generateClearing(const Heightmap& heightmap,
                               const IslandResult& islands,
                               const ToolpathConfig& config,
                               f32 toolDiameter);
 
+    // Same, reusing the cached geometry when only the feed rate changed
+    Toolpath generateClearing(const Heightmap& heightmap,
+                              const IslandResult& islands,
+                              const ToolpathConfig& config,
+                              f32 toolDiameter,
+                              ToolpathStages& stages);
+
     // Validate toolpath against machine travel limits, return warnings
     std::vector<std::string> validateLimits(
         const Toolpath& path,
         f32 travelX, f32 travelY, f32 travelZ) const;
 
   private:
-    void generateScanLines(Toolpath& path,
+    // Run body over [0, count) with parallelFor in batches of `batch`,
+    // reporting progress after each one
+    void runBatched(usize count, usize batch,
+                    const std::function<void(usize begin, usize end)>& body);
+
+    // Finishing stages (see ToolpathStages)
+    void sampleScanLines(ToolpathStages& stages,
+                         const Heightmap& heightmap,
+                         const ToolpathConfig& config,
+                         f32 stepoverMm,
+                         bool primaryAxis);  // true=X, false=Y
+    void compensateScanLines(ToolpathStages& stages,
+                             const Heightmap& heightmap,
+                             const VtdbToolGeometry& tool);
+    std::vector<f32> compensatedLine(const Heightmap& heightmap,
+                                     const VtdbToolGeometry& tool,
+                                     f32 scanResolution,
+                                     f32 stepPos,
+                                     bool primaryAxis) const;
+    void decimateScanLines(ToolpathStages& stages,
                            const Heightmap& heightmap,
-                           const ToolpathConfig& config,
-                           f32 stepoverMm,
-                           bool primaryAxis);  // true=X, false=Y
+                           f32 toleranceMm);
+    void linkScanLines(ToolpathStages& stages,
+                       const Heightmap& heightmap,
+                       const ToolpathConfig& config);
 
     void addRetract(Toolpath& path, f32 safeZ);
     void addRapidTo(Toolpath& path, const Vec3& pos);
@@ -61,15 +200,31 @@ class ToolpathGenerator {
                       f32 x, f32 y,
                       const VtdbToolGeometry& tool) const;
 
-    // Clear a single island region with depth-pass raster scanning
-    void clearIslandRegion(Toolpath& path,
-                           const Heightmap& heightmap,
-                           const IslandResult& islands,
-                           const Island& island,
-                           const ToolpathConfig& config,
-                           f32 stepoverMm,
-                           f32 stepdownMm,
-                           f32 toolRadius);
+    // One raster line of one island depth pass
+    struct ClearingLine {
+        const Island* island = nullptr;
+        f32 y = 0.0f;
+        f32 cutZ = 0.0f;
+        f32 xMin = 0.0f;
+        f32 xMax = 0.0f;
+        int leadingRetracts = 1; // Retracts issued before the line's own moves
+    };
+
+    // Plan the depth-pass raster lines of one island (appended in cut order)
+    void planIslandRegion(std::vector<ClearingLine>& lines,
+                          const Island& island,
+                          f32 stepoverMm,
+                          f32 stepdownMm,
+                          f32 toolRadius) const;
+
+    // Moves of a single clearing line, without the leading retracts
+    void clearIslandLine(Toolpath& path,
+                         const Heightmap& heightmap,
+                         const IslandResult& islands,
+                         const ClearingLine& line,
+                         const ToolpathConfig& config);
+
+    ProgressCallback m_onProgress;
 };
 
 } // namespace carve
@@ -39,6 +39,7 @@ struct ToolpathConfig {
     f32 plungeRateMmMin = 300.0f;
     f32 leadInMm = 2.0f;  // Ramp distance for clearing lead-in/out
     f32 scanResolutionMm = 0.0f;  // Point spacing along scan lines (0 = heightmap resolution)
+    f32 toleranceMm = 0.0f;  // Max Z deviation of dropped scan points (0 = keep every point)
 };
 
 // Single toolpath move
@@ -54,6 +55,8 @@ struct Toolpath {
     f32 estimatedTimeSec = 0.0f;
     int lineCount = 0;       // Number of G-code lines this will produce
     int scanLineCount = 0;   // Number of actual scan passes
+    int sampledPointCount = 0;  // Scan-line cut points at uniform spacing
+    int cutPointCount = 0;      // Scan-line cut points emitted after decimation
     std::vector<std::string> warnings;  // Travel limit violations
 };
 
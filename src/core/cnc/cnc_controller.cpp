@@ -15,6 +15,19 @@
 
 namespace dw {
 
+namespace {
+// Coalescing channels for MainThreadQueue::enqueueLatest: only the newest
+// status report / progress snapshot matters once the UI catches up
+constexpr u32 kStatusChannel = 0;
+constexpr u32 kProgressChannel = 1;
+
+// Connection, alarm, error, status and progress events all go out at this one
+// priority so they reach the UI in the order they happened; a progress
+// snapshot queued before a disconnect must not run after it. Status and
+// progress are coalesced, so at most one of each is ever pending.
+constexpr TaskPriority kStatePriority = TaskPriority::High;
+} // namespace
+
 CncController::CncController(MainThreadQueue* mtq) : m_mtq(mtq) {}
 
 CncController::~CncController() {
@@ -148,13 +161,15 @@ void CncController::disconnect() {
     if (wasSim) {
         // Simulator mode — no serial port to close
         if (wasConnected && m_mtq && m_callbacks.onConnectionChanged)
-            m_mtq->enqueue([cb = m_callbacks.onConnectionChanged]() { cb(false, ""); });
+            m_mtq->enqueue([cb = m_callbacks.onConnectionChanged]() { cb(false, ""); },
+                           kStatePriority);
     } else if (m_port && m_port->isOpen()) {
         m_port->close();
         m_port.reset();
 
         if (wasConnected && m_mtq && m_callbacks.onConnectionChanged)
-            m_mtq->enqueue([cb = m_callbacks.onConnectionChanged]() { cb(false, ""); });
+            m_mtq->enqueue([cb = m_callbacks.onConnectionChanged]() { cb(false, ""); },
+                           kStatePriority);
     }
 }
 
@@ -162,9 +177,11 @@ void CncController::startStream(const std::vector<std::string>& lines) {
     if (m_errorState) {
         log::error("CNC", "Cannot start stream while in error state -- call acknowledgeError() first");
         if (m_mtq && m_callbacks.onError) {
-            m_mtq->enqueue([cb = m_callbacks.onError]() {
-                cb("Cannot start new job: previous streaming error must be acknowledged first");
-            });
+            m_mtq->enqueue(
+                [cb = m_callbacks.onError]() {
+                    cb("Cannot start new job: previous streaming error must be acknowledged first");
+                },
+                kStatePriority);
         }
         return;
     }
@@ -338,7 +355,8 @@ void CncController::ioThreadFunc() {
         log::error("CNC", "No compatible controller detected");
         m_running = false;
         if (m_mtq && m_callbacks.onConnectionChanged)
-            m_mtq->enqueue([cb = m_callbacks.onConnectionChanged]() { cb(false, ""); });
+            m_mtq->enqueue([cb = m_callbacks.onConnectionChanged]() { cb(false, ""); },
+                           kStatePriority);
         return;
     }
 
@@ -358,7 +376,8 @@ void CncController::ioThreadFunc() {
                m_firmwareType == FirmwareType::GrblHAL ? "grblHAL" : "GRBL");
     if (m_mtq && m_callbacks.onConnectionChanged) {
         m_mtq->enqueue(
-            [cb = m_callbacks.onConnectionChanged, ver = version]() { cb(true, ver); });
+            [cb = m_callbacks.onConnectionChanged, ver = version]() { cb(true, ver); },
+            kStatePriority);
     }
 
     m_lastStatusQuery = std::chrono::steady_clock::now();
@@ -422,12 +441,26 @@ void CncController::processResponse(const std::string& line) {
 
     // Status report: <Idle|MPos:0.000,0.000,0.000|...>
     if (line.front() == '<' && line.back() == '>') {
-        m_lastStatus = parseStatusReport(line);
+        MachineStatus status = parseStatusReport(line);
+        // GRBL only includes WCO and Ov every few reports; carry the last
+        // values forward so workPos and overrides stay valid in between
+        if (line.find("WCO:") != std::string::npos)
+            m_workOffset = status.machinePos - status.workPos;
+        else if (line.find("WPos:") == std::string::npos)
+            status.workPos = status.machinePos - m_workOffset;
+        if (line.find("Ov:") == std::string::npos) {
+            status.feedOverride = m_lastStatus.feedOverride;
+            status.rapidOverride = m_lastStatus.rapidOverride;
+            status.spindleOverride = m_lastStatus.spindleOverride;
+        }
+        m_lastStatus = status;
+        m_telemetry.recordStatus(m_lastStatus);
         m_statusPending = false;
         m_consecutiveTimeouts = 0;
         if (m_mtq && m_callbacks.onStatusUpdate) {
-            m_mtq->enqueue(
-                [cb = m_callbacks.onStatusUpdate, st = m_lastStatus]() { cb(st); });
+            m_mtq->enqueueLatest(MainThreadQueue::latestKey(this, kStatusChannel),
+                                 [cb = m_callbacks.onStatusUpdate, st = m_lastStatus]() { cb(st); },
+                                 kStatePriority);
         }
         return;
     }
@@ -440,7 +473,8 @@ void CncController::processResponse(const std::string& line) {
         } catch (...) {}
         std::string desc = alarmDescription(code);
         if (m_mtq && m_callbacks.onAlarm) {
-            m_mtq->enqueue([cb = m_callbacks.onAlarm, code, desc]() { cb(code, desc); });
+            m_mtq->enqueue([cb = m_callbacks.onAlarm, code, desc]() { cb(code, desc); },
+                           kStatePriority);
         }
         // Stop streaming on alarm
         m_streaming = false;
@@ -464,6 +498,10 @@ void CncController::processResponse(const std::string& line) {
             try {
                 ack.errorCode = std::stoi(line.substr(6));
             } catch (...) {}
+        }
+        m_telemetry.recordAck(ack.lineIndex, ack.ok, ack.errorCode);
+
+        if (!ack.ok) {
             ack.errorMessage = errorDescription(ack.errorCode);
             m_errorCount++;
 
@@ -493,9 +531,8 @@ void CncController::processResponse(const std::string& line) {
 
                 // Notify UI with detailed error report
                 if (m_mtq && m_callbacks.onStreamingError) {
-                    m_mtq->enqueue([cb = m_callbacks.onStreamingError, streamErr]() {
-                        cb(streamErr);
-                    });
+                    m_mtq->enqueue([cb = m_callbacks.onStreamingError, streamErr]() { cb(streamErr); },
+                                   kStatePriority);
                 }
 
                 // Also fire the line ack callback so UI can track the specific line
@@ -520,7 +557,9 @@ void CncController::processResponse(const std::string& line) {
         // Post progress update
         if (m_mtq && m_callbacks.onProgressUpdate) {
             auto prog = streamProgress();
-            m_mtq->enqueue([cb = m_callbacks.onProgressUpdate, prog]() { cb(prog); });
+            m_mtq->enqueueLatest(MainThreadQueue::latestKey(this, kProgressChannel),
+                                 [cb = m_callbacks.onProgressUpdate, prog]() { cb(prog); },
+                                 kStatePriority);
         }
         return;
     }
@@ -531,7 +570,7 @@ void CncController::processResponse(const std::string& line) {
             std::string msg = line.substr(5);
             if (!msg.empty() && msg.back() == ']')
                 msg.pop_back();
-            m_mtq->enqueue([cb = m_callbacks.onError, msg]() { cb(msg); });
+            m_mtq->enqueue([cb = m_callbacks.onError, msg]() { cb(msg); }, kStatePriority);
         }
     }
 }
@@ -665,14 +704,15 @@ void CncController::handleDisconnect() {
 
     // Notify UI of disconnect
     if (m_mtq && m_callbacks.onConnectionChanged)
-        m_mtq->enqueue([cb = m_callbacks.onConnectionChanged]() {
-            cb(false, "");
-        });
+        m_mtq->enqueue([cb = m_callbacks.onConnectionChanged]() { cb(false, ""); },
+                       kStatePriority);
 
     if (wasStreaming && m_mtq && m_callbacks.onError)
-        m_mtq->enqueue([cb = m_callbacks.onError]() {
-            cb("Connection lost during streaming -- job aborted. Manual reconnect required.");
-        });
+        m_mtq->enqueue(
+            [cb = m_callbacks.onError]() {
+                cb("Connection lost during streaming -- job aborted. Manual reconnect required.");
+            },
+            kStatePriority);
 }
 
 // --- Simulator ---
@@ -768,7 +808,8 @@ void CncController::simIoThreadFunc() {
     m_connected = true;
     log::infof("CNC", "Simulator connected: %s", version.c_str());
     if (m_mtq && m_callbacks.onConnectionChanged)
-        m_mtq->enqueue([cb = m_callbacks.onConnectionChanged, ver = version]() { cb(true, ver); });
+        m_mtq->enqueue([cb = m_callbacks.onConnectionChanged, ver = version]() { cb(true, ver); },
+                       kStatePriority);
     simEmitLine(version);
 
     auto lastStatusTime = std::chrono::steady_clock::now();
@@ -896,6 +937,7 @@ void CncController::simIoThreadFunc() {
                     ack.lineIndex = m_ackIndex;
                     ack.ok = true;
                     m_ackIndex++;
+                    m_telemetry.recordAck(ack.lineIndex, ack.ok, ack.errorCode);
 
                     simEmitLine("ok");
                     if (m_mtq && m_callbacks.onLineAcked)
@@ -907,7 +949,9 @@ void CncController::simIoThreadFunc() {
                         prog.errorCount = m_errorCount;
                         prog.elapsedSeconds = std::chrono::duration<f32>(
                             std::chrono::steady_clock::now() - m_streamStartTime).count();
-                        m_mtq->enqueue([cb = m_callbacks.onProgressUpdate, prog]() { cb(prog); });
+                        m_mtq->enqueueLatest(
+                            MainThreadQueue::latestKey(this, kProgressChannel),
+                            [cb = m_callbacks.onProgressUpdate, prog]() { cb(prog); }, kStatePriority);
                     }
 
                     if (m_ackIndex >= static_cast<int>(m_program.size())) {
@@ -928,8 +972,11 @@ void CncController::simIoThreadFunc() {
             std::string statusStr = buildSimStatus();
             MachineStatus status = parseStatusReport(statusStr);
             m_lastStatus = status;
+            m_telemetry.recordStatus(status);
             if (m_mtq && m_callbacks.onStatusUpdate)
-                m_mtq->enqueue([cb = m_callbacks.onStatusUpdate, status]() { cb(status); });
+                m_mtq->enqueueLatest(MainThreadQueue::latestKey(this, kStatusChannel),
+                                     [cb = m_callbacks.onStatusUpdate, status]() { cb(status); },
+                                     kStatePriority);
         }
 
         std::this_thread::sleep_for(std::chrono::milliseconds(20));
@@ -10,6 +10,7 @@
 
 #include "byte_stream.h"
 #include "cnc_types.h"
+#include "job_telemetry.h"
 #include "unified_settings.h"
 
 namespace dw {
@@ -61,6 +62,10 @@ class CncController {
     const MachineStatus& lastStatus() const { return m_lastStatus; }
     StreamProgress streamProgress() const;
 
+    // Job telemetry — status samples and line acks are recorded on the IO
+    // thread while a recording is open
+    JobTelemetryRecorder& telemetry() { return m_telemetry; }
+
     // Error state — set after streaming error, requires acknowledgment
     bool isInErrorState() const { return m_errorState.load(); }
     void acknowledgeError();
@@ -135,12 +140,14 @@ class CncController {
 
     // Status polling and disconnect detection
     MachineStatus m_lastStatus;
+    Vec3 m_workOffset{0.0f}; // Last WCO reported; GRBL only sends it every few reports
     std::chrono::steady_clock::time_point m_lastStatusQuery;
     std::chrono::steady_clock::time_point m_streamStartTime;
     int m_consecutiveTimeouts = 0;
     bool m_statusPending = false;
 
     int m_statusPollMs = 200; // Default 5 Hz, configurable via Config
+    JobTelemetryRecorder m_telemetry;
     static constexpr int MAX_CONSECUTIVE_TIMEOUTS = 10; // ~2 seconds of no response
 
     // Firmware detection
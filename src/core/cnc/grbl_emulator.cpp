@@ -0,0 +1,725 @@
+#include "grbl_emulator.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+#include "../utils/log.h"
+#include "cnc_types.h"
+
+namespace dw {
+
+namespace {
+
+constexpr f64 kMotionStep = 0.0005;   // Integration step for planner blocks (s)
+constexpr f32 kStraightCos = 0.999999f; // Junctions closer to straight/reversal than this
+constexpr f32 kMmPerInch = 25.4f;
+constexpr u8 kJogCancel = 0x85;
+
+std::string formatSetting(int id, f32 value) {
+    char buf[48];
+    std::snprintf(buf, sizeof(buf), "$%d=%.3f", id, static_cast<double>(value));
+    return buf;
+}
+
+} // namespace
+
+GrblEmulator::GrblEmulator(const GrblEmulatorConfig& config) : m_config(config) {}
+
+GrblEmulator::~GrblEmulator() {
+    stop();
+}
+
+GrblEmulatorStats GrblEmulator::stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+void GrblEmulator::resetStats() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats = GrblEmulatorStats{};
+    m_emptySince = -1.0;
+}
+
+Vec3 GrblEmulator::position() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_position;
+}
+
+bool GrblEmulator::isIdle() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_wire.empty() && m_rx.empty() && m_planner.empty();
+}
+
+// --- Link and protocol ---
+
+void GrblEmulator::receiveByte(u8 byte) {
+    ++m_stats.bytesReceived;
+
+    // Real-time commands are picked off the wire before the RX buffer
+    switch (byte) {
+    case cnc::CMD_STATUS_QUERY:
+        reply(statusReport());
+        return;
+    case cnc::CMD_FEED_HOLD:
+        m_hold = true;
+        return;
+    case cnc::CMD_CYCLE_START:
+        m_hold = false;
+        return;
+    case cnc::CMD_SOFT_RESET:
+        softReset();
+        return;
+    case kJogCancel:
+        return;
+    case cnc::CMD_FEED_100_PERCENT: m_feedOverride = 100; return;
+    case cnc::CMD_FEED_PLUS_10:     m_feedOverride += 10; break;
+    case cnc::CMD_FEED_MINUS_10:    m_feedOverride -= 10; break;
+    case cnc::CMD_FEED_PLUS_1:      m_feedOverride += 1; break;
+    case cnc::CMD_FEED_MINUS_1:     m_feedOverride -= 1; break;
+    case cnc::CMD_RAPID_100_PERCENT: m_rapidOverride = 100; return;
+    case cnc::CMD_RAPID_50_PERCENT:  m_rapidOverride = 50; return;
+    case cnc::CMD_RAPID_25_PERCENT:  m_rapidOverride = 25; return;
+    default:
+        if (byte >= 0x80)
+            return; // Other extended real-time commands (spindle, coolant) are ignored
+        if (m_rx.size() >= m_config.rxBufferSize) {
+            ++m_stats.rxOverflowBytes;
+            return;
+        }
+        m_rx.push_back(static_cast<char>(byte));
+        m_stats.peakRxUsed = std::max(m_stats.peakRxUsed, m_rx.size());
+        return;
+    }
+    m_feedOverride = std::clamp(m_feedOverride, 10, 200);
+}
+
+void GrblEmulator::processLines() {
+    while (true) {
+        auto eol = m_rx.find_first_of("\r\n");
+        if (eol == std::string::npos)
+            return;
+        // A line that needs a planner block waits in the RX buffer until one frees up
+        if (!executeLine(m_rx.substr(0, eol)))
+            return;
+        m_rx.erase(0, eol + 1);
+        ++m_stats.linesProcessed;
+    }
+}
+
+bool GrblEmulator::executeLine(const std::string& raw) {
+    // Drop whitespace and comments, upper-case the rest
+    std::string line;
+    bool inComment = false;
+    for (char c : raw) {
+        if (inComment) {
+            inComment = (c != ')');
+            continue;
+        }
+        if (c == '(') {
+            inComment = true;
+            continue;
+        }
+        if (c == ';')
+            break;
+        if (std::isspace(static_cast<unsigned char>(c)))
+            continue;
+        line.push_back(static_cast<char>(std::toupper(static_cast<unsigned char>(c))));
+    }
+
+    // Empty and comment-only lines are acknowledged, as GRBL does for syncing
+    if (line.empty()) {
+        reply("ok");
+        ++m_stats.okCount;
+        return true;
+    }
+    if (line[0] == '$')
+        return executeSystemCommand(line);
+    return executeGcode(line, false);
+}
+
+bool GrblEmulator::executeSystemCommand(const std::string& line) {
+    auto ok = [this]() {
+        reply("ok");
+        ++m_stats.okCount;
+        return true;
+    };
+
+    if (line.rfind("$J=", 0) == 0)
+        return executeGcode(line.substr(3), true);
+
+    if (line == "$$") {
+        reply(formatSetting(11, m_config.junctionDeviation));
+        for (int axis = 0; axis < 3; ++axis)
+            reply(formatSetting(110 + axis, m_config.maxRate[axis]));
+        for (int axis = 0; axis < 3; ++axis)
+            reply(formatSetting(120 + axis, m_config.acceleration[axis]));
+        return ok();
+    }
+    if (line == "$I") {
+        reply("[VER:1.1h.20190825:]");
+        reply("[OPT:V," + std::to_string(m_config.plannerBlocks) + "," +
+              std::to_string(m_config.rxBufferSize) + "]");
+        return ok();
+    }
+    if (line == "$G") {
+        char buf[128];
+        std::snprintf(buf, sizeof(buf), "[GC:G%d G54 G17 %s %s G94 M5 M9 T0 F%.0f S0]", m_motion,
+                      m_inches ? "G20" : "G21", m_absolute ? "G90" : "G91",
+                      static_cast<double>(m_inches ? m_feedRate / kMmPerInch : m_feedRate));
+        reply(buf);
+        return ok();
+    }
+    if (line == "$X") {
+        reply("[MSG:Caution: Unlocked]");
+        return ok();
+    }
+    if (line == "$H") {
+        // Homing is instant: the machine is at its origin once the planner is empty
+        if (!m_planner.empty())
+            return false;
+        m_position = Vec3{0.0f};
+        m_plannedPos = m_position;
+        return ok();
+    }
+    if (line == "$" || line == "$#" || line == "$N" || line == "$C" || line == "$SLP")
+        return ok();
+
+    // $<id>=<value>
+    char* end = nullptr;
+    const long id = std::strtol(line.c_str() + 1, &end, 10);
+    if (end != line.c_str() + 1 && *end == '=') {
+        const auto value = static_cast<f32>(std::strtod(end + 1, nullptr));
+        if (id == 11)
+            m_config.junctionDeviation = value;
+        else if (id >= 110 && id <= 112)
+            m_config.maxRate[static_cast<int>(id - 110)] = value;
+        else if (id >= 120 && id <= 122)
+            m_config.acceleration[static_cast<int>(id - 120)] = value;
+        return ok();
+    }
+
+    reply("error:3"); // '$' statement not valid
+    ++m_stats.errorCount;
+    return true;
+}
+
+bool GrblEmulator::executeGcode(const std::string& line, bool jog) {
+    auto error = [this](int code) {
+        reply("error:" + std::to_string(code));
+        ++m_stats.errorCount;
+        return true;
+    };
+
+    // Parse into locals; modal state is only committed once the line is accepted
+    int motion = m_motion;
+    bool absolute = m_absolute;
+    bool inches = m_inches;
+    bool hasAxis[3] = {false, false, false};
+    f32 axis[3] = {0.0f, 0.0f, 0.0f};
+    bool hasFeed = false;
+    f32 feed = 0.0f;
+    bool dwell = false;
+    bool goHome = false;
+    f32 dwellSeconds = 0.0f;
+
+    const char* p = line.c_str();
+    while (*p) {
+        const char letter = *p++;
+        if (!std::isalpha(static_cast<unsigned char>(letter)))
+            return error(1); // Expected command letter
+        char* end = nullptr;
+        const auto value = static_cast<f32>(std::strtod(p, &end));
+        if (end == p)
+            return error(2); // Bad number format
+        p = end;
+
+        switch (letter) {
+        case 'G': {
+            const int code = static_cast<int>(std::lround(value * 10.0f));
+            switch (code) {
+            case 0: motion = 0; break;
+            case 10: case 20: case 30: motion = 1; break; // Arcs run as straight moves
+            case 40: dwell = true; break;
+            case 280: case 300: goHome = true; break;
+            case 200: inches = true; break;
+            case 210: inches = false; break;
+            case 900: absolute = true; break;
+            case 910: absolute = false; break;
+            default: break; // Planes, WCS, cutter comp etc. don't affect timing
+            }
+            break;
+        }
+        case 'X': hasAxis[0] = true; axis[0] = value; break;
+        case 'Y': hasAxis[1] = true; axis[1] = value; break;
+        case 'Z': hasAxis[2] = true; axis[2] = value; break;
+        case 'F': hasFeed = true; feed = value; break;
+        case 'P': dwellSeconds = value; break;
+        case 'M': case 'S': case 'T': case 'N': case 'I': case 'J': case 'K':
+        case 'R': case 'L': case 'H': case 'D': case 'Q': case 'A': case 'B': case 'C':
+            break;
+        default:
+            return error(20); // Unsupported command
+        }
+    }
+
+    const f32 scale = inches ? kMmPerInch : 1.0f;
+    const f32 feedRate = hasFeed ? feed * scale : (jog ? 0.0f : m_feedRate);
+    const bool move = goHome || hasAxis[0] || hasAxis[1] || hasAxis[2];
+    const bool rapid = !jog && motion == 0;
+
+    if ((move && (jog || motion != 0) && feedRate <= 0.0f))
+        return error(22); // Feed rate undefined
+    if ((move || (dwell && dwellSeconds > 0.0f)) && m_planner.size() >= m_config.plannerBlocks)
+        return false;
+
+    Vec3 target = m_plannedPos;
+    if (goHome) {
+        target = Vec3{0.0f};
+    } else {
+        for (int i = 0; i < 3; ++i) {
+            if (hasAxis[i])
+                target[i] = absolute ? axis[i] * scale : target[i] + axis[i] * scale;
+        }
+    }
+
+    if (!jog) {
+        m_motion = motion;
+        m_absolute = absolute;
+        m_inches = inches;
+        m_feedRate = feedRate;
+    }
+    if (dwell && dwellSeconds > 0.0f)
+        queueDwell(dwellSeconds);
+    else if (move)
+        queueMove(target, feedRate, rapid);
+
+    reply("ok");
+    ++m_stats.okCount;
+    return true;
+}
+
+void GrblEmulator::softReset() {
+    // Motion stops where it is; modal state returns to power-on defaults
+    m_planner.clear();
+    m_plannedPos = m_position;
+    m_progress = 0.0f;
+    m_speed = 0.0f;
+    m_emptySince = -1.0;
+    m_rx.clear();
+    m_tx.clear();
+    m_hold = false;
+    m_absolute = true;
+    m_inches = false;
+    m_motion = 0;
+    m_feedRate = 0.0f;
+    m_feedOverride = 100;
+    m_rapidOverride = 100;
+    reply("");
+    reply("Grbl 1.1h ['$' for help]");
+}
+
+void GrblEmulator::reply(const std::string& text) {
+    m_tx += text;
+    m_tx += "\r\n";
+}
+
+std::string GrblEmulator::statusReport() const {
+    const char* state = "Idle";
+    if (m_hold)
+        state = m_speed > 0.0f ? "Hold:1" : "Hold:0";
+    else if (!m_planner.empty())
+        state = "Run";
+
+    char buf[160];
+    std::snprintf(buf, sizeof(buf), "<%s|MPos:%.3f,%.3f,%.3f|Bf:%zu,%zu|FS:%.0f,0>", state,
+                  static_cast<double>(m_position.x), static_cast<double>(m_position.y),
+                  static_cast<double>(m_position.z),
+                  m_config.plannerBlocks - std::min(m_planner.size(), m_config.plannerBlocks),
+                  m_config.rxBufferSize - std::min(m_rx.size(), m_config.rxBufferSize),
+                  static_cast<double>(m_speed * 60.0f));
+    return buf;
+}
+
+// --- Planner and motion ---
+
+void GrblEmulator::queueMove(const Vec3& target, f32 feedRate, bool rapid) {
+    const Vec3 delta = target - m_plannedPos;
+    const f32 length = std::sqrt(delta.x * delta.x + delta.y * delta.y + delta.z * delta.z);
+    if (length < 1e-6f)
+        return;
+
+    Block block;
+    block.start = m_plannedPos;
+    block.target = target;
+    block.unit = delta / length;
+    block.length = length;
+    block.rapid = rapid;
+
+    // Per-axis limits projected onto the move direction
+    f32 maxSpeed = std::numeric_limits<f32>::max();
+    f32 accel = std::numeric_limits<f32>::max();
+    for (int i = 0; i < 3; ++i) {
+        const f32 component = std::abs(block.unit[i]);
+        if (component < 1e-6f)
+            continue;
+        maxSpeed = std::min(maxSpeed, m_config.maxRate[i] / 60.0f / component);
+        accel = std::min(accel, m_config.acceleration[i] / component);
+    }
+    block.nominalSpeed = rapid ? maxSpeed : std::min(feedRate / 60.0f, maxSpeed);
+    block.acceleration = accel;
+
+    // Junction speed from GRBL's junction-deviation model; from rest when the
+    // planner is empty or the previous block is a dwell
+    if (!m_planner.empty() && m_planner.back().length > 0.0f) {
+        const Block& prev = m_planner.back();
+        const f32 cosTheta = -(prev.unit.x * block.unit.x + prev.unit.y * block.unit.y +
+                               prev.unit.z * block.unit.z);
+        f32 junction = 0.0f;
+        if (cosTheta < -kStraightCos) {
+            junction = std::numeric_limits<f32>::max();
+        } else if (cosTheta <= kStraightCos) {
+            const f32 sinHalf = std::sqrt(0.5f * (1.0f - cosTheta));
+            junction = std::sqrt(accel * m_config.junctionDeviation * sinHalf / (1.0f - sinHalf));
+        }
+        block.maxEntrySpeed = std::min({junction, block.nominalSpeed, prev.nominalSpeed});
+    }
+
+    m_planner.push_back(block);
+    m_plannedPos = target;
+    ++m_stats.blocksPlanned;
+
+    if (m_emptySince >= 0.0) {
+        m_stats.starvedSeconds += m_simTime - m_emptySince;
+        ++m_stats.starvations;
+        m_emptySince = -1.0;
+    }
+    planBlocks();
+}
+
+void GrblEmulator::queueDwell(f32 seconds) {
+    Block block;
+    block.start = m_plannedPos;
+    block.target = m_plannedPos;
+    block.dwell = seconds;
+    m_planner.push_back(block);
+    ++m_stats.blocksPlanned;
+}
+
+void GrblEmulator::planBlocks() {
+    const usize count = m_planner.size();
+    if (count < 2)
+        return;
+
+    // Reverse pass: every block must be able to stop by the end of the queue
+    for (usize i = count - 1; i >= 1; --i) {
+        Block& block = m_planner[i];
+        const f32 exit = exitSpeed(i);
+        block.entrySpeed = std::min(
+            block.maxEntrySpeed, std::sqrt(exit * exit + 2.0f * block.acceleration * block.length));
+    }
+
+    // Forward pass: no block may enter faster than the one before can reach
+    const Block& front = m_planner.front();
+    f32 reach = 0.0f;
+    if (front.length > 0.0f) {
+        const f32 remaining = std::max(0.0f, front.length - m_progress);
+        reach = std::sqrt(m_speed * m_speed + 2.0f * front.acceleration * remaining);
+    }
+    for (usize i = 1; i < count; ++i) {
+        Block& block = m_planner[i];
+        block.entrySpeed = std::min(block.entrySpeed, reach);
+        reach = std::sqrt(block.entrySpeed * block.entrySpeed +
+                          2.0f * block.acceleration * block.length);
+    }
+}
+
+f32 GrblEmulator::exitSpeed(usize index) const {
+    return index + 1 < m_planner.size() ? m_planner[index + 1].entrySpeed : 0.0f;
+}
+
+void GrblEmulator::advanceMotion(f64 seconds) {
+    f64 remaining = seconds;
+    while (remaining > 0.0) {
+        if (m_planner.empty()) {
+            m_simTime += remaining;
+            return;
+        }
+
+        Block& block = m_planner.front();
+        if (block.length <= 0.0f) {
+            // Dwell
+            const f64 t = std::min(remaining, static_cast<f64>(block.dwell - m_progress));
+            m_progress += static_cast<f32>(t);
+            m_simTime += t;
+            m_stats.motionSeconds += t;
+            remaining -= t;
+            if (m_progress >= block.dwell) {
+                m_planner.pop_front();
+                m_progress = 0.0f;
+                if (m_planner.empty())
+                    m_emptySince = m_simTime;
+            }
+            continue;
+        }
+
+        const f64 h = std::min(remaining, kMotionStep);
+        const auto hf = static_cast<f32>(h);
+        const f32 left = block.length - m_progress;
+        if (m_hold) {
+            m_speed = std::max(0.0f, m_speed - block.acceleration * hf);
+            if (m_speed <= 0.0f) {
+                // Stopped in a feed hold; time passes with the planner intact
+                m_simTime += remaining;
+                return;
+            }
+        } else {
+            const int override = block.rapid ? m_rapidOverride : m_feedOverride;
+            const f32 nominal = block.nominalSpeed * static_cast<f32>(override) / 100.0f;
+            const f32 exit = exitSpeed(0);
+            const f32 cap =
+                std::min(nominal, std::sqrt(exit * exit + 2.0f * block.acceleration * left));
+            m_speed = m_speed < cap ? std::min(cap, m_speed + block.acceleration * hf) : cap;
+        }
+
+        const f32 distance = m_speed * hf;
+        if (distance >= left) {
+            const f64 t = m_speed > 0.0f ? std::min(h, static_cast<f64>(left / m_speed)) : h;
+            m_position = block.target;
+            m_simTime += t;
+            m_stats.motionSeconds += t;
+            remaining -= t;
+            m_planner.pop_front();
+            m_progress = 0.0f;
+            if (m_planner.empty()) {
+                m_speed = 0.0f;
+                m_emptySince = m_simTime;
+            }
+            continue;
+        }
+
+        m_progress += distance;
+        m_position = block.start + block.unit * m_progress;
+        m_simTime += h;
+        m_stats.motionSeconds += h;
+        remaining -= h;
+    }
+}
+
+// ── POSIX transport ───────────────────────────────────────────────────
+
+#ifndef _WIN32
+
+std::string GrblEmulator::openPty() {
+    stop();
+
+    m_fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (m_fd < 0 || grantpt(m_fd) != 0 || unlockpt(m_fd) != 0) {
+        log::errorf("GrblEmu", "Failed to create pty: %s", strerror(errno));
+        stop();
+        return {};
+    }
+    const char* name = ptsname(m_fd);
+    std::string path = name ? name : "";
+
+    // Hold the slave open in raw mode so the link survives hosts reconnecting
+    m_slaveFd = path.empty() ? -1 : ::open(path.c_str(), O_RDWR | O_NOCTTY);
+    if (m_slaveFd < 0) {
+        log::errorf("GrblEmu", "Failed to open pty slave: %s", strerror(errno));
+        stop();
+        return {};
+    }
+    struct termios tty {};
+    if (tcgetattr(m_slaveFd, &tty) == 0) {
+        cfmakeraw(&tty);
+        tcsetattr(m_slaveFd, TCSANOW, &tty);
+    }
+    fcntl(m_fd, F_SETFL, fcntl(m_fd, F_GETFL) | O_NONBLOCK);
+
+    start();
+    log::infof("GrblEmu", "Serving on %s", path.c_str());
+    return path;
+}
+
+int GrblEmulator::listenTcp(int port) {
+    stop();
+
+    m_listenFd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (m_listenFd < 0) {
+        log::errorf("GrblEmu", "socket failed: %s", strerror(errno));
+        return 0;
+    }
+    int reuse = 1;
+    setsockopt(m_listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(static_cast<u16>(port));
+    socklen_t addrLen = sizeof(addr);
+    if (::bind(m_listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(m_listenFd, 1) != 0 ||
+        getsockname(m_listenFd, reinterpret_cast<sockaddr*>(&addr), &addrLen) != 0) {
+        log::errorf("GrblEmu", "Failed to listen on port %d: %s", port, strerror(errno));
+        stop();
+        return 0;
+    }
+    fcntl(m_listenFd, F_SETFL, fcntl(m_listenFd, F_GETFL) | O_NONBLOCK);
+
+    const int bound = ntohs(addr.sin_port);
+    start();
+    log::infof("GrblEmu", "Listening on 127.0.0.1:%d", bound);
+    return bound;
+}
+
+void GrblEmulator::stop() {
+    m_running = false;
+    if (m_thread.joinable())
+        m_thread.join();
+    for (int* fd : {&m_fd, &m_slaveFd, &m_listenFd}) {
+        if (*fd >= 0)
+            ::close(*fd);
+        *fd = -1;
+    }
+}
+
+void GrblEmulator::start() {
+    m_wire.clear();
+    m_rx.clear();
+    m_tx.clear();
+    m_rxCredit = 0.0;
+    m_txCredit = 0.0;
+    m_running = true;
+    m_thread = std::thread(&GrblEmulator::threadFunc, this);
+}
+
+bool GrblEmulator::pumpInput() {
+    char buf[4096];
+    while (true) {
+        const ssize_t n = ::read(m_fd, buf, sizeof(buf));
+        if (n > 0) {
+            m_wire.append(buf, static_cast<usize>(n));
+            continue;
+        }
+        if (n == 0)
+            return false; // Peer closed
+        return errno == EAGAIN || errno == EINTR;
+    }
+}
+
+void GrblEmulator::flushOutput(f64 seconds) {
+    if (m_tx.empty()) {
+        m_txCredit = 0.0;
+        return;
+    }
+    usize allowed = m_tx.size();
+    if (m_config.baudRate > 0) {
+        m_txCredit += seconds * m_config.baudRate / 10.0;
+        allowed = std::min(allowed, static_cast<usize>(m_txCredit));
+    }
+    if (allowed == 0)
+        return;
+
+    const ssize_t n = ::write(m_fd, m_tx.data(), allowed);
+    if (n > 0) {
+        m_tx.erase(0, static_cast<usize>(n));
+        if (m_config.baudRate > 0)
+            m_txCredit -= static_cast<f64>(n);
+    }
+}
+
+void GrblEmulator::threadFunc() {
+    auto last = std::chrono::steady_clock::now();
+
+    while (m_running) {
+        struct pollfd pfd {};
+        pfd.fd = m_fd >= 0 ? m_fd : m_listenFd;
+        pfd.events = POLLIN;
+        poll(&pfd, 1, 1);
+
+        const auto now = std::chrono::steady_clock::now();
+        const f64 dt = std::chrono::duration<f64>(now - last).count();
+        last = now;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // TCP: one client at a time; a new client gets a freshly reset controller
+        if (m_fd < 0 && m_listenFd >= 0) {
+            m_fd = ::accept(m_listenFd, nullptr, nullptr);
+            if (m_fd >= 0) {
+                fcntl(m_fd, F_SETFL, fcntl(m_fd, F_GETFL) | O_NONBLOCK);
+                int noDelay = 1;
+                setsockopt(m_fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+                m_wire.clear();
+                softReset();
+            }
+        }
+        if (m_fd < 0) {
+            advanceMotion(dt * static_cast<f64>(m_config.timeScale));
+            continue;
+        }
+        if (!pumpInput()) {
+            ::close(m_fd);
+            m_fd = -1;
+            continue;
+        }
+
+        // Bytes cross the wire at the baud rate; an idle line banks no credit
+        usize arrived = m_wire.size();
+        if (m_config.baudRate > 0) {
+            m_rxCredit += dt * m_config.baudRate / 10.0;
+            arrived = std::min(arrived, static_cast<usize>(m_rxCredit));
+            m_rxCredit -= static_cast<f64>(arrived);
+        }
+        for (usize i = 0; i < arrived; ++i)
+            receiveByte(static_cast<u8>(m_wire[i]));
+        m_wire.erase(0, arrived);
+        if (m_wire.empty())
+            m_rxCredit = std::min(m_rxCredit, 1.0);
+
+        advanceMotion(dt * static_cast<f64>(m_config.timeScale));
+        processLines();
+        flushOutput(dt);
+    }
+}
+
+#else // _WIN32
+
+std::string GrblEmulator::openPty() {
+    log::error("GrblEmu", "Pseudo-terminals are not available on Windows");
+    return {};
+}
+
+int GrblEmulator::listenTcp(int /*port*/) {
+    log::error("GrblEmu", "The GRBL emulator is not available on Windows");
+    return 0;
+}
+
+void GrblEmulator::stop() {
+    m_running = false;
+}
+
+void GrblEmulator::start() {}
+bool GrblEmulator::pumpInput() { return false; }
+void GrblEmulator::flushOutput(f64 /*seconds*/) {}
+void GrblEmulator::threadFunc() {}
+
+#endif // _WIN32
+
+} // namespace dw
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "../types.h"
+
+namespace dw {
+
+// Machine and link parameters for GrblEmulator. Defaults match a stock GRBL 1.1
+// board on a 115200 baud USB serial link.
+struct GrblEmulatorConfig {
+    int baudRate = 115200;     // Serial timing both ways, 10 bits per byte (0 = unthrottled)
+    usize rxBufferSize = 128;  // GRBL serial RX buffer (bytes)
+    usize plannerBlocks = 15;  // Usable planner blocks (GRBL: 16-slot ring, one kept free)
+    f32 timeScale = 1.0f;      // Motion runs this many times faster than real time
+    Vec3 maxRate{5000.0f, 5000.0f, 3000.0f};   // $110-$112 (mm/min)
+    Vec3 acceleration{500.0f, 500.0f, 200.0f}; // $120-$122 (mm/s^2)
+    f32 junctionDeviation = 0.01f;             // $11 (mm)
+};
+
+// Counters for benchmarking a host's streaming against the emulator
+struct GrblEmulatorStats {
+    u64 bytesReceived = 0;   // Bytes that reached the controller (including dropped)
+    u64 rxOverflowBytes = 0; // Dropped because the RX buffer was full
+    usize peakRxUsed = 0;    // Highest RX buffer fill (bytes)
+    u64 linesProcessed = 0;
+    u64 okCount = 0;
+    u64 errorCount = 0;
+    u64 blocksPlanned = 0;
+    f64 motionSeconds = 0.0;  // Emulated time spent executing planner blocks
+    f64 starvedSeconds = 0.0; // Emulated time the planner sat empty between motion blocks
+    u32 starvations = 0;      // Times the planner ran dry mid-job
+};
+
+// Standalone GRBL 1.1 emulator for hardware-free streaming tests.
+//
+// Serves a pseudo-terminal (open the returned path with SerialPort) or a TCP
+// port on 127.0.0.1 (connect with TcpSocket) from its own thread. Unlike
+// CncController's in-process simulator it models what limits a real stream:
+// bytes cross the link at the configured baud rate, land in a fixed-size RX
+// buffer (overflowing bytes are dropped and counted), and a line is only
+// consumed once the planner has a free block, so "ok" arrives late when the
+// planner is full. Planned moves run a trapezoidal profile with per-axis rate
+// and acceleration limits and GRBL's junction-deviation cornering, so a host
+// that cannot keep the planner fed shows up as starvation time.
+//
+// Real-time bytes ('?', '!', '~', 0x18, overrides) bypass the RX buffer as on
+// GRBL. G2/G3 arcs are planned as a straight move to their end point. POSIX only.
+class GrblEmulator {
+  public:
+    explicit GrblEmulator(const GrblEmulatorConfig& config = {});
+    ~GrblEmulator();
+
+    GrblEmulator(const GrblEmulator&) = delete;
+    GrblEmulator& operator=(const GrblEmulator&) = delete;
+
+    // Serve on a new pseudo-terminal; returns the device path to open, or an
+    // empty string on failure
+    std::string openPty();
+    // Serve one client at a time on 127.0.0.1:port (0 picks a free port);
+    // returns the bound port, or 0 on failure
+    int listenTcp(int port = 0);
+
+    void stop();
+    bool isRunning() const { return m_running.load(); }
+
+    GrblEmulatorStats stats() const;
+    void resetStats();
+    Vec3 position() const;
+    // Nothing buffered or moving
+    bool isIdle() const;
+
+  private:
+    struct Block {
+        Vec3 start{0.0f};
+        Vec3 target{0.0f};
+        Vec3 unit{0.0f};
+        f32 length = 0.0f;        // mm
+        f32 nominalSpeed = 0.0f;  // mm/s before overrides
+        f32 acceleration = 0.0f;  // mm/s^2 along the move
+        f32 maxEntrySpeed = 0.0f; // Junction limit (mm/s)
+        f32 entrySpeed = 0.0f;    // Planned (mm/s)
+        f32 dwell = 0.0f;         // G4 seconds; dwell blocks have no length
+        bool rapid = false;
+    };
+
+    void start();
+    void threadFunc();
+
+    // Link and protocol, all on the emulator thread
+    bool pumpInput();
+    void receiveByte(u8 byte);
+    void processLines();
+    bool executeLine(const std::string& line);
+    bool executeSystemCommand(const std::string& line);
+    bool executeGcode(const std::string& line, bool jog);
+    void softReset();
+    void reply(const std::string& text);
+    void flushOutput(f64 seconds);
+    std::string statusReport() const;
+
+    // Planner and motion
+    void queueMove(const Vec3& target, f32 feedRate, bool rapid);
+    void queueDwell(f32 seconds);
+    void planBlocks();
+    void advanceMotion(f64 seconds);
+    f32 exitSpeed(usize index) const;
+
+    GrblEmulatorConfig m_config;
+
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+    int m_fd = -1;       // Pty master or connected TCP client
+    int m_slaveFd = -1;  // Held open so the pty survives host reconnects
+    int m_listenFd = -1; // TCP listener
+
+    // Link: bytes the host wrote that are still crossing the wire, RX buffer,
+    // and replies waiting to go out; credits are bytes the baud rate allows
+    std::string m_wire;
+    std::string m_rx;
+    std::string m_tx;
+    f64 m_rxCredit = 0.0;
+    f64 m_txCredit = 0.0;
+
+    // Parser modal state
+    bool m_absolute = true;
+    bool m_inches = false;
+    int m_motion = 0; // 0 = G0, 1 = G1 (G2/G3 treated as G1)
+    f32 m_feedRate = 0.0f;
+    bool m_hold = false;
+    int m_feedOverride = 100;
+    int m_rapidOverride = 100;
+
+    // Planner (front block is executing) and the programmed end of the queue
+    std::deque<Block> m_planner;
+    Vec3 m_plannedPos{0.0f};
+    f32 m_progress = 0.0f; // mm into, or seconds of dwell spent in, the front block
+    f32 m_speed = 0.0f;    // mm/s
+
+    f64 m_simTime = 0.0;
+    f64 m_emptySince = -1.0; // Emulated time the planner last ran dry (-1 = idle)
+
+    mutable std::mutex m_mutex; // Held by the emulator thread while it works a tick
+    GrblEmulatorStats m_stats;
+    Vec3 m_position{0.0f};
+};
+
+} // namespace dw
@@ -0,0 +1,275 @@
+#include "job_telemetry.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+#include "../mesh/hash.h"
+#include "../utils/log.h"
+
+namespace dw {
+
+// ---- Binary .dwjt format ----
+//
+// Header: u32 magic, u32 version, i32 total lines, u64 hash of the lines.
+// Records: u8 tag, then LEB128 varints (signed values zigzag-encoded). Every
+// record starts with the microseconds since the previous record.
+//   Status: dt, u8 state, dx, dy, dz (µm, relative to the previous sample),
+//           feed (mm/min), u8 feed override, u8 rapid override
+//   Ack:    dt, line index relative to the previous ack + 1
+//   Error:  as Ack, then the error code
+
+static constexpr u32 DWJT_MAGIC   = 0x544A5744; // "DWJT"
+static constexpr u32 DWJT_VERSION = 2;
+
+static constexpr u8 kTagStatus = 1;
+static constexpr u8 kTagAck = 2;
+static constexpr u8 kTagError = 3;
+
+static constexpr usize kFlushBytes = 4096;
+
+namespace {
+
+class Reader {
+  public:
+    explicit Reader(const std::vector<u8>& data) : m_data(data) {}
+
+    bool atEnd() const { return m_pos >= m_data.size(); }
+
+    bool byte(u8& out) {
+        if (m_pos >= m_data.size())
+            return false;
+        out = m_data[m_pos++];
+        return true;
+    }
+
+    bool varint(u64& out) {
+        out = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            u8 b = 0;
+            if (!byte(b))
+                return false;
+            out |= static_cast<u64>(b & 0x7F) << shift;
+            if ((b & 0x80) == 0)
+                return true;
+        }
+        return false;
+    }
+
+    bool zigzag(i64& out) {
+        u64 v = 0;
+        if (!varint(v))
+            return false;
+        out = static_cast<i64>(v >> 1) ^ -static_cast<i64>(v & 1);
+        return true;
+    }
+
+  private:
+    const std::vector<u8>& m_data;
+    usize m_pos = 0;
+};
+
+} // namespace
+
+std::optional<JobTelemetry> JobTelemetry::load(const std::string& path) {
+    std::ifstream f(path, std::ios::binary);
+    if (!f.is_open())
+        return std::nullopt;
+
+    u32 magic = 0, version = 0;
+    i32 totalLines = 0;
+    u64 linesHash = 0;
+    f.read(reinterpret_cast<char*>(&magic), 4);
+    f.read(reinterpret_cast<char*>(&version), 4);
+    f.read(reinterpret_cast<char*>(&totalLines), 4);
+    f.read(reinterpret_cast<char*>(&linesHash), 8);
+    if (!f.good() || magic != DWJT_MAGIC || version != DWJT_VERSION)
+        return std::nullopt;
+
+    std::vector<u8> data{std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>()};
+
+    JobTelemetry telemetry;
+    telemetry.totalLines = totalLines;
+    telemetry.linesHash = linesHash;
+
+    Reader in(data);
+    u64 micros = 0;
+    i64 pos[3] = {0, 0, 0};
+    int lastAck = -1;
+    while (!in.atEnd()) {
+        u8 tag = 0;
+        u64 dt = 0;
+        if (!in.byte(tag) || !in.varint(dt))
+            break;
+        micros += dt;
+        const f64 time = static_cast<f64>(micros) * 1e-6;
+
+        if (tag == kTagStatus) {
+            u8 state = 0, feedOv = 0, rapidOv = 0;
+            i64 delta[3] = {0, 0, 0};
+            u64 feed = 0;
+            if (!in.byte(state) || !in.zigzag(delta[0]) || !in.zigzag(delta[1]) ||
+                !in.zigzag(delta[2]) || !in.varint(feed) || !in.byte(feedOv) || !in.byte(rapidOv))
+                break;
+            TelemetrySample sample;
+            sample.time = time;
+            sample.state = static_cast<MachineState>(state);
+            for (int axis = 0; axis < 3; ++axis) {
+                pos[axis] += delta[axis];
+                sample.workPos[axis] = static_cast<f32>(static_cast<f64>(pos[axis]) * 1e-3);
+            }
+            sample.feedRate = static_cast<f32>(feed);
+            sample.feedOverride = feedOv;
+            sample.rapidOverride = rapidOv;
+            telemetry.samples.push_back(sample);
+        } else if (tag == kTagAck || tag == kTagError) {
+            i64 step = 0;
+            u64 code = 0;
+            if (!in.zigzag(step) || (tag == kTagError && !in.varint(code)))
+                break;
+            TelemetryAck ack;
+            ack.time = time;
+            ack.lineIndex = lastAck + 1 + static_cast<int>(step);
+            ack.errorCode = static_cast<int>(code);
+            lastAck = ack.lineIndex;
+            telemetry.acks.push_back(ack);
+        } else {
+            log::warningf("Telemetry", "Unknown record tag %u in %s", tag, path.c_str());
+            break;
+        }
+    }
+    return telemetry;
+}
+
+u64 JobTelemetry::hashLines(const std::vector<std::string>& lines) {
+    hash::Hasher hasher;
+    for (const auto& line : lines) {
+        hasher.update(line.data(), line.size());
+        hasher.update("\n", 1);
+    }
+    return hasher.value();
+}
+
+// ---- Recorder ----
+
+JobTelemetryRecorder::~JobTelemetryRecorder() {
+    end();
+}
+
+bool JobTelemetryRecorder::begin(const std::string& path, int totalLines, u64 linesHash) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    closeLocked();
+
+    m_file.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_file.is_open()) {
+        log::errorf("Telemetry", "Failed to create %s", path.c_str());
+        return false;
+    }
+    const i32 lines = totalLines;
+    m_file.write(reinterpret_cast<const char*>(&DWJT_MAGIC), 4);
+    m_file.write(reinterpret_cast<const char*>(&DWJT_VERSION), 4);
+    m_file.write(reinterpret_cast<const char*>(&lines), 4);
+    m_file.write(reinterpret_cast<const char*>(&linesHash), 8);
+
+    m_buffer.clear();
+    m_buffer.reserve(kFlushBytes + 64);
+    m_start = std::chrono::steady_clock::now();
+    m_lastMicros = 0;
+    m_lastPos[0] = m_lastPos[1] = m_lastPos[2] = 0;
+    m_lastAck = -1;
+    m_endWhenIdle = false;
+    m_recording.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+void JobTelemetryRecorder::end() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    closeLocked();
+}
+
+void JobTelemetryRecorder::endWhenIdle() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_endWhenIdle = true;
+}
+
+void JobTelemetryRecorder::recordStatus(const MachineStatus& status) {
+    if (!m_recording.load(std::memory_order_relaxed))
+        return;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_file.is_open())
+        return;
+
+    m_buffer.push_back(kTagStatus);
+    putTime();
+    m_buffer.push_back(static_cast<u8>(status.state));
+    for (int axis = 0; axis < 3; ++axis) {
+        const auto micron = static_cast<i64>(std::llround(static_cast<f64>(status.workPos[axis]) * 1000.0));
+        putSigned(micron - m_lastPos[axis]);
+        m_lastPos[axis] = micron;
+    }
+    putVarint(static_cast<u64>(std::llround(std::max(0.0, static_cast<f64>(status.feedRate)))));
+    m_buffer.push_back(static_cast<u8>(std::clamp(status.feedOverride, 0, 255)));
+    m_buffer.push_back(static_cast<u8>(std::clamp(status.rapidOverride, 0, 255)));
+
+    if (m_endWhenIdle && status.state == MachineState::Idle)
+        closeLocked();
+    else if (m_buffer.size() >= kFlushBytes)
+        flushLocked();
+}
+
+void JobTelemetryRecorder::recordAck(int lineIndex, bool ok, int errorCode) {
+    if (!m_recording.load(std::memory_order_relaxed))
+        return;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_file.is_open())
+        return;
+
+    m_buffer.push_back(ok ? kTagAck : kTagError);
+    putTime();
+    putSigned(static_cast<i64>(lineIndex) - (m_lastAck + 1));
+    if (!ok)
+        putVarint(static_cast<u64>(std::max(errorCode, 0)));
+    m_lastAck = lineIndex;
+
+    if (m_buffer.size() >= kFlushBytes)
+        flushLocked();
+}
+
+void JobTelemetryRecorder::putVarint(u64 value) {
+    while (value >= 0x80) {
+        m_buffer.push_back(static_cast<u8>(value | 0x80));
+        value >>= 7;
+    }
+    m_buffer.push_back(static_cast<u8>(value));
+}
+
+void JobTelemetryRecorder::putSigned(i64 value) {
+    putVarint((static_cast<u64>(value) << 1) ^ static_cast<u64>(value >> 63));
+}
+
+void JobTelemetryRecorder::putTime() {
+    const auto elapsed = std::chrono::steady_clock::now() - m_start;
+    const auto micros =
+        static_cast<u64>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+    putVarint(micros - std::min(micros, m_lastMicros));
+    m_lastMicros = std::max(micros, m_lastMicros);
+}
+
+void JobTelemetryRecorder::flushLocked() {
+    if (m_buffer.empty())
+        return;
+    m_file.write(reinterpret_cast<const char*>(m_buffer.data()),
+                 static_cast<std::streamsize>(m_buffer.size()));
+    m_buffer.clear();
+}
+
+void JobTelemetryRecorder::closeLocked() {
+    m_recording.store(false, std::memory_order_relaxed);
+    if (!m_file.is_open())
+        return;
+    flushLocked();
+    m_file.close();
+    m_endWhenIdle = false;
+}
+
+} // namespace dw
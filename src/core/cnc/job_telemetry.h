@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "../types.h"
+#include "cnc_types.h"
+
+namespace dw {
+
+// Status report as recorded in a job telemetry log
+struct TelemetrySample {
+    f64 time = 0.0; // Seconds since recording began
+    MachineState state = MachineState::Unknown;
+    Vec3 workPos{0.0f}; // Program coordinates, 1 µm resolution
+    f32 feedRate = 0.0f;
+    int feedOverride = 100;
+    int rapidOverride = 100;
+};
+
+// "ok"/"error:N" for one streamed line
+struct TelemetryAck {
+    f64 time = 0.0;
+    int lineIndex = 0; // 0-based index into the streamed lines
+    int errorCode = 0; // 0 = ok
+};
+
+// A job telemetry log read back from disk
+struct JobTelemetry {
+    int totalLines = 0;
+    u64 linesHash = 0; // hashLines() of the streamed lines
+    std::vector<TelemetrySample> samples;
+    std::vector<TelemetryAck> acks;
+
+    // Read a .dwjt file; nullopt if missing or not a telemetry log. A log cut
+    // short by a crash keeps every complete record.
+    static std::optional<JobTelemetry> load(const std::string& path);
+
+    // Content hash of the lines a job streams, recorded so a log is only
+    // matched against the exact program that produced it
+    static u64 hashLines(const std::vector<std::string>& lines);
+};
+
+// Appends status samples and line acks for one streamed job to a compact
+// binary .dwjt log.
+//
+// Called from CncController's IO thread, so recording only encodes into a
+// memory buffer (a few bytes per ack, ~15 per status sample: varint time
+// deltas and µm position deltas) and writes it out every 4 KB. Calls while
+// not recording return after one atomic load.
+class JobTelemetryRecorder {
+  public:
+    JobTelemetryRecorder() = default;
+    ~JobTelemetryRecorder();
+
+    JobTelemetryRecorder(const JobTelemetryRecorder&) = delete;
+    JobTelemetryRecorder& operator=(const JobTelemetryRecorder&) = delete;
+
+    // Start a new log, replacing any file at `path`; ends a recording in progress
+    bool begin(const std::string& path, int totalLines, u64 linesHash);
+    // Flush and close now
+    void end();
+    // Keep recording until the machine reports Idle, so motion still queued
+    // in the planner after the last ack is captured, then close
+    void endWhenIdle();
+
+    bool isRecording() const { return m_recording.load(std::memory_order_relaxed); }
+
+    void recordStatus(const MachineStatus& status);
+    void recordAck(int lineIndex, bool ok, int errorCode);
+
+  private:
+    void putVarint(u64 value);
+    void putSigned(i64 value);
+    void putTime();
+    void flushLocked();
+    void closeLocked();
+
+    std::atomic<bool> m_recording{false};
+    std::mutex m_mutex;
+    std::ofstream m_file;
+    std::vector<u8> m_buffer;
+    std::chrono::steady_clock::time_point m_start;
+    u64 m_lastMicros = 0;
+    i64 m_lastPos[3] = {0, 0, 0};
+    int m_lastAck = -1;
+    bool m_endWhenIdle = false;
+};
+
+} // namespace dw
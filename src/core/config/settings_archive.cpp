@@ -27,7 +27,7 @@ namespace dw {
 
 namespace {
 
-// Binary archive format — same structure as ProjectArchive
+// Binary archive format — same structure as version 1 ProjectArchive
 constexpr uint32_t MAGIC = 0x44575300; // "DWS\0"
 constexpr uint32_t FORMAT_VERSION = 1;
 
@@ -5,6 +5,7 @@
 #include <sqlite3.h>
 
 #include "../utils/log.h"
+#include "../utils/trace.h"
 
 namespace dw {
 
@@ -61,6 +62,7 @@ bool Statement::step() {
 }
 
 bool Statement::execute() {
+    DW_TRACE_ZONE("DB statement");
     int result = sqlite3_step(m_stmt);
     return result == SQLITE_DONE;
 }
@@ -165,6 +167,7 @@ void Database::close() {
 }
 
 bool Database::execute(const std::string& sql) {
+    DW_TRACE_ZONE("DB execute");
     char* errMsg = nullptr;
     int result = sqlite3_exec(m_db, sql.c_str(), nullptr, nullptr, &errMsg);
 
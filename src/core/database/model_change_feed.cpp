@@ -0,0 +1,67 @@
+#include "model_change_feed.h"
+
+#include <unordered_map>
+
+namespace dw {
+
+ModelChangeFeed& ModelChangeFeed::instance() {
+    static ModelChangeFeed feed;
+    return feed;
+}
+
+u64 ModelChangeFeed::publish(ModelChangeKind kind, i64 modelId) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_changes.push_back({++m_version, kind, modelId});
+    while (m_changes.size() > m_capacity) {
+        m_changes.pop_front();
+    }
+    return m_version;
+}
+
+ModelChangeBatch ModelChangeFeed::changesSince(u64 version) const {
+    ModelChangeBatch batch;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    batch.latestVersion = m_version;
+    if (version >= m_version) {
+        return batch;
+    }
+
+    // The oldest retained change must directly follow the caller's version
+    if (m_changes.empty() || m_changes.front().version > version + 1) {
+        batch.overflowed = true;
+        return batch;
+    }
+
+    // Keep only the newest change per model; an Added followed by edits stays Added
+    std::unordered_map<i64, usize> slot;
+    for (const auto& change : m_changes) {
+        if (change.version <= version) {
+            continue;
+        }
+        if (change.kind == ModelChangeKind::CategoriesChanged) {
+            batch.changes.push_back(change);
+            continue;
+        }
+        auto it = slot.find(change.modelId);
+        if (it == slot.end()) {
+            slot[change.modelId] = batch.changes.size();
+            batch.changes.push_back(change);
+            continue;
+        }
+        ModelChange& prev = batch.changes[it->second];
+        ModelChangeKind kind = change.kind;
+        if (prev.kind == ModelChangeKind::Added && kind == ModelChangeKind::Updated) {
+            kind = ModelChangeKind::Added;
+        }
+        prev.version = change.version;
+        prev.kind = kind;
+    }
+    return batch;
+}
+
+u64 ModelChangeFeed::currentVersion() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_version;
+}
+
+} // namespace dw
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include "../types.h"
+
+namespace dw {
+
+// Kind of library mutation recorded in the change feed
+enum class ModelChangeKind {
+    Added,            // New model row
+    Updated,          // Row fields, tags or category membership changed
+    Removed,          // Row deleted
+    CategoriesChanged // Category tree changed (modelId is 0)
+};
+
+struct ModelChange {
+    u64 version = 0;
+    ModelChangeKind kind = ModelChangeKind::Updated;
+    i64 modelId = 0;
+};
+
+struct ModelChangeBatch {
+    std::vector<ModelChange> changes; // Coalesced: one entry per model (its latest change)
+    u64 latestVersion = 0;
+    bool overflowed = false; // Caller fell out of the retained window -> full reload
+};
+
+// Process-wide, versioned log of model table mutations.
+// ModelRepository publishes on every write (from any thread/connection); views poll
+// with the last version they saw and patch their rows instead of re-running findAll().
+// Only the most recent `capacity` changes are retained.
+class ModelChangeFeed {
+  public:
+    static ModelChangeFeed& instance();
+
+    explicit ModelChangeFeed(usize capacity = 4096) : m_capacity(capacity) {}
+
+    // Record a change; returns its version
+    u64 publish(ModelChangeKind kind, i64 modelId);
+
+    // Changes with version > `version`
+    ModelChangeBatch changesSince(u64 version) const;
+
+    u64 currentVersion() const;
+
+  private:
+    mutable std::mutex m_mutex;
+    std::deque<ModelChange> m_changes;
+    usize m_capacity;
+    u64 m_version = 0;
+};
+
+} // namespace dw
@@ -1,12 +1,26 @@
 #include "model_repository.h"
 
+#include <algorithm>
 #include <sstream>
 
 #include "../utils/log.h"
 #include "../utils/string_utils.h"
+#include "model_change_feed.h"
 
 namespace dw {
 
+namespace {
+
+// Publish only when the statement actually touched a row
+bool publishIfChanged(Database& db, ModelChangeKind kind, i64 modelId) {
+    if (db.changesCount() > 0) {
+        ModelChangeFeed::instance().publish(kind, modelId);
+    }
+    return true;
+}
+
+} // namespace
+
 ModelRepository::ModelRepository(Database& db) : m_db(db) {}
 
 std::optional<i64> ModelRepository::insert(const ModelRecord& model) {
@@ -66,7 +80,9 @@ std::optional<i64> ModelRepository::insert(const ModelRecord& model) {
         return std::nullopt;
     }
 
-    return m_db.lastInsertId();
+    i64 id = m_db.lastInsertId();
+    ModelChangeFeed::instance().publish(ModelChangeKind::Added, id);
+    return id;
 }
 
 std::optional<ModelRecord> ModelRepository::findById(i64 id) {
@@ -179,6 +195,148 @@ std::vector<ModelRecord> ModelRepository::findByTag(std::string_view tag) {
     return results;
 }
 
+ModelPage ModelRepository::findPage(const ModelPageQuery& query) {
+    ModelPage page;
+    std::vector<f64> ranks;
+    page.rows = querySummaries(query, std::nullopt, &ranks);
+    if (!page.rows.empty() && static_cast<int>(page.rows.size()) >= query.limit) {
+        const auto& last = page.rows.back();
+        page.next = ModelPageCursor{last.importedAt, ranks.back(), last.id};
+    }
+    return page;
+}
+
+std::optional<ModelSummary> ModelRepository::findSummary(i64 id, const ModelPageQuery& filter) {
+    auto rows = querySummaries(filter, id, nullptr);
+    if (rows.empty()) {
+        return std::nullopt;
+    }
+    return std::move(rows.front());
+}
+
+std::vector<ModelSummary> ModelRepository::querySummaries(const ModelPageQuery& query,
+                                                          std::optional<i64> onlyId,
+                                                          std::vector<f64>* ranks) {
+    std::vector<ModelSummary> results;
+
+    const bool search = !query.search.empty();
+    const bool fts = search && query.useFTS;
+    const bool byCategory = query.categoryId > 0;
+    const bool paged = !onlyId;
+    const int limit = std::max(1, query.limit);
+
+    // Inner select applies the filters; the outer one applies the keyset and order so
+    // the bm25() rank can be compared like a plain column.
+    std::string sql;
+    if (byCategory) {
+        sql += "WITH RECURSIVE subtree(id) AS ("
+               "  SELECT ? "
+               "  UNION ALL "
+               "  SELECT c.id FROM categories c "
+               "  INNER JOIN subtree s ON c.parent_id = s.id"
+               ") ";
+    }
+    sql += "SELECT * FROM (SELECT m.id, m.name, m.file_path, m.file_format, m.file_size, "
+           "m.vertex_count, m.triangle_count, m.thumbnail_path, m.imported_at, "
+           "m.descriptor_hover, ";
+    sql += fts ? "bm25(models_fts, 10.0, 3.0) AS rank " : "0.0 AS rank ";
+    sql += "FROM models m ";
+    if (fts) {
+        sql += "INNER JOIN models_fts ON models_fts.rowid = m.id WHERE models_fts MATCH ? ";
+    } else if (search) {
+        sql += "WHERE m.name LIKE ? ESCAPE '\\' ";
+    } else {
+        sql += "WHERE 1 = 1 ";
+    }
+    if (byCategory) {
+        sql += "AND m.id IN (SELECT mc.model_id FROM model_categories mc "
+               "INNER JOIN subtree st ON mc.category_id = st.id) ";
+    }
+    if (onlyId) {
+        sql += "AND m.id = ? ";
+    }
+    sql += ") ";
+
+    // NULL imported_at sorts last in DESC order, so it needs its own keyset branch
+    const ModelPageCursor* cursor = paged && query.after ? &*query.after : nullptr;
+    if (cursor) {
+        if (fts) {
+            sql += "WHERE rank > ? OR (rank = ? AND id < ?) ";
+        } else if (cursor->importedAt.empty()) {
+            sql += "WHERE imported_at IS NULL AND id < ? ";
+        } else {
+            sql += "WHERE imported_at < ? OR imported_at IS NULL "
+                   "OR (imported_at = ? AND id < ?) ";
+        }
+    }
+    sql += fts ? "ORDER BY rank ASC, id DESC " : "ORDER BY imported_at DESC, id DESC ";
+    if (paged) {
+        sql += "LIMIT ?";
+    }
+
+    auto stmt = m_db.prepare(sql);
+    if (!stmt.isValid()) {
+        return results;
+    }
+
+    int idx = 1;
+    bool ok = true;
+    if (byCategory) {
+        ok = ok && stmt.bindInt(idx++, query.categoryId);
+    }
+    if (fts) {
+        // Prefix wildcard for search-as-you-type, as in searchFTS()
+        std::string ftsQuery = query.search;
+        if (ftsQuery.back() != '*') {
+            ftsQuery += '*';
+        }
+        ok = ok && stmt.bindText(idx++, ftsQuery);
+    } else if (search) {
+        ok = ok && stmt.bindText(idx++, "%" + str::escapeLike(query.search) + "%");
+    }
+    if (onlyId) {
+        ok = ok && stmt.bindInt(idx++, *onlyId);
+    }
+    if (cursor) {
+        if (fts) {
+            ok = ok && stmt.bindDouble(idx++, cursor->rank) &&
+                 stmt.bindDouble(idx++, cursor->rank) && stmt.bindInt(idx++, cursor->id);
+        } else if (cursor->importedAt.empty()) {
+            ok = ok && stmt.bindInt(idx++, cursor->id);
+        } else {
+            ok = ok && stmt.bindText(idx++, cursor->importedAt) &&
+                 stmt.bindText(idx++, cursor->importedAt) && stmt.bindInt(idx++, cursor->id);
+        }
+    }
+    if (paged) {
+        ok = ok && stmt.bindInt(idx++, limit);
+    }
+    if (!ok) {
+        log::error("ModelRepo", "Failed to bind page query parameters");
+        return results;
+    }
+
+    while (stmt.step()) {
+        ModelSummary row;
+        row.id = stmt.getInt(0);
+        row.name = stmt.getText(1);
+        row.filePath = stmt.getText(2);
+        row.fileFormat = stmt.getText(3);
+        row.fileSize = static_cast<u64>(stmt.getInt(4));
+        row.vertexCount = static_cast<u32>(stmt.getInt(5));
+        row.triangleCount = static_cast<u32>(stmt.getInt(6));
+        row.thumbnailPath = stmt.getText(7);
+        row.importedAt = stmt.getText(8);
+        row.descriptorHover = stmt.getText(9);
+        if (ranks) {
+            ranks->push_back(stmt.getDouble(10));
+        }
+        results.push_back(std::move(row));
+    }
+
+    return results;
+}
+
 bool ModelRepository::update(const ModelRecord& model) {
     auto stmt = m_db.prepare(R"(
         UPDATE models SET
@@ -218,7 +376,7 @@ bool ModelRepository::update(const ModelRecord& model) {
         return false;
     }
 
-    return stmt.execute();
+    return stmt.execute() && publishIfChanged(m_db, ModelChangeKind::Updated, model.id);
 }
 
 bool ModelRepository::updateThumbnail(i64 id, const Path& thumbnailPath) {
@@ -231,7 +389,21 @@ bool ModelRepository::updateThumbnail(i64 id, const Path& thumbnailPath) {
         return false;
     }
 
-    return stmt.execute();
+    return stmt.execute() && publishIfChanged(m_db, ModelChangeKind::Updated, id);
+}
+
+bool ModelRepository::updateMaterial(i64 id, std::optional<i64> materialId) {
+    auto stmt = m_db.prepare("UPDATE models SET material_id = ? WHERE id = ?");
+    if (!stmt.isValid()) {
+        return false;
+    }
+
+    bool bound = materialId ? stmt.bindInt(1, *materialId) : stmt.bindNull(1);
+    if (!bound || !stmt.bindInt(2, id)) {
+        return false;
+    }
+
+    return stmt.execute() && publishIfChanged(m_db, ModelChangeKind::Updated, id);
 }
 
 bool ModelRepository::updateTags(i64 id, const std::vector<std::string>& tags) {
@@ -244,7 +416,7 @@ bool ModelRepository::updateTags(i64 id, const std::vector<std::string>& tags) {
         return false;
     }
 
-    return stmt.execute();
+    return stmt.execute() && publishIfChanged(m_db, ModelChangeKind::Updated, id);
 }
 
 bool ModelRepository::remove(i64 id) {
@@ -256,19 +428,16 @@ bool ModelRepository::remove(i64 id) {
     if (!stmt.bindInt(1, id)) {
         return false;
     }
-    return stmt.execute();
+    return stmt.execute() && publishIfChanged(m_db, ModelChangeKind::Removed, id);
 }
 
 bool ModelRepository::removeByHash(std::string_view hash) {
-    auto stmt = m_db.prepare("DELETE FROM models WHERE hash = ?");
-    if (!stmt.isValid()) {
-        return false;
-    }
-
-    if (!stmt.bindText(1, std::string(hash))) {
-        return false;
+    // Resolve the ID first so the change feed can report which row went away
+    auto existing = findByHash(hash);
+    if (!existing) {
+        return true;
     }
-    return stmt.execute();
+    return remove(existing->id);
 }
 
 bool ModelRepository::exists(std::string_view hash) {
@@ -329,7 +498,7 @@ bool ModelRepository::assignCategory(i64 modelId, i64 categoryId) {
         return false;
     if (!stmt.bindInt(1, modelId) || !stmt.bindInt(2, categoryId))
         return false;
-    return stmt.execute();
+    return stmt.execute() && publishIfChanged(m_db, ModelChangeKind::Updated, modelId);
 }
 
 bool ModelRepository::removeCategory(i64 modelId, i64 categoryId) {
@@ -338,7 +507,7 @@ bool ModelRepository::removeCategory(i64 modelId, i64 categoryId) {
         return false;
     if (!stmt.bindInt(1, modelId) || !stmt.bindInt(2, categoryId))
         return false;
-    return stmt.execute();
+    return stmt.execute() && publishIfChanged(m_db, ModelChangeKind::Updated, modelId);
 }
 
 std::vector<ModelRecord> ModelRepository::findByCategory(i64 categoryId) {
@@ -379,6 +548,7 @@ std::optional<i64> ModelRepository::createCategory(const std::string& name,
     }
     if (!stmt.execute())
         return std::nullopt;
+    ModelChangeFeed::instance().publish(ModelChangeKind::CategoriesChanged, 0);
     return m_db.lastInsertId();
 }
 
@@ -388,7 +558,7 @@ bool ModelRepository::deleteCategory(i64 categoryId) {
         return false;
     if (!stmt.bindInt(1, categoryId))
         return false;
-    return stmt.execute();
+    return stmt.execute() && publishIfChanged(m_db, ModelChangeKind::CategoriesChanged, 0);
 }
 
 std::vector<CategoryRecord> ModelRepository::getAllCategories() {
@@ -581,7 +751,7 @@ bool ModelRepository::updateDescriptor(i64 id,
         return false;
     }
 
-    return stmt.execute();
+    return stmt.execute() && publishIfChanged(m_db, ModelChangeKind::Updated, id);
 }
 
 bool ModelRepository::updateTagStatus(i64 id, int status) {
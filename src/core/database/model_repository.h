@@ -60,6 +60,41 @@ struct ModelRecord {
     int tagStatus = 0; // 0=untagged, 1=queued, 2=tagged, 3=failed
 };
 
+// Lightweight row projection for list views (no tags, bounds, orient or camera state)
+struct ModelSummary {
+    i64 id = 0;
+    std::string name;
+    Path filePath;
+    std::string fileFormat;
+    u64 fileSize = 0;
+    u32 vertexCount = 0;
+    u32 triangleCount = 0;
+    Path thumbnailPath;
+    std::string importedAt;
+    std::string descriptorHover;
+};
+
+// Keyset position of the last row of a page (rows strictly after it come next)
+struct ModelPageCursor {
+    std::string importedAt; // Browse order: imported_at DESC, id DESC
+    f64 rank = 0.0;         // Search order: bm25 ASC, id DESC
+    i64 id = 0;
+};
+
+// Filter + page request for the library list
+struct ModelPageQuery {
+    std::string search;  // Empty = browse everything
+    bool useFTS = true;  // FTS5 with BM25 ranking vs LIKE on name
+    i64 categoryId = -1; // > 0 = restrict to this category's subtree
+    std::optional<ModelPageCursor> after;
+    int limit = 200;
+};
+
+struct ModelPage {
+    std::vector<ModelSummary> rows;
+    std::optional<ModelPageCursor> next; // nullopt = last page
+};
+
 // Repository for model CRUD operations
 class ModelRepository {
   public:
@@ -76,6 +111,11 @@ class ModelRepository {
     std::vector<ModelRecord> findByFormat(std::string_view format);
     std::vector<ModelRecord> findByTag(std::string_view tag);
 
+    // Paged list queries (keyset pagination, summary columns only)
+    ModelPage findPage(const ModelPageQuery& query);
+    // Summary for one model if it passes the query's filters (cursor/limit ignored)
+    std::optional<ModelSummary> findSummary(i64 id, const ModelPageQuery& filter);
+
     // Update
     bool update(const ModelRecord& model);
     bool updateThumbnail(i64 id, const Path& thumbnailPath);
@@ -87,6 +127,8 @@ class ModelRepository {
                           const std::string& description,
                           const std::string& hover);
     bool updateTagStatus(i64 id, int status);
+    // Assign a material (nullopt clears it)
+    bool updateMaterial(i64 id, std::optional<i64> materialId);
 
     // Tag status queries
     std::optional<ModelRecord> findNextUntagged();
@@ -120,6 +162,9 @@ class ModelRepository {
 
   private:
     ModelRecord rowToModel(Statement& stmt);
+    std::vector<ModelSummary> querySummaries(const ModelPageQuery& query,
+                                             std::optional<i64> onlyId,
+                                             std::vector<f64>* ranks);
     std::string tagsToJson(const std::vector<std::string>& tags);
     std::vector<std::string> jsonToTags(const std::string& json);
     static std::string mat4ToJson(const Mat4& m);
@@ -363,6 +363,8 @@ void createIndexes(Database& db) {
     (void)db.execute("CREATE INDEX IF NOT EXISTS idx_models_hash ON models(hash)");
     (void)db.execute("CREATE INDEX IF NOT EXISTS idx_models_name ON models(name)");
     (void)db.execute("CREATE INDEX IF NOT EXISTS idx_models_format ON models(file_format)");
+    (void)db.execute(
+        "CREATE INDEX IF NOT EXISTS idx_models_imported ON models(imported_at, id)");
     (void)db.execute("CREATE INDEX IF NOT EXISTS idx_project_models_project ON "
                      "project_models(project_id)");
     (void)db.execute("CREATE INDEX IF NOT EXISTS idx_project_models_model ON "
@@ -770,6 +772,13 @@ bool Schema::migrate(Database& db, int fromVersion) {
         log::info("Schema", "v16: Added rate_categories table");
     }
 
+    if (fromVersion < 17) {
+        // Keyset pagination for the library list (ORDER BY imported_at DESC, id DESC)
+        (void)db.execute(
+            "CREATE INDEX IF NOT EXISTS idx_models_imported ON models(imported_at, id)");
+        log::info("Schema", "v17: Added imported_at index for paged library queries");
+    }
+
     if (!setVersion(db, CURRENT_VERSION)) {
         txn.rollback();
         return false;
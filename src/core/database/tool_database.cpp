@@ -413,6 +413,16 @@ std::optional<VtdbToolGeometry> ToolDatabase::findGeometryById(const std::string
     return g;
 }
 
+std::optional<VtdbToolGeometry> ToolDatabase::findGeometryByToolNumber(int toolNumber) {
+    auto stmt = m_db.prepare(
+        "SELECT te.tool_geometry_id FROM tool_entity te "
+        "JOIN tool_cutting_data cd ON cd.id = te.tool_cutting_data_id "
+        "WHERE cd.tool_number = ? LIMIT 1");
+    if (!stmt.isValid() || !stmt.bindInt(1, toolNumber) || !stmt.step())
+        return std::nullopt;
+    return findGeometryById(stmt.getText(0));
+}
+
 std::vector<VtdbToolGeometry> ToolDatabase::findAllGeometries() {
     std::vector<VtdbToolGeometry> result;
     auto stmt = m_db.prepare(
@@ -42,6 +42,8 @@ class ToolDatabase {
     // --- Tool Geometry CRUD ---
     bool insertGeometry(const VtdbToolGeometry& g);
     std::optional<VtdbToolGeometry> findGeometryById(const std::string& id);
+    // Geometry of the first tool entity whose cutting data has this T-number
+    std::optional<VtdbToolGeometry> findGeometryByToolNumber(int toolNumber);
     std::vector<VtdbToolGeometry> findAllGeometries();
     bool updateGeometry(const VtdbToolGeometry& g);
     bool removeGeometry(const std::string& id);
@@ -10,10 +10,11 @@
 #include "../project/project.h"
 #include "../utils/file_utils.h"
 #include "../utils/log.h"
+#include "zip_stream_writer.h"
 
 #include <chrono>
+#include <cstdio>
 #include <cstring>
-#include <miniz.h>
 #include <nlohmann/json.hpp>
 
 namespace dw {
@@ -45,9 +46,22 @@ static std::string getFileExtension(const Path& p) {
     return p.extension().string();
 }
 
+static f64 megabytesPerSecond(uint64_t bytes, std::chrono::steady_clock::time_point start) {
+    f64 seconds =
+        std::chrono::duration<f64>(std::chrono::steady_clock::now() - start).count();
+    return seconds > 0.0 ? static_cast<f64>(bytes) / (1024.0 * 1024.0) / seconds : 0.0;
+}
+
+static std::string formatRate(uint64_t bytes, std::chrono::steady_clock::time_point start) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.1f MB/s", megabytesPerSecond(bytes, start));
+    return buf;
+}
+
 // --- Construction ---
 
-ProjectExportManager::ProjectExportManager(Database& db) : m_db(db) {}
+ProjectExportManager::ProjectExportManager(Database& db, StorageManager* storageManager)
+    : m_db(db), m_storageManager(storageManager) {}
 
 // --- Helpers ---
 
@@ -95,9 +109,9 @@ DwprojExportResult ProjectExportManager::exportProject(const Project& project,
 
     MaterialRepository materialRepo(m_db);
 
-    // Initialize ZIP writer
-    mz_zip_archive zip{};
-    if (!mz_zip_writer_init_file(&zip, outputPath.string().c_str(), 0)) {
+    // Entries stream through in fixed blocks; large ones deflate in parallel
+    ZipStreamWriter zip;
+    if (!zip.open(outputPath)) {
         return DwprojExportResult::fail("Failed to create archive file: " + outputPath.string());
     }
 
@@ -105,10 +119,12 @@ DwprojExportResult ProjectExportManager::exportProject(const Project& project,
     uint64_t totalBytes = 0;
     int itemIndex = 0;
     int totalItems = static_cast<int>(models.size());
+    auto startTime = std::chrono::steady_clock::now();
+    std::unordered_map<std::string, std::string> hashToContentHash;
 
     for (const auto& model : models) {
-        auto blobData = file::readBinary(PathResolver::resolve(model.filePath, PathCategory::Support));
-        if (!blobData) {
+        Path blobPath = PathResolver::resolve(model.filePath, PathCategory::Support);
+        if (!file::exists(blobPath)) {
             log::warningf(kLogModule,
                           "Skipping model '%s': cannot read file '%s'",
                           model.name.c_str(),
@@ -120,21 +136,21 @@ DwprojExportResult ProjectExportManager::exportProject(const Project& project,
         std::string ext = getFileExtension(model.filePath);
         std::string archPath = "models/" + model.hash + ext;
 
-        if (!mz_zip_writer_add_mem(&zip,
-                                   archPath.c_str(),
-                                   blobData->data(),
-                                   blobData->size(),
-                                   MZ_DEFAULT_COMPRESSION)) {
-            mz_zip_writer_end(&zip);
-            (void)file::remove(outputPath);
+        ZipStreamWriter::EntryInfo info;
+        if (!zip.addFile(
+                archPath, blobPath, ZipStreamWriter::methodForExtension(ext), &info)) {
+            zip.discard();
             return DwprojExportResult::fail("Failed to add model blob: " + model.name);
         }
+        hashToContentHash[model.hash] = info.contentHash;
 
-        totalBytes += blobData->size();
+        totalBytes += info.uncompressedSize;
         itemIndex++;
 
         if (progress) {
-            progress(itemIndex, totalItems, model.name);
+            progress(itemIndex,
+                     totalItems,
+                     model.name + " (" + formatRate(totalBytes, startTime) + ")");
         }
     }
 
@@ -144,16 +160,8 @@ DwprojExportResult ProjectExportManager::exportProject(const Project& project,
         if (model.thumbnailPath.empty() || !file::exists(model.thumbnailPath)) {
             continue;
         }
-        auto thumbData = file::readBinary(model.thumbnailPath);
-        if (!thumbData) {
-            continue;
-        }
         std::string thumbArchPath = "thumbnails/" + model.hash + ".png";
-        if (!mz_zip_writer_add_mem(&zip,
-                                   thumbArchPath.c_str(),
-                                   thumbData->data(),
-                                   thumbData->size(),
-                                   MZ_DEFAULT_COMPRESSION)) {
+        if (!zip.addFile(thumbArchPath, model.thumbnailPath, ZipStreamWriter::Method::Store)) {
             log::warningf(kLogModule, "Failed to add thumbnail for model '%s'", model.name.c_str());
             continue;
         }
@@ -179,17 +187,9 @@ DwprojExportResult ProjectExportManager::exportProject(const Project& project,
             continue;
         }
 
-        auto matData = file::readBinary(matRec->archivePath);
-        if (!matData) {
-            continue;
-        }
-
+        // .dwmat is itself a ZIP: stored, not recompressed
         std::string matArchPath = "materials/" + std::to_string(*matId) + ".dwmat";
-        if (!mz_zip_writer_add_mem(&zip,
-                                   matArchPath.c_str(),
-                                   matData->data(),
-                                   matData->size(),
-                                   MZ_DEFAULT_COMPRESSION)) {
+        if (!zip.addFile(matArchPath, matRec->archivePath, ZipStreamWriter::Method::Store)) {
             log::warningf(kLogModule,
                           "Failed to add material %lld for model '%s'",
                           static_cast<long long>(*matId),
@@ -207,26 +207,24 @@ DwprojExportResult ProjectExportManager::exportProject(const Project& project,
         Path resolvedGcPath = PathResolver::resolve(gc.filePath, PathCategory::GCode);
         std::string archivePath =
             "gcode/" + std::to_string(gc.id) + getFileExtension(resolvedGcPath);
-        auto fileData = file::readBinary(resolvedGcPath);
-        if (!fileData) {
+        if (!file::exists(resolvedGcPath)) {
             log::warningf(
                 kLogModule, "Skipping gcode '%s': cannot read file", gc.name.c_str());
             continue;
         }
-        if (!mz_zip_writer_add_mem(&zip,
-                                   archivePath.c_str(),
-                                   fileData->data(),
-                                   fileData->size(),
-                                   MZ_DEFAULT_COMPRESSION)) {
+        ZipStreamWriter::EntryInfo info;
+        if (!zip.addFile(archivePath, resolvedGcPath, ZipStreamWriter::Method::Deflate, &info)) {
             log::warningf(kLogModule, "Failed to add gcode '%s'", gc.name.c_str());
-            continue;
+            zip.discard();
+            return DwprojExportResult::fail("Failed to add gcode: " + gc.name);
         }
-        totalBytes += fileData->size();
+        totalBytes += info.uncompressedSize;
 
         ManifestGCode entry;
         entry.id = gc.id;
         entry.name = gc.name;
         entry.hash = gc.hash;
+        entry.contentHash = info.contentHash;
         entry.fileInArchive = archivePath;
         entry.estimatedTime = gc.estimatedTime;
         entry.toolNumbers = gc.toolNumbers;
@@ -239,11 +237,10 @@ DwprojExportResult ProjectExportManager::exportProject(const Project& project,
     bool hasCosts = !estimates.empty();
     if (hasCosts) {
         std::string costsJson = buildCostsJson(estimates);
-        if (!mz_zip_writer_add_mem(&zip,
-                                   "costs.json",
-                                   costsJson.data(),
-                                   costsJson.size(),
-                                   MZ_DEFAULT_COMPRESSION)) {
+        if (!zip.addMemory("costs.json",
+                           costsJson.data(),
+                           costsJson.size(),
+                           ZipStreamWriter::Method::Deflate)) {
             log::warningf(kLogModule, "Failed to add costs.json");
         }
     }
@@ -254,11 +251,10 @@ DwprojExportResult ProjectExportManager::exportProject(const Project& project,
     bool hasCutPlans = !cutPlans.empty();
     if (hasCutPlans) {
         std::string plansJson = buildCutPlansJson(cutPlans);
-        if (!mz_zip_writer_add_mem(&zip,
-                                   "cut_plans.json",
-                                   plansJson.data(),
-                                   plansJson.size(),
-                                   MZ_DEFAULT_COMPRESSION)) {
+        if (!zip.addMemory("cut_plans.json",
+                           plansJson.data(),
+                           plansJson.size(),
+                           ZipStreamWriter::Method::Deflate)) {
             log::warningf(kLogModule, "Failed to add cut_plans.json");
         }
     }
@@ -271,43 +267,43 @@ DwprojExportResult ProjectExportManager::exportProject(const Project& project,
                                                  models,
                                                  modelIdToMaterialId,
                                                  hashToThumbnailPath,
+                                                 hashToContentHash,
                                                  gcodeEntries,
                                                  projectNotes,
                                                  hasCosts,
                                                  hasCutPlans);
 
-    if (!mz_zip_writer_add_mem(&zip,
-                               "manifest.json",
-                               manifestJson.data(),
-                               manifestJson.size(),
-                               MZ_DEFAULT_COMPRESSION)) {
-        mz_zip_writer_end(&zip);
-        (void)file::remove(outputPath);
+    if (!zip.addMemory("manifest.json",
+                       manifestJson.data(),
+                       manifestJson.size(),
+                       ZipStreamWriter::Method::Deflate)) {
+        zip.discard();
         return DwprojExportResult::fail("Failed to write manifest to archive");
     }
 
     // Finalize archive
-    if (!mz_zip_writer_finalize_archive(&zip)) {
-        mz_zip_writer_end(&zip);
-        (void)file::remove(outputPath);
+    if (!zip.finalize()) {
+        zip.discard();
         return DwprojExportResult::fail("Failed to finalize archive");
     }
 
-    mz_zip_writer_end(&zip);
-
     int modelCount = static_cast<int>(models.size());
+    f64 rate = megabytesPerSecond(totalBytes, startTime);
     log::infof(kLogModule,
                "Exported project '%s' with %d models, %d gcode, %d costs, %d cut plans "
-               "(%llu bytes) to '%s'",
+               "(%llu bytes, %.1f MB/s) to '%s'",
                project.name().c_str(),
                modelCount,
                static_cast<int>(gcodeEntries.size()),
                static_cast<int>(estimates.size()),
                static_cast<int>(cutPlans.size()),
                static_cast<unsigned long long>(totalBytes),
+               rate,
                outputPath.string().c_str());
 
-    return DwprojExportResult::ok(modelCount, totalBytes);
+    auto result = DwprojExportResult::ok(modelCount, totalBytes);
+    result.megabytesPerSecond = rate;
+    return result;
 }
 
 // --- Manifest JSON ---
@@ -317,6 +313,7 @@ std::string ProjectExportManager::buildManifestJson(
     const std::vector<ModelRecord>& models,
     const std::unordered_map<i64, i64>& modelIdToMaterialId,
     const std::unordered_map<std::string, std::string>& hashToThumbnailPath,
+    const std::unordered_map<std::string, std::string>& hashToContentHash,
     const std::vector<ManifestGCode>& gcodeEntries,
     const std::string& projectNotes,
     bool hasCosts,
@@ -356,6 +353,12 @@ std::string ProjectExportManager::buildManifestJson(
             mj["material_in_archive"] = "";
         }
 
+        // Hash of the archived bytes, verified on import
+        auto contentIt = hashToContentHash.find(m.hash);
+        if (contentIt != hashToContentHash.end()) {
+            mj["content_hash"] = contentIt->second;
+        }
+
         // Thumbnail info
         auto thumbIt = hashToThumbnailPath.find(m.hash);
         if (thumbIt != hashToThumbnailPath.end()) {
@@ -375,6 +378,7 @@ std::string ProjectExportManager::buildManifestJson(
         gj["id"] = gc.id;
         gj["name"] = gc.name;
         gj["hash"] = gc.hash;
+        gj["content_hash"] = gc.contentHash;
         gj["file_in_archive"] = gc.fileInArchive;
         gj["estimated_time"] = gc.estimatedTime;
         gj["tool_numbers"] = gc.toolNumbers;
@@ -490,6 +494,7 @@ bool ProjectExportManager::parseManifest(const std::string& json,
             mm.hash = mj.value("hash", "");
             mm.originalFilename = mj.value("original_filename", "");
             mm.fileInArchive = mj.value("file_in_archive", "");
+            mm.contentHash = mj.value("content_hash", "");
             mm.fileFormat = mj.value("file_format", "stl");
             mm.vertexCount = mj.value("vertex_count", static_cast<u32>(0));
             mm.triangleCount = mj.value("triangle_count", static_cast<u32>(0));
@@ -535,6 +540,7 @@ bool ProjectExportManager::parseManifest(const std::string& json,
                 gc.id = gj.value("id", static_cast<i64>(0));
                 gc.name = gj.value("name", "");
                 gc.hash = gj.value("hash", "");
+                gc.contentHash = gj.value("content_hash", "");
                 gc.fileInArchive = gj.value("file_in_archive", "");
                 gc.estimatedTime = gj.value("estimated_time", 0.0f);
                 if (gj.contains("tool_numbers") && gj["tool_numbers"].is_array()) {
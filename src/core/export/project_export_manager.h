@@ -20,6 +20,7 @@ namespace dw {
 // Forward declarations
 class Database;
 class Project;
+class StorageManager;
 
 // Result of export/import operations
 struct DwprojExportResult {
@@ -28,26 +29,34 @@ struct DwprojExportResult {
     int modelCount = 0;
     uint64_t totalBytes = 0;
     std::optional<i64> importedProjectId; // Set on successful import, nullopt on export or failure
+    f64 megabytesPerSecond = 0.0;         // Blob throughput of the whole operation
 
     static DwprojExportResult ok(int models = 0, uint64_t bytes = 0) {
-        return {true, "", models, bytes, std::nullopt};
+        return {true, "", models, bytes, std::nullopt, 0.0};
     }
 
     static DwprojExportResult fail(const std::string& err) {
-        return {false, err, 0, 0, std::nullopt};
+        return {false, err, 0, 0, std::nullopt, 0.0};
     }
 };
 
-// Progress callback: (current, total, currentItemName)
+// Progress callback: (current, total, currentItemName). Model items carry the
+// running throughput, e.g. "Bracket (182.4 MB/s)".
 using ExportProgressCallback = std::function<void(int, int, const std::string&)>;
 
 // Manages exporting/importing projects as .dwproj ZIP archives.
 // A .dwproj archive contains:
 //   - manifest.json  (project metadata + model list)
 //   - models/<hash>.<ext>  (model blob files)
+//
+// Both directions stream entries in fixed-size blocks, so memory use does not
+// grow with model size. Export deflates large entries block-parallel and stores
+// already-compressed formats (3MF, PNG, .dwmat) as-is; import verifies each blob
+// against its manifest content hash and, given a StorageManager, writes it
+// straight into the CAS blob store.
 class ProjectExportManager {
   public:
-    explicit ProjectExportManager(Database& db);
+    explicit ProjectExportManager(Database& db, StorageManager* storageManager = nullptr);
 
     // Export a project and its models to a .dwproj ZIP at outputPath
     DwprojExportResult exportProject(const Project& project,
@@ -65,6 +74,7 @@ class ProjectExportManager {
     struct ManifestModel {
         std::string name;
         std::string hash;
+        std::string contentHash; // hash::Hasher of the archived bytes (empty in old archives)
         std::string originalFilename;
         std::string fileInArchive;
         std::string fileFormat;
@@ -82,6 +92,7 @@ class ProjectExportManager {
         i64 id = 0;
         std::string name;
         std::string hash;
+        std::string contentHash;
         std::string fileInArchive; // "gcode/1.nc"
         f32 estimatedTime = 0.0f;
         std::vector<int> toolNumbers;
@@ -105,6 +116,7 @@ class ProjectExportManager {
         const std::vector<ModelRecord>& models,
         const std::unordered_map<i64, i64>& modelIdToMaterialId,
         const std::unordered_map<std::string, std::string>& hashToThumbnailPath,
+        const std::unordered_map<std::string, std::string>& hashToContentHash,
         const std::vector<ManifestGCode>& gcodeEntries,
         const std::string& projectNotes,
         bool hasCosts,
@@ -117,6 +129,7 @@ class ProjectExportManager {
     std::optional<i64> getModelMaterialId(i64 modelId);
 
     Database& m_db;
+    StorageManager* m_storageManager; // Optional, for CAS blob storage
 };
 
 } // namespace dw
@@ -7,11 +7,16 @@
 #include "../materials/material_archive.h"
 #include "../paths/app_paths.h"
 #include "../paths/path_resolver.h"
+#include "../mesh/hash.h"
 #include "../project/project.h"
+#include "../storage/storage_manager.h"
 #include "../utils/file_utils.h"
 #include "../utils/log.h"
 
+#include <chrono>
+#include <cstdio>
 #include <cstring>
+#include <fstream>
 #include <miniz.h>
 #include <nlohmann/json.hpp>
 
@@ -24,6 +29,80 @@ static bool containsPathTraversalImport(const std::string& path) {
     return path.find("..") != std::string::npos;
 }
 
+using EntrySink = std::function<bool(const void* data, usize size)>;
+
+// Decompress one entry block by block into `sink`; miniz checks the CRC at the end
+static bool streamEntry(mz_zip_archive& zip,
+                        const std::string& name,
+                        const EntrySink& sink,
+                        u64& bytes) {
+    struct Context {
+        const EntrySink* sink;
+        u64* bytes;
+    } ctx{&sink, &bytes};
+    bytes = 0;
+    auto callback = [](void* opaque, mz_uint64, const void* buf, size_t n) -> size_t {
+        auto* c = static_cast<Context*>(opaque);
+        if (!(*c->sink)(buf, n)) {
+            return 0;
+        }
+        *c->bytes += n;
+        return n;
+    };
+    return mz_zip_reader_extract_file_to_callback(&zip, name.c_str(), callback, &ctx, 0) != 0;
+}
+
+// Stream an entry to a plain file, checking it against the manifest content hash
+static bool streamEntryToFile(mz_zip_archive& zip,
+                              const std::string& name,
+                              const Path& dest,
+                              const std::string& expectedHash,
+                              u64& bytes,
+                              std::string& error) {
+    hash::Hasher hasher;
+    bool ok = false;
+    {
+        std::ofstream out(dest, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            error = "cannot write " + dest.string();
+            return false;
+        }
+        ok = streamEntry(
+            zip,
+            name,
+            [&out, &hasher](const void* data, usize size) {
+                hasher.update(data, size);
+                out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+                return static_cast<bool>(out);
+            },
+            bytes);
+        out.close();
+        ok = ok && !out.fail();
+    }
+    if (!ok) {
+        error = "failed to extract " + name;
+    } else if (!expectedHash.empty() && hasher.hex() != expectedHash) {
+        error = "content hash mismatch for " + name;
+        ok = false;
+    }
+    if (!ok) {
+        std::error_code ec;
+        fs::remove(dest, ec);
+    }
+    return ok;
+}
+
+static std::string formatImportRate(uint64_t bytes, std::chrono::steady_clock::time_point start) {
+    f64 seconds =
+        std::chrono::duration<f64>(std::chrono::steady_clock::now() - start).count();
+    char buf[32];
+    std::snprintf(buf,
+                  sizeof(buf),
+                  "%.1f MB/s",
+                  seconds > 0.0 ? static_cast<f64>(bytes) / (1024.0 * 1024.0) / seconds : 0.0);
+    return buf;
+}
+
 // --- Import ---
 
 DwprojExportResult ProjectExportManager::importProject(const Path& archivePath,
@@ -87,6 +166,7 @@ DwprojExportResult ProjectExportManager::importProject(const Path& archivePath,
     int current = 0;
     int importedCount = 0;
     uint64_t totalBytes = 0;
+    auto startTime = std::chrono::steady_clock::now();
 
     for (size_t i = 0; i < manifest.models.size(); i++) {
         const auto& mm = manifest.models[i];
@@ -103,17 +183,6 @@ DwprojExportResult ProjectExportManager::importProject(const Path& archivePath,
         bool alreadyExists = modelRepo.exists(mm.hash);
 
         if (!alreadyExists) {
-            // Extract blob from ZIP
-            size_t blobSize = 0;
-            void* blobData =
-                mz_zip_reader_extract_file_to_heap(&zip, mm.fileInArchive.c_str(), &blobSize, 0);
-            if (!blobData) {
-                log::warningf(kLogModuleImport,
-                              "Failed to extract model blob: %s",
-                              mm.fileInArchive.c_str());
-                continue;
-            }
-
             // Determine file extension from archive path
             Path archPath(mm.fileInArchive);
             std::string ext = archPath.extension().string();
@@ -121,24 +190,50 @@ DwprojExportResult ProjectExportManager::importProject(const Path& archivePath,
                 ext = "." + mm.fileFormat;
             }
 
-            // Write blob to models directory
-            Path destPath = modelsDir / (mm.hash + ext);
-            if (!file::writeBinary(destPath, blobData, blobSize)) {
-                mz_free(blobData);
+            // Stream the blob out of the ZIP without staging it in memory
+            u64 blobSize = 0;
+            Path storedPath;
+            std::string error;
+            if (m_storageManager) {
+                // CAS: keyed and verified by content hash
+                const std::string& key = mm.contentHash.empty() ? mm.hash : mm.contentHash;
+                Path blob = m_storageManager->storeStream(
+                    key,
+                    ext.substr(1),
+                    [&](const StorageManager::BlobSink& sink) {
+                        return streamEntry(zip, mm.fileInArchive, sink, blobSize);
+                    },
+                    error);
+                if (!blob.empty()) {
+                    std::error_code ec;
+                    auto onDisk = fs::file_size(blob, ec);
+                    if (blobSize == 0 && !ec) {
+                        blobSize = static_cast<u64>(onDisk); // Deduplicated: nothing streamed
+                    }
+                    storedPath = PathResolver::makeStorable(blob, PathCategory::Support);
+                }
+            } else {
+                Path destPath = modelsDir / (mm.hash + ext);
+                if (streamEntryToFile(
+                        zip, mm.fileInArchive, destPath, mm.contentHash, blobSize, error)) {
+                    storedPath = PathResolver::makeStorable(destPath, PathCategory::Models);
+                }
+            }
+            if (storedPath.empty()) {
                 log::warningf(kLogModuleImport,
-                              "Failed to write model blob to: %s",
-                              destPath.string().c_str());
+                              "Failed to import model blob %s: %s",
+                              mm.fileInArchive.c_str(),
+                              error.c_str());
                 continue;
             }
 
             totalBytes += blobSize;
-            mz_free(blobData);
 
             // Create model record
             ModelRecord rec;
             rec.hash = mm.hash;
             rec.name = mm.name;
-            rec.filePath = PathResolver::makeStorable(destPath, PathCategory::Models);
+            rec.filePath = storedPath;
             rec.fileFormat = mm.fileFormat;
             rec.fileSize = blobSize;
             rec.vertexCount = mm.vertexCount;
@@ -163,7 +258,7 @@ DwprojExportResult ProjectExportManager::importProject(const Path& archivePath,
         current++;
 
         if (progress) {
-            progress(current, total, mm.name);
+            progress(current, total, mm.name + " (" + formatImportRate(totalBytes, startTime) + ")");
         }
     }
 
@@ -257,10 +352,7 @@ DwprojExportResult ProjectExportManager::importProject(const Path& archivePath,
         }
 
         // Assign material to model
-        auto stmt = m_db.prepare("UPDATE models SET material_id = ? WHERE id = ?");
-        if (stmt.isValid() && stmt.bindInt(1, newMatId) && stmt.bindInt(2, imported->id)) {
-            (void)stmt.execute();
-        }
+        (void)modelRepo.updateMaterial(imported->id, newMatId);
     }
 
     // Phase C: Import G-code files
@@ -274,29 +366,19 @@ DwprojExportResult ProjectExportManager::importProject(const Path& archivePath,
             continue;
         }
 
-        // Extract file from ZIP
-        size_t fileSize = 0;
-        void* fileData =
-            mz_zip_reader_extract_file_to_heap(&zip, gc.fileInArchive.c_str(), &fileSize, 0);
-        if (!fileData) {
-            log::warningf(
-                kLogModuleImport, "Failed to extract gcode: %s", gc.fileInArchive.c_str());
-            current++;
-            continue;
-        }
-
-        // Write to gcode storage directory
+        // Stream to gcode storage directory
         Path archPath(gc.fileInArchive);
         std::string ext = archPath.extension().string();
         if (ext.empty()) ext = ".nc";
         Path outPath = gcodeDir / (gc.hash + ext);
-        if (!file::writeBinary(outPath, fileData, fileSize)) {
-            mz_free(fileData);
+        u64 fileSize = 0;
+        std::string error;
+        if (!streamEntryToFile(zip, gc.fileInArchive, outPath, gc.contentHash, fileSize, error)) {
+            log::warningf(kLogModuleImport, "Failed to import gcode: %s", error.c_str());
             current++;
             continue;
         }
         totalBytes += fileSize;
-        mz_free(fileData);
 
         // Check if gcode with this hash already exists (dedup)
         auto existing = gcodeRepo.findByHash(gc.hash);
@@ -368,6 +450,11 @@ DwprojExportResult ProjectExportManager::importProject(const Path& archivePath,
 
     auto result = DwprojExportResult::ok(importedCount, totalBytes);
     result.importedProjectId = *projectId;
+    f64 seconds =
+        std::chrono::duration<f64>(std::chrono::steady_clock::now() - startTime).count();
+    if (seconds > 0.0) {
+        result.megabytesPerSecond = static_cast<f64>(totalBytes) / (1024.0 * 1024.0) / seconds;
+    }
     return result;
 }
 
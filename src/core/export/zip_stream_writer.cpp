@@ -0,0 +1,411 @@
+// Digital Workshop - Streaming ZIP Writer
+// Block-parallel deflate with constant memory (see zip_stream_writer.h)
+
+#include "zip_stream_writer.h"
+
+#include "../mesh/hash.h"
+#include "../threading/parallel_for.h"
+#include "../utils/log.h"
+#include "../utils/string_utils.h"
+
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <miniz.h>
+
+namespace dw {
+
+namespace {
+
+constexpr const char* kLogModule = "ZipStream";
+
+constexpr u32 kLocalHeaderSig = 0x04034b50;
+constexpr u32 kCentralHeaderSig = 0x02014b50;
+constexpr u32 kEndOfCentralDirSig = 0x06054b50;
+constexpr u32 kZip64EndOfCentralDirSig = 0x06064b50;
+constexpr u32 kZip64LocatorSig = 0x07064b50;
+constexpr u16 kZip64ExtraId = 0x0001;
+constexpr u16 kVersionDefault = 20;
+constexpr u16 kVersionZip64 = 45;
+constexpr u16 kFlagUtf8 = 0x0800;
+constexpr u32 kMax32 = 0xFFFFFFFFu;
+constexpr u16 kMax16 = 0xFFFFu;
+
+// Entries whose size is known to approach 4 GiB get ZIP64 local headers up front;
+// the margin covers deflate's worst-case expansion of incompressible data
+constexpr u64 kZip64Threshold = 0xF0000000ull;
+
+void putU16(std::vector<u8>& out, u16 v) {
+    out.push_back(static_cast<u8>(v));
+    out.push_back(static_cast<u8>(v >> 8));
+}
+
+void putU32(std::vector<u8>& out, u32 v) {
+    for (int i = 0; i < 4; ++i)
+        out.push_back(static_cast<u8>(v >> (8 * i)));
+}
+
+void putU64(std::vector<u8>& out, u64 v) {
+    for (int i = 0; i < 8; ++i)
+        out.push_back(static_cast<u8>(v >> (8 * i)));
+}
+
+u32 clamp32(u64 v) {
+    return v >= kMax32 ? kMax32 : static_cast<u32>(v);
+}
+
+// One block as an independent raw deflate stream. Non-final blocks end with a
+// sync flush so the next block starts byte-aligned.
+bool deflateBlock(const u8* src, usize size, bool final, int level, std::vector<u8>& out) {
+    mz_stream stream{};
+    if (mz_deflateInit2(&stream, level, MZ_DEFLATED, -MZ_DEFAULT_WINDOW_BITS, 9,
+                        MZ_DEFAULT_STRATEGY) != MZ_OK) {
+        return false;
+    }
+    // Bound plus room for the sync-flush marker
+    out.resize(static_cast<usize>(mz_deflateBound(&stream, static_cast<mz_ulong>(size))) + 64);
+    stream.next_in = const_cast<u8*>(src);
+    stream.avail_in = static_cast<unsigned int>(size);
+    stream.next_out = out.data();
+    stream.avail_out = static_cast<unsigned int>(out.size());
+
+    int status = mz_deflate(&stream, final ? MZ_FINISH : MZ_SYNC_FLUSH);
+    bool ok = final ? status == MZ_STREAM_END : (status == MZ_OK && stream.avail_in == 0);
+    out.resize(static_cast<usize>(stream.total_out));
+    mz_deflateEnd(&stream);
+    return ok;
+}
+
+} // namespace
+
+ZipStreamWriter::~ZipStreamWriter() {
+    if (m_out.is_open())
+        m_out.close();
+}
+
+bool ZipStreamWriter::open(const Path& path) {
+    m_path = path;
+    m_offset = 0;
+    m_entries.clear();
+    m_error.clear();
+    m_out.open(path, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!m_out.is_open())
+        return fail("Cannot create archive: " + path.string());
+
+    // DOS timestamp shared by every entry
+    std::time_t now = std::time(nullptr);
+    std::tm local{};
+#ifdef _WIN32
+    localtime_s(&local, &now);
+#else
+    localtime_r(&now, &local);
+#endif
+    int year = std::max(local.tm_year + 1900, 1980);
+    m_dosTime = static_cast<u16>((local.tm_hour << 11) | (local.tm_min << 5) | (local.tm_sec / 2));
+    m_dosDate =
+        static_cast<u16>(((year - 1980) << 9) | ((local.tm_mon + 1) << 5) | local.tm_mday);
+    return true;
+}
+
+bool ZipStreamWriter::addFile(const std::string& name,
+                              const Path& source,
+                              Method method,
+                              EntryInfo* info) {
+    std::ifstream in(source, std::ios::binary);
+    if (!in)
+        return fail("Cannot read " + source.string());
+    std::error_code ec;
+    u64 size = static_cast<u64>(fs::file_size(source, ec));
+    if (ec)
+        size = 0;
+
+    bool readError = false;
+    auto read = [&in, &readError](u8* dst, usize capacity) -> usize {
+        if (!in)
+            return 0;
+        in.read(reinterpret_cast<char*>(dst), static_cast<std::streamsize>(capacity));
+        if (in.bad())
+            readError = true;
+        return static_cast<usize>(in.gcount());
+    };
+    if (!addStream(name, size, read, method, info))
+        return false;
+    if (readError)
+        return fail("Read error in " + source.string());
+    return true;
+}
+
+bool ZipStreamWriter::addMemory(const std::string& name,
+                                const void* data,
+                                usize size,
+                                Method method,
+                                EntryInfo* info) {
+    const u8* bytes = static_cast<const u8*>(data);
+    usize pos = 0;
+    auto read = [bytes, size, &pos](u8* dst, usize capacity) -> usize {
+        usize n = std::min(capacity, size - pos);
+        if (n > 0)
+            std::memcpy(dst, bytes + pos, n);
+        pos += n;
+        return n;
+    };
+    return addStream(name, size, read, method, info);
+}
+
+bool ZipStreamWriter::addStream(const std::string& name,
+                                u64 sizeHint,
+                                const ReadFn& read,
+                                Method method,
+                                EntryInfo* info) {
+    if (!m_out.is_open())
+        return fail("Archive is not open");
+    if (name.size() > kMax16)
+        return fail("Entry name too long: " + name);
+
+    CentralEntry entry;
+    entry.name = name;
+    entry.method = method;
+    entry.localOffset = m_offset;
+    entry.zip64 = sizeHint >= kZip64Threshold;
+
+    // Local header; CRC and sizes are patched after the data
+    std::vector<u8> header;
+    putU32(header, kLocalHeaderSig);
+    putU16(header, entry.zip64 ? kVersionZip64 : kVersionDefault);
+    putU16(header, kFlagUtf8);
+    putU16(header, static_cast<u16>(method));
+    putU16(header, m_dosTime);
+    putU16(header, m_dosDate);
+    putU32(header, 0);
+    putU32(header, entry.zip64 ? kMax32 : 0);
+    putU32(header, entry.zip64 ? kMax32 : 0);
+    putU16(header, static_cast<u16>(name.size()));
+    putU16(header, static_cast<u16>(entry.zip64 ? 20 : 0));
+    header.insert(header.end(), name.begin(), name.end());
+    if (entry.zip64) {
+        putU16(header, kZip64ExtraId);
+        putU16(header, 16);
+        putU64(header, 0);
+        putU64(header, 0);
+    }
+    if (!write(header.data(), header.size()))
+        return false;
+
+    // Batches of blocks: read in order, deflate in parallel, write in order.
+    // Memory stays at two buffers per block in flight regardless of entry size.
+    const usize batchBlocks = method == Method::Deflate ? std::max<usize>(2, parallelThreadCount()) : 1;
+    std::vector<std::vector<u8>> input(batchBlocks);
+    std::vector<std::vector<u8>> output(batchBlocks);
+    std::vector<usize> inputSize(batchBlocks, 0);
+    std::vector<char> blockOk(batchBlocks, 1);
+
+    u32 crc = MZ_CRC32_INIT;
+    hash::Hasher hasher;
+    u64 uncompressed = 0;
+    u64 compressed = 0;
+    bool finished = false;
+    while (!finished) {
+        usize blocks = 0;
+        for (; blocks < batchBlocks; ++blocks) {
+            input[blocks].resize(kBlockSize);
+            usize got = 0;
+            while (got < kBlockSize) {
+                usize n = read(input[blocks].data() + got, kBlockSize - got);
+                if (n == 0)
+                    break;
+                got += n;
+            }
+            inputSize[blocks] = got;
+            if (got < kBlockSize) {
+                finished = true;
+                ++blocks;
+                break;
+            }
+        }
+
+        for (usize b = 0; b < blocks; ++b) {
+            crc = static_cast<u32>(mz_crc32(crc, input[b].data(), inputSize[b]));
+            hasher.update(input[b].data(), inputSize[b]);
+            uncompressed += inputSize[b];
+        }
+
+        if (method == Method::Store) {
+            for (usize b = 0; b < blocks; ++b) {
+                if (!write(input[b].data(), inputSize[b]))
+                    return false;
+                compressed += inputSize[b];
+            }
+            continue;
+        }
+
+        // The short (possibly empty) block that ends the entry carries BFINAL
+        parallelFor(blocks, 1, [&](usize begin, usize end) {
+            for (usize b = begin; b < end; ++b) {
+                bool final = finished && b + 1 == blocks;
+                blockOk[b] = deflateBlock(input[b].data(), inputSize[b], final, m_level, output[b])
+                                 ? 1
+                                 : 0;
+            }
+        });
+        for (usize b = 0; b < blocks; ++b) {
+            if (!blockOk[b])
+                return fail("Deflate failed for " + name);
+            if (!write(output[b].data(), output[b].size()))
+                return false;
+            compressed += output[b].size();
+        }
+    }
+
+    if (!entry.zip64 && (uncompressed >= kMax32 || compressed >= kMax32))
+        return fail("Entry grew past 4 GiB without a ZIP64 header: " + name);
+
+    // Patch CRC and sizes into the local header
+    std::vector<u8> patch;
+    putU32(patch, crc);
+    if (!entry.zip64) {
+        putU32(patch, static_cast<u32>(compressed));
+        putU32(patch, static_cast<u32>(uncompressed));
+    }
+    m_out.seekp(static_cast<std::streamoff>(entry.localOffset + 14));
+    m_out.write(reinterpret_cast<const char*>(patch.data()), static_cast<std::streamsize>(patch.size()));
+    if (entry.zip64) {
+        patch.clear();
+        putU64(patch, uncompressed);
+        putU64(patch, compressed);
+        m_out.seekp(static_cast<std::streamoff>(entry.localOffset + 30 + name.size() + 4));
+        m_out.write(reinterpret_cast<const char*>(patch.data()),
+                    static_cast<std::streamsize>(patch.size()));
+    }
+    m_out.seekp(static_cast<std::streamoff>(m_offset));
+    if (!m_out)
+        return fail("Failed to update header for " + name);
+
+    entry.crc32 = crc;
+    entry.compressedSize = compressed;
+    entry.uncompressedSize = uncompressed;
+    m_entries.push_back(entry);
+
+    if (info) {
+        info->uncompressedSize = uncompressed;
+        info->compressedSize = compressed;
+        info->crc32 = crc;
+        info->contentHash = hasher.hex();
+    }
+    return true;
+}
+
+bool ZipStreamWriter::finalize() {
+    if (!m_out.is_open())
+        return fail("Archive is not open");
+
+    const u64 centralOffset = m_offset;
+    std::vector<u8> record;
+    for (const auto& entry : m_entries) {
+        bool zip64 = entry.zip64 || entry.uncompressedSize >= kMax32 ||
+                     entry.compressedSize >= kMax32 || entry.localOffset >= kMax32;
+        record.clear();
+        putU32(record, kCentralHeaderSig);
+        putU16(record, kVersionZip64);
+        putU16(record, zip64 ? kVersionZip64 : kVersionDefault);
+        putU16(record, kFlagUtf8);
+        putU16(record, static_cast<u16>(entry.method));
+        putU16(record, m_dosTime);
+        putU16(record, m_dosDate);
+        putU32(record, entry.crc32);
+        putU32(record, zip64 ? kMax32 : static_cast<u32>(entry.compressedSize));
+        putU32(record, zip64 ? kMax32 : static_cast<u32>(entry.uncompressedSize));
+        putU16(record, static_cast<u16>(entry.name.size()));
+        putU16(record, static_cast<u16>(zip64 ? 28 : 0));
+        putU16(record, 0); // Comment
+        putU16(record, 0); // Disk
+        putU16(record, 0); // Internal attributes
+        putU32(record, 0); // External attributes
+        putU32(record, zip64 ? kMax32 : static_cast<u32>(entry.localOffset));
+        record.insert(record.end(), entry.name.begin(), entry.name.end());
+        if (zip64) {
+            putU16(record, kZip64ExtraId);
+            putU16(record, 24);
+            putU64(record, entry.uncompressedSize);
+            putU64(record, entry.compressedSize);
+            putU64(record, entry.localOffset);
+        }
+        if (!write(record.data(), record.size()))
+            return false;
+    }
+    const u64 centralSize = m_offset - centralOffset;
+    const u64 count = m_entries.size();
+
+    record.clear();
+    if (count >= kMax16 || centralOffset >= kMax32 || centralSize >= kMax32) {
+        const u64 zip64EndOffset = m_offset;
+        putU32(record, kZip64EndOfCentralDirSig);
+        putU64(record, 44);
+        putU16(record, kVersionZip64);
+        putU16(record, kVersionZip64);
+        putU32(record, 0);
+        putU32(record, 0);
+        putU64(record, count);
+        putU64(record, count);
+        putU64(record, centralSize);
+        putU64(record, centralOffset);
+
+        putU32(record, kZip64LocatorSig);
+        putU32(record, 0);
+        putU64(record, zip64EndOffset);
+        putU32(record, 1);
+    }
+    putU32(record, kEndOfCentralDirSig);
+    putU16(record, 0);
+    putU16(record, 0);
+    putU16(record, static_cast<u16>(std::min<u64>(count, kMax16)));
+    putU16(record, static_cast<u16>(std::min<u64>(count, kMax16)));
+    putU32(record, clamp32(centralSize));
+    putU32(record, clamp32(centralOffset));
+    putU16(record, 0);
+    if (!write(record.data(), record.size()))
+        return false;
+
+    m_out.close();
+    if (m_out.fail())
+        return fail("Failed to close archive: " + m_path.string());
+    return true;
+}
+
+void ZipStreamWriter::discard() {
+    if (m_out.is_open())
+        m_out.close();
+    std::error_code ec;
+    if (!m_path.empty())
+        fs::remove(m_path, ec);
+}
+
+bool ZipStreamWriter::isPrecompressed(const std::string& extension) {
+    static const char* const kCompressed[] = {
+        ".3mf", ".zip", ".png", ".jpg", ".jpeg", ".webp", ".gz", ".7z", ".dwmat", ".dwproj"};
+    std::string ext = str::toLower(extension);
+    for (const char* candidate : kCompressed) {
+        if (ext == candidate)
+            return true;
+    }
+    return false;
+}
+
+ZipStreamWriter::Method ZipStreamWriter::methodForExtension(const std::string& extension) {
+    return isPrecompressed(extension) ? Method::Store : Method::Deflate;
+}
+
+bool ZipStreamWriter::write(const void* data, usize size) {
+    m_out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    if (!m_out)
+        return fail("Write failed: " + m_path.string());
+    m_offset += size;
+    return true;
+}
+
+bool ZipStreamWriter::fail(const std::string& error) {
+    m_error = error;
+    log::errorf(kLogModule, "%s", error.c_str());
+    return false;
+}
+
+} // namespace dw
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "../types.h"
+
+namespace dw {
+
+// Streaming ZIP writer for large archives.
+//
+// Unlike mz_zip_writer_add_mem, entries are read and written in fixed-size
+// blocks, so peak memory does not depend on entry size. Deflated entries are
+// compressed block-parallel: each block is an independent raw deflate stream
+// ended by a sync flush, and their concatenation is one valid deflate stream
+// (the pigz scheme; the ratio loss at 1 MiB blocks is negligible). Local
+// headers are patched in place once an entry's CRC and sizes are known, and
+// ZIP64 records are written when sizes or offsets pass 4 GiB.
+class ZipStreamWriter {
+  public:
+    enum class Method : u16 { Store = 0, Deflate = 8 };
+
+    struct EntryInfo {
+        u64 uncompressedSize = 0;
+        u64 compressedSize = 0;
+        u32 crc32 = 0;
+        std::string contentHash; // hash::Hasher over the uncompressed bytes
+    };
+
+    static constexpr usize kBlockSize = 1u << 20;
+
+    ZipStreamWriter() = default;
+    ~ZipStreamWriter();
+    ZipStreamWriter(const ZipStreamWriter&) = delete;
+    ZipStreamWriter& operator=(const ZipStreamWriter&) = delete;
+
+    bool open(const Path& path);
+
+    // Stream a file from disk into the archive
+    bool addFile(const std::string& name,
+                 const Path& source,
+                 Method method,
+                 EntryInfo* info = nullptr);
+
+    bool addMemory(const std::string& name,
+                   const void* data,
+                   usize size,
+                   Method method,
+                   EntryInfo* info = nullptr);
+
+    // Write the central directory and close the file
+    bool finalize();
+
+    // Close and delete a partially written archive
+    void discard();
+
+    void setCompressionLevel(int level) { m_level = level; }
+    const std::string& lastError() const { return m_error; }
+    u64 bytesWritten() const { return m_offset; }
+
+    // Already-compressed formats gain nothing from deflate
+    static bool isPrecompressed(const std::string& extension);
+    static Method methodForExtension(const std::string& extension);
+
+  private:
+    // Pulls up to `capacity` bytes into `dst`; returns the count, 0 at the end
+    using ReadFn = std::function<usize(u8* dst, usize capacity)>;
+
+    struct CentralEntry {
+        std::string name;
+        Method method = Method::Store;
+        u32 crc32 = 0;
+        u64 compressedSize = 0;
+        u64 uncompressedSize = 0;
+        u64 localOffset = 0;
+        bool zip64 = false;
+    };
+
+    bool addStream(const std::string& name,
+                   u64 sizeHint,
+                   const ReadFn& read,
+                   Method method,
+                   EntryInfo* info);
+    bool write(const void* data, usize size);
+    bool fail(const std::string& error);
+
+    std::fstream m_out;
+    Path m_path;
+    u64 m_offset = 0;
+    std::vector<CentralEntry> m_entries;
+    int m_level = 6;
+    u16 m_dosTime = 0;
+    u16 m_dosDate = 0;
+    std::string m_error;
+};
+
+} // namespace dw
@@ -0,0 +1,270 @@
+#include "gcode_calibration.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "gcode_analyzer.h"
+#include "gcode_parser.h"
+
+namespace dw {
+namespace gcode {
+
+namespace {
+
+constexpr usize kSearchWindow = 512; // Segments ahead of the last match to search
+constexpr f32 kOnPathTolerance = 1.0f; // mm; farther samples are off the program path
+constexpr f32 kTieTolerance = 1e-3f;   // mm; prefer the earlier segment within this
+constexpr usize kMinIntervals = 2;
+
+// A point along the toolpath
+struct PathPos {
+    usize segment = 0;
+    f32 fraction = 0.0f;
+};
+
+// Time between two located samples that can be compared with an estimate
+struct Interval {
+    PathPos from;
+    PathPos to;
+    f64 fromDistance = 0.0; // Along the path (mm)
+    f64 toDistance = 0.0;
+    f64 startTime = 0.0;
+    f64 seconds = 0.0;
+};
+
+struct Located {
+    bool onPath = false;
+    PathPos pos;
+    f64 distance = 0.0; // Along the path (mm)
+};
+
+// Closest point on a segment: returns squared distance and the fraction along it
+f32 closestOnSegment(const PathSegment& seg, const Vec3& p, f32& fraction) {
+    const Vec3 d = seg.end - seg.start;
+    const f32 len2 = d.x * d.x + d.y * d.y + d.z * d.z;
+    fraction = 0.0f;
+    if (len2 > 1e-12f) {
+        const Vec3 rel = p - seg.start;
+        fraction = std::clamp((rel.x * d.x + rel.y * d.y + rel.z * d.z) / len2, 0.0f, 1.0f);
+    }
+    const Vec3 diff = seg.start + d * fraction - p;
+    return diff.x * diff.x + diff.y * diff.y + diff.z * diff.z;
+}
+
+MachineProfile scaledProfile(const MachineProfile& profile, f32 accelScale, f32 rateScale) {
+    MachineProfile scaled = profile;
+    scaled.accelX *= accelScale;
+    scaled.accelY *= accelScale;
+    scaled.accelZ *= accelScale;
+    scaled.maxFeedRateX *= rateScale;
+    scaled.maxFeedRateY *= rateScale;
+    scaled.maxFeedRateZ *= rateScale;
+    scaled.rapidRate *= rateScale;
+    return scaled;
+}
+
+// Estimated seconds from the start of the program to each segment's start,
+// plus one entry for the end
+std::vector<f64> cumulativeEstimate(const Program& program, const MachineProfile& profile) {
+    Analyzer analyzer;
+    analyzer.setMachineProfile(profile);
+    const auto stats = analyzer.analyze(program);
+
+    std::vector<f64> cumulative(stats.segmentTimes.size() + 1, 0.0);
+    for (usize i = 0; i < stats.segmentTimes.size(); ++i)
+        cumulative[i + 1] = cumulative[i] + static_cast<f64>(stats.segmentTimes[i]) * 60.0;
+    return cumulative;
+}
+
+f64 estimateAt(const std::vector<f64>& cumulative, const PathPos& pos) {
+    const f64 start = cumulative[pos.segment];
+    return start + (cumulative[pos.segment + 1] - start) * static_cast<f64>(pos.fraction);
+}
+
+f64 squaredError(const std::vector<Interval>& intervals, const std::vector<f64>& cumulative) {
+    f64 sum = 0.0;
+    for (const auto& interval : intervals) {
+        const f64 estimate = estimateAt(cumulative, interval.to) - estimateAt(cumulative, interval.from);
+        const f64 error = interval.seconds - estimate;
+        sum += error * error;
+    }
+    return sum;
+}
+
+// Minimize f over log(scale) in [lo, hi]
+template <typename F>
+f32 goldenSection(F f, f32 lo, f32 hi) {
+    const f64 ratio = (std::sqrt(5.0) - 1.0) / 2.0;
+    f64 a = std::log(static_cast<f64>(lo));
+    f64 b = std::log(static_cast<f64>(hi));
+    f64 c = b - ratio * (b - a);
+    f64 d = a + ratio * (b - a);
+    f64 fc = f(static_cast<f32>(std::exp(c)));
+    f64 fd = f(static_cast<f32>(std::exp(d)));
+    for (int i = 0; i < 40; ++i) {
+        if (fc < fd) {
+            b = d;
+            d = c;
+            fd = fc;
+            c = b - ratio * (b - a);
+            fc = f(static_cast<f32>(std::exp(c)));
+        } else {
+            a = c;
+            c = d;
+            fc = fd;
+            d = a + ratio * (b - a);
+            fd = f(static_cast<f32>(std::exp(d)));
+        }
+    }
+    return static_cast<f32>(std::exp((a + b) / 2.0));
+}
+
+} // namespace
+
+CalibrationResult calibrateFromTelemetry(const JobTelemetry& telemetry,
+                                         const std::vector<std::string>& lines,
+                                         const MachineProfile& profile) {
+    CalibrationResult result;
+    result.profile = profile;
+
+    std::string content;
+    for (const auto& line : lines) {
+        content += line;
+        content += '\n';
+    }
+    Parser parser;
+    const Program program = parser.parse(content);
+    const auto& path = program.path;
+    if (path.empty())
+        return result;
+
+    // Path length to the start of each segment
+    std::vector<f64> pathStart(path.size() + 1, 0.0);
+    for (usize i = 0; i < path.size(); ++i) {
+        const Vec3 d = path[i].end - path[i].start;
+        pathStart[i + 1] = pathStart[i] + static_cast<f64>(std::sqrt(d.x * d.x + d.y * d.y + d.z * d.z));
+    }
+
+    // Locate each sample on the path. The machine only moves forward and can't
+    // be past the last acknowledged line, so the search starts at the previous
+    // match and stops at unacknowledged segments.
+    std::vector<Located> located(telemetry.samples.size());
+    usize ackIndex = 0;
+    int lastAcked = -1;
+    PathPos cursor;
+    for (usize i = 0; i < telemetry.samples.size(); ++i) {
+        const auto& sample = telemetry.samples[i];
+        while (ackIndex < telemetry.acks.size() && telemetry.acks[ackIndex].time <= sample.time)
+            lastAcked = std::max(lastAcked, telemetry.acks[ackIndex++].lineIndex);
+        if (lastAcked < 0)
+            continue;
+
+        f32 bestDist2 = std::numeric_limits<f32>::max();
+        PathPos best = cursor;
+        const usize end = std::min(path.size(), cursor.segment + kSearchWindow);
+        for (usize k = cursor.segment; k < end; ++k) {
+            if (path[k].lineNumber - 1 > lastAcked)
+                break;
+            f32 fraction = 0.0f;
+            const f32 dist2 = closestOnSegment(path[k], sample.workPos, fraction);
+            if (dist2 + kTieTolerance * kTieTolerance < bestDist2) {
+                bestDist2 = dist2;
+                best = {k, fraction};
+            }
+        }
+        if (bestDist2 > kOnPathTolerance * kOnPathTolerance)
+            continue;
+        if (best.segment == cursor.segment)
+            best.fraction = std::max(best.fraction, cursor.fraction);
+        cursor = best;
+
+        located[i].onPath = true;
+        located[i].pos = best;
+        located[i].distance = pathStart[best.segment] +
+                              (pathStart[best.segment + 1] - pathStart[best.segment]) *
+                                  static_cast<f64>(best.fraction);
+    }
+
+    // Intervals between consecutive samples that both show the machine
+    // running the program at 100% overrides and moving
+    std::vector<Interval> intervals;
+    auto measurable = [](const TelemetrySample& s) {
+        return s.state == MachineState::Run && s.feedOverride == 100 && s.rapidOverride == 100;
+    };
+    for (usize i = 1; i < telemetry.samples.size(); ++i) {
+        const auto& a = telemetry.samples[i - 1];
+        const auto& b = telemetry.samples[i];
+        if (!located[i - 1].onPath || !located[i].onPath || !measurable(a) || !measurable(b))
+            continue;
+        if (!(located[i].distance > located[i - 1].distance) || !(b.time > a.time))
+            continue;
+        intervals.push_back({located[i - 1].pos, located[i].pos, located[i - 1].distance,
+                             located[i].distance, a.time, b.time - a.time});
+    }
+    result.intervalsUsed = intervals.size();
+
+    // Per-segment actual times: interpolate the time each segment boundary
+    // was passed within the measured intervals
+    const auto baseline = cumulativeEstimate(program, profile);
+    std::vector<f64> boundaryTime(path.size() + 1, -1.0);
+    usize boundary = 0;
+    for (const auto& interval : intervals) {
+        const f64 s0 = interval.fromDistance;
+        const f64 s1 = interval.toDistance;
+        while (boundary < boundaryTime.size() && pathStart[boundary] < s0)
+            ++boundary;
+        while (boundary < boundaryTime.size() && pathStart[boundary] <= s1) {
+            boundaryTime[boundary] = interval.startTime + (pathStart[boundary] - s0) / (s1 - s0) * interval.seconds;
+            ++boundary;
+        }
+    }
+    result.segments.resize(path.size());
+    for (usize k = 0; k < path.size(); ++k) {
+        auto& timing = result.segments[k];
+        timing.lineNumber = path[k].lineNumber;
+        timing.estimatedSeconds = static_cast<f32>(baseline[k + 1] - baseline[k]);
+        if (boundaryTime[k] >= 0.0 && boundaryTime[k + 1] >= 0.0)
+            timing.actualSeconds = static_cast<f32>(boundaryTime[k + 1] - boundaryTime[k]);
+    }
+    result.programEstimateSeconds = baseline.back();
+    result.calibratedProgramSeconds = baseline.back();
+
+    if (intervals.size() < kMinIntervals)
+        return result;
+    result.valid = true;
+
+    // Fit the acceleration and rate multipliers by coordinate descent. A
+    // multiplier that doesn't reduce the error (e.g. the rate scale on a job
+    // that never reaches the axis limits) stays at 1.
+    auto loss = [&](f32 accelScale, f32 rateScale) {
+        return squaredError(intervals, cumulativeEstimate(program, scaledProfile(profile, accelScale, rateScale)));
+    };
+    f32 accelScale = 1.0f;
+    f32 rateScale = 1.0f;
+    for (int round = 0; round < 2; ++round) {
+        const f64 before = loss(accelScale, rateScale);
+        const f32 accel = goldenSection([&](f32 s) { return loss(s, rateScale); }, 0.05f, 20.0f);
+        if (loss(accel, rateScale) < before * 0.999)
+            accelScale = accel;
+        const f64 mid = loss(accelScale, rateScale);
+        const f32 rate = goldenSection([&](f32 s) { return loss(accelScale, s); }, 0.25f, 4.0f);
+        if (loss(accelScale, rate) < mid * 0.999)
+            rateScale = rate;
+    }
+    result.accelScale = accelScale;
+    result.rateScale = rateScale;
+    result.profile = scaledProfile(profile, accelScale, rateScale);
+
+    const auto calibrated = cumulativeEstimate(program, result.profile);
+    for (const auto& interval : intervals) {
+        result.measuredSeconds += interval.seconds;
+        result.estimatedSeconds += estimateAt(baseline, interval.to) - estimateAt(baseline, interval.from);
+        result.calibratedSeconds += estimateAt(calibrated, interval.to) - estimateAt(calibrated, interval.from);
+    }
+    result.calibratedProgramSeconds = calibrated.back();
+    return result;
+}
+
+} // namespace gcode
+} // namespace dw
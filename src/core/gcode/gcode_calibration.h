@@ -0,0 +1,55 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "../cnc/job_telemetry.h"
+#include "machine_profile.h"
+
+namespace dw {
+namespace gcode {
+
+// Estimated vs measured time for one path segment
+struct SegmentTiming {
+    int lineNumber = 0;           // 1-based index into the streamed lines
+    f32 estimatedSeconds = 0.0f;  // Analyzer estimate with the input profile
+    f32 actualSeconds = -1.0f;    // From status samples; -1 where not measured
+};
+
+struct CalibrationResult {
+    bool valid = false; // Enough running samples to compare and fit
+    std::vector<SegmentTiming> segments; // Parallel to the parsed program's path
+    usize intervalsUsed = 0;
+
+    // Over the stretches of the run that could be measured
+    f64 measuredSeconds = 0.0;
+    f64 estimatedSeconds = 0.0;
+    f64 calibratedSeconds = 0.0;
+
+    // Whole program, as a quote would use
+    f64 programEstimateSeconds = 0.0;
+    f64 calibratedProgramSeconds = 0.0;
+
+    // Fitted multipliers and the input profile with them applied
+    f32 accelScale = 1.0f; // accelX/Y/Z
+    f32 rateScale = 1.0f;  // maxFeedRateX/Y/Z and rapidRate
+    MachineProfile profile;
+};
+
+// Compare a recorded run against Analyzer estimates and fit the profile's
+// acceleration and rate limits so the estimate matches the machine.
+//
+// `lines` are the lines that were streamed (line acks index into them). Each
+// status sample is located on the toolpath, and the time between consecutive
+// samples is compared with the estimate for the path covered. Only stretches
+// where the machine was running at 100% overrides count, so holds, tool
+// changes and starved planners don't skew the fit. Because Analyzer plans
+// every segment from and to a stop, the fitted acceleration also absorbs the
+// cornering speed a real planner carries: it is the value that makes quotes
+// match, not a measurement of the axis drives.
+CalibrationResult calibrateFromTelemetry(const JobTelemetry& telemetry,
+                                         const std::vector<std::string>& lines,
+                                         const MachineProfile& profile);
+
+} // namespace gcode
+} // namespace dw
@@ -0,0 +1,409 @@
+#include "gcode_lod.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+#include "../threading/parallel_for.h"
+#include "../utils/log.h"
+
+namespace dw {
+namespace gcode {
+
+namespace {
+
+constexpr usize CLASSIFY_GRAIN = 65536;
+constexpr u8 HIDDEN = 0xFF;
+
+// A coarser level is only stored when it saves at least this share of vertices
+constexpr f32 MIN_LEVEL_SAVING = 0.1f;
+
+// G-code Z-up -> renderer Y-up
+void pushPoint(std::vector<f32>& out, const Vec3& p) {
+    out.push_back(p.x);
+    out.push_back(p.z);
+    out.push_back(p.y);
+}
+
+f32 pointSegmentDistance(const Vec3& p, const Vec3& a, const Vec3& b) {
+    Vec3 ab = b - a;
+    f32 len2 = glm::dot(ab, ab);
+    f32 t = len2 > 0.0f ? std::clamp(glm::dot(p - a, ab) / len2, 0.0f, 1.0f) : 0.0f;
+    return glm::length(p - (a + ab * t));
+}
+
+struct ChunkJob {
+    u32 group = 0;
+    const std::vector<u32>* segments = nullptr;
+    usize begin = 0;
+    usize end = 0;
+};
+
+// Per-chunk build output; an empty level with reuse set draws the level below
+struct ChunkBuild {
+    std::array<std::vector<f32>, LodChunk::kLevels> verts;
+    std::array<bool, LodChunk::kLevels> reuse{};
+    Vec3 boundsMin{FLT_MAX};
+    Vec3 boundsMax{-FLT_MAX};
+
+    // Level whose vertices `level` actually draws
+    int owner(int level) const {
+        while (level > 0 && reuse[static_cast<usize>(level)])
+            --level;
+        return level;
+    }
+};
+
+void buildChunk(const std::vector<PathSegment>& path, const ChunkJob& job, ChunkBuild& out) {
+    const auto& segs = *job.segments;
+
+    // Level 0: every segment as-is
+    auto& exact = out.verts[0];
+    exact.reserve((job.end - job.begin) * 6);
+    for (usize i = job.begin; i < job.end; ++i) {
+        const auto& seg = path[segs[i]];
+        pushPoint(exact, seg.start);
+        pushPoint(exact, seg.end);
+        out.boundsMin = glm::min(out.boundsMin, glm::min(seg.start, seg.end));
+        out.boundsMax = glm::max(out.boundsMax, glm::max(seg.start, seg.end));
+    }
+    // Bounds in renderer space
+    std::swap(out.boundsMin.y, out.boundsMin.z);
+    std::swap(out.boundsMax.y, out.boundsMax.z);
+    const f32 diagonal = glm::length(out.boundsMax - out.boundsMin);
+
+    // Connected runs become polylines for simplification
+    std::vector<std::vector<Vec3>> runs;
+    for (usize i = job.begin; i < job.end; ++i) {
+        const auto& seg = path[segs[i]];
+        bool connected = i > job.begin && path[segs[i - 1]].end == seg.start;
+        if (!connected)
+            runs.push_back({seg.start});
+        runs.back().push_back(seg.end);
+    }
+
+    std::vector<u32> keep;
+    usize previousCount = exact.size();
+    for (int level = 1; level < LodChunk::kLevels; ++level) {
+        const f32 tolerance = LodGeometry::kLevelTolerance[static_cast<usize>(level)] * diagonal;
+        std::vector<f32> verts;
+        for (const auto& run : runs) {
+            simplifyPolyline(run, tolerance, keep);
+            for (usize k = 1; k < keep.size(); ++k) {
+                pushPoint(verts, run[keep[k - 1]]);
+                pushPoint(verts, run[keep[k]]);
+            }
+        }
+
+        auto& slot = out.verts[static_cast<usize>(level)];
+        if (static_cast<f32>(verts.size()) >
+            static_cast<f32>(previousCount) * (1.0f - MIN_LEVEL_SAVING)) {
+            out.reuse[static_cast<usize>(level)] = true;
+        } else {
+            slot = std::move(verts);
+            previousCount = slot.size();
+        }
+    }
+}
+
+} // namespace
+
+MoveKind classifyMove(const PathSegment& seg) {
+    if (seg.isRapid)
+        return MoveKind::Rapid;
+    f32 dz = seg.end.z - seg.start.z;
+    f32 dx = seg.end.x - seg.start.x;
+    f32 dy = seg.end.y - seg.start.y;
+    bool zDominant = (dz * dz) > (dx * dx + dy * dy) * 0.25f;
+    if (dz < -0.001f && zDominant)
+        return MoveKind::Plunge;
+    if (dz > 0.001f && zDominant)
+        return MoveKind::Retract;
+    return MoveKind::Cut;
+}
+
+bool isVisible(const PathSegment& seg, MoveKind kind, const LodBuildOptions& options) {
+    if (seg.end.z > options.zClipMax)
+        return false;
+    switch (kind) {
+    case MoveKind::Rapid:
+        return options.showRapids;
+    case MoveKind::Cut:
+        return options.showCuts;
+    case MoveKind::Plunge:
+        return options.showPlunges;
+    case MoveKind::Retract:
+        return options.showRetracts;
+    }
+    return false;
+}
+
+void simplifyPolyline(const std::vector<Vec3>& points, f32 tolerance, std::vector<u32>& keep) {
+    keep.clear();
+    const usize n = points.size();
+    if (n < 3 || tolerance <= 0.0f) {
+        for (usize i = 0; i < n; ++i)
+            keep.push_back(static_cast<u32>(i));
+        return;
+    }
+
+    std::vector<bool> kept(n, false);
+    kept[0] = kept[n - 1] = true;
+
+    // Explicit stack: runs can be thousands of points long
+    std::vector<std::pair<usize, usize>> stack;
+    stack.emplace_back(0, n - 1);
+    while (!stack.empty()) {
+        auto [first, last] = stack.back();
+        stack.pop_back();
+        if (last <= first + 1)
+            continue;
+
+        f32 worst = -1.0f;
+        usize worstIndex = first;
+        for (usize i = first + 1; i < last; ++i) {
+            f32 d = pointSegmentDistance(points[i], points[first], points[last]);
+            if (d > worst) {
+                worst = d;
+                worstIndex = i;
+            }
+        }
+        if (worst > tolerance) {
+            kept[worstIndex] = true;
+            stack.emplace_back(worstIndex, last);
+            stack.emplace_back(first, worstIndex);
+        }
+    }
+
+    for (usize i = 0; i < n; ++i) {
+        if (kept[i])
+            keep.push_back(static_cast<u32>(i));
+    }
+}
+
+void LodGeometry::build(const Program& program, const LodBuildOptions& options) {
+    clear();
+    const auto& path = program.path;
+    const usize n = path.size();
+    if (n == 0)
+        return;
+
+    // Classify and filter in parallel
+    std::vector<u8> kinds(n);
+    parallelFor(n, CLASSIFY_GRAIN, [&](usize begin, usize end) {
+        for (usize i = begin; i < end; ++i) {
+            const auto& seg = path[i];
+            MoveKind kind = classifyMove(seg);
+            kinds[i] = isVisible(seg, kind, options) ? static_cast<u8>(kind) : HIDDEN;
+        }
+    });
+
+    // Group segment lists in program order
+    std::vector<std::vector<u32>> groupSegments;
+    if (options.groupByTool) {
+        std::vector<u32> rapids;
+        std::map<int, std::vector<u32>> byTool;
+        for (usize i = 0; i < n; ++i) {
+            if (kinds[i] == HIDDEN)
+                continue;
+            if (kinds[i] == static_cast<u8>(MoveKind::Rapid))
+                rapids.push_back(static_cast<u32>(i));
+            else
+                byTool[path[i].toolNumber].push_back(static_cast<u32>(i));
+        }
+        if (!rapids.empty()) {
+            m_groups.push_back(LodGroup{MoveKind::Rapid, -1});
+            groupSegments.push_back(std::move(rapids));
+        }
+        for (auto& [tool, segments] : byTool) {
+            m_groups.push_back(LodGroup{MoveKind::Cut, tool});
+            groupSegments.push_back(std::move(segments));
+        }
+    } else {
+        std::array<std::vector<u32>, 4> byKind;
+        for (usize i = 0; i < n; ++i) {
+            if (kinds[i] != HIDDEN)
+                byKind[kinds[i]].push_back(static_cast<u32>(i));
+        }
+        for (usize k = 0; k < byKind.size(); ++k) {
+            if (byKind[k].empty())
+                continue;
+            m_groups.push_back(LodGroup{static_cast<MoveKind>(k), -1});
+            groupSegments.push_back(std::move(byKind[k]));
+        }
+    }
+
+    // Chunk jobs, group by group
+    const usize chunkSize = std::max<u32>(options.chunkSegments, 1);
+    std::vector<ChunkJob> jobs;
+    for (usize g = 0; g < groupSegments.size(); ++g) {
+        const auto& segments = groupSegments[g];
+        for (usize begin = 0; begin < segments.size(); begin += chunkSize)
+            jobs.push_back(ChunkJob{static_cast<u32>(g),
+                                    &segments,
+                                    begin,
+                                    std::min(segments.size(), begin + chunkSize)});
+    }
+    if (jobs.empty())
+        return;
+
+    std::vector<ChunkBuild> builds(jobs.size());
+    parallelFor(jobs.size(), 1, [&](usize begin, usize end) {
+        for (usize c = begin; c < end; ++c)
+            buildChunk(path, jobs[c], builds[c]);
+    });
+
+    // Vertex budget: drop the finest levels until the stored levels fit
+    auto storedFloats = [&](int minLevel) {
+        usize total = 0;
+        for (const auto& b : builds) {
+            total += b.verts[static_cast<usize>(b.owner(minLevel))].size();
+            for (int level = minLevel + 1; level < LodChunk::kLevels; ++level) {
+                if (b.owner(level) == level)
+                    total += b.verts[static_cast<usize>(level)].size();
+            }
+        }
+        return total;
+    };
+    m_minLevel = 0;
+    while (m_minLevel + 1 < LodChunk::kLevels && storedFloats(m_minLevel) / 3 > options.maxVertices)
+        ++m_minLevel;
+    const usize storedVertices = storedFloats(m_minLevel) / 3;
+    if (storedVertices > options.maxVertices) {
+        log::warningf("GCode",
+                      "Toolpath LOD: coarsest level alone needs %zu vertices (budget %zu)",
+                      storedVertices,
+                      options.maxVertices);
+    } else if (m_minLevel > 0) {
+        log::infof("GCode",
+                   "Toolpath LOD: %zu segments exceed the vertex budget, finest level %d",
+                   n,
+                   m_minLevel);
+    }
+
+    // Lay out level-major, chunk-major; reused levels point at their owner's range
+    m_chunks.resize(jobs.size());
+    std::vector<std::array<usize, LodChunk::kLevels>> floatOffset(jobs.size());
+    usize offset = 0;
+    for (int level = m_minLevel; level < LodChunk::kLevels; ++level) {
+        const auto l = static_cast<usize>(level);
+        for (usize c = 0; c < jobs.size(); ++c) {
+            const auto& b = builds[c];
+            auto& chunk = m_chunks[c];
+            int owner = std::max(b.owner(level), m_minLevel);
+            if (level > m_minLevel && owner < level) {
+                auto o = static_cast<usize>(owner);
+                chunk.first[l] = chunk.first[o];
+                chunk.count[l] = chunk.count[o];
+                floatOffset[c][l] = floatOffset[c][o];
+                continue;
+            }
+            const auto& verts = b.verts[static_cast<usize>(b.owner(level))];
+            floatOffset[c][l] = offset;
+            chunk.first[l] = static_cast<u32>(offset / 3);
+            chunk.count[l] = static_cast<u32>(verts.size() / 3);
+            offset += verts.size();
+        }
+    }
+    for (usize c = 0; c < jobs.size(); ++c) {
+        auto& chunk = m_chunks[c];
+        chunk.group = jobs[c].group;
+        chunk.boundsMin = builds[c].boundsMin;
+        chunk.boundsMax = builds[c].boundsMax;
+        for (int level = 0; level < m_minLevel; ++level) {
+            chunk.first[static_cast<usize>(level)] = chunk.first[static_cast<usize>(m_minLevel)];
+            chunk.count[static_cast<usize>(level)] = chunk.count[static_cast<usize>(m_minLevel)];
+        }
+    }
+
+    m_vertices.resize(offset);
+    m_vertexCount = offset / 3;
+    parallelFor(jobs.size(), 1, [&](usize begin, usize end) {
+        for (usize c = begin; c < end; ++c) {
+            for (int level = m_minLevel; level < LodChunk::kLevels; ++level) {
+                const auto l = static_cast<usize>(level);
+                if (level > m_minLevel && std::max(builds[c].owner(level), m_minLevel) < level)
+                    continue;
+                const auto& verts = builds[c].verts[static_cast<usize>(builds[c].owner(level))];
+                std::copy(verts.begin(),
+                          verts.end(),
+                          m_vertices.begin() + static_cast<std::ptrdiff_t>(floatOffset[c][l]));
+            }
+        }
+    });
+}
+
+void LodGeometry::clear() {
+    m_vertices.clear();
+    m_vertexCount = 0;
+    m_groups.clear();
+    m_chunks.clear();
+    m_minLevel = 0;
+}
+
+void LodGeometry::releaseVertices() {
+    m_vertices.clear();
+    m_vertices.shrink_to_fit();
+}
+
+int LodGeometry::selectLevel(const LodChunk& chunk, const LodView& view) const {
+    const Mat4& m = view.viewProj;
+    auto row = [&m](int i) { return Vec4{m[0][i], m[1][i], m[2][i], m[3][i]}; };
+    const Vec4 r0 = row(0), r1 = row(1), r2 = row(2), r3 = row(3);
+
+    // Frustum planes (Gribb-Hartmann); the box is out if fully behind any one
+    const Vec4 planes[6] = {r3 + r0, r3 - r0, r3 + r1, r3 - r1, r3 + r2, r3 - r2};
+    for (const Vec4& p : planes) {
+        Vec3 v{p.x >= 0.0f ? chunk.boundsMax.x : chunk.boundsMin.x,
+               p.y >= 0.0f ? chunk.boundsMax.y : chunk.boundsMin.y,
+               p.z >= 0.0f ? chunk.boundsMax.z : chunk.boundsMin.z};
+        if (p.x * v.x + p.y * v.y + p.z * v.z + p.w < 0.0f)
+            return -1;
+    }
+
+    // Projected size of the chunk at its depth
+    const Vec3 center = (chunk.boundsMin + chunk.boundsMax) * 0.5f;
+    const f32 diagonal = glm::length(chunk.boundsMax - chunk.boundsMin);
+    const f32 depth = r3.x * center.x + r3.y * center.y + r3.z * center.z + r3.w;
+    if (depth <= diagonal * 0.5f)
+        return m_minLevel;
+    const f32 chunkPx = diagonal * view.pixelsPerUnit / depth;
+
+    for (int level = LodChunk::kLevels - 1; level > m_minLevel; --level) {
+        if (kLevelTolerance[static_cast<usize>(level)] * chunkPx <= view.maxErrorPx)
+            return level;
+    }
+    return m_minLevel;
+}
+
+void LodGeometry::selectDraws(const LodView& view, std::vector<LodDrawBatch>& out) const {
+    out.resize(m_groups.size());
+    for (usize g = 0; g < out.size(); ++g) {
+        out[g].group = static_cast<u32>(g);
+        out[g].first.clear();
+        out[g].count.clear();
+    }
+
+    for (const auto& chunk : m_chunks) {
+        int level = selectLevel(chunk, view);
+        if (level < 0)
+            continue;
+        const auto l = static_cast<usize>(level);
+        if (chunk.count[l] == 0)
+            continue;
+
+        auto& batch = out[chunk.group];
+        auto first = static_cast<i32>(chunk.first[l]);
+        auto count = static_cast<i32>(chunk.count[l]);
+        // Neighbouring chunks at the same level are contiguous: extend the range
+        if (!batch.first.empty() && batch.first.back() + batch.count.back() == first)
+            batch.count.back() += count;
+        else {
+            batch.first.push_back(first);
+            batch.count.push_back(count);
+        }
+    }
+}
+
+} // namespace gcode
+} // namespace dw
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <array>
+#include <cfloat>
+#include <vector>
+
+#include "../types.h"
+#include "gcode_types.h"
+
+namespace dw {
+namespace gcode {
+
+// Move categories the viewport colors separately
+enum class MoveKind : u8 { Rapid, Cut, Plunge, Retract };
+
+// Rapid, or a feed move classified by whether Z dominates its direction
+MoveKind classifyMove(const PathSegment& seg);
+
+// Douglas-Peucker: indices of the points to keep so that no dropped point is
+// farther than `tolerance` from the simplified polyline. First and last are
+// always kept; fewer than three points are returned unchanged.
+void simplifyPolyline(const std::vector<Vec3>& points, f32 tolerance, std::vector<u32>& keep);
+
+struct LodBuildOptions {
+    f32 zClipMax = FLT_MAX; // Segments ending above this are skipped
+    bool showRapids = false;
+    bool showCuts = true;
+    bool showPlunges = true;
+    bool showRetracts = true;
+    bool groupByTool = false;          // Rapids + one group per tool instead of per kind
+    u32 chunkSegments = 4096;          // Consecutive segments per chunk
+    usize maxVertices = 8u << 20;      // Upload budget; finest levels are dropped to fit.
+                                       // Soft cap: the coarsest level is always kept
+};
+
+// Whether a segment of the given kind passes the Z-clip and visibility toggles
+bool isVisible(const PathSegment& seg, MoveKind kind, const LodBuildOptions& options);
+
+// One color group: a move kind, or (groupByTool) a tool's feed moves
+struct LodGroup {
+    MoveKind kind = MoveKind::Cut;
+    int toolNumber = -1; // -1 unless grouped by tool
+};
+
+// Run of consecutive path segments with a line list per level of detail
+struct LodChunk {
+    static constexpr int kLevels = 4;
+
+    Vec3 boundsMin{0.0f}; // Renderer space (G-code Z -> Y)
+    Vec3 boundsMax{0.0f};
+    u32 group = 0;
+    std::array<u32, kLevels> first{}; // Vertex ranges in LodGeometry::vertices()
+    std::array<u32, kLevels> count{};
+};
+
+// Camera parameters for per-frame level selection
+struct LodView {
+    Mat4 viewProj{1.0f};
+    f32 pixelsPerUnit = 1.0f; // viewportHeight / (2 tan(fovY / 2)): pixels per unit at depth 1
+    f32 maxErrorPx = 1.0f;    // Allowed screen-space deviation of simplified lines
+};
+
+// Vertex ranges to draw for one group (glMultiDrawArrays-ready)
+struct LodDrawBatch {
+    u32 group = 0;
+    std::vector<i32> first;
+    std::vector<i32> count;
+
+    bool empty() const { return first.empty(); }
+};
+
+// Hierarchical line geometry for large toolpaths.
+//
+// The filtered path is split into chunks of consecutive segments per group.
+// Each chunk stores its exact line list (level 0) plus Douglas-Peucker
+// simplifications at tolerances that grow with level, relative to the chunk's
+// size. Per frame, chunks outside the frustum are skipped and every other
+// chunk draws the coarsest level whose error stays under maxErrorPx, so both
+// the GPU buffer (maxVertices) and the per-frame vertex count stay bounded.
+// The budget only drops whole levels: a toolpath whose coarsest level alone
+// exceeds maxVertices keeps that level (minLevel() == kLevels - 1) and logs a
+// warning rather than losing geometry.
+//
+// Vertices are laid out level-major and then chunk-major within each group, so
+// neighbouring chunks at the same level merge into a single draw range. The
+// build runs chunks in parallel and is deterministic.
+class LodGeometry {
+  public:
+    // Tolerance per level as a fraction of the chunk diagonal
+    static constexpr std::array<f32, LodChunk::kLevels> kLevelTolerance = {
+        0.0f, 1.0f / 512.0f, 1.0f / 128.0f, 1.0f / 32.0f};
+
+    void build(const Program& program, const LodBuildOptions& options);
+    void clear();
+
+    // Interleaved xyz positions for GL_LINES (renderer space)
+    const std::vector<f32>& vertices() const { return m_vertices; }
+    usize vertexCount() const { return m_vertexCount; }
+
+    // Drop the CPU copy once uploaded; chunk ranges stay valid
+    void releaseVertices();
+
+    const std::vector<LodGroup>& groups() const { return m_groups; }
+    const std::vector<LodChunk>& chunks() const { return m_chunks; }
+    bool empty() const { return m_vertexCount == 0; }
+
+    // Finest level kept after applying the vertex budget
+    int minLevel() const { return m_minLevel; }
+
+    // Level a chunk would draw at, or -1 when it is outside the frustum
+    int selectLevel(const LodChunk& chunk, const LodView& view) const;
+
+    // Visible ranges per group, in group order (batches may be empty)
+    void selectDraws(const LodView& view, std::vector<LodDrawBatch>& out) const;
+
+  private:
+    std::vector<f32> m_vertices;
+    usize m_vertexCount = 0;
+    std::vector<LodGroup> m_groups;
+    std::vector<LodChunk> m_chunks;
+    int m_minLevel = 0;
+};
+
+} // namespace gcode
+} // namespace dw
@@ -5,10 +5,21 @@
 #include <cstdlib>
 #include <sstream>
 
+#include "gcode_writer.h"
+
 namespace dw {
 
+namespace {
+
+std::string axisWord(char axis, float value) {
+    return axis + gcode::GcodeWriter::formatNumber(value);
+}
+
+} // namespace
+
 std::vector<std::string> ModalState::toPreamble() const {
     std::vector<std::string> lines;
+    const bool reposition = position[0] && position[1] && position[2];
 
     // 1. Units (must come first so subsequent values are interpreted correctly)
     lines.push_back(units);
@@ -16,8 +27,8 @@ std::vector<std::string> ModalState::toPreamble() const {
     // 2. Coordinate system
     lines.push_back(coordinateSystem);
 
-    // 3. Distance mode
-    lines.push_back(distanceMode);
+    // 3. Distance mode (absolute while repositioning, restored afterwards)
+    lines.push_back(reposition ? "G90" : distanceMode);
 
     // 4. Feed rate (only if set)
     if (feedRate > 0.0f) {
@@ -39,6 +50,28 @@ std::vector<std::string> ModalState::toPreamble() const {
     // 7. Coolant state
     lines.push_back(coolantState);
 
+    if (!reposition)
+        return lines;
+
+    // 8. Retract, move over the resume point, plunge at the cutting feed
+    const float z = *position[2];
+    const float clearZ = std::max(clearanceZ.value_or(z), z);
+    lines.push_back("G0 " + axisWord('Z', clearZ));
+    lines.push_back("G0 " + axisWord('X', *position[0]) + " " + axisWord('Y', *position[1]));
+    std::string plungeMode = "G0";
+    if (feedRate > 0.0f) {
+        plungeMode = "G1";
+        lines.push_back("G1 " + axisWord('Z', z) + " " + axisWord('F', feedRate));
+    } else {
+        lines.push_back("G0 " + axisWord('Z', z));
+    }
+
+    // 9. Distance and motion mode the resumed lines expect
+    if (distanceMode != "G90")
+        lines.push_back(distanceMode);
+    if ((motionMode == "G0" || motionMode == "G1") && motionMode != plungeMode)
+        lines.push_back(motionMode);
+
     return lines;
 }
 
@@ -88,6 +121,11 @@ ModalState GCodeModalScanner::scanToLine(const std::vector<std::string>& program
         if (line.empty())
             continue;
 
+        // Axis words on this line, applied once its G words are known
+        std::optional<float> axisValue[3];
+        bool machineCoords = false; // G53, G28, G30, G10: axis words are not a program position
+        bool setsPosition = false;  // G92: axis words are the new position
+
         // Scan through the line character by character to extract codes and values
         size_t pos = 0;
         while (pos < line.size()) {
@@ -134,7 +172,16 @@ ModalState GCodeModalScanner::scanToLine(const std::vector<std::string>& program
                 case 57: state.coordinateSystem = "G57"; break;
                 case 58: state.coordinateSystem = "G58"; break;
                 case 59: state.coordinateSystem = "G59"; break;
-                default: break; // G0, G1, G2, G3, etc. don't affect modal tracking
+                case 0: state.motionMode = "G0"; break;
+                case 1: state.motionMode = "G1"; break;
+                case 2: state.motionMode = "G2"; break;
+                case 3: state.motionMode = "G3"; break;
+                case 10:
+                case 28:
+                case 30:
+                case 53: machineCoords = true; break;
+                case 92: setsPosition = true; break;
+                default: break;
                 }
             } else if (letter == 'M') {
                 ++pos;
@@ -188,18 +235,34 @@ ModalState GCodeModalScanner::scanToLine(const std::vector<std::string>& program
                     state.spindleSpeed = std::strtof(line.c_str() + start, nullptr);
                 }
             } else {
-                // Skip other letters and their numeric arguments (X, Y, Z, I, J, K, etc.)
+                // Other letters and their numeric arguments (X, Y, Z, I, J, K, etc.)
                 ++pos;
                 while (pos < line.size() && line[pos] == ' ')
                     ++pos;
-                // Skip number
+                size_t start = pos;
                 if (pos < line.size() && (line[pos] == '-' || line[pos] == '+'))
                     ++pos;
                 while (pos < line.size() &&
                        (std::isdigit(static_cast<unsigned char>(line[pos])) || line[pos] == '.'))
                     ++pos;
+                if (pos > start && letter >= 'X' && letter <= 'Z')
+                    axisValue[letter - 'X'] = std::strtof(line.c_str() + start, nullptr);
             }
         }
+
+        if (machineCoords)
+            continue;
+        const bool incremental = state.distanceMode == "G91" && !setsPosition;
+        for (int axis = 0; axis < 3; ++axis) {
+            if (!axisValue[axis])
+                continue;
+            if (!incremental)
+                state.position[axis] = *axisValue[axis];
+            else if (state.position[axis])
+                *state.position[axis] += *axisValue[axis];
+        }
+        if (state.position[2])
+            state.clearanceZ = std::max(state.clearanceZ.value_or(*state.position[2]), *state.position[2]);
     }
 
     return state;
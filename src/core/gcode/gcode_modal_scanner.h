@@ -1,5 +1,6 @@
 #pragma once
 
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -15,10 +16,21 @@ struct ModalState {
     std::string coolantState = "M9";        // M7 (mist), M8 (flood), M9 (off)
     float feedRate = 0.0f;                  // F value
     float spindleSpeed = 0.0f;              // S value
+    std::string motionMode = "G0";          // G0, G1, G2 or G3
+
+    // Program position after the scanned lines (work coordinates), per axis;
+    // unset until an axis is given in absolute mode
+    std::optional<float> position[3];
+    // Highest Z the program has been at, used as the retract height
+    std::optional<float> clearanceZ;
 
     // Generate G-code preamble to restore this modal state.
     // Order: units, coordinate system, distance mode, feed rate, spindle speed,
     //        spindle state, coolant state.
+    // When X, Y and Z are all known, the tool is then brought back to the
+    // resume position: G0 up to clearanceZ, G0 over XY, G1 down to Z at the
+    // modal feed. Distance mode (G90 during the reposition) and motion mode
+    // are restored last. Arc modes are not restated: G2/G3 need axis words.
     std::vector<std::string> toPreamble() const;
 };
 
@@ -6,11 +6,13 @@
 #include "../utils/file_utils.h"
 #include "../utils/log.h"
 #include "../utils/string_utils.h"
+#include "../utils/trace.h"
 
 namespace dw {
 namespace gcode {
 
 Program Parser::parse(const std::string& content) {
+    DW_TRACE_ZONE("G-code parse");
     Program program;
     m_lastError.clear();
 
@@ -0,0 +1,68 @@
+#include "gcode_sim_path.h"
+
+#include <algorithm>
+
+namespace dw {
+namespace gcode {
+
+namespace {
+
+// Swap Y<->Z: G-code is Z-up, the renderer is Y-up
+void pushPoint(std::vector<f32>& out, const Vec3& p) {
+    out.push_back(p.x);
+    out.push_back(p.z);
+    out.push_back(p.y);
+}
+
+} // namespace
+
+void SimPath::build(const Program& program, f32 zClipMax) {
+    clear();
+
+    const auto& path = program.path;
+    completedVertexCount.reserve(path.size() + 1);
+    vertices.reserve((path.size() + 1) * 6);
+
+    u32 count = 0;
+    for (const auto& seg : path) {
+        completedVertexCount.push_back(count);
+        if (seg.end.z > zClipMax)
+            continue;
+        pushPoint(vertices, seg.start);
+        pushPoint(vertices, seg.end);
+        count += 2;
+    }
+    completedVertexCount.push_back(count);
+
+    // Spare tail for the in-progress segment (rewritten each frame)
+    vertices.resize(vertices.size() + 6, 0.0f);
+}
+
+void SimPath::clear() {
+    vertices.clear();
+    completedVertexCount.clear();
+}
+
+u32 SimPath::completedVertices(usize segmentIndex) const {
+    if (completedVertexCount.empty())
+        return 0;
+    return completedVertexCount[std::min(segmentIndex, completedVertexCount.size() - 1)];
+}
+
+u32 SimPath::partialVertex() const {
+    return completedVertexCount.empty() ? 0 : completedVertexCount.back();
+}
+
+void SimPath::partialSegment(const PathSegment& seg, f32 t, f32 out[6]) {
+    t = std::clamp(t, 0.0f, 1.0f);
+    Vec3 end = seg.start + (seg.end - seg.start) * t;
+    out[0] = seg.start.x;
+    out[1] = seg.start.z;
+    out[2] = seg.start.y;
+    out[3] = end.x;
+    out[4] = end.z;
+    out[5] = end.y;
+}
+
+} // namespace gcode
+} // namespace dw
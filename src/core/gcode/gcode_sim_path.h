@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+
+#include "../types.h"
+#include "gcode_types.h"
+
+namespace dw {
+namespace gcode {
+
+// Line geometry for simulation playback, built once per program / Z-clip change.
+//
+// Every visible segment is stored in program order as two renderer-space
+// vertices (G-code Z -> renderer Y), followed by two spare vertices for the
+// partially cut current segment. The "completed" overlay for segment index N is
+// then just the vertex range [0, completedVertices(N)), and only the two tail
+// vertices change per frame, so playback cost no longer grows with position.
+struct SimPath {
+    std::vector<f32> vertices;             // xyz per vertex, tail included
+    std::vector<u32> completedVertexCount; // [i] = vertices drawn before segment i
+
+    // Rebuild from a program, skipping segments that end above zClipMax
+    void build(const Program& program, f32 zClipMax);
+    void clear();
+
+    bool empty() const { return completedVertexCount.empty(); }
+    usize segmentCount() const {
+        return completedVertexCount.empty() ? 0 : completedVertexCount.size() - 1;
+    }
+
+    // Vertices of fully cut segments before segmentIndex (clamped to the end)
+    u32 completedVertices(usize segmentIndex) const;
+
+    // First of the two spare vertices reserved for the current segment
+    u32 partialVertex() const;
+
+    // Start and interpolated end (t in [0,1]) of a segment in renderer space
+    static void partialSegment(const PathSegment& seg, f32 t, f32 out[6]);
+};
+
+} // namespace gcode
+} // namespace dw
@@ -0,0 +1,378 @@
+#include "gcode_spatial_index.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include "../threading/parallel_for.h"
+
+namespace dw {
+namespace gcode {
+
+namespace {
+
+constexpr usize LEAF_SIZE = 8;     // Segments per leaf
+constexpr usize FANOUT = 8;        // Children per internal node
+constexpr usize SORT_CHUNK = 65536; // Keys sorted per task before merging
+constexpr usize BUILD_GRAIN = 4096;
+
+// Spread the low 10 bits of v so there are two zero bits between each
+u32 expandBits(u32 v) {
+    v = (v * 0x00010001u) & 0xFF0000FFu;
+    v = (v * 0x00000101u) & 0x0F00F00Fu;
+    v = (v * 0x00000011u) & 0xC30C30C3u;
+    v = (v * 0x00000005u) & 0x49249249u;
+    return v;
+}
+
+u32 morton3(f32 x, f32 y, f32 z) {
+    auto quantize = [](f32 v) {
+        return static_cast<u32>(std::clamp(v * 1024.0f, 0.0f, 1023.0f));
+    };
+    return (expandBits(quantize(x)) << 2) | (expandBits(quantize(y)) << 1) |
+           expandBits(quantize(z));
+}
+
+struct Box {
+    Vec3 min{FLT_MAX};
+    Vec3 max{-FLT_MAX};
+
+    void expand(const Vec3& p) {
+        min = glm::min(min, p);
+        max = glm::max(max, p);
+    }
+    void expand(const Box& b) {
+        min = glm::min(min, b.min);
+        max = glm::max(max, b.max);
+    }
+};
+
+bool overlaps(const Vec3& aMin, const Vec3& aMax, const Vec3& bMin, const Vec3& bMax) {
+    return aMin.x <= bMax.x && aMax.x >= bMin.x && aMin.y <= bMax.y && aMax.y >= bMin.y &&
+           aMin.z <= bMax.z && aMax.z >= bMin.z;
+}
+
+// Liang-Barsky: parameter interval [t0, t1] of a->b inside the box
+bool clipSegment(const Vec3& a, const Vec3& b, const Vec3& min, const Vec3& max, f32& t0, f32& t1) {
+    t0 = 0.0f;
+    t1 = 1.0f;
+    const Vec3 d = b - a;
+    for (int axis = 0; axis < 3; ++axis) {
+        if (d[axis] == 0.0f) {
+            if (a[axis] < min[axis] || a[axis] > max[axis])
+                return false;
+            continue;
+        }
+        f32 inv = 1.0f / d[axis];
+        f32 tNear = (min[axis] - a[axis]) * inv;
+        f32 tFar = (max[axis] - a[axis]) * inv;
+        if (tNear > tFar)
+            std::swap(tNear, tFar);
+        t0 = std::max(t0, tNear);
+        t1 = std::min(t1, tFar);
+        if (t0 > t1)
+            return false;
+    }
+    return true;
+}
+
+// Slab test; returns the entry distance along the ray or a negative value on a miss
+f32 rayBoxEntry(const Vec3& origin, const Vec3& invDir, const Vec3& min, const Vec3& max) {
+    f32 tNear = 0.0f;
+    f32 tFar = FLT_MAX;
+    for (int axis = 0; axis < 3; ++axis) {
+        if (std::isinf(invDir[axis])) {
+            if (origin[axis] < min[axis] || origin[axis] > max[axis])
+                return -1.0f;
+            continue;
+        }
+        f32 t1 = (min[axis] - origin[axis]) * invDir[axis];
+        f32 t2 = (max[axis] - origin[axis]) * invDir[axis];
+        if (t1 > t2)
+            std::swap(t1, t2);
+        tNear = std::max(tNear, t1);
+        tFar = std::min(tFar, t2);
+        if (tNear > tFar)
+            return -1.0f;
+    }
+    return tNear;
+}
+
+// Closest points between a ray (unit direction, t >= 0) and segment a->b
+// (after Ericson, Real-Time Collision Detection 5.1.9)
+void closestRaySegment(const Vec3& origin,
+                       const Vec3& dir,
+                       const Vec3& a,
+                       const Vec3& b,
+                       f32& rayT,
+                       f32& distance) {
+    const Vec3 d2 = b - a;
+    const Vec3 r = origin - a;
+    const f32 e = glm::dot(d2, d2);
+    const f32 c = glm::dot(dir, r);
+
+    f32 s = 0.0f; // Ray parameter
+    f32 t = 0.0f; // Segment parameter
+    if (e <= 1e-12f) {
+        s = std::max(-c, 0.0f);
+    } else {
+        const f32 f = glm::dot(d2, r);
+        const f32 bb = glm::dot(dir, d2);
+        const f32 denom = e - bb * bb;
+        s = denom > 1e-12f ? std::max((bb * f - c * e) / denom, 0.0f) : 0.0f;
+        t = (bb * s + f) / e;
+        if (t < 0.0f) {
+            t = 0.0f;
+            s = std::max(-c, 0.0f);
+        } else if (t > 1.0f) {
+            t = 1.0f;
+            s = std::max(bb - c, 0.0f);
+        }
+    }
+    rayT = s;
+    distance = glm::length((origin + dir * s) - (a + d2 * t));
+}
+
+} // namespace
+
+void SpatialIndex::build(const Program& program) {
+    clear();
+    const auto& path = program.path;
+    const usize n = path.size();
+    if (n == 0 || n > static_cast<usize>(UINT32_MAX))
+        return;
+    m_path = &path;
+
+    // Centroid bounds for Morton quantization
+    Box centroidBounds = parallelReduce(
+        n,
+        SORT_CHUNK,
+        Box{},
+        [&](usize begin, usize end) {
+            Box box;
+            for (usize i = begin; i < end; ++i)
+                box.expand((path[i].start + path[i].end) * 0.5f);
+            return box;
+        },
+        [](Box lhs, const Box& rhs) {
+            lhs.expand(rhs);
+            return lhs;
+        });
+    const Vec3 extent = glm::max(centroidBounds.max - centroidBounds.min, Vec3{1e-6f});
+    const Vec3 scale = Vec3{1.0f} / extent;
+
+    // Keys carry the path index in the low bits: unique, so the sort is deterministic
+    std::vector<u64> keys(n);
+    parallelFor(n, SORT_CHUNK, [&](usize begin, usize end) {
+        for (usize i = begin; i < end; ++i) {
+            Vec3 c = ((path[i].start + path[i].end) * 0.5f - centroidBounds.min) * scale;
+            keys[i] = (static_cast<u64>(morton3(c.x, c.y, c.z)) << 32) | static_cast<u64>(i);
+        }
+    });
+
+    // Sort fixed chunks in parallel, then merge pairs of runs level by level
+    parallelFor(n, SORT_CHUNK, [&](usize begin, usize end) {
+        std::sort(keys.begin() + static_cast<std::ptrdiff_t>(begin),
+                  keys.begin() + static_cast<std::ptrdiff_t>(end));
+    });
+    std::vector<u64> merged(n);
+    for (usize width = SORT_CHUNK; width < n; width *= 2) {
+        usize pairs = (n + 2 * width - 1) / (2 * width);
+        parallelFor(pairs, 1, [&](usize pairBegin, usize pairEnd) {
+            for (usize p = pairBegin; p < pairEnd; ++p) {
+                auto first = static_cast<std::ptrdiff_t>(p * 2 * width);
+                auto mid = static_cast<std::ptrdiff_t>(std::min(n, p * 2 * width + width));
+                auto last = static_cast<std::ptrdiff_t>(std::min(n, p * 2 * width + 2 * width));
+                std::merge(keys.begin() + first,
+                           keys.begin() + mid,
+                           keys.begin() + mid,
+                           keys.begin() + last,
+                           merged.begin() + first);
+            }
+        });
+        keys.swap(merged);
+    }
+
+    m_order.resize(n);
+    parallelFor(n, SORT_CHUNK, [&](usize begin, usize end) {
+        for (usize i = begin; i < end; ++i)
+            m_order[i] = static_cast<u32>(keys[i] & 0xFFFFFFFFu);
+    });
+
+    // Leaves over consecutive runs of the sorted order
+    std::vector<Node> leaves((n + LEAF_SIZE - 1) / LEAF_SIZE);
+    parallelFor(leaves.size(), BUILD_GRAIN, [&](usize begin, usize end) {
+        for (usize leaf = begin; leaf < end; ++leaf) {
+            Box box;
+            usize last = std::min(n, (leaf + 1) * LEAF_SIZE);
+            for (usize i = leaf * LEAF_SIZE; i < last; ++i) {
+                const auto& seg = path[m_order[i]];
+                box.expand(seg.start);
+                box.expand(seg.end);
+            }
+            leaves[leaf] = Node{box.min, box.max};
+        }
+    });
+    m_levels.push_back(std::move(leaves));
+
+    // Upper levels until a single root
+    while (m_levels.back().size() > 1) {
+        const std::vector<Node>& below = m_levels.back();
+        std::vector<Node> level((below.size() + FANOUT - 1) / FANOUT);
+        parallelFor(level.size(), BUILD_GRAIN, [&](usize begin, usize end) {
+            for (usize node = begin; node < end; ++node) {
+                Box box;
+                usize last = std::min(below.size(), (node + 1) * FANOUT);
+                for (usize child = node * FANOUT; child < last; ++child) {
+                    box.expand(below[child].min);
+                    box.expand(below[child].max);
+                }
+                level[node] = Node{box.min, box.max};
+            }
+        });
+        m_levels.push_back(std::move(level));
+    }
+}
+
+void SpatialIndex::clear() {
+    m_path = nullptr;
+    m_order.clear();
+    m_levels.clear();
+}
+
+template <typename NodeTest, typename LeafFn>
+void SpatialIndex::traverse(NodeTest&& nodeTest, LeafFn&& leafFn) const {
+    if (m_levels.empty())
+        return;
+
+    struct Entry {
+        usize level;
+        usize node;
+    };
+    std::vector<Entry> stack;
+    stack.push_back({m_levels.size() - 1, 0});
+
+    while (!stack.empty()) {
+        Entry entry = stack.back();
+        stack.pop_back();
+
+        const Node& node = m_levels[entry.level][entry.node];
+        if (!nodeTest(node.min, node.max))
+            continue;
+
+        if (entry.level == 0) {
+            usize last = std::min(m_order.size(), (entry.node + 1) * LEAF_SIZE);
+            for (usize i = entry.node * LEAF_SIZE; i < last; ++i)
+                leafFn(m_order[i]);
+            continue;
+        }
+
+        // Push children in reverse so they are visited in order
+        usize first = entry.node * FANOUT;
+        usize last = std::min(m_levels[entry.level - 1].size(), first + FANOUT);
+        for (usize child = last; child > first; --child)
+            stack.push_back({entry.level - 1, child - 1});
+    }
+}
+
+void SpatialIndex::queryBox(const Vec3& min, const Vec3& max, std::vector<u32>& out) const {
+    out.clear();
+    if (!m_path)
+        return;
+
+    const auto& path = *m_path;
+    traverse([&](const Vec3& nodeMin,
+                 const Vec3& nodeMax) { return overlaps(nodeMin, nodeMax, min, max); },
+             [&](u32 index) {
+                 f32 t0, t1;
+                 if (clipSegment(path[index].start, path[index].end, min, max, t0, t1))
+                     out.push_back(index);
+             });
+    std::sort(out.begin(), out.end());
+}
+
+void SpatialIndex::queryZRange(f32 zMin, f32 zMax, std::vector<u32>& out) const {
+    queryBox(Vec3{-FLT_MAX, -FLT_MAX, zMin}, Vec3{FLT_MAX, FLT_MAX, zMax}, out);
+}
+
+std::optional<SegmentHit> SpatialIndex::pick(const Vec3& origin,
+                                             const Vec3& direction,
+                                             f32 radius,
+                                             bool includeRapids) const {
+    return pickFiltered(origin, direction, radius, [includeRapids](const PathSegment& seg) {
+        return includeRapids || !seg.isRapid;
+    });
+}
+
+std::optional<SegmentHit> SpatialIndex::pickFiltered(
+    const Vec3& origin,
+    const Vec3& direction,
+    f32 radius,
+    const std::function<bool(const PathSegment&)>& accept) const {
+    if (!m_path || glm::dot(direction, direction) <= 0.0f)
+        return std::nullopt;
+
+    const auto& path = *m_path;
+    const Vec3 dir = glm::normalize(direction);
+    const Vec3 invDir = Vec3{1.0f} / dir;
+    const Vec3 pad{radius};
+
+    std::optional<SegmentHit> best;
+    traverse(
+        [&](const Vec3& nodeMin, const Vec3& nodeMax) {
+            f32 entry = rayBoxEntry(origin, invDir, nodeMin - pad, nodeMax + pad);
+            return entry >= 0.0f && (!best || entry <= best->rayT);
+        },
+        [&](u32 index) {
+            const auto& seg = path[index];
+            if (accept && !accept(seg))
+                return;
+            f32 rayT, distance;
+            closestRaySegment(origin, dir, seg.start, seg.end, rayT, distance);
+            if (distance > radius)
+                return;
+            if (!best || rayT < best->rayT || (rayT == best->rayT && index < best->segment))
+                best = SegmentHit{index, rayT, distance};
+        });
+    return best;
+}
+
+SegmentRange SpatialIndex::segmentsForLine(int lineNumber) const {
+    if (!m_path)
+        return {};
+
+    const auto& path = *m_path;
+    auto lower = std::lower_bound(
+        path.begin(), path.end(), lineNumber, [](const PathSegment& seg, int line) {
+            return seg.lineNumber < line;
+        });
+    auto upper = std::upper_bound(
+        lower, path.end(), lineNumber, [](int line, const PathSegment& seg) {
+            return line < seg.lineNumber;
+        });
+    return SegmentRange{static_cast<u32>(lower - path.begin()),
+                        static_cast<u32>(upper - path.begin())};
+}
+
+RegionStats SpatialIndex::measureBox(const Vec3& min, const Vec3& max) const {
+    RegionStats stats;
+    if (!m_path)
+        return stats;
+
+    const auto& path = *m_path;
+    traverse([&](const Vec3& nodeMin,
+                 const Vec3& nodeMax) { return overlaps(nodeMin, nodeMax, min, max); },
+             [&](u32 index) {
+                 const auto& seg = path[index];
+                 f32 t0, t1;
+                 if (!clipSegment(seg.start, seg.end, min, max, t0, t1))
+                     return;
+                 f32 length = glm::length(seg.end - seg.start) * (t1 - t0);
+                 ++stats.segmentCount;
+                 (seg.isRapid ? stats.rapidLength : stats.cuttingLength) += length;
+             });
+    return stats;
+}
+
+} // namespace gcode
+} // namespace dw
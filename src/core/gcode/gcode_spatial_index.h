@@ -0,0 +1,100 @@
+#pragma once
+
+#include <functional>
+#include <optional>
+#include <vector>
+
+#include "../types.h"
+#include "gcode_types.h"
+
+namespace dw {
+namespace gcode {
+
+// Result of SpatialIndex::pick()
+struct SegmentHit {
+    u32 segment = 0;      // Index into Program::path
+    f32 rayT = 0.0f;      // Distance along the (normalized) ray to the closest point
+    f32 distance = 0.0f;  // Ray-to-segment distance at that point
+};
+
+// Half-open range of path indices produced by one source line
+struct SegmentRange {
+    u32 first = 0;
+    u32 last = 0;
+
+    bool empty() const { return last <= first; }
+    u32 size() const { return last > first ? last - first : 0; }
+};
+
+// Totals for the part of the toolpath inside a box (segments clipped to it)
+struct RegionStats {
+    usize segmentCount = 0;
+    f32 cuttingLength = 0.0f;
+    f32 rapidLength = 0.0f;
+};
+
+// Bounding volume hierarchy over Program::path, in program coordinates (Z-up).
+//
+// Segments are sorted along a Morton curve and packed into fixed-size leaves;
+// each upper level groups a fixed number of nodes from the level below. Every
+// stage of the build is a parallelFor over independent ranges, so a 5M-segment
+// program indexes in a fraction of a second and the tree is identical for any
+// thread count.
+//
+// The index keeps a pointer to the program's path: the program must outlive it
+// and the index must be rebuilt when the path changes. Query results are path
+// indices in ascending (program) order.
+class SpatialIndex {
+  public:
+    void build(const Program& program);
+    void clear();
+
+    bool empty() const { return m_levels.empty(); }
+    usize segmentCount() const { return m_order.size(); }
+
+    // Segments with any part inside the box (inclusive)
+    void queryBox(const Vec3& min, const Vec3& max, std::vector<u32>& out) const;
+
+    // Segments with any part in zMin <= z <= zMax
+    void queryZRange(f32 zMin, f32 zMax, std::vector<u32>& out) const;
+
+    // Segment nearest the ray origin among those within `radius` of the ray.
+    // Direction need not be normalized; rapids are skipped unless includeRapids.
+    std::optional<SegmentHit> pick(const Vec3& origin,
+                                   const Vec3& direction,
+                                   f32 radius,
+                                   bool includeRapids = false) const;
+
+    // As pick(), considering only segments `accept` returns true for, so a
+    // visible segment behind a hidden one is still found
+    std::optional<SegmentHit>
+    pickFiltered(const Vec3& origin,
+                 const Vec3& direction,
+                 f32 radius,
+                 const std::function<bool(const PathSegment&)>& accept) const;
+
+    // Path indices generated by a source line (arcs expand to several). The
+    // parser emits the path in source order, so each line's segments are
+    // contiguous and this is a binary search.
+    SegmentRange segmentsForLine(int lineNumber) const;
+
+    // Segment count and clipped cut/rapid lengths inside the box
+    RegionStats measureBox(const Vec3& min, const Vec3& max) const;
+
+  private:
+    struct Node {
+        Vec3 min;
+        Vec3 max;
+    };
+
+    template <typename NodeTest, typename LeafFn>
+    void traverse(NodeTest&& nodeTest, LeafFn&& leafFn) const;
+
+    const std::vector<PathSegment>* m_path = nullptr;
+
+    std::vector<u32> m_order;                // Path indices in Morton order
+    std::vector<std::vector<Node>> m_levels; // [0] = leaves ... back() = root
+};
+
+} // namespace gcode
+} // namespace dw
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <cmath>
 #include <string>
 #include <variant>
@@ -109,6 +110,15 @@ struct Program {
     // Bounds of the toolpath
     Vec3 boundsMin;
     Vec3 boundsMax;
+
+    // Index of the first command at or after a 1-based source line, or
+    // commands.size() past the end. Blank and comment lines produce no
+    // command, so this is a binary search rather than lineNumber - 1.
+    usize commandIndexAtLine(int lineNumber) const {
+        auto it = std::lower_bound(commands.begin(), commands.end(), lineNumber,
+                                   [](const Command& cmd, int line) { return cmd.lineNumber < line; });
+        return static_cast<usize>(it - commands.begin());
+    }
 };
 
 // Statistics about the G-code program
@@ -123,7 +133,7 @@ struct Statistics {
     Vec3 boundsMin;
     Vec3 boundsMax;
 
-    // Per-segment time in seconds (parallel to Program::path)
+    // Per-segment time in minutes (parallel to Program::path)
     std::vector<f32> segmentTimes;
 };
 
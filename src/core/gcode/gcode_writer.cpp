@@ -0,0 +1,180 @@
+#include "gcode_writer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace dw {
+namespace gcode {
+
+namespace {
+
+// Longest line move() writes: motion word, three axes and a feed
+constexpr usize kMaxLineChars = 3 + 4 * (GcodeWriter::kMaxNumberChars + 2) + 1;
+
+// Coordinates past this many thousandths are clamped (well beyond any machine)
+constexpr f64 kMaxThousandths = 1e15;
+
+// A float times 1000 is exact in double, so rounding half to even here gives
+// the same digits as printf("%.3f")
+i64 toThousandths(f32 value)
+{
+    const f64 scaled = static_cast<f64>(value) * 1000.0;
+    if (!std::isfinite(scaled)) return 0;
+    return static_cast<i64>(std::nearbyint(std::clamp(scaled, -kMaxThousandths, kMaxThousandths)));
+}
+
+// Fixed-point digits of `thousandths`: at least one decimal, trailing zeros
+// trimmed (5000 -> "5.0", -125 -> "-0.125")
+char* writeThousandths(char* out, i64 thousandths)
+{
+    u64 magnitude = static_cast<u64>(thousandths);
+    if (thousandths < 0) {
+        *out++ = '-';
+        magnitude = ~magnitude + 1;
+    }
+    u64 whole = magnitude / 1000;
+    const auto frac = static_cast<u32>(magnitude % 1000);
+
+    char digits[20];
+    int count = 0;
+    do {
+        digits[count++] = static_cast<char>('0' + whole % 10);
+        whole /= 10;
+    } while (whole != 0);
+    while (count > 0)
+        *out++ = digits[--count];
+
+    *out++ = '.';
+    *out++ = static_cast<char>('0' + frac / 100);
+    if (frac % 100 != 0) {
+        *out++ = static_cast<char>('0' + frac / 10 % 10);
+        if (frac % 10 != 0) *out++ = static_cast<char>('0' + frac % 10);
+    }
+    return out;
+}
+
+} // namespace
+
+char* GcodeWriter::formatNumber(char* out, f32 value)
+{
+    return writeThousandths(out, toThousandths(value));
+}
+
+std::string GcodeWriter::formatNumber(f32 value)
+{
+    char buf[kMaxNumberChars];
+    return std::string(buf, formatNumber(buf, value));
+}
+
+std::string GcodeWriter::takeText()
+{
+    std::string text = std::move(m_text);
+    m_text.clear();
+    return text;
+}
+
+void GcodeWriter::rapid(const Vec3& pos)
+{
+    move(Motion::Rapid, pos, 0.0f);
+}
+
+void GcodeWriter::linear(const Vec3& pos, f32 feedRate)
+{
+    move(Motion::Linear, pos, feedRate);
+}
+
+void GcodeWriter::retractTo(f32 z)
+{
+    char buf[kMaxLineChars];
+    char* out = buf;
+    *out++ = 'G';
+    *out++ = '0';
+    *out++ = ' ';
+    *out++ = 'Z';
+    m_axis[2] = toThousandths(z);
+    m_axisKnown[2] = true;
+    out = writeThousandths(out, m_axis[2]);
+    *out++ = '\n';
+    m_text.append(buf, out);
+    m_motion = Motion::Rapid;
+}
+
+void GcodeWriter::line(std::string_view text)
+{
+    m_text.append(text);
+    m_text.push_back('\n');
+}
+
+void GcodeWriter::setModalState(const Vec3& pos, bool rapid, f32 feedRate)
+{
+    m_motion = rapid ? Motion::Rapid : Motion::Linear;
+    for (int i = 0; i < 3; ++i) {
+        m_axis[i] = toThousandths(pos[i]);
+        m_axisKnown[i] = true;
+    }
+    if (feedRate > 0.0f) {
+        m_feedRate = feedRate;
+        m_feed = toThousandths(feedRate);
+    } else {
+        m_feedRate = 0.0f;
+        m_feed = -1;
+    }
+}
+
+void GcodeWriter::resetModalState()
+{
+    m_motion = Motion::Unknown;
+    for (bool& known : m_axisKnown) known = false;
+    m_feedRate = 0.0f;
+    m_feed = -1;
+}
+
+void GcodeWriter::move(Motion motion, const Vec3& pos, f32 feedRate)
+{
+    const i64 axis[3] = {toThousandths(pos.x), toThousandths(pos.y), toThousandths(pos.z)};
+    const i64 feed = (motion == Motion::Linear) ? toThousandths(feedRate) : -1;
+
+    bool writeMotion = motion != m_motion;
+    bool writeAxis[3];
+    bool anyAxis = false;
+    for (int i = 0; i < 3; ++i) {
+        writeAxis[i] = !m_axisKnown[i] || axis[i] != m_axis[i];
+        anyAxis = anyAxis || writeAxis[i];
+    }
+    const bool writeFeed = motion == Motion::Linear && feed != m_feed;
+    if (!writeMotion && !anyAxis && !writeFeed) {
+        // Nothing changed: restate the whole move rather than emit a blank line
+        writeMotion = true;
+        writeAxis[0] = writeAxis[1] = writeAxis[2] = true;
+    }
+
+    char buf[kMaxLineChars];
+    char* out = buf;
+    if (writeMotion) {
+        *out++ = 'G';
+        *out++ = (motion == Motion::Rapid) ? '0' : '1';
+    }
+    static constexpr char kAxisNames[3] = {'X', 'Y', 'Z'};
+    for (int i = 0; i < 3; ++i) {
+        if (!writeAxis[i]) continue;
+        if (out != buf) *out++ = ' ';
+        *out++ = kAxisNames[i];
+        out = writeThousandths(out, axis[i]);
+        m_axis[i] = axis[i];
+        m_axisKnown[i] = true;
+    }
+    if (writeFeed) {
+        if (out != buf) *out++ = ' ';
+        *out++ = 'F';
+        out = writeThousandths(out, feed);
+        m_feed = feed;
+        m_feedRate = feedRate;
+    }
+    *out++ = '\n';
+    m_text.append(buf, out);
+    m_motion = motion;
+}
+
+} // namespace gcode
+} // namespace dw
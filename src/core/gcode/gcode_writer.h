@@ -0,0 +1,70 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "../types.h"
+
+namespace dw {
+namespace gcode {
+
+// Appends G-code text for linear moves. Numbers are fixed-point with three
+// decimals and trailing zeros trimmed ("5.0", "-0.125"), formatted from
+// integers rather than printf. Modal words are suppressed: after the first
+// move sets them, the motion word, unchanged axis words (equal at output
+// precision) and an unchanged feed are left out. A move that would leave
+// nothing to write is written in full. Every call appends exactly one line.
+class GcodeWriter {
+  public:
+    // Longest number formatNumber() writes, without terminator
+    static constexpr usize kMaxNumberChars = 24;
+
+    GcodeWriter() = default;
+
+    void rapid(const Vec3& pos);
+    void linear(const Vec3& pos, f32 feedRate);
+
+    // "G0 Z<z>", always with the motion word; X and Y are left as they were
+    void retractTo(f32 z);
+
+    // Verbatim line (comments, M codes); modal state is not touched
+    void line(std::string_view text);
+    // Text formatted by another writer, e.g. a chunk done in parallel; modal
+    // state is not touched, so set it to where that text leaves off
+    void append(std::string_view text) { m_text.append(text); }
+
+    // Continue from a known machine state, e.g. when formatting one chunk of
+    // a longer program; feedRate <= 0 means no feed has been set yet
+    void setModalState(const Vec3& pos, bool rapid, f32 feedRate);
+    // Forget everything: the next move writes every word
+    void resetModalState();
+
+    // Modal feed rate so far (0 when none has been written)
+    f32 feedRate() const { return m_feedRate; }
+
+    const std::string& text() const { return m_text; }
+    // Drop the text but keep the modal state and the buffer's capacity
+    void clear() { m_text.clear(); }
+    void reserve(usize bytes) { m_text.reserve(bytes); }
+    std::string takeText();
+
+    // Write `value` to `out` (room for kMaxNumberChars), return the end
+    static char* formatNumber(char* out, f32 value);
+    static std::string formatNumber(f32 value);
+
+  private:
+    enum class Motion : u8 { Unknown, Rapid, Linear };
+
+    void move(Motion motion, const Vec3& pos, f32 feedRate);
+    void appendNumber(char axis, i64 thousandths);
+
+    std::string m_text;
+    Motion m_motion = Motion::Unknown;
+    bool m_axisKnown[3] = {false, false, false};
+    i64 m_axis[3] = {0, 0, 0}; // Last written position in thousandths of a unit
+    f32 m_feedRate = 0.0f;
+    i64 m_feed = -1; // Last written feed in thousandths, -1 when unset
+};
+
+} // namespace gcode
+} // namespace dw
@@ -9,10 +9,13 @@
 #include "../loaders/gcode_loader.h"
 #include "../loaders/loader_factory.h"
 #include "../mesh/hash.h"
+#include "../mesh/mesh_cache.h"
+#include "../mesh/mesh_optimizer.h"
 #include "../paths/path_resolver.h"
 #include "../storage/storage_manager.h"
 #include "../utils/file_utils.h"
 #include "../utils/log.h"
+#include "../utils/trace.h"
 #include "file_validator.h"
 #include "import_log.h"
 
@@ -144,6 +147,10 @@ void ImportQueue::setImportLog(ImportLog* log) {
     m_importLog = log;
 }
 
+void ImportQueue::setMeshCache(MeshCache* cache) {
+    m_meshCache = cache;
+}
+
 void ImportQueue::setQueueForTagging(bool enabled) {
     m_queueForTagging = enabled;
 }
@@ -202,6 +209,7 @@ void ImportQueue::checkBatchComplete() {
 // --- Pipeline stage functions (runs on ThreadPool worker) ---
 
 bool ImportQueue::stageReadFile(ImportTask& task) {
+    DW_TRACE_ZONE("Import: read");
     task.stage = ImportStage::Reading;
     m_progress.currentStage.store(ImportStage::Reading);
 
@@ -215,6 +223,7 @@ bool ImportQueue::stageReadFile(ImportTask& task) {
 }
 
 bool ImportQueue::stageValidate(ImportTask& task) {
+    DW_TRACE_ZONE("Import: validate");
     task.stage = ImportStage::Validating;
     m_progress.currentStage.store(ImportStage::Validating);
 
@@ -227,6 +236,7 @@ bool ImportQueue::stageValidate(ImportTask& task) {
 }
 
 void ImportQueue::stageComputeHash(ImportTask& task) {
+    DW_TRACE_ZONE("Import: hash");
     task.stage = ImportStage::Hashing;
     m_progress.currentStage.store(ImportStage::Hashing);
 
@@ -234,6 +244,7 @@ void ImportQueue::stageComputeHash(ImportTask& task) {
 }
 
 bool ImportQueue::stageCheckDuplicate(ImportTask& task, TaskContext& ctx) {
+    DW_TRACE_ZONE("Import: duplicate check");
     task.stage = ImportStage::CheckingDuplicate;
     m_progress.currentStage.store(ImportStage::CheckingDuplicate);
 
@@ -291,6 +302,7 @@ bool ImportQueue::stageCheckDuplicate(ImportTask& task, TaskContext& ctx) {
 }
 
 bool ImportQueue::stageParse(ImportTask& task) {
+    DW_TRACE_ZONE("Import: parse");
     task.stage = ImportStage::Parsing;
     m_progress.currentStage.store(ImportStage::Parsing);
 
@@ -316,7 +328,30 @@ bool ImportQueue::stageParse(ImportTask& task) {
     return true;
 }
 
+void ImportQueue::stageOptimize(ImportTask& task) {
+    DW_TRACE_ZONE("Import: optimize");
+    if (task.importType == ImportType::GCode || !task.mesh || !task.mesh->isValid())
+        return;
+
+    task.stage = ImportStage::Optimizing;
+    m_progress.currentStage.store(ImportStage::Optimizing);
+
+    auto stats = mesh_opt::optimize(*task.mesh);
+    log::infof("Import",
+               "Optimized %s: %u -> %u vertices, ACMR %.2f -> %.2f",
+               task.sourcePath.filename().string().c_str(),
+               stats.verticesBefore,
+               stats.verticesAfter,
+               static_cast<double>(stats.acmrBefore),
+               static_cast<double>(stats.acmrAfter));
+
+    // Best effort: a failed write only costs a re-optimize on next load
+    if (m_meshCache && !task.fileHash.empty())
+        (void)m_meshCache->store(task.fileHash, *task.mesh);
+}
+
 bool ImportQueue::stageInsertGCode(ImportTask& task, TaskContext& ctx, u64 fileSize) {
+    DW_TRACE_ZONE("Import: insert G-code");
     auto mode = m_batchMode;
 
     GCodeRecord record;
@@ -398,6 +433,7 @@ bool ImportQueue::stageInsertGCode(ImportTask& task, TaskContext& ctx, u64 fileS
 }
 
 bool ImportQueue::stageInsertMesh(ImportTask& task, TaskContext& ctx, u64 fileSize) {
+    DW_TRACE_ZONE("Import: insert mesh");
     auto mode = m_batchMode;
 
     // Precompute autoOrient on the worker thread (pure CPU, no GL)
@@ -454,6 +490,7 @@ bool ImportQueue::stageInsertMesh(ImportTask& task, TaskContext& ctx, u64 fileSi
 }
 
 void ImportQueue::stageHandleFile(ImportTask& task, TaskContext& ctx) {
+    DW_TRACE_ZONE("Import: handle file");
     auto mode = m_batchMode;
 
     if (m_storageManager && mode != FileHandlingMode::LeaveInPlace) {
@@ -526,6 +563,7 @@ void ImportQueue::stageHandleFile(ImportTask& task, TaskContext& ctx) {
 }
 
 void ImportQueue::stageFinalize(ImportTask& task) {
+    DW_TRACE_ZONE("Import: finalize");
     // Log successful import
     if (m_importLog)
         m_importLog->appendDone(task.sourcePath, task.fileHash);
@@ -551,6 +589,7 @@ void ImportQueue::stageFinalize(ImportTask& task) {
 // --- Worker task processing (runs on ThreadPool worker) ---
 
 void ImportQueue::processTask(ImportTask task) {
+    DW_TRACE_ZONE("Import task");
     // Check for cancellation at start
     if (m_cancelRequested.load()) {
         failTask(task, "Cancelled");
@@ -582,6 +621,9 @@ void ImportQueue::processTask(ImportTask task) {
     if (!stageParse(task))
         return;
 
+    // Stage 5.1: Weld and reorder mesh for rendering, persist to the mesh cache
+    stageOptimize(task);
+
     // Capture file size before releasing buffer
     u64 actualFileSize = static_cast<u64>(task.fileData.size());
 
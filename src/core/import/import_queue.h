@@ -16,6 +16,7 @@ namespace dw {
 // Forward declarations
 class ImportLog;
 class LibraryManager;
+class MeshCache;
 class StorageManager;
 
 class ImportQueue {
@@ -63,6 +64,9 @@ class ImportQueue {
     // Import log for resume/revert support
     void setImportLog(ImportLog* log);
 
+    // Cache for optimized meshes (optional, owned externally)
+    void setMeshCache(MeshCache* cache);
+
     // Tag queueing mode
     void setQueueForTagging(bool enabled);
     bool queueForTagging() const;
@@ -84,6 +88,7 @@ class ImportQueue {
     void stageComputeHash(ImportTask& task);
     bool stageCheckDuplicate(ImportTask& task, TaskContext& ctx);
     bool stageParse(ImportTask& task);
+    void stageOptimize(ImportTask& task);
     bool stageInsertGCode(ImportTask& task, TaskContext& ctx, u64 fileSize);
     bool stageInsertMesh(ImportTask& task, TaskContext& ctx, u64 fileSize);
     void stageHandleFile(ImportTask& task, TaskContext& ctx);
@@ -92,6 +97,7 @@ class ImportQueue {
     ConnectionPool& m_pool;
     LibraryManager* m_libraryManager; // Optional, for auto-detect
     StorageManager* m_storageManager; // Optional, for CAS blob storage
+    MeshCache* m_meshCache = nullptr; // Optional, persists optimized meshes
 
     // Thread management
     std::unique_ptr<ThreadPool> m_threadPool; // Lazily created
@@ -33,6 +33,7 @@ enum class ImportStage {
     Hashing,
     CheckingDuplicate,
     Parsing,
+    Optimizing, // Weld + reorder for rendering (mesh imports only)
     Inserting,
     WaitingForThumbnail, // Handed off to main thread for GL work
     Done,
@@ -143,6 +144,8 @@ inline const char* importStageName(ImportStage stage) {
         return "Checking duplicates";
     case ImportStage::Parsing:
         return "Parsing mesh";
+    case ImportStage::Optimizing:
+        return "Optimizing mesh";
     case ImportStage::Inserting:
         return "Saving to library";
     case ImportStage::WaitingForThumbnail:
@@ -4,13 +4,26 @@
 #include "../graph/graph_manager.h"
 #include "../loaders/loader_factory.h"
 #include "../mesh/hash.h"
+#include "../mesh/mesh_cache.h"
+#include "../mesh/mesh_optimizer.h"
 #include "../paths/app_paths.h"
 #include "../paths/path_resolver.h"
 #include "../utils/file_utils.h"
 #include "../utils/log.h"
+#include "../utils/string_utils.h"
 
 namespace dw {
 
+namespace {
+
+// G-code toolpaths are line geometry for the viewer; welding would corrupt them
+bool isToolpathFormat(const std::string& format) {
+    std::string lower = str::toLower(format);
+    return lower == "gcode" || lower == "nc" || lower == "ngc" || lower == "tap";
+}
+
+} // namespace
+
 LibraryManager::LibraryManager(Database& db) : m_db(db), m_modelRepo(db), m_gcodeRepo(db) {}
 
 ImportResult LibraryManager::importModel(const Path& sourcePath) {
@@ -59,6 +72,7 @@ ImportResult LibraryManager::importModel(const Path& sourcePath) {
     }
 
     MeshPtr mesh = loadResult.mesh;
+    prepareMesh(fileHash, file::getExtension(sourcePath), *mesh);
 
     // Create model record
     ModelRecord record;
@@ -115,6 +129,15 @@ std::vector<ModelRecord> LibraryManager::searchModels(const std::string& query)
     return m_modelRepo.findByName(query);
 }
 
+ModelPage LibraryManager::getModelPage(const ModelPageQuery& query) {
+    return m_modelRepo.findPage(query);
+}
+
+std::optional<ModelSummary> LibraryManager::getModelSummary(i64 modelId,
+                                                            const ModelPageQuery& filter) {
+    return m_modelRepo.findSummary(modelId, filter);
+}
+
 std::optional<ModelRecord> LibraryManager::getModel(i64 modelId) {
     return m_modelRepo.findById(modelId);
 }
@@ -132,16 +155,35 @@ MeshPtr LibraryManager::loadMesh(i64 modelId) {
 }
 
 MeshPtr LibraryManager::loadMesh(const ModelRecord& record) {
+    // Optimized copy from a previous import/load skips parsing entirely
+    if (m_meshCache && !isToolpathFormat(record.fileFormat)) {
+        if (auto cached = m_meshCache->load(record.hash)) {
+            cached->setName(record.name);
+            return cached;
+        }
+    }
+
     auto loadResult = LoaderFactory::load(PathResolver::resolve(record.filePath, PathCategory::Support));
     if (!loadResult) {
         log::errorf("Library", "Failed to load mesh: %s", loadResult.error.c_str());
         return nullptr;
     }
 
+    prepareMesh(record.hash, record.fileFormat, *loadResult.mesh);
     loadResult.mesh->setName(record.name);
     return loadResult.mesh;
 }
 
+void LibraryManager::prepareMesh(const std::string& hash, const std::string& format, Mesh& mesh) {
+    if (isToolpathFormat(format) || !mesh.isValid()) {
+        return;
+    }
+    mesh_opt::optimize(mesh);
+    if (m_meshCache && !hash.empty()) {
+        (void)m_meshCache->store(hash, mesh);
+    }
+}
+
 bool LibraryManager::updateModel(const ModelRecord& record) {
     return m_modelRepo.update(record);
 }
@@ -161,6 +203,10 @@ bool LibraryManager::removeModel(i64 modelId) {
         (void)file::remove(record->thumbnailPath);
     }
 
+    if (m_meshCache) {
+        (void)m_meshCache->remove(record->hash);
+    }
+
     // Dual-write: remove graph node (non-fatal)
     if (m_graphManager && m_graphManager->isAvailable()) {
         m_graphManager->removeModelNode(modelId);
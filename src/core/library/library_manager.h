@@ -18,6 +18,7 @@ namespace dw {
 class ThumbnailGenerator;
 class Texture;
 class GraphManager;
+class MeshCache;
 
 // Report returned by library maintenance operations
 struct MaintenanceReport {
@@ -50,6 +51,12 @@ class LibraryManager {
     // Search models by name
     std::vector<ModelRecord> searchModels(const std::string& query);
 
+    // Paged summary rows for list views (keyset pagination, see ModelPageQuery)
+    ModelPage getModelPage(const ModelPageQuery& query);
+
+    // Summary for one model if it still passes the list filter (for in-place patching)
+    std::optional<ModelSummary> getModelSummary(i64 modelId, const ModelPageQuery& filter);
+
     // Get a single model record
     std::optional<ModelRecord> getModel(i64 modelId);
 
@@ -83,6 +90,9 @@ class LibraryManager {
     // Set graph manager for dual-write (optional, owned externally)
     void setGraphManager(GraphManager* gm) { m_graphManager = gm; }
 
+    // Set cache of import-optimized meshes (optional, owned externally)
+    void setMeshCache(MeshCache* cache) { m_meshCache = cache; }
+
     // Generate thumbnail and update DB record
     bool generateThumbnail(i64 modelId,
                            const Mesh& mesh,
@@ -140,12 +150,16 @@ class LibraryManager {
   private:
     std::string computeFileHash(const Path& path);
 
+    // Optimize a freshly parsed mesh in place and write it to the mesh cache
+    void prepareMesh(const std::string& hash, const std::string& format, Mesh& mesh);
+
     Database& m_db;
     ModelRepository m_modelRepo;
     GCodeRepository m_gcodeRepo;
     DuplicateHandler m_duplicateHandler;
     ThumbnailGenerator* m_thumbnailGen = nullptr;
     GraphManager* m_graphManager = nullptr;
+    MeshCache* m_meshCache = nullptr;
 };
 
 } // namespace dw
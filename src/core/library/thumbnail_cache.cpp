@@ -0,0 +1,651 @@
+#include "thumbnail_cache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include <miniz.h>
+
+#include "../utils/file_utils.h"
+#include "../utils/log.h"
+
+namespace dw {
+
+namespace {
+
+constexpr usize kFileHeaderSize = 8;   // magic + version
+constexpr usize kRecordHeaderSize = 28; // modelId + fileSize + mtime + levelCount
+constexpr usize kLevelHeaderSize = 8;   // width + height + compressedSize
+constexpr u32 kMaxLevels = 16;
+constexpr int kMaxDimension = 4096;
+// Compact on open once dead records are a quarter of the file and worth a rewrite
+constexpr u64 kCompactMinDeadBytes = 64 * 1024;
+
+template <typename T>
+void putLE(ByteBuffer& out, T value) {
+    for (usize i = 0; i < sizeof(T); ++i) {
+        out.push_back(static_cast<u8>((static_cast<u64>(value) >> (8 * i)) & 0xFF));
+    }
+}
+
+template <typename T>
+T getLE(const u8* in) {
+    u64 v = 0;
+    for (usize i = 0; i < sizeof(T); ++i) {
+        v |= static_cast<u64>(in[i]) << (8 * i);
+    }
+    return static_cast<T>(v);
+}
+
+} // namespace
+
+// --- Decode / mip helpers ---
+
+namespace thumbnail {
+
+std::optional<ThumbnailImage> decodeTGA(const Path& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        log::warningf("Thumbnail", "Failed to open TGA file: %s", path.string().c_str());
+        return std::nullopt;
+    }
+
+    u8 header[18];
+    file.read(reinterpret_cast<char*>(header), 18);
+    if (!file) {
+        log::warningf("Thumbnail", "Failed to read TGA header: %s", path.string().c_str());
+        return std::nullopt;
+    }
+
+    // Uncompressed true-color (type 2), 32bpp
+    if (header[2] != 2 || header[16] != 32) {
+        log::warningf("Thumbnail",
+                      "Unsupported TGA format (type=%d, bpp=%d): %s",
+                      header[2],
+                      header[16],
+                      path.string().c_str());
+        return std::nullopt;
+    }
+
+    int width = header[12] | (header[13] << 8);
+    int height = header[14] | (header[15] << 8);
+    if (width <= 0 || height <= 0 || width > kMaxDimension || height > kMaxDimension) {
+        log::warningf("Thumbnail",
+                      "Invalid TGA dimensions (%dx%d): %s",
+                      width,
+                      height,
+                      path.string().c_str());
+        return std::nullopt;
+    }
+
+    // Skip the optional image ID field
+    if (header[0] > 0) {
+        file.seekg(header[0], std::ios::cur);
+    }
+
+    ThumbnailImage img;
+    img.width = width;
+    img.height = height;
+    usize pixelCount = static_cast<usize>(width) * static_cast<usize>(height);
+    img.rgba.resize(pixelCount * 4);
+    file.read(reinterpret_cast<char*>(img.rgba.data()),
+              static_cast<std::streamsize>(img.rgba.size()));
+    if (!file) {
+        log::warningf("Thumbnail", "Failed to read TGA pixel data: %s", path.string().c_str());
+        return std::nullopt;
+    }
+
+    // BGRA -> RGBA, one 32-bit word per pixel (swap bytes 0 and 2)
+    u8* px = img.rgba.data();
+    for (usize i = 0; i < pixelCount; ++i, px += 4) {
+        u32 w;
+        std::memcpy(&w, px, 4);
+        w = (w & 0xFF00FF00u) | ((w >> 16) & 0xFFu) | ((w & 0xFFu) << 16);
+        std::memcpy(px, &w, 4);
+    }
+
+    return img;
+}
+
+std::vector<ThumbnailImage> buildMipChain(ThumbnailImage base, int minSize) {
+    std::vector<ThumbnailImage> chain;
+    if (!base.isValid()) {
+        return chain;
+    }
+    chain.push_back(std::move(base));
+
+    while (true) {
+        const ThumbnailImage& src = chain.back();
+        int w = src.width / 2;
+        int h = src.height / 2;
+        if (w < minSize || h < minSize || w < 1 || h < 1) {
+            break;
+        }
+
+        ThumbnailImage dst;
+        dst.width = w;
+        dst.height = h;
+        dst.rgba.resize(static_cast<usize>(w) * static_cast<usize>(h) * 4);
+
+        usize srcStride = static_cast<usize>(src.width) * 4;
+        for (int y = 0; y < h; ++y) {
+            const u8* row0 = src.rgba.data() + static_cast<usize>(y * 2) * srcStride;
+            const u8* row1 = row0 + srcStride;
+            u8* out = dst.rgba.data() + static_cast<usize>(y) * static_cast<usize>(w) * 4;
+            for (int x = 0; x < w; ++x) {
+                usize o = static_cast<usize>(x) * 8;
+                for (usize c = 0; c < 4; ++c) {
+                    u32 sum = static_cast<u32>(row0[o + c]) + row0[o + 4 + c] + row1[o + c] +
+                              row1[o + 4 + c];
+                    out[static_cast<usize>(x) * 4 + c] = static_cast<u8>((sum + 2) / 4);
+                }
+            }
+        }
+        chain.push_back(std::move(dst));
+    }
+    return chain;
+}
+
+usize selectMipLevel(const std::vector<int>& levelWidths, float displaySize) {
+    if (levelWidths.empty()) {
+        return 0;
+    }
+    usize best = 0;
+    for (usize i = 0; i < levelWidths.size(); ++i) {
+        if (static_cast<float>(levelWidths[i]) >= displaySize) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+} // namespace thumbnail
+
+// --- ThumbnailStamp ---
+
+std::optional<ThumbnailStamp> ThumbnailStamp::fromFile(const Path& path) {
+    std::error_code ec;
+    auto size = fs::file_size(path, ec);
+    if (ec) {
+        return std::nullopt;
+    }
+    auto mtime = fs::last_write_time(path, ec);
+    if (ec) {
+        return std::nullopt;
+    }
+    ThumbnailStamp stamp;
+    stamp.fileSize = static_cast<u64>(size);
+    stamp.modifiedTime = static_cast<i64>(mtime.time_since_epoch().count());
+    return stamp;
+}
+
+// --- ThumbnailAtlas ---
+
+bool ThumbnailAtlas::open(const Path& path) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_path = path;
+    m_index.clear();
+    m_fileBytes = 0;
+    m_deadBytes = 0;
+    m_open = false;
+
+    if (!file::exists(path)) {
+        (void)file::createDirectories(path.parent_path());
+        ByteBuffer header;
+        putLE<u32>(header, Magic);
+        putLE<u32>(header, Version);
+        if (!file::writeBinary(path, header)) {
+            log::warningf("Thumbnail", "Failed to create cache file: %s", path.string().c_str());
+            return false;
+        }
+    }
+
+    m_open = scanLocked();
+    if (m_open && m_deadBytes >= kCompactMinDeadBytes && m_deadBytes * 4 >= m_fileBytes) {
+        log::infof("Thumbnail", "Compacting thumbnail cache (%llu of %llu bytes unused)",
+                   static_cast<unsigned long long>(m_deadBytes),
+                   static_cast<unsigned long long>(m_fileBytes));
+        (void)compactLocked();
+    }
+    return m_open;
+}
+
+bool ThumbnailAtlas::isOpen() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_open;
+}
+
+bool ThumbnailAtlas::scanLocked() {
+    std::ifstream in(m_path, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+
+    u8 header[kFileHeaderSize];
+    in.read(reinterpret_cast<char*>(header), kFileHeaderSize);
+    if (!in || getLE<u32>(header) != Magic || getLE<u32>(header + 4) != Version) {
+        // Unknown or outdated cache: start over
+        in.close();
+        log::infof("Thumbnail", "Resetting thumbnail cache: %s", m_path.string().c_str());
+        ByteBuffer fresh;
+        putLE<u32>(fresh, Magic);
+        putLE<u32>(fresh, Version);
+        if (!file::writeBinary(m_path, fresh)) {
+            return false;
+        }
+        m_fileBytes = kFileHeaderSize;
+        return true;
+    }
+
+    std::error_code ec;
+    u64 totalSize = static_cast<u64>(fs::file_size(m_path, ec));
+    if (ec) {
+        return false;
+    }
+
+    u64 offset = kFileHeaderSize;
+    while (offset < totalSize) {
+        u8 rec[kRecordHeaderSize];
+        in.read(reinterpret_cast<char*>(rec), kRecordHeaderSize);
+        if (!in) {
+            break; // Truncated record header
+        }
+
+        i64 modelId = getLE<i64>(rec);
+        IndexEntry entry;
+        entry.stamp.fileSize = getLE<u64>(rec + 8);
+        entry.stamp.modifiedTime = getLE<i64>(rec + 16);
+        u32 levelCount = getLE<u32>(rec + 24);
+        if (levelCount > kMaxLevels) {
+            break; // Corrupt
+        }
+
+        entry.recordOffset = offset;
+        u64 cursor = offset + kRecordHeaderSize + u64{levelCount} * kLevelHeaderSize;
+        bool ok = true;
+        for (u32 l = 0; l < levelCount; ++l) {
+            u8 lh[kLevelHeaderSize];
+            in.read(reinterpret_cast<char*>(lh), kLevelHeaderSize);
+            if (!in) {
+                ok = false;
+                break;
+            }
+            LevelInfo info;
+            info.width = getLE<u16>(lh);
+            info.height = getLE<u16>(lh + 2);
+            info.compressedSize = getLE<u32>(lh + 4);
+            info.dataOffset = cursor;
+            cursor += info.compressedSize;
+            entry.levels.push_back(info);
+        }
+        if (!ok) {
+            break;
+        }
+
+        // Skip the payload, verifying it is fully present
+        if (cursor > totalSize) {
+            break; // Truncated payload (interrupted write)
+        }
+        in.seekg(static_cast<std::streamoff>(cursor));
+        entry.recordSize = cursor - offset;
+
+        auto existing = m_index.find(modelId);
+        if (existing != m_index.end()) {
+            m_deadBytes += existing->second.recordSize;
+            m_index.erase(existing);
+        }
+        if (levelCount == 0) {
+            m_deadBytes += entry.recordSize; // Tombstone
+        } else {
+            m_index[modelId] = std::move(entry);
+        }
+        offset = cursor;
+    }
+
+    // Drop any partially written tail so future appends start on a record boundary
+    if (totalSize != offset) {
+        in.close();
+        fs::resize_file(m_path, offset, ec);
+    }
+    m_fileBytes = offset;
+    return true;
+}
+
+bool ThumbnailAtlas::store(i64 modelId,
+                           const ThumbnailStamp& stamp,
+                           const std::vector<ThumbnailImage>& levels) {
+    if (levels.empty() || levels.size() > kMaxLevels) {
+        return false;
+    }
+
+    // Compress outside the lock; only the append is serialized
+    std::vector<ByteBuffer> payloads;
+    payloads.reserve(levels.size());
+    for (const auto& img : levels) {
+        if (!img.isValid() || img.width > kMaxDimension || img.height > kMaxDimension) {
+            return false;
+        }
+        mz_ulong bound = mz_compressBound(static_cast<mz_ulong>(img.rgba.size()));
+        ByteBuffer out(static_cast<usize>(bound));
+        mz_ulong outLen = bound;
+        if (mz_compress2(out.data(),
+                         &outLen,
+                         img.rgba.data(),
+                         static_cast<mz_ulong>(img.rgba.size()),
+                         MZ_BEST_SPEED) != MZ_OK) {
+            return false;
+        }
+        out.resize(static_cast<usize>(outLen));
+        payloads.push_back(std::move(out));
+    }
+
+    ByteBuffer record;
+    putLE<i64>(record, modelId);
+    putLE<u64>(record, stamp.fileSize);
+    putLE<i64>(record, stamp.modifiedTime);
+    putLE<u32>(record, static_cast<u32>(levels.size()));
+    for (usize i = 0; i < levels.size(); ++i) {
+        putLE<u16>(record, static_cast<u16>(levels[i].width));
+        putLE<u16>(record, static_cast<u16>(levels[i].height));
+        putLE<u32>(record, static_cast<u32>(payloads[i].size()));
+    }
+    usize headerBytes = record.size();
+    for (const auto& p : payloads) {
+        record.insert(record.end(), p.begin(), p.end());
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_open) {
+        return false;
+    }
+
+    std::ofstream out(m_path, std::ios::binary | std::ios::app);
+    if (!out) {
+        return false;
+    }
+    out.write(reinterpret_cast<const char*>(record.data()),
+              static_cast<std::streamsize>(record.size()));
+    out.flush();
+    if (!out) {
+        log::warning("Thumbnail", "Failed to append to thumbnail cache");
+        return false;
+    }
+
+    IndexEntry entry;
+    entry.stamp = stamp;
+    entry.recordOffset = m_fileBytes;
+    entry.recordSize = record.size();
+    u64 cursor = m_fileBytes + headerBytes;
+    for (usize i = 0; i < levels.size(); ++i) {
+        LevelInfo info;
+        info.width = static_cast<u16>(levels[i].width);
+        info.height = static_cast<u16>(levels[i].height);
+        info.compressedSize = static_cast<u32>(payloads[i].size());
+        info.dataOffset = cursor;
+        cursor += info.compressedSize;
+        entry.levels.push_back(info);
+    }
+
+    auto existing = m_index.find(modelId);
+    if (existing != m_index.end()) {
+        m_deadBytes += existing->second.recordSize;
+    }
+    m_index[modelId] = std::move(entry);
+    m_fileBytes += record.size();
+    return true;
+}
+
+const ThumbnailAtlas::IndexEntry* ThumbnailAtlas::findLocked(i64 modelId,
+                                                             const ThumbnailStamp& stamp) const {
+    auto it = m_index.find(modelId);
+    if (it == m_index.end() || !(it->second.stamp == stamp)) {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+std::vector<int> ThumbnailAtlas::levelWidths(i64 modelId, const ThumbnailStamp& stamp) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<int> widths;
+    if (const auto* entry = findLocked(modelId, stamp)) {
+        for (const auto& l : entry->levels) {
+            widths.push_back(l.width);
+        }
+    }
+    return widths;
+}
+
+std::optional<ThumbnailImage> ThumbnailAtlas::load(i64 modelId,
+                                                   const ThumbnailStamp& stamp,
+                                                   usize level) const {
+    LevelInfo info;
+    ByteBuffer compressed;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const auto* entry = findLocked(modelId, stamp);
+        if (!entry || level >= entry->levels.size()) {
+            return std::nullopt;
+        }
+        info = entry->levels[level];
+
+        std::ifstream in(m_path, std::ios::binary);
+        if (!in) {
+            return std::nullopt;
+        }
+        in.seekg(static_cast<std::streamoff>(info.dataOffset));
+        compressed.resize(info.compressedSize);
+        in.read(reinterpret_cast<char*>(compressed.data()),
+                static_cast<std::streamsize>(compressed.size()));
+        if (!in) {
+            return std::nullopt;
+        }
+    }
+
+    ThumbnailImage img;
+    img.width = info.width;
+    img.height = info.height;
+    img.rgba.resize(static_cast<usize>(info.width) * info.height * 4);
+    mz_ulong outLen = static_cast<mz_ulong>(img.rgba.size());
+    if (mz_uncompress(img.rgba.data(),
+                      &outLen,
+                      compressed.data(),
+                      static_cast<mz_ulong>(compressed.size())) != MZ_OK ||
+        outLen != img.rgba.size()) {
+        log::warningf("Thumbnail", "Corrupt cached thumbnail for model %lld",
+                      static_cast<long long>(modelId));
+        return std::nullopt;
+    }
+    return img;
+}
+
+void ThumbnailAtlas::invalidate(i64 modelId) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_index.find(modelId);
+    if (it == m_index.end()) {
+        return;
+    }
+    m_deadBytes += it->second.recordSize;
+    m_index.erase(it);
+
+    // Append a tombstone (zero levels) so the removal survives a restart
+    ByteBuffer record;
+    putLE<i64>(record, modelId);
+    putLE<u64>(record, 0);
+    putLE<i64>(record, 0);
+    putLE<u32>(record, 0);
+    std::ofstream out(m_path, std::ios::binary | std::ios::app);
+    if (out) {
+        out.write(reinterpret_cast<const char*>(record.data()),
+                  static_cast<std::streamsize>(record.size()));
+        if (out) {
+            m_fileBytes += record.size();
+            m_deadBytes += record.size();
+        }
+    }
+}
+
+bool ThumbnailAtlas::compact() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_open) {
+        return false;
+    }
+    return compactLocked();
+}
+
+bool ThumbnailAtlas::compactLocked() {
+    Path tmpPath = m_path;
+    tmpPath += ".tmp";
+
+    // New record offsets, applied to the index only once the rewritten file
+    // has replaced the old one
+    std::vector<std::pair<IndexEntry*, u64>> moved;
+    moved.reserve(m_index.size());
+    u64 offset = kFileHeaderSize;
+    bool ok = true;
+    {
+        std::ifstream in(m_path, std::ios::binary);
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!in || !out) {
+            return false;
+        }
+
+        ByteBuffer header;
+        putLE<u32>(header, Magic);
+        putLE<u32>(header, Version);
+        out.write(reinterpret_cast<const char*>(header.data()),
+                  static_cast<std::streamsize>(header.size()));
+
+        ByteBuffer buf;
+        for (auto& [id, entry] : m_index) {
+            buf.resize(static_cast<usize>(entry.recordSize));
+            in.seekg(static_cast<std::streamoff>(entry.recordOffset));
+            in.read(reinterpret_cast<char*>(buf.data()), static_cast<std::streamsize>(buf.size()));
+            if (!in) {
+                ok = false;
+                break;
+            }
+            out.write(reinterpret_cast<const char*>(buf.data()),
+                      static_cast<std::streamsize>(buf.size()));
+            moved.emplace_back(&entry, offset);
+            offset += entry.recordSize;
+        }
+        ok = ok && static_cast<bool>(out);
+    }
+
+    std::error_code ec;
+    if (ok) {
+        fs::rename(tmpPath, m_path, ec);
+    }
+    if (!ok || ec) {
+        log::warningf("Thumbnail", "Failed to compact cache: %s",
+                      ec ? ec.message().c_str() : "read/write error");
+        fs::remove(tmpPath, ec);
+        return false;
+    }
+
+    for (auto& [entry, newOffset] : moved) {
+        i64 delta = static_cast<i64>(newOffset) - static_cast<i64>(entry->recordOffset);
+        entry->recordOffset = newOffset;
+        for (auto& l : entry->levels) {
+            l.dataOffset = static_cast<u64>(static_cast<i64>(l.dataOffset) + delta);
+        }
+    }
+    m_fileBytes = offset;
+    m_deadBytes = 0;
+    return true;
+}
+
+usize ThumbnailAtlas::entryCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_index.size();
+}
+
+u64 ThumbnailAtlas::fileBytes() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_fileBytes;
+}
+
+u64 ThumbnailAtlas::deadBytes() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_deadBytes;
+}
+
+// --- ThumbnailLru ---
+
+const ThumbnailLru::Entry* ThumbnailLru::touch(i64 modelId) {
+    auto it = m_map.find(modelId);
+    if (it == m_map.end()) {
+        return nullptr;
+    }
+    m_order.splice(m_order.begin(), m_order, it->second);
+    return &it->second->second;
+}
+
+const ThumbnailLru::Entry* ThumbnailLru::peek(i64 modelId) const {
+    auto it = m_map.find(modelId);
+    return (it != m_map.end()) ? &it->second->second : nullptr;
+}
+
+std::vector<u32> ThumbnailLru::insert(i64 modelId, Entry entry) {
+    std::vector<u32> released;
+    auto it = m_map.find(modelId);
+    if (it != m_map.end()) {
+        if (it->second->second.handle != 0 && it->second->second.handle != entry.handle) {
+            released.push_back(it->second->second.handle);
+        }
+        it->second->second = entry;
+        m_order.splice(m_order.begin(), m_order, it->second);
+    } else {
+        m_order.emplace_front(modelId, entry);
+        m_map[modelId] = m_order.begin();
+    }
+
+    auto evicted = evictOverflow();
+    released.insert(released.end(), evicted.begin(), evicted.end());
+    return released;
+}
+
+u32 ThumbnailLru::erase(i64 modelId) {
+    auto it = m_map.find(modelId);
+    if (it == m_map.end()) {
+        return 0;
+    }
+    u32 handle = it->second->second.handle;
+    m_order.erase(it->second);
+    m_map.erase(it);
+    return handle;
+}
+
+std::vector<u32> ThumbnailLru::clear() {
+    std::vector<u32> handles;
+    handles.reserve(m_order.size());
+    for (const auto& [id, entry] : m_order) {
+        if (entry.handle != 0) {
+            handles.push_back(entry.handle);
+        }
+    }
+    m_order.clear();
+    m_map.clear();
+    return handles;
+}
+
+std::vector<u32> ThumbnailLru::setCapacity(usize capacity) {
+    m_capacity = std::max<usize>(1, capacity);
+    return evictOverflow();
+}
+
+std::vector<u32> ThumbnailLru::evictOverflow() {
+    std::vector<u32> evicted;
+    while (m_order.size() > m_capacity) {
+        const auto& [id, entry] = m_order.back();
+        if (entry.handle != 0) {
+            evicted.push_back(entry.handle);
+        }
+        m_map.erase(id);
+        m_order.pop_back();
+    }
+    return evicted;
+}
+
+} // namespace dw
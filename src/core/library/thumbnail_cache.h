@@ -0,0 +1,153 @@
+#pragma once
+
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "../types.h"
+
+namespace dw {
+
+// Decoded RGBA8 thumbnail image (row-major, top-down)
+struct ThumbnailImage {
+    int width = 0;
+    int height = 0;
+    ByteBuffer rgba;
+
+    bool isValid() const { return width > 0 && height > 0 && !rgba.empty(); }
+};
+
+namespace thumbnail {
+
+// Decode an uncompressed 32bpp TGA (as written by ThumbnailGenerator) to RGBA.
+// Safe to call from any thread (no GL).
+std::optional<ThumbnailImage> decodeTGA(const Path& path);
+
+// Build a mip chain by 2x2 box filtering: [base, base/2, ...] down to minSize.
+std::vector<ThumbnailImage> buildMipChain(ThumbnailImage base, int minSize = 64);
+
+// Pick the smallest level whose width is >= displaySize (levels ordered large -> small)
+usize selectMipLevel(const std::vector<int>& levelWidths, float displaySize);
+
+} // namespace thumbnail
+
+// Identifies the source TGA a cached entry was built from (invalidates on regenerate)
+struct ThumbnailStamp {
+    u64 fileSize = 0;
+    i64 modifiedTime = 0;
+
+    bool operator==(const ThumbnailStamp& o) const {
+        return fileSize == o.fileSize && modifiedTime == o.modifiedTime;
+    }
+
+    // Read the stamp of a file on disk (nullopt if missing)
+    static std::optional<ThumbnailStamp> fromFile(const Path& path);
+};
+
+// Packed on-disk thumbnail cache.
+// A single append-only file holds every model's mip chain, deflate-compressed.
+// An in-memory index (rebuilt on open) maps model ID -> record offset; the newest
+// record for a model wins. Thread-safe: workers may store/load concurrently.
+class ThumbnailAtlas {
+  public:
+    ThumbnailAtlas() = default;
+
+    // Open (or create) the cache file and index its records. Compacts the
+    // file when at least a quarter of it is superseded records.
+    bool open(const Path& path);
+    bool isOpen() const;
+
+    // Store all mip levels for a model. Returns false on I/O failure.
+    bool store(i64 modelId,
+               const ThumbnailStamp& stamp,
+               const std::vector<ThumbnailImage>& levels);
+
+    // Level widths cached for a model (empty if missing or stamp mismatch)
+    std::vector<int> levelWidths(i64 modelId, const ThumbnailStamp& stamp) const;
+
+    // Load one mip level (nullopt if missing, stale or corrupt)
+    std::optional<ThumbnailImage> load(i64 modelId, const ThumbnailStamp& stamp, usize level) const;
+
+    // Drop a model from the index (its bytes are reclaimed by compact())
+    void invalidate(i64 modelId);
+
+    // Rewrite the file keeping only live records
+    bool compact();
+
+    usize entryCount() const;
+    u64 fileBytes() const;
+    u64 deadBytes() const;
+
+    static constexpr u32 Magic = 0x43545744; // "DWTC"
+    static constexpr u32 Version = 1;
+
+  private:
+    struct LevelInfo {
+        u16 width = 0;
+        u16 height = 0;
+        u32 compressedSize = 0;
+        u64 dataOffset = 0;
+    };
+    struct IndexEntry {
+        ThumbnailStamp stamp;
+        u64 recordOffset = 0;
+        u64 recordSize = 0;
+        std::vector<LevelInfo> levels;
+    };
+
+    bool scanLocked();
+    bool compactLocked();
+    const IndexEntry* findLocked(i64 modelId, const ThumbnailStamp& stamp) const;
+
+    mutable std::mutex m_mutex;
+    Path m_path;
+    bool m_open = false;
+    u64 m_fileBytes = 0;
+    u64 m_deadBytes = 0;
+    std::unordered_map<i64, IndexEntry> m_index;
+};
+
+// LRU bookkeeping for resident thumbnail textures (GL-free, main thread only).
+// Holds opaque texture handles; evicted handles are returned so the caller can
+// release the GPU resource.
+class ThumbnailLru {
+  public:
+    struct Entry {
+        u32 handle = 0;
+        int width = 0;        // Resident mip width (to detect when a larger level is needed)
+        bool largest = false; // Resident level is the full-size image
+    };
+
+    explicit ThumbnailLru(usize capacity = 512) : m_capacity(capacity) {}
+
+    // Look up and mark as most recently used
+    const Entry* touch(i64 modelId);
+
+    // Look up without affecting recency
+    const Entry* peek(i64 modelId) const;
+
+    // Insert or replace. Returns handles that must be released (replaced + evicted).
+    std::vector<u32> insert(i64 modelId, Entry entry);
+
+    // Remove an entry; returns its handle (0 if absent)
+    u32 erase(i64 modelId);
+
+    // Remove everything; returns all handles
+    std::vector<u32> clear();
+
+    usize size() const { return m_map.size(); }
+    usize capacity() const { return m_capacity; }
+    // Shrinking evicts least recently used entries; returns their handles
+    std::vector<u32> setCapacity(usize capacity);
+
+  private:
+    std::vector<u32> evictOverflow();
+
+    usize m_capacity;
+    std::list<std::pair<i64, Entry>> m_order; // Front = most recently used
+    std::unordered_map<i64, std::list<std::pair<i64, Entry>>::iterator> m_map;
+};
+
+} // namespace dw
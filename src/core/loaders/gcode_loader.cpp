@@ -1,13 +1,60 @@
 #include "gcode_loader.h"
 
 #include <algorithm>
+#include <cfloat>
 #include <set>
 
+#include "../gcode/gcode_lod.h"
 #include "../utils/file_utils.h"
 #include "../utils/log.h"
 
 namespace dw {
 
+namespace {
+
+// Merge near-collinear moves within connected runs of the same move type, tool
+// and feed, so every merged segment keeps attributes that are true for all of
+// it. Dense finishing passes collapse to a fraction of their segments with no
+// visible change at mesh scale; tolerance is a thousandth of the toolpath's
+// extent.
+std::vector<gcode::PathSegment> simplifyForMesh(const std::vector<gcode::PathSegment>& path) {
+    Vec3 lo{FLT_MAX};
+    Vec3 hi{-FLT_MAX};
+    for (const auto& seg : path) {
+        lo = glm::min(lo, glm::min(seg.start, seg.end));
+        hi = glm::max(hi, glm::max(seg.start, seg.end));
+    }
+    const f32 tolerance = path.empty() ? 0.0f : glm::length(hi - lo) * 0.001f;
+
+    std::vector<gcode::PathSegment> out;
+    out.reserve(path.size());
+    std::vector<Vec3> run;
+    std::vector<u32> keep;
+    usize i = 0;
+    while (i < path.size()) {
+        usize j = i + 1;
+        while (j < path.size() && path[j].isRapid == path[i].isRapid &&
+               path[j].toolNumber == path[i].toolNumber &&
+               path[j].feedRate == path[i].feedRate && path[j].start == path[j - 1].end)
+            ++j;
+
+        run.clear();
+        run.push_back(path[i].start);
+        for (usize k = i; k < j; ++k)
+            run.push_back(path[k].end);
+        gcode::simplifyPolyline(run, tolerance, keep);
+        for (usize k = 1; k < keep.size(); ++k) {
+            gcode::PathSegment seg = path[i + keep[k] - 1];
+            seg.start = run[keep[k - 1]];
+            out.push_back(seg);
+        }
+        i = j;
+    }
+    return out;
+}
+
+} // namespace
+
 LoadResult GCodeLoader::load(const Path& path) {
     // Read file content
     auto content = file::readText(path);
@@ -71,8 +118,9 @@ LoadResult GCodeLoader::processProgram(const gcode::Program& program) {
     return LoadResult{mesh, ""};
 }
 
-MeshPtr GCodeLoader::toolpathToMesh(const std::vector<gcode::PathSegment>& path) {
+MeshPtr GCodeLoader::toolpathToMesh(const std::vector<gcode::PathSegment>& fullPath) {
     auto mesh = std::make_shared<Mesh>();
+    const auto path = simplifyForMesh(fullPath);
 
     // Estimate vertex count: 4 vertices per segment (quad = 2 triangles)
     mesh->reserve(static_cast<u32>(path.size() * 4), static_cast<u32>(path.size() * 6));
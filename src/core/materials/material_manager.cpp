@@ -3,6 +3,7 @@
 #include <set>
 
 #include "../config/config.h"
+#include "../database/model_repository.h"
 #include "../paths/app_paths.h"
 #include "../paths/path_resolver.h"
 #include "../utils/file_utils.h"
@@ -289,15 +290,9 @@ bool MaterialManager::assignMaterialToModel(i64 materialId, i64 modelId) {
         return false;
     }
 
-    auto stmt = m_db.prepare("UPDATE models SET material_id = ? WHERE id = ?");
-    if (!stmt.isValid()) {
-        return false;
-    }
-    if (!stmt.bindInt(1, materialId) || !stmt.bindInt(2, modelId)) {
-        return false;
-    }
-
-    if (!stmt.execute()) {
+    // Through the repository so library views see the change
+    ModelRepository modelRepo(m_db);
+    if (!modelRepo.updateMaterial(modelId, materialId)) {
         log::errorf("MaterialManager",
                     "assignMaterialToModel: UPDATE failed for model %lld",
                     static_cast<long long>(modelId));
@@ -308,14 +303,8 @@ bool MaterialManager::assignMaterialToModel(i64 materialId, i64 modelId) {
 }
 
 bool MaterialManager::clearMaterialAssignment(i64 modelId) {
-    auto stmt = m_db.prepare("UPDATE models SET material_id = NULL WHERE id = ?");
-    if (!stmt.isValid()) {
-        return false;
-    }
-    if (!stmt.bindInt(1, modelId)) {
-        return false;
-    }
-    return stmt.execute() && m_db.changesCount() > 0;
+    ModelRepository modelRepo(m_db);
+    return modelRepo.updateMaterial(modelId, std::nullopt) && m_db.changesCount() > 0;
 }
 
 std::optional<MaterialRecord> MaterialManager::getModelMaterial(i64 modelId) {
@@ -0,0 +1,261 @@
+#include "compact_mesh.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "mesh.h"
+
+namespace dw {
+
+namespace quant {
+
+u16 floatToHalf(f32 value) {
+    u32 bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    const u32 sign = (bits >> 16) & 0x8000u;
+    const u32 rawExp = (bits >> 23) & 0xFFu;
+    u32 mant = bits & 0x7FFFFFu;
+
+    if (rawExp == 0xFFu) {
+        return static_cast<u16>(sign | 0x7C00u | (mant != 0 ? 0x200u : 0u)); // Inf / NaN
+    }
+
+    const i32 exp = static_cast<i32>(rawExp) - 127 + 15;
+    if (exp >= 31) {
+        return static_cast<u16>(sign | 0x7C00u);
+    }
+
+    if (exp <= 0) {
+        // Subnormal half (or underflow to signed zero)
+        if (exp < -10) {
+            return static_cast<u16>(sign);
+        }
+        mant |= 0x800000u;
+        const u32 shift = static_cast<u32>(14 - exp);
+        u32 half = mant >> shift;
+        const u32 rem = mant & ((1u << shift) - 1u);
+        const u32 halfway = 1u << (shift - 1u);
+        if (rem > halfway || (rem == halfway && (half & 1u) != 0)) {
+            ++half;
+        }
+        return static_cast<u16>(sign | half);
+    }
+
+    u32 half = (static_cast<u32>(exp) << 10) | (mant >> 13);
+    const u32 rem = mant & 0x1FFFu;
+    if (rem > 0x1000u || (rem == 0x1000u && (half & 1u) != 0)) {
+        ++half; // A carry into the exponent is still the correctly rounded result
+    }
+    return static_cast<u16>(sign | half);
+}
+
+f32 halfToFloat(u16 half) {
+    const u32 sign = static_cast<u32>(half & 0x8000u) << 16;
+    const u32 exp = (half >> 10) & 0x1Fu;
+    const u32 mant = half & 0x3FFu;
+
+    u32 bits = 0;
+    if (exp == 0) {
+        if (mant == 0) {
+            bits = sign;
+        } else {
+            f32 value = std::ldexp(static_cast<f32>(mant), -24);
+            return sign != 0 ? -value : value;
+        }
+    } else if (exp == 31) {
+        bits = sign | 0x7F800000u | (mant << 13);
+    } else {
+        bits = sign | ((exp + 112u) << 23) | (mant << 13);
+    }
+
+    f32 value = 0.0f;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+namespace {
+
+i8 toSnorm8(f32 v) {
+    return static_cast<i8>(std::lround(std::clamp(v, -1.0f, 1.0f) * 127.0f));
+}
+
+f32 signNotZero(f32 v) {
+    return v >= 0.0f ? 1.0f : -1.0f;
+}
+
+} // namespace
+
+u16 encodeOctahedral(const Vec3& normal) {
+    const f32 l1 = std::fabs(normal.x) + std::fabs(normal.y) + std::fabs(normal.z);
+    if (l1 <= 0.0f) {
+        return 0;
+    }
+
+    f32 px = normal.x / l1;
+    f32 py = normal.y / l1;
+    if (normal.z < 0.0f) {
+        // Fold the lower hemisphere over the diagonals
+        const f32 fx = (1.0f - std::fabs(py)) * signNotZero(px);
+        const f32 fy = (1.0f - std::fabs(px)) * signNotZero(py);
+        px = fx;
+        py = fy;
+    }
+
+    const auto qx = static_cast<u8>(toSnorm8(px));
+    const auto qy = static_cast<u8>(toSnorm8(py));
+    return static_cast<u16>(qx | (qy << 8));
+}
+
+Vec3 decodeOctahedral(u16 packed) {
+    const auto qx = static_cast<i8>(packed & 0xFFu);
+    const auto qy = static_cast<i8>(packed >> 8);
+    f32 x = std::max(static_cast<f32>(qx) / 127.0f, -1.0f);
+    f32 y = std::max(static_cast<f32>(qy) / 127.0f, -1.0f);
+    const f32 z = 1.0f - std::fabs(x) - std::fabs(y);
+    if (z < 0.0f) {
+        const f32 ux = (1.0f - std::fabs(y)) * signNotZero(x);
+        const f32 uy = (1.0f - std::fabs(x)) * signNotZero(y);
+        x = ux;
+        y = uy;
+    }
+    const f32 len = std::sqrt(x * x + y * y + z * z);
+    return Vec3{x / len, y / len, z / len};
+}
+
+} // namespace quant
+
+namespace {
+
+u16 quantizeAxis(f32 value, f32 min, f32 step) {
+    if (step <= 0.0f) {
+        return 0;
+    }
+    const f32 q = std::round((value - min) / step);
+    return static_cast<u16>(std::clamp(q, 0.0f, 65535.0f));
+}
+
+} // namespace
+
+CompactMesh CompactMesh::fromMesh(const Mesh& mesh) {
+    CompactMesh out;
+    out.m_name = mesh.name();
+
+    const auto& vertices = mesh.vertices();
+    const auto& indices = mesh.indices();
+    if (vertices.empty()) {
+        return out;
+    }
+
+    for (const auto& v : vertices) {
+        out.m_bounds.expand(v.position);
+    }
+    const Vec3 extent = out.m_bounds.size();
+    out.m_step = Vec3{extent.x / 65535.0f, extent.y / 65535.0f, extent.z / 65535.0f};
+
+    const bool keepNormals = mesh.hasNormals();
+    const bool keepTexCoords = mesh.hasTexCoords();
+
+    out.m_positions.resize(vertices.size());
+    if (keepNormals) {
+        out.m_normals.resize(vertices.size());
+    }
+    if (keepTexCoords) {
+        out.m_texCoords.resize(vertices.size());
+    }
+
+    const Vec3& min = out.m_bounds.min;
+    for (usize i = 0; i < vertices.size(); ++i) {
+        const Vertex& v = vertices[i];
+        auto& q = out.m_positions[i];
+        q.x = quantizeAxis(v.position.x, min.x, out.m_step.x);
+        q.y = quantizeAxis(v.position.y, min.y, out.m_step.y);
+        q.z = quantizeAxis(v.position.z, min.z, out.m_step.z);
+        if (keepNormals) {
+            out.m_normals[i] = quant::encodeOctahedral(v.normal);
+        }
+        if (keepTexCoords) {
+            out.m_texCoords[i] = static_cast<u32>(quant::floatToHalf(v.texCoord.x)) |
+                                 (static_cast<u32>(quant::floatToHalf(v.texCoord.y)) << 16);
+        }
+    }
+
+    // Unwelded triangle soup (binary STL) indexes 0..n-1; don't store that
+    out.m_indexCount = static_cast<u32>(indices.size());
+    bool identity = indices.size() == vertices.size();
+    for (usize i = 0; identity && i < indices.size(); ++i) {
+        identity = indices[i] == static_cast<u32>(i);
+    }
+    out.m_implicitIndices = identity;
+    if (!identity) {
+        out.m_indices = indices;
+    }
+
+    return out;
+}
+
+Vec3 CompactMesh::position(u32 vertex) const {
+    const auto& q = m_positions[vertex];
+    return Vec3{m_bounds.min.x + static_cast<f32>(q.x) * m_step.x,
+                m_bounds.min.y + static_cast<f32>(q.y) * m_step.y,
+                m_bounds.min.z + static_cast<f32>(q.z) * m_step.z};
+}
+
+Vec3 CompactMesh::normal(u32 vertex) const {
+    if (m_normals.empty()) {
+        return Vec3{0.0f, 0.0f, 0.0f};
+    }
+    return quant::decodeOctahedral(m_normals[vertex]);
+}
+
+Vec2 CompactMesh::texCoord(u32 vertex) const {
+    if (m_texCoords.empty()) {
+        return Vec2{0.0f, 0.0f};
+    }
+    const u32 packed = m_texCoords[vertex];
+    return Vec2{quant::halfToFloat(static_cast<u16>(packed & 0xFFFFu)),
+                quant::halfToFloat(static_cast<u16>(packed >> 16))};
+}
+
+void CompactMesh::decodeRange(u32 first, u32 count, Vertex* out) const {
+    const u32 total = vertexCount();
+    if (first >= total) {
+        return;
+    }
+    const u32 end = first + std::min(count, total - first);
+    for (u32 i = first; i < end; ++i) {
+        *out++ = Vertex(position(i), normal(i), texCoord(i));
+    }
+}
+
+Mesh CompactMesh::decode() const {
+    std::vector<Vertex> vertices(vertexCount());
+    decodeRange(0, vertexCount(), vertices.data());
+
+    std::vector<u32> indices;
+    if (m_implicitIndices) {
+        indices.resize(m_indexCount);
+        for (u32 i = 0; i < m_indexCount; ++i) {
+            indices[i] = i;
+        }
+    } else {
+        indices = m_indices;
+    }
+
+    Mesh mesh(std::move(vertices), std::move(indices));
+    mesh.setName(m_name);
+    return mesh;
+}
+
+f32 CompactMesh::maxPositionError() const {
+    return std::max({m_step.x, m_step.y, m_step.z}) * 0.5f;
+}
+
+usize CompactMesh::memoryBytes() const {
+    return m_positions.capacity() * sizeof(QuantizedPosition) +
+           m_normals.capacity() * sizeof(u16) + m_texCoords.capacity() * sizeof(u32) +
+           m_indices.capacity() * sizeof(u32);
+}
+
+} // namespace dw
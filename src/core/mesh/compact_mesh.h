@@ -0,0 +1,95 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../types.h"
+#include "bounds.h"
+#include "vertex.h"
+
+namespace dw {
+
+class Mesh;
+
+namespace quant {
+
+// IEEE 754 binary16 conversion (round to nearest, overflow saturates to +/-inf)
+u16 floatToHalf(f32 value);
+f32 halfToFloat(u16 half);
+
+// Octahedral unit-vector encoding into two snorm8 components (low byte = x).
+// Worst-case angular error is just under 1 degree; a zero vector decodes to +Z.
+u16 encodeOctahedral(const Vec3& normal);
+Vec3 decodeOctahedral(u16 packed);
+
+} // namespace quant
+
+// Memory-compact, read-only copy of a Mesh for large resident models.
+//
+//   position  3 x u16, quantized to the mesh AABB (error <= extent / 131070 per axis)
+//   normal    octahedral 2 x snorm8 (dropped when the mesh has no normals)
+//   texCoord  2 x half float (dropped when all UVs are zero, e.g. STL)
+//   indices   u32, or implicit when they are the identity (unwelded STL soup)
+//
+// That is 6-12 bytes per vertex instead of 32. Vertices are decoded back to
+// floats on demand: per element for CPU consumers (carve/heightmap), or in
+// bounded chunks via decodeRange().
+class CompactMesh {
+  public:
+    CompactMesh() = default;
+
+    // Quantize a mesh (bounds are recomputed from the vertex positions)
+    static CompactMesh fromMesh(const Mesh& mesh);
+
+    // Expand back to a full-precision Mesh
+    Mesh decode() const;
+
+    // Decode vertices [first, first + count) into out (count is clamped)
+    void decodeRange(u32 first, u32 count, Vertex* out) const;
+
+    // Element accessors
+    Vec3 position(u32 vertex) const;
+    Vec3 normal(u32 vertex) const;
+    Vec2 texCoord(u32 vertex) const;
+    u32 index(u32 i) const { return m_implicitIndices ? i : m_indices[i]; }
+
+    // Statistics
+    u32 vertexCount() const { return static_cast<u32>(m_positions.size()); }
+    u32 indexCount() const { return m_indexCount; }
+    u32 triangleCount() const { return m_indexCount / 3; }
+    const AABB& bounds() const { return m_bounds; }
+    bool empty() const { return m_positions.empty(); }
+    bool hasNormals() const { return !m_normals.empty(); }
+    bool hasTexCoords() const { return !m_texCoords.empty(); }
+    bool hasImplicitIndices() const { return m_implicitIndices; }
+
+    // Largest per-axis position error introduced by quantization
+    f32 maxPositionError() const;
+
+    // Heap bytes held by the vertex/index streams
+    usize memoryBytes() const;
+
+    const std::string& name() const { return m_name; }
+
+  private:
+    struct QuantizedPosition {
+        u16 x = 0;
+        u16 y = 0;
+        u16 z = 0;
+    };
+
+    std::vector<QuantizedPosition> m_positions;
+    std::vector<u16> m_normals;   // Octahedral, parallel to m_positions (or empty)
+    std::vector<u32> m_texCoords; // Packed half2, parallel to m_positions (or empty)
+    std::vector<u32> m_indices;   // Empty when m_implicitIndices
+    u32 m_indexCount = 0;
+    bool m_implicitIndices = false;
+    AABB m_bounds;
+    Vec3 m_step{0.0f}; // Bounds extent / 65535 per axis
+    std::string m_name;
+};
+
+using CompactMeshPtr = std::shared_ptr<CompactMesh>;
+
+} // namespace dw
@@ -1,10 +1,11 @@
 #include "hash.h"
 
 #include <cstring>
+#include <fstream>
 #include <iomanip>
 #include <sstream>
+#include <vector>
 
-#include "../utils/file_utils.h"
 #include "mesh.h"
 
 namespace dw {
@@ -32,13 +33,22 @@ u64 computeBytes(const void* data, usize size) {
 namespace hash {
 
 std::string computeFile(const Path& path) {
-    auto data = file::readBinary(path);
-    if (!data) {
+    // Streamed in blocks so multi-GB files hash in constant memory
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
         return "";
     }
 
-    u64 hash = computeBytes(data->data(), data->size());
-    return toHex(hash);
+    Hasher hasher;
+    std::vector<char> block(1u << 20);
+    while (in) {
+        in.read(block.data(), static_cast<std::streamsize>(block.size()));
+        hasher.update(block.data(), static_cast<usize>(in.gcount()));
+    }
+    if (in.bad()) {
+        return "";
+    }
+    return hasher.hex();
 }
 
 std::string computeBuffer(const ByteBuffer& buffer) {
@@ -83,6 +93,16 @@ std::string toHex(u64 hash) {
     return ss.str();
 }
 
+void Hasher::update(const void* data, usize size) {
+    const u8* bytes = static_cast<const u8*>(data);
+    u64 h = m_state;
+    for (usize i = 0; i < size; ++i) {
+        h ^= bytes[i];
+        h *= FNV_PRIME;
+    }
+    m_state = h;
+}
+
 u64 fromHex(const std::string& hex) {
     u64 hash = 0;
     std::istringstream ss(hex);
@@ -27,5 +27,16 @@ std::string toHex(u64 hash);
 // Convert hex string to hash
 u64 fromHex(const std::string& hex);
 
+// Incremental form of computeBuffer/computeFile for data that arrives in pieces
+class Hasher {
+  public:
+    void update(const void* data, usize size);
+    u64 value() const { return m_state; }
+    std::string hex() const { return toHex(m_state); }
+
+  private:
+    u64 m_state = 14695981039346656037ULL; // FNV-1a offset basis
+};
+
 } // namespace hash
 } // namespace dw
@@ -4,10 +4,66 @@
 #include <cmath>
 #include <cstring>
 
+#include "../threading/parallel_for.h"
 #include "../utils/log.h"
+#include "mesh_kernels.h"
 
 namespace dw {
 
+namespace {
+
+// Work split for the data-parallel operations. Fixed chunk sizes (independent of
+// thread count) keep chunked reductions bit-reproducible.
+constexpr usize VERTEX_GRAIN = 16384;
+constexpr usize TRIANGLE_GRAIN = 8192;
+
+// Unnormalized face normal of one triangle (indices must be in range)
+Vec3 faceNormal(const std::vector<Vertex>& vertices, const u32* tri) {
+    const Vec3& v0 = vertices[tri[0]].position;
+    const Vec3& v1 = vertices[tri[1]].position;
+    const Vec3& v2 = vertices[tri[2]].position;
+    Vec3 edge1 = v1 - v0;
+    Vec3 edge2 = v2 - v0;
+    return glm::cross(edge1, edge2);
+}
+
+// Normalize (guard against zero-length from degenerate triangles)
+Vec3 unitOrUp(const Vec3& n) {
+    f32 len = glm::length(n);
+    if (len > 1e-7f) {
+        return n / len;
+    }
+    return Vec3{0.0f, 1.0f, 0.0f}; // Default up normal
+}
+
+u32 countNonFinite(const std::vector<Vertex>& vertices) {
+    return parallelReduce(
+        vertices.size(),
+        VERTEX_GRAIN,
+        0u,
+        [&](usize begin, usize end) {
+            return mesh_kernels::countNonFinitePositions(vertices.data() + begin, end - begin);
+        },
+        [](u32 acc, u32 chunk) { return acc + chunk; });
+}
+
+u32 countOutOfBounds(const std::vector<u32>& indices, u32 vertCount) {
+    return parallelReduce(
+        indices.size(),
+        VERTEX_GRAIN,
+        0u,
+        [&](usize begin, usize end) {
+            u32 chunk = 0;
+            for (usize i = begin; i < end; ++i) {
+                chunk += indices[i] >= vertCount ? 1u : 0u;
+            }
+            return chunk;
+        },
+        [](u32 acc, u32 chunk) { return acc + chunk; });
+}
+
+} // namespace
+
 Mesh::Mesh(std::vector<Vertex> vertices, std::vector<u32> indices)
     : m_vertices(std::move(vertices)), m_indices(std::move(indices)) {
     recalculateBounds();
@@ -53,64 +109,110 @@ u64 Mesh::geometryHash() const {
 }
 
 void Mesh::recalculateBounds() {
-    m_bounds.reset();
-    for (const auto& vertex : m_vertices) {
-        m_bounds.expand(vertex.position);
-    }
+    m_bounds = parallelReduce(
+        m_vertices.size(),
+        VERTEX_GRAIN,
+        AABB{},
+        [&](usize begin, usize end) {
+            AABB chunk;
+            mesh_kernels::expandBounds(m_vertices.data() + begin, end - begin, chunk);
+            return chunk;
+        },
+        [](AABB acc, const AABB& chunk) {
+            acc.expand(chunk);
+            return acc;
+        });
 }
 
 void Mesh::recalculateNormals() {
-    // Reset all normals to zero
-    for (auto& vertex : m_vertices) {
-        vertex.normal = Vec3{0.0f, 0.0f, 0.0f};
+    const u32 vertCount = vertexCount();
+    const usize triCount = m_indices.size() / 3;
+
+    // Incident triangle count per vertex (triangles with a bad index are skipped)
+    std::vector<u32> offsets(static_cast<usize>(vertCount) + 1, 0);
+    bool soup = true;
+    for (usize t = 0; t < triCount; ++t) {
+        const u32* tri = &m_indices[t * 3];
+        if (tri[0] >= vertCount || tri[1] >= vertCount || tri[2] >= vertCount) {
+            continue;
+        }
+        for (int c = 0; c < 3; ++c) {
+            soup = soup && offsets[tri[c] + 1] == 0;
+            ++offsets[tri[c] + 1];
+        }
     }
 
-    // Accumulate face normals for each vertex
-    for (usize i = 0; i + 2 < m_indices.size(); i += 3) {
-        u32 i0 = m_indices[i];
-        u32 i1 = m_indices[i + 1];
-        u32 i2 = m_indices[i + 2];
-
-        const Vec3& v0 = m_vertices[i0].position;
-        const Vec3& v1 = m_vertices[i1].position;
-        const Vec3& v2 = m_vertices[i2].position;
-
-        Vec3 edge1 = v1 - v0;
-        Vec3 edge2 = v2 - v0;
-        Vec3 normal = glm::cross(edge1, edge2);
-
-        m_vertices[i0].normal = m_vertices[i0].normal + normal;
-        m_vertices[i1].normal = m_vertices[i1].normal + normal;
-        m_vertices[i2].normal = m_vertices[i2].normal + normal;
+    if (soup) {
+        // Every vertex belongs to at most one triangle: write face normals directly
+        parallelFor(m_vertices.size(), VERTEX_GRAIN, [&](usize begin, usize end) {
+            for (usize v = begin; v < end; ++v) {
+                m_vertices[v].normal = unitOrUp(Vec3{0.0f, 0.0f, 0.0f});
+            }
+        });
+        parallelFor(triCount, TRIANGLE_GRAIN, [&](usize begin, usize end) {
+            for (usize t = begin; t < end; ++t) {
+                const u32* tri = &m_indices[t * 3];
+                if (tri[0] >= vertCount || tri[1] >= vertCount || tri[2] >= vertCount) {
+                    continue;
+                }
+                const Vec3 normal = unitOrUp(Vec3{0.0f, 0.0f, 0.0f} + faceNormal(m_vertices, tri));
+                m_vertices[tri[0]].normal = normal;
+                m_vertices[tri[1]].normal = normal;
+                m_vertices[tri[2]].normal = normal;
+            }
+        });
+        return;
     }
 
-    // Normalize all normals (guard against zero-length from degenerate triangles)
-    for (auto& vertex : m_vertices) {
-        f32 len = glm::length(vertex.normal);
-        if (len > 1e-7f) {
-            vertex.normal = vertex.normal / len;
-        } else {
-            vertex.normal = Vec3{0.0f, 1.0f, 0.0f}; // Default up normal
+    // Shared vertices: gather incident faces per vertex in triangle order, so the
+    // sums match the sequential scatter bit-for-bit regardless of thread count
+    for (u32 v = 0; v < vertCount; ++v) {
+        offsets[v + 1] += offsets[v];
+    }
+    std::vector<u32> faces(offsets[vertCount]);
+    std::vector<u32> cursor(offsets.begin(), offsets.end() - 1);
+    for (usize t = 0; t < triCount; ++t) {
+        const u32* tri = &m_indices[t * 3];
+        if (tri[0] >= vertCount || tri[1] >= vertCount || tri[2] >= vertCount) {
+            continue;
+        }
+        for (int c = 0; c < 3; ++c) {
+            faces[cursor[tri[c]]++] = static_cast<u32>(t);
         }
     }
+
+    parallelFor(vertCount, VERTEX_GRAIN, [&](usize begin, usize end) {
+        for (usize v = begin; v < end; ++v) {
+            Vec3 sum{0.0f, 0.0f, 0.0f};
+            for (u32 f = offsets[v]; f < offsets[v + 1]; ++f) {
+                const u32* tri = &m_indices[static_cast<usize>(faces[f]) * 3];
+                sum = sum + faceNormal(m_vertices, tri);
+            }
+            m_vertices[v].normal = unitOrUp(sum);
+        }
+    });
 }
 
 void Mesh::transform(const Mat4& matrix) {
     m_hashCached = false;
     // Normal matrix (inverse transpose of upper 3x3)
-    // For simple transforms, we can use the matrix directly
-    for (auto& vertex : m_vertices) {
-        Vec4 pos = matrix * Vec4(vertex.position, 1.0f);
-        vertex.position = Vec3{pos.x, pos.y, pos.z};
-
-        // Transform normal (assuming no non-uniform scaling)
-        Vec4 norm = matrix * Vec4(vertex.normal, 0.0f);
-        Vec3 n{norm.x, norm.y, norm.z};
-        f32 len = glm::length(n);
-        vertex.normal = (len > 1e-7f) ? (n / len) : Vec3{0.0f, 1.0f, 0.0f};
-    }
-
-    recalculateBounds();
+    // For simple transforms, we can use the matrix directly.
+    // Bounds are gathered per chunk while the transformed vertices are still in cache.
+    m_bounds = parallelReduce(
+        m_vertices.size(),
+        VERTEX_GRAIN,
+        AABB{},
+        [&](usize begin, usize end) {
+            Vertex* chunk = m_vertices.data() + begin;
+            mesh_kernels::transformVertices(chunk, end - begin, matrix);
+            AABB bounds;
+            mesh_kernels::expandBounds(chunk, end - begin, bounds);
+            return bounds;
+        },
+        [](AABB acc, const AABB& chunk) {
+            acc.expand(chunk);
+            return acc;
+        });
 }
 
 void Mesh::centerOnOrigin() {
@@ -184,22 +286,32 @@ f32 Mesh::autoOrient() {
     m_autoOriented = true;
 
     // Count triangle normals along Z to determine front face
-    i32 posZ = 0;
-    i32 negZ = 0;
-    for (usize i = 0; i + 2 < m_indices.size(); i += 3) {
-        const Vec3& v0 = m_vertices[m_indices[i]].position;
-        const Vec3& v1 = m_vertices[m_indices[i + 1]].position;
-        const Vec3& v2 = m_vertices[m_indices[i + 2]].position;
-
-        Vec3 edge1 = v1 - v0;
-        Vec3 edge2 = v2 - v0;
-        Vec3 normal = glm::cross(edge1, edge2);
-
-        if (normal.z > 0.0f)
-            posZ++;
-        else if (normal.z < 0.0f)
-            negZ++;
-    }
+    struct ZCount {
+        i64 pos = 0;
+        i64 neg = 0;
+    };
+    const ZCount counts = parallelReduce(
+        m_indices.size() / 3,
+        TRIANGLE_GRAIN,
+        ZCount{},
+        [&](usize begin, usize end) {
+            ZCount chunk;
+            for (usize t = begin; t < end; ++t) {
+                const Vec3 normal = faceNormal(m_vertices, &m_indices[t * 3]);
+                if (normal.z > 0.0f)
+                    chunk.pos++;
+                else if (normal.z < 0.0f)
+                    chunk.neg++;
+            }
+            return chunk;
+        },
+        [](ZCount acc, const ZCount& chunk) {
+            acc.pos += chunk.pos;
+            acc.neg += chunk.neg;
+            return acc;
+        });
+    const i64 posZ = counts.pos;
+    const i64 negZ = counts.neg;
 
     return (posZ >= negZ) ? 0.0f : 180.0f;
 }
@@ -355,20 +467,23 @@ void Mesh::generatePlanarUVs(float grainRotationDeg) {
         sinR = std::sin(rad);
     }
 
-    for (auto& vertex : m_vertices) {
-        float u = (getAxis(vertex.position, axis1) - minAxis1) / axis1Size;
-        float v = (getAxis(vertex.position, axis2) - minAxis2) / axis2Size;
-
-        if (doRotate) {
-            // Rotate around UV center (0.5, 0.5)
-            float du = u - 0.5f;
-            float dv = v - 0.5f;
-            u = du * cosR - dv * sinR + 0.5f;
-            v = du * sinR + dv * cosR + 0.5f;
-        }
+    parallelFor(m_vertices.size(), VERTEX_GRAIN, [&](usize begin, usize end) {
+        for (usize i = begin; i < end; ++i) {
+            auto& vertex = m_vertices[i];
+            float u = (getAxis(vertex.position, axis1) - minAxis1) / axis1Size;
+            float v = (getAxis(vertex.position, axis2) - minAxis2) / axis2Size;
 
-        vertex.texCoord = Vec2{u, v};
-    }
+            if (doRotate) {
+                // Rotate around UV center (0.5, 0.5)
+                float du = u - 0.5f;
+                float dv = v - 0.5f;
+                u = du * cosR - dv * sinR + 0.5f;
+                v = du * sinR + dv * cosR + 0.5f;
+            }
+
+            vertex.texCoord = Vec2{u, v};
+        }
+    });
 }
 
 bool Mesh::hasTexCoords() const {
@@ -390,48 +505,44 @@ bool Mesh::validate() const {
     u32 vertCount = vertexCount();
 
     // Check for NaN/Inf in vertex positions and normals
-    u32 nanVerts = 0;
-    for (const auto& v : m_vertices) {
-        if (std::isnan(v.position.x) || std::isnan(v.position.y) || std::isnan(v.position.z) ||
-            std::isinf(v.position.x) || std::isinf(v.position.y) || std::isinf(v.position.z)) {
-            nanVerts++;
-        }
-    }
+    u32 nanVerts = countNonFinite(m_vertices);
     if (nanVerts > 0) {
         log::warningf("Mesh", "%u vertices have NaN/Inf positions", nanVerts);
         valid = false;
     }
 
     // Check for out-of-bounds indices
-    u32 oobIndices = 0;
-    for (u32 idx : m_indices) {
-        if (idx >= vertCount) {
-            oobIndices++;
-        }
-    }
+    u32 oobIndices = countOutOfBounds(m_indices, vertCount);
     if (oobIndices > 0) {
         log::warningf("Mesh", "%u indices out of bounds (vertex count: %u)", oobIndices, vertCount);
         valid = false;
     }
 
     // Check for degenerate triangles (zero area)
-    u32 degenerates = 0;
-    for (usize i = 0; i + 2 < m_indices.size(); i += 3) {
-        u32 i0 = m_indices[i], i1 = m_indices[i + 1], i2 = m_indices[i + 2];
-        if (i0 >= vertCount || i1 >= vertCount || i2 >= vertCount) {
-            continue; // Already flagged above
-        }
-        if (i0 == i1 || i1 == i2 || i0 == i2) {
-            degenerates++;
-            continue;
-        }
-        Vec3 e1 = m_vertices[i1].position - m_vertices[i0].position;
-        Vec3 e2 = m_vertices[i2].position - m_vertices[i0].position;
-        Vec3 cross = glm::cross(e1, e2);
-        if (glm::dot(cross, cross) < 1e-12f) {
-            degenerates++;
-        }
-    }
+    u32 degenerates = parallelReduce(
+        m_indices.size() / 3,
+        TRIANGLE_GRAIN,
+        0u,
+        [&](usize begin, usize end) {
+            u32 chunk = 0;
+            for (usize t = begin; t < end; ++t) {
+                const u32* tri = &m_indices[t * 3];
+                u32 i0 = tri[0], i1 = tri[1], i2 = tri[2];
+                if (i0 >= vertCount || i1 >= vertCount || i2 >= vertCount) {
+                    continue; // Already flagged above
+                }
+                if (i0 == i1 || i1 == i2 || i0 == i2) {
+                    chunk++;
+                    continue;
+                }
+                Vec3 cross = faceNormal(m_vertices, tri);
+                if (glm::dot(cross, cross) < 1e-12f) {
+                    chunk++;
+                }
+            }
+            return chunk;
+        },
+        [](u32 acc, u32 chunk) { return acc + chunk; });
     if (degenerates > 0) {
         log::warningf("Mesh", "%u degenerate triangles (zero area)", degenerates);
         valid = false;
@@ -445,25 +556,14 @@ bool Mesh::validateGeometry() const {
     u32 vertCount = vertexCount();
 
     // Check for NaN/Inf in vertex positions (fatal - makes mesh unrenderable)
-    u32 nanVerts = 0;
-    for (const auto& v : m_vertices) {
-        if (std::isnan(v.position.x) || std::isnan(v.position.y) || std::isnan(v.position.z) ||
-            std::isinf(v.position.x) || std::isinf(v.position.y) || std::isinf(v.position.z)) {
-            nanVerts++;
-        }
-    }
+    u32 nanVerts = countNonFinite(m_vertices);
     if (nanVerts > 0) {
         log::warningf("Mesh", "%u vertices have NaN/Inf positions", nanVerts);
         valid = false;
     }
 
     // Check for out-of-bounds indices (fatal - causes crashes)
-    u32 oobIndices = 0;
-    for (u32 idx : m_indices) {
-        if (idx >= vertCount) {
-            oobIndices++;
-        }
-    }
+    u32 oobIndices = countOutOfBounds(m_indices, vertCount);
     if (oobIndices > 0) {
         log::warningf("Mesh", "%u indices out of bounds (vertex count: %u)", oobIndices, vertCount);
         valid = false;
@@ -0,0 +1,234 @@
+#include "mesh_cache.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include <miniz.h>
+
+#include "../paths/app_paths.h"
+#include "../utils/file_utils.h"
+#include "../utils/log.h"
+#include "mesh_optimizer.h"
+
+namespace dw {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+static_assert(sizeof(Vertex) == 8 * sizeof(f32), "Vertex is stored as 8 packed floats");
+
+struct Header {
+    u32 magic = 0;
+    u32 version = 0;
+    u32 optimizerVersion = 0;
+    u32 vertexCount = 0;
+    u32 indexCount = 0;
+    u32 crc = 0;
+    f32 boundsMin[3] = {};
+    f32 boundsMax[3] = {};
+};
+static_assert(sizeof(Header) == 48, "Header layout is part of the file format");
+
+bool isValidHash(const std::string& hash) {
+    if (hash.empty()) {
+        return false;
+    }
+    for (char c : hash) {
+        if (!std::isalnum(static_cast<unsigned char>(c))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+u32 payloadCrc(const std::vector<Vertex>& vertices, const std::vector<u32>& indices) {
+    mz_ulong crc = MZ_CRC32_INIT;
+    crc = mz_crc32(crc,
+                   reinterpret_cast<const unsigned char*>(vertices.data()),
+                   vertices.size() * sizeof(Vertex));
+    crc = mz_crc32(crc,
+                   reinterpret_cast<const unsigned char*>(indices.data()),
+                   indices.size() * sizeof(u32));
+    return static_cast<u32>(crc);
+}
+
+} // namespace
+
+MeshCache::MeshCache(const Path& dir, u64 maxBytes) : m_dir(dir), m_maxBytes(maxBytes) {}
+
+Path MeshCache::defaultDir() {
+    return paths::getMeshCacheDir();
+}
+
+Path MeshCache::pathFor(const std::string& hash) const {
+    if (!isValidHash(hash)) {
+        return {};
+    }
+    return m_dir / (hash + ".dwmesh");
+}
+
+bool MeshCache::contains(const std::string& hash) const {
+    Path path = pathFor(hash);
+    return !path.empty() && file::isFile(path);
+}
+
+MeshPtr MeshCache::load(const std::string& hash) const {
+    Path path = pathFor(hash);
+    if (path.empty()) {
+        return nullptr;
+    }
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return nullptr;
+    }
+
+    Header header;
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!in || header.magic != Magic || header.version != Version ||
+        header.optimizerVersion != mesh_opt::VERSION || header.indexCount % 3 != 0) {
+        return nullptr; // Missing, foreign or built by an older optimizer
+    }
+
+    std::error_code ec;
+    const u64 expected = sizeof(Header) + static_cast<u64>(header.vertexCount) * sizeof(Vertex) +
+                         static_cast<u64>(header.indexCount) * sizeof(u32);
+    if (fs::file_size(path, ec) != expected || ec) {
+        log::warningf("MeshCache", "Truncated cache entry: %s", path.string().c_str());
+        return nullptr;
+    }
+
+    std::vector<Vertex> vertices(header.vertexCount);
+    std::vector<u32> indices(header.indexCount);
+    in.read(reinterpret_cast<char*>(vertices.data()),
+            static_cast<std::streamsize>(vertices.size() * sizeof(Vertex)));
+    in.read(reinterpret_cast<char*>(indices.data()),
+            static_cast<std::streamsize>(indices.size() * sizeof(u32)));
+    if (!in || payloadCrc(vertices, indices) != header.crc) {
+        log::warningf("MeshCache", "Corrupt cache entry: %s", path.string().c_str());
+        return nullptr;
+    }
+    for (u32 idx : indices) {
+        if (idx >= header.vertexCount) {
+            return nullptr;
+        }
+    }
+
+    // Mark as recently used for eviction
+    fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+
+    return std::make_shared<Mesh>(std::move(vertices), std::move(indices));
+}
+
+bool MeshCache::store(const std::string& hash, const Mesh& mesh) const {
+    Path path = pathFor(hash);
+    if (path.empty() || mesh.vertices().empty()) {
+        return false;
+    }
+    if (!file::isDirectory(m_dir) && !file::createDirectories(m_dir)) {
+        log::warningf("MeshCache", "Cannot create cache directory: %s", m_dir.string().c_str());
+        return false;
+    }
+
+    Header header;
+    header.magic = Magic;
+    header.version = Version;
+    header.optimizerVersion = mesh_opt::VERSION;
+    header.vertexCount = mesh.vertexCount();
+    header.indexCount = mesh.indexCount();
+    header.crc = payloadCrc(mesh.vertices(), mesh.indices());
+    const AABB& bounds = mesh.bounds();
+    for (int i = 0; i < 3; ++i) {
+        header.boundsMin[i] = bounds.min[i];
+        header.boundsMax[i] = bounds.max[i];
+    }
+
+    // Unique temp name so concurrent imports of the same content don't collide
+    static std::atomic<u32> s_tempCounter{0};
+    Path tmpPath = path;
+    tmpPath += ".tmp" + std::to_string(s_tempCounter.fetch_add(1));
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(mesh.vertices().data()),
+                  static_cast<std::streamsize>(mesh.vertices().size() * sizeof(Vertex)));
+        out.write(reinterpret_cast<const char*>(mesh.indices().data()),
+                  static_cast<std::streamsize>(mesh.indices().size() * sizeof(u32)));
+        out.flush();
+        if (!out) {
+            log::warningf("MeshCache", "Failed to write %s", tmpPath.string().c_str());
+            out.close();
+            (void)file::remove(tmpPath);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(tmpPath, path, ec);
+    if (ec) {
+        log::warningf("MeshCache",
+                      "Failed to finalize %s: %s",
+                      path.string().c_str(),
+                      ec.message().c_str());
+        (void)file::remove(tmpPath);
+        return false;
+    }
+    evictOverflow(path);
+    return true;
+}
+
+void MeshCache::evictOverflow(const Path& keep) const {
+    struct Entry {
+        Path path;
+        u64 bytes;
+        fs::file_time_type time;
+    };
+    std::vector<Entry> entries;
+    u64 total = 0;
+    std::error_code ec;
+    for (fs::directory_iterator it(m_dir, ec), end; !ec && it != end; it.increment(ec)) {
+        if (it->path().extension() != ".dwmesh") {
+            continue;
+        }
+        std::error_code entryEc;
+        const u64 bytes = it->file_size(entryEc);
+        const auto time = it->last_write_time(entryEc);
+        if (entryEc) {
+            continue; // Removed by a concurrent eviction
+        }
+        total += bytes;
+        entries.push_back({it->path(), bytes, time});
+    }
+    if (total <= m_maxBytes) {
+        return;
+    }
+
+    std::sort(entries.begin(), entries.end(),
+              [](const Entry& a, const Entry& b) { return a.time < b.time; });
+    for (const auto& entry : entries) {
+        if (total <= m_maxBytes) {
+            break;
+        }
+        if (entry.path == keep) {
+            continue;
+        }
+        if (file::remove(entry.path)) {
+            total -= entry.bytes;
+        }
+    }
+}
+
+bool MeshCache::remove(const std::string& hash) const {
+    Path path = pathFor(hash);
+    if (path.empty() || !file::exists(path)) {
+        return true;
+    }
+    return file::remove(path);
+}
+
+} // namespace dw
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <string>
+
+#include "../types.h"
+#include "mesh.h"
+
+namespace dw {
+
+// On-disk cache of import-optimized meshes, one file per source content hash:
+//   dir/<hash>.dwmesh
+//
+// Files hold the raw vertex/index buffers behind a small header (format and
+// optimizer version, counts, bounds, CRC-32 of the payload), so a cache hit is a
+// single read with no parsing, welding or reordering. Entries written by an
+// older optimizer version are treated as misses. The directory is kept under
+// maxBytes: after each store the least recently used entries (a hit refreshes
+// the file time) are deleted. Safe to use from any thread.
+class MeshCache {
+  public:
+    static constexpr u64 DefaultMaxBytes = 4ull << 30; // 4 GiB
+
+    explicit MeshCache(const Path& dir, u64 maxBytes = DefaultMaxBytes);
+
+    // Cached mesh for a source file hash (nullptr on miss, stale or corrupt entry)
+    MeshPtr load(const std::string& hash) const;
+
+    // Write (or replace) the entry via temp file + rename, then evict down to
+    // maxBytes (never the new entry). Returns false on I/O failure.
+    bool store(const std::string& hash, const Mesh& mesh) const;
+
+    bool contains(const std::string& hash) const;
+
+    // Delete an entry. Returns true if removed or absent.
+    bool remove(const std::string& hash) const;
+
+    Path pathFor(const std::string& hash) const;
+    const Path& directory() const { return m_dir; }
+    u64 maxBytes() const { return m_maxBytes; }
+
+    static constexpr u32 Magic = 0x434D5744; // "DWMC"
+    static constexpr u32 Version = 1;
+
+    // Default location: paths::getMeshCacheDir()
+    static Path defaultDir();
+
+  private:
+    void evictOverflow(const Path& keep) const;
+
+    Path m_dir;
+    u64 m_maxBytes;
+};
+
+} // namespace dw
@@ -0,0 +1,150 @@
+#include "mesh_kernels.h"
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DW_MESH_SSE2 1
+#include <emmintrin.h>
+#else
+#define DW_MESH_SSE2 0
+#endif
+
+namespace dw {
+namespace mesh_kernels {
+
+namespace {
+
+// Shared tail of the normal transform (same expressions as the original scalar loop)
+Vec3 renormalize(f32 x, f32 y, f32 z) {
+    Vec3 n{x, y, z};
+    f32 len = glm::length(n);
+    return (len > 1e-7f) ? (n / len) : Vec3{0.0f, 1.0f, 0.0f};
+}
+
+} // namespace
+
+#if DW_MESH_SSE2
+
+bool simdEnabled() {
+    return true;
+}
+
+namespace {
+
+// Lanes 0..2 of a Vertex member; lane 3 is whatever follows it in the struct.
+// Every Vec3 in Vertex is followed by at least one float, so this stays in bounds.
+__m128 loadXYZ(const Vec3& v) {
+    return _mm_loadu_ps(&v.x);
+}
+
+void storeXYZ(__m128 value, Vec3& out) {
+    alignas(16) f32 lanes[4];
+    _mm_store_ps(lanes, value);
+    out.x = lanes[0];
+    out.y = lanes[1];
+    out.z = lanes[2];
+}
+
+} // namespace
+
+void transformVertices(Vertex* vertices, usize count, const Mat4& matrix) {
+    const __m128 c0 = _mm_loadu_ps(&matrix[0][0]);
+    const __m128 c1 = _mm_loadu_ps(&matrix[1][0]);
+    const __m128 c2 = _mm_loadu_ps(&matrix[2][0]);
+    const __m128 c3 = _mm_loadu_ps(&matrix[3][0]);
+    // GLM evaluates m * v as (c0*x + c1*y) + (c2*z + c3*w); keep that order
+    const __m128 c3w1 = _mm_mul_ps(c3, _mm_set1_ps(1.0f));
+    const __m128 c3w0 = _mm_mul_ps(c3, _mm_setzero_ps());
+
+    for (usize i = 0; i < count; ++i) {
+        Vertex& v = vertices[i];
+
+        const __m128 p = loadXYZ(v.position);
+        const __m128 px = _mm_shuffle_ps(p, p, _MM_SHUFFLE(0, 0, 0, 0));
+        const __m128 py = _mm_shuffle_ps(p, p, _MM_SHUFFLE(1, 1, 1, 1));
+        const __m128 pz = _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 2, 2));
+        const __m128 pos = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, px), _mm_mul_ps(c1, py)),
+                                      _mm_add_ps(_mm_mul_ps(c2, pz), c3w1));
+
+        const __m128 n = loadXYZ(v.normal);
+        const __m128 nx = _mm_shuffle_ps(n, n, _MM_SHUFFLE(0, 0, 0, 0));
+        const __m128 ny = _mm_shuffle_ps(n, n, _MM_SHUFFLE(1, 1, 1, 1));
+        const __m128 nz = _mm_shuffle_ps(n, n, _MM_SHUFFLE(2, 2, 2, 2));
+        const __m128 nrm = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, nx), _mm_mul_ps(c1, ny)),
+                                      _mm_add_ps(_mm_mul_ps(c2, nz), c3w0));
+
+        storeXYZ(pos, v.position);
+        Vec3 tn;
+        storeXYZ(nrm, tn);
+        v.normal = renormalize(tn.x, tn.y, tn.z);
+    }
+}
+
+void expandBounds(const Vertex* vertices, usize count, AABB& bounds) {
+    if (count == 0) {
+        return;
+    }
+    // minps/maxps return the second operand when unordered, matching
+    // AABB::expand's std::min/std::max (a NaN component leaves the bound alone)
+    __m128 lo = _mm_set_ps(0.0f, bounds.min.z, bounds.min.y, bounds.min.x);
+    __m128 hi = _mm_set_ps(0.0f, bounds.max.z, bounds.max.y, bounds.max.x);
+    for (usize i = 0; i < count; ++i) {
+        const __m128 p = loadXYZ(vertices[i].position);
+        lo = _mm_min_ps(p, lo);
+        hi = _mm_max_ps(p, hi);
+    }
+    storeXYZ(lo, bounds.min);
+    storeXYZ(hi, bounds.max);
+}
+
+u32 countNonFinitePositions(const Vertex* vertices, usize count) {
+    u32 bad = 0;
+    for (usize i = 0; i < count; ++i) {
+        const __m128 p = loadXYZ(vertices[i].position);
+        // p - p is 0 for finite values and NaN for NaN/Inf
+        const __m128 d = _mm_sub_ps(p, p);
+        const int ordered = _mm_movemask_ps(_mm_cmpord_ps(d, d));
+        bad += (ordered & 0x7) != 0x7 ? 1u : 0u;
+    }
+    return bad;
+}
+
+#else // Scalar fallback
+
+bool simdEnabled() {
+    return false;
+}
+
+void transformVertices(Vertex* vertices, usize count, const Mat4& matrix) {
+    for (usize i = 0; i < count; ++i) {
+        Vertex& v = vertices[i];
+        Vec4 pos = matrix * Vec4(v.position, 1.0f);
+        v.position = Vec3{pos.x, pos.y, pos.z};
+
+        // Transform normal (assuming no non-uniform scaling)
+        Vec4 norm = matrix * Vec4(v.normal, 0.0f);
+        v.normal = renormalize(norm.x, norm.y, norm.z);
+    }
+}
+
+void expandBounds(const Vertex* vertices, usize count, AABB& bounds) {
+    for (usize i = 0; i < count; ++i) {
+        bounds.expand(vertices[i].position);
+    }
+}
+
+u32 countNonFinitePositions(const Vertex* vertices, usize count) {
+    u32 bad = 0;
+    for (usize i = 0; i < count; ++i) {
+        const Vec3& p = vertices[i].position;
+        if (!std::isfinite(p.x) || !std::isfinite(p.y) || !std::isfinite(p.z)) {
+            ++bad;
+        }
+    }
+    return bad;
+}
+
+#endif
+
+} // namespace mesh_kernels
+} // namespace dw
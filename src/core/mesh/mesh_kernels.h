@@ -0,0 +1,29 @@
+#pragma once
+
+#include "../types.h"
+#include "bounds.h"
+#include "vertex.h"
+
+namespace dw {
+
+// Per-range vertex kernels behind the parallel Mesh operations.
+// SSE2 on x86-64 with a scalar fallback elsewhere. Both paths evaluate the same
+// float operations in the same order as the scalar GLM code they replace, so
+// results are bit-identical whichever path (or chunking) is used.
+namespace mesh_kernels {
+
+// True when the SSE2 path is compiled in
+bool simdEnabled();
+
+// Apply matrix to positions (w=1) and normals (w=0, renormalized; zero-length -> +Y)
+void transformVertices(Vertex* vertices, usize count, const Mat4& matrix);
+
+// Grow bounds by the positions of [vertices, vertices + count)
+void expandBounds(const Vertex* vertices, usize count, AABB& bounds);
+
+// Number of vertices with a NaN or Inf position component
+u32 countNonFinitePositions(const Vertex* vertices, usize count);
+
+} // namespace mesh_kernels
+
+} // namespace dw
@@ -0,0 +1,610 @@
+#include "mesh_optimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "../threading/parallel_for.h"
+#include "compact_mesh.h"
+#include "mesh.h"
+
+namespace dw {
+namespace mesh_opt {
+
+namespace {
+
+constexpr u32 INVALID = std::numeric_limits<u32>::max();
+constexpr usize GRAIN = 16384;
+
+// Post-transform cache modelled by the Forsyth scorer
+constexpr u32 CACHE_SIZE = 32;
+// FIFO size used to find overdraw cluster boundaries (typical hardware)
+constexpr u32 CLUSTER_CACHE_SIZE = 16;
+
+struct WeldKey {
+    i64 x = 0;
+    i64 y = 0;
+    i64 z = 0;
+    u32 u = 0;
+    u32 v = 0;
+
+    bool operator==(const WeldKey& o) const {
+        return x == o.x && y == o.y && z == o.z && u == o.u && v == o.v;
+    }
+};
+
+u32 floatBits(f32 value) {
+    value += 0.0f; // -0 -> +0
+    u32 bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+u64 hashKey(const WeldKey& k) {
+    u64 h = static_cast<u64>(k.x) * 0x9E3779B97F4A7C15ULL;
+    h ^= static_cast<u64>(k.y) * 0xC2B2AE3D27D4EB4FULL;
+    h ^= static_cast<u64>(k.z) * 0x165667B19E3779F9ULL;
+    h ^= ((static_cast<u64>(k.u) << 32) | k.v) * 0x27D4EB2F165667C5ULL;
+    return h ^ (h >> 29);
+}
+
+// Faces around one vertex sharing a quantized normal direction
+struct NormalBucket {
+    Vec3 unit;   // Representative unit normal
+    Vec3 area;   // Sum of the faces' area-weighted normals
+    Vec3 normal; // Crease-limited average seen from this direction
+};
+
+// Whole triangles only, every index naming a vertex
+bool isTriangleList(const std::vector<u32>& indices, usize vertexCount) {
+    if (indices.size() % 3 != 0) {
+        return false;
+    }
+    for (u32 idx : indices) {
+        if (idx >= vertexCount) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Vertex -> incident corner (triangle * 3 + corner) lists, in triangle order
+struct CornerAdjacency {
+    std::vector<u32> offsets;
+    std::vector<u32> corners;
+
+    CornerAdjacency(const std::vector<u32>& indices, u32 vertexCount)
+        : offsets(static_cast<usize>(vertexCount) + 1, 0), corners(indices.size()) {
+        for (u32 idx : indices) {
+            ++offsets[idx + 1];
+        }
+        for (u32 v = 0; v < vertexCount; ++v) {
+            offsets[v + 1] += offsets[v];
+        }
+        std::vector<u32> cursor(offsets.begin(), offsets.end() - 1);
+        for (usize i = 0; i < indices.size(); ++i) {
+            corners[cursor[indices[i]]++] = static_cast<u32>(i);
+        }
+    }
+};
+
+Vec3 faceCross(const std::vector<Vertex>& verts, const u32* tri) {
+    const Vec3& p0 = verts[tri[0]].position;
+    return glm::cross(verts[tri[1]].position - p0, verts[tri[2]].position - p0);
+}
+
+Vec3 unitOrUp(const Vec3& n) {
+    f32 len = glm::length(n);
+    return len > 1e-20f ? n / len : Vec3{0.0f, 1.0f, 0.0f};
+}
+
+// Forsyth vertex score: recency in the cache plus a bonus for few remaining triangles
+f32 vertexScore(i32 cachePos, u32 remaining) {
+    if (remaining == 0) {
+        return -1.0f;
+    }
+    f32 score = 0.0f;
+    if (cachePos >= 0) {
+        if (cachePos < 3) {
+            score = 0.75f; // Used by the last triangle: no extra benefit from its position
+        } else {
+            const f32 scale = 1.0f / static_cast<f32>(CACHE_SIZE - 3);
+            score = std::pow(1.0f - static_cast<f32>(cachePos - 3) * scale, 1.5f);
+        }
+    }
+    return score + 2.0f / std::sqrt(static_cast<f32>(remaining));
+}
+
+} // namespace
+
+u32 weldVertices(Mesh& mesh, f32 tolerance) {
+    auto& verts = mesh.vertices();
+    auto& indices = mesh.indices();
+    if (verts.empty()) {
+        return 0;
+    }
+
+    mesh.recalculateBounds();
+    const f32 cell = tolerance > 0.0f ? tolerance * mesh.bounds().diagonal() : 0.0f;
+    const bool withUVs = mesh.hasTexCoords();
+
+    auto keyOf = [&](const Vertex& v) {
+        WeldKey k;
+        if (cell > 0.0f) {
+            k.x = std::llround(v.position.x / cell);
+            k.y = std::llround(v.position.y / cell);
+            k.z = std::llround(v.position.z / cell);
+        } else {
+            k.x = floatBits(v.position.x);
+            k.y = floatBits(v.position.y);
+            k.z = floatBits(v.position.z);
+        }
+        if (withUVs) {
+            k.u = floatBits(v.texCoord.x);
+            k.v = floatBits(v.texCoord.y);
+        }
+        return k;
+    };
+
+    // Open-addressing table of output vertex indices
+    usize capacity = 16;
+    while (capacity < verts.size() * 2) {
+        capacity <<= 1;
+    }
+    const usize mask = capacity - 1;
+    std::vector<u32> table(capacity, INVALID);
+    std::vector<WeldKey> keys;
+    std::vector<Vertex> welded;
+    std::vector<u32> remap(verts.size());
+
+    for (usize i = 0; i < verts.size(); ++i) {
+        const WeldKey key = keyOf(verts[i]);
+        usize slot = static_cast<usize>(hashKey(key)) & mask;
+        while (table[slot] != INVALID && !(keys[table[slot]] == key)) {
+            slot = (slot + 1) & mask;
+        }
+        if (table[slot] == INVALID) {
+            table[slot] = static_cast<u32>(welded.size());
+            keys.push_back(key);
+            welded.push_back(verts[i]);
+        }
+        remap[i] = table[slot];
+    }
+
+    // Rewrite triangles, dropping any that collapsed (or referenced a bad index)
+    std::vector<u32> out;
+    out.reserve(indices.size());
+    const usize vertCount = verts.size();
+    for (usize i = 0; i + 2 < indices.size(); i += 3) {
+        if (indices[i] >= vertCount || indices[i + 1] >= vertCount ||
+            indices[i + 2] >= vertCount) {
+            continue;
+        }
+        const u32 a = remap[indices[i]];
+        const u32 b = remap[indices[i + 1]];
+        const u32 c = remap[indices[i + 2]];
+        if (a == b || b == c || a == c) {
+            continue;
+        }
+        out.insert(out.end(), {a, b, c});
+    }
+
+    const auto removed = static_cast<u32>(verts.size() - welded.size());
+    verts = std::move(welded);
+    indices = std::move(out);
+    mesh.recalculateBounds();
+    mesh.invalidateHash();
+    return removed;
+}
+
+void computeCreaseNormals(Mesh& mesh, f32 creaseAngleDeg) {
+    auto& verts = mesh.vertices();
+    auto& indices = mesh.indices();
+    const usize triCount = indices.size() / 3;
+    if (verts.empty() || triCount == 0 || !isTriangleList(indices, verts.size())) {
+        return;
+    }
+
+    // Area-weighted and unit face normals
+    std::vector<Vec3> faceArea(triCount);
+    std::vector<Vec3> faceUnit(triCount);
+    parallelFor(triCount, GRAIN, [&](usize begin, usize end) {
+        for (usize t = begin; t < end; ++t) {
+            faceArea[t] = faceCross(verts, &indices[t * 3]);
+            f32 len = glm::length(faceArea[t]);
+            faceUnit[t] = len > 0.0f ? faceArea[t] / len : Vec3{0.0f, 0.0f, 0.0f};
+        }
+    });
+
+    const CornerAdjacency adj(indices, mesh.vertexCount());
+    const f32 cosCrease = std::cos(creaseAngleDeg * 3.14159265358979323846f / 180.0f);
+
+    // Each corner averages the faces around its vertex that are within the crease
+    // angle of its own face (degenerate faces take the plain average). Faces are
+    // first bucketed by quantized normal, so the angle test runs per pair of
+    // distinct directions rather than per pair of faces: a fan of coplanar
+    // faces around a high-valence vertex costs O(valence), not O(valence^2).
+    std::vector<Vec3> cornerNormal(indices.size());
+    parallelFor(verts.size(), GRAIN, [&](usize begin, usize end) {
+        std::vector<std::pair<u16, u32>> keyed; // (normal key, corner)
+        std::vector<NormalBucket> buckets;
+        for (usize v = begin; v < end; ++v) {
+            keyed.clear();
+            buckets.clear();
+            Vec3 total{0.0f, 0.0f, 0.0f};
+            for (u32 k = adj.offsets[v]; k < adj.offsets[v + 1]; ++k) {
+                const u32 corner = adj.corners[k];
+                total = total + faceArea[corner / 3];
+                const Vec3& own = faceUnit[corner / 3];
+                if (own.x == 0.0f && own.y == 0.0f && own.z == 0.0f) {
+                    cornerNormal[corner] = Vec3{0.0f, 0.0f, 0.0f}; // Degenerate: set below
+                    continue;
+                }
+                keyed.emplace_back(quant::encodeOctahedral(own), corner);
+            }
+            std::sort(keyed.begin(), keyed.end());
+
+            for (usize i = 0; i < keyed.size(); ++i) {
+                const u32 face = keyed[i].second / 3;
+                if (i == 0 || keyed[i].first != keyed[i - 1].first) {
+                    const Vec3 zero{0.0f, 0.0f, 0.0f};
+                    buckets.push_back({faceUnit[face], zero, zero});
+                }
+                buckets.back().area = buckets.back().area + faceArea[face];
+            }
+            for (auto& bucket : buckets) {
+                Vec3 sum{0.0f, 0.0f, 0.0f};
+                for (const auto& other : buckets) {
+                    if (glm::dot(bucket.unit, other.unit) >= cosCrease) {
+                        sum = sum + other.area;
+                    }
+                }
+                bucket.normal = unitOrUp(sum);
+            }
+
+            usize bucket = 0;
+            for (usize i = 0; i < keyed.size(); ++i) {
+                if (i > 0 && keyed[i].first != keyed[i - 1].first) {
+                    ++bucket;
+                }
+                cornerNormal[keyed[i].second] = buckets[bucket].normal;
+            }
+            const Vec3 average = unitOrUp(total);
+            for (u32 k = adj.offsets[v]; k < adj.offsets[v + 1]; ++k) {
+                const Vec3& own = faceUnit[adj.corners[k] / 3];
+                if (own.x == 0.0f && own.y == 0.0f && own.z == 0.0f) {
+                    cornerNormal[adj.corners[k]] = average;
+                }
+            }
+        }
+    });
+
+    // Split vertices whose corners ended up with different normals
+    std::vector<Vertex> out;
+    out.reserve(verts.size());
+    std::vector<u32> variants;
+    for (usize v = 0; v < verts.size(); ++v) {
+        variants.clear();
+        for (u32 k = adj.offsets[v]; k < adj.offsets[v + 1]; ++k) {
+            const u32 corner = adj.corners[k];
+            const Vec3& n = cornerNormal[corner];
+            u32 target = INVALID;
+            for (u32 candidate : variants) {
+                if (out[candidate].normal == n) {
+                    target = candidate;
+                    break;
+                }
+            }
+            if (target == INVALID) {
+                target = static_cast<u32>(out.size());
+                Vertex split = verts[v];
+                split.normal = n;
+                out.push_back(split);
+                variants.push_back(target);
+            }
+            indices[corner] = target;
+        }
+    }
+
+    verts = std::move(out);
+    mesh.recalculateBounds();
+    mesh.invalidateHash();
+}
+
+void optimizeVertexCache(std::vector<u32>& indices, u32 vertexCount) {
+    const usize triCount = indices.size() / 3;
+    const usize triIndexCount = triCount * 3;
+    if (triCount < 2) {
+        return;
+    }
+    // Out-of-range indices have no adjacency slot: leave such input as it is
+    for (usize i = 0; i < triIndexCount; ++i) {
+        if (indices[i] >= vertexCount) {
+            return;
+        }
+    }
+
+    // Vertex -> triangle lists; the first `remaining[v]` entries are not yet emitted
+    std::vector<u32> offsets(static_cast<usize>(vertexCount) + 1, 0);
+    for (usize i = 0; i < triIndexCount; ++i) {
+        ++offsets[indices[i] + 1];
+    }
+    for (u32 v = 0; v < vertexCount; ++v) {
+        offsets[v + 1] += offsets[v];
+    }
+    std::vector<u32> adjacency(triIndexCount);
+    std::vector<u32> remaining(vertexCount, 0);
+    for (usize t = 0; t < triCount; ++t) {
+        for (usize c = 0; c < 3; ++c) {
+            const u32 v = indices[t * 3 + c];
+            adjacency[offsets[v] + remaining[v]++] = static_cast<u32>(t);
+        }
+    }
+
+    std::vector<i32> cachePos(vertexCount, -1);
+    std::vector<f32> vScore(vertexCount);
+    for (u32 v = 0; v < vertexCount; ++v) {
+        vScore[v] = vertexScore(-1, remaining[v]);
+    }
+    std::vector<f32> tScore(triCount);
+    std::vector<u8> emitted(triCount, 0);
+    u32 best = 0;
+    for (usize t = 0; t < triCount; ++t) {
+        const u32* tri = &indices[t * 3];
+        tScore[t] = vScore[tri[0]] + vScore[tri[1]] + vScore[tri[2]];
+        if (tScore[t] > tScore[best]) {
+            best = static_cast<u32>(t);
+        }
+    }
+
+    std::vector<u32> out;
+    out.reserve(indices.size());
+    std::vector<u32> cache;
+    std::vector<u32> nextCache;
+    cache.reserve(CACHE_SIZE + 3);
+    nextCache.reserve(CACHE_SIZE + 3);
+    usize scanCursor = 0;
+
+    while (out.size() < triIndexCount) {
+        if (best == INVALID) {
+            // Nothing in the cache scores: continue with the next unemitted triangle
+            while (emitted[scanCursor]) {
+                ++scanCursor;
+            }
+            best = static_cast<u32>(scanCursor);
+        }
+
+        const u32* tri = &indices[static_cast<usize>(best) * 3];
+        emitted[best] = 1;
+        out.insert(out.end(), {tri[0], tri[1], tri[2]});
+
+        // Drop the triangle from its vertices' active lists
+        for (int c = 0; c < 3; ++c) {
+            const u32 v = tri[c];
+            u32* list = &adjacency[offsets[v]];
+            for (u32 i = 0; i < remaining[v]; ++i) {
+                if (list[i] == best) {
+                    std::swap(list[i], list[remaining[v] - 1]);
+                    --remaining[v];
+                    break;
+                }
+            }
+        }
+
+        // New cache: this triangle's vertices in front, then the previous contents
+        nextCache.assign(tri, tri + 3);
+        for (u32 v : cache) {
+            if (v != tri[0] && v != tri[1] && v != tri[2]) {
+                nextCache.push_back(v);
+            }
+        }
+        for (usize i = CACHE_SIZE; i < nextCache.size(); ++i) {
+            // Evicted: rescore the vertex and the triangles still waiting on it
+            const u32 v = nextCache[i];
+            cachePos[v] = -1;
+            vScore[v] = vertexScore(-1, remaining[v]);
+            for (u32 j = 0; j < remaining[v]; ++j) {
+                const u32 t = adjacency[offsets[v] + j];
+                const u32* tv = &indices[static_cast<usize>(t) * 3];
+                tScore[t] = vScore[tv[0]] + vScore[tv[1]] + vScore[tv[2]];
+            }
+        }
+        if (nextCache.size() > CACHE_SIZE) {
+            nextCache.resize(CACHE_SIZE);
+        }
+        std::swap(cache, nextCache);
+
+        for (usize i = 0; i < cache.size(); ++i) {
+            const u32 v = cache[i];
+            cachePos[v] = static_cast<i32>(i);
+            vScore[v] = vertexScore(cachePos[v], remaining[v]);
+        }
+
+        // Rescore triangles touching the cache and pick the best of them
+        best = INVALID;
+        f32 bestScore = -1.0f;
+        for (u32 v : cache) {
+            for (u32 j = 0; j < remaining[v]; ++j) {
+                const u32 t = adjacency[offsets[v] + j];
+                const u32* tv = &indices[static_cast<usize>(t) * 3];
+                tScore[t] = vScore[tv[0]] + vScore[tv[1]] + vScore[tv[2]];
+                if (tScore[t] > bestScore) {
+                    bestScore = tScore[t];
+                    best = t;
+                }
+            }
+        }
+    }
+
+    // A trailing partial triangle is not a triangle: keep it at the end
+    out.insert(out.end(),
+               indices.begin() + static_cast<std::ptrdiff_t>(triIndexCount),
+               indices.end());
+    indices = std::move(out);
+}
+
+void optimizeOverdraw(Mesh& mesh) {
+    const auto& verts = mesh.vertices();
+    auto& indices = mesh.indices();
+    const usize triCount = indices.size() / 3;
+    if (triCount < 2) {
+        return;
+    }
+
+    // Cluster boundaries: triangles that miss the cache on all three vertices.
+    // Reordering whole clusters keeps the vertex cache ordering intact.
+    std::vector<u32> clusterStart;
+    std::vector<u32> fifo(CLUSTER_CACHE_SIZE, INVALID);
+    u32 head = 0;
+    for (usize t = 0; t < triCount; ++t) {
+        int misses = 0;
+        for (usize c = 0; c < 3; ++c) {
+            const u32 v = indices[t * 3 + c];
+            if (std::find(fifo.begin(), fifo.end(), v) == fifo.end()) {
+                fifo[head] = v;
+                head = (head + 1) % CLUSTER_CACHE_SIZE;
+                ++misses;
+            }
+        }
+        if (t == 0 || misses == 3) {
+            clusterStart.push_back(static_cast<u32>(t));
+        }
+    }
+    if (clusterStart.size() < 2) {
+        return;
+    }
+    clusterStart.push_back(static_cast<u32>(triCount));
+
+    // Area-weighted centroid and normal per cluster
+    const usize clusterCount = clusterStart.size() - 1;
+    std::vector<Vec3> centroid(clusterCount);
+    std::vector<Vec3> normal(clusterCount);
+    std::vector<f32> area(clusterCount);
+    Vec3 meshCentroid{0.0f, 0.0f, 0.0f};
+    f32 meshArea = 0.0f;
+    for (usize c = 0; c < clusterCount; ++c) {
+        Vec3 sum{0.0f, 0.0f, 0.0f};
+        Vec3 n{0.0f, 0.0f, 0.0f};
+        f32 a = 0.0f;
+        for (u32 t = clusterStart[c]; t < clusterStart[c + 1]; ++t) {
+            const u32* tri = &indices[static_cast<usize>(t) * 3];
+            const Vec3 cross = faceCross(verts, tri);
+            const f32 triArea = glm::length(cross);
+            const Vec3 mid =
+                (verts[tri[0]].position + verts[tri[1]].position + verts[tri[2]].position) / 3.0f;
+            sum = sum + mid * triArea;
+            n = n + cross;
+            a += triArea;
+        }
+        centroid[c] = a > 0.0f ? sum / a : verts[indices[clusterStart[c] * 3u]].position;
+        normal[c] = n;
+        area[c] = a;
+        meshCentroid = meshCentroid + sum;
+        meshArea += a;
+    }
+    if (meshArea > 0.0f) {
+        meshCentroid = meshCentroid / meshArea;
+    }
+
+    // Clusters facing away from the centre are drawn first: from any viewpoint
+    // they tend to occlude the inward-facing ones behind them
+    std::vector<f32> sortKey(clusterCount);
+    for (usize c = 0; c < clusterCount; ++c) {
+        f32 len = glm::length(normal[c]);
+        sortKey[c] = len > 0.0f ? glm::dot(centroid[c] - meshCentroid, normal[c] / len) : 0.0f;
+    }
+    std::vector<u32> order(clusterCount);
+    for (usize c = 0; c < clusterCount; ++c) {
+        order[c] = static_cast<u32>(c);
+    }
+    std::stable_sort(order.begin(), order.end(), [&](u32 a, u32 b) {
+        return sortKey[a] > sortKey[b];
+    });
+
+    std::vector<u32> out;
+    out.reserve(indices.size());
+    for (u32 c : order) {
+        out.insert(out.end(),
+                   indices.begin() + static_cast<std::ptrdiff_t>(clusterStart[c]) * 3,
+                   indices.begin() + static_cast<std::ptrdiff_t>(clusterStart[c + 1]) * 3);
+    }
+    indices = std::move(out);
+    mesh.invalidateHash();
+}
+
+void optimizeVertexFetch(Mesh& mesh) {
+    auto& verts = mesh.vertices();
+    auto& indices = mesh.indices();
+    if (verts.empty()) {
+        return;
+    }
+
+    std::vector<u32> remap(verts.size(), INVALID);
+    std::vector<Vertex> out;
+    out.reserve(verts.size());
+    for (u32& idx : indices) {
+        if (remap[idx] == INVALID) {
+            remap[idx] = static_cast<u32>(out.size());
+            out.push_back(verts[idx]);
+        }
+        idx = remap[idx];
+    }
+
+    verts = std::move(out);
+    mesh.recalculateBounds();
+    mesh.invalidateHash();
+}
+
+f32 computeAcmr(const std::vector<u32>& indices, u32 vertexCount, u32 cacheSize) {
+    const usize triCount = indices.size() / 3;
+    if (triCount == 0 || cacheSize == 0) {
+        return 0.0f;
+    }
+
+    // FIFO cache using per-vertex insertion timestamps
+    std::vector<u64> insertedAt(vertexCount, 0);
+    u64 clock = cacheSize + 1; // Anything inserted before clock - cacheSize is evicted
+    u64 misses = 0;
+    for (u32 idx : indices) {
+        if (idx >= vertexCount) {
+            continue;
+        }
+        if (clock - insertedAt[idx] > cacheSize) {
+            insertedAt[idx] = clock++;
+            ++misses;
+        }
+    }
+    return static_cast<f32>(misses) / static_cast<f32>(triCount);
+}
+
+Stats optimize(Mesh& mesh, const Options& options) {
+    Stats stats;
+    stats.verticesBefore = mesh.vertexCount();
+    stats.trianglesBefore = mesh.triangleCount();
+    stats.acmrBefore = computeAcmr(mesh.indices(), mesh.vertexCount());
+
+    if (mesh.isValid()) {
+        weldVertices(mesh, options.weldTolerance);
+        computeCreaseNormals(mesh, options.creaseAngleDeg);
+        if (options.optimizeVertexCache) {
+            optimizeVertexCache(mesh.indices(), mesh.vertexCount());
+        }
+        if (options.optimizeOverdraw) {
+            optimizeOverdraw(mesh);
+        }
+        if (options.optimizeVertexFetch) {
+            optimizeVertexFetch(mesh);
+        }
+    }
+
+    stats.verticesAfter = mesh.vertexCount();
+    stats.trianglesAfter = mesh.triangleCount();
+    stats.acmrAfter = computeAcmr(mesh.indices(), mesh.vertexCount());
+    return stats;
+}
+
+} // namespace mesh_opt
+} // namespace dw
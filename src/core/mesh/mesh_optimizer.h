@@ -0,0 +1,66 @@
+#pragma once
+
+#include <vector>
+
+#include "../types.h"
+
+namespace dw {
+
+class Mesh;
+
+// Import-time mesh optimization: weld, crease normals, GPU-friendly ordering.
+namespace mesh_opt {
+
+// Bump when the output of optimize() changes so cached results are rebuilt
+constexpr u32 VERSION = 1;
+
+struct Options {
+    // Weld grid size as a fraction of the bounds diagonal (0 = exact positions only)
+    f32 weldTolerance = 1e-6f;
+    // Faces meeting at more than this angle keep a hard edge (split vertices)
+    f32 creaseAngleDeg = 40.0f;
+    bool optimizeVertexCache = true;
+    bool optimizeOverdraw = true;
+    bool optimizeVertexFetch = true;
+};
+
+struct Stats {
+    u32 verticesBefore = 0;
+    u32 verticesAfter = 0;
+    u32 trianglesBefore = 0;
+    u32 trianglesAfter = 0; // Degenerates created by welding are dropped
+    f32 acmrBefore = 0.0f;
+    f32 acmrAfter = 0.0f;
+};
+
+// Run the full pipeline in place: weld -> crease normals -> vertex cache ->
+// overdraw -> vertex fetch. Texture coordinates are preserved (welding only
+// merges vertices whose UVs match).
+Stats optimize(Mesh& mesh, const Options& options = {});
+
+// Merge vertices whose positions quantize to the same grid cell and drop
+// triangles that collapse. Returns the number of vertices removed.
+u32 weldVertices(Mesh& mesh, f32 tolerance);
+
+// Per-corner normals averaged over adjacent faces within the crease angle;
+// vertices are split where a hard edge needs distinct normals.
+void computeCreaseNormals(Mesh& mesh, f32 creaseAngleDeg);
+
+// Reorder triangles for the post-transform vertex cache (Forsyth's linear-speed
+// algorithm). Does not touch the vertex buffer. A trailing partial triangle is
+// kept at the end; input with indices >= vertexCount is left unchanged.
+void optimizeVertexCache(std::vector<u32>& indices, u32 vertexCount);
+
+// Reorder cache-friendly triangle clusters roughly front-to-back from every view
+// direction (outward-facing clusters first) to reduce overdraw.
+void optimizeOverdraw(Mesh& mesh);
+
+// Renumber vertices in first-use order (and drop unreferenced ones)
+void optimizeVertexFetch(Mesh& mesh);
+
+// Average cache miss ratio (transformed vertices per triangle) for a FIFO cache
+f32 computeAcmr(const std::vector<u32>& indices, u32 vertexCount, u32 cacheSize = 16);
+
+} // namespace mesh_opt
+
+} // namespace dw
@@ -104,12 +104,25 @@ bool CloResultFile::save(const std::string& name,
 
         auto& sheetsArr = planObj["sheets"];
         sheetsArr = json::array();
-        for (const auto& sr : gr.plan.sheets) {
+        for (size_t si = 0; si < gr.plan.sheets.size(); ++si) {
+            const auto& sr = gr.plan.sheets[si];
             json sheetResult;
             sheetResult["sheet_index"] = sr.sheetIndex;
             sheetResult["used_area"] = sr.usedArea;
             sheetResult["waste_area"] = sr.wasteArea;
 
+            // Per-sheet stock, only written for groups that mix stock sizes
+            if (gr.mixedStock()) {
+                const auto& stock = gr.stockFor(si);
+                sheetResult["stock"] = {
+                    {"width", stock.width},
+                    {"height", stock.height},
+                    {"cost", stock.cost},
+                    {"name", stock.name},
+                    {"grain_horizontal", stock.grainHorizontal}
+                };
+            }
+
             auto& placementsArr = sheetResult["placements"];
             placementsArr = json::array();
             for (const auto& p : sr.placements) {
@@ -255,6 +268,21 @@ std::optional<CloResultFile::LoadResult> CloResultFile::load(const Path& filePat
                         sheetResult.usedArea = sr.value("used_area", 0.0f);
                         sheetResult.wasteArea = sr.value("waste_area", 0.0f);
 
+                        if (sr.contains("stock")) {
+                            auto& st = sr["stock"];
+                            // Sheets before the first with its own stock used usedSheet
+                            gr.sheetStock.resize(gr.plan.sheets.size(), gr.usedSheet);
+                            optimizer::Sheet stock;
+                            stock.width = st.value("width", 0.0f);
+                            stock.height = st.value("height", 0.0f);
+                            stock.cost = st.value("cost", 0.0f);
+                            stock.name = st.value("name", std::string{});
+                            stock.grainHorizontal = st.value("grain_horizontal", true);
+                            gr.sheetStock.push_back(stock);
+                        } else if (!gr.sheetStock.empty()) {
+                            gr.sheetStock.push_back(gr.usedSheet);
+                        }
+
                         if (sr.contains("placements") && sr["placements"].is_array()) {
                             for (const auto& pl : sr["placements"]) {
                                 optimizer::Placement placement;
@@ -20,10 +20,13 @@ CutPlan GuillotineOptimizer::optimize(const std::vector<Part>& parts,
     }
 
     // Expand parts by quantity and sort by area (decreasing)
-    auto expandedParts = expandParts(parts);
+    expandParts(parts, m_expanded);
+    const auto& expandedParts = m_expanded;
 
     // Track which parts have been placed
-    std::vector<bool> placed(expandedParts.size(), false);
+    m_placed.assign(expandedParts.size(), 0);
+    auto& placed = m_placed;
+    usize placedCount = 0;
 
     // Process sheets
     for (int sheetIdx = 0; sheetIdx < static_cast<int>(sheets.size()); ++sheetIdx) {
@@ -38,11 +41,8 @@ CutPlan GuillotineOptimizer::optimize(const std::vector<Part>& parts,
         }
 
         // Create root node for this sheet
-        auto root = std::make_unique<Node>();
-        root->x = m_margin;
-        root->y = m_margin;
-        root->width = effectiveWidth;
-        root->height = effectiveHeight;
+        m_nodes.clear();
+        const i32 root = addNode(m_margin, m_margin, effectiveWidth, effectiveHeight);
 
         SheetResult sheetResult;
         sheetResult.sheetIndex = sheetIdx;
@@ -58,39 +58,26 @@ CutPlan GuillotineOptimizer::optimize(const std::vector<Part>& parts,
             f32 partHeight = ep.part->height + m_kerf;
 
             // Try to insert (with optional rotation)
-            Node* node = insert(root.get(), partWidth, partHeight);
-
-            if (!node && m_allowRotation && ep.part->canRotate) {
-                node = insert(root.get(), partHeight, partWidth);
-                if (node) {
-                    // Mark as rotated
-                    Placement placement;
-                    placement.part = ep.part;
-                    placement.partIndex = ep.partIndex;
-                    placement.instanceIndex = ep.instanceIndex;
-                    placement.x = node->x;
-                    placement.y = node->y;
-                    placement.rotated = true;
-
-                    sheetResult.placements.push_back(placement);
-                    sheetResult.usedArea += ep.part->area();
-                    placed[i] = true;
-                    continue;
-                }
+            bool rotated = false;
+            i32 node = insert(root, partWidth, partHeight);
+            if (node == kNoNode && m_allowRotation && ep.part->canRotate) {
+                node = insert(root, partHeight, partWidth);
+                rotated = true;
             }
 
-            if (node) {
+            if (node != kNoNode) {
                 Placement placement;
                 placement.part = ep.part;
                 placement.partIndex = ep.partIndex;
                 placement.instanceIndex = ep.instanceIndex;
-                placement.x = node->x;
-                placement.y = node->y;
-                placement.rotated = false;
+                placement.x = m_nodes[static_cast<usize>(node)].x;
+                placement.y = m_nodes[static_cast<usize>(node)].y;
+                placement.rotated = rotated;
 
                 sheetResult.placements.push_back(placement);
                 sheetResult.usedArea += ep.part->area();
-                placed[i] = true;
+                placed[i] = 1;
+                ++placedCount;
             }
         }
 
@@ -105,15 +92,7 @@ CutPlan GuillotineOptimizer::optimize(const std::vector<Part>& parts,
         }
 
         // Check if all parts are placed
-        bool allPlaced = true;
-        for (bool p : placed) {
-            if (!p) {
-                allPlaced = false;
-                break;
-            }
-        }
-
-        if (allPlaced) {
+        if (placedCount == expandedParts.size()) {
             break;
         }
     }
@@ -131,66 +110,91 @@ CutPlan GuillotineOptimizer::optimize(const std::vector<Part>& parts,
     return plan;
 }
 
-GuillotineOptimizer::Node* GuillotineOptimizer::insert(Node* node, f32 width, f32 height) {
-    // If this node is used, try children
-    if (node->used) {
-        Node* result = nullptr;
-        if (node->right) {
-            result = insert(node->right.get(), width, height);
-        }
-        if (!result && node->down) {
-            result = insert(node->down.get(), width, height);
+i32 GuillotineOptimizer::addNode(f32 x, f32 y, f32 width, f32 height) {
+    Node node;
+    node.x = x;
+    node.y = y;
+    node.width = width;
+    node.height = height;
+    node.freeWidth = width;
+    node.freeHeight = height;
+    m_nodes.push_back(node);
+    return static_cast<i32>(m_nodes.size() - 1);
+}
+
+i32 GuillotineOptimizer::insert(i32 index, f32 width, f32 height) {
+    // Children are appended to m_nodes, so nodes are looked up by index
+    // again after any call that may grow it
+    const auto at = static_cast<usize>(index);
+    {
+        const Node& node = m_nodes[at];
+
+        // Nothing below is large enough (with epsilon tolerance for float
+        // rounding); for a free leaf this is the plain fit test
+        if (width > node.freeWidth + PLACEMENT_EPSILON ||
+            height > node.freeHeight + PLACEMENT_EPSILON) {
+            return kNoNode;
         }
-        return result;
-    }
 
-    // If it doesn't fit, return null (with epsilon tolerance for float rounding)
-    if (width > node->width + PLACEMENT_EPSILON || height > node->height + PLACEMENT_EPSILON) {
-        return nullptr;
-    }
+        // If this node is used, try children
+        if (node.used) {
+            const i32 right = node.right;
+            const i32 down = node.down;
+            i32 result = kNoNode;
+            if (right != kNoNode) {
+                result = insert(right, width, height);
+            }
+            if (result == kNoNode && down != kNoNode) {
+                result = insert(down, width, height);
+            }
+            if (result != kNoNode) {
+                updateFreeSize(at);
+            }
+            return result;
+        }
 
-    // Perfect fit (within epsilon)
-    if (node->width - width < PLACEMENT_EPSILON && node->height - height < PLACEMENT_EPSILON) {
-        node->used = true;
-        return node;
+        // Perfect fit (within epsilon)
+        if (node.width - width < PLACEMENT_EPSILON && node.height - height < PLACEMENT_EPSILON) {
+            Node& filled = m_nodes[at];
+            filled.used = true;
+            filled.freeWidth = 0.0f;
+            filled.freeHeight = 0.0f;
+            return index;
+        }
     }
 
     // Split the node
-    node->used = true;
-
     // Decide split direction (split along longer remainder)
-    f32 dw = node->width - width;
-    f32 dh = node->height - height;
+    const Node node = m_nodes[at];
+    f32 dw = node.width - width;
+    f32 dh = node.height - height;
 
+    i32 right = kNoNode;
+    i32 down = kNoNode;
     if (dw > dh) {
         // Horizontal split: right gets the wider piece
-        node->right = std::make_unique<Node>();
-        node->right->x = node->x + width;
-        node->right->y = node->y;
-        node->right->width = dw;
-        node->right->height = height;
-
-        node->down = std::make_unique<Node>();
-        node->down->x = node->x;
-        node->down->y = node->y + height;
-        node->down->width = node->width;
-        node->down->height = dh;
+        right = addNode(node.x + width, node.y, dw, height);
+        down = addNode(node.x, node.y + height, node.width, dh);
     } else {
         // Vertical split: down gets the taller piece
-        node->right = std::make_unique<Node>();
-        node->right->x = node->x + width;
-        node->right->y = node->y;
-        node->right->width = dw;
-        node->right->height = node->height;
-
-        node->down = std::make_unique<Node>();
-        node->down->x = node->x;
-        node->down->y = node->y + height;
-        node->down->width = width;
-        node->down->height = dh;
+        right = addNode(node.x + width, node.y, dw, node.height);
+        down = addNode(node.x, node.y + height, width, dh);
     }
 
-    return node;
+    Node& split = m_nodes[at];
+    split.used = true;
+    split.right = right;
+    split.down = down;
+    updateFreeSize(at);
+    return index;
+}
+
+void GuillotineOptimizer::updateFreeSize(usize index) {
+    Node& node = m_nodes[index];
+    const Node& right = m_nodes[static_cast<usize>(node.right)];
+    const Node& down = m_nodes[static_cast<usize>(node.down)];
+    node.freeWidth = std::max(right.freeWidth, down.freeWidth);
+    node.freeHeight = std::max(right.freeHeight, down.freeHeight);
 }
 
 } // namespace optimizer
@@ -1,12 +1,20 @@
 #pragma once
 
+#include <vector>
+
 #include "cut_optimizer.h"
+#include "optimizer_utils.h"
 
 namespace dw {
 namespace optimizer {
 
 // Guillotine algorithm - restricts cuts to guillotine patterns
-// (straight through cuts), which is more practical for CNC cutting
+// (straight through cuts), which is more practical for CNC cutting.
+//
+// The free-space tree lives in a flat node arena indexed by position, and the
+// expanded part list is kept between calls, so reusing one optimizer for
+// repeated runs (stock-size trials, multi-start searches) packs without
+// allocating once its buffers have grown.
 class GuillotineOptimizer : public CutOptimizer {
   public:
     GuillotineOptimizer() = default;
@@ -14,19 +22,28 @@ class GuillotineOptimizer : public CutOptimizer {
     CutPlan optimize(const std::vector<Part>& parts, const std::vector<Sheet>& sheets) override;
 
   private:
+    static constexpr i32 kNoNode = -1;
+
+    // Free rectangle; once used, its remainder is split into two children.
+    // freeWidth/freeHeight bound the largest free leaf below (they may come
+    // from different leaves), so inserts skip subtrees nothing can fit in.
     struct Node {
         f32 x, y, width, height;
+        f32 freeWidth, freeHeight;
         bool used = false;
-        std::unique_ptr<Node> right;
-        std::unique_ptr<Node> down;
+        i32 right = kNoNode;
+        i32 down = kNoNode;
     };
 
-    Node* insert(Node* node, f32 width, f32 height);
-    void collectPlacements(Node* node,
-                           std::vector<Placement>& placements,
-                           const Part* part,
-                           int partIndex,
-                           int instanceIndex);
+    i32 addNode(f32 x, f32 y, f32 width, f32 height);
+    i32 insert(i32 node, f32 width, f32 height);
+    // Refresh a split node's free-size bounds from its two children
+    void updateFreeSize(usize node);
+
+    // Scratch reused across optimize() calls: cleared per run, never shrunk
+    std::vector<Node> m_nodes; // Tree of the sheet being filled; root at 0
+    std::vector<ExpandedPart> m_expanded;
+    std::vector<u8> m_placed;
 };
 
 } // namespace optimizer
@@ -1,12 +1,156 @@
 #include "multi_stock_optimizer.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <limits>
 #include <map>
 
+#include "../threading/parallel_for.h"
+
 namespace dw {
 namespace optimizer {
 
+namespace {
+
+constexpr f32 kNoBound = std::numeric_limits<f32>::infinity();
+
+// A material group with parts and stock to try
+struct GroupWork {
+    i64 materialId = 0;
+    const MaterialGroup* material = nullptr;
+    const std::vector<Part>* parts = nullptr;
+    usize instanceCount = 0; // Upper bound on the sheets any trial can use
+    f64 partArea = 0.0;
+};
+
+// One packing run: a group's parts on `leadCount` sheets of stock `lead`
+// followed by as many sheets of stock `stock` as the budget allows
+struct Trial {
+    usize group = 0;
+    usize stock = 0;
+    usize lead = 0;
+    usize leadCount = 0;
+    f64 tailArea = 0.0;      // Part area the `stock` sheets must hold
+    f32 estimate = 0.0f;     // Cost lower bound, used to run promising trials first
+    bool ran = false;        // False when pruned
+    CutPlan plan;
+    std::vector<usize> sheetStock; // Stock index of each plan sheet
+};
+
+f32 usableArea(const Sheet& stock, f32 margin) {
+    const f32 w = stock.width - 2 * margin;
+    const f32 h = stock.height - 2 * margin;
+    return (w > 0.0f && h > 0.0f) ? w * h : 0.0f;
+}
+
+// Fewest sheets that can hold `area` by area alone
+usize minSheets(f64 area, f32 usable) {
+    if (area <= 0.0)
+        return 0;
+    if (usable <= 0.0f)
+        return std::numeric_limits<usize>::max();
+    return static_cast<usize>(std::ceil(area / static_cast<f64>(usable)));
+}
+
+// Most sheets costing `cost` each that keep `spent` plus their cost within
+// `bound`, capped at `limit`
+usize sheetBudget(f32 bound, f32 spent, f32 cost, usize limit) {
+    if (bound == kNoBound || cost <= 0.0f)
+        return limit;
+    if (spent > bound)
+        return 0;
+    const f64 room = static_cast<f64>(bound - spent) / static_cast<f64>(cost);
+    usize n = std::min(limit, static_cast<usize>(room));
+    // Settle on the same f32 arithmetic the costs are compared with
+    while (n < limit && spent + static_cast<f32>(n + 1) * cost <= bound)
+        ++n;
+    while (n > 0 && spent + static_cast<f32>(n) * cost > bound)
+        --n;
+    return n;
+}
+
+void lowerBound(std::atomic<f32>& bound, f32 cost) {
+    f32 current = bound.load(std::memory_order_relaxed);
+    while (cost < current &&
+           !bound.compare_exchange_weak(current, cost, std::memory_order_relaxed)) {
+    }
+}
+
+// Run trials in parallel, cheapest estimate first. Each complete plan lowers
+// its group's bound, which caps the sheets later trials of the group get.
+void runTrials(std::vector<Trial>& trials,
+               const std::vector<GroupWork>& groups,
+               std::vector<std::atomic<f32>>& bounds,
+               Algorithm algorithm, bool allowRotation, f32 kerf, f32 margin) {
+    std::vector<usize> order(trials.size());
+    for (usize i = 0; i < order.size(); ++i)
+        order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&trials](usize a, usize b) {
+        return trials[a].estimate < trials[b].estimate;
+    });
+
+    parallelFor(order.size(), 1, [&](usize begin, usize end) {
+        auto opt = CutOptimizer::create(algorithm);
+        opt->setAllowRotation(allowRotation);
+        opt->setKerf(kerf);
+        opt->setMargin(margin);
+        std::vector<Sheet> sheets;
+
+        for (usize i = begin; i < end; ++i) {
+            Trial& trial = trials[order[i]];
+            const GroupWork& group = groups[trial.group];
+            const auto& stockSizes = group.material->stockSizes;
+            const Sheet& lead = stockSizes[trial.lead];
+            const Sheet& stock = stockSizes[trial.stock];
+
+            const f32 bound = bounds[trial.group].load(std::memory_order_relaxed);
+            const f32 spent = static_cast<f32>(trial.leadCount) * lead.cost;
+            const usize budget = sheetBudget(bound, spent, stock.cost, group.instanceCount);
+            // With a finite bound, a plan that cannot finish within budget
+            // costs more than a complete plan already found
+            if (bound != kNoBound &&
+                minSheets(trial.tailArea, usableArea(stock, margin)) > budget) {
+                continue;
+            }
+
+            sheets.assign(trial.leadCount, lead);
+            sheets.insert(sheets.end(), budget, stock);
+
+            CutPlan plan = opt->optimize(*group.parts, sheets);
+            if (bound != kNoBound && budget < group.instanceCount && !plan.isComplete())
+                continue;
+
+            trial.sheetStock.clear();
+            for (const auto& sr : plan.sheets) {
+                trial.sheetStock.push_back(static_cast<usize>(sr.sheetIndex) < trial.leadCount
+                                               ? trial.lead
+                                               : trial.stock);
+            }
+            const usize tailCount = plan.sheets.size() > trial.leadCount
+                                        ? plan.sheets.size() - trial.leadCount
+                                        : 0;
+            plan.totalCost = spent + static_cast<f32>(tailCount) * stock.cost;
+            if (plan.isComplete())
+                lowerBound(bounds[trial.group], plan.totalCost);
+
+            trial.plan = std::move(plan);
+            trial.ran = true;
+        }
+    });
+}
+
+// Prefer complete plans, then lowest cost; ties keep the earlier candidate
+bool isBetter(const CutPlan& plan, const CutPlan* best) {
+    if (!best)
+        return true;
+    if (plan.isComplete() != best->isComplete())
+        return plan.isComplete();
+    return plan.totalCost < best->totalCost;
+}
+
+} // namespace
+
 MultiStockResult optimizeMultiStock(
     const std::vector<Part>& parts,
     const std::vector<MaterialGroup>& materials,
@@ -27,72 +171,123 @@ MultiStockResult optimizeMultiStock(
         partsByMaterial[part.materialId].push_back(part);
     }
 
-    // For each material group that has parts, run optimization
+    // Material groups that have parts and stock, in materialId order
+    std::vector<GroupWork> groups;
     for (auto& [matId, groupParts] : partsByMaterial) {
-        // Find the MaterialGroup definition
         auto it = groupMap.find(matId);
-        if (it == groupMap.end()) {
-            // No material group defined for this materialId -- skip
+        if (it == groupMap.end() || it->second->stockSizes.empty()) {
+            // No material group (or no stock) defined for this materialId -- skip
             continue;
         }
 
-        const MaterialGroup* mg = it->second;
-        if (mg->stockSizes.empty()) {
-            continue;
+        GroupWork group;
+        group.materialId = matId;
+        group.material = it->second;
+        group.parts = &groupParts;
+        for (const auto& part : groupParts) {
+            const usize count = static_cast<usize>(std::max(part.quantity, 0));
+            group.instanceCount += count;
+            group.partArea += static_cast<f64>(part.area()) * static_cast<f64>(count);
         }
+        group.instanceCount = std::max<usize>(group.instanceCount, 1);
+        groups.push_back(group);
+    }
 
-        // Try each stock size and pick the one with minimum cost
-        CutPlan bestPlan;
-        Sheet bestSheet;
-        f32 bestCost = std::numeric_limits<f32>::max();
-        bool foundAny = false;
-
-        for (const auto& stock : mg->stockSizes) {
-            auto opt = CutOptimizer::create(algorithm);
-            opt->setAllowRotation(allowRotation);
-            opt->setKerf(kerf);
-            opt->setMargin(margin);
-
-            // Use unlimited quantity for the stock sheet
-            Sheet s = stock;
-            s.quantity = 0; // unlimited
-
-            CutPlan plan = opt->optimize(groupParts, {s});
-
-            // Calculate cost: sheetsUsed * sheet cost
-            f32 cost = static_cast<f32>(plan.sheetsUsed) * stock.cost;
-            plan.totalCost = cost;
-
-            // Pick the best: prefer complete plans, then lowest cost
-            bool isBetter = false;
-            if (!foundAny) {
-                isBetter = true;
-            } else if (plan.isComplete() && !bestPlan.isComplete()) {
-                isBetter = true;
-            } else if (plan.isComplete() == bestPlan.isComplete()) {
-                isBetter = (cost < bestCost);
-            }
+    // Cheapest complete plan per group so far
+    std::vector<std::atomic<f32>> bounds(groups.size());
+    for (auto& bound : bounds)
+        bound.store(kNoBound, std::memory_order_relaxed);
+
+    // Every group on every stock size
+    std::vector<Trial> trials;
+    std::vector<usize> firstTrial(groups.size() + 1, 0);
+    for (usize g = 0; g < groups.size(); ++g) {
+        firstTrial[g] = trials.size();
+        const auto& stockSizes = groups[g].material->stockSizes;
+        for (usize s = 0; s < stockSizes.size(); ++s) {
+            Trial trial;
+            trial.group = g;
+            trial.stock = s;
+            trial.lead = s;
+            trial.tailArea = groups[g].partArea;
+            const usize sheetsNeeded =
+                std::min(minSheets(trial.tailArea, usableArea(stockSizes[s], margin)),
+                         groups[g].instanceCount);
+            trial.estimate = static_cast<f32>(sheetsNeeded) * stockSizes[s].cost;
+            trials.push_back(std::move(trial));
+        }
+    }
+    firstTrial[groups.size()] = trials.size();
+    runTrials(trials, groups, bounds, algorithm, allowRotation, kerf, margin);
+
+    // Pick each group's best stock in stock order, as a serial search would
+    std::vector<const Trial*> best(groups.size(), nullptr);
+    for (usize g = 0; g < groups.size(); ++g) {
+        for (usize t = firstTrial[g]; t < firstTrial[g + 1]; ++t) {
+            if (trials[t].ran && isBetter(trials[t].plan, best[g] ? &best[g]->plan : nullptr))
+                best[g] = &trials[t];
+        }
+    }
+
+    // Retry the last sheet of multi-sheet plans on each cheaper stock size
+    std::vector<Trial> tails;
+    std::vector<usize> firstTail(groups.size() + 1, 0);
+    for (usize g = 0; g < groups.size(); ++g) {
+        firstTail[g] = tails.size();
+        const Trial* lead = best[g];
+        if (!lead || !lead->plan.isComplete() || lead->plan.sheets.size() < 2)
+            continue;
 
-            if (isBetter) {
-                bestPlan = plan;
-                bestSheet = stock;
-                bestCost = cost;
-                foundAny = true;
+        const auto& stockSizes = groups[g].material->stockSizes;
+        const Sheet& leadStock = stockSizes[lead->stock];
+        for (usize s = 0; s < stockSizes.size(); ++s) {
+            if (s == lead->stock || !(stockSizes[s].cost < leadStock.cost))
+                continue;
+            Trial trial;
+            trial.group = g;
+            trial.stock = s;
+            trial.lead = lead->stock;
+            trial.leadCount = lead->plan.sheets.size() - 1;
+            trial.tailArea = lead->plan.sheets.back().usedArea;
+            trial.estimate = static_cast<f32>(trial.leadCount) * leadStock.cost +
+                             static_cast<f32>(minSheets(trial.tailArea,
+                                                        usableArea(stockSizes[s], margin))) *
+                                 stockSizes[s].cost;
+            tails.push_back(std::move(trial));
+        }
+    }
+    firstTail[groups.size()] = tails.size();
+    runTrials(tails, groups, bounds, algorithm, allowRotation, kerf, margin);
+
+    for (usize g = 0; g < groups.size(); ++g) {
+        const Trial* chosen = best[g];
+        if (!chosen)
+            continue;
+        for (usize t = firstTail[g]; t < firstTail[g + 1]; ++t) {
+            const Trial& tail = tails[t];
+            if (tail.ran && tail.plan.isComplete() &&
+                tail.plan.totalCost < chosen->plan.totalCost) {
+                chosen = &tail;
             }
         }
 
-        if (foundAny) {
-            MultiStockResult::GroupResult gr;
-            gr.materialId = matId;
-            gr.materialName = mg->materialName;
-            gr.plan = bestPlan;
-            gr.usedSheet = bestSheet;
-            gr.waste = computeWasteBreakdown(bestPlan, bestSheet, kerf);
-            result.groups.push_back(gr);
-
-            result.totalCost += bestCost;
-            result.totalSheetsUsed += bestPlan.sheetsUsed;
+        const auto& stockSizes = groups[g].material->stockSizes;
+        MultiStockResult::GroupResult gr;
+        gr.materialId = groups[g].materialId;
+        gr.materialName = groups[g].material->materialName;
+        gr.plan = chosen->plan;
+        gr.usedSheet = stockSizes[chosen->lead];
+        if (chosen->leadCount > 0) {
+            for (usize s : chosen->sheetStock)
+                gr.sheetStock.push_back(stockSizes[s]);
+            gr.waste = computeWasteBreakdown(gr.plan, gr.sheetStock, kerf);
+        } else {
+            gr.waste = computeWasteBreakdown(gr.plan, gr.usedSheet, kerf);
         }
+        result.groups.push_back(gr);
+
+        result.totalCost += gr.plan.totalCost;
+        result.totalSheetsUsed += gr.plan.sheetsUsed;
     }
 
     return result;
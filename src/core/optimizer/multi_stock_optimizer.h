@@ -25,7 +25,15 @@ struct MultiStockResult {
         std::string materialName;
         CutPlan plan;
         WasteBreakdown waste;
-        Sheet usedSheet; // Which stock size was selected
+        Sheet usedSheet; // Which stock size was selected (the leading sheets' when mixed)
+        // Stock for each plan.sheets entry when the plan mixes stock sizes;
+        // empty when every sheet is usedSheet
+        std::vector<Sheet> sheetStock;
+
+        bool mixedStock() const { return !sheetStock.empty(); }
+        const Sheet& stockFor(usize sheet) const {
+            return sheet < sheetStock.size() ? sheetStock[sheet] : usedSheet;
+        }
     };
     std::vector<GroupResult> groups;
     f32 totalCost = 0.0f;
@@ -33,8 +41,18 @@ struct MultiStockResult {
 };
 
 // Group parts by materialId, then for each group try all available stock sizes
-// and pick the one minimizing total cost (sheets_used * sheet_cost).
-// Falls back to the first stock size if costs are equal.
+// and pick the one minimizing total cost (sheets_used * sheet_cost). Stock is
+// unlimited: a trial uses as many sheets as its parts need. Complete plans win
+// over incomplete ones; the first stock size wins when costs are equal.
+//
+// Once a group's best plan spans several sheets, its last sheet is retried on
+// every cheaper stock size, and a mixed plan is kept if it costs strictly less.
+//
+// Trials of all groups run in parallel (parallelFor) with branch-and-bound: a
+// trial only gets as many sheets as could still match the cheapest complete
+// plan found so far, and is skipped when the parts' area alone needs more.
+// Pruned trials could never have been picked, so the result is identical to an
+// exhaustive serial search for any thread count.
 MultiStockResult optimizeMultiStock(
     const std::vector<Part>& parts,
     const std::vector<MaterialGroup>& materials,
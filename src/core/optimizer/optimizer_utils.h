@@ -18,9 +18,10 @@ struct ExpandedPart {
 };
 
 // Expand parts by quantity into individual instances and sort by area (largest first).
-// Each Part with quantity N produces N ExpandedPart entries.
-inline std::vector<ExpandedPart> expandParts(const std::vector<Part>& parts) {
-    std::vector<ExpandedPart> expanded;
+// Each Part with quantity N produces N ExpandedPart entries. Fills `expanded`
+// in place so callers running repeatedly can keep its capacity.
+inline void expandParts(const std::vector<Part>& parts, std::vector<ExpandedPart>& expanded) {
+    expanded.clear();
     for (int i = 0; i < static_cast<int>(parts.size()); ++i) {
         const Part& part = parts[i];
         for (int j = 0; j < part.quantity; ++j) {
@@ -32,7 +33,11 @@ inline std::vector<ExpandedPart> expandParts(const std::vector<Part>& parts) {
     std::sort(expanded.begin(), expanded.end(), [](const ExpandedPart& a, const ExpandedPart& b) {
         return a.area > b.area;
     });
+}
 
+inline std::vector<ExpandedPart> expandParts(const std::vector<Part>& parts) {
+    std::vector<ExpandedPart> expanded;
+    expandParts(parts, expanded);
     return expanded;
 }
 
@@ -6,25 +6,30 @@
 namespace dw {
 namespace optimizer {
 
-WasteBreakdown computeWasteBreakdown(const CutPlan& plan,
-                                      const Sheet& sheetTemplate,
-                                      f32 kerf) {
+namespace {
+
+// stockFor(si) returns the stock sheet plan.sheets[si] was cut from
+template <typename StockFor>
+WasteBreakdown computeBreakdown(const CutPlan& plan, StockFor stockFor, f32 kerf) {
     WasteBreakdown wb;
 
     if (plan.sheets.empty()) {
         return wb;
     }
 
-    const f32 sheetArea = sheetTemplate.area();
-    if (sheetArea <= 0.0f) {
-        return wb;
-    }
-
     f32 totalKerfArea = 0.0f;
     f32 totalScrapArea = 0.0f;
+    f32 totalSheetArea = 0.0f;
+    f32 totalCost = 0.0f;
 
     for (int si = 0; si < static_cast<int>(plan.sheets.size()); ++si) {
         const SheetResult& sr = plan.sheets[si];
+        const Sheet& sheetTemplate = stockFor(si);
+        if (sheetTemplate.area() <= 0.0f) {
+            continue;
+        }
+        totalSheetArea += sheetTemplate.area();
+        totalCost += sheetTemplate.cost;
 
         // Compute bounding box of all placements on this sheet
         f32 maxRight = 0.0f;
@@ -85,9 +90,6 @@ WasteBreakdown computeWasteBreakdown(const CutPlan& plan,
     wb.totalUnusableArea = std::max(0.0f, totalWaste - totalScrapArea - totalKerfArea);
 
     // Dollar values proportional to area ratios
-    f32 totalSheetArea = sheetArea * static_cast<f32>(plan.sheetsUsed);
-    f32 totalCost = sheetTemplate.cost * static_cast<f32>(plan.sheetsUsed);
-
     if (totalSheetArea > 0.0f && totalCost > 0.0f) {
         f32 rate = totalCost / totalSheetArea;
         wb.scrapValue = wb.totalScrapArea * rate;
@@ -99,5 +101,26 @@ WasteBreakdown computeWasteBreakdown(const CutPlan& plan,
     return wb;
 }
 
+} // namespace
+
+WasteBreakdown computeWasteBreakdown(const CutPlan& plan,
+                                      const Sheet& sheetTemplate,
+                                      f32 kerf) {
+    return computeBreakdown(plan, [&sheetTemplate](int) -> const Sheet& { return sheetTemplate; },
+                            kerf);
+}
+
+WasteBreakdown computeWasteBreakdown(const CutPlan& plan,
+                                      const std::vector<Sheet>& sheetStock,
+                                      f32 kerf) {
+    const Sheet none;
+    return computeBreakdown(plan,
+                            [&sheetStock, &none](int si) -> const Sheet& {
+                                const auto index = static_cast<usize>(si);
+                                return index < sheetStock.size() ? sheetStock[index] : none;
+                            },
+                            kerf);
+}
+
 } // namespace optimizer
 } // namespace dw
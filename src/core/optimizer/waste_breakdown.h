@@ -36,5 +36,11 @@ WasteBreakdown computeWasteBreakdown(const CutPlan& plan,
                                       const Sheet& sheetTemplate,
                                       f32 kerf);
 
+// Same for a plan that mixes stock sizes: sheetStock[i] is the stock
+// plan.sheets[i] was cut from
+WasteBreakdown computeWasteBreakdown(const CutPlan& plan,
+                                      const std::vector<Sheet>& sheetStock,
+                                      f32 kerf);
+
 } // namespace optimizer
 } // namespace dw
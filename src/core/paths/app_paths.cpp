@@ -156,6 +156,10 @@ Path getThumbnailDir() {
     return getCacheDir() / "thumbnails";
 }
 
+Path getMeshCacheDir() {
+    return getCacheDir() / "meshes";
+}
+
 Path getDatabasePath() {
     return getDataDir() / "library.db";
 }
@@ -184,6 +188,10 @@ Path getMaterialsDir() {
     return getDataDir() / "materials";
 }
 
+Path getTelemetryDir() {
+    return getDataDir() / "telemetry";
+}
+
 Path getBundledMaterialsDir() {
     return getExeDir() / "resources" / "materials";
 }
@@ -229,8 +237,10 @@ bool ensureDirectoriesExist() {
     ensureDir(getDataDir(), "data");
     ensureDir(getCacheDir(), "cache");
     ensureDir(getThumbnailDir(), "thumbnail");
+    ensureDir(getMeshCacheDir(), "mesh cache");
     ensureDir(getBlobStoreDir(), "blob store");
     ensureDir(getTempStoreDir(), "temp store");
+    ensureDir(getTelemetryDir(), "telemetry");
 
     // User-visible directories (from Config, defaults to ~/DigitalWorkshop/*)
     auto& cfg = Config::instance();
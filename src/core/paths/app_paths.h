@@ -25,6 +25,9 @@ Path getCacheDir();
 // Thumbnail cache directory
 Path getThumbnailDir();
 
+// Optimized mesh cache directory (welded/reordered meshes keyed by file hash)
+Path getMeshCacheDir();
+
 // Database file path
 Path getDatabasePath();
 
@@ -46,6 +49,9 @@ Path getTempStoreDir();
 // Materials directory (app-managed .dwmat files)
 Path getMaterialsDir();
 
+// Job telemetry directory (.dwjt logs recorded while streaming)
+Path getTelemetryDir();
+
 // User root directory (~/DigitalWorkshop)
 Path getUserRoot();
 
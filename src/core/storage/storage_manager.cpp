@@ -1,5 +1,7 @@
 #include "storage_manager.h"
 
+#include <fstream>
+
 #include "../mesh/hash.h"
 #include "../paths/app_paths.h"
 #include "../utils/log.h"
@@ -63,6 +65,64 @@ Path StorageManager::storeFile(const Path& source,
     }
 }
 
+Path StorageManager::storeStream(const std::string& hash,
+                                 const std::string& ext,
+                                 const std::function<bool(const BlobSink&)>& produce,
+                                 std::string& error) {
+    try {
+        Path finalPath = blobPath(hash, ext);
+        if (finalPath.empty()) {
+            error = "Invalid hash: must be at least 4 characters";
+            return Path();
+        }
+        if (fs::exists(finalPath)) {
+            return finalPath;
+        }
+
+        fs::create_directories(m_tempDir);
+        Path tmpPath = m_tempDir / ("stream_" + hash + "." + ext);
+
+        // Hash while writing so verification needs no second pass
+        hash::Hasher hasher;
+        bool produced = false;
+        {
+            std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+            if (!out) {
+                error = "Cannot create temp file: " + tmpPath.string();
+                return Path();
+            }
+            BlobSink sink = [&out, &hasher](const void* data, usize size) {
+                hasher.update(data, size);
+                out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+                return static_cast<bool>(out);
+            };
+            produced = produce(sink);
+            out.close();
+            produced = produced && !out.fail();
+        }
+        if (!produced) {
+            fs::remove(tmpPath);
+            error = "Failed to write blob stream";
+            return Path();
+        }
+
+        std::string computedHash = hasher.hex();
+        if (computedHash != hash) {
+            fs::remove(tmpPath);
+            error = "Hash verification failed: expected " + hash + ", got " + computedHash;
+            return Path();
+        }
+
+        fs::create_directories(finalPath.parent_path());
+        fs::rename(tmpPath, finalPath);
+        return finalPath;
+
+    } catch (const fs::filesystem_error& e) {
+        error = std::string("Filesystem error: ") + e.what();
+        return Path();
+    }
+}
+
 Path StorageManager::moveFile(const Path& source,
                               const std::string& hash,
                               const std::string& ext,
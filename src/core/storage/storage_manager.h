@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <string>
 
 #include "../types.h"
@@ -26,6 +27,18 @@ class StorageManager {
                    const std::string& ext,
                    std::string& error);
 
+    /// Receives streamed blob bytes; returns false on a write failure.
+    using BlobSink = std::function<bool(const void* data, usize size)>;
+
+    /// Stream content into blob store via temp+verify+rename, without staging
+    /// it in memory. `produce` pushes the bytes through the sink and returns
+    /// false to abort; the running hash must match `hash`.
+    /// Idempotent: `produce` is not called if the blob already exists.
+    Path storeStream(const std::string& hash,
+                     const std::string& ext,
+                     const std::function<bool(const BlobSink&)>& produce,
+                     std::string& error);
+
     /// Move source into blob store. Falls back to copy+delete if
     /// cross-filesystem.
     Path moveFile(const Path& source,
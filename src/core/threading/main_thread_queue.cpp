@@ -1,59 +1,232 @@
 #include "main_thread_queue.h"
 
+#include <algorithm>
+
+#include "core/utils/log.h"
+#include "core/utils/trace.h"
+
 namespace dw {
 
-MainThreadQueue::MainThreadQueue(size_t maxSize) : m_maxSize(maxSize) {}
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Weight of the newest sample in the latency moving average
+constexpr double kLatencySmoothing = 0.1;
+
+double elapsedMs(Clock::time_point from, Clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+} // namespace
 
-void MainThreadQueue::enqueue(std::function<void()> task) {
-    std::unique_lock<std::mutex> lock(m_mutex);
+struct MainThreadQueue::Node {
+    std::atomic<Node*> next{nullptr};
+    std::function<void()> task;
+    Clock::time_point enqueuedAt;
+    std::uint64_t key = 0;
+    size_t slot = 0;
+    bool marker = false; // Runs whatever m_latest[slot] holds when popped
+};
 
-    // Wait if queue is full (blocks producer until space available or shutdown)
-    m_cvFull.wait(lock, [this] { return m_size.load() < m_maxSize || m_shutdown.load(); });
+MainThreadQueue::List::List() : head(new Node()), tail(head.load()) {}
+
+MainThreadQueue::List::~List() {
+    while (Node* node = pop())
+        delete node;
+    delete tail;
+}
+
+void MainThreadQueue::List::push(Node* node) {
+    node->next.store(nullptr, std::memory_order_relaxed);
+    Node* prev = head.exchange(node, std::memory_order_acq_rel);
+    // Between the exchange and this store the list looks one node shorter to
+    // the consumer; that node is simply picked up on a later pop
+    prev->next.store(node, std::memory_order_release);
+}
+
+MainThreadQueue::Node* MainThreadQueue::List::pop() {
+    Node* first = tail;
+    Node* next = first->next.load(std::memory_order_acquire);
+    if (!next)
+        return nullptr;
+
+    // `next` becomes the new stub; its payload moves into the old stub, which
+    // the caller owns from here on
+    tail = next;
+    first->task = std::move(next->task);
+    first->enqueuedAt = next->enqueuedAt;
+    first->key = next->key;
+    first->slot = next->slot;
+    first->marker = next->marker;
+    return first;
+}
+
+MainThreadQueue::MainThreadQueue(size_t softLimit) : m_softLimit(softLimit) {
+    for (auto& slot : m_latest)
+        slot.store(nullptr, std::memory_order_relaxed);
+}
+
+MainThreadQueue::~MainThreadQueue() {
+    for (auto& slot : m_latest)
+        delete slot.exchange(nullptr, std::memory_order_acquire);
+}
+
+void MainThreadQueue::push(Node* node, TaskPriority priority) {
+    node->enqueuedAt = Clock::now();
+    m_lists[static_cast<size_t>(priority)].push(node);
+    m_enqueued.fetch_add(1, std::memory_order_relaxed);
+
+    size_t depth = m_size.fetch_add(1, std::memory_order_relaxed) + 1;
+    size_t peak = m_peak.load(std::memory_order_relaxed);
+    while (depth > peak && !m_peak.compare_exchange_weak(peak, depth, std::memory_order_relaxed)) {
+    }
+    if (depth > m_softLimit && !m_overflowWarned.exchange(true, std::memory_order_relaxed)) {
+        log::warningf("MainThreadQueue", "%zu tasks pending (soft limit %zu); main thread is behind",
+                      depth, m_softLimit);
+    }
+}
+
+void MainThreadQueue::enqueue(std::function<void()> task, TaskPriority priority) {
+    if (m_shutdown.load(std::memory_order_acquire)) {
+        return;
+    }
+    Node* node = new Node();
+    node->task = std::move(task);
+    push(node, priority);
+}
 
-    // If shutdown, return immediately without enqueuing
-    if (m_shutdown.load()) {
+void MainThreadQueue::enqueueLatest(std::uint64_t key,
+                                    std::function<void()> task,
+                                    TaskPriority priority) {
+    if (m_shutdown.load(std::memory_order_acquire)) {
         return;
     }
+    Node* keyed = new Node();
+    keyed->task = std::move(task);
+    keyed->key = key;
 
-    // Add task to queue
-    m_queue.push(std::move(task));
-    m_size.fetch_add(1);
+    size_t slot = static_cast<size_t>(key ^ (key >> 32)) & (kLatestSlots - 1);
+    Node* previous = m_latest[slot].exchange(keyed, std::memory_order_acq_rel);
+    if (!previous) {
+        // Nothing pending in this slot: queue a marker that will run it
+        Node* marker = new Node();
+        marker->marker = true;
+        marker->slot = slot;
+        push(marker, priority);
+        return;
+    }
+
+    // A marker for the slot is already queued and will now run our task. On a
+    // slot collision the other key's snapshot is dropped too: requeueing it
+    // could let it run after a newer one for that key
+    m_coalesced.fetch_add(1, std::memory_order_relaxed);
+    delete previous;
+}
+
+std::uint64_t MainThreadQueue::latestKey(const void* owner, std::uint32_t channel) {
+    // splitmix64 finalizer over the owner address and channel
+    std::uint64_t z = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(owner)) +
+                      0x9E3779B97F4A7C15ull * (static_cast<std::uint64_t>(channel) + 1);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+bool MainThreadQueue::runOne(TaskPriority priority, double& maxLatencyMs) {
+    Node* node = m_lists[static_cast<size_t>(priority)].pop();
+    if (!node) {
+        return false;
+    }
+    m_size.fetch_sub(1, std::memory_order_relaxed);
+
+    std::function<void()> task;
+    if (node->marker) {
+        if (Node* keyed = m_latest[node->slot].exchange(nullptr, std::memory_order_acq_rel)) {
+            task = std::move(keyed->task);
+            delete keyed;
+        }
+    } else {
+        task = std::move(node->task);
+    }
+
+    double latencyMs = elapsedMs(node->enqueuedAt, Clock::now());
+    delete node;
+    maxLatencyMs = std::max(maxLatencyMs, latencyMs);
+    m_avgLatencyMs += (latencyMs - m_avgLatencyMs) * kLatencySmoothing;
+    ++m_executed;
+
+    // Run outside any queue state so tasks may enqueue more work
+    if (task) {
+        task();
+    }
+    return true;
+}
+
+void MainThreadQueue::process(std::chrono::microseconds budget) {
+    drain(Clock::now() + budget);
 }
 
 void MainThreadQueue::processAll() {
+    drain(Clock::time_point::max());
+}
+
+void MainThreadQueue::drain(Clock::time_point deadline) {
     // Assert we're on the main thread (debug only)
     ASSERT_MAIN_THREAD();
+    DW_TRACE_ZONE("MainThreadQueue::process");
+
+    auto start = Clock::now();
 
-    // Drain queue into local vector (minimize lock time)
-    std::vector<std::function<void()>> tasks;
-    {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        while (!m_queue.empty()) {
-            tasks.push_back(std::move(m_queue.front()));
-            m_queue.pop();
-            m_size.fetch_sub(1);
+    // Only tasks pending on entry, so a task that re-enqueues itself cannot
+    // keep this call going
+    const size_t limit = m_size.load(std::memory_order_relaxed);
+    size_t executed = 0;
+    double maxLatencyMs = 0.0;
+
+    while (executed < limit && runOne(TaskPriority::High, maxLatencyMs)) {
+        ++executed;
+    }
+    for (TaskPriority priority : {TaskPriority::Normal, TaskPriority::Low}) {
+        bool first = true; // Guarantees progress for every priority
+        while (executed < limit && (first || Clock::now() < deadline) &&
+               runOne(priority, maxLatencyMs)) {
+            ++executed;
+            first = false;
         }
-        // Notify blocked producers that space is available
-        m_cvFull.notify_all();
     }
 
-    // Execute all callbacks outside the lock (prevents deadlocks)
-    for (auto& task : tasks) {
-        task();
+    size_t remaining = m_size.load(std::memory_order_relaxed);
+    m_lastExecuted = executed;
+    m_lastDeferred = std::min(remaining, limit - executed);
+    m_lastProcessMs = elapsedMs(start, Clock::now());
+    m_lastMaxLatencyMs = maxLatencyMs;
+    if (remaining <= m_softLimit / 2) {
+        m_overflowWarned.store(false, std::memory_order_relaxed);
     }
 }
 
 size_t MainThreadQueue::size() const {
-    return m_size.load();
+    return m_size.load(std::memory_order_relaxed);
 }
 
 void MainThreadQueue::shutdown() {
-    {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        m_shutdown = true;
-    }
-    // Wake all waiting producers
-    m_cvFull.notify_all();
+    m_shutdown.store(true, std::memory_order_release);
+}
+
+MainThreadQueue::Stats MainThreadQueue::stats() const {
+    Stats s;
+    s.pending = m_size.load(std::memory_order_relaxed);
+    s.peakPending = m_peak.load(std::memory_order_relaxed);
+    s.enqueued = m_enqueued.load(std::memory_order_relaxed);
+    s.executed = m_executed;
+    s.coalesced = m_coalesced.load(std::memory_order_relaxed);
+    s.lastExecuted = m_lastExecuted;
+    s.lastDeferred = m_lastDeferred;
+    s.lastProcessMs = m_lastProcessMs;
+    s.lastMaxLatencyMs = m_lastMaxLatencyMs;
+    s.avgLatencyMs = m_avgLatencyMs;
+    return s;
 }
 
 } // namespace dw
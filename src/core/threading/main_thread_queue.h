@@ -1,41 +1,122 @@
 #pragma once
 
+#include <array>
 #include <atomic>
-#include <condition_variable>
+#include <chrono>
+#include <cstdint>
 #include <functional>
-#include <mutex>
-#include <queue>
-#include <vector>
 
 #include "core/utils/thread_utils.h"
 
 namespace dw {
 
-// Thread-safe bounded FIFO queue for posting callables from worker threads to main thread
-// Workers enqueue tasks (may block if full), main thread calls processAll() each frame
+// Drain order for main-thread tasks. High runs in full every frame (connection
+// changes, alarms, errors and the state snapshots that must stay ordered with
+// them); Normal and Low share the frame budget, Low only after Normal is empty.
+enum class TaskPriority : std::uint8_t { High, Normal, Low };
+
+// Lock-free MPSC queue for posting callables from worker threads to the main thread.
+//
+// enqueue() never blocks: each priority is an unbounded intrusive linked list
+// (Vyukov MPSC) so producers only do an atomic exchange. State snapshots such
+// as progress or machine status go through enqueueLatest(), which keeps at most
+// one pending task per key and replaces it in place, so bursts collapse to the
+// newest value instead of growing the queue. The main thread calls process()
+// once per frame with a time budget; work left over is deferred to the next frame.
 class MainThreadQueue {
   public:
-    explicit MainThreadQueue(size_t maxSize = 1000);
+    // Depth past which a (rate-limited) overflow warning is logged; not a hard cap
+    explicit MainThreadQueue(size_t softLimit = 1000);
+    ~MainThreadQueue();
+
+    MainThreadQueue(const MainThreadQueue&) = delete;
+    MainThreadQueue& operator=(const MainThreadQueue&) = delete;
+
+    // Enqueue a task from any thread (never blocks; no-op after shutdown)
+    void enqueue(std::function<void()> task, TaskPriority priority = TaskPriority::Normal);
+
+    // Enqueue a task that supersedes any still-pending task with the same key.
+    // The newest task runs in the oldest one's place in the queue. Keys share a
+    // fixed table of slots; a rare collision drops the other key's pending
+    // task, so only post snapshots that the producer's next update restores.
+    void enqueueLatest(std::uint64_t key,
+                       std::function<void()> task,
+                       TaskPriority priority = TaskPriority::Normal);
 
-    // Enqueue a task from any thread (blocks if queue full, returns immediately if shutdown)
-    void enqueue(std::function<void()> task);
+    // Coalescing key for one kind of update from one producer object
+    static std::uint64_t latestKey(const void* owner, std::uint32_t channel);
 
-    // Process all pending tasks on main thread (drains queue and executes callbacks)
+    // Run queued tasks on the main thread until the budget is spent. High tasks
+    // always run; every non-empty priority runs at least one task per call.
+    // Tasks enqueued while processing wait for the next call.
+    void process(std::chrono::microseconds budget);
+
+    // Process every task that was pending on entry, regardless of time
     void processAll();
 
-    // Query approximate queue size (lock-free)
+    // Approximate number of pending tasks (lock-free)
     size_t size() const;
 
-    // Shutdown the queue (unblocks waiting producers, prevents further enqueues)
+    // Shutdown the queue (prevents further enqueues; pending tasks are discarded
+    // on destruction)
     void shutdown();
 
+    struct Stats {
+        size_t pending = 0;
+        size_t peakPending = 0;
+        std::uint64_t enqueued = 0;
+        std::uint64_t executed = 0;
+        std::uint64_t coalesced = 0; // Tasks replaced by a newer enqueueLatest()
+        // Last process() call
+        size_t lastExecuted = 0;
+        size_t lastDeferred = 0; // Left pending when the budget ran out
+        double lastProcessMs = 0.0;
+        double lastMaxLatencyMs = 0.0; // Oldest task's enqueue-to-run delay
+        // Exponential moving average of enqueue-to-run delay
+        double avgLatencyMs = 0.0;
+    };
+
+    // Main thread only
+    Stats stats() const;
+
   private:
-    std::queue<std::function<void()>> m_queue;
-    std::mutex m_mutex;
-    std::condition_variable m_cvFull; // Notifies producers when space available
-    size_t m_maxSize;
+    struct Node;
+
+    // Intrusive Vyukov MPSC list with a stub node; pop() is main thread only
+    struct List {
+        List();
+        ~List();
+        void push(Node* node);
+        Node* pop();
+
+        std::atomic<Node*> head;
+        Node* tail;
+    };
+
+    static constexpr size_t kPriorityCount = 3;
+    static constexpr size_t kLatestSlots = 256;
+
+    void push(Node* node, TaskPriority priority);
+    void drain(std::chrono::steady_clock::time_point deadline);
+    bool runOne(TaskPriority priority, double& maxLatencyMs);
+
+    std::array<List, kPriorityCount> m_lists;
+    std::array<std::atomic<Node*>, kLatestSlots> m_latest; // Pending keyed task per slot
+    size_t m_softLimit;
     std::atomic<size_t> m_size{0};
+    std::atomic<size_t> m_peak{0};
+    std::atomic<std::uint64_t> m_enqueued{0};
+    std::atomic<std::uint64_t> m_coalesced{0};
     std::atomic<bool> m_shutdown{false};
+    std::atomic<bool> m_overflowWarned{false};
+
+    // Main thread only
+    std::uint64_t m_executed = 0;
+    size_t m_lastExecuted = 0;
+    size_t m_lastDeferred = 0;
+    double m_lastProcessMs = 0.0;
+    double m_lastMaxLatencyMs = 0.0;
+    double m_avgLatencyMs = 0.0;
 };
 
 } // namespace dw
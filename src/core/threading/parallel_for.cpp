@@ -0,0 +1,123 @@
+#include "parallel_for.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+#include "thread_pool.h"
+
+namespace dw {
+
+namespace {
+
+struct SharedPool {
+    std::mutex mutex;
+    std::shared_ptr<ThreadPool> pool; // Lazily created, threads - 1 workers
+    usize threads = 0;                // 0 = not configured yet
+};
+
+SharedPool& sharedPool() {
+    static SharedPool s;
+    return s;
+}
+
+// Returns the worker pool (null when running single-threaded) and the total thread count
+std::shared_ptr<ThreadPool> acquirePool(usize& threads) {
+    auto& s = sharedPool();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    if (s.threads == 0) {
+        s.threads = calculateThreadCount(ParallelismTier::Auto);
+    }
+    if (!s.pool && s.threads > 1) {
+        s.pool = std::make_shared<ThreadPool>(s.threads - 1);
+    }
+    threads = s.threads;
+    return s.pool;
+}
+
+struct Job {
+    const std::function<void(usize, usize)>* body = nullptr;
+    usize count = 0;
+    usize grain = 1;
+    usize chunks = 0;
+    std::atomic<usize> next{0};
+    std::atomic<usize> done{0};
+    std::mutex mutex;
+    std::condition_variable finished;
+};
+
+// Claim and run chunks until none are left. A helper that starts after the
+// caller has returned claims nothing and never touches `body`.
+void runChunks(Job& job) {
+    usize ran = 0;
+    for (;;) {
+        const usize chunk = job.next.fetch_add(1, std::memory_order_relaxed);
+        if (chunk >= job.chunks) {
+            break;
+        }
+        const usize begin = chunk * job.grain;
+        (*job.body)(begin, std::min(job.count, begin + job.grain));
+        ++ran;
+    }
+    if (ran > 0 && job.done.fetch_add(ran, std::memory_order_acq_rel) + ran == job.chunks) {
+        std::lock_guard<std::mutex> lock(job.mutex);
+        job.finished.notify_all();
+    }
+}
+
+} // namespace
+
+void parallelFor(usize count, usize grain, const std::function<void(usize, usize)>& body) {
+    grain = grain > 0 ? grain : 1;
+    const usize chunks = parallelChunkCount(count, grain);
+    if (chunks == 0) {
+        return;
+    }
+
+    usize threads = 1;
+    std::shared_ptr<ThreadPool> pool = chunks > 1 ? acquirePool(threads) : nullptr;
+    if (!pool) {
+        for (usize begin = 0; begin < count; begin += grain) {
+            body(begin, std::min(count, begin + grain));
+        }
+        return;
+    }
+
+    auto job = std::make_shared<Job>();
+    job->body = &body;
+    job->count = count;
+    job->grain = grain;
+    job->chunks = chunks;
+
+    const usize helpers = std::min(threads - 1, chunks - 1);
+    for (usize i = 0; i < helpers; ++i) {
+        pool->enqueue([job] { runChunks(*job); });
+    }
+    runChunks(*job);
+
+    std::unique_lock<std::mutex> lock(job->mutex);
+    job->finished.wait(lock, [&] {
+        return job->done.load(std::memory_order_acquire) == job->chunks;
+    });
+}
+
+void setParallelThreadCount(usize threads) {
+    auto& s = sharedPool();
+    std::shared_ptr<ThreadPool> old;
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+        s.threads = threads > 0 ? std::min<usize>(threads, 64) : 0;
+        old = std::move(s.pool);
+    }
+    // Old workers are joined here (outside the lock) unless a loop still holds the pool
+}
+
+usize parallelThreadCount() {
+    auto& s = sharedPool();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    return s.threads > 0 ? s.threads : calculateThreadCount(ParallelismTier::Auto);
+}
+
+} // namespace dw
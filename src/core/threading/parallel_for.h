@@ -0,0 +1,46 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "../types.h"
+
+namespace dw {
+
+// Deterministic data-parallel loop over [0, count).
+//
+// The range is cut into fixed chunks of `grain` elements. Chunk boundaries depend only on
+// count and grain, never on how many threads run, so partial results reduced in chunk order
+// are bit-identical for any thread count. The calling thread works through chunks alongside
+// the shared workers, which makes it safe to call from a ThreadPool task (no nested deadlock).
+// `body` must not throw.
+void parallelFor(usize count, usize grain, const std::function<void(usize begin, usize end)>& body);
+
+// Number of chunks parallelFor() splits [0, count) into
+inline usize parallelChunkCount(usize count, usize grain) {
+    grain = grain > 0 ? grain : 1;
+    return (count + grain - 1) / grain;
+}
+
+// Chunked reduction: chunkFn(begin, end) -> T per chunk, folded left-to-right in chunk order
+template <typename T, typename ChunkFn, typename CombineFn>
+T parallelReduce(usize count, usize grain, T identity, ChunkFn chunkFn, CombineFn combine) {
+    grain = grain > 0 ? grain : 1;
+    std::vector<T> partials(parallelChunkCount(count, grain), identity);
+    parallelFor(count, grain, [&](usize begin, usize end) {
+        partials[begin / grain] = chunkFn(begin, end);
+    });
+
+    T result = identity;
+    for (const T& partial : partials) {
+        result = combine(result, partial);
+    }
+    return result;
+}
+
+// Threads used by parallelFor, including the caller (0 restores the ParallelismTier::Auto default).
+// Intended for startup configuration and tests; do not change while loops are running.
+void setParallelThreadCount(usize threads);
+usize parallelThreadCount();
+
+} // namespace dw
@@ -1,6 +1,9 @@
 #include "thread_pool.h"
 
 #include <algorithm>
+#include <string>
+
+#include "../utils/trace.h"
 
 namespace dw {
 
@@ -32,7 +35,10 @@ ThreadPool::ThreadPool(size_t numThreads) {
     // Create worker threads immediately
     m_workers.reserve(numThreads);
     for (size_t i = 0; i < numThreads; ++i) {
-        m_workers.emplace_back([this] { workerLoop(); });
+        m_workers.emplace_back([this, i] {
+            trace::setThreadName("Worker " + std::to_string(i + 1));
+            workerLoop();
+        });
     }
 }
 
@@ -1,31 +1,156 @@
 #include "log.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <ctime>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <memory>
 #include <mutex>
 #include <sstream>
+#include <thread>
+#include <vector>
 
 namespace dw {
 namespace log {
 
 namespace {
 
-Level g_minLevel = Level::Info;
-bool g_consoleOutput = false;
-std::ofstream g_logFile;
-std::mutex g_logMutex;
+std::atomic<Level> g_minLevel{Level::Info};
+std::atomic<bool> g_consoleOutput{false};
 
-std::string getCurrentTimestamp() {
-    auto now = std::chrono::system_clock::now();
-    auto time = std::chrono::system_clock::to_time_t(now);
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
+// Per-thread ring size in bytes (power of two)
+constexpr std::size_t kRingBytes = 64 * 1024;
+
+// Longest message kept from the unformatted calls
+constexpr std::size_t kMaxMessageBytes = kRingBytes / 8;
+
+// Writer wakes at least this often even without a notification
+constexpr auto kIdleWait = std::chrono::milliseconds(50);
+
+enum class RecordKind : std::uint32_t { Padding, Message };
+
+// Records are 8-byte aligned; padding records only use size and kind
+struct RecordHeader {
+    std::uint32_t size; // Whole record including this header
+    RecordKind kind;
+    std::int64_t timeUs;
+    std::uint16_t moduleLen;
+    std::uint16_t level;
+    std::uint32_t messageLen;
+};
+static_assert(sizeof(RecordHeader) % 8 == 0, "record header must keep 8-byte alignment");
+
+constexpr std::size_t align8(std::size_t n) {
+    return (n + 7) & ~static_cast<std::size_t>(7);
+}
+
+std::int64_t nowUs() {
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+}
+
+// Single-producer single-consumer byte ring. The owning thread writes a record,
+// then publishes it by bumping head with release order; the writer thread reads
+// up to head and hands the space back by bumping tail.
+struct Ring {
+    std::unique_ptr<std::uint64_t[]> storage{new std::uint64_t[kRingBytes / 8]};
+    std::atomic<std::uint64_t> head{0}; // Bytes ever written
+    std::atomic<std::uint64_t> tail{0}; // Bytes ever consumed
+    std::atomic<std::uint64_t> dropped{0};
+    std::atomic<bool> inUse{true};
+
+    char* data() { return reinterpret_cast<char*>(storage.get()); }
+
+    bool tryPush(Level level, std::int64_t timeUs, std::string_view module,
+                 std::string_view message) {
+        module = module.substr(0, 255);
+        message = message.substr(0, kMaxMessageBytes);
+        const std::size_t size = align8(sizeof(RecordHeader) + module.size() + message.size());
+
+        std::uint64_t h = head.load(std::memory_order_relaxed);
+        std::uint64_t t = tail.load(std::memory_order_acquire);
+        std::size_t offset = static_cast<std::size_t>(h & (kRingBytes - 1));
+        std::size_t toEnd = kRingBytes - offset;
+        std::size_t padding = size > toEnd ? toEnd : 0;
+
+        if (h + padding + size - t > kRingBytes) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        if (padding > 0) {
+            // Records never wrap; skip to the start of the buffer
+            const std::uint32_t pad[2] = {static_cast<std::uint32_t>(padding),
+                                          static_cast<std::uint32_t>(RecordKind::Padding)};
+            std::memcpy(data() + offset, pad, sizeof(pad));
+            offset = 0;
+        }
+
+        RecordHeader header{};
+        header.size = static_cast<std::uint32_t>(size);
+        header.kind = RecordKind::Message;
+        header.timeUs = timeUs;
+        header.moduleLen = static_cast<std::uint16_t>(module.size());
+        header.level = static_cast<std::uint16_t>(level);
+        header.messageLen = static_cast<std::uint32_t>(message.size());
+
+        char* dst = data() + offset;
+        std::memcpy(dst, &header, sizeof(header));
+        std::memcpy(dst + sizeof(header), module.data(), module.size());
+        std::memcpy(dst + sizeof(header) + module.size(), message.data(), message.size());
+        head.store(h + padding + size, std::memory_order_release);
+        return true;
+    }
+};
+
+struct Line {
+    std::int64_t timeUs;
+    Level level;
+    std::string module;
+    std::string message;
+};
+
+// Leaked on purpose: static destructors in other translation units may still
+// log after the writer has been stopped
+struct State {
+    std::mutex registryMutex;
+    std::vector<std::unique_ptr<Ring>> rings; // Guarded by registryMutex; never shrinks
+
+    std::mutex wakeMutex;
+    std::condition_variable wakeCv;  // Writer sleeps here
+    std::condition_variable flushCv; // flush() waits here
+    std::atomic<bool> wakePending{false};
+    std::uint64_t flushRequested = 0; // Guarded by wakeMutex
+    std::uint64_t flushCompleted = 0; // Guarded by wakeMutex
+    bool stopRequested = false;       // Guarded by wakeMutex
+
+    std::thread writer;
+    bool writerStarted = false;          // Guarded by registryMutex
+    std::atomic<bool> writerStopped{false}; // After shutdown, messages are written inline
+
+    std::mutex outputMutex; // Guards the sinks below
+    std::ofstream logFile;
+
+    std::atomic<std::uint64_t> droppedReported{0};
+};
+
+State& state() {
+    static State* s = new State();
+    return *s;
+}
+
+std::string formatTimestamp(std::int64_t timeUs) {
+    auto time = static_cast<std::time_t>(timeUs / 1000000);
+    auto ms = (timeUs / 1000) % 1000;
 
     std::stringstream ss;
     ss << std::put_time(std::localtime(&time), "%H:%M:%S");
-    ss << '.' << std::setfill('0') << std::setw(3) << ms.count();
+    ss << '.' << std::setfill('0') << std::setw(3) << ms;
     return ss.str();
 }
 
@@ -57,47 +182,279 @@ const char* levelToColor(Level level) {
     return "\033[0m";
 }
 
-void logMessage(Level level, std::string_view module, std::string_view message) {
-    if (level < g_minLevel) {
-        return;
-    }
-
-    std::lock_guard<std::mutex> lock(g_logMutex);
-
-    std::string timestamp = getCurrentTimestamp();
-    const char* levelStr = levelToString(level);
-    const char* color = levelToColor(level);
+// Caller holds outputMutex
+void writeLine(State& s, const Line& line) {
+    std::string timestamp = formatTimestamp(line.timeUs);
+    const char* levelStr = levelToString(line.level);
+    const char* color = levelToColor(line.level);
     const char* reset = "\033[0m";
 
     // Console output with color (only when enabled via --verbose)
-    if (g_consoleOutput) {
+    if (g_consoleOutput.load(std::memory_order_relaxed)) {
         std::cerr << color << "[" << timestamp << "] [" << levelStr << "] "
-                  << "[" << module << "] " << reset << message << std::endl;
+                  << "[" << line.module << "] " << reset << line.message << '\n';
     }
 
     // File output without color
-    if (g_logFile.is_open()) {
-        g_logFile << "[" << timestamp << "] [" << levelStr << "] "
-                  << "[" << module << "] " << message << std::endl;
+    if (s.logFile.is_open()) {
+        s.logFile << "[" << timestamp << "] [" << levelStr << "] "
+                  << "[" << line.module << "] " << line.message << '\n';
+    }
+}
+
+// Moves every published record out of the rings, oldest first across threads
+void drainRings(State& s, std::vector<Line>& lines) {
+    std::vector<Ring*> rings;
+    {
+        std::lock_guard<std::mutex> lock(s.registryMutex);
+        rings.reserve(s.rings.size());
+        for (auto& ring : s.rings)
+            rings.push_back(ring.get());
+    }
+
+    std::uint64_t dropped = 0;
+    for (Ring* ring : rings) {
+        dropped += ring->dropped.load(std::memory_order_relaxed);
+        std::uint64_t t = ring->tail.load(std::memory_order_relaxed);
+        std::uint64_t h = ring->head.load(std::memory_order_acquire);
+        while (t < h) {
+            const char* src = ring->data() + (t & (kRingBytes - 1));
+            RecordHeader header;
+            std::memcpy(&header, src, 2 * sizeof(std::uint32_t));
+            if (header.kind == RecordKind::Message) {
+                std::memcpy(&header, src, sizeof(header));
+                const char* text = src + sizeof(header);
+                lines.push_back({header.timeUs, static_cast<Level>(header.level),
+                                 std::string(text, header.moduleLen),
+                                 std::string(text + header.moduleLen, header.messageLen)});
+            }
+            t += header.size;
+        }
+        ring->tail.store(t, std::memory_order_release);
+    }
+
+    // Report overflow once per batch rather than per lost message
+    std::uint64_t reported = s.droppedReported.load(std::memory_order_relaxed);
+    if (dropped > reported) {
+        s.droppedReported.store(dropped, std::memory_order_relaxed);
+        lines.push_back({nowUs(), Level::Warning, "Log",
+                         std::to_string(dropped - reported) +
+                             " message(s) dropped: log queue full"});
+    }
+
+    std::stable_sort(lines.begin(), lines.end(),
+                     [](const Line& a, const Line& b) { return a.timeUs < b.timeUs; });
+}
+
+void writeBatch(State& s, std::vector<Line>& lines) {
+    if (lines.empty())
+        return;
+    std::lock_guard<std::mutex> lock(s.outputMutex);
+    for (const auto& line : lines)
+        writeLine(s, line);
+    if (g_consoleOutput.load(std::memory_order_relaxed))
+        std::cerr.flush();
+    if (s.logFile.is_open())
+        s.logFile.flush();
+    lines.clear();
+}
+
+void writerLoop() {
+    State& s = state();
+    std::vector<Line> lines;
+    for (;;) {
+        std::uint64_t flushTarget = 0;
+        bool stopping = false;
+        {
+            std::unique_lock<std::mutex> lock(s.wakeMutex);
+            s.wakeCv.wait_for(lock, kIdleWait, [&] {
+                return s.wakePending.load(std::memory_order_relaxed) || s.stopRequested ||
+                       s.flushRequested > s.flushCompleted;
+            });
+            flushTarget = s.flushRequested;
+            stopping = s.stopRequested;
+        }
+        s.wakePending.store(false, std::memory_order_relaxed);
+
+        drainRings(s, lines);
+        writeBatch(s, lines);
+
+        {
+            std::lock_guard<std::mutex> lock(s.wakeMutex);
+            s.flushCompleted = std::max(s.flushCompleted, flushTarget);
+        }
+        s.flushCv.notify_all();
+
+        if (stopping)
+            return;
+    }
+}
+
+// Caller holds registryMutex
+void startWriterLocked(State& s) {
+    if (s.writerStarted)
+        return;
+    s.writerStarted = true;
+    s.writer = std::thread(writerLoop);
+}
+
+// Drains and joins the writer at exit; later messages are written inline
+struct WriterShutdown {
+    ~WriterShutdown() {
+        State& s = state();
+        {
+            std::lock_guard<std::mutex> lock(s.registryMutex);
+            if (!s.writerStarted)
+                return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(s.wakeMutex);
+            s.stopRequested = true;
+        }
+        s.wakeCv.notify_one();
+        if (s.writer.joinable())
+            s.writer.join();
+        s.writerStopped.store(true, std::memory_order_release);
+
+        // Anything that raced in after the writer's final pass
+        std::vector<Line> lines;
+        drainRings(s, lines);
+        writeBatch(s, lines);
+    }
+};
+WriterShutdown g_writerShutdown;
+
+// Marks the ring reusable when its thread exits
+struct RingHandle {
+    Ring* ring = nullptr;
+    ~RingHandle() {
+        if (ring)
+            ring->inUse.store(false, std::memory_order_release);
+    }
+};
+
+thread_local RingHandle t_ring;
+
+Ring& threadRing() {
+    if (t_ring.ring)
+        return *t_ring.ring;
+
+    // First message from this thread: claim a drained ring from an exited
+    // thread, or register a new one
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.registryMutex);
+    startWriterLocked(s);
+    for (auto& ring : s.rings) {
+        if (!ring->inUse.load(std::memory_order_acquire) &&
+            ring->tail.load(std::memory_order_acquire) ==
+                ring->head.load(std::memory_order_relaxed)) {
+            ring->inUse.store(true, std::memory_order_relaxed);
+            t_ring.ring = ring.get();
+            return *ring;
+        }
+    }
+    s.rings.push_back(std::make_unique<Ring>());
+    t_ring.ring = s.rings.back().get();
+    return *t_ring.ring;
+}
+
+void enqueue(Level level, std::string_view module, std::string_view message) {
+    State& s = state();
+    std::int64_t timeUs = nowUs();
+
+    if (s.writerStopped.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(s.outputMutex);
+        writeLine(s, {timeUs, level, std::string(module), std::string(message)});
+        return;
+    }
+
+    threadRing().tryPush(level, timeUs, module, message);
+
+    // notify_one never blocks; a missed wakeup costs at most kIdleWait
+    if (!s.wakePending.load(std::memory_order_relaxed) &&
+        !s.wakePending.exchange(true, std::memory_order_relaxed))
+        s.wakeCv.notify_one();
+}
+
+// Per-thread rate limiter slots, direct-mapped by call site key
+struct RateSlot {
+    const void* key = nullptr;
+    std::int64_t windowStartUs = 0;
+    std::uint32_t count = 0;
+    std::uint32_t suppressed = 0;
+};
+
+constexpr std::size_t kRateSlots = 64;
+thread_local std::array<RateSlot, kRateSlots> t_rateSlots;
+
+bool admitKey(Level level, std::string_view module, const void* key) {
+    // Filtered levels never reach the limiter, so they cannot queue its notes
+    if (level < g_minLevel.load(std::memory_order_relaxed)) {
+        return false;
+    }
+
+    auto bits = reinterpret_cast<std::uintptr_t>(key);
+    RateSlot& slot = t_rateSlots[(bits ^ (bits >> 7) ^ (bits >> 15)) & (kRateSlots - 1)];
+    std::int64_t now = nowUs();
+
+    if (slot.key != key || now - slot.windowStartUs >= kRateWindowMs * 1000) {
+        if (slot.key == key && slot.suppressed > 0) {
+            enqueue(level, module,
+                    "(" + std::to_string(slot.suppressed) + " similar message(s) suppressed)");
+        }
+        slot.key = key;
+        slot.windowStartUs = now;
+        slot.count = 0;
+        slot.suppressed = 0;
+    }
+
+    if (slot.count < kRateBurst) {
+        ++slot.count;
+        return true;
     }
+    if (slot.suppressed++ == 0)
+        enqueue(level, module, "(repeating; further copies suppressed for up to 1s)");
+    return false;
+}
+
+// Rate-limit key: identical text from the same module
+const void* messageKey(Level level, std::string_view module, std::string_view message) {
+    std::uint64_t h = 14695981039346656037ull; // FNV-1a
+    auto mix = [&h](std::string_view text) {
+        for (char c : text) {
+            h ^= static_cast<unsigned char>(c);
+            h *= 1099511628211ull;
+        }
+    };
+    mix(module);
+    mix(message);
+    h ^= static_cast<std::uint64_t>(level);
+    return reinterpret_cast<const void*>(static_cast<std::uintptr_t>(h | 1));
+}
+
+void logMessage(Level level, std::string_view module, std::string_view message) {
+    if (!admitKey(level, module, messageKey(level, module, message))) {
+        return;
+    }
+    enqueue(level, module, message);
 }
 
 } // namespace
 
 void setLevel(Level level) {
-    g_minLevel = level;
+    g_minLevel.store(level, std::memory_order_relaxed);
 }
 
 Level getLevel() {
-    return g_minLevel;
+    return g_minLevel.load(std::memory_order_relaxed);
 }
 
 void setConsoleOutput(bool enabled) {
-    g_consoleOutput = enabled;
+    g_consoleOutput.store(enabled, std::memory_order_relaxed);
 }
 
 bool getConsoleOutput() {
-    return g_consoleOutput;
+    return g_consoleOutput.load(std::memory_order_relaxed);
 }
 
 void debug(std::string_view module, std::string_view message) {
@@ -116,6 +473,31 @@ void error(std::string_view module, std::string_view message) {
     logMessage(Level::Error, module, message);
 }
 
+void flush() {
+    State& s = state();
+    {
+        std::lock_guard<std::mutex> lock(s.registryMutex);
+        if (!s.writerStarted)
+            return;
+    }
+    if (s.writerStopped.load(std::memory_order_acquire))
+        return;
+
+    std::unique_lock<std::mutex> lock(s.wakeMutex);
+    std::uint64_t target = ++s.flushRequested;
+    s.wakeCv.notify_one();
+    s.flushCv.wait(lock, [&] { return s.flushCompleted >= target || s.stopRequested; });
+}
+
+std::uint64_t droppedCount() {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.registryMutex);
+    std::uint64_t total = 0;
+    for (const auto& ring : s.rings)
+        total += ring->dropped.load(std::memory_order_relaxed);
+    return total;
+}
+
 namespace detail {
 
 void logAtLevel(Level level, std::string_view module, std::string_view message) {
@@ -125,20 +507,24 @@ void logAtLevel(Level level, std::string_view module, std::string_view message)
 } // namespace detail
 
 void setLogFile(const std::string& path) {
-    std::lock_guard<std::mutex> lock(g_logMutex);
-    if (g_logFile.is_open()) {
-        g_logFile.close();
+    flush();
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.outputMutex);
+    if (s.logFile.is_open()) {
+        s.logFile.close();
     }
-    g_logFile.open(path, std::ios::app);
-    if (!g_logFile.is_open()) {
+    s.logFile.open(path, std::ios::app);
+    if (!s.logFile.is_open()) {
         std::cerr << "Failed to open log file: " << path << std::endl;
     }
 }
 
 void closeLogFile() {
-    std::lock_guard<std::mutex> lock(g_logMutex);
-    if (g_logFile.is_open()) {
-        g_logFile.close();
+    flush();
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.outputMutex);
+    if (s.logFile.is_open()) {
+        s.logFile.close();
     }
 }
 
@@ -1,13 +1,28 @@
 #pragma once
 
+#include <cstdint>
 #include <cstdio>
 #include <cstring>
 #include <string>
 #include <string_view>
 
+// Asynchronous logging. Messages are formatted on the calling thread and
+// pushed into that thread's lock-free single-producer ring; a background
+// writer thread drains the rings and does all file/console I/O. Enqueueing
+// never blocks: when a ring is full the message is dropped and counted.
+//
+// Repeated messages are rate-limited per thread: after kRateBurst copies of
+// the same text from the same module within kRateWindowMs, further copies are
+// suppressed and summarized once the window rolls over. Formatted calls are
+// keyed on the formatted text, so one call site logging different values is
+// never suppressed.
+
 namespace dw {
 namespace log {
 
+inline constexpr std::uint32_t kRateBurst = 10;
+inline constexpr std::int64_t kRateWindowMs = 1000;
+
 enum class Level { Debug, Info, Warning, Error };
 
 // Set minimum log level (default: Info in release, Debug in debug builds)
@@ -24,10 +39,16 @@ void info(std::string_view module, std::string_view message);
 void warning(std::string_view module, std::string_view message);
 void error(std::string_view module, std::string_view message);
 
+// Block until everything logged before the call has been written
+void flush();
+
+// Messages discarded because a thread's ring was full
+std::uint64_t droppedCount();
+
 // Internal helper -- do not call directly
 namespace detail {
 
-// Dispatch to the correct level function
+// Level filter, rate limit and queueing for an already-formatted message
 void logAtLevel(Level level, std::string_view module, std::string_view message);
 
 inline constexpr std::size_t kFormatBufSize = 1024;
@@ -85,7 +106,7 @@ void errorf(const char* module, const char* format, Args... args) {
     detail::formatAndLog(Level::Error, module, format, args...);
 }
 
-// Log to file (in addition to console)
+// Log to file (in addition to console). Both flush pending messages first.
 void setLogFile(const std::string& path);
 void closeLogFile();
 
@@ -0,0 +1,344 @@
+#include "trace.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "file_utils.h"
+
+namespace dw {
+namespace trace {
+
+namespace detail {
+std::atomic<bool> g_enabled{true};
+} // namespace detail
+
+namespace {
+
+static_assert((kRingCapacity & (kRingCapacity - 1)) == 0, "ring capacity must be a power of two");
+
+const auto g_epoch = std::chrono::steady_clock::now();
+
+// Ring slot as a seqlock: seq is 0 while the writer fills it, then index + 1
+// of the event it holds. The fields are relaxed atomics so a reader racing
+// the writer gets a torn copy it can detect, not a data race.
+struct Slot {
+    std::atomic<u64> seq{0};
+    std::atomic<const char*> name{nullptr};
+    std::atomic<u64> startNs{0};
+    std::atomic<u64> durationNs{0};
+    std::atomic<f64> value{0.0};
+    std::atomic<EventType> type{EventType::Zone};
+};
+
+// Single-writer ring. The owning thread writes a slot, then publishes it by
+// bumping head with release order; snapshot() keeps only slots whose
+// sequence number is unchanged across its copy.
+struct ThreadBuffer {
+    explicit ThreadBuffer(u32 id) : threadId(id), slots(kRingCapacity) {}
+
+    u32 threadId;                  // Guarded by g_registryMutex
+    std::string name;              // Guarded by g_registryMutex
+    std::vector<Slot> slots;
+    std::atomic<u64> head{0};      // Events ever written
+    std::atomic<u64> clearedTo{0}; // Events before this index were cleared
+    std::atomic<bool> inUse{true};
+
+    void push(const Event& event) {
+        u64 index = head.load(std::memory_order_relaxed);
+        Slot& slot = slots[index & (kRingCapacity - 1)];
+        slot.seq.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.name.store(event.name, std::memory_order_relaxed);
+        slot.startNs.store(event.startNs, std::memory_order_relaxed);
+        slot.durationNs.store(event.durationNs, std::memory_order_relaxed);
+        slot.value.store(event.value, std::memory_order_relaxed);
+        slot.type.store(event.type, std::memory_order_relaxed);
+        slot.seq.store(index + 1, std::memory_order_release);
+        head.store(index + 1, std::memory_order_release);
+    }
+
+    // Copy of the event at `index`, or false if the slot has been reused
+    bool read(u64 index, Event& out) const {
+        const Slot& slot = slots[index & (kRingCapacity - 1)];
+        if (slot.seq.load(std::memory_order_acquire) != index + 1)
+            return false;
+        out.name = slot.name.load(std::memory_order_relaxed);
+        out.startNs = slot.startNs.load(std::memory_order_relaxed);
+        out.durationNs = slot.durationNs.load(std::memory_order_relaxed);
+        out.value = slot.value.load(std::memory_order_relaxed);
+        out.type = slot.type.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return slot.seq.load(std::memory_order_relaxed) == index + 1;
+    }
+};
+
+// Retired rings are only recycled past this many, so events from finished
+// worker threads stay visible until the pool is under pressure
+constexpr usize kMaxBuffers = 32;
+
+std::mutex g_registryMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> g_buffers;
+u32 g_nextThreadId = 1;
+
+// Marks the ring retired when its thread exits
+struct BufferHandle {
+    ThreadBuffer* buffer = nullptr;
+    ~BufferHandle() {
+        if (buffer)
+            buffer->inUse.store(false, std::memory_order_release);
+    }
+};
+
+thread_local BufferHandle t_handle;
+thread_local std::string t_threadName; // Applied when the ring is claimed
+
+ThreadBuffer& threadBuffer() {
+    if (t_handle.buffer)
+        return *t_handle.buffer;
+
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    if (g_buffers.size() >= kMaxBuffers) {
+        for (auto& buffer : g_buffers) {
+            if (!buffer->inUse.load(std::memory_order_acquire)) {
+                buffer->inUse.store(true, std::memory_order_relaxed);
+                buffer->threadId = g_nextThreadId++;
+                buffer->name = t_threadName;
+                buffer->clearedTo.store(buffer->head.load(std::memory_order_relaxed),
+                                        std::memory_order_relaxed);
+                t_handle.buffer = buffer.get();
+                return *buffer;
+            }
+        }
+    }
+    g_buffers.push_back(std::make_unique<ThreadBuffer>(g_nextThreadId++));
+    g_buffers.back()->name = t_threadName;
+    t_handle.buffer = g_buffers.back().get();
+    return *t_handle.buffer;
+}
+
+// Frame history is only touched from the main thread
+u64 g_lastFrameNs = 0;
+std::array<f32, kFrameHistory> g_frameTimes{};
+usize g_frameCount = 0;
+
+void appendEscaped(std::string& out, const char* text) {
+    for (const char* c = text; *c; ++c) {
+        switch (*c) {
+        case '"':
+            out += "\\\"";
+            break;
+        case '\\':
+            out += "\\\\";
+            break;
+        default:
+            if (static_cast<unsigned char>(*c) < 0x20)
+                out += ' ';
+            else
+                out += *c;
+        }
+    }
+}
+
+void appendMicros(std::string& out, u64 ns) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.3f", static_cast<f64>(ns) / 1000.0);
+    out += buf;
+}
+
+} // namespace
+
+void setEnabled(bool enabled) {
+    detail::g_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+u64 nowNs() {
+    auto elapsed = std::chrono::steady_clock::now() - g_epoch;
+    return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+}
+
+void setThreadName(const std::string& name) {
+    t_threadName = name;
+    if (t_handle.buffer) {
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        t_handle.buffer->name = name;
+    }
+}
+
+void recordZone(const char* name, u64 startNs, u64 endNs) {
+    Event event;
+    event.name = name;
+    event.startNs = startNs;
+    event.durationNs = endNs > startNs ? endNs - startNs : 0;
+    event.type = EventType::Zone;
+    threadBuffer().push(event);
+}
+
+void recordCounter(const char* name, f64 value) {
+    Event event;
+    event.name = name;
+    event.startNs = nowNs();
+    event.value = value;
+    event.type = EventType::Counter;
+    threadBuffer().push(event);
+}
+
+void markFrame() {
+    u64 now = nowNs();
+    if (g_lastFrameNs != 0) {
+        u64 duration = now - g_lastFrameNs;
+        g_frameTimes[g_frameCount % kFrameHistory] =
+            static_cast<f32>(static_cast<f64>(duration) / 1.0e6);
+        ++g_frameCount;
+        if (isEnabled()) {
+            Event event;
+            event.name = "Frame";
+            event.startNs = g_lastFrameNs;
+            event.durationNs = duration;
+            event.type = EventType::Frame;
+            threadBuffer().push(event);
+        }
+    }
+    g_lastFrameNs = now;
+}
+
+std::vector<ThreadTrace> snapshot() {
+    std::vector<ThreadTrace> result;
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    result.reserve(g_buffers.size());
+
+    for (const auto& buffer : g_buffers) {
+        ThreadTrace trace;
+        trace.threadId = buffer->threadId;
+        trace.name = buffer->name;
+
+        u64 head = buffer->head.load(std::memory_order_acquire);
+        u64 begin = head > kRingCapacity ? head - kRingCapacity : 0;
+        begin = std::max(begin, buffer->clearedTo.load(std::memory_order_relaxed));
+        trace.events.reserve(static_cast<usize>(head - begin));
+
+        // A slot the writer reused mid-copy means everything older is gone
+        // too; restart the window after it so the events stay contiguous
+        Event event;
+        for (u64 i = begin; i < head; ++i) {
+            if (buffer->read(i, event)) {
+                trace.events.push_back(event);
+            } else {
+                trace.events.clear();
+                begin = i + 1;
+            }
+        }
+        u64 clearedTo = buffer->clearedTo.load(std::memory_order_relaxed);
+        trace.dropped = begin > clearedTo ? begin - clearedTo : 0;
+
+        if (!trace.events.empty() || !trace.name.empty())
+            result.push_back(std::move(trace));
+    }
+    return result;
+}
+
+void clear() {
+    {
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        for (auto& buffer : g_buffers)
+            buffer->clearedTo.store(buffer->head.load(std::memory_order_acquire),
+                                    std::memory_order_relaxed);
+    }
+    g_lastFrameNs = 0;
+    g_frameCount = 0;
+    g_frameTimes.fill(0.0f);
+}
+
+std::vector<ZoneStats> summarize(const std::vector<ThreadTrace>& threads, u64 sinceNs) {
+    std::unordered_map<const char*, ZoneStats> byName;
+    for (const auto& thread : threads) {
+        for (const auto& event : thread.events) {
+            if (event.type != EventType::Zone || event.startNs < sinceNs)
+                continue;
+            auto& stats = byName[event.name];
+            stats.name = event.name;
+            f64 ms = static_cast<f64>(event.durationNs) / 1.0e6;
+            ++stats.calls;
+            stats.totalMs += ms;
+            stats.maxMs = std::max(stats.maxMs, ms);
+        }
+    }
+
+    std::vector<ZoneStats> result;
+    result.reserve(byName.size());
+    for (auto& [name, stats] : byName)
+        result.push_back(stats);
+    std::sort(result.begin(), result.end(), [](const ZoneStats& a, const ZoneStats& b) {
+        return a.totalMs > b.totalMs;
+    });
+    return result;
+}
+
+std::vector<f32> frameTimes() {
+    std::vector<f32> result;
+    usize count = std::min(g_frameCount, kFrameHistory);
+    result.reserve(count);
+    for (usize i = g_frameCount - count; i < g_frameCount; ++i)
+        result.push_back(g_frameTimes[i % kFrameHistory]);
+    return result;
+}
+
+std::string toChromeTraceJson(const std::vector<ThreadTrace>& threads) {
+    std::string out;
+    out.reserve(256);
+    out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    auto beginEvent = [&]() {
+        if (!first)
+            out += ",\n";
+        first = false;
+    };
+
+    for (const auto& thread : threads) {
+        std::string tid = std::to_string(thread.threadId);
+        if (!thread.name.empty()) {
+            beginEvent();
+            out += "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" + tid +
+                   ",\"args\":{\"name\":\"";
+            appendEscaped(out, thread.name.c_str());
+            out += "\"}}";
+        }
+
+        for (const auto& event : thread.events) {
+            beginEvent();
+            out += "{\"name\":\"";
+            appendEscaped(out, event.name ? event.name : "");
+            out += "\",\"pid\":1,\"tid\":" + tid + ",\"ts\":";
+            appendMicros(out, event.startNs);
+            if (event.type == EventType::Counter) {
+                char value[48];
+                std::snprintf(value, sizeof(value), "%.17g", event.value);
+                out += ",\"ph\":\"C\",\"args\":{\"value\":";
+                out += value;
+                out += "}}";
+            } else {
+                out += ",\"ph\":\"X\",\"dur\":";
+                appendMicros(out, event.durationNs);
+                out += event.type == EventType::Frame ? ",\"cat\":\"frame\"}"
+                                                      : ",\"cat\":\"zone\"}";
+            }
+        }
+    }
+    out += "]}\n";
+    return out;
+}
+
+bool exportChromeTrace(const Path& path, std::string& error) {
+    if (!file::writeText(path, toChromeTraceJson(snapshot()))) {
+        error = "Failed to write trace file: " + path.string();
+        return false;
+    }
+    return true;
+}
+
+} // namespace trace
+} // namespace dw
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "../types.h"
+
+// Hot-path tracing: scoped zones, counters and frame markers recorded into
+// per-thread ring buffers, viewable in the Profiler panel and exportable as
+// Chrome trace JSON (chrome://tracing, ui.perfetto.dev).
+//
+// Recording is lock-free: each thread appends to its own fixed-size ring and
+// publishes with a release store. Every slot carries a sequence number, so a
+// reader copying the ring keeps only slots that still hold the event it
+// expected. When the ring is full the oldest events are overwritten. Zone and
+// counter names must be string literals (only the pointer is stored).
+//
+// Configuring with -DDW_ENABLE_TRACING=OFF defines DW_TRACE_DISABLED and the
+// macros below compile to nothing; the runtime switch (setEnabled) costs one
+// relaxed load per zone when off.
+
+namespace dw {
+namespace trace {
+
+enum class EventType : u8 { Zone, Counter, Frame };
+
+struct Event {
+    const char* name = nullptr;
+    u64 startNs = 0;    // Since the trace epoch
+    u64 durationNs = 0; // Zones and frames
+    f64 value = 0.0;    // Counters
+    EventType type = EventType::Zone;
+};
+
+// Per-thread ring size in events
+constexpr usize kRingCapacity = 1u << 14;
+
+// Frame times kept for the panel
+constexpr usize kFrameHistory = 240;
+
+#if defined(DW_TRACE_DISABLED)
+constexpr bool kCompiledIn = false;
+#else
+constexpr bool kCompiledIn = true;
+#endif
+
+namespace detail {
+extern std::atomic<bool> g_enabled;
+} // namespace detail
+
+// Runtime switch (default on)
+void setEnabled(bool enabled);
+inline bool isEnabled() {
+    return detail::g_enabled.load(std::memory_order_relaxed);
+}
+
+// Monotonic nanoseconds since the trace epoch (first use)
+u64 nowNs();
+
+// Label for the calling thread in snapshots and exports. Cheap: the ring is
+// only allocated once the thread records its first event.
+void setThreadName(const std::string& name);
+
+void recordZone(const char* name, u64 startNs, u64 endNs);
+void recordCounter(const char* name, f64 value);
+
+// Frame boundary; call once per frame from the main thread
+void markFrame();
+
+// RAII zone; use through DW_TRACE_ZONE
+class Zone {
+  public:
+    explicit Zone(const char* name) : m_name(isEnabled() ? name : nullptr) {
+        if (m_name)
+            m_start = nowNs();
+    }
+    ~Zone() {
+        if (m_name)
+            recordZone(m_name, m_start, nowNs());
+    }
+    Zone(const Zone&) = delete;
+    Zone& operator=(const Zone&) = delete;
+
+  private:
+    const char* m_name;
+    u64 m_start = 0;
+};
+
+struct ThreadTrace {
+    u32 threadId = 0;
+    std::string name;
+    std::vector<Event> events; // Oldest first
+    u64 dropped = 0;           // Events overwritten before this snapshot
+};
+
+// Copy of every thread's buffered events
+std::vector<ThreadTrace> snapshot();
+
+// Discard buffered events and frame history (buffers stay registered)
+void clear();
+
+struct ZoneStats {
+    const char* name = nullptr;
+    u32 calls = 0;
+    f64 totalMs = 0.0;
+    f64 maxMs = 0.0;
+};
+
+// Zone totals over events that started at or after sinceNs, by total time
+std::vector<ZoneStats> summarize(const std::vector<ThreadTrace>& threads, u64 sinceNs = 0);
+
+// Recent frame durations in milliseconds, oldest first (main thread)
+std::vector<f32> frameTimes();
+
+// Chrome trace event format ("traceEvents" array, microsecond timestamps)
+std::string toChromeTraceJson(const std::vector<ThreadTrace>& threads);
+bool exportChromeTrace(const Path& path, std::string& error);
+
+} // namespace trace
+} // namespace dw
+
+#if defined(DW_TRACE_DISABLED)
+#define DW_TRACE_ZONE(name) ((void)0)
+#define DW_TRACE_COUNTER(name, value) ((void)0)
+#define DW_TRACE_FRAME() ((void)0)
+#else
+#define DW_TRACE_CONCAT_INNER(a, b) a##b
+#define DW_TRACE_CONCAT(a, b) DW_TRACE_CONCAT_INNER(a, b)
+#define DW_TRACE_ZONE(name) ::dw::trace::Zone DW_TRACE_CONCAT(dwTraceZone_, __LINE__)(name)
+#define DW_TRACE_COUNTER(name, value)                                                      \
+    do {                                                                                   \
+        if (::dw::trace::isEnabled())                                                      \
+            ::dw::trace::recordCounter(name, static_cast<::dw::f64>(value));               \
+    } while (0)
+#define DW_TRACE_FRAME() ::dw::trace::markFrame()
+#endif
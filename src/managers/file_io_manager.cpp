@@ -269,8 +269,9 @@ void FileIOManager::processCompletedImports(ViewportPanel* viewport,
         // up when started via the import options "Queue for AI tagging" checkbox.
     }
 
-    // Refresh library to show the newly imported model
-    if (library) {
+    // Imported models reach the library panel through the ModelChangeFeed;
+    // G-code files are not tracked there, so reload the lists for those
+    if (library && task.importType == ImportType::GCode) {
         library->refresh();
     }
 
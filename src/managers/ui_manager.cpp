@@ -42,6 +42,7 @@
 #include "ui/panels/gcode_panel.h"
 #include "ui/panels/library_panel.h"
 #include "ui/panels/materials_panel.h"
+#include "ui/panels/profiler_panel.h"
 #include "ui/panels/project_panel.h"
 #include "ui/panels/properties_panel.h"
 #include "ui/panels/start_page.h"
@@ -88,6 +89,7 @@ void UIManager::init(LibraryManager* libraryManager,
     m_cncSettingsPanel = std::make_unique<CncSettingsPanel>();
     m_cncMacroPanel = std::make_unique<CncMacroPanel>();
     m_directCarvePanel = std::make_unique<DirectCarvePanel>();
+    m_profilerPanel = std::make_unique<ProfilerPanel>();
     m_fileDialog = std::make_unique<FileDialog>();
     m_lightingDialog = std::make_unique<LightingDialog>();
     m_importSummaryDialog = std::make_unique<ImportSummaryDialog>();
@@ -110,6 +112,7 @@ void UIManager::init(LibraryManager* libraryManager,
     }
     if (m_gcodePanel)
         m_gcodePanel->setFileDialog(m_fileDialog.get());
+    m_profilerPanel->setFileDialog(m_fileDialog.get());
 
     buildPanelRegistry();
     m_dialogList = {
@@ -160,6 +163,7 @@ void UIManager::shutdown() {
     m_cncSettingsPanel.reset();
     m_cncMacroPanel.reset();
     m_directCarvePanel.reset();
+    m_profilerPanel.reset();
     m_startPage.reset();
 }
 
@@ -207,6 +211,8 @@ void UIManager::buildPanelRegistry() {
          m_cncMacroPanel.get(), true},
         {"direct_carve",    &m_showDirectCarve,     "Direct Carve",      "Direct Carve",
          m_directCarvePanel.get(), true},
+        {"profiler",        &m_showProfiler,        "Profiler",          "Profiler",
+         m_profilerPanel.get(), true},
     };
 }
 
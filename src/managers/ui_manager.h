@@ -47,6 +47,7 @@ class MaterialsPanel;
 class StartPage;
 class ToolBrowserPanel;
 class DirectCarvePanel;
+class ProfilerPanel;
 class GroupPanel;
 
 // Forward declarations - dialogs
@@ -151,6 +152,7 @@ class UIManager {
     CncSettingsPanel* cncSettingsPanel() { return m_cncSettingsPanel.get(); }
     CncMacroPanel* cncMacroPanel() { return m_cncMacroPanel.get(); }
     DirectCarvePanel* directCarvePanel() { return m_directCarvePanel.get(); }
+    ProfilerPanel* profilerPanel() { return m_profilerPanel.get(); }
     FileDialog* fileDialog() { return m_fileDialog.get(); }
     LightingDialog* lightingDialog() { return m_lightingDialog.get(); }
     ImportSummaryDialog* importSummaryDialog() { return m_importSummaryDialog.get(); }
@@ -181,6 +183,7 @@ class UIManager {
     bool& showCncSettings() { return m_showCncSettings; }
     bool& showCncMacros() { return m_showCncMacros; }
     bool& showDirectCarve() { return m_showDirectCarve; }
+    bool& showProfiler() { return m_showProfiler; }
     bool& showStartPage() { return m_showStartPage; }
 
     // Workspace mode
@@ -268,6 +271,7 @@ class UIManager {
     std::unique_ptr<CncSettingsPanel> m_cncSettingsPanel;
     std::unique_ptr<CncMacroPanel> m_cncMacroPanel;
     std::unique_ptr<DirectCarvePanel> m_directCarvePanel;
+    std::unique_ptr<ProfilerPanel> m_profilerPanel;
 
     // Panel visibility
     bool m_showViewport = true;
@@ -289,6 +293,7 @@ class UIManager {
     bool m_showCncSettings = false;
     bool m_showCncMacros = false;
     bool m_showDirectCarve = false;
+    bool m_showProfiler = false;
     bool m_showStartPage = true;
 
     // Group panels (blank dockable containers)
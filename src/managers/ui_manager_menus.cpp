@@ -160,6 +160,7 @@ void UIManager::renderViewMenu() {
     if (ImGui::MenuItem("Add Group Panel"))
         addGroupPanel();
     ImGui::Separator();
+    ImGui::MenuItem("Profiler", nullptr, &m_showProfiler);
     if (ImGui::MenuItem("Lighting Settings", "Ctrl+L") && m_lightingDialog)
         m_lightingDialog->open();
     ImGui::EndMenu();
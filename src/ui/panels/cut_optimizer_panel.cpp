@@ -133,12 +133,13 @@ void CutOptimizerPanel::render() {
                 // Info line below visualization
                 if (m_selectedSheet < static_cast<int>(m_result.sheets.size())) {
                     const auto& sr = m_result.sheets[static_cast<size_t>(m_selectedSheet)];
+                    const auto& stock = selectedSheetStock();
                     int pieceCount = static_cast<int>(sr.placements.size());
                     float eff = sr.efficiency() * 100.0f;
                     ImGui::Text("%d pieces  %s  %.0fx%.0f  %.1f%%",
                                 pieceCount, Icons::Optimizer,
-                                static_cast<double>(m_sheet.width),
-                                static_cast<double>(m_sheet.height),
+                                static_cast<double>(stock.width),
+                                static_cast<double>(stock.height),
                                 static_cast<double>(eff));
                 }
             } else {
@@ -617,10 +618,23 @@ void CutOptimizerPanel::renderSettings() {
 // ---------------------------------------------------------------------------
 // VISUALIZATION — reuse existing Canvas2D
 // ---------------------------------------------------------------------------
+const optimizer::Sheet& CutOptimizerPanel::selectedSheetStock() const {
+    if (m_hasMultiResults && !m_multiResult.groups.empty() && m_selectedSheet >= 0) {
+        int groupIdx = std::clamp(m_selectedGroupIdx, 0,
+                                  static_cast<int>(m_multiResult.groups.size()) - 1);
+        const auto& grp = m_multiResult.groups[static_cast<size_t>(groupIdx)];
+        if (grp.mixedStock())
+            return grp.stockFor(static_cast<usize>(m_selectedSheet));
+    }
+    return m_sheet;
+}
+
 void CutOptimizerPanel::renderVisualization() {
     if (m_result.sheets.empty())
         return;
 
+    const auto& sheet = selectedSheetStock();
+
     auto area = m_canvas.begin();
     if (!area)
         return;
@@ -631,8 +645,8 @@ void CutOptimizerPanel::renderVisualization() {
                                  IM_COL32(40, 40, 40, 255));
 
     // Scale to fit sheet
-    float scaleX = (area.size.x - 20) / m_sheet.width;
-    float scaleY = (area.size.y - 20) / m_sheet.height;
+    float scaleX = (area.size.x - 20) / sheet.width;
+    float scaleY = (area.size.y - 20) / sheet.height;
     float scale = m_canvas.effectiveScale(std::min(scaleX, scaleY));
 
     float offsetX = area.pos.x + 10 + m_canvas.panX;
@@ -640,7 +654,7 @@ void CutOptimizerPanel::renderVisualization() {
 
     // Sheet outline
     ImVec2 sheetP1(offsetX, offsetY);
-    ImVec2 sheetP2(offsetX + m_sheet.width * scale, offsetY + m_sheet.height * scale);
+    ImVec2 sheetP2(offsetX + sheet.width * scale, offsetY + sheet.height * scale);
     area.drawList->AddRectFilled(sheetP1, sheetP2, IM_COL32(60, 60, 60, 255));
     area.drawList->AddRect(sheetP1, sheetP2, IM_COL32(100, 100, 100, 255), 0.0f, 0, 2.0f);
 
@@ -648,7 +662,7 @@ void CutOptimizerPanel::renderVisualization() {
     {
         ImU32 grainColor = IM_COL32(80, 75, 65, 80);
         float spacing = 12.0f;
-        if (m_sheet.grainHorizontal) {
+        if (sheet.grainHorizontal) {
             for (float gy = sheetP1.y + spacing; gy < sheetP2.y; gy += spacing)
                 area.drawList->AddLine(ImVec2(sheetP1.x, gy), ImVec2(sheetP2.x, gy), grainColor);
         } else {
@@ -789,7 +803,12 @@ void CutOptimizerPanel::renderResultsPanel() {
         ImGui::TextDisabled("Efficiency - %s", grp.materialName.c_str());
 
         ImGui::Spacing();
-        ImGui::Text("Stock: %s", grp.usedSheet.name.c_str());
+        if (grp.mixedStock()) {
+            const auto& tail = grp.sheetStock.back();
+            ImGui::Text("Stock: %s + %s", grp.usedSheet.name.c_str(), tail.name.c_str());
+        } else {
+            ImGui::Text("Stock: %s", grp.usedSheet.name.c_str());
+        }
         ImGui::Text("Sheets: %d", grp.plan.sheetsUsed);
         ImGui::Text("Cost: $%.2f", static_cast<double>(grp.plan.totalCost));
 
@@ -897,32 +916,49 @@ void CutOptimizerPanel::renderResultsPanel() {
             std::vector<CloGroupCostData> groups;
 
             if (m_hasMultiResults) {
-                // Multi-stock: one entry per material group
+                // Multi-stock: one entry per material group and stock size
                 for (const auto& gr : m_multiResult.groups) {
-                    CloGroupCostData data;
-                    data.materialName = gr.materialName;
-
-                    // Format dimensions from usedSheet
-                    char dimBuf[64];
-                    std::snprintf(dimBuf, sizeof(dimBuf), "%.0fx%.0fmm",
-                                  static_cast<double>(gr.usedSheet.width),
-                                  static_cast<double>(gr.usedSheet.height));
-                    data.dimensions = dimBuf;
-
-                    data.sheetsUsed = gr.plan.sheetsUsed;
-                    data.costPerSheet = static_cast<f64>(gr.usedSheet.cost);
-                    data.totalCost = data.costPerSheet * data.sheetsUsed;
-
-                    // Look up StockSize DB ID from m_stockSizes by matching dimensions
-                    for (const auto& ss : m_stockSizes) {
-                        if (std::abs(static_cast<f32>(ss.widthMm) - gr.usedSheet.width) < 1.0f &&
-                            std::abs(static_cast<f32>(ss.heightMm) - gr.usedSheet.height) < 1.0f) {
-                            data.stockSizeDbId = ss.id;
-                            break;
+                    // Mixed-stock groups cut their last sheets from a second size
+                    std::vector<std::pair<optimizer::Sheet, int>> stockRuns;
+                    if (gr.mixedStock()) {
+                        for (const auto& stock : gr.sheetStock) {
+                            if (stockRuns.empty() || stockRuns.back().first.width != stock.width ||
+                                stockRuns.back().first.height != stock.height ||
+                                stockRuns.back().first.cost != stock.cost) {
+                                stockRuns.emplace_back(stock, 0);
+                            }
+                            ++stockRuns.back().second;
                         }
+                    } else {
+                        stockRuns.emplace_back(gr.usedSheet, gr.plan.sheetsUsed);
                     }
 
-                    groups.push_back(std::move(data));
+                    for (const auto& [stock, sheetsUsed] : stockRuns) {
+                        CloGroupCostData data;
+                        data.materialName = gr.materialName;
+
+                        // Format dimensions from the stock sheet
+                        char dimBuf[64];
+                        std::snprintf(dimBuf, sizeof(dimBuf), "%.0fx%.0fmm",
+                                      static_cast<double>(stock.width),
+                                      static_cast<double>(stock.height));
+                        data.dimensions = dimBuf;
+
+                        data.sheetsUsed = sheetsUsed;
+                        data.costPerSheet = static_cast<f64>(stock.cost);
+                        data.totalCost = data.costPerSheet * data.sheetsUsed;
+
+                        // Look up StockSize DB ID from m_stockSizes by matching dimensions
+                        for (const auto& ss : m_stockSizes) {
+                            if (std::abs(static_cast<f32>(ss.widthMm) - stock.width) < 1.0f &&
+                                std::abs(static_cast<f32>(ss.heightMm) - stock.height) < 1.0f) {
+                                data.stockSizeDbId = ss.id;
+                                break;
+                            }
+                        }
+
+                        groups.push_back(std::move(data));
+                    }
                 }
             } else if (m_hasResults) {
                 // Single-sheet mode: one entry
@@ -88,6 +88,10 @@ class CutOptimizerPanel : public Panel {
     void runOptimization();
     void refreshMaterials();
 
+    // Stock the selected result sheet was cut from; differs from m_sheet only
+    // in a multi-stock group that mixes stock sizes
+    const optimizer::Sheet& selectedSheetStock() const;
+
     // Input data
     std::vector<optimizer::Part> m_parts;
     optimizer::Sheet m_sheet{2440.0f, 1220.0f}; // Standard 4x8 sheet
@@ -285,6 +285,7 @@ void DirectCarvePanel::renderNavButtons() {
         m_safeZConfirmed = false;
         m_finishingToolSelected = false;
         m_materialSelected = false;
+        if (m_carveJob) m_carveJob->cancelToolpath();
         m_toolpathGenerated = false;
         m_settingsVersion = 0;
         m_generatedAtVersion = -1;
@@ -733,8 +734,7 @@ void DirectCarvePanel::renderToolSelect() {
         if (m_carveJob && m_carveJob->state() == carve::CarveJobState::Ready
             && m_toolDb && !m_recommendationRun) {
             // Analyze heightmap for islands using selected finishing tool angle
-            f32 toolAngle = static_cast<f32>(m_finishTool.included_angle);
-            if (toolAngle <= 0.0f) toolAngle = 90.0f;
+            f32 toolAngle = finishToolAngle();
             m_carveJob->analyzeHeightmap(toolAngle);
 
             // Populate recommender with toolbox tools
@@ -1129,6 +1129,14 @@ void DirectCarvePanel::renderMaterialSetup() {
                           "Lower = more detail, more G-code lines.\n"
                           "Heightmap resolution: %.2f mm", hmRes);
 
+    ImGui::SetNextItemWidth(iw);
+    if (ImGui::SliderFloat("Tolerance (mm)", &m_toolpathConfig.toleranceMm, 0.0f, 0.1f, "%.3f"))
+        ++m_settingsVersion;
+    if (ImGui::IsItemHovered())
+        ImGui::SetTooltip("Drop scan points that stay within this distance\n"
+                          "of a straight move. Tighter near sharp curvature.\n"
+                          "0 = keep every point.");
+
     ImGui::Spacing();
     ImGui::SeparatorText("Scan Pattern");
 
@@ -1206,7 +1214,7 @@ void DirectCarvePanel::renderPreview() {
         if (!loaded && !m_hmFileMissing) {
             carve::HeightmapConfig hmCfg;
             m_carveJob->startHeightmap(m_vertices, m_indices, m_fitter,
-                                        m_fitParams, hmCfg);
+                                        m_fitParams, hmCfg, finishToolAngle());
             hmComputing = true;
         }
 
@@ -1259,7 +1267,7 @@ void DirectCarvePanel::renderPreview() {
                 m_fitter.setStock(m_stock);
                 carve::HeightmapConfig hmCfg;
                 m_carveJob->startHeightmap(m_vertices, m_indices, m_fitter,
-                                            m_fitParams, hmCfg);
+                                            m_fitParams, hmCfg, finishToolAngle());
                 ImGui::CloseCurrentPopup();
             }
             ImGui::SameLine();
@@ -1276,13 +1284,25 @@ void DirectCarvePanel::renderPreview() {
         if (hmComputing) {
             ImGui::TextColored(kYellow, "1. Computing heightmap...");
             CenteredProgressBar(m_carveJob->progress(), ImVec2(-1, 0), "Computing heightmap...");
+
+            // Coarse analysis preview, sharpened as full-resolution tiles land
+            pollCoarsePreview();
+            if (m_hmPreviewCoarse && m_hmPreviewTex != 0 && m_hmPreviewW > 0) {
+                ImGui::TextDisabled("Preview %.0f%% refined: %d island(s)",
+                                    static_cast<f64>(m_hmPreviewRefined) * 100.0,
+                                    m_hmPreviewIslands);
+                f32 availW = ImGui::GetContentRegionAvail().x;
+                f32 aspect = static_cast<f32>(m_hmPreviewH) / static_cast<f32>(m_hmPreviewW);
+                ImGui::Image(static_cast<ImTextureID>(static_cast<uintptr_t>(m_hmPreviewTex)),
+                             ImVec2(availW, availW * aspect));
+            }
         } else if (jobState == carve::CarveJobState::Error) {
             ImGui::TextColored(kRed, "1. Heightmap error: %s", m_carveJob->errorMessage().c_str());
             if (ImGui::Button("Retry", ImVec2(bw, 0))) {
                 m_fitter.setStock(m_stock);
                 carve::HeightmapConfig hmCfg;
                 m_carveJob->startHeightmap(m_vertices, m_indices, m_fitter,
-                                            m_fitParams, hmCfg);
+                                            m_fitParams, hmCfg, finishToolAngle());
             }
         } else if (hmReady) {
             // Auto-save after first computation
@@ -1292,7 +1312,7 @@ void DirectCarvePanel::renderPreview() {
             }
 
             // Upload preview texture once when heightmap becomes ready
-            if (m_hmPreviewTex == 0)
+            if (m_hmPreviewTex == 0 || m_hmPreviewCoarse)
                 uploadHeightmapPreview();
 
             const auto& hm = m_carveJob->heightmap();
@@ -1331,7 +1351,7 @@ void DirectCarvePanel::renderPreview() {
                     m_fitter.setStock(m_stock);
                     carve::HeightmapConfig hmCfg;
                     m_carveJob->startHeightmap(m_vertices, m_indices, m_fitter,
-                                                m_fitParams, hmCfg);
+                                                m_fitParams, hmCfg, finishToolAngle());
                     ImGui::CloseCurrentPopup();
                 }
                 ImGui::SameLine();
@@ -1345,12 +1365,20 @@ void DirectCarvePanel::renderPreview() {
 
     // Step 2: Toolpath (only after heightmap)
     ImGui::Spacing();
+    if (m_carveJob->collectToolpath()) {
+        m_toolpathGenerated = true;
+        m_generatedAtVersion = m_toolpathRequestedVersion;
+    }
+    const bool toolpathBusy = m_carveJob->toolpathBusy();
     bool toolpathStale = m_toolpathGenerated
                          && (m_generatedAtVersion != m_settingsVersion);
     {
         ImVec4 tpColor = kDimmed;
         const char* tpLabel = "2. Toolpath: Not generated";
-        if (m_toolpathGenerated && !toolpathStale) {
+        if (toolpathBusy) {
+            tpColor = kYellow;
+            tpLabel = "2. Toolpath: Generating...";
+        } else if (m_toolpathGenerated && !toolpathStale) {
             tpColor = kGreen;
             tpLabel = "2. Toolpath: Generated";
         } else if (m_toolpathGenerated && toolpathStale) {
@@ -1361,20 +1389,23 @@ void DirectCarvePanel::renderPreview() {
         }
         ImGui::TextColored(tpColor, "%s", tpLabel);
 
-        if (hmReady && (!m_toolpathGenerated || toolpathStale)) {
+        if (toolpathBusy) {
+            CenteredProgressBar(m_carveJob->toolpathProgress(), ImVec2(-1, 0),
+                                "Generating toolpath...");
+            if (ImGui::Button("Cancel##toolpath", ImVec2(bw, 0)))
+                m_carveJob->cancelToolpath();
+        } else if (hmReady && (!m_toolpathGenerated || toolpathStale)) {
             const char* btnLabel = toolpathStale
                 ? "Regenerate Toolpath" : "Generate Toolpath";
             if (ImGui::Button(btnLabel, ImVec2(bw, 0))) {
-                f32 toolAngle = static_cast<f32>(m_finishTool.included_angle);
-                if (toolAngle <= 0.0f) toolAngle = 90.0f;
+                f32 toolAngle = finishToolAngle();
                 if (!m_recommendationRun)
                     m_carveJob->analyzeHeightmap(toolAngle);
 
                 const VtdbToolGeometry* clrPtr =
                     m_clearToolSelected ? &m_clearTool : nullptr;
-                m_carveJob->generateToolpath(m_toolpathConfig, m_finishTool, clrPtr);
-                m_toolpathGenerated = true;
-                m_generatedAtVersion = m_settingsVersion;
+                m_carveJob->startToolpath(m_toolpathConfig, m_finishTool, clrPtr);
+                m_toolpathRequestedVersion = m_settingsVersion;
             }
         }
     }
@@ -1431,6 +1462,12 @@ void DirectCarvePanel::renderPreview() {
                 formatTime(tp.finishing.estimatedTimeSec).c_str(),
                 static_cast<double>(tp.finishing.totalDistanceMm));
     ImGui::TextDisabled("  G-code lines: %d", tp.finishing.lineCount);
+    if (tp.finishing.cutPointCount < tp.finishing.sampledPointCount) {
+        const int dropped = tp.finishing.sampledPointCount - tp.finishing.cutPointCount;
+        ImGui::TextDisabled("  Points: %d of %d (%.0f%% fewer than uniform)",
+                            tp.finishing.cutPointCount, tp.finishing.sampledPointCount,
+                            100.0 * dropped / tp.finishing.sampledPointCount);
+    }
     if (!tp.clearing.points.empty()) {
         ImGui::Text("Clearing:  %d scan passes, %s, %.0f mm",
                     tp.clearing.scanLineCount,
@@ -2139,6 +2176,35 @@ void DirectCarvePanel::uploadHeightmapPreview() {
         }
     }
 
+    uploadPreviewTexture(pixels, w, h);
+    m_hmPreviewCoarse = false;
+}
+
+void DirectCarvePanel::pollCoarsePreview() {
+    // Preview updates arrive per tile; re-uploading every frame buys nothing
+    constexpr f64 kPollIntervalSec = 0.1;
+    const f64 now = ImGui::GetTime();
+    if (!m_carveJob || now - m_hmPreviewPolledAt < kPollIntervalSec)
+        return;
+    m_hmPreviewPolledAt = now;
+
+    carve::CarveJob::Preview preview;
+    if (!m_carveJob->previewSince(m_hmPreviewRevision, preview))
+        return;
+    m_hmPreviewRevision = preview.revision;
+
+    const auto& hm = preview.heightmap;
+    auto pixels = carve::generateAnalysisOverlay(hm, preview.islands, preview.curvature,
+                                                 hm.cols(), hm.rows());
+    if (pixels.empty())
+        return;
+    uploadPreviewTexture(pixels, hm.cols(), hm.rows());
+    m_hmPreviewCoarse = true;
+    m_hmPreviewRefined = preview.refined;
+    m_hmPreviewIslands = static_cast<int>(preview.islands.islands.size());
+}
+
+void DirectCarvePanel::uploadPreviewTexture(const std::vector<u8>& rgba, int w, int h) {
     if (m_hmPreviewTex == 0)
         glGenTextures(1, &m_hmPreviewTex);
 
@@ -2146,13 +2212,18 @@ void DirectCarvePanel::uploadHeightmapPreview() {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, w, h, 0,
-                 GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+                 GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
     glBindTexture(GL_TEXTURE_2D, 0);
 
     m_hmPreviewW = w;
     m_hmPreviewH = h;
 }
 
+f32 DirectCarvePanel::finishToolAngle() const {
+    f32 toolAngle = static_cast<f32>(m_finishTool.included_angle);
+    return toolAngle > 0.0f ? toolAngle : 90.0f;
+}
+
 void DirectCarvePanel::saveGCodeToProject() {
     if (!m_projectManager || !m_carveJob) {
         showExportDialog();
@@ -181,12 +181,21 @@ class DirectCarvePanel : public Panel {
     u32 m_hmPreviewTex = 0;
     int m_hmPreviewW = 0;
     int m_hmPreviewH = 0;
+    bool m_hmPreviewCoarse = false;   // Texture shows the in-progress preview
+    u32 m_hmPreviewRevision = 0;      // Last CarveJob preview revision uploaded
+    f64 m_hmPreviewPolledAt = 0.0;    // ImGui time of the last preview poll
+    f32 m_hmPreviewRefined = 0.0f;
+    int m_hmPreviewIslands = 0;
     void uploadHeightmapPreview();
+    void pollCoarsePreview();
+    void uploadPreviewTexture(const std::vector<u8>& rgba, int w, int h);
+    f32 finishToolAngle() const;
 
     // Preview state
     bool m_toolpathGenerated = false;
     int m_settingsVersion = 0;       // Bumped when toolpath-affecting settings change
     int m_generatedAtVersion = -1;   // Version when toolpath was last generated
+    int m_toolpathRequestedVersion = -1; // Version of the generation in flight
     f32 m_previewZoom = 1.0f;
     bool m_showFinishing = true;
     bool m_showClearing = true;
@@ -10,9 +10,13 @@
 #include "../../core/database/gcode_repository.h"
 #include "../../core/cnc/cnc_controller.h"
 #include "../../core/cnc/preflight_check.h"
+#include "../../core/gcode/gcode_calibration.h"
 #include "../../core/gcode/gcode_modal_scanner.h"
+#include "../../core/paths/app_paths.h"
 #include "../../core/project/project.h"
 #include "../../core/cnc/serial_port.h"
+#include "../../core/threading/main_thread_queue.h"
+#include "../../core/threading/thread_pool.h"
 #include "../../core/utils/file_utils.h"
 #include "../dialogs/file_dialog.h"
 #include "../icons.h"
@@ -56,12 +60,75 @@ struct LongPressButton {
 };
 
 static LongPressButton s_startLongPress;
+
+// Lines as they are streamed: blanks and comments dropped, inline comments
+// stripped. Telemetry line acks index into this list.
+std::vector<std::string> extractStreamLines(const gcode::Program& program) {
+    std::vector<std::string> lines;
+    for (const auto& cmd : program.commands) {
+        std::string cmdLine = cmd.raw;
+        // Strip whitespace
+        while (!cmdLine.empty() &&
+               (cmdLine.back() == ' ' || cmdLine.back() == '\r'))
+            cmdLine.pop_back();
+        if (cmdLine.empty() ||
+            cmdLine.front() == ';' || cmdLine.front() == '(')
+            continue;
+        // Strip inline comments
+        auto semi = cmdLine.find(';');
+        if (semi != std::string::npos)
+            cmdLine = cmdLine.substr(0, semi);
+        lines.push_back(cmdLine);
+    }
+    return lines;
+}
+
+Path telemetryPath(i64 jobId) {
+    return paths::getTelemetryDir() / ("job_" + std::to_string(jobId) + ".dwjt");
+}
+
+// Calibration of one history job, or the console message explaining why not
+struct CalibrationOutcome {
+    std::optional<gcode::CalibrationResult> result;
+    std::string error;
+};
+
+// Load, parse and fit; touches no panel state so it can run on a worker
+CalibrationOutcome runCalibration(i64 jobId, const std::string& filePath, const std::string& fileName,
+                                  const gcode::MachineProfile& profile) {
+    CalibrationOutcome outcome;
+    auto telemetry = JobTelemetry::load(telemetryPath(jobId).string());
+    auto content = file::readText(filePath);
+    if (!telemetry || !content) {
+        outcome.error = "Calibration: cannot read telemetry or " + filePath;
+        return outcome;
+    }
+
+    gcode::Parser parser;
+    auto lines = extractStreamLines(parser.parse(*content));
+    if (static_cast<int>(lines.size()) != telemetry->totalLines ||
+        JobTelemetry::hashLines(lines) != telemetry->linesHash) {
+        outcome.error = "Calibration: " + fileName + " changed since it was run";
+        return outcome;
+    }
+
+    outcome.result = gcode::calibrateFromTelemetry(*telemetry, lines, profile);
+    if (!outcome.result->valid)
+        outcome.error = "Calibration: not enough running samples in " + fileName;
+    return outcome;
+}
 } // namespace
 
 GCodePanel::GCodePanel() : Panel("G-code") {
     m_availablePorts = listSerialPorts();
 }
 
+GCodePanel::~GCodePanel() {
+    // Expire m_alive first so a finished calibration's callback becomes a no-op
+    m_alive.reset();
+    m_calibrationPool.reset();
+}
+
 void GCodePanel::render() {
     if (!m_open)
         return;
@@ -154,9 +221,10 @@ void GCodePanel::render() {
                             const auto& cmd = m_program.commands[static_cast<size_t>(i)];
                             bool isAcked = m_cncConnected && i <= m_lastAckedLine;
                             if (isAcked) {
-                                ImGui::TextColored(ImVec4(0.3f, 0.8f, 0.3f, 1.0f), "%6d  %s", i + 1, cmd.raw.c_str());
+                                ImGui::TextColored(ImVec4(0.3f, 0.8f, 0.3f, 1.0f), "%6d  %s",
+                                                   cmd.lineNumber, cmd.raw.c_str());
                             } else {
-                                ImGui::Text("%6d  %s", i + 1, cmd.raw.c_str());
+                                ImGui::Text("%6d  %s", cmd.lineNumber, cmd.raw.c_str());
                             }
                         }
                     }
@@ -192,9 +260,10 @@ void GCodePanel::render() {
                             const auto& cmd = m_program.commands[static_cast<size_t>(i)];
                             bool isAcked = m_cncConnected && i <= m_lastAckedLine;
                             if (isAcked) {
-                                ImGui::TextColored(ImVec4(0.3f, 0.8f, 0.3f, 1.0f), "%6d  %s", i + 1, cmd.raw.c_str());
+                                ImGui::TextColored(ImVec4(0.3f, 0.8f, 0.3f, 1.0f), "%6d  %s",
+                                                   cmd.lineNumber, cmd.raw.c_str());
                             } else {
-                                ImGui::Text("%6d  %s", i + 1, cmd.raw.c_str());
+                                ImGui::Text("%6d  %s", cmd.lineNumber, cmd.raw.c_str());
                             }
                         }
                     }
@@ -713,6 +782,7 @@ void GCodePanel::renderPlaybackControls() {
                     m_cnc->feedHold(); // Real-time byte, takes effect immediately
                 }
                 m_cnc->stopStream();
+                m_cnc->telemetry().end();
             }
         }
     }
@@ -881,6 +951,8 @@ void GCodePanel::onGrblConnected(bool connected, const std::string& version) {
         addConsoleLine("Connection failed — no compatible controller detected", ConsoleLine::Error);
     } else {
         addConsoleLine("Disconnected", ConsoleLine::Info);
+        if (m_cnc)
+            m_cnc->telemetry().end();
         // Finalize active job as aborted on disconnect
         if (m_jobRepo && m_activeJobId > 0) {
             auto modal = GCodeModalScanner::scanToLine(getRawLines(), m_streamProgress.ackedLines);
@@ -917,6 +989,9 @@ void GCodePanel::onGrblProgress(const StreamProgress& progress) {
     // Check completion
     if (progress.ackedLines >= progress.totalLines && progress.totalLines > 0) {
         addConsoleLine("Stream complete", ConsoleLine::Info);
+        // The planner still holds the last moves; keep sampling until Idle
+        if (m_cnc)
+            m_cnc->telemetry().endWhenIdle();
 
         // Finalize job record
         if (m_jobRepo && m_activeJobId > 0) {
@@ -946,6 +1021,8 @@ void GCodePanel::onGrblProgress(const StreamProgress& progress) {
 void GCodePanel::onGrblAlarm(int code, const std::string& desc) {
     addConsoleLine("ALARM:" + std::to_string(code) + " " + desc, ConsoleLine::Error);
     ToastManager::instance().show(ToastType::Error, "Alarm", desc);
+    if (m_cnc)
+        m_cnc->telemetry().end();
 
     // Finalize active job as aborted
     if (m_jobRepo && m_activeJobId > 0) {
@@ -1016,22 +1093,7 @@ void GCodePanel::buildSendProgram() {
     }
 
     // Extract raw command lines, skip blanks and comments
-    std::vector<std::string> lines;
-    for (const auto& cmd : m_program.commands) {
-        std::string cmdLine = cmd.raw;
-        // Strip whitespace
-        while (!cmdLine.empty() &&
-               (cmdLine.back() == ' ' || cmdLine.back() == '\r'))
-            cmdLine.pop_back();
-        if (cmdLine.empty() ||
-            cmdLine.front() == ';' || cmdLine.front() == '(')
-            continue;
-        // Strip inline comments
-        auto semi = cmdLine.find(';');
-        if (semi != std::string::npos)
-            cmdLine = cmdLine.substr(0, semi);
-        lines.push_back(cmdLine);
-    }
+    std::vector<std::string> lines = extractStreamLines(m_program);
 
     m_lastAckedLine = -1;
     m_streamProgress = {};
@@ -1046,6 +1108,11 @@ void GCodePanel::buildSendProgram() {
         auto id = m_jobRepo->insert(job);
         m_activeJobId = id.value_or(-1);
         m_jobHistoryDirty = true;
+
+        // Status samples and ack times for profile calibration
+        if (m_activeJobId > 0)
+            m_cnc->telemetry().begin(telemetryPath(m_activeJobId).string(), job.totalLines,
+                                     JobTelemetry::hashLines(lines));
     }
 
     m_cnc->startStream(lines);
@@ -1091,9 +1158,10 @@ void GCodePanel::renderSearchBar() {
         m_searchResultLine = -1;
     }
 
-    if (m_searchResultLine >= 0) {
+    if (m_searchResultLine >= 0 && m_searchResultLine < static_cast<int>(m_program.commands.size())) {
         ImGui::SameLine();
-        ImGui::TextDisabled("Match at line %d", m_searchResultLine + 1);
+        ImGui::TextDisabled("Match at line %d",
+                            m_program.commands[static_cast<size_t>(m_searchResultLine)].lineNumber);
     }
 }
 
@@ -1123,11 +1191,13 @@ void GCodePanel::findNext() {
 }
 
 void GCodePanel::gotoLineNumber(int lineNum) {
-    auto lines = getRawLines();
-    int idx = lineNum - 1;
-    if (idx >= 0 && idx < static_cast<int>(lines.size())) {
-        m_scrollToLine = idx;
-        m_searchResultLine = idx;
+    // Lands on the next command when the line itself is blank or a comment
+    if (lineNum < 1)
+        return;
+    usize idx = m_program.commandIndexAtLine(lineNum);
+    if (idx < m_program.commands.size()) {
+        m_scrollToLine = static_cast<int>(idx);
+        m_searchResultLine = static_cast<int>(idx);
     }
 }
 
@@ -1147,7 +1217,14 @@ void GCodePanel::renderJobHistory() {
     ImGui::Text("Job History");
     ImGui::SameLine();
     if (ImGui::SmallButton("Clear All")) {
+        // The running job keeps its log; it is still being written
+        const Path activeLog = m_activeJobId > 0 ? telemetryPath(m_activeJobId) : Path();
+        for (const auto& telemetryLog : file::listFiles(paths::getTelemetryDir(), "dwjt")) {
+            if (telemetryLog != activeLog)
+                (void)file::remove(telemetryLog);
+        }
         m_jobRepo->clearAll();
+        m_calibration.reset();
         m_jobHistoryDirty = true;
     }
     ImGui::SameLine();
@@ -1169,12 +1246,13 @@ void GCodePanel::renderJobHistory() {
             float colLines = ImGui::CalcTextSize("00000/00000").x;
             float colDur = ImGui::CalcTextSize("00:00:00").x;
             float colDate = ImGui::CalcTextSize("2026-02-28 12:00").x;
+            float colActions = ImGui::CalcTextSize("Calibrate X__").x;
             ImGui::TableSetupColumn("Status", ImGuiTableColumnFlags_WidthFixed, colStatus);
             ImGui::TableSetupColumn("File", ImGuiTableColumnFlags_WidthStretch);
             ImGui::TableSetupColumn("Lines", ImGuiTableColumnFlags_WidthFixed, colLines);
             ImGui::TableSetupColumn("Duration", ImGuiTableColumnFlags_WidthFixed, colDur);
             ImGui::TableSetupColumn("Date", ImGuiTableColumnFlags_WidthFixed, colDate);
-            ImGui::TableSetupColumn("##Actions", ImGuiTableColumnFlags_WidthFixed, colStatus);
+            ImGui::TableSetupColumn("##Actions", ImGuiTableColumnFlags_WidthFixed, colActions);
             ImGui::TableHeadersRow();
 
             i64 removeId = -1;
@@ -1237,6 +1315,14 @@ void GCodePanel::renderJobHistory() {
                     if (ImGui::IsItemHovered())
                         ImGui::SetTooltip("Load file for resume from line %d", job.lastAckedLine);
                 }
+                if (job.status == "completed" && file::exists(telemetryPath(job.id))) {
+                    ImGui::BeginDisabled(m_calibrating);
+                    if (ImGui::SmallButton("Calibrate"))
+                        calibrateJob(job);
+                    ImGui::EndDisabled();
+                    if (ImGui::IsItemHovered())
+                        ImGui::SetTooltip("Compare this run with the time estimate and fit the machine profile");
+                }
                 ImGui::SameLine();
                 if (ImGui::SmallButton("X"))
                     removeId = job.id;
@@ -1247,13 +1333,99 @@ void GCodePanel::renderJobHistory() {
             ImGui::EndTable();
 
             if (removeId > 0) {
+                if (removeId != m_activeJobId)
+                    (void)file::remove(telemetryPath(removeId));
                 m_jobRepo->remove(removeId);
                 m_jobHistoryDirty = true;
             }
         }
     }
     ImGui::EndChild();
+    renderCalibration();
     ImGui::Separator();
 }
 
+void GCodePanel::calibrateJob(const JobRecord& job) {
+    m_calibration.reset();
+    m_calibrationFile = job.fileName;
+    const auto profile = Config::instance().getActiveMachineProfile();
+
+    // No queue wired (e.g. tests): calibrate inline
+    if (!m_mainThreadQueue) {
+        auto outcome = runCalibration(job.id, job.filePath, job.fileName, profile);
+        m_calibration = std::move(outcome.result);
+        if (!outcome.error.empty())
+            addConsoleLine(outcome.error, ConsoleLine::Error);
+        return;
+    }
+
+    if (!m_calibrationPool)
+        m_calibrationPool = std::make_unique<ThreadPool>(1);
+
+    m_calibrating = true;
+    auto* mtq = m_mainThreadQueue;
+    std::weak_ptr<bool> alive = m_alive;
+    m_calibrationPool->enqueue(
+        [this, mtq, alive, profile, jobId = job.id, filePath = job.filePath, fileName = job.fileName]() {
+            if (alive.expired())
+                return; // Panel closing
+            auto outcome = runCalibration(jobId, filePath, fileName, profile);
+            mtq->enqueue([this, alive, outcome = std::move(outcome)]() mutable {
+                if (alive.expired())
+                    return;
+                m_calibrating = false;
+                m_calibration = std::move(outcome.result);
+                if (!outcome.error.empty())
+                    addConsoleLine(outcome.error, ConsoleLine::Error);
+            });
+        });
+}
+
+void GCodePanel::renderCalibration() {
+    if (!m_calibration || !m_calibration->valid)
+        return;
+    const auto& result = *m_calibration;
+
+    ImGui::Text("Calibration: %s", m_calibrationFile.c_str());
+    ImGui::SameLine();
+    if (ImGui::SmallButton("X##CloseCalibration")) {
+        m_calibration.reset();
+        return;
+    }
+
+    ImGui::Indent();
+    auto percent = [](f64 value, f64 reference) {
+        return reference > 0.0 ? (value / reference - 1.0) * 100.0 : 0.0;
+    };
+    ImGui::Text("Measured %.1f s over %zu samples", result.measuredSeconds, result.intervalsUsed);
+    ImGui::Text("Estimated %.1f s (%+.1f%%), calibrated %.1f s (%+.1f%%)", result.estimatedSeconds,
+                percent(result.estimatedSeconds, result.measuredSeconds), result.calibratedSeconds,
+                percent(result.calibratedSeconds, result.measuredSeconds));
+    ImGui::Text("Program estimate %.1f min -> %.1f min", result.programEstimateSeconds / 60.0,
+                result.calibratedProgramSeconds / 60.0);
+    ImGui::Text("Acceleration x%.2f, max rates x%.2f", static_cast<f64>(result.accelScale),
+                static_cast<f64>(result.rateScale));
+
+    if (ImGui::SmallButton("Apply to Profile")) {
+        auto& config = Config::instance();
+        const int activeIdx = config.getActiveMachineProfileIndex();
+        gcode::MachineProfile profile = result.profile;
+        if (profile.builtIn) {
+            profile.name += " (Calibrated)";
+            profile.builtIn = false;
+            config.addMachineProfile(profile);
+            config.setActiveMachineProfileIndex(static_cast<int>(config.getMachineProfiles().size()) - 1);
+        } else {
+            config.updateMachineProfile(activeIdx, profile);
+        }
+        config.save();
+        reanalyze();
+        addConsoleLine("Machine profile calibrated: " + profile.name, ConsoleLine::Info);
+        m_calibration.reset();
+    }
+    if (ImGui::IsItemHovered())
+        ImGui::SetTooltip("Scale the active profile's acceleration and max rates by the fitted values");
+    ImGui::Unindent();
+}
+
 } // namespace dw
@@ -3,10 +3,12 @@
 #include <deque>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
 #include "../../core/gcode/gcode_analyzer.h"
+#include "../../core/gcode/gcode_calibration.h"
 #include "../../core/gcode/gcode_parser.h"
 #include "../../core/gcode/machine_profile.h"
 #include "../../core/cnc/cnc_types.h"
@@ -18,8 +20,10 @@ namespace dw {
 
 class FileDialog;
 class GCodeRepository;
+class MainThreadQueue;
 class ProjectManager;
 class CncController;
+class ThreadPool;
 class ToolDatabase;
 
 // Panel mode — View (text listing), Send (real CNC)
@@ -35,7 +39,7 @@ struct ConsoleLine {
 class GCodePanel : public Panel {
   public:
     GCodePanel();
-    ~GCodePanel() override = default;
+    ~GCodePanel() override;
 
     void render() override;
 
@@ -46,6 +50,7 @@ class GCodePanel : public Panel {
     void setCncController(CncController* ctrl) { m_cnc = ctrl; }
     void setJobRepository(JobRepository* repo) { m_jobRepo = repo; }
     void setToolDatabase(ToolDatabase* db) { m_toolDatabase = db; }
+    void setMainThreadQueue(MainThreadQueue* queue) { m_mainThreadQueue = queue; }
 
     // Callback notifications for program load/clear
     void setOnProgramLoaded(std::function<void(const gcode::Program&)> cb) { m_onProgramLoaded = std::move(cb); }
@@ -59,6 +64,9 @@ class GCodePanel : public Panel {
     // Get raw G-code lines for resume-from-line feature
     std::vector<std::string> getRawLines() const;
 
+    // Scroll the listing to a 1-based source line and highlight it
+    void showLine(int lineNumber) { gotoLineNumber(lineNumber); }
+
     // Get toolpath bounds (from analyzed statistics)
     Vec3 boundsMin() const { return m_stats.boundsMin; }
     Vec3 boundsMax() const { return m_stats.boundsMax; }
@@ -92,6 +100,11 @@ class GCodePanel : public Panel {
     void renderFeedOverride();
     void renderConsole();
     void renderJobHistory();
+    void renderCalibration();
+
+    // Fit the active machine profile to a completed job's telemetry, on a
+    // worker thread when a MainThreadQueue is wired
+    void calibrateJob(const JobRecord& job);
 
     // Re-run analyzer with current profile
     void reanalyze();
@@ -123,6 +136,14 @@ class GCodePanel : public Panel {
     std::vector<JobRecord> m_jobHistoryCache;
     bool m_jobHistoryDirty = true;
 
+    // Telemetry calibration of a job picked from history
+    std::optional<gcode::CalibrationResult> m_calibration;
+    std::string m_calibrationFile;
+    bool m_calibrating = false;
+    MainThreadQueue* m_mainThreadQueue = nullptr;
+    std::unique_ptr<ThreadPool> m_calibrationPool;                // Lazily created
+    std::shared_ptr<bool> m_alive = std::make_shared<bool>(true); // Guards queued callbacks
+
     // Mode
     GCodePanelMode m_mode = GCodePanelMode::View;
 
@@ -1,10 +1,10 @@
 #include "library_panel.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cstdint>
 #include <cstring>
 #include <filesystem>
-#include <fstream>
 #include <vector>
 
 #include <imgui.h>
@@ -12,6 +12,8 @@
 #include "../../core/config/config.h"
 #include "../../core/loaders/texture_loader.h"
 #include "../../core/paths/app_paths.h"
+#include "../../core/threading/main_thread_queue.h"
+#include "../../core/threading/thread_pool.h"
 #include "../../core/utils/file_utils.h"
 #include "../../core/utils/log.h"
 #include "../context_menu_manager.h"
@@ -26,6 +28,9 @@ LibraryPanel::LibraryPanel(LibraryManager* library) : Panel("Library"), m_librar
 }
 
 LibraryPanel::~LibraryPanel() {
+    // Expire m_alive first so workers skip queued decodes and callbacks become no-ops
+    m_alive.reset();
+    m_thumbnailPool.reset();
     clearTextureCache();
     if (m_placeholderTexture != 0) {
         glDeleteTextures(1, &m_placeholderTexture);
@@ -65,62 +70,20 @@ void LibraryPanel::setContextMenuManager(ContextMenuManager* mgr) {
 }
 
 void LibraryPanel::clearTextureCache() {
-    for (auto& [id, tex] : m_textureCache) {
-        if (tex != 0) {
-            glDeleteTextures(1, &tex);
-        }
-    }
-    m_textureCache.clear();
+    releaseTextures(m_textureCache.clear());
+    m_pendingUploads.clear();
+    m_thumbnailsInFlight.clear();
 }
 
-GLuint LibraryPanel::loadTGATexture(const Path& path) {
-    std::ifstream file(path, std::ios::binary);
-    if (!file) {
-        log::warningf("Library", "Failed to open TGA file: %s", path.string().c_str());
-        return 0;
-    }
-
-    // Read 18-byte TGA header
-    uint8_t header[18];
-    file.read(reinterpret_cast<char*>(header), 18);
-    if (!file) {
-        log::warningf("Library", "Failed to read TGA header: %s", path.string().c_str());
-        return 0;
-    }
-
-    // Validate: uncompressed true-color (type 2), 32bpp
-    if (header[2] != 2 || header[16] != 32) {
-        log::warningf("Library",
-                      "Unsupported TGA format (type=%d, bpp=%d): %s",
-                      header[2],
-                      header[16],
-                      path.string().c_str());
-        return 0;
-    }
-
-    int width = header[12] | (header[13] << 8);
-    int height = header[14] | (header[15] << 8);
-    if (width <= 0 || height <= 0 || width > 4096 || height > 4096) {
-        log::warningf(
-            "Library", "Invalid TGA dimensions (%dx%d): %s", width, height, path.string().c_str());
-        return 0;
-    }
-
-    // Read BGRA pixel data
-    size_t dataSize = static_cast<size_t>(width) * height * 4;
-    std::vector<uint8_t> bgra(dataSize);
-    file.read(reinterpret_cast<char*>(bgra.data()), static_cast<std::streamsize>(dataSize));
-    if (!file) {
-        log::warningf("Library", "Failed to read TGA pixel data: %s", path.string().c_str());
-        return 0;
-    }
-
-    // Convert BGRA to RGBA in-place
-    for (size_t i = 0; i < dataSize; i += 4) {
-        std::swap(bgra[i + 0], bgra[i + 2]); // swap B and R
+void LibraryPanel::releaseTextures(const std::vector<u32>& handles) {
+    for (u32 handle : handles) {
+        GLuint tex = handle;
+        if (tex != 0)
+            glDeleteTextures(1, &tex);
     }
+}
 
-    // Create OpenGL texture
+GLuint LibraryPanel::uploadThumbnail(const ThumbnailImage& image) {
     GLuint texture = 0;
     glGenTextures(1, &texture);
     if (texture == 0) {
@@ -133,18 +96,141 @@ GLuint LibraryPanel::loadTGATexture(const Path& path) {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexImage2D(
-        GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, bgra.data());
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, image.width, image.height, 0, GL_RGBA,
+                 GL_UNSIGNED_BYTE, image.rgba.data());
     glBindTexture(GL_TEXTURE_2D, 0);
 
     return texture;
 }
 
-GLuint LibraryPanel::getThumbnailTexture(const ModelRecord& model) {
-    // Check cache first
-    auto it = m_textureCache.find(model.id);
-    if (it != m_textureCache.end()) {
-        return it->second;
+namespace {
+
+// Runs on a thumbnail worker: serve from the packed cache, else decode the TGA,
+// build its mip chain and populate the cache for next time.
+// Sets isLargest when the returned image is the full-size level.
+ThumbnailImage loadThumbnailLevel(ThumbnailAtlas* atlas,
+                                  int64_t modelId,
+                                  const Path& tgaPath,
+                                  float displaySize,
+                                  bool& isLargest) {
+    isLargest = true;
+    auto stamp = ThumbnailStamp::fromFile(tgaPath);
+    if (!stamp)
+        return {};
+
+    if (atlas) {
+        auto widths = atlas->levelWidths(modelId, *stamp);
+        if (!widths.empty()) {
+            usize level = thumbnail::selectMipLevel(widths, displaySize);
+            auto img = atlas->load(modelId, *stamp, level);
+            if (img) {
+                isLargest = (level == 0);
+                return std::move(*img);
+            }
+        }
+    }
+
+    auto base = thumbnail::decodeTGA(tgaPath);
+    if (!base)
+        return {};
+
+    auto chain = thumbnail::buildMipChain(std::move(*base));
+    if (atlas)
+        (void)atlas->store(modelId, *stamp, chain);
+
+    std::vector<int> widths;
+    widths.reserve(chain.size());
+    for (const auto& level : chain)
+        widths.push_back(level.width);
+    usize level = thumbnail::selectMipLevel(widths, displaySize);
+    isLargest = (level == 0);
+    return std::move(chain[level]);
+}
+
+} // namespace
+
+void LibraryPanel::requestThumbnail(const ModelSummary& model, float displaySize) {
+    if (m_thumbnailsInFlight.count(model.id) > 0)
+        return;
+
+    if (!m_thumbnailAtlas) {
+        m_thumbnailAtlas = std::make_shared<ThumbnailAtlas>();
+        if (!m_thumbnailAtlas->open(paths::getThumbnailDir() / "thumbnails.dwtc"))
+            log::warning("Library", "Thumbnail cache unavailable; decoding TGAs directly");
+    }
+
+    // No queue wired (e.g. early startup): decode inline like before
+    if (!m_mainThreadQueue) {
+        ThumbnailAtlas* atlas = m_thumbnailAtlas->isOpen() ? m_thumbnailAtlas.get() : nullptr;
+        bool largest = true;
+        auto img = loadThumbnailLevel(atlas, model.id, model.thumbnailPath, displaySize, largest);
+        GLuint tex = img.isValid() ? uploadThumbnail(img) : 0;
+        releaseTextures(m_textureCache.insert(model.id, {tex, img.width, largest}));
+        return;
+    }
+
+    if (!m_thumbnailPool)
+        m_thumbnailPool = std::make_unique<ThreadPool>(2);
+
+    u64 serial = ++m_thumbnailRequestSerial;
+    m_thumbnailsInFlight[model.id] = serial;
+    auto atlasRef = m_thumbnailAtlas;
+    auto* mtq = m_mainThreadQueue;
+    std::weak_ptr<bool> alive = m_alive;
+    int64_t modelId = model.id;
+    Path tgaPath = model.thumbnailPath;
+
+    // atlasRef keeps the cache alive for the worker even if the panel goes away
+    m_thumbnailPool->enqueue([this, atlasRef, mtq, alive, modelId, serial, tgaPath, displaySize]() {
+        if (alive.expired())
+            return; // Panel closing: skip the backlog
+        ThumbnailAtlas* workerAtlas = atlasRef->isOpen() ? atlasRef.get() : nullptr;
+        bool largest = true;
+        auto img = loadThumbnailLevel(workerAtlas, modelId, tgaPath, displaySize, largest);
+        mtq->enqueue([this, alive, modelId, serial, largest, img = std::move(img)]() mutable {
+            if (alive.expired())
+                return;
+            m_pendingUploads.push_back({modelId, serial, std::move(img), largest});
+        }, TaskPriority::Low);
+    });
+}
+
+void LibraryPanel::uploadPendingThumbnails() {
+    if (m_pendingUploads.empty())
+        return;
+
+    auto start = std::chrono::steady_clock::now();
+    int uploaded = 0;
+    while (!m_pendingUploads.empty() && uploaded < MAX_UPLOADS_PER_FRAME) {
+        PendingThumbnail pending = std::move(m_pendingUploads.front());
+        m_pendingUploads.pop_front();
+
+        // Invalidated (or superseded) while in flight: drop the stale result
+        auto it = m_thumbnailsInFlight.find(pending.modelId);
+        if (it == m_thumbnailsInFlight.end() || it->second != pending.serial)
+            continue;
+        m_thumbnailsInFlight.erase(it);
+
+        GLuint tex = pending.image.isValid() ? uploadThumbnail(pending.image) : 0;
+        releaseTextures(
+            m_textureCache.insert(pending.modelId, {tex, pending.image.width, pending.largest}));
+        ++uploaded;
+
+        auto elapsed = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start);
+        if (elapsed.count() >= UPLOAD_BUDGET_MS)
+            break;
+    }
+}
+
+GLuint LibraryPanel::getThumbnailTexture(const ModelSummary& model, float displaySize) {
+    if (const auto* entry = m_textureCache.touch(model.id)) {
+        // Zoomed past the resident mip: fetch a larger level, keep showing this one
+        if (entry->handle != 0 && !entry->largest &&
+            static_cast<float>(entry->width) < displaySize) {
+            requestThumbnail(model, displaySize);
+        }
+        return entry->handle;
     }
 
     // No thumbnail path yet — don't cache so we re-check after generation
@@ -152,10 +238,9 @@ GLuint LibraryPanel::getThumbnailTexture(const ModelRecord& model) {
         return 0;
     }
 
-    // Try to load the TGA file
-    GLuint tex = loadTGATexture(model.thumbnailPath);
-    m_textureCache[model.id] = tex;
-    return tex;
+    requestThumbnail(model, displaySize);
+    const auto* entry = m_textureCache.peek(model.id); // Set when loaded inline
+    return entry ? entry->handle : 0;
 }
 
 void LibraryPanel::render() {
@@ -172,6 +257,9 @@ void LibraryPanel::render() {
         }
     }
 
+    applyModelChanges();
+    uploadPendingThumbnails();
+
     applyMinSize(18, 12);
     if (ImGui::Begin(m_title.c_str(), &m_open)) {
         renderToolbar();
@@ -223,61 +311,16 @@ void LibraryPanel::render() {
     ImGui::End();
 }
 
-GLuint LibraryPanel::getThumbnailTextureForModel(int64_t modelId) const {
-    auto it = m_textureCache.find(modelId);
-    return (it != m_textureCache.end()) ? it->second : 0;
+GLuint LibraryPanel::getThumbnailTextureForModel(int64_t modelId) {
+    const auto* entry = m_textureCache.touch(modelId);
+    return entry ? entry->handle : 0;
 }
 
 void LibraryPanel::invalidateThumbnail(int64_t modelId) {
-    auto it = m_textureCache.find(modelId);
-    if (it != m_textureCache.end()) {
-        if (it->second != 0)
-            glDeleteTextures(1, &it->second);
-        m_textureCache.erase(it);
-    }
-}
-
-void LibraryPanel::refresh() {
-    if (!m_library)
-        return;
-
-    // Refresh category cache
-    m_categories = m_library->getAllCategories();
-
-    // Determine model list based on search + category filter
-    if (!m_searchQuery.empty()) {
-        // FTS5 search with BM25 ranking (falls back to LIKE if FTS unavailable)
-        if (m_useFTS) {
-            m_models = m_library->searchModelsFTS(m_searchQuery);
-        } else {
-            m_models = m_library->searchModels(m_searchQuery);
-        }
-
-        // If also filtering by category, client-side filter the FTS results
-        if (m_selectedCategoryId > 0) {
-            auto categoryModels = m_library->filterByCategory(m_selectedCategoryId);
-            std::set<int64_t> catIds;
-            for (auto& m : categoryModels)
-                catIds.insert(m.id);
-            m_models.erase(std::remove_if(m_models.begin(),
-                                          m_models.end(),
-                                          [&](const ModelRecord& m) {
-                                              return catIds.find(m.id) == catIds.end();
-                                          }),
-                           m_models.end());
-        }
-    } else if (m_selectedCategoryId > 0) {
-        m_models = m_library->filterByCategory(m_selectedCategoryId);
-    } else {
-        m_models = m_library->getAllModels();
-    }
-
-    // G-code files are not affected by category filter
-    if (!m_searchQuery.empty()) {
-        m_gcodeFiles = m_library->searchGCodeFiles(m_searchQuery);
-    } else {
-        m_gcodeFiles = m_library->getAllGCodeFiles();
-    }
+    releaseTextures({m_textureCache.erase(modelId)});
+    m_thumbnailsInFlight.erase(modelId);
+    if (m_thumbnailAtlas)
+        m_thumbnailAtlas->invalidate(modelId);
 }
 
 void LibraryPanel::renderToolbar() {
@@ -563,7 +606,6 @@ void LibraryPanel::renderCategoryAssignDialog() {
                         }
                     }
                 }
-                refresh();
             }
             ImGui::CloseCurrentPopup();
         }
@@ -687,7 +729,6 @@ void LibraryPanel::renderRenameDialog() {
                 if (record) {
                     record->name = newName;
                     if (m_library->updateModel(*record)) {
-                        refresh();
                         ToastManager::instance().show(ToastType::Success,
                                                       "Renamed",
                                                       "Model renamed successfully");
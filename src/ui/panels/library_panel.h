@@ -1,6 +1,8 @@
 #pragma once
 
+#include <deque>
 #include <functional>
+#include <memory>
 #include <optional>
 #include <set>
 #include <string>
@@ -10,12 +12,15 @@
 #include <glad/gl.h>
 
 #include "../../core/library/library_manager.h"
+#include "../../core/library/thumbnail_cache.h"
 #include "panel.h"
 
 namespace dw {
 
 class ContextMenuManager;
+class MainThreadQueue;
 class ProjectManager;
+class ThreadPool;
 
 // Library panel for browsing and managing imported models
 class LibraryPanel : public Panel {
@@ -64,7 +69,9 @@ class LibraryPanel : public Panel {
         m_onGCodeAddToProject = std::move(cb);
     }
 
-    // Refresh the model and G-code lists
+    // Reload the model and G-code lists from the first page.
+    // Library writes made through ModelRepository are picked up automatically each
+    // frame from the ModelChangeFeed; call this only for out-of-band changes.
     void refresh();
 
     // Invalidate cached thumbnail texture for a model (forces reload from disk)
@@ -82,8 +89,13 @@ class LibraryPanel : public Panel {
     const std::set<int64_t>& selectedGCodeIds() const { return m_selectedGCodeIds; }
     bool isModelSelected(int64_t id) const { return m_selectedModelIds.count(id) > 0; }
 
-    // Get cached thumbnail GL texture for a model (0 if not cached)
-    GLuint getThumbnailTextureForModel(int64_t modelId) const;
+    // Get cached thumbnail GL texture for a model (0 if not resident).
+    // Marks the texture as recently used so it is not the next LRU eviction.
+    GLuint getThumbnailTextureForModel(int64_t modelId);
+
+    // Route background thumbnail decodes back to the UI thread.
+    // Without a queue, thumbnails are decoded synchronously on first draw.
+    void setMainThreadQueue(MainThreadQueue* queue) { m_mainThreadQueue = queue; }
 
     // Set context menu manager (must be called before first render)
     void setContextMenuManager(ContextMenuManager* mgr);
@@ -102,23 +114,43 @@ class LibraryPanel : public Panel {
     void renderModelList();
     void renderGCodeList();
     void renderCombinedList();
-    void renderModelItem(const ModelRecord& model, int index, float thumbOverride = 0.0f);
+    void renderModelItem(const ModelSummary& model, int index, float thumbOverride = 0.0f);
     void renderGCodeItem(const GCodeRecord& gcode, int index, float thumbOverride = 0.0f);
     void renderRenameDialog();
     void renderDeleteConfirm();
     void registerContextMenuEntries();
 
-    // Load a TGA file into an OpenGL texture, returns 0 on failure
-    GLuint loadTGATexture(const Path& path);
+    // Get a resident thumbnail texture, requesting a background load if missing
+    GLuint getThumbnailTexture(const ModelSummary& model, float displaySize);
+
+    // Queue a decode of the mip level matching displaySize (packed cache first, then TGA)
+    void requestThumbnail(const ModelSummary& model, float displaySize);
+
+    // Upload decoded thumbnails to GL, bounded per frame to avoid hitches
+    void uploadPendingThumbnails();
+    GLuint uploadThumbnail(const ThumbnailImage& image);
 
-    // Get or load a cached thumbnail texture for a model
-    GLuint getThumbnailTexture(const ModelRecord& model);
+    // Delete GL textures released by the LRU
+    void releaseTextures(const std::vector<u32>& handles);
 
     // Release all cached GL textures
     void clearTextureCache();
 
+    // Filter matching the current search text + category selection
+    ModelPageQuery currentModelQuery() const;
+
+    // Append the next keyset page of models (no-op once the last page is loaded)
+    void loadNextModelPage();
+
+    // Patch m_models in place from ModelChangeFeed entries since the last poll
+    void applyModelChanges();
+
     LibraryManager* m_library;
-    std::vector<ModelRecord> m_models;
+    std::vector<ModelSummary> m_models; // Loaded pages, in query order
+    std::optional<ModelPageCursor> m_nextModelPage;
+    bool m_hasMoreModels = false;
+    u64 m_modelFeedVersion = 0; // Last ModelChangeFeed version reflected in m_models
+    static constexpr int MODEL_PAGE_SIZE = 200;
     std::vector<GCodeRecord> m_gcodeFiles;
     std::string m_searchQuery;
     std::set<int64_t> m_selectedModelIds;
@@ -137,8 +169,27 @@ class LibraryPanel : public Panel {
     GCodeSelectedCallback m_onGCodeOpened;
     GCodeAddToProjectCallback m_onGCodeAddToProject;
 
-    // Thumbnail texture cache: model ID -> GL texture
-    std::unordered_map<int64_t, GLuint> m_textureCache;
+    // Resident thumbnail textures (LRU-bounded); handle 0 marks a failed load
+    static constexpr usize MAX_RESIDENT_THUMBNAILS = 512;
+    static constexpr int MAX_UPLOADS_PER_FRAME = 8;
+    static constexpr double UPLOAD_BUDGET_MS = 2.0;
+    ThumbnailLru m_textureCache{MAX_RESIDENT_THUMBNAILS};
+
+    // Async thumbnail pipeline: workers decode (or read the packed cache) and post
+    // results through the MainThreadQueue; render() uploads them under a budget
+    struct PendingThumbnail {
+        int64_t modelId = 0;
+        u64 serial = 0;
+        ThumbnailImage image;
+        bool largest = true;
+    };
+    MainThreadQueue* m_mainThreadQueue = nullptr;
+    std::unique_ptr<ThreadPool> m_thumbnailPool; // Lazily created
+    std::shared_ptr<ThumbnailAtlas> m_thumbnailAtlas;
+    std::unordered_map<int64_t, u64> m_thumbnailsInFlight; // Model ID -> request serial
+    u64 m_thumbnailRequestSerial = 0;
+    std::deque<PendingThumbnail> m_pendingUploads;
+    std::shared_ptr<bool> m_alive = std::make_shared<bool>(true); // Guards queued callbacks
 
     // Placeholder texture for models without a thumbnail (statue.png)
     GLuint m_placeholderTexture = 0;
@@ -181,7 +232,7 @@ class LibraryPanel : public Panel {
 
     // Context menu management
     ContextMenuManager* m_contextMenuManager = nullptr;
-    std::optional<ModelRecord> m_currentContextMenuModel;
+    std::optional<ModelSummary> m_currentContextMenuModel;
     std::optional<GCodeRecord> m_currentContextMenuGCode;
 };
 
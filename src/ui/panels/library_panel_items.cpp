@@ -23,6 +23,7 @@ namespace dw {
 
 void LibraryPanel::renderModelList() {
     ImGui::BeginChild("ModelList", ImVec2(0, 0), false, ImGuiWindowFlags_AlwaysVerticalScrollbar);
+    bool loadMore = false;
 
     // Ctrl+scroll to zoom thumbnails in grid view
     if (m_showThumbnails && ImGui::IsWindowHovered() && ImGui::GetIO().KeyCtrl) {
@@ -51,6 +52,8 @@ void LibraryPanel::renderModelList() {
         int col = 0;
         for (size_t i = 0; i < m_models.size(); ++i) {
             renderModelItem(m_models[i], static_cast<int>(i), thumbSize);
+            if (i + 1 == m_models.size() && ImGui::IsItemVisible())
+                loadMore = m_hasMoreModels;
             ++col;
             if (col < columns) {
                 ImGui::SameLine(0.0f, 0.0f);
@@ -61,13 +64,19 @@ void LibraryPanel::renderModelList() {
     } else {
         for (size_t i = 0; i < m_models.size(); ++i) {
             renderModelItem(m_models[i], static_cast<int>(i));
+            if (i + 1 == m_models.size() && ImGui::IsItemVisible())
+                loadMore = m_hasMoreModels;
         }
     }
 
     ImGui::EndChild();
+
+    // Keyset paging: pull the next page once the last loaded model scrolls into view
+    if (loadMore)
+        loadNextModelPage();
 }
 
-void LibraryPanel::renderModelItem(const ModelRecord& model,
+void LibraryPanel::renderModelItem(const ModelSummary& model,
                                    [[maybe_unused]] int index,
                                    float thumbOverride) {
     ImGui::PushID(static_cast<int>(model.id));
@@ -166,7 +175,7 @@ void LibraryPanel::renderModelItem(const ModelRecord& model,
         ImVec2 thumbMin = ImVec2(itemMin.x + pad, itemMin.y + pad);
         ImVec2 thumbMax = ImVec2(thumbMin.x + ts, thumbMin.y + ts);
 
-        GLuint tex = getThumbnailTexture(model);
+        GLuint tex = getThumbnailTexture(model, ts);
         if (tex != 0) {
             drawList->AddImageRounded((ImTextureID)(intptr_t)tex,
                                       thumbMin,
@@ -511,6 +520,7 @@ void LibraryPanel::renderGCodeList() {
 void LibraryPanel::renderCombinedList() {
     ImGui::BeginChild(
         "CombinedList", ImVec2(0, 0), false, ImGuiWindowFlags_AlwaysVerticalScrollbar);
+    bool loadMore = false;
 
     // Ctrl+scroll to zoom thumbnails in grid view
     if (m_showThumbnails && ImGui::IsWindowHovered() && ImGui::GetIO().KeyCtrl) {
@@ -537,6 +547,8 @@ void LibraryPanel::renderCombinedList() {
         int col = 0;
         for (size_t i = 0; i < m_models.size(); ++i) {
             renderModelItem(m_models[i], static_cast<int>(i), thumbSize);
+            if (i + 1 == m_models.size() && ImGui::IsItemVisible())
+                loadMore = m_hasMoreModels;
             ++col;
             if (col < columns) {
                 ImGui::SameLine(0.0f, 0.0f);
@@ -556,6 +568,8 @@ void LibraryPanel::renderCombinedList() {
     } else {
         for (size_t i = 0; i < m_models.size(); ++i) {
             renderModelItem(m_models[i], static_cast<int>(i));
+            if (i + 1 == m_models.size() && ImGui::IsItemVisible())
+                loadMore = m_hasMoreModels;
         }
         for (size_t i = 0; i < m_gcodeFiles.size(); ++i) {
             renderGCodeItem(m_gcodeFiles[i], static_cast<int>(i + m_models.size()));
@@ -563,6 +577,10 @@ void LibraryPanel::renderCombinedList() {
     }
 
     ImGui::EndChild();
+
+    // Keyset paging: pull the next page once the last loaded model scrolls into view
+    if (loadMore)
+        loadNextModelPage();
 }
 
 void LibraryPanel::renderGCodeItem(const GCodeRecord& gcode,
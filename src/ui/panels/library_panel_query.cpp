@@ -0,0 +1,159 @@
+// library_panel_query.cpp — Model list loading for LibraryPanel
+// Split from library_panel.cpp to stay within the 800-line .cpp limit.
+// Contains: refresh, currentModelQuery, loadNextModelPage, applyModelChanges
+
+#include "library_panel.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+#include "../../core/database/model_change_feed.h"
+
+namespace dw {
+
+namespace {
+
+// Browse order: imported_at DESC, id DESC (matches ModelRepository::findPage)
+bool sortsBefore(const ModelSummary& a, const ModelSummary& b) {
+    if (a.importedAt != b.importedAt)
+        return a.importedAt > b.importedAt;
+    return a.id > b.id;
+}
+
+} // namespace
+
+ModelPageQuery LibraryPanel::currentModelQuery() const {
+    ModelPageQuery query;
+    query.search = m_searchQuery;
+    query.useFTS = m_useFTS;
+    query.categoryId = m_selectedCategoryId;
+    query.limit = MODEL_PAGE_SIZE;
+    return query;
+}
+
+void LibraryPanel::refresh() {
+    if (!m_library)
+        return;
+
+    // Refresh category cache
+    m_categories = m_library->getAllCategories();
+
+    // Take the feed position before querying so writes racing the reload are replayed
+    m_modelFeedVersion = ModelChangeFeed::instance().currentVersion();
+    m_models.clear();
+    m_nextModelPage.reset();
+    m_hasMoreModels = true;
+    loadNextModelPage();
+
+    // G-code files are not affected by category filter
+    if (!m_searchQuery.empty()) {
+        m_gcodeFiles = m_library->searchGCodeFiles(m_searchQuery);
+    } else {
+        m_gcodeFiles = m_library->getAllGCodeFiles();
+    }
+}
+
+void LibraryPanel::loadNextModelPage() {
+    if (!m_library || !m_hasMoreModels)
+        return;
+
+    auto query = currentModelQuery();
+    query.after = m_nextModelPage;
+    auto page = m_library->getModelPage(query);
+
+    // Rows patched in from the change feed may already be present
+    std::unordered_set<i64> present;
+    present.reserve(m_models.size());
+    for (const auto& m : m_models)
+        present.insert(m.id);
+
+    m_models.reserve(m_models.size() + page.rows.size());
+    for (auto& row : page.rows) {
+        if (present.count(row.id) == 0)
+            m_models.push_back(std::move(row));
+    }
+    m_nextModelPage = page.next;
+    m_hasMoreModels = page.next.has_value();
+}
+
+void LibraryPanel::applyModelChanges() {
+    if (!m_library)
+        return;
+
+    auto& feed = ModelChangeFeed::instance();
+    if (feed.currentVersion() == m_modelFeedVersion)
+        return;
+
+    auto batch = feed.changesSince(m_modelFeedVersion);
+    if (batch.overflowed) {
+        refresh();
+        return;
+    }
+    m_modelFeedVersion = batch.latestVersion;
+
+    const auto query = currentModelQuery();
+    const bool ranked = !query.search.empty();
+    bool categoriesChanged = false;
+
+    for (const auto& change : batch.changes) {
+        if (change.kind == ModelChangeKind::CategoriesChanged) {
+            categoriesChanged = true;
+            continue;
+        }
+
+        auto it = std::find_if(m_models.begin(), m_models.end(), [&](const ModelSummary& m) {
+            return m.id == change.modelId;
+        });
+
+        if (change.kind == ModelChangeKind::Removed) {
+            if (it != m_models.end())
+                m_models.erase(it);
+            m_selectedModelIds.erase(change.modelId);
+            if (m_lastClickedModelId == change.modelId)
+                m_lastClickedModelId = -1;
+            invalidateThumbnail(change.modelId);
+            continue;
+        }
+
+        // Added/Updated: re-read the row through the current filter
+        auto summary = m_library->getModelSummary(change.modelId, query);
+        if (!summary) {
+            if (it != m_models.end())
+                m_models.erase(it); // No longer matches search/category
+            continue;
+        }
+        if (it != m_models.end()) {
+            *it = std::move(*summary);
+            continue;
+        }
+
+        if (ranked) {
+            // Search rank is not known client-side; surface new matches first
+            m_models.insert(m_models.begin(), std::move(*summary));
+            continue;
+        }
+        auto pos = std::lower_bound(m_models.begin(), m_models.end(), *summary, sortsBefore);
+        if (pos == m_models.end() && m_hasMoreModels)
+            continue; // Belongs to a page that has not been loaded yet
+        m_models.insert(pos, std::move(*summary));
+    }
+
+    if (categoriesChanged) {
+        m_categories = m_library->getAllCategories();
+        // Deleting a category changes membership without per-model entries
+        if (m_selectedCategoryId > 0) {
+            bool exists = std::any_of(m_categories.begin(),
+                                      m_categories.end(),
+                                      [&](const CategoryRecord& c) {
+                                          return c.id == m_selectedCategoryId;
+                                      });
+            if (!exists) {
+                m_selectedCategoryId = -1;
+                m_selectedCategoryName.clear();
+            }
+            refresh();
+        }
+    }
+}
+
+} // namespace dw
@@ -0,0 +1,148 @@
+#include "ui/panels/profiler_panel.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <numeric>
+
+#include <imgui.h>
+
+#include "ui/dialogs/file_dialog.h"
+#include "ui/ui_colors.h"
+#include "ui/widgets/toast.h"
+
+namespace dw {
+
+namespace {
+
+constexpr u64 kRefreshIntervalNs = 250'000'000;
+
+} // namespace
+
+ProfilerPanel::ProfilerPanel() : Panel("Profiler") {}
+
+void ProfilerPanel::render() {
+    if (!m_open)
+        return;
+
+    applyMinSize(30, 12);
+    if (!ImGui::Begin(m_title.c_str(), &m_open)) {
+        ImGui::End();
+        return;
+    }
+
+    if (!trace::kCompiledIn) {
+        ImGui::TextColored(colors::kDimmed, "Tracing is compiled out of this build");
+        ImGui::TextDisabled("Reconfigure with -DDW_ENABLE_TRACING=ON");
+        ImGui::End();
+        return;
+    }
+
+    bool recording = trace::isEnabled();
+    if (ImGui::Checkbox("Record", &recording))
+        trace::setEnabled(recording);
+    ImGui::SameLine();
+    ImGui::Checkbox("Pause table", &m_paused);
+    ImGui::SameLine();
+    if (ImGui::Button("Clear")) {
+        trace::clear();
+        m_zones.clear();
+        m_droppedEvents = 0;
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Export Trace..."))
+        exportTrace();
+
+    renderFrameGraph();
+    ImGui::Separator();
+    renderZoneTable();
+
+    ImGui::End();
+}
+
+void ProfilerPanel::renderFrameGraph() {
+    auto frames = trace::frameTimes();
+    if (frames.empty()) {
+        ImGui::TextDisabled("No frames recorded");
+        return;
+    }
+
+    f32 total = std::accumulate(frames.begin(), frames.end(), 0.0f);
+    f32 average = total / static_cast<f32>(frames.size());
+    f32 worst = *std::max_element(frames.begin(), frames.end());
+
+    char overlay[96];
+    std::snprintf(overlay, sizeof(overlay), "avg %.2f ms (%.0f fps)  max %.2f ms",
+                  static_cast<double>(average),
+                  average > 0.0f ? 1000.0 / static_cast<double>(average) : 0.0,
+                  static_cast<double>(worst));
+    f32 scaleMax = std::max(worst * 1.1f, 1000.0f / 30.0f);
+    ImGui::PlotLines("##frametimes", frames.data(), static_cast<int>(frames.size()), 0, overlay,
+                     0.0f, scaleMax, ImVec2(-1.0f, ImGui::GetTextLineHeight() * 5.0f));
+}
+
+void ProfilerPanel::renderZoneTable() {
+    ImGui::SetNextItemWidth(ImGui::GetFontSize() * 10.0f);
+    ImGui::SliderFloat("Window (s)", &m_windowSeconds, 0.5f, 30.0f, "%.1f");
+
+    u64 now = trace::nowNs();
+    if (!m_paused && now - m_lastRefreshNs >= kRefreshIntervalNs) {
+        m_lastRefreshNs = now;
+        auto window = static_cast<u64>(static_cast<f64>(m_windowSeconds) * 1.0e9);
+        auto threads = trace::snapshot();
+        m_droppedEvents = 0;
+        for (const auto& thread : threads)
+            m_droppedEvents += thread.dropped;
+        m_zones = trace::summarize(threads, now > window ? now - window : 0);
+    }
+
+    if (m_droppedEvents > 0) {
+        ImGui::SameLine();
+        ImGui::TextColored(colors::kDimmed, "(%llu older events overwritten)",
+                           static_cast<unsigned long long>(m_droppedEvents));
+    }
+
+    ImGuiTableFlags flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders |
+                            ImGuiTableFlags_ScrollY | ImGuiTableFlags_Resizable;
+    if (!ImGui::BeginTable("##zones", 5, flags))
+        return;
+    ImGui::TableSetupScrollFreeze(0, 1);
+    ImGui::TableSetupColumn("Zone", ImGuiTableColumnFlags_WidthStretch);
+    ImGui::TableSetupColumn("Calls", ImGuiTableColumnFlags_WidthFixed);
+    ImGui::TableSetupColumn("Total ms", ImGuiTableColumnFlags_WidthFixed);
+    ImGui::TableSetupColumn("Avg ms", ImGuiTableColumnFlags_WidthFixed);
+    ImGui::TableSetupColumn("Max ms", ImGuiTableColumnFlags_WidthFixed);
+    ImGui::TableHeadersRow();
+
+    for (const auto& zone : m_zones) {
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted(zone.name);
+        ImGui::TableNextColumn();
+        ImGui::Text("%u", zone.calls);
+        ImGui::TableNextColumn();
+        ImGui::Text("%.2f", zone.totalMs);
+        ImGui::TableNextColumn();
+        ImGui::Text("%.3f", zone.calls > 0 ? zone.totalMs / zone.calls : 0.0);
+        ImGui::TableNextColumn();
+        ImGui::Text("%.3f", zone.maxMs);
+    }
+    ImGui::EndTable();
+}
+
+void ProfilerPanel::exportTrace() {
+    if (!m_fileDialog)
+        return;
+    m_fileDialog->showSave("Export Trace", {{"Chrome Trace", "*.json"}}, "trace.json",
+                           [](const std::string& path) {
+                               std::string error;
+                               if (trace::exportChromeTrace(path, error)) {
+                                   ToastManager::instance().show(
+                                       ToastType::Success, "Trace Exported", path);
+                               } else {
+                                   ToastManager::instance().show(ToastType::Error,
+                                                                 "Export Failed", error);
+                               }
+                           });
+}
+
+} // namespace dw
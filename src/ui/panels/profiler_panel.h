@@ -0,0 +1,39 @@
+#pragma once
+
+#include <vector>
+
+#include "../../core/utils/trace.h"
+#include "panel.h"
+
+namespace dw {
+
+class FileDialog;
+
+// Profiler panel -- frame-time graph and per-zone timing table fed by the
+// trace subsystem (core/utils/trace.h), with Chrome trace export for offline
+// analysis in chrome://tracing or Perfetto.
+class ProfilerPanel : public Panel {
+  public:
+    ProfilerPanel();
+    ~ProfilerPanel() override = default;
+
+    void render() override;
+
+    void setFileDialog(FileDialog* dialog) { m_fileDialog = dialog; }
+
+  private:
+    void renderFrameGraph();
+    void renderZoneTable();
+    void exportTrace();
+
+    FileDialog* m_fileDialog = nullptr;
+
+    // Zone table is refreshed a few times per second, not every frame
+    std::vector<trace::ZoneStats> m_zones;
+    u64 m_lastRefreshNs = 0;
+    u64 m_droppedEvents = 0;
+    float m_windowSeconds = 2.0f;
+    bool m_paused = false;
+};
+
+} // namespace dw
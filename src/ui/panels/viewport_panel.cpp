@@ -5,17 +5,18 @@
 #include <cfloat>
 #include <cmath>
 #include <cstdio>
-#include <map>
 #include <numeric>
 
 #include <imgui.h>
 #include <imgui_internal.h>
 
+#include "../../core/carve/carve_job.h"
 #include "../../core/config/config.h"
 #include "../../core/config/input_binding.h"
 #include "../../core/mesh/mesh.h"
 #include "../../render/gl_utils.h"
 #include "../context_menu_manager.h"
+#include "../dialogs/file_dialog.h"
 
 namespace dw {
 
@@ -583,6 +584,13 @@ void ViewportPanel::renderViewport() {
         m_renderer.renderMesh(m_gpuMesh, m_materialTexture, m_modelMatrix);
     }
 
+    // Render simulated stock (only while a simulation position is shown)
+    bool stockActive = m_simState != VPSimState::Stopped || m_simSegmentIndex > 0;
+    if (m_showStock && hasGCode() && stockActive) {
+        updateStockSimulation();
+        renderStock();
+    }
+
     // Render toolpath (if present and visible)
     if (m_showToolpath && m_gpuToolpath.vao != 0) {
         m_renderer.renderToolpath(*m_toolpathMesh);
@@ -696,6 +704,10 @@ void ViewportPanel::renderViewport() {
                  ImVec2(0, 1),
                  ImVec2(1, 0));
 
+    ImVec2 imageMin = ImGui::GetItemRectMin();
+    ImVec2 imageMax = ImGui::GetItemRectMax();
+    bool imageHovered = ImGui::IsItemHovered();
+
     // Live DRO overlay
     if (m_cncConnected && Config::instance().getCncShowDroOverlay()) {
         renderCncDro();
@@ -714,6 +726,12 @@ void ViewportPanel::renderViewport() {
     }
 
     renderViewCube();
+
+    // Where the Z clip slices the toolpath
+    renderZClipSlice(imageMin, imageMax);
+
+    // Hovered G-code line: highlight + tooltip, click to select in the G-code panel
+    updateGCodeHover(imageMin, imageMax, imageHovered);
 }
 
 void ViewportPanel::renderToolbar() {
@@ -814,7 +832,12 @@ void ViewportPanel::renderToolbar() {
                 m_gcodeProgram.boundsMin.z,
                 m_zClipMaxBound, "%.2f mm")) {
             m_gcodeDirty = true;
+            updateZClipSlice();
         }
+        ImGui::TextDisabled("Below clip: %zu moves, %.0f mm cutting, %.0f mm rapid",
+                            m_zClipStats.segmentCount,
+                            static_cast<double>(m_zClipStats.cuttingLength),
+                            static_cast<double>(m_zClipStats.rapidLength));
 
         // Simulation controls
         renderSimControls();
@@ -1024,12 +1047,16 @@ void ViewportPanel::renderViewCube() {
 
 void ViewportPanel::setGCodeProgram(const gcode::Program& program) {
     m_gcodeProgram = program;
+    m_gcodeIndex.build(m_gcodeProgram);
+    m_hoverLine = -1;
     m_gcodeDirty = true;
     m_alignmentDirty = true;
+    m_stockStale = true;
 
     // Initialize Z-clip bounds from program
     m_zClipMaxBound = program.boundsMax.z;
     m_zClipMax = m_zClipMaxBound;
+    updateZClipSlice();
 
     // Fit camera to G-code bounds if no mesh is currently loaded
     if (!m_mesh) {
@@ -1067,10 +1094,13 @@ void ViewportPanel::setGCodeStatistics(const gcode::Statistics& stats) {
 }
 
 void ViewportPanel::clearGCodeProgram() {
+    m_gcodeIndex.clear();
+    m_hoverLine = -1;
     m_gcodeProgram = gcode::Program{};
     m_zClipMax = 100.0f;
     m_zClipMaxBound = 100.0f;
-    m_gcToolGroups.clear();
+    m_zSliceSegments.clear();
+    m_zClipStats = gcode::RegionStats{};
     destroyGCodeGeometry();
     m_alignmentStatus = AlignmentStatus::Unknown;
 
@@ -1082,6 +1112,10 @@ void ViewportPanel::clearGCodeProgram() {
     m_segmentTimes.clear();
     m_segmentTimeCumulative.clear();
     destroySimGeometry();
+
+    destroyStockGeometry();
+    m_stockSim = carve::StockSimulator{};
+    m_stockStale = true;
 }
 
 void ViewportPanel::destroyGCodeGeometry() {
@@ -1093,10 +1127,8 @@ void ViewportPanel::destroyGCodeGeometry() {
         glDeleteVertexArrays(1, &m_gcodeVAO);
         m_gcodeVAO = 0;
     }
-    m_gcRapidStart = m_gcRapidCount = 0;
-    m_gcCutStart = m_gcCutCount = 0;
-    m_gcPlungeStart = m_gcPlungeCount = 0;
-    m_gcRetractStart = m_gcRetractCount = 0;
+    m_gcodeLod.clear();
+    m_gcBatches.clear();
     destroySimGeometry();
 }
 
@@ -1109,6 +1141,32 @@ void ViewportPanel::destroySimGeometry() {
         glDeleteVertexArrays(1, &m_simVAO);
         m_simVAO = 0;
     }
+    m_simPath.clear();
+}
+
+void ViewportPanel::buildSimGeometry() {
+    destroySimGeometry();
+    if (m_gcodeProgram.path.empty())
+        return;
+
+    // Built lazily on first playback frame and again after Z-clip/program changes
+    m_simPath.build(m_gcodeProgram, m_zClipMax);
+
+    GL_CHECK(glGenVertexArrays(1, &m_simVAO));
+    GL_CHECK(glGenBuffers(1, &m_simVBO));
+    GL_CHECK(glBindVertexArray(m_simVAO));
+    GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, m_simVBO));
+    GL_CHECK(glBufferData(GL_ARRAY_BUFFER,
+                          static_cast<GLsizeiptr>(m_simPath.vertices.size() * sizeof(f32)),
+                          m_simPath.vertices.data(),
+                          GL_DYNAMIC_DRAW));
+    GL_CHECK(glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(f32), nullptr));
+    GL_CHECK(glEnableVertexAttribArray(0));
+    GL_CHECK(glBindVertexArray(0));
+
+    // GPU copy is authoritative; keep only the per-segment draw ranges
+    m_simPath.vertices.clear();
+    m_simPath.vertices.shrink_to_fit();
 }
 
 void ViewportPanel::updateSimulation(float dt) {
@@ -1143,156 +1201,35 @@ void ViewportPanel::updateSimulation(float dt) {
     m_simSegmentProgress = (segDur > 0.0f) ? (m_simTime - segStart) / segDur : 0.0f;
 }
 
+gcode::LodBuildOptions ViewportPanel::gcodeDisplayOptions() const {
+    gcode::LodBuildOptions options;
+    options.zClipMax = m_zClipMax;
+    options.showRapids = m_showRapids;
+    options.showCuts = m_showCuts;
+    options.showPlunges = m_showPlunges;
+    options.showRetracts = m_showRetracts;
+    options.groupByTool = m_colorByTool;
+    return options;
+}
+
 void ViewportPanel::buildGCodeGeometry() {
     destroyGCodeGeometry();
-    m_gcToolGroups.clear();
 
     if (m_gcodeProgram.path.empty()) {
         m_gcodeDirty = false;
         return;
     }
 
-    // Lambda to push a segment's vertices with Y<->Z swap
-    auto addSegVerts = [](std::vector<f32>& verts,
-                          const gcode::PathSegment& seg) {
-        verts.push_back(seg.start.x);
-        verts.push_back(seg.start.z); // G-code Z -> renderer Y
-        verts.push_back(seg.start.y); // G-code Y -> renderer Z
-        verts.push_back(seg.end.x);
-        verts.push_back(seg.end.z);
-        verts.push_back(seg.end.y);
-    };
+    // Filtered, grouped, multi-level line lists (see gcode_lod.h)
+    m_gcodeLod.build(m_gcodeProgram, gcodeDisplayOptions());
 
-    // Helper: classify non-rapid segment visibility
-    auto isVisibleNonRapid =
-        [this](const gcode::PathSegment& seg) -> bool {
-        float dz = seg.end.z - seg.start.z;
-        float dxy2 =
-            (seg.end.x - seg.start.x) * (seg.end.x - seg.start.x) +
-            (seg.end.y - seg.start.y) * (seg.end.y - seg.start.y);
-        bool zDominant = (dz * dz) > dxy2 * 0.25f;
-
-        if (dz < -0.001f && zDominant) return m_showPlunges;
-        if (dz > 0.001f && zDominant) return m_showRetracts;
-        return m_showCuts;
-    };
-
-    std::vector<f32> allVerts;
-
-    if (m_colorByTool) {
-        // Color-by-tool mode: group by tool number
-        std::vector<f32> rapidVerts;
-        std::map<int, std::vector<f32>> toolVerts;
-
-        for (const auto& seg : m_gcodeProgram.path) {
-            if (seg.end.z > m_zClipMax) continue;
-
-            if (seg.isRapid) {
-                if (m_showRapids) addSegVerts(rapidVerts, seg);
-            } else {
-                if (!isVisibleNonRapid(seg)) continue;
-                addSegVerts(toolVerts[seg.toolNumber], seg);
-            }
-        }
-
-        allVerts.reserve(rapidVerts.size());
-        for (auto& [tool, verts] : toolVerts)
-            allVerts.reserve(allVerts.capacity() + verts.size());
-
-        // Rapids first
-        m_gcRapidStart = 0;
-        m_gcRapidCount =
-            static_cast<u32>(rapidVerts.size() / 3);
-        allVerts.insert(
-            allVerts.end(), rapidVerts.begin(), rapidVerts.end());
-
-        // Zero out type-based groups (not used in tool mode)
-        m_gcCutStart = m_gcCutCount = 0;
-        m_gcPlungeStart = m_gcPlungeCount = 0;
-        m_gcRetractStart = m_gcRetractCount = 0;
-
-        // Tool groups
-        u32 offset = m_gcRapidCount;
-        for (auto& [tool, verts] : toolVerts) {
-            ToolGroup tg;
-            tg.toolNumber = tool;
-            tg.start = offset;
-            tg.count = static_cast<u32>(verts.size() / 3);
-            m_gcToolGroups.push_back(tg);
-            allVerts.insert(
-                allVerts.end(), verts.begin(), verts.end());
-            offset += tg.count;
-        }
-    } else {
-        // Standard mode: group by move type with filtering
-        std::vector<f32> rapidVerts;
-        std::vector<f32> cutVerts;
-        std::vector<f32> plungeVerts;
-        std::vector<f32> retractVerts;
-
-        for (const auto& seg : m_gcodeProgram.path) {
-            if (seg.end.z > m_zClipMax) continue;
-
-            if (seg.isRapid) {
-                if (!m_showRapids) continue;
-                addSegVerts(rapidVerts, seg);
-            } else {
-                float dz = seg.end.z - seg.start.z;
-                float dxy2 =
-                    (seg.end.x - seg.start.x) *
-                        (seg.end.x - seg.start.x) +
-                    (seg.end.y - seg.start.y) *
-                        (seg.end.y - seg.start.y);
-                bool zDominant = (dz * dz) > dxy2 * 0.25f;
-
-                if (dz < -0.001f && zDominant) {
-                    if (!m_showPlunges) continue;
-                    addSegVerts(plungeVerts, seg);
-                } else if (dz > 0.001f && zDominant) {
-                    if (!m_showRetracts) continue;
-                    addSegVerts(retractVerts, seg);
-                } else {
-                    if (!m_showCuts) continue;
-                    addSegVerts(cutVerts, seg);
-                }
-            }
-        }
-
-        allVerts.reserve(
-            rapidVerts.size() + cutVerts.size() +
-            plungeVerts.size() + retractVerts.size());
-
-        m_gcRapidStart = 0;
-        m_gcRapidCount =
-            static_cast<u32>(rapidVerts.size() / 3);
-        allVerts.insert(
-            allVerts.end(), rapidVerts.begin(), rapidVerts.end());
-
-        m_gcCutStart = m_gcRapidCount;
-        m_gcCutCount =
-            static_cast<u32>(cutVerts.size() / 3);
-        allVerts.insert(
-            allVerts.end(), cutVerts.begin(), cutVerts.end());
-
-        m_gcPlungeStart = m_gcCutStart + m_gcCutCount;
-        m_gcPlungeCount =
-            static_cast<u32>(plungeVerts.size() / 3);
-        allVerts.insert(
-            allVerts.end(), plungeVerts.begin(), plungeVerts.end());
-
-        m_gcRetractStart = m_gcPlungeStart + m_gcPlungeCount;
-        m_gcRetractCount =
-            static_cast<u32>(retractVerts.size() / 3);
-        allVerts.insert(
-            allVerts.end(), retractVerts.begin(), retractVerts.end());
-    }
-
-    if (allVerts.empty()) {
+    if (m_gcodeLod.empty()) {
         m_gcodeDirty = false;
         return;
     }
 
     // Upload to GPU
+    const auto& verts = m_gcodeLod.vertices();
     GL_CHECK(glGenVertexArrays(1, &m_gcodeVAO));
     GL_CHECK(glGenBuffers(1, &m_gcodeVBO));
 
@@ -1300,8 +1237,8 @@ void ViewportPanel::buildGCodeGeometry() {
     GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, m_gcodeVBO));
     GL_CHECK(glBufferData(GL_ARRAY_BUFFER,
                           static_cast<GLsizeiptr>(
-                              allVerts.size() * sizeof(f32)),
-                          allVerts.data(),
+                              verts.size() * sizeof(f32)),
+                          verts.data(),
                           GL_STATIC_DRAW));
 
     // Position attribute (location 0): vec3
@@ -1311,6 +1248,8 @@ void ViewportPanel::buildGCodeGeometry() {
 
     GL_CHECK(glBindVertexArray(0));
 
+    // Chunk ranges are all the renderer needs from here on
+    m_gcodeLod.releaseVertices();
     m_gcodeDirty = false;
 }
 
@@ -1360,6 +1299,24 @@ void ViewportPanel::renderSimControls() {
         ImGui::EndCombo();
     }
 
+    ImGui::SameLine();
+    ImGui::Checkbox("Stock##Sim", &m_showStock);
+
+    // Compare the simulated stock against the Direct Carve heightmap
+    const bool canCompare = m_showStock && !m_stockSim.empty() && m_fileDialog && m_carveJob &&
+                            m_carveJob->state() == carve::CarveJobState::Ready;
+    ImGui::SameLine();
+    ImGui::BeginDisabled(!canCompare);
+    if (ImGui::Button("Deviation...##Sim")) {
+        m_fileDialog->showSave("Export Stock Deviation",
+                               {{"PPM Image", "*.ppm"}},
+                               "deviation.ppm",
+                               [this](const std::string& path) { exportStockDeviation(path); });
+    }
+    ImGui::EndDisabled();
+    if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
+        ImGui::SetTooltip("Stock minus carve heightmap: blue = gouge, red = material left");
+
     // Scrub slider
     ImGui::Text("Progress:");
     ImGui::SameLine();
@@ -1403,184 +1360,116 @@ void ViewportPanel::renderGCodeLines() {
 
     bool simActive = m_simState != VPSimState::Stopped;
 
+    // Cull chunks outside the view and pick each one's level of detail
+    constexpr f32 kDeg2Rad = 3.14159265f / 180.0f;
+    gcode::LodView lodView;
+    lodView.viewProj = mvp;
+    lodView.pixelsPerUnit = static_cast<f32>(m_framebuffer.height()) /
+                            (2.0f * std::tan(m_camera.fov() * 0.5f * kDeg2Rad));
+    m_gcodeLod.selectDraws(lodView, m_gcBatches);
+
+    auto drawBatch = [](const gcode::LodDrawBatch& batch) {
+        glMultiDrawArrays(GL_LINES,
+                          batch.first.data(),
+                          batch.count.data(),
+                          static_cast<GLsizei>(batch.first.size()));
+    };
+
     glDisable(GL_CULL_FACE);
     glLineWidth(1.5f);
     glBindVertexArray(m_gcodeVAO);
 
     if (simActive) {
         // During simulation: draw ALL base geometry as dim ghost lines
-        u32 totalVerts = m_gcRapidCount + m_gcCutCount +
-                         m_gcPlungeCount + m_gcRetractCount;
-        if (!m_gcToolGroups.empty()) {
-            for (const auto& tg : m_gcToolGroups)
-                totalVerts += tg.count;
-            // Subtract the type-based counts since tool groups replace them
-            totalVerts = m_gcRapidCount;
-            for (const auto& tg : m_gcToolGroups)
-                totalVerts += tg.count;
-        }
         flat.bind();
         flat.setMat4("uMVP", mvp);
         flat.setVec4("uColor", Vec4{0.3f, 0.3f, 0.35f, 0.35f});
-        glDrawArrays(GL_LINES, 0, static_cast<GLsizei>(totalVerts));
-    } else if (m_colorByTool && !m_gcToolGroups.empty()) {
-        // Color-by-tool mode: rapids gray, then each tool group
-        flat.bind();
-        flat.setMat4("uMVP", mvp);
-        if (m_gcRapidCount > 0) {
-            flat.setVec4("uColor",
-                Vec4{0.4f, 0.4f, 0.4f, 0.5f});
-            glDrawArrays(
-                GL_LINES,
-                static_cast<GLint>(m_gcRapidStart),
-                static_cast<GLsizei>(m_gcRapidCount));
-        }
-
-        // Tool groups use height shader for depth
-        heightShader.bind();
-        heightShader.setMat4("uMVP", mvp);
-        heightShader.setFloat("uYMin", yMin);
-        heightShader.setFloat("uYMax", yMax);
-        for (const auto& tg : m_gcToolGroups) {
-            if (tg.count == 0) continue;
-            Vec3 tc = toolColor(tg.toolNumber);
-            heightShader.setVec4("uColorLow",
-                Vec4{tc.x * 0.3f, tc.y * 0.3f,
-                     tc.z * 0.3f, 1.0f});
-            heightShader.setVec4("uColorHigh",
-                Vec4{tc.x, tc.y, tc.z, 1.0f});
-            glDrawArrays(
-                GL_LINES,
-                static_cast<GLint>(tg.start),
-                static_cast<GLsizei>(tg.count));
+        for (const auto& batch : m_gcBatches) {
+            if (!batch.empty())
+                drawBatch(batch);
         }
     } else {
-        // Standard mode: 4-group rendering
-        flat.bind();
-        flat.setMat4("uMVP", mvp);
-
-        // Rapids: dim gray
-        if (m_gcRapidCount > 0) {
-            flat.setVec4("uColor",
-                Vec4{0.4f, 0.4f, 0.4f, 0.5f});
-            glDrawArrays(
-                GL_LINES,
-                static_cast<GLint>(m_gcRapidStart),
-                static_cast<GLsizei>(m_gcRapidCount));
-        }
-
-        // Cuts: height-colored (deep blue -> bright cyan)
-        if (m_gcCutCount > 0) {
-            heightShader.bind();
-            heightShader.setMat4("uMVP", mvp);
-            heightShader.setFloat("uYMin", yMin);
-            heightShader.setFloat("uYMax", yMax);
-            heightShader.setVec4("uColorLow",
-                Vec4{0.05f, 0.15f, 0.5f, 1.0f});
-            heightShader.setVec4("uColorHigh",
-                Vec4{0.3f, 0.8f, 1.0f, 1.0f});
-            glDrawArrays(
-                GL_LINES,
-                static_cast<GLint>(m_gcCutStart),
-                static_cast<GLsizei>(m_gcCutCount));
-            // Re-bind flat shader for remaining groups
-            flat.bind();
-            flat.setMat4("uMVP", mvp);
-        }
-
-        // Plunges: orange
-        if (m_gcPlungeCount > 0) {
-            flat.setVec4("uColor",
-                Vec4{1.0f, 0.5f, 0.1f, 1.0f});
-            glDrawArrays(
-                GL_LINES,
-                static_cast<GLint>(m_gcPlungeStart),
-                static_cast<GLsizei>(m_gcPlungeCount));
-        }
-
-        // Retracts: green
-        if (m_gcRetractCount > 0) {
-            flat.setVec4("uColor",
-                Vec4{0.3f, 0.8f, 0.3f, 0.6f});
-            glDrawArrays(
-                GL_LINES,
-                static_cast<GLint>(m_gcRetractStart),
-                static_cast<GLsizei>(m_gcRetractCount));
+        // Rapids and plunges/retracts are flat; cuts (or tool groups) use the
+        // height shader for depth
+        for (const auto& batch : m_gcBatches) {
+            if (batch.empty())
+                continue;
+            const auto& group = m_gcodeLod.groups()[batch.group];
+            if (group.kind == gcode::MoveKind::Rapid) {
+                flat.bind();
+                flat.setMat4("uMVP", mvp);
+                flat.setVec4("uColor", Vec4{0.4f, 0.4f, 0.4f, 0.5f});
+            } else if (group.toolNumber >= 0) {
+                Vec3 tc = toolColor(group.toolNumber);
+                heightShader.bind();
+                heightShader.setMat4("uMVP", mvp);
+                heightShader.setFloat("uYMin", yMin);
+                heightShader.setFloat("uYMax", yMax);
+                heightShader.setVec4("uColorLow",
+                    Vec4{tc.x * 0.3f, tc.y * 0.3f,
+                         tc.z * 0.3f, 1.0f});
+                heightShader.setVec4("uColorHigh",
+                    Vec4{tc.x, tc.y, tc.z, 1.0f});
+            } else if (group.kind == gcode::MoveKind::Cut) {
+                // Cuts: height-colored (deep blue -> bright cyan)
+                heightShader.bind();
+                heightShader.setMat4("uMVP", mvp);
+                heightShader.setFloat("uYMin", yMin);
+                heightShader.setFloat("uYMax", yMax);
+                heightShader.setVec4("uColorLow",
+                    Vec4{0.05f, 0.15f, 0.5f, 1.0f});
+                heightShader.setVec4("uColorHigh",
+                    Vec4{0.3f, 0.8f, 1.0f, 1.0f});
+            } else {
+                flat.bind();
+                flat.setMat4("uMVP", mvp);
+                flat.setVec4("uColor",
+                    group.kind == gcode::MoveKind::Plunge
+                        ? Vec4{1.0f, 0.5f, 0.1f, 1.0f}   // Plunges: orange
+                        : Vec4{0.3f, 0.8f, 0.3f, 0.6f}); // Retracts: green
+            }
+            drawBatch(batch);
         }
     }
 
     // --- Simulation overlay: completed + current segment ---
-    if (simActive) {
+    // Draws a prefix of the persistent sim buffer; only the current segment's
+    // two tail vertices are re-uploaded per frame.
+    if (simActive && m_simVAO == 0)
+        buildSimGeometry();
+    if (simActive && m_simVAO != 0) {
         flat.bind();
         flat.setMat4("uMVP", mvp);
-        std::vector<f32> simVerts;
-        simVerts.reserve((m_simSegmentIndex + 1) * 6);
-
-        for (size_t si = 0; si < m_simSegmentIndex && si < m_gcodeProgram.path.size(); ++si) {
-            const auto& seg = m_gcodeProgram.path[si];
-            if (seg.end.z > m_zClipMax) continue;
-            // Swap Y<->Z for Y-up renderer
-            simVerts.push_back(seg.start.x);
-            simVerts.push_back(seg.start.z);
-            simVerts.push_back(seg.start.y);
-            simVerts.push_back(seg.end.x);
-            simVerts.push_back(seg.end.z);
-            simVerts.push_back(seg.end.y);
-        }
+        GL_CHECK(glBindVertexArray(m_simVAO));
 
-        u32 completedVertCount = static_cast<u32>(simVerts.size() / 3);
+        u32 completedVertCount = m_simPath.completedVertices(m_simSegmentIndex);
 
-        // Current segment partial
-        if (m_simSegmentIndex < m_gcodeProgram.path.size()) {
-            const auto& cur = m_gcodeProgram.path[m_simSegmentIndex];
-            float t = std::clamp(m_simSegmentProgress, 0.0f, 1.0f);
-            float ex = cur.start.x + (cur.end.x - cur.start.x) * t;
-            float ey = cur.start.y + (cur.end.y - cur.start.y) * t;
-            float ez = cur.start.z + (cur.end.z - cur.start.z) * t;
-            // Swap Y<->Z
-            simVerts.push_back(cur.start.x);
-            simVerts.push_back(cur.start.z);
-            simVerts.push_back(cur.start.y);
-            simVerts.push_back(ex);
-            simVerts.push_back(ez);
-            simVerts.push_back(ey);
+        // Draw completed in bright green
+        if (completedVertCount > 0) {
+            flat.setVec4("uColor", Vec4{0.1f, 0.85f, 0.1f, 1.0f});
+            glDrawArrays(GL_LINES, 0, static_cast<GLsizei>(completedVertCount));
         }
 
-        if (!simVerts.empty()) {
-            // Create/update sim VBO
-            if (m_simVAO == 0) {
-                GL_CHECK(glGenVertexArrays(1, &m_simVAO));
-                GL_CHECK(glGenBuffers(1, &m_simVBO));
-                GL_CHECK(glBindVertexArray(m_simVAO));
-                GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, m_simVBO));
-                GL_CHECK(glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(f32), nullptr));
-                GL_CHECK(glEnableVertexAttribArray(0));
-            } else {
-                GL_CHECK(glBindVertexArray(m_simVAO));
-                GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, m_simVBO));
-            }
-
-            GL_CHECK(glBufferData(GL_ARRAY_BUFFER,
-                                  static_cast<GLsizeiptr>(simVerts.size() * sizeof(f32)),
-                                  simVerts.data(),
-                                  GL_DYNAMIC_DRAW));
-
-            // Draw completed in bright green
-            if (completedVertCount > 0) {
-                flat.setVec4("uColor", Vec4{0.1f, 0.85f, 0.1f, 1.0f});
-                glDrawArrays(GL_LINES, 0, static_cast<GLsizei>(completedVertCount));
-            }
+        // Current segment partial
+        if (m_simSegmentIndex < m_gcodeProgram.path.size()) {
+            f32 partial[6];
+            gcode::SimPath::partialSegment(
+                m_gcodeProgram.path[m_simSegmentIndex], m_simSegmentProgress, partial);
+            GLint tail = static_cast<GLint>(m_simPath.partialVertex());
+            GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, m_simVBO));
+            GL_CHECK(glBufferSubData(GL_ARRAY_BUFFER,
+                                     static_cast<GLintptr>(tail) * 3 * sizeof(f32),
+                                     sizeof(partial),
+                                     partial));
 
             // Draw current segment in yellow
-            if (m_simSegmentIndex < m_gcodeProgram.path.size()) {
-                flat.setVec4("uColor", Vec4{1.0f, 0.85f, 0.2f, 1.0f});
-                glDrawArrays(GL_LINES, static_cast<GLint>(completedVertCount), 2);
-
-                // Cutter dot at current position
-                flat.setVec4("uColor", Vec4{1.0f, 0.2f, 0.2f, 1.0f});
-                glPointSize(8.0f);
-                glDrawArrays(GL_POINTS, static_cast<GLint>(completedVertCount) + 1, 1);
-            }
+            flat.setVec4("uColor", Vec4{1.0f, 0.85f, 0.2f, 1.0f});
+            glDrawArrays(GL_LINES, tail, 2);
+
+            // Cutter dot at current position
+            flat.setVec4("uColor", Vec4{1.0f, 0.2f, 0.2f, 1.0f});
+            glPointSize(8.0f);
+            glDrawArrays(GL_POINTS, tail + 1, 1);
         }
     }
 
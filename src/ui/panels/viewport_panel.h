@@ -1,6 +1,8 @@
 #pragma once
 
 #include <array>
+#include <functional>
+#include <map>
 #include <memory>
 #include <optional>
 #include <vector>
@@ -9,7 +11,11 @@
 
 #include "../../core/carve/alignment_validator.h"
 #include "../../core/carve/model_fitter.h"
+#include "../../core/carve/stock_simulator.h"
 #include "../../core/database/model_repository.h"
+#include "../../core/gcode/gcode_lod.h"
+#include "../../core/gcode/gcode_sim_path.h"
+#include "../../core/gcode/gcode_spatial_index.h"
 #include "../../core/gcode/gcode_types.h"
 #include "../../render/camera.h"
 #include "../../render/framebuffer.h"
@@ -24,6 +30,11 @@ namespace dw {
 class Mesh;
 using MeshPtr = std::shared_ptr<Mesh>;
 class ContextMenuManager;
+class FileDialog;
+
+namespace carve {
+class CarveJob;
+} // namespace carve
 
 // 3D viewport panel
 class ViewportPanel : public Panel {
@@ -71,11 +82,23 @@ class ViewportPanel : public Panel {
     void setGCodeProgram(const gcode::Program& program);
     void clearGCodeProgram();
     bool hasGCode() const { return !m_gcodeProgram.path.empty(); }
+    const gcode::SpatialIndex& gcodeIndex() const { return m_gcodeIndex; }
+
+    // Called with the source line number when a G-code segment is clicked
+    void setOnGCodeLinePicked(std::function<void(int)> cb) { m_onGCodeLinePicked = std::move(cb); }
 
     // Simulation playback
     void updateSimulation(float dt);
     void setGCodeStatistics(const gcode::Statistics& stats);
 
+    // Cutter shapes for the stock removal preview, keyed by T-number
+    void setSimToolProfiles(std::map<int, carve::ToolProfile> profiles,
+                            const carve::ToolProfile& fallback);
+
+    // Target surface for the stock deviation export (not owned)
+    void setCarveJob(const carve::CarveJob* job) { m_carveJob = job; }
+    void setFileDialog(FileDialog* dialog) { m_fileDialog = dialog; }
+
     // FitParams-based model matrix for alignment overlay
     void setFitParams(const carve::FitParams& params,
                       const Vec3& modelBoundsMin,
@@ -167,6 +190,7 @@ class ViewportPanel : public Panel {
     float m_zClipMaxBound = 100.0f;
 
     // --- G-code line rendering ---
+    gcode::LodBuildOptions gcodeDisplayOptions() const; // Current Z-clip and move toggles
     void buildGCodeGeometry();
     void destroyGCodeGeometry();
     void renderGCodeLines();
@@ -174,19 +198,21 @@ class ViewportPanel : public Panel {
     gcode::Program m_gcodeProgram;
     GLuint m_gcodeVAO = 0;
     GLuint m_gcodeVBO = 0;
-    u32 m_gcRapidStart = 0, m_gcRapidCount = 0;
-    u32 m_gcCutStart = 0, m_gcCutCount = 0;
-    u32 m_gcPlungeStart = 0, m_gcPlungeCount = 0;
-    u32 m_gcRetractStart = 0, m_gcRetractCount = 0;
+    gcode::LodGeometry m_gcodeLod;                // Chunked multi-level line lists
+    std::vector<gcode::LodDrawBatch> m_gcBatches; // Per-frame visible ranges
     bool m_gcodeDirty = false;
 
-    // Per-tool draw groups (used when m_colorByTool is true)
-    struct ToolGroup {
-        u32 start = 0;
-        u32 count = 0;
-        int toolNumber = 0;
-    };
-    std::vector<ToolGroup> m_gcToolGroups;
+    // Segment BVH for hover picking, line lookups and the Z-clip slice
+    // (viewport_panel_pick.cpp)
+    void updateGCodeHover(const ImVec2& imageMin, const ImVec2& imageMax, bool imageHovered);
+    void updateZClipSlice(); // After the clip height or the program changes
+    void renderZClipSlice(const ImVec2& imageMin, const ImVec2& imageMax);
+
+    gcode::SpatialIndex m_gcodeIndex;
+    int m_hoverLine = -1;
+    std::function<void(int)> m_onGCodeLinePicked;
+    std::vector<u32> m_zSliceSegments; // Feed moves crossing the Z-clip plane
+    gcode::RegionStats m_zClipStats;   // Toolpath at or below the Z-clip plane
 
     // Tool color palette
     static constexpr int kNumToolColors = 8;
@@ -205,11 +231,34 @@ class ViewportPanel : public Panel {
     std::vector<float> m_segmentTimes;
     std::vector<float> m_segmentTimeCumulative;
 
+    // Persistent playback geometry (see gcode::SimPath)
+    gcode::SimPath m_simPath;
     GLuint m_simVAO = 0;
     GLuint m_simVBO = 0;
 
     void renderSimControls();
+    void buildSimGeometry();
     void destroySimGeometry();
+
+    // --- Stock material removal preview (viewport_panel_stock.cpp) ---
+    // Heightfield grid mesh; only rows touched since the last frame are
+    // rewritten into the vertex buffer.
+    void updateStockSimulation();
+    void renderStock();
+    void buildStockMesh();
+    void uploadStockRows(int row0, int row1);
+    void destroyStockGeometry();
+    void exportStockDeviation(const std::string& path);
+
+    carve::StockSimulator m_stockSim;
+    GPUMesh m_stockMesh;
+    std::map<int, carve::ToolProfile> m_simToolProfiles;
+    carve::ToolProfile m_simFallbackTool = carve::ToolProfile::flat(3.175f);
+    std::vector<Vertex> m_stockRowScratch;
+    bool m_showStock = true;
+    bool m_stockStale = true; // Program or tools changed; reset before next use
+    const carve::CarveJob* m_carveJob = nullptr;
+    FileDialog* m_fileDialog = nullptr;
 };
 
 } // namespace dw
@@ -0,0 +1,159 @@
+#include "viewport_panel.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include <imgui.h>
+
+namespace dw {
+
+// ---------------------------------------------------------------------------
+// G-code hover picking and Z-clip slicing
+// ---------------------------------------------------------------------------
+
+namespace {
+
+constexpr f32 kPickRadiusPx = 5.0f;
+constexpr u32 kMaxHighlightSegments = 4096;
+constexpr usize kMaxSliceSegments = 65536;
+
+// G-code (Z-up) <-> renderer (Y-up)
+Vec3 swapYZ(const Vec3& v) {
+    return Vec3{v.x, v.z, v.y};
+}
+
+// Program-space point to viewport image pixels; false when behind the camera
+bool toScreen(const Mat4& viewProj,
+              const Vec3& p,
+              const ImVec2& imageMin,
+              f32 width,
+              f32 height,
+              ImVec2& out) {
+    Vec4 clip = viewProj * Vec4{swapYZ(p), 1.0f};
+    if (clip.w <= 0.0f)
+        return false;
+    out = ImVec2(imageMin.x + (clip.x / clip.w * 0.5f + 0.5f) * width,
+                 imageMin.y + (0.5f - clip.y / clip.w * 0.5f) * height);
+    return true;
+}
+
+} // namespace
+
+void ViewportPanel::updateGCodeHover(const ImVec2& imageMin,
+                                     const ImVec2& imageMax,
+                                     bool imageHovered) {
+    m_hoverLine = -1;
+    if (!imageHovered || !m_showGCode || m_gcodeIndex.empty())
+        return;
+    // Not while orbiting/panning (a release frame already reports the button up)
+    if (ImGui::IsMouseDown(ImGuiMouseButton_Left) || ImGui::IsMouseDown(ImGuiMouseButton_Right) ||
+        ImGui::IsMouseDown(ImGuiMouseButton_Middle))
+        return;
+
+    const f32 width = imageMax.x - imageMin.x;
+    const f32 height = imageMax.y - imageMin.y;
+    if (width <= 1.0f || height <= 1.0f)
+        return;
+
+    // Mouse ray through the near and far planes, back in program coordinates
+    ImVec2 mouse = ImGui::GetIO().MousePos;
+    f32 ndcX = (mouse.x - imageMin.x) / width * 2.0f - 1.0f;
+    f32 ndcY = 1.0f - (mouse.y - imageMin.y) / height * 2.0f;
+    Mat4 viewProj = m_camera.viewProjectionMatrix();
+    Mat4 invViewProj = glm::inverse(viewProj);
+    Vec4 nearPt = invViewProj * Vec4{ndcX, ndcY, -1.0f, 1.0f};
+    Vec4 farPt = invViewProj * Vec4{ndcX, ndcY, 1.0f, 1.0f};
+    if (nearPt.w == 0.0f || farPt.w == 0.0f)
+        return;
+    Vec3 rayOrigin = swapYZ(Vec3(nearPt) / nearPt.w);
+    Vec3 rayDir = swapYZ(Vec3(farPt) / farPt.w) - rayOrigin;
+
+    // A few pixels at the orbit target distance
+    constexpr f32 kDeg2Rad = 3.14159265f / 180.0f;
+    f32 worldPerPixel =
+        2.0f * m_camera.distance() * std::tan(m_camera.fov() * 0.5f * kDeg2Rad) / height;
+    // Only what is drawn: Z-clip and the per-kind toggles
+    const gcode::LodBuildOptions visibility = gcodeDisplayOptions();
+    auto isShown = [&visibility](const gcode::PathSegment& seg) {
+        return gcode::isVisible(seg, gcode::classifyMove(seg), visibility);
+    };
+    auto hit = m_gcodeIndex.pickFiltered(rayOrigin, rayDir, kPickRadiusPx * worldPerPixel, isShown);
+    if (!hit)
+        return;
+
+    m_hoverLine = m_gcodeProgram.path[hit->segment].lineNumber;
+
+    // Highlight every segment the line produced (arcs expand to many)
+    auto range = m_gcodeIndex.segmentsForLine(m_hoverLine);
+    u32 last = std::min(range.last, range.first + kMaxHighlightSegments);
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    for (u32 i = range.first; i < last; ++i) {
+        const auto& seg = m_gcodeProgram.path[i];
+        ImVec2 a, b;
+        if (toScreen(viewProj, seg.start, imageMin, width, height, a) &&
+            toScreen(viewProj, seg.end, imageMin, width, height, b))
+            drawList->AddLine(a, b, IM_COL32(255, 220, 60, 255), 3.0f);
+    }
+
+    // Tooltip with the source text
+    usize cmdIndex = m_gcodeProgram.commandIndexAtLine(m_hoverLine);
+    if (cmdIndex < m_gcodeProgram.commands.size() &&
+        m_gcodeProgram.commands[cmdIndex].lineNumber == m_hoverLine) {
+        ImGui::SetTooltip("Line %d: %s",
+                          m_hoverLine,
+                          m_gcodeProgram.commands[cmdIndex].raw.c_str());
+    } else {
+        ImGui::SetTooltip("Line %d", m_hoverLine);
+    }
+
+    // Click without drag selects the line
+    if (ImGui::IsMouseReleased(ImGuiMouseButton_Left) &&
+        !ImGui::IsMouseDragPastThreshold(ImGuiMouseButton_Left) && m_onGCodeLinePicked) {
+        m_onGCodeLinePicked(m_hoverLine);
+    }
+}
+
+void ViewportPanel::updateZClipSlice() {
+    m_zSliceSegments.clear();
+    m_zClipStats = gcode::RegionStats{};
+    if (m_gcodeIndex.empty())
+        return;
+
+    m_zClipStats = m_gcodeIndex.measureBox(Vec3{-FLT_MAX}, Vec3{FLT_MAX, FLT_MAX, m_zClipMax});
+
+    // At the top of the program nothing is clipped, so there is no slice to show
+    if (m_zClipMax >= m_zClipMaxBound)
+        return;
+    m_gcodeIndex.queryZRange(m_zClipMax, m_zClipMax, m_zSliceSegments);
+    const auto& path = m_gcodeProgram.path;
+    m_zSliceSegments.erase(std::remove_if(m_zSliceSegments.begin(),
+                                          m_zSliceSegments.end(),
+                                          [&path](u32 i) { return path[i].isRapid; }),
+                           m_zSliceSegments.end());
+    if (m_zSliceSegments.size() > kMaxSliceSegments)
+        m_zSliceSegments.resize(kMaxSliceSegments);
+}
+
+void ViewportPanel::renderZClipSlice(const ImVec2& imageMin, const ImVec2& imageMax) {
+    if (!m_showGCode || m_zSliceSegments.empty())
+        return;
+    const f32 width = imageMax.x - imageMin.x;
+    const f32 height = imageMax.y - imageMin.y;
+    if (width <= 1.0f || height <= 1.0f)
+        return;
+
+    const Mat4 viewProj = m_camera.viewProjectionMatrix();
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    drawList->PushClipRect(imageMin, imageMax, true);
+    for (u32 i : m_zSliceSegments) {
+        const auto& seg = m_gcodeProgram.path[i];
+        ImVec2 a, b;
+        if (toScreen(viewProj, seg.start, imageMin, width, height, a) &&
+            toScreen(viewProj, seg.end, imageMin, width, height, b))
+            drawList->AddLine(a, b, IM_COL32(80, 220, 255, 255), 2.0f);
+    }
+    drawList->PopClipRect();
+}
+
+} // namespace dw
@@ -0,0 +1,171 @@
+#include "viewport_panel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+#include "../../core/carve/carve_job.h"
+#include "../../core/mesh/mesh.h"
+#include "../../render/gl_utils.h"
+#include "../widgets/toast.h"
+
+namespace dw {
+
+// ---------------------------------------------------------------------------
+// Stock material removal preview
+// ---------------------------------------------------------------------------
+
+void ViewportPanel::setSimToolProfiles(std::map<int, carve::ToolProfile> profiles,
+                                       const carve::ToolProfile& fallback) {
+    m_simToolProfiles = std::move(profiles);
+    m_simFallbackTool = fallback;
+    m_stockStale = true;
+}
+
+void ViewportPanel::updateStockSimulation() {
+    if (m_stockStale) {
+        destroyStockGeometry();
+
+        // Margin wide enough that the largest cutter never leaves the grid
+        f32 margin = m_simFallbackTool.radius;
+        for (const auto& [toolNumber, profile] : m_simToolProfiles)
+            margin = std::max(margin, profile.radius);
+
+        m_stockSim.reset(carve::StockConfig::fromProgram(m_gcodeProgram, margin));
+        m_stockSim.setProgram(m_gcodeProgram);
+        m_stockSim.setToolProfiles(m_simToolProfiles, m_simFallbackTool);
+        m_stockStale = false;
+    }
+    if (m_stockSim.empty())
+        return;
+
+    m_stockSim.simulateTo(m_simSegmentIndex, m_simSegmentProgress);
+    carve::DirtyRegion dirty = m_stockSim.takeDirtyRegion();
+
+    if (m_stockMesh.vao == 0) {
+        buildStockMesh();
+        return;
+    }
+    if (dirty.empty())
+        return;
+
+    // Normals read one cell either side, so neighbouring rows change too
+    uploadStockRows(std::max(dirty.row0 - 1, 0), std::min(dirty.row1 + 1, m_stockSim.rows()));
+}
+
+void ViewportPanel::renderStock() {
+    if (m_stockMesh.vao != 0)
+        m_renderer.renderMesh(m_stockMesh);
+}
+
+namespace {
+
+// Grid vertex in renderer space (G-code Z -> renderer Y) with a central
+// difference normal
+Vertex stockVertex(const carve::StockSimulator& sim, int col, int row) {
+    const f32 res = sim.resolution();
+    const Vec3 origin = sim.origin();
+    const int cols = sim.cols();
+    const int rows = sim.rows();
+
+    int c0 = std::max(col - 1, 0);
+    int c1 = std::min(col + 1, cols - 1);
+    int r0 = std::max(row - 1, 0);
+    int r1 = std::min(row + 1, rows - 1);
+    f32 gx = c1 > c0 ? (sim.at(c1, row) - sim.at(c0, row)) / (static_cast<f32>(c1 - c0) * res)
+                     : 0.0f;
+    f32 gy = r1 > r0 ? (sim.at(col, r1) - sim.at(col, r0)) / (static_cast<f32>(r1 - r0) * res)
+                     : 0.0f;
+
+    Vec3 pos{origin.x + static_cast<f32>(col) * res,
+             sim.at(col, row),
+             origin.y + static_cast<f32>(row) * res};
+    return Vertex(pos, glm::normalize(Vec3{-gx, 1.0f, -gy}));
+}
+
+} // namespace
+
+void ViewportPanel::buildStockMesh() {
+    const int cols = m_stockSim.cols();
+    const int rows = m_stockSim.rows();
+    if (cols < 2 || rows < 2)
+        return;
+
+    Mesh mesh;
+    mesh.reserve(static_cast<u32>(cols * rows), static_cast<u32>((cols - 1) * (rows - 1) * 6));
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c)
+            mesh.addVertex(stockVertex(m_stockSim, c, r));
+    }
+
+    // Counter-clockwise seen from above once Y and Z are swapped
+    for (int r = 0; r + 1 < rows; ++r) {
+        for (int c = 0; c + 1 < cols; ++c) {
+            u32 a = static_cast<u32>(r * cols + c);
+            u32 b = a + 1;
+            u32 d = a + static_cast<u32>(cols);
+            u32 e = d + 1;
+            mesh.addTriangle(a, e, b);
+            mesh.addTriangle(a, d, e);
+        }
+    }
+
+    m_stockMesh = m_renderer.uploadMesh(mesh);
+}
+
+void ViewportPanel::uploadStockRows(int row0, int row1) {
+    const int cols = m_stockSim.cols();
+    if (m_stockMesh.vbo == 0 || row1 <= row0)
+        return;
+
+    m_stockRowScratch.clear();
+    m_stockRowScratch.reserve(static_cast<usize>((row1 - row0) * cols));
+    for (int r = row0; r < row1; ++r) {
+        for (int c = 0; c < cols; ++c)
+            m_stockRowScratch.push_back(stockVertex(m_stockSim, c, r));
+    }
+
+    const usize firstVertex = static_cast<usize>(row0) * static_cast<usize>(cols);
+    GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, m_stockMesh.vbo));
+    GL_CHECK(glBufferSubData(GL_ARRAY_BUFFER,
+                             static_cast<GLintptr>(firstVertex * sizeof(Vertex)),
+                             static_cast<GLsizeiptr>(m_stockRowScratch.size() * sizeof(Vertex)),
+                             m_stockRowScratch.data()));
+    GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, 0));
+}
+
+void ViewportPanel::destroyStockGeometry() {
+    m_stockMesh.destroy();
+    m_stockRowScratch.clear();
+    m_stockRowScratch.shrink_to_fit();
+}
+
+void ViewportPanel::exportStockDeviation(const std::string& path) {
+    // Gouges deeper than this count as errors; the image saturates at the range
+    constexpr f32 kToleranceMm = 0.05f;
+    constexpr f32 kRangeMm = 1.0f;
+
+    if (!m_carveJob || m_carveJob->state() != carve::CarveJobState::Ready || m_stockSim.empty())
+        return;
+    const carve::Heightmap& target = m_carveJob->heightmap();
+
+    carve::DeviationStats stats;
+    (void)m_stockSim.deviationMap(target, kToleranceMm, &stats);
+    if (stats.comparedCells == 0) {
+        ToastManager::instance().show(ToastType::Warning, "No Overlap",
+            "The simulated stock does not cover the carve heightmap");
+        return;
+    }
+    if (!m_stockSim.exportDeviation(target, path, kRangeMm)) {
+        ToastManager::instance().show(ToastType::Error, "Export Failed", "Could not write " + path);
+        return;
+    }
+
+    char summary[160];
+    std::snprintf(summary, sizeof(summary), "%.3f to %+.3f mm, mean %.3f mm, %zu gouged cells",
+                  static_cast<double>(stats.minDeviation), static_cast<double>(stats.maxDeviation),
+                  static_cast<double>(stats.meanAbsDeviation), stats.gougeCells);
+    ToastManager::instance().show(ToastType::Success, "Deviation Exported", summary);
+}
+
+} // namespace dw
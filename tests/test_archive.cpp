@@ -5,7 +5,10 @@
 #include "core/archive/archive.h"
 #include "core/utils/file_utils.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <filesystem>
+#include <fstream>
 
 namespace {
 
@@ -30,6 +33,13 @@ class ArchiveTest : public ::testing::Test {
         ASSERT_TRUE(dw::file::writeText(path, content));
     }
 
+    const dw::ArchiveEntry* findEntry(const std::vector<dw::ArchiveEntry>& entries,
+                                      const std::string& path) {
+        auto it = std::find_if(entries.begin(), entries.end(),
+                               [&](const dw::ArchiveEntry& e) { return e.path == path; });
+        return it == entries.end() ? nullptr : &*it;
+    }
+
     std::filesystem::path m_baseDir;
     std::string m_srcDir;
     std::string m_outDir;
@@ -159,3 +169,119 @@ TEST_F(ArchiveTest, Extract_NonExistentArchive) {
     auto result = dw::ProjectArchive::extract("/nonexistent.dwp", m_outDir);
     EXPECT_FALSE(result.success);
 }
+
+// --- Version 2: indexed, streamed, compressed ---
+
+TEST_F(ArchiveTest, V2_CompressesLargeEntriesAndStoresPrecompressed) {
+    std::string text;
+    for (int i = 0; text.size() < 300 * 1024; ++i)
+        text += "G1 X" + std::to_string(i % 500) + " Y" + std::to_string(i % 250) + "\n";
+    createTestFile("gcode/job.nc", text);
+    createTestFile("thumb.png", "PNGDATA");
+
+    auto createResult = dw::ProjectArchive::create(m_archivePath, m_srcDir);
+    ASSERT_TRUE(createResult.success) << createResult.error;
+
+    auto entries = dw::ProjectArchive::list(m_archivePath);
+    ASSERT_EQ(entries.size(), 2u);
+    const auto* job = findEntry(entries, "gcode/job.nc");
+    ASSERT_NE(job, nullptr);
+    EXPECT_TRUE(job->compressed);
+    EXPECT_EQ(job->uncompressedSize, text.size());
+    EXPECT_LT(job->compressedSize * 4, job->uncompressedSize);
+    const auto* thumb = findEntry(entries, "thumb.png");
+    ASSERT_NE(thumb, nullptr);
+    EXPECT_FALSE(thumb->compressed);
+    EXPECT_EQ(thumb->compressedSize, 7u);
+
+    auto extractResult = dw::ProjectArchive::extract(m_archivePath, m_outDir);
+    ASSERT_TRUE(extractResult.success) << extractResult.error;
+    auto content = dw::file::readText(m_outDir + "/gcode/job.nc");
+    ASSERT_TRUE(content.has_value());
+    EXPECT_EQ(*content, text);
+}
+
+TEST_F(ArchiveTest, V2_ExtractSingleFile) {
+    createTestFile("a.txt", "Alpha");
+    createTestFile("sub/b.txt", "Bravo");
+    ASSERT_TRUE(dw::ProjectArchive::create(m_archivePath, m_srcDir).success);
+
+    auto result = dw::ProjectArchive::extractFile(m_archivePath, "sub/b.txt", m_outDir + "/b.txt");
+    ASSERT_TRUE(result.success) << result.error;
+    auto content = dw::file::readText(m_outDir + "/b.txt");
+    ASSERT_TRUE(content.has_value());
+    EXPECT_EQ(*content, "Bravo");
+    EXPECT_FALSE(dw::file::exists(m_outDir + "/a.txt"));
+
+    EXPECT_FALSE(
+        dw::ProjectArchive::extractFile(m_archivePath, "missing.txt", m_outDir + "/x").success);
+}
+
+TEST_F(ArchiveTest, V2_ChecksumDetectsCorruption) {
+    createTestFile("data.txt", "0123456789");
+    ASSERT_TRUE(
+        dw::ProjectArchive::create(m_archivePath, m_srcDir, dw::ArchiveCompression::None).success);
+
+    auto entries = dw::ProjectArchive::list(m_archivePath);
+    ASSERT_EQ(entries.size(), 1u);
+    EXPECT_FALSE(entries[0].compressed);
+    {
+        std::fstream f(m_archivePath, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(static_cast<std::streamoff>(entries[0].offset + 3));
+        f.put('X');
+    }
+
+    auto result = dw::ProjectArchive::extract(m_archivePath, m_outDir);
+    EXPECT_FALSE(result.success);
+    EXPECT_FALSE(dw::file::exists(m_outDir + "/data.txt"));
+}
+
+TEST_F(ArchiveTest, V2_RejectsOversizedEntryCount) {
+    createTestFile("data.txt", "0123456789");
+    ASSERT_TRUE(
+        dw::ProjectArchive::create(m_archivePath, m_srcDir, dw::ArchiveCompression::None).success);
+    {
+        // Trailer: toc_offset(8) + entry_count(4) + magic(4) at end of file
+        std::fstream f(m_archivePath, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(-8, std::ios::end);
+        const uint32_t count = 0xFFFFFFFFu;
+        f.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    }
+
+    EXPECT_TRUE(dw::ProjectArchive::list(m_archivePath).empty());
+    EXPECT_FALSE(dw::ProjectArchive::extract(m_archivePath, m_outDir).success);
+}
+
+TEST_F(ArchiveTest, V1_ArchivesRemainReadable) {
+    // Header + path_len + path + size + data, as written by version 1
+    {
+        std::ofstream out(m_archivePath, std::ios::binary);
+        const uint32_t header[4] = {0x44575000, 1, 2, 0};
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+        for (const std::string& name : {std::string("one.txt"), std::string("dir/two.txt")}) {
+            std::string data = "data:" + name;
+            uint32_t pathLen = static_cast<uint32_t>(name.size());
+            uint64_t size = data.size();
+            out.write(reinterpret_cast<const char*>(&pathLen), sizeof(pathLen));
+            out.write(name.data(), pathLen);
+            out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+            out.write(data.data(), static_cast<std::streamsize>(size));
+        }
+    }
+
+    EXPECT_TRUE(dw::ProjectArchive::isValidArchive(m_archivePath));
+    auto entries = dw::ProjectArchive::list(m_archivePath);
+    ASSERT_EQ(entries.size(), 2u);
+    EXPECT_EQ(entries[1].path, "dir/two.txt");
+    EXPECT_EQ(entries[1].uncompressedSize, 16u);
+
+    auto result = dw::ProjectArchive::extract(m_archivePath, m_outDir);
+    ASSERT_TRUE(result.success) << result.error;
+    auto content = dw::file::readText(m_outDir + "/dir/two.txt");
+    ASSERT_TRUE(content.has_value());
+    EXPECT_EQ(*content, "data:dir/two.txt");
+
+    auto single = dw::ProjectArchive::extractFile(m_archivePath, "one.txt", m_outDir + "/1.txt");
+    ASSERT_TRUE(single.success) << single.error;
+    EXPECT_EQ(*dw::file::readText(m_outDir + "/1.txt"), "data:one.txt");
+}
@@ -113,3 +113,116 @@ TEST(CarveJob, CancelMidCompute) {
     // Should be back to Idle (cancelled)
     EXPECT_EQ(job.state(), CarveJobState::Idle);
 }
+
+TEST(CarveJob, CoarsePreviewRefinesToFullResolution) {
+    CarveJob job;
+
+    std::vector<Vertex> verts;
+    std::vector<u32> indices;
+    makeFlatMesh(100.0f, 5.0f, verts, indices);
+
+    ModelFitter fitter;
+    fitter.setModelBounds(Vec3{0, 0, 0}, Vec3{100, 100, 5});
+
+    StockDimensions stock;
+    stock.width = 100.0f;
+    stock.height = 100.0f;
+    stock.thickness = 5.0f;
+    fitter.setStock(stock);
+
+    FitParams fp;
+    fp.scale = 1.0f;
+
+    HeightmapConfig hcfg;
+    hcfg.resolutionMm = 0.1f; // Fine enough that a coarse preview is built first
+
+    CarveJob::Preview preview;
+    EXPECT_FALSE(job.previewSince(0, preview));
+
+    job.startHeightmap(verts, indices, fitter, fp, hcfg);
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while (job.state() == CarveJobState::Computing) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            FAIL() << "CarveJob timed out";
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(job.state(), CarveJobState::Ready);
+
+    ASSERT_TRUE(job.previewSince(0, preview));
+    EXPECT_LE(preview.heightmap.cols(), CarveJob::kPreviewCells);
+    EXPECT_LE(preview.heightmap.rows(), CarveJob::kPreviewCells);
+    EXPECT_FLOAT_EQ(preview.refined, 1.0f);
+    EXPECT_NEAR(preview.heightmap.maxZ(), job.heightmap().maxZ(), 1e-4f);
+
+    // Nothing newer once the caller has seen the final revision
+    EXPECT_FALSE(job.previewSince(preview.revision, preview));
+}
+
+TEST(CarveJob, BackgroundToolpathMatchesBlocking) {
+    CarveJob job;
+
+    std::vector<Vertex> verts;
+    std::vector<u32> indices;
+    makeFlatMesh(20.0f, 5.0f, verts, indices);
+
+    ModelFitter fitter;
+    fitter.setModelBounds(Vec3{0, 0, 0}, Vec3{20, 20, 5});
+
+    StockDimensions stock;
+    stock.width = 20.0f;
+    stock.height = 20.0f;
+    stock.thickness = 5.0f;
+    fitter.setStock(stock);
+
+    FitParams fp;
+    fp.scale = 1.0f;
+
+    HeightmapConfig hcfg;
+    hcfg.resolutionMm = 0.25f;
+
+    job.startHeightmap(verts, indices, fitter, fp, hcfg);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (job.state() == CarveJobState::Computing) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            FAIL() << "CarveJob timed out";
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(job.state(), CarveJobState::Ready);
+    job.analyzeHeightmap(90.0f);
+
+    VtdbToolGeometry tool;
+    tool.tool_type = VtdbToolType::BallNose;
+    tool.diameter = 3.0;
+    ToolpathConfig config;
+    config.stepoverPreset = StepoverPreset::Fine;
+
+    // A cancelled run leaves nothing to collect
+    job.startToolpath(config, tool, nullptr);
+    job.cancelToolpath();
+    EXPECT_FALSE(job.toolpathBusy());
+    EXPECT_FALSE(job.collectToolpath());
+
+    job.startToolpath(config, tool, nullptr);
+    while (job.toolpathBusy()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            FAIL() << "Toolpath timed out";
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    ASSERT_TRUE(job.collectToolpath());
+    EXPECT_FLOAT_EQ(job.toolpathProgress(), 1.0f);
+    const auto background = job.toolpath().finishing.points;
+    ASSERT_FALSE(background.empty());
+    EXPECT_FALSE(job.collectToolpath());
+
+    job.generateToolpath(config, tool, nullptr);
+    const auto& blocking = job.toolpath().finishing.points;
+    ASSERT_EQ(background.size(), blocking.size());
+    for (size_t i = 0; i < blocking.size(); ++i) {
+        EXPECT_EQ(background[i].position, blocking[i].position);
+        EXPECT_EQ(background[i].rapid, blocking[i].rapid);
+    }
+}
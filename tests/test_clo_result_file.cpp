@@ -212,6 +212,44 @@ TEST_F(CloResultFileTest, WasteBreakdownPreserved) {
     EXPECT_EQ(w.scrapPieces[0].sheetIndex, 0);
 }
 
+TEST_F(CloResultFileTest, MixedStockPreserved) {
+    auto result = makeTestResult();
+    auto parts = makeTestParts();
+
+    auto& gr = result.groups[0];
+    Sheet small(1220.0f, 1220.0f, 25.0f);
+    small.name = "4x4 Plywood";
+    gr.sheetStock = {gr.usedSheet, small};
+
+    ASSERT_TRUE(m_file.save("Mixed Test", result, parts,
+                            "guillotine", true, 3.0f, 5.0f, {42}));
+
+    auto listing = m_file.list();
+    auto loaded = m_file.load(listing[0].filePath);
+    ASSERT_TRUE(loaded.has_value());
+
+    const auto& g = loaded->result.groups[0];
+    ASSERT_TRUE(g.mixedStock());
+    ASSERT_EQ(g.sheetStock.size(), 2u);
+    EXPECT_NEAR(g.stockFor(0).width, 2440.0f, 0.1f);
+    EXPECT_NEAR(g.stockFor(1).width, 1220.0f, 0.1f);
+    EXPECT_NEAR(g.stockFor(1).cost, 25.0f, 0.01f);
+    EXPECT_EQ(g.stockFor(1).name, "4x4 Plywood");
+}
+
+TEST_F(CloResultFileTest, UniformStockStaysUnmixed) {
+    auto result = makeTestResult();
+    auto parts = makeTestParts();
+
+    ASSERT_TRUE(m_file.save("Uniform Test", result, parts,
+                            "guillotine", true, 3.0f, 5.0f, {42}));
+
+    auto listing = m_file.list();
+    auto loaded = m_file.load(listing[0].filePath);
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_FALSE(loaded->result.groups[0].mixedStock());
+}
+
 TEST_F(CloResultFileTest, PartsWithMaterialId) {
     auto result = makeTestResult();
     std::vector<Part> parts;
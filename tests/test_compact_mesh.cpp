@@ -0,0 +1,143 @@
+// Digital Workshop - Compact Mesh Tests
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "core/carve/heightmap.h"
+#include "core/mesh/compact_mesh.h"
+#include "core/mesh/mesh.h"
+
+using namespace dw;
+
+namespace {
+
+// Unwelded triangle soup like binary STL produces (indices 0..n-1)
+Mesh makeSoup(int gridN, f32 size) {
+    Mesh mesh;
+    u32 next = 0;
+    f32 cell = size / static_cast<f32>(gridN);
+    for (int y = 0; y < gridN; ++y) {
+        for (int x = 0; x < gridN; ++x) {
+            f32 x0 = static_cast<f32>(x) * cell;
+            f32 y0 = static_cast<f32>(y) * cell;
+            f32 z = std::sin(x0 * 0.1f) * 5.0f + 5.0f;
+            Vec3 n{0.0f, 0.0f, 1.0f};
+            Vec3 a{x0, y0, z};
+            Vec3 b{x0 + cell, y0, z};
+            Vec3 c{x0 + cell, y0 + cell, z};
+            Vec3 d{x0, y0 + cell, z};
+            for (const Vec3& p : {a, b, c, a, c, d}) {
+                mesh.addVertex(Vertex(p, n));
+            }
+            mesh.addTriangle(next, next + 1, next + 2);
+            mesh.addTriangle(next + 3, next + 4, next + 5);
+            next += 6;
+        }
+    }
+    mesh.recalculateBounds();
+    return mesh;
+}
+
+f32 angleDeg(const Vec3& a, const Vec3& b) {
+    f32 d = std::clamp(a.x * b.x + a.y * b.y + a.z * b.z, -1.0f, 1.0f);
+    return std::acos(d) * 57.29578f;
+}
+
+} // namespace
+
+TEST(CompactMesh, HalfFloatRoundTrip) {
+    for (f32 v : {0.0f, 1.0f, -2.5f, 0.333f, 1024.0f, 6.1e-5f, -65504.0f}) {
+        f32 back = quant::halfToFloat(quant::floatToHalf(v));
+        EXPECT_NEAR(back, v, std::fabs(v) * 1e-3f + 1e-7f) << v;
+    }
+    EXPECT_TRUE(std::isinf(quant::halfToFloat(quant::floatToHalf(1e6f))));
+}
+
+TEST(CompactMesh, OctahedralNormalsWithinOneDegree) {
+    f32 worst = 0.0f;
+    for (int i = 0; i < 2000; ++i) {
+        f32 t = static_cast<f32>(i) * 0.0137f;
+        Vec3 n{std::sin(t * 3.1f) * std::cos(t), std::sin(t * 3.1f) * std::sin(t),
+               std::cos(t * 3.1f)};
+        worst = std::max(worst, angleDeg(n, quant::decodeOctahedral(quant::encodeOctahedral(n))));
+    }
+    EXPECT_LT(worst, 1.0f);
+
+    Vec3 down = quant::decodeOctahedral(quant::encodeOctahedral(Vec3{0.0f, 0.0f, -1.0f}));
+    EXPECT_NEAR(down.z, -1.0f, 1e-4f);
+}
+
+TEST(CompactMesh, PositionsWithinQuantizationError) {
+    Mesh mesh = makeSoup(16, 200.0f);
+    CompactMesh compact = CompactMesh::fromMesh(mesh);
+
+    ASSERT_EQ(compact.vertexCount(), mesh.vertexCount());
+    EXPECT_EQ(compact.triangleCount(), mesh.triangleCount());
+    EXPECT_TRUE(compact.hasImplicitIndices());
+    EXPECT_TRUE(compact.hasNormals());
+    EXPECT_FALSE(compact.hasTexCoords());
+
+    f32 tol = compact.maxPositionError() + 1e-5f;
+    for (u32 i = 0; i < mesh.vertexCount(); ++i) {
+        Vec3 p = compact.position(i);
+        const Vec3& ref = mesh.vertices()[i].position;
+        EXPECT_NEAR(p.x, ref.x, tol);
+        EXPECT_NEAR(p.y, ref.y, tol);
+        EXPECT_NEAR(p.z, ref.z, tol);
+    }
+}
+
+TEST(CompactMesh, AtLeastThreeTimesSmallerForSoup) {
+    Mesh mesh = makeSoup(64, 100.0f);
+    CompactMesh compact = CompactMesh::fromMesh(mesh);
+    usize full = mesh.vertices().size() * sizeof(Vertex) + mesh.indices().size() * sizeof(u32);
+    EXPECT_GE(full, compact.memoryBytes() * 3);
+}
+
+TEST(CompactMesh, DecodeKeepsTopologyAndUVs) {
+    Mesh mesh;
+    mesh.addVertex(Vertex(Vec3{0, 0, 0}, Vec3{0, 0, 1}, Vec2{0.25f, 0.75f}));
+    mesh.addVertex(Vertex(Vec3{1, 0, 0}, Vec3{0, 0, 1}, Vec2{1.0f, 0.0f}));
+    mesh.addVertex(Vertex(Vec3{0, 1, 0}, Vec3{0, 0, 1}, Vec2{0.0f, 1.0f}));
+    mesh.addTriangle(0, 2, 1);
+    mesh.addTriangle(0, 1, 2);
+
+    CompactMesh compact = CompactMesh::fromMesh(mesh);
+    EXPECT_FALSE(compact.hasImplicitIndices());
+    EXPECT_TRUE(compact.hasTexCoords());
+
+    Mesh decoded = compact.decode();
+    EXPECT_EQ(decoded.indices(), mesh.indices());
+    EXPECT_FLOAT_EQ(decoded.vertices()[0].texCoord.x, 0.25f);
+    EXPECT_FLOAT_EQ(decoded.vertices()[0].texCoord.y, 0.75f);
+    EXPECT_NEAR(decoded.vertices()[1].normal.z, 1.0f, 1e-4f);
+}
+
+TEST(CompactMesh, DecodeRangeClampsCount) {
+    Mesh mesh = makeSoup(2, 10.0f);
+    CompactMesh compact = CompactMesh::fromMesh(mesh);
+    std::vector<Vertex> out(4);
+    compact.decodeRange(compact.vertexCount() - 2, 100, out.data());
+    EXPECT_NEAR(out[1].position.x, mesh.vertices().back().position.x, 1e-3f);
+}
+
+TEST(CompactMesh, HeightmapMatchesFullPrecisionBuild) {
+    Mesh mesh = makeSoup(32, 50.0f);
+    CompactMesh compact = CompactMesh::fromMesh(mesh);
+    carve::HeightmapConfig cfg;
+    cfg.resolutionMm = 1.0f;
+
+    carve::Heightmap full;
+    full.build(mesh.vertices(), mesh.indices(), mesh.bounds().min, mesh.bounds().max, cfg);
+    carve::Heightmap fromCompact;
+    fromCompact.build(compact, compact.bounds().min, compact.bounds().max, cfg);
+
+    ASSERT_EQ(full.cols(), fromCompact.cols());
+    ASSERT_EQ(full.rows(), fromCompact.rows());
+    for (int r = 0; r < full.rows(); r += 5) {
+        for (int c = 0; c < full.cols(); c += 5) {
+            EXPECT_NEAR(full.at(c, r), fromCompact.at(c, r), 0.01f);
+        }
+    }
+}
@@ -1,7 +1,10 @@
 #include "core/carve/gcode_export.h"
+#include "core/gcode/gcode_parser.h"
+#include "core/threading/parallel_for.h"
 
 #include <gtest/gtest.h>
 
+#include <cmath>
 #include <cstdio>
 #include <filesystem>
 #include <fstream>
@@ -55,6 +58,25 @@ MultiPassToolpath makeTestToolpathWithClearing()
     return mp;
 }
 
+// Long zigzag finishing path: rapids between lines, cuts along them
+MultiPassToolpath makeLongToolpath(int lines, int pointsPerLine)
+{
+    MultiPassToolpath mp;
+    auto& points = mp.finishing.points;
+    for (int line = 0; line < lines; ++line) {
+        const f32 y = static_cast<f32>(line) * 0.4f;
+        points.push_back({Vec3{0.0f, y, 5.0f}, true});
+        for (int i = 0; i < pointsPerLine; ++i) {
+            const f32 x = static_cast<f32>(i) * 0.1f;
+            const f32 z = -1.0f + 0.5f * std::sin(x * 0.3f) * std::cos(y * 0.2f);
+            points.push_back({Vec3{x, y, z}, false});
+        }
+        points.push_back({Vec3{points.back().position.x, y, 5.0f}, true});
+    }
+    mp.finishing.lineCount = static_cast<int>(points.size());
+    return mp;
+}
+
 ToolpathConfig makeTestConfig()
 {
     ToolpathConfig cfg;
@@ -228,3 +250,67 @@ TEST(GcodeExport, FeedRateOnlyOnFirstFeedMove)
     }
     EXPECT_EQ(fCount, 1u);
 }
+
+TEST(GcodeExport, ModalWordsSuppressed)
+{
+    auto tp = makeTestToolpath();
+    auto cfg = makeTestConfig();
+
+    std::string gcode = generateGcode(tp, cfg, "test", "tool");
+
+    // Cut at (20, 0, -2) follows (10, 0, -1): G1 and Y are already modal
+    EXPECT_NE(gcode.find("\nX20.0 Z-2.0\n"), std::string::npos) << gcode;
+    EXPECT_EQ(gcode.find("G1 X20.0"), std::string::npos);
+}
+
+TEST(GcodeExport, ParsesBackToToolpath)
+{
+    auto tp = makeTestToolpathWithClearing();
+    auto cfg = makeTestConfig();
+
+    gcode::Parser parser;
+    auto program = parser.parse(generateGcode(tp, cfg, "test", "tool"));
+
+    // Every toolpath point is reached, in order, at the output precision
+    std::vector<ToolpathPoint> expected = tp.clearing.points;
+    expected.insert(expected.end(), tp.finishing.points.begin(), tp.finishing.points.end());
+    size_t next = 0;
+    for (const auto& seg : program.path) {
+        if (next < expected.size() && glm::length(seg.end - expected[next].position) < 1e-3f &&
+            seg.isRapid == expected[next].rapid)
+            ++next;
+    }
+    EXPECT_EQ(next, expected.size());
+}
+
+TEST(GcodeExport, ParallelChunksMatchSerial)
+{
+    // Enough points for several parallel chunks
+    auto tp = makeLongToolpath(60, 1200);
+    tp.clearing = makeLongToolpath(3, 50).finishing;
+    auto cfg = makeTestConfig();
+
+    dw::setParallelThreadCount(1);
+    const std::string serial = generateGcode(tp, cfg, "test", "tool");
+    dw::setParallelThreadCount(4);
+    const std::string parallel = generateGcode(tp, cfg, "test", "tool");
+    dw::setParallelThreadCount(0);
+    EXPECT_EQ(serial, parallel);
+
+    // One line per point plus the fixed lines around the passes
+    size_t lines = 0;
+    for (char c : serial)
+        if (c == '\n') ++lines;
+    EXPECT_EQ(lines, tp.clearing.points.size() + tp.finishing.points.size() + 12);
+
+    // The file gets the same bytes
+    std::string tmpPath = std::filesystem::temp_directory_path().string()
+                          + "/dw_test_gcode_export_long.nc";
+    ASSERT_TRUE(exportGcode(tmpPath, tp, cfg, "test", "tool"));
+    std::ifstream file(tmpPath, std::ios::binary);
+    std::string content((std::istreambuf_iterator<char>(file)),
+                         std::istreambuf_iterator<char>());
+    file.close();
+    std::filesystem::remove(tmpPath);
+    EXPECT_EQ(content, serial);
+}
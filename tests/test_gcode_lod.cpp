@@ -0,0 +1,269 @@
+// Digital Workshop - G-code Level-of-Detail Geometry Tests
+
+#include <gtest/gtest.h>
+
+#include "core/gcode/gcode_lod.h"
+#include "core/threading/parallel_for.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+using dw::f32;
+using dw::u32;
+using dw::Vec3;
+using dw::gcode::LodBuildOptions;
+using dw::gcode::LodGeometry;
+using dw::gcode::MoveKind;
+
+dw::gcode::PathSegment seg(Vec3 a, Vec3 b, bool rapid = false, int tool = 1) {
+    dw::gcode::PathSegment s;
+    s.start = a;
+    s.end = b;
+    s.isRapid = rapid;
+    s.toolNumber = tool;
+    return s;
+}
+
+// Finishing-style raster: long rows of tiny, gently curved connected moves
+dw::gcode::Program denseRaster(int rows, int pointsPerRow) {
+    dw::gcode::Program program;
+    for (int r = 0; r < rows; ++r) {
+        f32 y = static_cast<f32>(r) * 0.5f;
+        Vec3 prev{0.0f, y, -1.0f};
+        for (int i = 1; i < pointsPerRow; ++i) {
+            f32 x = static_cast<f32>(i) * 0.05f;
+            Vec3 next{x, y, -1.0f - 0.5f * std::sin(x * 0.2f)};
+            program.path.push_back(seg(prev, next));
+            prev = next;
+        }
+        program.path.push_back(seg(prev, Vec3{0.0f, y + 0.5f, -1.0f}, true));
+    }
+    return program;
+}
+
+// OpenGL-style perspective looking down -Z, content pushed `distance` away
+dw::Mat4 viewProjection(f32 distance, f32 fovDeg = 45.0f) {
+    f32 f = 1.0f / std::tan(fovDeg * 0.5f * 3.14159265f / 180.0f);
+    f32 nearP = 0.1f;
+    f32 farP = 100000.0f;
+    dw::Mat4 proj(0.0f);
+    proj[0][0] = f;
+    proj[1][1] = f;
+    proj[2][2] = (farP + nearP) / (nearP - farP);
+    proj[2][3] = -1.0f;
+    proj[3][2] = 2.0f * farP * nearP / (nearP - farP);
+    dw::Mat4 view(1.0f);
+    view[3] = dw::Vec4{0.0f, 0.0f, -distance, 1.0f};
+    return proj * view;
+}
+
+} // namespace
+
+TEST(GcodeLod, ClassifyMove) {
+    EXPECT_EQ(dw::gcode::classifyMove(seg({0, 0, 5}, {10, 0, 5}, true)), MoveKind::Rapid);
+    EXPECT_EQ(dw::gcode::classifyMove(seg({0, 0, 0}, {10, 0, -1})), MoveKind::Cut);
+    EXPECT_EQ(dw::gcode::classifyMove(seg({0, 0, 0}, {0.1f, 0, -2})), MoveKind::Plunge);
+    EXPECT_EQ(dw::gcode::classifyMove(seg({0, 0, -2}, {0, 0, 3})), MoveKind::Retract);
+}
+
+TEST(GcodeLod, SimplifyPolylineRespectsTolerance) {
+    std::vector<Vec3> line;
+    for (int i = 0; i <= 100; ++i)
+        line.push_back(Vec3{static_cast<f32>(i), 0.0f, 0.0f});
+    std::vector<u32> keep;
+    dw::gcode::simplifyPolyline(line, 0.01f, keep);
+    EXPECT_EQ(keep, (std::vector<u32>{0, 100}));
+
+    // Sine wave: every dropped point stays within tolerance of the result
+    std::vector<Vec3> wave;
+    for (int i = 0; i <= 400; ++i) {
+        f32 x = static_cast<f32>(i) * 0.05f;
+        wave.push_back(Vec3{x, std::sin(x), 0.0f});
+    }
+    const f32 tolerance = 0.02f;
+    dw::gcode::simplifyPolyline(wave, tolerance, keep);
+    EXPECT_LT(keep.size(), wave.size() / 4);
+    ASSERT_EQ(keep.front(), 0u);
+    ASSERT_EQ(keep.back(), 400u);
+    for (size_t k = 1; k < keep.size(); ++k) {
+        Vec3 a = wave[keep[k - 1]];
+        Vec3 b = wave[keep[k]];
+        for (u32 i = keep[k - 1] + 1; i < keep[k]; ++i) {
+            Vec3 ab = b - a;
+            f32 t = std::clamp(glm::dot(wave[i] - a, ab) / glm::dot(ab, ab), 0.0f, 1.0f);
+            EXPECT_LE(glm::length(wave[i] - (a + ab * t)), tolerance + 1e-5f);
+        }
+    }
+
+    dw::gcode::simplifyPolyline(wave, 0.0f, keep);
+    EXPECT_EQ(keep.size(), wave.size());
+}
+
+TEST(GcodeLod, FiltersAndGroupsByKind) {
+    dw::gcode::Program program;
+    program.path.push_back(seg({0, 0, 5}, {10, 0, 5}, true));
+    program.path.push_back(seg({10, 0, 5}, {10, 0, -1}));  // Plunge
+    program.path.push_back(seg({10, 0, -1}, {20, 0, -1})); // Cut
+    program.path.push_back(seg({20, 0, -1}, {20, 0, 5}));  // Retract
+    program.path.push_back(seg({20, 0, 5}, {30, 0, 9}));   // Cut above the clip
+
+    LodBuildOptions options;
+    options.showRapids = false;
+    options.zClipMax = 6.0f;
+    LodGeometry lod;
+    lod.build(program, options);
+
+    ASSERT_EQ(lod.groups().size(), 3u);
+    EXPECT_EQ(lod.groups()[0].kind, MoveKind::Cut);
+    EXPECT_EQ(lod.groups()[1].kind, MoveKind::Plunge);
+    EXPECT_EQ(lod.groups()[2].kind, MoveKind::Retract);
+    EXPECT_EQ(lod.chunks().size(), 3u);
+    for (const auto& chunk : lod.chunks())
+        EXPECT_EQ(chunk.count[0], 2u);
+
+    // Renderer space: G-code Z becomes Y
+    const auto& cut = lod.chunks()[0];
+    EXPECT_FLOAT_EQ(cut.boundsMin.x, 10.0f);
+    EXPECT_FLOAT_EQ(cut.boundsMin.y, -1.0f);
+    EXPECT_FLOAT_EQ(cut.boundsMax.x, 20.0f);
+}
+
+TEST(GcodeLod, GroupsByTool) {
+    dw::gcode::Program program;
+    program.path.push_back(seg({0, 0, 5}, {10, 0, 5}, true, 1));
+    program.path.push_back(seg({0, 0, -1}, {10, 0, -1}, false, 3));
+    program.path.push_back(seg({0, 1, -1}, {10, 1, -1}, false, 1));
+
+    LodBuildOptions options;
+    options.showRapids = true;
+    options.groupByTool = true;
+    LodGeometry lod;
+    lod.build(program, options);
+
+    ASSERT_EQ(lod.groups().size(), 3u);
+    EXPECT_EQ(lod.groups()[0].kind, MoveKind::Rapid);
+    EXPECT_EQ(lod.groups()[1].toolNumber, 1);
+    EXPECT_EQ(lod.groups()[2].toolNumber, 3);
+}
+
+TEST(GcodeLod, CoarseLevelsShrinkDenseToolpaths) {
+    auto program = denseRaster(40, 2000);
+    LodGeometry lod;
+    lod.build(program, LodBuildOptions{});
+
+    dw::usize exact = 0;
+    dw::usize coarse = 0;
+    for (const auto& chunk : lod.chunks()) {
+        exact += chunk.count[0];
+        coarse += chunk.count[dw::gcode::LodChunk::kLevels - 1];
+    }
+    EXPECT_EQ(exact, 40u * 1999u * 2u);
+    EXPECT_LT(coarse * 20, exact);
+    EXPECT_EQ(lod.minLevel(), 0);
+    EXPECT_EQ(lod.vertices().size(), lod.vertexCount() * 3);
+}
+
+TEST(GcodeLod, VertexBudgetDropsFinestLevels) {
+    auto program = denseRaster(40, 2000);
+    LodBuildOptions options;
+    options.maxVertices = 20000;
+    LodGeometry lod;
+    lod.build(program, options);
+
+    EXPECT_GT(lod.minLevel(), 0);
+    EXPECT_LE(lod.vertexCount(), options.maxVertices);
+    for (const auto& chunk : lod.chunks()) {
+        EXPECT_EQ(chunk.first[0], chunk.first[static_cast<size_t>(lod.minLevel())]);
+        EXPECT_LE(chunk.first[0] + chunk.count[0], lod.vertexCount());
+    }
+}
+
+TEST(GcodeLod, VertexBudgetKeepsCoarsestLevel) {
+    // Budget below even the coarsest level: geometry is kept, not dropped
+    auto program = denseRaster(40, 2000);
+    LodBuildOptions options;
+    options.maxVertices = 16;
+    LodGeometry lod;
+    lod.build(program, options);
+
+    constexpr int coarsest = dw::gcode::LodChunk::kLevels - 1;
+    EXPECT_EQ(lod.minLevel(), coarsest);
+    EXPECT_GT(lod.vertexCount(), options.maxVertices);
+    for (const auto& chunk : lod.chunks())
+        EXPECT_GT(chunk.count[coarsest], 0u);
+}
+
+TEST(GcodeLod, SelectsLevelByDistanceAndCullsOffscreen) {
+    auto program = denseRaster(4, 2000); // ~100 mm rows
+    LodBuildOptions options;
+    options.chunkSegments = 100000; // One chunk per group
+    LodGeometry lod;
+    lod.build(program, options);
+    ASSERT_FALSE(lod.chunks().empty());
+    const auto& chunk = lod.chunks()[0];
+
+    dw::gcode::LodView view;
+    view.pixelsPerUnit = 1000.0f / (2.0f * std::tan(22.5f * 3.14159265f / 180.0f));
+
+    view.viewProj = viewProjection(150.0f);
+    EXPECT_EQ(lod.selectLevel(chunk, view), 0);
+
+    view.viewProj = viewProjection(50000.0f);
+    EXPECT_EQ(lod.selectLevel(chunk, view), dw::gcode::LodChunk::kLevels - 1);
+
+    // Content behind the camera
+    view.viewProj = viewProjection(-500.0f);
+    EXPECT_EQ(lod.selectLevel(chunk, view), -1);
+
+    std::vector<dw::gcode::LodDrawBatch> batches;
+    lod.selectDraws(view, batches);
+    ASSERT_EQ(batches.size(), lod.groups().size());
+    for (const auto& batch : batches)
+        EXPECT_TRUE(batch.empty());
+}
+
+TEST(GcodeLod, AdjacentChunksMergeIntoOneRange) {
+    auto program = denseRaster(20, 500);
+    LodBuildOptions options;
+    options.chunkSegments = 256;
+    LodGeometry lod;
+    lod.build(program, options);
+    ASSERT_GT(lod.chunks().size(), 4u);
+
+    // Full detail everywhere: one contiguous level-0 range
+    dw::gcode::LodView view;
+    view.pixelsPerUnit = 1.0e6f;
+    view.viewProj = viewProjection(200.0f);
+    std::vector<dw::gcode::LodDrawBatch> batches;
+    lod.selectDraws(view, batches);
+    ASSERT_FALSE(batches.empty());
+    EXPECT_EQ(batches[0].first.size(), 1u);
+    EXPECT_EQ(batches[0].count[0], 20 * 499 * 2);
+
+    // Everything tiny: coarse ranges, mostly merged
+    view.pixelsPerUnit = 1000.0f;
+    view.viewProj = viewProjection(50000.0f);
+    lod.selectDraws(view, batches);
+    EXPECT_LT(batches[0].first.size(), lod.chunks().size() - 1);
+}
+
+TEST(GcodeLod, BuildIndependentOfThreadCount) {
+    auto program = denseRaster(30, 3000);
+    dw::setParallelThreadCount(1);
+    LodGeometry a;
+    a.build(program, LodBuildOptions{});
+    dw::setParallelThreadCount(4);
+    LodGeometry b;
+    b.build(program, LodBuildOptions{});
+    dw::setParallelThreadCount(0);
+
+    EXPECT_EQ(a.vertices(), b.vertices());
+    ASSERT_EQ(a.chunks().size(), b.chunks().size());
+    for (size_t i = 0; i < a.chunks().size(); ++i) {
+        EXPECT_EQ(a.chunks()[i].first, b.chunks()[i].first);
+        EXPECT_EQ(a.chunks()[i].count, b.chunks()[i].count);
+    }
+}
@@ -3,6 +3,10 @@
 #include <gtest/gtest.h>
 
 #include "core/gcode/gcode_modal_scanner.h"
+#include "core/gcode/gcode_parser.h"
+#include "core/gcode/gcode_writer.h"
+
+#include <sstream>
 
 using namespace dw;
 
@@ -285,3 +289,124 @@ TEST(GCodeModalScanner, RealisticProgram) {
     EXPECT_EQ(endState.spindleState, "M5");
     EXPECT_EQ(endState.coolantState, "M9");
 }
+
+// Test 16: Motion mode and program position are tracked
+TEST(GCodeModalScanner, TracksMotionModeAndPosition) {
+    std::vector<std::string> program = {
+        "G90 G21",
+        "G0 X10 Y20 Z5",
+        "G1 Z-1 F300",
+        "X15",
+        "G53 G0 Z0",     // Machine coordinates: not a program position
+        "G91",
+        "G1 Y2.5 Z-0.5",
+    };
+
+    auto state = GCodeModalScanner::scanToLine(program, 4);
+    EXPECT_EQ(state.motionMode, "G1");
+    ASSERT_TRUE(state.position[0] && state.position[1] && state.position[2]);
+    EXPECT_FLOAT_EQ(*state.position[0], 15.0f);
+    EXPECT_FLOAT_EQ(*state.position[1], 20.0f);
+    EXPECT_FLOAT_EQ(*state.position[2], -1.0f);
+    EXPECT_FLOAT_EQ(state.clearanceZ.value_or(0.0f), 5.0f);
+
+    state = GCodeModalScanner::scanToLine(program, 100);
+    EXPECT_FLOAT_EQ(*state.position[0], 15.0f);
+    EXPECT_FLOAT_EQ(*state.position[1], 22.5f);
+    EXPECT_FLOAT_EQ(*state.position[2], -1.5f);
+
+    // Nothing given yet: no reposition in the preamble
+    state = GCodeModalScanner::scanToLine(program, 1);
+    EXPECT_FALSE(state.position[0] || state.position[1] || state.position[2]);
+    EXPECT_EQ(state.toPreamble().size(), 5u);
+}
+
+// Test 17: toPreamble repositions before restoring incremental and rapid modes
+TEST(GCodeModalScanner, ToPreambleRepositionsSafely) {
+    ModalState state;
+    state.distanceMode = "G91";
+    state.motionMode = "G0";
+    state.feedRate = 600.0f;
+    state.spindleSpeed = 12000.0f;
+    state.spindleState = "M3";
+    state.position[0] = 12.5f;
+    state.position[1] = -3.0f;
+    state.position[2] = -2.0f;
+    state.clearanceZ = 6.0f;
+
+    const std::vector<std::string> expected = {
+        "G21", "G54", "G90", "F600", "S12000", "M3", "M9",
+        "G0 Z6.0", "G0 X12.5 Y-3.0", "G1 Z-2.0 F600.0", "G91", "G0",
+    };
+    EXPECT_EQ(state.toPreamble(), expected);
+}
+
+// Test 18: Resuming a writer-produced file mid-pass runs the remaining moves
+// exactly as the full program does
+TEST(GCodeModalScanner, ResumeWriterOutputMidPass) {
+    gcode::GcodeWriter writer;
+    writer.line("G21");
+    writer.line("G90");
+    writer.line("M3 S12000");
+    writer.retractTo(5.0f);
+    writer.rapid({0.0f, 0.0f, 5.0f});
+    writer.linear({0.0f, 0.0f, -1.25f}, 300.0f);
+    writer.linear({10.0f, 0.0f, -1.25f}, 1200.0f);
+    writer.linear({10.0f, 4.0f, -1.25f}, 1200.0f);
+    writer.linear({0.0f, 4.0f, -1.5f}, 1200.0f);
+    writer.linear({0.0f, 8.0f, -1.5f}, 1200.0f);
+    writer.retractTo(5.0f);
+
+    std::vector<std::string> lines;
+    std::istringstream in(writer.text());
+    for (std::string line; std::getline(in, line);)
+        lines.push_back(line);
+
+    // Resume at "Y4.0": modal-suppressed, no motion word, X and Z implied
+    const int resumeIndex = 7;
+    ASSERT_EQ(lines[resumeIndex], "Y4.0");
+
+    auto state = GCodeModalScanner::scanToLine(lines, resumeIndex);
+    std::string resumed;
+    for (const auto& line : state.toPreamble())
+        resumed += line + "\n";
+    const usize preambleLines = state.toPreamble().size();
+    for (usize i = resumeIndex; i < lines.size(); ++i)
+        resumed += lines[i] + "\n";
+
+    gcode::Parser parser;
+    const auto full = parser.parse(writer.text());
+    const auto partial = parser.parse(resumed);
+
+    // Preamble reaches the resume point through the clearance height
+    std::vector<gcode::PathSegment> approach;
+    for (const auto& seg : partial.path) {
+        if (seg.lineNumber <= static_cast<int>(preambleLines))
+            approach.push_back(seg);
+    }
+    ASSERT_FALSE(approach.empty());
+    EXPECT_FLOAT_EQ(approach.front().end.z, 5.0f);
+    EXPECT_FALSE(approach.back().isRapid);
+    EXPECT_FLOAT_EQ(approach.back().end.x, 10.0f);
+    EXPECT_FLOAT_EQ(approach.back().end.y, 0.0f);
+    EXPECT_FLOAT_EQ(approach.back().end.z, -1.25f);
+
+    // Every resumed move matches the original one
+    std::vector<gcode::PathSegment> expected;
+    for (const auto& seg : full.path) {
+        if (seg.lineNumber > resumeIndex)
+            expected.push_back(seg);
+    }
+    ASSERT_EQ(partial.path.size(), approach.size() + expected.size());
+    for (usize i = 0; i < expected.size(); ++i) {
+        const auto& got = partial.path[approach.size() + i];
+        EXPECT_EQ(got.isRapid, expected[i].isRapid) << i;
+        EXPECT_FLOAT_EQ(got.start.x, expected[i].start.x) << i;
+        EXPECT_FLOAT_EQ(got.start.y, expected[i].start.y) << i;
+        EXPECT_FLOAT_EQ(got.start.z, expected[i].start.z) << i;
+        EXPECT_FLOAT_EQ(got.end.x, expected[i].end.x) << i;
+        EXPECT_FLOAT_EQ(got.end.y, expected[i].end.y) << i;
+        EXPECT_FLOAT_EQ(got.end.z, expected[i].end.z) << i;
+        EXPECT_FLOAT_EQ(got.feedRate, expected[i].feedRate) << i;
+    }
+}
@@ -145,3 +145,22 @@ TEST(GcodeParser, InlineCommentStripped) {
     EXPECT_EQ(program.commands[0].type, dw::gcode::CommandType::G0);
     EXPECT_FLOAT_EQ(program.commands[0].x, 10.0f);
 }
+
+TEST(GcodeParser, CommandIndexAtLineSkipsBlankAndCommentLines) {
+    dw::gcode::Parser parser;
+    auto program = parser.parse("; header\n"
+                                "G21\n"
+                                "\n"
+                                "(setup)\n"
+                                "G0 X1\n"
+                                "G1 X2 F100\n");
+
+    ASSERT_EQ(program.commands.size(), 3u);
+    EXPECT_EQ(program.commandIndexAtLine(1), 0u); // Comment: next command
+    EXPECT_EQ(program.commandIndexAtLine(2), 0u);
+    EXPECT_EQ(program.commandIndexAtLine(3), 1u);
+    EXPECT_EQ(program.commandIndexAtLine(5), 1u);
+    EXPECT_EQ(program.commands[1].lineNumber, 5);
+    EXPECT_EQ(program.commandIndexAtLine(6), 2u);
+    EXPECT_EQ(program.commandIndexAtLine(7), 3u);
+}
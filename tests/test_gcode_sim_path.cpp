@@ -0,0 +1,92 @@
+// Digital Workshop - G-code Simulation Path Tests
+
+#include <gtest/gtest.h>
+
+#include "core/gcode/gcode_parser.h"
+#include "core/gcode/gcode_sim_path.h"
+
+namespace {
+
+dw::gcode::PathSegment seg(dw::Vec3 a, dw::Vec3 b) {
+    dw::gcode::PathSegment s;
+    s.start = a;
+    s.end = b;
+    return s;
+}
+
+} // namespace
+
+TEST(GcodeSimPath, EmptyProgram) {
+    dw::gcode::SimPath sim;
+    sim.build(dw::gcode::Program{}, 100.0f);
+    EXPECT_EQ(sim.segmentCount(), 0u);
+    EXPECT_EQ(sim.completedVertices(0), 0u);
+    EXPECT_EQ(sim.completedVertices(5), 0u);
+    EXPECT_EQ(sim.partialVertex(), 0u);
+    EXPECT_EQ(sim.vertices.size(), 6u); // Tail only
+}
+
+TEST(GcodeSimPath, PrefixCountsMatchProgramOrder) {
+    dw::gcode::Parser parser;
+    auto program = parser.parse("G0 X10 Y0 Z5\nG1 Z0 F100\nG1 X20 Y5\nG1 X30 Y10\n");
+    ASSERT_EQ(program.path.size(), 4u);
+
+    dw::gcode::SimPath sim;
+    sim.build(program, 100.0f);
+    EXPECT_EQ(sim.segmentCount(), 4u);
+    for (size_t i = 0; i <= 4; ++i)
+        EXPECT_EQ(sim.completedVertices(i), static_cast<dw::u32>(i * 2));
+    EXPECT_EQ(sim.completedVertices(99), 8u); // Clamped past the end
+    EXPECT_EQ(sim.partialVertex(), 8u);
+    ASSERT_EQ(sim.vertices.size(), (8u + 2u) * 3u);
+
+    // Segment 2 starts at (10,?,0) in G-code space -> renderer Y is G-code Z
+    const auto& s2 = program.path[2];
+    EXPECT_FLOAT_EQ(sim.vertices[4 * 3 + 0], s2.start.x);
+    EXPECT_FLOAT_EQ(sim.vertices[4 * 3 + 1], s2.start.z);
+    EXPECT_FLOAT_EQ(sim.vertices[4 * 3 + 2], s2.start.y);
+    EXPECT_FLOAT_EQ(sim.vertices[5 * 3 + 2], s2.end.y);
+}
+
+TEST(GcodeSimPath, ZClipSkipsSegmentsButKeepsIndexing) {
+    dw::gcode::Program program;
+    program.path.push_back(seg({0, 0, 0}, {1, 0, 0}));
+    program.path.push_back(seg({1, 0, 0}, {1, 0, 10})); // Ends above clip
+    program.path.push_back(seg({1, 0, 10}, {2, 0, 0}));
+
+    dw::gcode::SimPath sim;
+    sim.build(program, 5.0f);
+    EXPECT_EQ(sim.segmentCount(), 3u);
+    EXPECT_EQ(sim.completedVertices(1), 2u);
+    EXPECT_EQ(sim.completedVertices(2), 2u); // Clipped segment adds nothing
+    EXPECT_EQ(sim.completedVertices(3), 4u);
+    EXPECT_EQ(sim.partialVertex(), 4u);
+}
+
+TEST(GcodeSimPath, PartialSegmentInterpolatesAndClamps) {
+    auto s = seg({0, 0, 0}, {10, 20, -4});
+    float out[6];
+
+    dw::gcode::SimPath::partialSegment(s, 0.5f, out);
+    EXPECT_FLOAT_EQ(out[0], 0.0f);
+    EXPECT_FLOAT_EQ(out[3], 5.0f);
+    EXPECT_FLOAT_EQ(out[4], -2.0f); // Z -> renderer Y
+    EXPECT_FLOAT_EQ(out[5], 10.0f); // Y -> renderer Z
+
+    dw::gcode::SimPath::partialSegment(s, 2.0f, out);
+    EXPECT_FLOAT_EQ(out[3], 10.0f);
+    dw::gcode::SimPath::partialSegment(s, -1.0f, out);
+    EXPECT_FLOAT_EQ(out[3], 0.0f);
+}
+
+TEST(GcodeSimPath, ClearResets) {
+    dw::gcode::Program program;
+    program.path.push_back(seg({0, 0, 0}, {1, 0, 0}));
+    dw::gcode::SimPath sim;
+    sim.build(program, 100.0f);
+    EXPECT_FALSE(sim.empty());
+    sim.clear();
+    EXPECT_TRUE(sim.empty());
+    EXPECT_TRUE(sim.vertices.empty());
+    EXPECT_EQ(sim.completedVertices(1), 0u);
+}
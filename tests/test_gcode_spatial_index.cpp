@@ -0,0 +1,201 @@
+// Digital Workshop - G-code Spatial Index Tests
+
+#include <gtest/gtest.h>
+
+#include "core/gcode/gcode_parser.h"
+#include "core/gcode/gcode_spatial_index.h"
+#include "core/threading/parallel_for.h"
+
+#include <cmath>
+#include <vector>
+
+namespace {
+
+using dw::f32;
+using dw::u32;
+using dw::Vec3;
+
+dw::gcode::PathSegment seg(Vec3 a, Vec3 b, bool rapid = false, int line = 0) {
+    dw::gcode::PathSegment s;
+    s.start = a;
+    s.end = b;
+    s.isRapid = rapid;
+    s.lineNumber = line;
+    return s;
+}
+
+// Deterministic scatter of short segments in a 200 x 200 x 20 block
+dw::gcode::Program scatter(int count) {
+    dw::gcode::Program program;
+    u32 state = 12345u;
+    auto next = [&state]() {
+        state = state * 1664525u + 1013904223u;
+        return static_cast<f32>(state >> 8) / static_cast<f32>(1u << 24);
+    };
+    for (int i = 0; i < count; ++i) {
+        Vec3 a{next() * 200.0f, next() * 200.0f, -next() * 20.0f};
+        Vec3 b = a + Vec3{next() * 6.0f - 3.0f, next() * 6.0f - 3.0f, next() * 2.0f - 1.0f};
+        program.path.push_back(seg(a, b, (i % 7) == 0, i + 1));
+    }
+    return program;
+}
+
+bool segmentInBox(const dw::gcode::PathSegment& s, Vec3 min, Vec3 max) {
+    // Dense sampling is enough for a brute-force reference
+    for (int i = 0; i <= 256; ++i) {
+        Vec3 p = s.start + (s.end - s.start) * (static_cast<f32>(i) / 256.0f);
+        if (p.x >= min.x && p.x <= max.x && p.y >= min.y && p.y <= max.y && p.z >= min.z &&
+            p.z <= max.z)
+            return true;
+    }
+    return false;
+}
+
+} // namespace
+
+TEST(GcodeSpatialIndex, EmptyProgram) {
+    dw::gcode::Program program;
+    dw::gcode::SpatialIndex index;
+    index.build(program);
+    EXPECT_TRUE(index.empty());
+
+    std::vector<u32> out{1, 2, 3};
+    index.queryBox(Vec3{-1.0f}, Vec3{1.0f}, out);
+    EXPECT_TRUE(out.empty());
+    EXPECT_FALSE(index.pick(Vec3{0.0f, 0.0f, 10.0f}, Vec3{0.0f, 0.0f, -1.0f}, 1.0f));
+    EXPECT_TRUE(index.segmentsForLine(1).empty());
+}
+
+TEST(GcodeSpatialIndex, BoxQueryMatchesBruteForce) {
+    auto program = scatter(20000);
+    dw::gcode::SpatialIndex index;
+    index.build(program);
+    EXPECT_EQ(index.segmentCount(), program.path.size());
+
+    const Vec3 boxes[][2] = {
+        {{10.0f, 10.0f, -20.0f}, {40.0f, 60.0f, 0.0f}},
+        {{100.0f, 0.0f, -5.0f}, {101.0f, 200.0f, -4.0f}},
+        {{150.0f, 150.0f, -30.0f}, {250.0f, 250.0f, 10.0f}},
+    };
+    std::vector<u32> found;
+    for (const auto& box : boxes) {
+        index.queryBox(box[0], box[1], found);
+        std::vector<u32> expected;
+        for (u32 i = 0; i < program.path.size(); ++i) {
+            if (segmentInBox(program.path[i], box[0], box[1]))
+                expected.push_back(i);
+        }
+        EXPECT_FALSE(expected.empty());
+        EXPECT_EQ(found, expected);
+    }
+}
+
+TEST(GcodeSpatialIndex, ZRangeQuery) {
+    dw::gcode::Program program;
+    program.path.push_back(seg({0, 0, 5}, {10, 0, 5}));   // Above
+    program.path.push_back(seg({0, 0, 0}, {0, 0, -3}));   // Plunge through the band
+    program.path.push_back(seg({0, 0, -3}, {10, 0, -3})); // Below
+    program.path.push_back(seg({10, 0, -1}, {20, 0, -1})); // Inside
+
+    dw::gcode::SpatialIndex index;
+    index.build(program);
+    std::vector<u32> found;
+    index.queryZRange(-2.0f, -0.5f, found);
+    EXPECT_EQ(found, (std::vector<u32>{1, 3}));
+}
+
+TEST(GcodeSpatialIndex, PickReturnsNearestAlongRay) {
+    dw::gcode::Program program;
+    program.path.push_back(seg({0, 0, 0}, {10, 0, 0}));      // Lower cut
+    program.path.push_back(seg({0, 0, 5}, {10, 0, 5}));      // Upper cut, same XY
+    program.path.push_back(seg({0, 5, 8}, {10, 5, 8}, true)); // Rapid above, offset
+    program.path.push_back(seg({0, 20, 0}, {10, 20, 0}));
+
+    dw::gcode::SpatialIndex index;
+    index.build(program);
+
+    // Looking straight down at X=4: the upper cut is hit first
+    auto hit = index.pick(Vec3{4.0f, 0.1f, 50.0f}, Vec3{0.0f, 0.0f, -2.0f}, 0.25f);
+    ASSERT_TRUE(hit.has_value());
+    EXPECT_EQ(hit->segment, 1u);
+    EXPECT_NEAR(hit->rayT, 45.0f, 1e-4f);
+    EXPECT_NEAR(hit->distance, 0.1f, 1e-4f);
+
+    // Rapids are ignored unless requested
+    EXPECT_FALSE(index.pick(Vec3{4.0f, 5.0f, 50.0f}, Vec3{0.0f, 0.0f, -1.0f}, 0.25f));
+    auto rapid = index.pick(Vec3{4.0f, 5.0f, 50.0f}, Vec3{0.0f, 0.0f, -1.0f}, 0.25f, true);
+    ASSERT_TRUE(rapid.has_value());
+    EXPECT_EQ(rapid->segment, 2u);
+
+    // Outside the radius
+    EXPECT_FALSE(index.pick(Vec3{4.0f, 1.0f, 50.0f}, Vec3{0.0f, 0.0f, -1.0f}, 0.25f));
+
+    // A filter that rejects the upper cut exposes the one below it
+    auto below = index.pickFiltered(Vec3{4.0f, 0.1f, 50.0f}, Vec3{0.0f, 0.0f, -1.0f}, 0.25f,
+                                    [](const dw::gcode::PathSegment& s) { return s.end.z <= 1.0f; });
+    ASSERT_TRUE(below.has_value());
+    EXPECT_EQ(below->segment, 0u);
+
+    // Oblique ray ending on the far segment
+    Vec3 origin{5.0f, 30.0f, 10.0f};
+    auto far = index.pick(origin, Vec3{5.0f, 20.0f, 0.0f} - origin, 0.1f);
+    ASSERT_TRUE(far.has_value());
+    EXPECT_EQ(far->segment, 3u);
+}
+
+TEST(GcodeSpatialIndex, SegmentsForLineCoversArcs) {
+    dw::gcode::Parser parser;
+    auto program = parser.parse("G0 X0 Y0 Z1\nG1 Z0 F100\nG2 X10 Y0 I5 J0\nG1 X20\n");
+    dw::gcode::SpatialIndex index;
+    index.build(program);
+
+    auto arc = index.segmentsForLine(3);
+    EXPECT_GT(arc.size(), 1u);
+    for (u32 i = arc.first; i < arc.last; ++i)
+        EXPECT_EQ(program.path[i].lineNumber, 3);
+
+    auto line = index.segmentsForLine(4);
+    ASSERT_EQ(line.size(), 1u);
+    EXPECT_EQ(line.first, arc.last);
+    EXPECT_TRUE(index.segmentsForLine(99).empty());
+}
+
+TEST(GcodeSpatialIndex, MeasureBoxClipsLengths) {
+    dw::gcode::Program program;
+    program.path.push_back(seg({0, 0, 0}, {20, 0, 0}));
+    program.path.push_back(seg({5, -5, 0}, {5, 5, 0}, true));
+    program.path.push_back(seg({50, 50, 0}, {60, 50, 0}));
+
+    dw::gcode::SpatialIndex index;
+    index.build(program);
+    auto stats = index.measureBox(Vec3{0.0f, -1.0f, -1.0f}, Vec3{10.0f, 1.0f, 1.0f});
+    EXPECT_EQ(stats.segmentCount, 2u);
+    EXPECT_NEAR(stats.cuttingLength, 10.0f, 1e-4f);
+    EXPECT_NEAR(stats.rapidLength, 2.0f, 1e-4f);
+}
+
+TEST(GcodeSpatialIndex, ResultsIndependentOfThreadCount) {
+    auto program = scatter(150000); // Several sort chunks to merge
+    std::vector<u32> single;
+    std::vector<u32> multi;
+
+    dw::setParallelThreadCount(1);
+    dw::gcode::SpatialIndex a;
+    a.build(program);
+    a.queryBox(Vec3{50.0f, 50.0f, -10.0f}, Vec3{80.0f, 70.0f, 0.0f}, single);
+    auto hitA = a.pick(Vec3{60.0f, 60.0f, 10.0f}, Vec3{0.0f, 0.0f, -1.0f}, 1.0f);
+
+    dw::setParallelThreadCount(4);
+    dw::gcode::SpatialIndex b;
+    b.build(program);
+    b.queryBox(Vec3{50.0f, 50.0f, -10.0f}, Vec3{80.0f, 70.0f, 0.0f}, multi);
+    auto hitB = b.pick(Vec3{60.0f, 60.0f, 10.0f}, Vec3{0.0f, 0.0f, -1.0f}, 1.0f);
+    dw::setParallelThreadCount(0);
+
+    EXPECT_FALSE(single.empty());
+    EXPECT_EQ(single, multi);
+    ASSERT_EQ(hitA.has_value(), hitB.has_value());
+    if (hitA) {
+        EXPECT_EQ(hitA->segment, hitB->segment);
+    }
+}
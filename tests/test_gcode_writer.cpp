@@ -0,0 +1,112 @@
+// Digital Workshop - G-code Writer Tests
+
+#include <gtest/gtest.h>
+
+#include "core/gcode/gcode_writer.h"
+
+#include <cstdio>
+#include <string>
+
+using namespace dw;
+using dw::gcode::GcodeWriter;
+
+TEST(GcodeWriter, NumbersAreFixedPointWithTrimmedZeros) {
+    EXPECT_EQ(GcodeWriter::formatNumber(5.0f), "5.0");
+    EXPECT_EQ(GcodeWriter::formatNumber(0.0f), "0.0");
+    EXPECT_EQ(GcodeWriter::formatNumber(-0.0001f), "0.0");
+    EXPECT_EQ(GcodeWriter::formatNumber(2.25f), "2.25");
+    EXPECT_EQ(GcodeWriter::formatNumber(-0.1f), "-0.1");
+    EXPECT_EQ(GcodeWriter::formatNumber(-12.005f), "-12.005");
+    EXPECT_EQ(GcodeWriter::formatNumber(1000.0f), "1000.0");
+    EXPECT_EQ(GcodeWriter::formatNumber(0.0996f), "0.1");
+    EXPECT_EQ(GcodeWriter::formatNumber(123456.789f), "123456.789");
+}
+
+TEST(GcodeWriter, MatchesPrintfRounding) {
+    // Same digits as "%.3f" with trailing zeros trimmed, exact ties included
+    EXPECT_EQ(GcodeWriter::formatNumber(145.5625f), "145.562");
+    EXPECT_EQ(GcodeWriter::formatNumber(0.0625f), "0.062");
+    EXPECT_EQ(GcodeWriter::formatNumber(0.1875f), "0.188");
+    for (int i = -20000; i <= 20000; i += 7) {
+        const f32 v = static_cast<f32>(i) * 0.0137f;
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%.3f", static_cast<double>(v));
+        std::string expected(buf);
+        while (expected.back() == '0' && expected[expected.size() - 2] != '.')
+            expected.pop_back();
+        if (expected == "-0.0") expected = "0.0";
+        EXPECT_EQ(GcodeWriter::formatNumber(v), expected) << v;
+    }
+}
+
+TEST(GcodeWriter, SuppressesModalWords) {
+    GcodeWriter w;
+    w.rapid({0.0f, 0.0f, 5.0f});
+    w.rapid({10.0f, 0.0f, 5.0f});
+    w.linear({10.0f, 0.0f, -1.0f}, 1000.0f);
+    w.linear({20.0f, 0.0f, -2.0f}, 1000.0f);
+    w.linear({20.0f, 5.0f, -2.0f}, 800.0f);
+    w.rapid({20.0f, 5.0f, 5.0f});
+    EXPECT_EQ(w.text(),
+              "G0 X0.0 Y0.0 Z5.0\n"
+              "X10.0\n"
+              "G1 Z-1.0 F1000.0\n"
+              "X20.0 Z-2.0\n"
+              "Y5.0 F800.0\n"
+              "G0 Z5.0\n");
+    EXPECT_FLOAT_EQ(w.feedRate(), 800.0f);
+}
+
+TEST(GcodeWriter, RepeatedMoveIsRestatedInFull) {
+    GcodeWriter w;
+    w.linear({1.0f, 2.0f, 3.0f}, 500.0f);
+    w.linear({1.0f, 2.0f, 3.0f}, 500.0f);
+    // Differences below output precision count as unchanged
+    w.linear({1.0001f, 2.0f, 3.0f}, 500.0f);
+    EXPECT_EQ(w.text(),
+              "G1 X1.0 Y2.0 Z3.0 F500.0\n"
+              "G1 X1.0 Y2.0 Z3.0\n"
+              "G1 X1.0 Y2.0 Z3.0\n");
+}
+
+TEST(GcodeWriter, RetractKeepsXYState) {
+    GcodeWriter w;
+    w.retractTo(5.0f);
+    w.rapid({3.0f, 4.0f, 5.0f});
+    w.linear({3.0f, 4.0f, -1.0f}, 300.0f);
+    w.retractTo(5.0f);
+    w.line("M5");
+    EXPECT_EQ(w.text(),
+              "G0 Z5.0\n"
+              "X3.0 Y4.0\n"
+              "G1 Z-1.0 F300.0\n"
+              "G0 Z5.0\n"
+              "M5\n");
+}
+
+TEST(GcodeWriter, PrimedChunkMatchesContinuousOutput) {
+    const Vec3 pts[] = {{0.0f, 0.0f, 5.0f}, {1.0f, 0.0f, -1.0f}, {2.0f, 0.0f, -1.5f},
+                        {2.0f, 1.0f, -1.5f}, {2.0f, 1.0f, 5.0f}, {0.0f, 1.0f, 5.0f}};
+    const bool rapid[] = {true, false, false, false, true, true};
+
+    GcodeWriter whole;
+    for (int i = 0; i < 6; ++i)
+        rapid[i] ? whole.rapid(pts[i]) : whole.linear(pts[i], 900.0f);
+
+    GcodeWriter head;
+    for (int i = 0; i < 3; ++i)
+        rapid[i] ? head.rapid(pts[i]) : head.linear(pts[i], 900.0f);
+    GcodeWriter tail;
+    tail.setModalState(pts[2], rapid[2], 900.0f);
+    for (int i = 3; i < 6; ++i)
+        rapid[i] ? tail.rapid(pts[i]) : tail.linear(pts[i], 900.0f);
+
+    EXPECT_EQ(head.text() + tail.text(), whole.text());
+
+    // Reset forgets everything
+    whole.clear();
+    whole.resetModalState();
+    whole.rapid(pts[5]);
+    EXPECT_EQ(whole.text(), "G0 X0.0 Y1.0 Z5.0\n");
+    EXPECT_FLOAT_EQ(whole.feedRate(), 0.0f);
+}
@@ -0,0 +1,205 @@
+// Tests for GrblEmulator — drives the emulator through the real SerialPort and
+// TcpSocket transports (no hardware required)
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/cnc/cnc_controller.h"
+#include "core/cnc/cnc_types.h"
+#include "core/cnc/grbl_emulator.h"
+#include "core/cnc/serial_port.h"
+#include "core/cnc/tcp_socket.h"
+
+using namespace dw;
+
+namespace {
+
+// Read until a line satisfying `match` arrives; returns it, or "" on timeout
+template <typename Match>
+std::string readUntil(IByteStream& port, Match match, int timeoutMs = 2000) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (std::chrono::steady_clock::now() < deadline) {
+        auto line = port.readLine(20);
+        if (line && match(*line))
+            return *line;
+    }
+    return {};
+}
+
+std::string readReply(IByteStream& port) {
+    return readUntil(port, [](const std::string& l) { return l == "ok" || l.rfind("error:", 0) == 0; });
+}
+
+GrblEmulatorConfig fastConfig() {
+    GrblEmulatorConfig config;
+    config.timeScale = 50.0f;
+    return config;
+}
+
+} // namespace
+
+TEST(GrblEmulator, BannerAfterSoftReset) {
+    GrblEmulator emu(fastConfig());
+    std::string path = emu.openPty();
+    ASSERT_FALSE(path.empty());
+    EXPECT_TRUE(emu.isRunning());
+
+    SerialPort port;
+    ASSERT_TRUE(port.open(path, 115200));
+    port.writeByte(cnc::CMD_SOFT_RESET);
+    auto banner = readUntil(port, [](const std::string& l) { return l.find("Grbl") != std::string::npos; });
+    EXPECT_EQ(banner.rfind("Grbl 1.1", 0), 0u);
+}
+
+TEST(GrblEmulator, AcknowledgesLinesAndReportsStatus) {
+    GrblEmulator emu(fastConfig());
+    std::string path = emu.openPty();
+    ASSERT_FALSE(path.empty());
+    SerialPort port;
+    ASSERT_TRUE(port.open(path, 115200));
+
+    port.write("G21 G90\n");
+    EXPECT_EQ(readReply(port), "ok");
+    port.write("G1 X10\n"); // No feed rate set yet
+    EXPECT_EQ(readReply(port), "error:22");
+    port.write("G1 X10 Y5 F3000\n");
+    EXPECT_EQ(readReply(port), "ok");
+    port.write("$Bogus\n");
+    EXPECT_EQ(readReply(port), "error:3");
+
+    // Let the move finish, then the status report shows the end point
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    port.writeByte(cnc::CMD_STATUS_QUERY);
+    auto report = readUntil(port, [](const std::string& l) { return !l.empty() && l[0] == '<'; });
+    auto status = CncController::parseStatusReport(report);
+    EXPECT_EQ(status.state, MachineState::Idle);
+    EXPECT_NEAR(status.machinePos.x, 10.0f, 1e-3f);
+    EXPECT_NEAR(status.machinePos.y, 5.0f, 1e-3f);
+
+    auto stats = emu.stats();
+    EXPECT_EQ(stats.linesProcessed, 4u);
+    EXPECT_EQ(stats.okCount, 2u);
+    EXPECT_EQ(stats.errorCount, 2u);
+    EXPECT_EQ(stats.blocksPlanned, 1u);
+}
+
+TEST(GrblEmulator, CharacterCountedStreamCompletes) {
+    GrblEmulator emu(fastConfig());
+    std::string path = emu.openPty();
+    ASSERT_FALSE(path.empty());
+    SerialPort port;
+    ASSERT_TRUE(port.open(path, 115200));
+
+    std::vector<std::string> lines;
+    for (int i = 1; i <= 200; ++i) {
+        char buf[48];
+        std::snprintf(buf, sizeof(buf), "G1 X%d.000 Y%d.000 F2400", i, (i % 2) * 3);
+        lines.push_back(buf);
+    }
+
+    // Keep the RX buffer as full as the character count allows
+    std::deque<usize> inFlight;
+    usize used = 0;
+    usize sent = 0;
+    usize acked = 0;
+    while (acked < lines.size()) {
+        while (sent < lines.size() && used + lines[sent].size() + 1 <= cnc::RX_BUFFER_SIZE) {
+            port.write(lines[sent] + "\n");
+            inFlight.push_back(lines[sent].size() + 1);
+            used += inFlight.back();
+            ++sent;
+        }
+        auto reply = readReply(port);
+        ASSERT_EQ(reply, "ok") << "at line " << acked;
+        used -= inFlight.front();
+        inFlight.pop_front();
+        ++acked;
+    }
+
+    auto stats = emu.stats();
+    EXPECT_EQ(stats.linesProcessed, 200u);
+    EXPECT_EQ(stats.rxOverflowBytes, 0u);
+    EXPECT_LE(stats.peakRxUsed, 128u);
+    EXPECT_EQ(stats.blocksPlanned, 200u);
+}
+
+TEST(GrblEmulator, FloodingOverflowsRxBuffer) {
+    GrblEmulatorConfig config;
+    config.timeScale = 1.0f;
+    GrblEmulator emu(config);
+    std::string path = emu.openPty();
+    ASSERT_FALSE(path.empty());
+    SerialPort port;
+    ASSERT_TRUE(port.open(path, 115200));
+
+    // Slow 1 mm moves fill the planner, then the RX buffer, then overflow
+    std::string flood;
+    for (int i = 1; i <= 60; ++i)
+        flood += "G1 X" + std::to_string(i) + " F100\n";
+    port.write(flood);
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (emu.stats().bytesReceived < flood.size() && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    // Bounds rather than exact counts: a slow host may let a block finish
+    auto stats = emu.stats();
+    EXPECT_EQ(stats.bytesReceived, flood.size());
+    EXPECT_GT(stats.rxOverflowBytes, 0u);
+    EXPECT_LE(stats.peakRxUsed, config.rxBufferSize);
+    EXPECT_GT(stats.peakRxUsed, config.rxBufferSize / 2);
+    EXPECT_GE(stats.blocksPlanned, config.plannerBlocks);
+    EXPECT_LE(stats.blocksPlanned, config.plannerBlocks + 1);
+}
+
+TEST(GrblEmulator, FeedHoldStopsMotion) {
+    GrblEmulator emu(fastConfig());
+    std::string path = emu.openPty();
+    ASSERT_FALSE(path.empty());
+    SerialPort port;
+    ASSERT_TRUE(port.open(path, 115200));
+
+    port.write("G1 X1000 F3000\n");
+    EXPECT_EQ(readReply(port), "ok");
+    port.writeByte(cnc::CMD_FEED_HOLD);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    const f32 held = emu.position().x;
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FLOAT_EQ(emu.position().x, held);
+    EXPECT_LT(held, 1000.0f);
+
+    port.writeByte(cnc::CMD_CYCLE_START);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_GT(emu.position().x, held);
+}
+
+TEST(GrblEmulator, ServesTcpClient) {
+    GrblEmulator emu(fastConfig());
+    int tcpPort = emu.listenTcp();
+    ASSERT_GT(tcpPort, 0);
+
+    TcpSocket sock;
+    ASSERT_TRUE(sock.connect("127.0.0.1", tcpPort, 1000));
+    auto banner = readUntil(sock, [](const std::string& l) { return l.find("Grbl") != std::string::npos; });
+    EXPECT_FALSE(banner.empty());
+
+    sock.write("$I\n");
+    auto version = readUntil(sock, [](const std::string& l) { return l.rfind("[VER:", 0) == 0; });
+    EXPECT_EQ(version, "[VER:1.1h.20190825:]");
+    EXPECT_EQ(readReply(sock), "ok");
+}
+
+TEST(GrblEmulator, StopIsIdempotent) {
+    GrblEmulator emu;
+    EXPECT_FALSE(emu.isRunning());
+    emu.stop();
+    ASSERT_FALSE(emu.openPty().empty());
+    emu.stop();
+    emu.stop();
+    EXPECT_FALSE(emu.isRunning());
+}
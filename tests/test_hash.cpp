@@ -66,3 +66,17 @@ TEST(Hash, FromHex_Zero) {
 
     EXPECT_EQ(value, 0u);
 }
+
+TEST(Hash, Hasher_MatchesComputeBufferAcrossSplits) {
+    dw::ByteBuffer data(1000);
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = static_cast<dw::u8>(i * 31u + 7u);
+
+    dw::hash::Hasher hasher;
+    hasher.update(data.data(), 1);
+    hasher.update(data.data() + 1, 499);
+    hasher.update(data.data() + 500, 0);
+    hasher.update(data.data() + 500, 500);
+
+    EXPECT_EQ(hasher.hex(), dw::hash::computeBuffer(data));
+}
@@ -3,8 +3,13 @@
 #include <gtest/gtest.h>
 
 #include "core/carve/heightmap.h"
+#include "core/carve/heightmap_pyramid.h"
 
+#include <algorithm>
 #include <cmath>
+#include <random>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 
 namespace {
@@ -179,3 +184,136 @@ TEST(Heightmap, ProgressCallback) {
     // Final value should be 1.0
     EXPECT_FLOAT_EQ(progressValues.back(), 1.0f);
 }
+
+TEST(Heightmap, PyramidBoundsEnclosePatch) {
+    // Odd sizes exercise the partial blocks at the right/bottom edges
+    constexpr int kCols = 37;
+    constexpr int kRows = 23;
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<f32> heights(-5.0f, 5.0f);
+    std::vector<f32> grid(static_cast<size_t>(kCols * kRows));
+    for (auto& z : grid)
+        z = heights(rng);
+
+    dw::carve::HeightmapPyramid pyramid;
+    pyramid.build(grid.data(), kCols, kRows);
+    ASSERT_FALSE(pyramid.empty());
+
+    std::uniform_int_distribution<int> col(0, kCols - 1);
+    std::uniform_int_distribution<int> row(0, kRows - 1);
+    for (int i = 0; i < 500; ++i) {
+        int c0 = col(rng), c1 = col(rng), r0 = row(rng), r1 = row(rng);
+        f32 lo = pyramid.minBound(c0, r0, c1, r1);
+        f32 hi = pyramid.maxBound(c0, r0, c1, r1);
+        if (c1 < c0) std::swap(c0, c1);
+        if (r1 < r0) std::swap(r0, r1);
+        for (int r = r0; r <= r1; ++r) {
+            for (int c = c0; c <= c1; ++c) {
+                const f32 z = grid[static_cast<size_t>(r * kCols + c)];
+                ASSERT_GE(z, lo);
+                ASSERT_LE(z, hi);
+            }
+        }
+    }
+
+    // Whole-grid query reaches the top level and is exact there
+    EXPECT_FLOAT_EQ(pyramid.maxBound(0, 0, kCols - 1, kRows - 1),
+                    *std::max_element(grid.begin(), grid.end()));
+    EXPECT_FLOAT_EQ(pyramid.minBound(0, 0, kCols - 1, kRows - 1),
+                    *std::min_element(grid.begin(), grid.end()));
+}
+
+TEST(Heightmap, MaxBoundMmCoversInterpolation) {
+    std::vector<dw::Vertex> verts;
+    std::vector<dw::u32> indices;
+    makePyramid(10.0f, 5.0f, verts, indices);
+
+    dw::carve::Heightmap hm;
+    dw::carve::HeightmapConfig cfg;
+    cfg.resolutionMm = 0.25f;
+    hm.build(verts, indices, dw::Vec3(0.0f), dw::Vec3(10.0f, 10.0f, 5.0f), cfg);
+
+    for (f32 x0 = 0.0f; x0 < 9.0f; x0 += 0.7f) {
+        const f32 x1 = x0 + 1.3f;
+        const f32 y0 = 10.0f - x1;
+        const f32 y1 = y0 + 0.9f;
+        const f32 hi = hm.maxBoundMm(x0, y0, x1, y1);
+        const f32 lo = hm.minBoundMm(x0, y0, x1, y1);
+        for (f32 x = x0; x <= x1; x += 0.1f) {
+            for (f32 y = y0; y <= y1; y += 0.1f) {
+                EXPECT_LE(hm.atMm(x, y), hi);
+                EXPECT_GE(hm.atMm(x, y), lo);
+            }
+        }
+    }
+}
+
+TEST(Heightmap, TileCallbackCoversEveryRowOnce) {
+    std::vector<dw::Vertex> verts;
+    std::vector<dw::u32> indices;
+    makePyramid(10.0f, 5.0f, verts, indices);
+
+    std::vector<int> seen;
+    dw::carve::Heightmap hm;
+    dw::carve::HeightmapConfig cfg;
+    cfg.resolutionMm = 0.1f;
+    hm.build(verts, indices, dw::Vec3(0.0f), dw::Vec3(10.0f, 10.0f, 5.0f), cfg, nullptr,
+             [&](const dw::carve::Heightmap& partial, int rowBegin, int rowEnd) {
+                 if (seen.empty())
+                     seen.assign(static_cast<size_t>(partial.rows()), 0);
+                 for (int r = rowBegin; r < rowEnd; ++r)
+                     ++seen[static_cast<size_t>(r)];
+             });
+
+    ASSERT_EQ(seen.size(), static_cast<size_t>(hm.rows()));
+    for (int count : seen)
+        EXPECT_EQ(count, 1);
+}
+
+TEST(Heightmap, ProgressExceptionCancelsBuild) {
+    std::vector<dw::Vertex> verts;
+    std::vector<dw::u32> indices;
+    makePyramid(10.0f, 5.0f, verts, indices);
+
+    int tiles = 0;
+    dw::carve::Heightmap hm;
+    dw::carve::HeightmapConfig cfg;
+    cfg.resolutionMm = 0.05f;
+    EXPECT_THROW(
+        hm.build(verts, indices, dw::Vec3(0.0f), dw::Vec3(10.0f, 10.0f, 5.0f), cfg,
+                 [](f32) { throw std::runtime_error("Cancelled"); },
+                 [&](const dw::carve::Heightmap&, int, int) { ++tiles; }),
+        std::runtime_error);
+    // Remaining tiles are skipped once the first one fails
+    EXPECT_LE(tiles, 1);
+}
+
+TEST(Heightmap, ResampleRowsRefinesCoarseGrid) {
+    std::vector<dw::Vertex> verts;
+    std::vector<dw::u32> indices;
+    makePyramid(10.0f, 5.0f, verts, indices);
+
+    const dw::Vec3 bMin(0.0f);
+    const dw::Vec3 bMax(10.0f, 10.0f, 5.0f);
+    dw::carve::Heightmap fine;
+    dw::carve::HeightmapConfig cfg;
+    cfg.resolutionMm = 0.25f;
+    fine.build(verts, indices, bMin, bMax, cfg);
+
+    dw::carve::Heightmap coarse = dw::carve::Heightmap::fromGrid(
+        10, 10, 1.0f, bMin, bMax, std::vector<f32>(100, 0.0f));
+    ASSERT_EQ(coarse.cols(), 10);
+    EXPECT_FLOAT_EQ(coarse.maxZ(), 0.0f);
+
+    // Top half only: bottom rows keep their coarse values
+    coarse.resampleRows(fine, 0, fine.rows() / 2);
+    EXPECT_FLOAT_EQ(coarse.at(5, 2), fine.at(20, 8));
+    EXPECT_FLOAT_EQ(coarse.at(5, 9), 0.0f);
+
+    coarse.resampleRows(fine, fine.rows() / 2, fine.rows());
+    for (int r = 0; r < coarse.rows(); ++r)
+        for (int c = 0; c < coarse.cols(); ++c)
+            EXPECT_FLOAT_EQ(coarse.at(c, r), fine.at(c * 4, r * 4));
+    EXPECT_FLOAT_EQ(coarse.maxZ(), fine.maxZ());
+    EXPECT_FLOAT_EQ(coarse.maxBoundMm(0.0f, 0.0f, 10.0f, 10.0f), coarse.maxZ());
+}
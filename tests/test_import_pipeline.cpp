@@ -59,6 +59,7 @@ TEST(ImportStageName, AllStages) {
     EXPECT_STREQ(dw::importStageName(dw::ImportStage::Hashing), "Computing hash");
     EXPECT_STREQ(dw::importStageName(dw::ImportStage::CheckingDuplicate), "Checking duplicates");
     EXPECT_STREQ(dw::importStageName(dw::ImportStage::Parsing), "Parsing mesh");
+    EXPECT_STREQ(dw::importStageName(dw::ImportStage::Optimizing), "Optimizing mesh");
     EXPECT_STREQ(dw::importStageName(dw::ImportStage::Inserting), "Saving to library");
     EXPECT_STREQ(dw::importStageName(dw::ImportStage::WaitingForThumbnail), "Generating thumbnail");
     EXPECT_STREQ(dw::importStageName(dw::ImportStage::Done), "Done");
@@ -4,7 +4,10 @@
 
 #include "core/carve/island_detector.h"
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
+#include <queue>
 #include <vector>
 
 namespace {
@@ -45,6 +48,47 @@ dw::carve::Heightmap buildFromFunc(f32 size, f32 res,
     return hm;
 }
 
+// Deterministic pseudo-random burial mask with a given fill ratio (percent)
+std::vector<dw::u8> randomMask(int cols, int rows, int percent, dw::u32 seed) {
+    std::vector<dw::u8> mask(static_cast<size_t>(cols * rows));
+    for (auto& cell : mask) {
+        seed = seed * 1664525u + 1013904223u;
+        cell = static_cast<int>((seed >> 16) % 100u) < percent ? 1 : 0;
+    }
+    return mask;
+}
+
+// Reference labeling: 4-connected BFS flood fill, ids in raster order
+std::vector<int> floodFillLabels(const std::vector<dw::u8>& mask, int cols, int rows) {
+    std::vector<int> labels(mask.size(), -1);
+    int next = 0;
+    for (int start = 0; start < cols * rows; ++start) {
+        if (!mask[start] || labels[start] >= 0)
+            continue;
+        std::queue<int> queue;
+        queue.push(start);
+        labels[start] = next;
+        while (!queue.empty()) {
+            const int cell = queue.front();
+            queue.pop();
+            const int c = cell % cols;
+            const int r = cell / cols;
+            const int neighbors[4][2] = {{c - 1, r}, {c + 1, r}, {c, r - 1}, {c, r + 1}};
+            for (const auto& n : neighbors) {
+                if (n[0] < 0 || n[0] >= cols || n[1] < 0 || n[1] >= rows)
+                    continue;
+                const int idx = n[1] * cols + n[0];
+                if (mask[idx] && labels[idx] < 0) {
+                    labels[idx] = next;
+                    queue.push(idx);
+                }
+            }
+        }
+        ++next;
+    }
+    return labels;
+}
+
 } // namespace
 
 TEST(IslandDetector, NoIslands) {
@@ -166,3 +210,88 @@ TEST(IslandDetector, ClearingDiameter) {
                    wideResult.islands[0].minClearDiameter);
     }
 }
+
+TEST(IslandDetector, LabelIslandsMatchesFloodFill) {
+    auto hm = buildFromFunc(100.0f, 0.5f, [](f32, f32) { return 10.0f; });
+    const int cols = hm.cols();
+    const int rows = hm.rows();
+    auto mask = randomMask(cols, rows, 45, 12345u);
+
+    auto result = dw::carve::labelIslands(hm, mask, 0.0f);
+    auto expected = floodFillLabels(mask, cols, rows);
+
+    ASSERT_EQ(result.maskCols, cols);
+    ASSERT_EQ(result.maskRows, rows);
+    EXPECT_EQ(result.islandMask, expected);
+
+    const int islandCount = *std::max_element(expected.begin(), expected.end()) + 1;
+    ASSERT_EQ(static_cast<int>(result.islands.size()), islandCount);
+    for (const auto& island : result.islands) {
+        size_t cells = 0;
+        for (const auto& span : island.spans) {
+            for (int c = span.colBegin; c < span.colEnd; ++c)
+                EXPECT_EQ(result.islandMask[span.row * cols + c], island.id);
+            cells += static_cast<size_t>(span.colEnd - span.colBegin);
+        }
+        EXPECT_EQ(island.cellCount(), cells);
+        EXPECT_FLOAT_EQ(island.areaMm2, static_cast<f32>(cells) * 0.25f);
+    }
+}
+
+TEST(IslandDetector, LabelIslandsJoinsAcrossRowBands) {
+    // A tall U: two one-cell columns joined only at the bottom row, far more
+    // rows than one parallel band
+    auto hm = buildFromFunc(100.0f, 0.5f, [](f32, f32) { return 10.0f; });
+    const int cols = hm.cols();
+    const int rows = hm.rows();
+    ASSERT_GT(rows, 150);
+    std::vector<dw::u8> mask(static_cast<size_t>(cols * rows), 0);
+    for (int r = 1; r < rows - 1; ++r) {
+        mask[r * cols + 5] = 1;
+        mask[r * cols + 20] = 1;
+    }
+    for (int c = 5; c <= 20; ++c)
+        mask[(rows - 2) * cols + c] = 1;
+
+    auto result = dw::carve::labelIslands(hm, mask, 0.0f);
+    ASSERT_EQ(result.islands.size(), 1u);
+    EXPECT_EQ(result.islands[0].cellCount(), static_cast<size_t>(2 * (rows - 2) + 14));
+    EXPECT_EQ(result.islandMask[1 * cols + 5], 0);
+    EXPECT_EQ(result.islandMask[1 * cols + 20], 0);
+}
+
+TEST(IslandDetector, ClearingDiameterIsExactEuclidean) {
+    auto hm = buildFromFunc(30.0f, 0.5f, [](f32, f32) { return 10.0f; });
+    const int cols = hm.cols();
+    const int rows = hm.rows();
+    auto mask = randomMask(cols, rows, 70, 777u);
+
+    auto result = dw::carve::labelIslands(hm, mask, 0.0f);
+    ASSERT_FALSE(result.islands.empty());
+
+    // Brute force: distance from each buried cell to the nearest accessible
+    // cell, where everything outside the grid is accessible
+    std::vector<f32> maxDist(result.islands.size(), 0.0f);
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            const int id = result.islandMask[r * cols + c];
+            if (id < 0)
+                continue;
+            const int edge = std::min({c + 1, cols - c, r + 1, rows - r});
+            f32 best = static_cast<f32>(edge);
+            for (int r2 = 0; r2 < rows; ++r2) {
+                for (int c2 = 0; c2 < cols; ++c2) {
+                    if (mask[r2 * cols + c2] == 0)
+                        best = std::min(best, std::hypot(static_cast<f32>(c - c2),
+                                                         static_cast<f32>(r - r2)));
+                }
+            }
+            maxDist[id] = std::max(maxDist[id], best);
+        }
+    }
+
+    for (const auto& island : result.islands) {
+        const f32 expected = 2.0f * std::max(0.0f, maxDist[island.id] - 1.0f) * 0.5f;
+        EXPECT_NEAR(island.minClearDiameter, expected, 1e-4f) << "island " << island.id;
+    }
+}
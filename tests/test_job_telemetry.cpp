@@ -0,0 +1,289 @@
+// Tests for JobTelemetryRecorder (.dwjt logs) and telemetry-based machine
+// profile calibration
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "core/cnc/job_telemetry.h"
+#include "core/gcode/gcode_analyzer.h"
+#include "core/gcode/gcode_calibration.h"
+#include "core/gcode/gcode_parser.h"
+
+using namespace dw;
+
+namespace {
+
+// RAII temp file for test isolation
+class TempFile {
+  public:
+    explicit TempFile(const std::string& name) {
+        m_path = std::filesystem::temp_directory_path() / name;
+        std::filesystem::remove(m_path);
+    }
+    ~TempFile() { std::filesystem::remove(m_path); }
+
+    std::string path() const { return m_path.string(); }
+
+  private:
+    Path m_path;
+};
+
+MachineStatus makeStatus(MachineState state, Vec3 workPos, f32 feed = 0.0f) {
+    MachineStatus status;
+    status.state = state;
+    status.workPos = workPos;
+    status.feedRate = feed;
+    return status;
+}
+
+// Zigzag of short cuts, so acceleration dominates the run time
+std::vector<std::string> zigzagLines(int rows) {
+    std::vector<std::string> lines = {"G21", "G90", "G0 X0 Y0"};
+    for (int i = 0; i < rows; ++i) {
+        const f32 x = (i % 2 == 0) ? 5.0f : 0.0f;
+        lines.push_back("G1 X" + std::to_string(x) + " Y" + std::to_string(static_cast<f32>(i + 1)) +
+                        " F3000");
+    }
+    return lines;
+}
+
+// Telemetry of an ideal run on a machine with `actual` limits: every line
+// acked up front, then status samples every `period` seconds whose positions
+// follow the Analyzer's timing for that machine.
+JobTelemetry simulateRun(const std::vector<std::string>& lines, const gcode::MachineProfile& actual,
+                         f64 period, int feedOverride = 100) {
+    std::string content;
+    for (const auto& line : lines)
+        content += line + "\n";
+    gcode::Parser parser;
+    const auto program = parser.parse(content);
+    gcode::Analyzer analyzer;
+    analyzer.setMachineProfile(actual);
+    const auto stats = analyzer.analyze(program);
+
+    std::vector<f64> cumulative(stats.segmentTimes.size() + 1, 0.0);
+    for (usize i = 0; i < stats.segmentTimes.size(); ++i)
+        cumulative[i + 1] = cumulative[i] + static_cast<f64>(stats.segmentTimes[i]) * 60.0;
+
+    JobTelemetry telemetry;
+    telemetry.totalLines = static_cast<int>(lines.size());
+    for (int i = 0; i < telemetry.totalLines; ++i)
+        telemetry.acks.push_back({0.0, i, 0});
+
+    usize segment = 0;
+    for (f64 t = 0.0; t < cumulative.back(); t += period) {
+        while (segment + 1 < program.path.size() && cumulative[segment + 1] <= t)
+            ++segment;
+        const auto& seg = program.path[segment];
+        const f64 span = cumulative[segment + 1] - cumulative[segment];
+        const auto fraction = static_cast<f32>(span > 0.0 ? (t - cumulative[segment]) / span : 1.0);
+
+        TelemetrySample sample;
+        sample.time = t;
+        sample.state = MachineState::Run;
+        sample.workPos = seg.start + (seg.end - seg.start) * fraction;
+        sample.feedOverride = feedOverride;
+        telemetry.samples.push_back(sample);
+    }
+    return telemetry;
+}
+
+} // namespace
+
+// --- Recorder / log format ---
+
+TEST(JobTelemetry, RoundTripsSamplesAndAcks) {
+    TempFile file("dw_test_telemetry_roundtrip.dwjt");
+
+    JobTelemetryRecorder recorder;
+    ASSERT_TRUE(recorder.begin(file.path(), 3, 0x0123456789ABCDEFULL));
+    EXPECT_TRUE(recorder.isRecording());
+
+    auto running = makeStatus(MachineState::Run, Vec3{12.345f, -6.5f, 0.001f}, 1500.0f);
+    running.feedOverride = 120;
+    running.rapidOverride = 50;
+    recorder.recordStatus(running);
+    recorder.recordAck(0, true, 0);
+    recorder.recordAck(1, false, 22);
+    recorder.recordStatus(makeStatus(MachineState::Hold, Vec3{-100.0f, 250.25f, -3.0f}));
+    recorder.recordAck(2, true, 0);
+    recorder.end();
+    EXPECT_FALSE(recorder.isRecording());
+
+    auto telemetry = JobTelemetry::load(file.path());
+    ASSERT_TRUE(telemetry.has_value());
+    EXPECT_EQ(telemetry->totalLines, 3);
+    EXPECT_EQ(telemetry->linesHash, 0x0123456789ABCDEFULL);
+
+    ASSERT_EQ(telemetry->samples.size(), 2u);
+    const auto& first = telemetry->samples[0];
+    EXPECT_EQ(first.state, MachineState::Run);
+    EXPECT_NEAR(first.workPos.x, 12.345f, 1e-3f);
+    EXPECT_NEAR(first.workPos.y, -6.5f, 1e-3f);
+    EXPECT_NEAR(first.workPos.z, 0.001f, 1e-3f);
+    EXPECT_FLOAT_EQ(first.feedRate, 1500.0f);
+    EXPECT_EQ(first.feedOverride, 120);
+    EXPECT_EQ(first.rapidOverride, 50);
+
+    const auto& second = telemetry->samples[1];
+    EXPECT_EQ(second.state, MachineState::Hold);
+    EXPECT_NEAR(second.workPos.x, -100.0f, 1e-3f);
+    EXPECT_NEAR(second.workPos.y, 250.25f, 1e-3f);
+    EXPECT_GE(second.time, first.time);
+
+    ASSERT_EQ(telemetry->acks.size(), 3u);
+    EXPECT_EQ(telemetry->acks[0].lineIndex, 0);
+    EXPECT_EQ(telemetry->acks[0].errorCode, 0);
+    EXPECT_EQ(telemetry->acks[1].lineIndex, 1);
+    EXPECT_EQ(telemetry->acks[1].errorCode, 22);
+    EXPECT_EQ(telemetry->acks[2].lineIndex, 2);
+}
+
+TEST(JobTelemetry, IgnoresCallsWhenNotRecording) {
+    TempFile file("dw_test_telemetry_idle.dwjt");
+
+    JobTelemetryRecorder recorder;
+    recorder.recordStatus(makeStatus(MachineState::Run, Vec3{1.0f}));
+    recorder.recordAck(0, true, 0);
+    EXPECT_FALSE(recorder.isRecording());
+
+    ASSERT_TRUE(recorder.begin(file.path(), 1, 0));
+    recorder.end();
+    recorder.recordAck(0, true, 0);
+
+    auto telemetry = JobTelemetry::load(file.path());
+    ASSERT_TRUE(telemetry.has_value());
+    EXPECT_TRUE(telemetry->samples.empty());
+    EXPECT_TRUE(telemetry->acks.empty());
+}
+
+TEST(JobTelemetry, EndWhenIdleKeepsRecordingUntilIdle) {
+    TempFile file("dw_test_telemetry_end_idle.dwjt");
+
+    JobTelemetryRecorder recorder;
+    ASSERT_TRUE(recorder.begin(file.path(), 1, 0));
+    recorder.recordAck(0, true, 0);
+    recorder.endWhenIdle();
+
+    recorder.recordStatus(makeStatus(MachineState::Run, Vec3{1.0f, 0.0f, 0.0f}));
+    EXPECT_TRUE(recorder.isRecording());
+    recorder.recordStatus(makeStatus(MachineState::Idle, Vec3{2.0f, 0.0f, 0.0f}));
+    EXPECT_FALSE(recorder.isRecording());
+    recorder.recordStatus(makeStatus(MachineState::Idle, Vec3{3.0f, 0.0f, 0.0f}));
+
+    auto telemetry = JobTelemetry::load(file.path());
+    ASSERT_TRUE(telemetry.has_value());
+    ASSERT_EQ(telemetry->samples.size(), 2u);
+    EXPECT_EQ(telemetry->samples.back().state, MachineState::Idle);
+}
+
+TEST(JobTelemetry, TruncatedLogKeepsCompleteRecords) {
+    TempFile file("dw_test_telemetry_truncated.dwjt");
+
+    JobTelemetryRecorder recorder;
+    ASSERT_TRUE(recorder.begin(file.path(), 0, 0));
+    for (int i = 0; i < 10; ++i)
+        recorder.recordStatus(makeStatus(MachineState::Run, Vec3{static_cast<f32>(i), 0.0f, 0.0f}));
+    recorder.end();
+
+    // Drop the last byte, as a crash mid-write would
+    const auto size = std::filesystem::file_size(file.path());
+    std::filesystem::resize_file(file.path(), size - 1);
+
+    auto telemetry = JobTelemetry::load(file.path());
+    ASSERT_TRUE(telemetry.has_value());
+    ASSERT_EQ(telemetry->samples.size(), 9u);
+    EXPECT_NEAR(telemetry->samples.back().workPos.x, 8.0f, 1e-3f);
+}
+
+TEST(JobTelemetry, RejectsMissingAndForeignFiles) {
+    TempFile file("dw_test_telemetry_foreign.dwjt");
+    EXPECT_FALSE(JobTelemetry::load(file.path()).has_value());
+
+    std::ofstream(file.path(), std::ios::binary) << "G1 X10 Y10 F1000\n";
+    EXPECT_FALSE(JobTelemetry::load(file.path()).has_value());
+}
+
+TEST(JobTelemetry, HashLinesDetectsEditsWithSameLineCount) {
+    const auto lines = zigzagLines(10);
+    auto edited = lines;
+    edited[5] = "G1 X5.000000 Y3.000000 F1500";
+    auto split = lines;
+    split[3] += split[4];
+    split[4].clear();
+
+    const u64 original = JobTelemetry::hashLines(lines);
+    EXPECT_EQ(JobTelemetry::hashLines(zigzagLines(10)), original);
+    EXPECT_NE(JobTelemetry::hashLines(edited), original);
+    EXPECT_NE(JobTelemetry::hashLines(split), original);
+}
+
+// --- Calibration ---
+
+TEST(GcodeCalibration, RecoversSlowerAcceleration) {
+    const auto lines = zigzagLines(60);
+    gcode::MachineProfile nominal;
+    gcode::MachineProfile actual = nominal;
+    actual.accelX = nominal.accelX * 0.25f;
+    actual.accelY = nominal.accelY * 0.25f;
+    actual.accelZ = nominal.accelZ * 0.25f;
+
+    const auto telemetry = simulateRun(lines, actual, 0.2);
+    const auto result = gcode::calibrateFromTelemetry(telemetry, lines, nominal);
+
+    ASSERT_TRUE(result.valid);
+    EXPECT_GT(result.intervalsUsed, 10u);
+    EXPECT_NEAR(result.accelScale, 0.25f, 0.02f);
+    EXPECT_NEAR(result.rateScale, 1.0f, 0.02f);
+    EXPECT_NEAR(result.profile.accelX, actual.accelX, actual.accelX * 0.08f);
+
+    // The nominal profile underestimates; the calibrated one matches
+    EXPECT_LT(result.estimatedSeconds, result.measuredSeconds * 0.9);
+    EXPECT_NEAR(result.calibratedSeconds, result.measuredSeconds, result.measuredSeconds * 0.02);
+    EXPECT_GT(result.calibratedProgramSeconds, result.programEstimateSeconds);
+
+    // Per-segment actual times cover the cuts
+    ASSERT_EQ(result.segments.size(), 61u);
+    int measured = 0;
+    for (const auto& segment : result.segments) {
+        if (segment.actualSeconds >= 0.0f)
+            ++measured;
+    }
+    EXPECT_GT(measured, 50);
+}
+
+TEST(GcodeCalibration, RecoversLowerRateLimit) {
+    // Long cuts requested faster than the machine can go, then short ones
+    // that never reach the limit: only a lower rate fits both
+    auto lines = zigzagLines(20);
+    for (const char* line : {"G1 X200 Y20 F8000", "G1 X200 Y200", "G1 X0 Y200", "G1 X0 Y20"})
+        lines.emplace_back(line);
+    gcode::MachineProfile nominal;
+    gcode::MachineProfile actual = nominal;
+    actual.maxFeedRateX = actual.maxFeedRateY = 2500.0f;
+
+    const auto telemetry = simulateRun(lines, actual, 0.2);
+    const auto result = gcode::calibrateFromTelemetry(telemetry, lines, nominal);
+
+    ASSERT_TRUE(result.valid);
+    EXPECT_NEAR(result.rateScale, 0.5f, 0.02f);
+    EXPECT_NEAR(result.accelScale, 1.0f, 0.05f);
+    EXPECT_NEAR(result.calibratedSeconds, result.measuredSeconds, result.measuredSeconds * 0.02);
+}
+
+TEST(GcodeCalibration, IgnoresOverriddenRuns) {
+    const auto lines = zigzagLines(20);
+    gcode::MachineProfile nominal;
+
+    const auto telemetry = simulateRun(lines, nominal, 0.2, 50);
+    const auto result = gcode::calibrateFromTelemetry(telemetry, lines, nominal);
+
+    EXPECT_FALSE(result.valid);
+    EXPECT_EQ(result.intervalsUsed, 0u);
+    EXPECT_FLOAT_EQ(result.accelScale, 1.0f);
+    EXPECT_FLOAT_EQ(result.rateScale, 1.0f);
+}
@@ -0,0 +1,152 @@
+// Digital Workshop - Async Logger Tests
+
+#include <gtest/gtest.h>
+
+#include "core/utils/log.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+class LogTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        m_path = std::filesystem::temp_directory_path() / "dw_test_log.txt";
+        std::filesystem::remove(m_path);
+        m_previousLevel = dw::log::getLevel();
+        dw::log::setLevel(dw::log::Level::Info);
+        dw::log::setLogFile(m_path.string());
+    }
+
+    void TearDown() override {
+        dw::log::closeLogFile();
+        dw::log::setLevel(m_previousLevel);
+        std::filesystem::remove(m_path);
+    }
+
+    // Lines written so far that contain `needle`
+    std::vector<std::string> linesContaining(const std::string& needle) {
+        dw::log::flush();
+        std::vector<std::string> result;
+        std::ifstream in(m_path);
+        std::string line;
+        while (std::getline(in, line))
+            if (line.find(needle) != std::string::npos)
+                result.push_back(line);
+        return result;
+    }
+
+    std::filesystem::path m_path;
+    dw::log::Level m_previousLevel = dw::log::Level::Info;
+};
+
+} // namespace
+
+TEST_F(LogTest, FlushWritesQueuedMessagesInOrder) {
+    for (int i = 0; i < 50; ++i)
+        dw::log::info("LogTest", "ordered " + std::to_string(i));
+
+    auto lines = linesContaining("ordered ");
+    ASSERT_EQ(lines.size(), 50u);
+    for (size_t i = 0; i < lines.size(); ++i) {
+        EXPECT_NE(lines[i].find("[INFO ] [LogTest] ordered " + std::to_string(i)),
+                  std::string::npos)
+            << lines[i];
+    }
+}
+
+TEST_F(LogTest, RateLimitIsPerThreadAndMessage) {
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 200;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([t]() {
+            for (int i = 0; i < kPerThread; ++i)
+                dw::log::warningf("LogTest", "worker %d stalled", t);
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    // One text per thread, so each thread gets a single burst within the window
+    auto lines = linesContaining("] worker ");
+    EXPECT_EQ(lines.size(), static_cast<size_t>(kThreads) * dw::log::kRateBurst);
+}
+
+TEST_F(LogTest, FormattedCallSiteWithDistinctValuesIsNotRateLimited) {
+    for (int i = 0; i < 100; ++i)
+        dw::log::infof("LogTest", "item %d loaded", i);
+
+    EXPECT_EQ(linesContaining("] item ").size(), 100u);
+    EXPECT_TRUE(linesContaining("further copies suppressed").empty());
+}
+
+TEST_F(LogTest, DistinctMessagesAreNotRateLimited) {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([t]() {
+            for (int i = 0; i < 200; ++i)
+                dw::log::info("LogTest", "distinct " + std::to_string(t) + ":" + std::to_string(i));
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    EXPECT_EQ(linesContaining("distinct ").size(), 800u);
+    EXPECT_EQ(dw::log::droppedCount(), 0u);
+}
+
+TEST_F(LogTest, RepeatedMessagesAreSummarizedAfterTheWindow) {
+    for (int i = 0; i < 100; ++i)
+        dw::log::warningf("LogTest", "repeated %s", "warning");
+
+    EXPECT_EQ(linesContaining("repeated warning").size(), dw::log::kRateBurst);
+    EXPECT_EQ(linesContaining("further copies suppressed").size(), 1u);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(dw::log::kRateWindowMs + 50));
+    dw::log::warningf("LogTest", "repeated %s", "warning");
+
+    auto summary = linesContaining("similar message(s) suppressed");
+    ASSERT_EQ(summary.size(), 1u);
+    EXPECT_NE(summary[0].find("(90 similar"), std::string::npos) << summary[0];
+    EXPECT_EQ(linesContaining("repeated warning").size(), dw::log::kRateBurst + 1);
+}
+
+TEST_F(LogTest, LevelFilterAppliesBeforeQueueing) {
+    dw::log::setLevel(dw::log::Level::Warning);
+    dw::log::info("LogTest", "filtered info");
+    dw::log::infof("LogTest", "filtered %s", "infof");
+    dw::log::error("LogTest", "kept error");
+
+    EXPECT_TRUE(linesContaining("filtered").empty());
+    EXPECT_EQ(linesContaining("kept error").size(), 1u);
+}
+
+TEST_F(LogTest, FilteredLevelsQueueNoRateLimitNotes) {
+    dw::log::setLevel(dw::log::Level::Warning);
+    for (int i = 0; i < 100; ++i)
+        dw::log::info("LogTest", "quiet info");
+
+    EXPECT_TRUE(linesContaining("quiet info").empty());
+    EXPECT_TRUE(linesContaining("further copies suppressed").empty());
+}
+
+TEST_F(LogTest, FullRingDropsInsteadOfBlocking) {
+    const auto droppedBefore = dw::log::droppedCount();
+    const std::string padding(4000, 'x');
+    constexpr int kMessages = 2000;
+    for (int i = 0; i < kMessages; ++i)
+        dw::log::info("LogTest", "flood " + std::to_string(i) + " " + padding);
+
+    auto written = linesContaining("] flood ").size();
+    auto dropped = dw::log::droppedCount() - droppedBefore;
+    EXPECT_EQ(written + dropped, static_cast<size_t>(kMessages));
+    if (dropped > 0) {
+        EXPECT_FALSE(linesContaining("dropped: log queue full").empty());
+    }
+}
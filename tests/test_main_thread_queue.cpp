@@ -3,8 +3,12 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
+#include <functional>
+#include <string>
 #include <thread>
 #include <vector>
 
@@ -101,34 +105,29 @@ TEST_F(MainThreadQueueTest, CrossThreadEnqueue) {
     EXPECT_EQ(queue.size(), 0);
 }
 
-// Test 6: shutdown() causes blocked enqueue to return without adding
-TEST_F(MainThreadQueueTest, ShutdownUnblocksEnqueue) {
-    MainThreadQueue queue(2); // Small queue for easy blocking
+// Test 6: enqueue never blocks past the soft limit; shutdown stops further enqueues
+TEST_F(MainThreadQueueTest, EnqueueNeverBlocksPastSoftLimit) {
+    MainThreadQueue queue(2); // Small soft limit
 
-    // Fill the queue
     queue.enqueue([]() {});
     queue.enqueue([]() {});
-
     EXPECT_EQ(queue.size(), 2);
 
-    // Spawn thread that will block on enqueue
+    // A full queue used to block the producer; now it returns right away
     std::atomic<bool> enqueueReturned{false};
     std::thread worker([&queue, &enqueueReturned]() {
-        queue.enqueue([]() {}); // This should block
+        queue.enqueue([]() {});
         enqueueReturned = true;
     });
-
-    // Give worker time to block
-    std::this_thread::sleep_for(std::chrono::milliseconds(50));
-
-    // Shutdown should unblock the worker
-    queue.shutdown();
-
     worker.join();
 
-    // Worker should have returned without adding task
     EXPECT_TRUE(enqueueReturned.load());
-    EXPECT_EQ(queue.size(), 2); // Still 2, not 3
+    EXPECT_EQ(queue.size(), 3);
+    EXPECT_EQ(queue.stats().peakPending, 3u);
+
+    queue.shutdown();
+    queue.enqueue([]() {});
+    EXPECT_EQ(queue.size(), 3);
 }
 
 // Test 7: After shutdown, enqueue is a no-op
@@ -179,3 +178,200 @@ TEST_F(MainThreadQueueTest, IsMainThreadFalse) {
 
     EXPECT_FALSE(result.load());
 }
+
+// Test 11: enqueueLatest keeps only the newest pending task per key
+TEST_F(MainThreadQueueTest, EnqueueLatestCoalescesPendingTasks) {
+    MainThreadQueue queue;
+    const auto key = MainThreadQueue::latestKey(this, 0);
+    std::vector<int> seen;
+
+    for (int i = 0; i < 100; ++i)
+        queue.enqueueLatest(key, [&seen, i]() { seen.push_back(i); });
+    EXPECT_EQ(queue.size(), 1);
+
+    queue.processAll();
+    ASSERT_EQ(seen.size(), 1u);
+    EXPECT_EQ(seen[0], 99);
+    EXPECT_EQ(queue.stats().coalesced, 99u);
+
+    // Once run, the next update is queued again
+    queue.enqueueLatest(key, [&seen]() { seen.push_back(100); });
+    queue.processAll();
+    EXPECT_EQ(seen.back(), 100);
+}
+
+// Test 12: distinct keys in distinct slots coexist; a slot collision drops the
+// older key's pending task instead of running it out of order
+TEST_F(MainThreadQueueTest, EnqueueLatestSlotCollisionDropsOlderTask) {
+    MainThreadQueue queue;
+    std::vector<int> seen;
+
+    // 1 and 257 hash to the same slot
+    queue.enqueueLatest(1, [&seen]() { seen.push_back(1); });
+    queue.enqueueLatest(257, [&seen]() { seen.push_back(257); });
+    queue.enqueueLatest(MainThreadQueue::latestKey(&seen, 3), [&seen]() { seen.push_back(3); });
+    EXPECT_EQ(queue.size(), 2);
+
+    queue.processAll();
+    EXPECT_EQ(seen, (std::vector<int>{257, 3}));
+    EXPECT_EQ(queue.stats().coalesced, 1u);
+    EXPECT_EQ(queue.size(), 0);
+
+    // The dropped key posts again and runs normally
+    queue.enqueueLatest(1, [&seen]() { seen.push_back(1); });
+    queue.processAll();
+    EXPECT_EQ(seen.back(), 1);
+}
+
+// Test 13: higher priorities drain first, FIFO within a priority
+TEST_F(MainThreadQueueTest, PrioritiesDrainInOrder) {
+    MainThreadQueue queue;
+    std::vector<int> order;
+
+    queue.enqueue([&order]() { order.push_back(5); }, TaskPriority::Low);
+    queue.enqueue([&order]() { order.push_back(3); });
+    queue.enqueue([&order]() { order.push_back(1); }, TaskPriority::High);
+    queue.enqueue([&order]() { order.push_back(4); });
+    queue.enqueue([&order]() { order.push_back(2); }, TaskPriority::High);
+
+    queue.processAll();
+    EXPECT_EQ(order, (std::vector<int>{1, 2, 3, 4, 5}));
+}
+
+// Test 13b: keyed and plain tasks at one priority keep their order, so a
+// progress snapshot queued before a disconnect never runs after it
+TEST_F(MainThreadQueueTest, EnqueueLatestKeepsFifoWithPlainTasks) {
+    MainThreadQueue queue;
+    const auto key = MainThreadQueue::latestKey(this, 1);
+    std::vector<std::string> order;
+
+    queue.enqueueLatest(key, [&order]() { order.push_back("progress 1"); }, TaskPriority::High);
+    queue.enqueue([&order]() { order.push_back("disconnect"); }, TaskPriority::High);
+    queue.enqueueLatest(key, [&order]() { order.push_back("progress 2"); }, TaskPriority::High);
+
+    queue.process(std::chrono::microseconds(0));
+    EXPECT_EQ(order, (std::vector<std::string>{"progress 2", "disconnect"}));
+}
+
+// Test 14: process() stops at the budget and defers the rest
+TEST_F(MainThreadQueueTest, BudgetDefersRemainingWork) {
+    MainThreadQueue queue;
+    std::atomic<int> counter{0};
+    for (int i = 0; i < 50; ++i) {
+        queue.enqueue([&counter]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            counter++;
+        });
+    }
+
+    queue.process(std::chrono::milliseconds(5));
+    int first = counter.load();
+    EXPECT_GT(first, 0);
+    EXPECT_LT(first, 50);
+    EXPECT_EQ(queue.stats().lastExecuted, static_cast<size_t>(first));
+    EXPECT_EQ(queue.stats().lastDeferred, static_cast<size_t>(50 - first));
+
+    queue.processAll();
+    EXPECT_EQ(counter.load(), 50);
+}
+
+// Test 15: High always runs and Low still makes progress with no budget left
+TEST_F(MainThreadQueueTest, ZeroBudgetStillMakesProgressPerPriority) {
+    MainThreadQueue queue;
+    int high = 0, normal = 0, low = 0;
+    for (int i = 0; i < 3; ++i) {
+        queue.enqueue([&high]() { high++; }, TaskPriority::High);
+        queue.enqueue([&normal]() { normal++; });
+        queue.enqueue([&low]() { low++; }, TaskPriority::Low);
+    }
+
+    queue.process(std::chrono::microseconds(0));
+    EXPECT_EQ(high, 3);
+    EXPECT_EQ(normal, 1);
+    EXPECT_EQ(low, 1);
+}
+
+// Test 16: tasks enqueued by a running task wait for the next call
+TEST_F(MainThreadQueueTest, ReentrantEnqueueRunsNextCall) {
+    MainThreadQueue queue;
+    int runs = 0;
+    std::function<void()> again = [&]() {
+        runs++;
+        queue.enqueue(again);
+    };
+    queue.enqueue(again);
+
+    queue.processAll();
+    EXPECT_EQ(runs, 1);
+    queue.processAll();
+    EXPECT_EQ(runs, 2);
+    EXPECT_EQ(queue.size(), 1);
+}
+
+// Test 17: many producers, nothing lost
+TEST_F(MainThreadQueueTest, ConcurrentProducers) {
+    MainThreadQueue queue;
+    std::atomic<int> counter{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([&queue, &counter]() {
+            for (int i = 0; i < 10000; ++i)
+                queue.enqueue([&counter]() { counter++; });
+        });
+    }
+
+    // Drain concurrently with the producers
+    while (counter.load() < 40000) {
+        queue.process(std::chrono::milliseconds(1));
+        if (counter.load() < 40000)
+            std::this_thread::yield();
+    }
+    for (auto& worker : workers)
+        worker.join();
+
+    queue.processAll();
+    EXPECT_EQ(counter.load(), 40000);
+    EXPECT_EQ(queue.size(), 0);
+    EXPECT_EQ(queue.stats().enqueued, 40000u);
+}
+
+// Test 18: latency covers the time a task waited in the queue
+TEST_F(MainThreadQueueTest, StatsReportLatency) {
+    MainThreadQueue queue;
+    queue.enqueue([]() {});
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    queue.processAll();
+    auto stats = queue.stats();
+    EXPECT_GE(stats.lastMaxLatencyMs, 20.0);
+    EXPECT_GT(stats.avgLatencyMs, 0.0);
+    EXPECT_EQ(stats.executed, 1u);
+}
+
+// Test 19: concurrent coalescing delivers every key's final value
+TEST_F(MainThreadQueueTest, ConcurrentEnqueueLatestDeliversNewest) {
+    MainThreadQueue queue;
+    constexpr int kThreads = 4;
+    constexpr int kUpdates = 5000;
+    std::array<int, kThreads> lastSeen{};
+    lastSeen.fill(-1);
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < kThreads; ++t) {
+        workers.emplace_back([&queue, &lastSeen, t]() {
+            auto key = MainThreadQueue::latestKey(&queue, static_cast<uint32_t>(t));
+            for (int i = 0; i < kUpdates; ++i)
+                queue.enqueueLatest(key, [&lastSeen, t, i]() { lastSeen[t] = i; });
+        });
+    }
+    for (int i = 0; i < 200; ++i)
+        queue.process(std::chrono::microseconds(100));
+    for (auto& worker : workers)
+        worker.join();
+    queue.processAll();
+
+    for (int t = 0; t < kThreads; ++t)
+        EXPECT_EQ(lastSeen[t], kUpdates - 1);
+    auto stats = queue.stats();
+    EXPECT_EQ(stats.coalesced + stats.executed, static_cast<uint64_t>(kThreads * kUpdates));
+}
@@ -6,6 +6,7 @@
 #include <gtest/gtest.h>
 
 #include "core/database/database.h"
+#include "core/database/model_change_feed.h"
 #include "core/database/schema.h"
 #include "core/materials/default_materials.h"
 #include "core/materials/material_archive.h"
@@ -270,6 +271,26 @@ TEST_F(MaterialManagerTest, Assign_PersistsMaterialOnModel) {
     EXPECT_EQ(retrieved->id, materialId);
 }
 
+TEST_F(MaterialManagerTest, Assign_PublishesModelChange) {
+    m_manager->seedDefaults();
+    auto materials = m_manager->getAllMaterials();
+    ASSERT_FALSE(materials.empty());
+
+    dw::i64 modelId = insertModel("test_cube");
+    auto& feed = dw::ModelChangeFeed::instance();
+
+    dw::u64 before = feed.currentVersion();
+    ASSERT_TRUE(m_manager->assignMaterialToModel(materials[0].id, modelId));
+    auto assigned = feed.changesSince(before);
+    ASSERT_EQ(assigned.changes.size(), 1u);
+    EXPECT_EQ(assigned.changes[0].modelId, modelId);
+    EXPECT_EQ(assigned.changes[0].kind, dw::ModelChangeKind::Updated);
+
+    before = feed.currentVersion();
+    ASSERT_TRUE(m_manager->clearMaterialAssignment(modelId));
+    EXPECT_EQ(feed.changesSince(before).changes.size(), 1u);
+}
+
 TEST_F(MaterialManagerTest, Assign_FailsForNonExistentMaterial) {
     dw::i64 modelId = insertModel("test_cube");
     EXPECT_FALSE(m_manager->assignMaterialToModel(99999, modelId));
@@ -0,0 +1,371 @@
+// Digital Workshop - Mesh Optimizer and Mesh Cache Tests
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <tuple>
+
+#include "core/mesh/mesh.h"
+#include "core/mesh/mesh_cache.h"
+#include "core/mesh/mesh_optimizer.h"
+
+using namespace dw;
+
+namespace {
+
+// Gently curved welded grid (adjacent faces differ by a few degrees)
+Mesh makeGrid(int n) {
+    std::vector<Vertex> verts;
+    std::vector<u32> idx;
+    for (int y = 0; y <= n; ++y) {
+        for (int x = 0; x <= n; ++x) {
+            f32 fx = static_cast<f32>(x);
+            f32 fy = static_cast<f32>(y);
+            verts.emplace_back(Vec3{fx, fy, std::sin(fx * 0.05f) * 2.0f});
+        }
+    }
+    auto at = [n](int x, int y) { return static_cast<u32>(y * (n + 1) + x); };
+    for (int y = 0; y < n; ++y) {
+        for (int x = 0; x < n; ++x) {
+            idx.insert(idx.end(), {at(x, y), at(x + 1, y), at(x + 1, y + 1)});
+            idx.insert(idx.end(), {at(x, y), at(x + 1, y + 1), at(x, y + 1)});
+        }
+    }
+    return Mesh(std::move(verts), std::move(idx));
+}
+
+// One vertex per corner, as binary STL produces
+Mesh makeSoup(const Mesh& welded) {
+    std::vector<Vertex> verts;
+    std::vector<u32> idx;
+    for (u32 i : welded.indices()) {
+        idx.push_back(static_cast<u32>(verts.size()));
+        verts.push_back(welded.vertices()[i]);
+    }
+    return Mesh(std::move(verts), std::move(idx));
+}
+
+// Unit cube, 8 shared corners, outward winding
+Mesh makeCube() {
+    std::vector<Vertex> verts;
+    for (int i = 0; i < 8; ++i) {
+        verts.emplace_back(Vec3{static_cast<f32>(i & 1),
+                                static_cast<f32>((i >> 1) & 1),
+                                static_cast<f32>((i >> 2) & 1)});
+    }
+    std::vector<u32> idx = {
+        0, 2, 3, 0, 3, 1, // -Z
+        4, 5, 7, 4, 7, 6, // +Z
+        0, 1, 5, 0, 5, 4, // -Y
+        2, 6, 7, 2, 7, 3, // +Y
+        0, 4, 6, 0, 6, 2, // -X
+        1, 3, 7, 1, 7, 5, // +X
+    };
+    return Mesh(std::move(verts), std::move(idx));
+}
+
+std::set<std::tuple<f32, f32, f32>> positionsOf(const Mesh& mesh) {
+    std::set<std::tuple<f32, f32, f32>> out;
+    for (const auto& v : mesh.vertices()) {
+        out.emplace(v.position.x, v.position.y, v.position.z);
+    }
+    return out;
+}
+
+} // namespace
+
+// --- Welding ---
+
+TEST(MeshOptimizer, WeldCollapsesSoupToSharedVertices) {
+    Mesh grid = makeGrid(20);
+    Mesh soup = makeSoup(grid);
+    ASSERT_EQ(soup.vertexCount(), 20u * 20u * 6u);
+
+    u32 removed = mesh_opt::weldVertices(soup, 1e-6f);
+    EXPECT_EQ(soup.vertexCount(), 21u * 21u);
+    EXPECT_EQ(removed, 20u * 20u * 6u - 21u * 21u);
+    EXPECT_EQ(soup.triangleCount(), grid.triangleCount());
+    EXPECT_TRUE(soup.isValid());
+}
+
+TEST(MeshOptimizer, WeldDropsCollapsedTriangles) {
+    std::vector<Vertex> verts = {
+        Vertex(Vec3{0, 0, 0}),
+        Vertex(Vec3{1, 0, 0}),
+        Vertex(Vec3{0, 1, 0}),
+        Vertex(Vec3{0, 0, 0}),
+        Vertex(Vec3{1e-9f, 0, 0}), // Within tolerance of vertex 0
+        Vertex(Vec3{0, 1, 0}),
+    };
+    Mesh mesh(std::move(verts), {0, 1, 2, 3, 4, 5});
+    mesh_opt::weldVertices(mesh, 1e-4f);
+    EXPECT_EQ(mesh.vertexCount(), 3u);
+    EXPECT_EQ(mesh.triangleCount(), 1u);
+}
+
+TEST(MeshOptimizer, WeldKeepsUvSeams) {
+    // Two triangles sharing an edge, but with different UVs along it
+    std::vector<Vertex> verts = {
+        Vertex(Vec3{0, 0, 0}, Vec3{0, 0, 1}, Vec2{0.0f, 0.0f}),
+        Vertex(Vec3{1, 0, 0}, Vec3{0, 0, 1}, Vec2{1.0f, 0.0f}),
+        Vertex(Vec3{0, 1, 0}, Vec3{0, 0, 1}, Vec2{0.0f, 1.0f}),
+        Vertex(Vec3{1, 0, 0}, Vec3{0, 0, 1}, Vec2{0.5f, 0.5f}),
+        Vertex(Vec3{1, 1, 0}, Vec3{0, 0, 1}, Vec2{1.0f, 1.0f}),
+        Vertex(Vec3{0, 1, 0}, Vec3{0, 0, 1}, Vec2{0.0f, 1.0f}),
+    };
+    Mesh mesh(std::move(verts), {0, 1, 2, 3, 4, 5});
+    ASSERT_TRUE(mesh.hasTexCoords());
+    mesh_opt::weldVertices(mesh, 1e-6f);
+    // (0,1,0) matches exactly; (1,0,0) differs in UV and stays split
+    EXPECT_EQ(mesh.vertexCount(), 5u);
+}
+
+// --- Crease normals ---
+
+TEST(MeshOptimizer, CreaseNormalsSplitCubeCorners) {
+    Mesh cube = makeCube();
+    mesh_opt::computeCreaseNormals(cube, 40.0f);
+    EXPECT_EQ(cube.vertexCount(), 24u); // 3 face normals per corner
+    EXPECT_EQ(positionsOf(cube).size(), 8u);
+    for (const auto& v : cube.vertices()) {
+        // Axis-aligned unit normal, pointing away from the cube center
+        f32 ax = std::abs(v.normal.x) + std::abs(v.normal.y) + std::abs(v.normal.z);
+        EXPECT_NEAR(ax, 1.0f, 1e-5f);
+        Vec3 out = v.position - Vec3{0.5f, 0.5f, 0.5f};
+        EXPECT_GT(glm::dot(out, v.normal), 0.0f);
+    }
+}
+
+TEST(MeshOptimizer, CreaseNormalsSmoothOnGentleCurve) {
+    Mesh grid = makeGrid(16);
+    const u32 before = grid.vertexCount();
+    mesh_opt::computeCreaseNormals(grid, 40.0f);
+    EXPECT_EQ(grid.vertexCount(), before);
+    for (const auto& v : grid.vertices()) {
+        EXPECT_NEAR(glm::length(v.normal), 1.0f, 1e-4f);
+        EXPECT_GT(v.normal.z, 0.9f);
+    }
+}
+
+TEST(MeshOptimizer, CreaseNormalsHighValenceFan) {
+    // 2000 coplanar faces around one hub, plus a steep skirt on every tenth
+    // rim edge; the hub must keep a single upward normal
+    constexpr u32 SPOKES = 2000;
+    std::vector<Vertex> verts;
+    std::vector<u32> idx;
+    verts.emplace_back(Vec3{0, 0, 0});
+    for (u32 i = 0; i < SPOKES; ++i) {
+        const f32 a = static_cast<f32>(i) * 6.2831853f / static_cast<f32>(SPOKES);
+        verts.emplace_back(Vec3{std::cos(a), std::sin(a), 0.0f});
+    }
+    for (u32 i = 0; i < SPOKES; ++i) {
+        idx.insert(idx.end(), {0u, 1 + i, 1 + (i + 1) % SPOKES});
+    }
+    for (u32 i = 0; i < SPOKES; i += 10) {
+        const Vec3 rim = verts[1 + i].position;
+        verts.emplace_back(Vec3{rim.x, rim.y, -1.0f});
+        idx.insert(idx.end(), {1 + (i + 1) % SPOKES, 1 + i, static_cast<u32>(verts.size() - 1)});
+    }
+    Mesh fan(std::move(verts), std::move(idx));
+    mesh_opt::computeCreaseNormals(fan, 40.0f);
+
+    u32 hubCopies = 0;
+    for (const auto& v : fan.vertices()) {
+        if (v.position == Vec3{0, 0, 0}) {
+            ++hubCopies;
+            EXPECT_NEAR(v.normal.z, 1.0f, 1e-4f);
+        }
+    }
+    EXPECT_EQ(hubCopies, 1u);
+}
+
+TEST(MeshOptimizer, CreaseNormalsIgnoresMalformedIndices) {
+    Mesh cube = makeCube();
+    std::vector<u32> idx = cube.indices();
+    idx.push_back(99);
+    Mesh bad(std::vector<Vertex>(cube.vertices()), std::move(idx));
+    mesh_opt::computeCreaseNormals(bad, 40.0f);
+    EXPECT_EQ(bad.vertexCount(), 8u);
+}
+
+// --- Reordering ---
+
+TEST(MeshOptimizer, VertexCacheLowersAcmr) {
+    Mesh grid = makeGrid(64);
+    // Scramble triangle order so the baseline is cache-hostile
+    std::vector<u32> idx = grid.indices();
+    const u32 tris = static_cast<u32>(idx.size() / 3);
+    for (u32 t = 0; t < tris; ++t) {
+        u32 other = (t * 7919u) % tris;
+        for (u32 k = 0; k < 3; ++k) {
+            std::swap(idx[t * 3 + k], idx[other * 3 + k]);
+        }
+    }
+    const f32 before = mesh_opt::computeAcmr(idx, grid.vertexCount());
+    std::vector<u32> optimized = idx;
+    mesh_opt::optimizeVertexCache(optimized, grid.vertexCount());
+
+    ASSERT_EQ(optimized.size(), idx.size());
+    EXPECT_EQ(std::multiset<u32>(optimized.begin(), optimized.end()),
+              std::multiset<u32>(idx.begin(), idx.end()));
+    const f32 after = mesh_opt::computeAcmr(optimized, grid.vertexCount());
+    EXPECT_LT(after, before);
+    EXPECT_LT(after, 0.8f);
+}
+
+TEST(MeshOptimizer, VertexCacheKeepsPartialTriangle) {
+    Mesh grid = makeGrid(8);
+    std::vector<u32> idx = grid.indices();
+    idx.push_back(3);
+    idx.push_back(4);
+    std::vector<u32> optimized = idx;
+    mesh_opt::optimizeVertexCache(optimized, grid.vertexCount());
+
+    ASSERT_EQ(optimized.size(), idx.size());
+    EXPECT_EQ(optimized[optimized.size() - 2], 3u);
+    EXPECT_EQ(optimized.back(), 4u);
+    EXPECT_EQ(std::multiset<u32>(optimized.begin(), optimized.end() - 2),
+              std::multiset<u32>(idx.begin(), idx.end() - 2));
+}
+
+TEST(MeshOptimizer, VertexCacheLeavesOutOfRangeInput) {
+    std::vector<u32> idx = {0, 1, 2, 2, 1, 7};
+    const std::vector<u32> original = idx;
+    mesh_opt::optimizeVertexCache(idx, 3);
+    EXPECT_EQ(idx, original);
+}
+
+TEST(MeshOptimizer, VertexFetchRenumbersInFirstUseOrder) {
+    std::vector<Vertex> verts = {
+        Vertex(Vec3{0, 0, 0}),
+        Vertex(Vec3{1, 0, 0}),
+        Vertex(Vec3{0, 1, 0}),
+        Vertex(Vec3{9, 9, 9}), // Unreferenced
+        Vertex(Vec3{1, 1, 0}),
+    };
+    Mesh mesh(std::move(verts), {4, 2, 1, 1, 2, 0});
+    mesh_opt::optimizeVertexFetch(mesh);
+
+    EXPECT_EQ(mesh.vertexCount(), 4u);
+    EXPECT_EQ(mesh.indices(), (std::vector<u32>{0, 1, 2, 2, 1, 3}));
+    EXPECT_EQ(mesh.vertices()[0].position, (Vec3{1, 1, 0}));
+    EXPECT_EQ(mesh.vertices()[3].position, (Vec3{0, 0, 0}));
+}
+
+TEST(MeshOptimizer, OptimizePreservesSurface) {
+    Mesh grid = makeGrid(24);
+    Mesh soup = makeSoup(grid);
+    const AABB bounds = soup.bounds();
+
+    auto stats = mesh_opt::optimize(soup);
+    EXPECT_EQ(stats.verticesBefore, 24u * 24u * 6u);
+    EXPECT_EQ(stats.verticesAfter, soup.vertexCount());
+    EXPECT_EQ(soup.vertexCount(), 25u * 25u);
+    EXPECT_EQ(stats.trianglesAfter, grid.triangleCount());
+    EXPECT_LT(stats.acmrAfter, stats.acmrBefore);
+    EXPECT_TRUE(soup.isValid());
+    EXPECT_EQ(positionsOf(soup), positionsOf(grid));
+    EXPECT_EQ(soup.bounds().min, bounds.min);
+    EXPECT_EQ(soup.bounds().max, bounds.max);
+}
+
+// --- Mesh cache ---
+
+class MeshCacheTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        m_dir = std::filesystem::temp_directory_path() / "dw_test_mesh_cache";
+        std::filesystem::remove_all(m_dir);
+    }
+
+    void TearDown() override { std::filesystem::remove_all(m_dir); }
+
+    Path m_dir;
+};
+
+TEST_F(MeshCacheTest, StoreLoadRoundTrip) {
+    MeshCache cache(m_dir);
+    Mesh mesh = makeGrid(10);
+    mesh_opt::optimize(mesh);
+
+    EXPECT_FALSE(cache.contains("abc123"));
+    EXPECT_EQ(cache.load("abc123"), nullptr);
+    ASSERT_TRUE(cache.store("abc123", mesh));
+    EXPECT_TRUE(cache.contains("abc123"));
+
+    auto loaded = cache.load("abc123");
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(loaded->indices(), mesh.indices());
+    ASSERT_EQ(loaded->vertexCount(), mesh.vertexCount());
+    EXPECT_EQ(std::memcmp(loaded->vertices().data(),
+                          mesh.vertices().data(),
+                          mesh.vertices().size() * sizeof(Vertex)),
+              0);
+    EXPECT_EQ(loaded->bounds().min, mesh.bounds().min);
+    EXPECT_EQ(loaded->bounds().max, mesh.bounds().max);
+
+    EXPECT_TRUE(cache.remove("abc123"));
+    EXPECT_FALSE(cache.contains("abc123"));
+    EXPECT_TRUE(cache.remove("abc123")); // Absent is not an error
+}
+
+TEST_F(MeshCacheTest, RejectsCorruptAndTruncatedEntries) {
+    MeshCache cache(m_dir);
+    Mesh mesh = makeGrid(6);
+    ASSERT_TRUE(cache.store("corrupt", mesh));
+    ASSERT_TRUE(cache.store("short", mesh));
+
+    {
+        std::fstream f(cache.pathFor("corrupt"), std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(100);
+        f.put('\x7f');
+    }
+    EXPECT_EQ(cache.load("corrupt"), nullptr);
+
+    std::filesystem::resize_file(cache.pathFor("short"),
+                                 std::filesystem::file_size(cache.pathFor("short")) - 4);
+    EXPECT_EQ(cache.load("short"), nullptr);
+}
+
+TEST_F(MeshCacheTest, RejectsUnsafeHashes) {
+    MeshCache cache(m_dir);
+    Mesh mesh = makeGrid(2);
+    EXPECT_TRUE(cache.pathFor("../escape").empty());
+    EXPECT_TRUE(cache.pathFor("").empty());
+    EXPECT_FALSE(cache.store("../escape", mesh));
+    EXPECT_EQ(cache.load("a/b"), nullptr);
+}
+
+TEST_F(MeshCacheTest, EvictsLeastRecentlyUsedOverCap) {
+    Mesh mesh = makeGrid(6);
+    MeshCache probe(m_dir);
+    ASSERT_TRUE(probe.store("probe", mesh));
+    const u64 entryBytes = std::filesystem::file_size(probe.pathFor("probe"));
+    ASSERT_TRUE(probe.remove("probe"));
+
+    // Room for two entries
+    MeshCache cache(m_dir, entryBytes * 2 + entryBytes / 2);
+    ASSERT_TRUE(cache.store("a", mesh));
+    ASSERT_TRUE(cache.store("b", mesh));
+    const auto old = std::filesystem::file_time_type::clock::now() - std::chrono::hours(2);
+    std::filesystem::last_write_time(cache.pathFor("a"), old);
+    std::filesystem::last_write_time(cache.pathFor("b"), old + std::chrono::hours(1));
+
+    ASSERT_NE(cache.load("a"), nullptr); // Hit refreshes "a"
+    ASSERT_TRUE(cache.store("c", mesh));
+    EXPECT_TRUE(cache.contains("a"));
+    EXPECT_FALSE(cache.contains("b"));
+    EXPECT_TRUE(cache.contains("c"));
+
+    // A cap below one entry still keeps the entry just written
+    MeshCache tiny(m_dir, 1);
+    ASSERT_TRUE(tiny.store("d", mesh));
+    EXPECT_TRUE(tiny.contains("d"));
+    EXPECT_FALSE(tiny.contains("a"));
+    EXPECT_FALSE(tiny.contains("c"));
+}
@@ -0,0 +1,289 @@
+// Digital Workshop - Parallel Mesh Operation Tests
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "core/mesh/mesh.h"
+#include "core/mesh/mesh_kernels.h"
+#include "core/threading/parallel_for.h"
+
+using namespace dw;
+
+namespace {
+
+// Wavy welded grid; large enough to span several parallel chunks
+Mesh makeWeldedGrid(int n) {
+    std::vector<Vertex> verts;
+    std::vector<u32> idx;
+    verts.reserve(static_cast<usize>((n + 1) * (n + 1)));
+    for (int y = 0; y <= n; ++y) {
+        for (int x = 0; x <= n; ++x) {
+            f32 fx = static_cast<f32>(x) * 0.37f;
+            f32 fy = static_cast<f32>(y) * 0.41f;
+            verts.emplace_back(Vec3{fx, fy, std::sin(fx) * std::cos(fy * 1.3f) * 3.0f});
+        }
+    }
+    auto at = [n](int x, int y) { return static_cast<u32>(y * (n + 1) + x); };
+    for (int y = 0; y < n; ++y) {
+        for (int x = 0; x < n; ++x) {
+            idx.insert(idx.end(), {at(x, y), at(x + 1, y), at(x + 1, y + 1)});
+            idx.insert(idx.end(), {at(x, y), at(x + 1, y + 1), at(x, y + 1)});
+        }
+    }
+    return Mesh(std::move(verts), std::move(idx));
+}
+
+// Same surface as unwelded soup (binary STL layout)
+Mesh makeSoup(int n) {
+    Mesh grid = makeWeldedGrid(n);
+    std::vector<Vertex> verts;
+    std::vector<u32> idx;
+    for (u32 i : grid.indices()) {
+        idx.push_back(static_cast<u32>(verts.size()));
+        verts.push_back(grid.vertices()[i]);
+    }
+    return Mesh(std::move(verts), std::move(idx));
+}
+
+bool sameBits(const std::vector<Vertex>& a, const std::vector<Vertex>& b) {
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(Vertex)) == 0;
+}
+
+bool sameBits(const AABB& a, const AABB& b) {
+    return std::memcmp(&a, &b, sizeof(AABB)) == 0;
+}
+
+// Original sequential scatter, kept as the reference
+void referenceNormals(std::vector<Vertex>& verts, const std::vector<u32>& idx) {
+    for (auto& v : verts)
+        v.normal = Vec3{0.0f, 0.0f, 0.0f};
+    for (usize i = 0; i + 2 < idx.size(); i += 3) {
+        Vec3 e1 = verts[idx[i + 1]].position - verts[idx[i]].position;
+        Vec3 e2 = verts[idx[i + 2]].position - verts[idx[i]].position;
+        Vec3 n = glm::cross(e1, e2);
+        for (int c = 0; c < 3; ++c)
+            verts[idx[i + static_cast<usize>(c)]].normal =
+                verts[idx[i + static_cast<usize>(c)]].normal + n;
+    }
+    for (auto& v : verts) {
+        f32 len = glm::length(v.normal);
+        v.normal = len > 1e-7f ? v.normal / len : Vec3{0.0f, 1.0f, 0.0f};
+    }
+}
+
+Mat4 testMatrix() {
+    Mat4 m(1.0f);
+    m[0] = Vec4{0.8f, 0.3f, -0.1f, 0.0f};
+    m[1] = Vec4{-0.2f, 1.1f, 0.4f, 0.0f};
+    m[2] = Vec4{0.05f, -0.3f, 0.9f, 0.0f};
+    m[3] = Vec4{12.5f, -3.25f, 7.0f, 1.0f};
+    return m;
+}
+
+class MeshParallelTest : public ::testing::Test {
+  protected:
+    void TearDown() override { setParallelThreadCount(0); }
+};
+
+} // namespace
+
+// --- parallelFor / parallelReduce ---
+
+TEST_F(MeshParallelTest, ParallelForVisitsEveryIndexOnce) {
+    setParallelThreadCount(4);
+    std::vector<std::atomic<int>> hits(10007);
+    parallelFor(hits.size(), 100, [&](usize begin, usize end) {
+        for (usize i = begin; i < end; ++i)
+            hits[i].fetch_add(1);
+    });
+    for (const auto& h : hits)
+        ASSERT_EQ(h.load(), 1);
+}
+
+TEST_F(MeshParallelTest, ParallelForEmptyAndZeroGrain) {
+    int calls = 0;
+    parallelFor(0, 64, [&](usize, usize) { ++calls; });
+    EXPECT_EQ(calls, 0);
+    EXPECT_EQ(parallelChunkCount(10, 0), 10u);
+    EXPECT_EQ(parallelChunkCount(10, 4), 3u);
+}
+
+TEST_F(MeshParallelTest, ReduceIsIndependentOfThreadCount) {
+    // Float sums depend on association order; fixed chunking must make it stable
+    std::vector<f32> values(100000);
+    for (usize i = 0; i < values.size(); ++i)
+        values[i] = std::sin(static_cast<f32>(i)) * 1000.0f + 1e-3f;
+
+    auto sum = [&] {
+        return parallelReduce(
+            values.size(),
+            1000,
+            0.0f,
+            [&](usize begin, usize end) {
+                f32 s = 0.0f;
+                for (usize i = begin; i < end; ++i)
+                    s += values[i];
+                return s;
+            },
+            [](f32 a, f32 b) { return a + b; });
+    };
+
+    setParallelThreadCount(1);
+    f32 serial = sum();
+    setParallelThreadCount(7);
+    f32 parallel = sum();
+    EXPECT_EQ(std::memcmp(&serial, &parallel, sizeof(f32)), 0);
+}
+
+TEST_F(MeshParallelTest, NestedCallsFromWorkersComplete) {
+    setParallelThreadCount(3);
+    std::atomic<usize> total{0};
+    parallelFor(8, 1, [&](usize, usize) {
+        parallelFor(1000, 10, [&](usize begin, usize end) { total.fetch_add(end - begin); });
+    });
+    EXPECT_EQ(total.load(), 8000u);
+}
+
+// --- Mesh operations: bit-identical across thread counts and to the scalar reference ---
+
+TEST_F(MeshParallelTest, NormalsMatchSequentialReferenceWelded) {
+    Mesh mesh = makeWeldedGrid(150);
+    auto expected = mesh.vertices();
+    referenceNormals(expected, mesh.indices());
+
+    for (usize threads : {1u, 2u, 5u}) {
+        setParallelThreadCount(threads);
+        Mesh copy = mesh.clone();
+        copy.recalculateNormals();
+        EXPECT_TRUE(sameBits(copy.vertices(), expected)) << "threads=" << threads;
+    }
+}
+
+TEST_F(MeshParallelTest, NormalsMatchSequentialReferenceSoup) {
+    Mesh mesh = makeSoup(100);
+    auto expected = mesh.vertices();
+    referenceNormals(expected, mesh.indices());
+
+    for (usize threads : {1u, 4u}) {
+        setParallelThreadCount(threads);
+        Mesh copy = mesh.clone();
+        copy.recalculateNormals();
+        EXPECT_TRUE(sameBits(copy.vertices(), expected)) << "threads=" << threads;
+    }
+}
+
+TEST_F(MeshParallelTest, NormalsSkipOutOfRangeIndices) {
+    Mesh mesh = makeWeldedGrid(4);
+    mesh.indices().insert(mesh.indices().end(), {0, 1, 9999});
+    mesh.recalculateNormals();
+    for (const auto& v : mesh.vertices())
+        EXPECT_NEAR(glm::length(v.normal), 1.0f, 1e-5f);
+}
+
+TEST_F(MeshParallelTest, TransformMatchesGlmAndThreadCounts) {
+    Mesh mesh = makeWeldedGrid(150);
+    mesh.recalculateNormals();
+    const Mat4 m = testMatrix();
+
+    setParallelThreadCount(1);
+    Mesh serial = mesh.clone();
+    serial.transform(m);
+    setParallelThreadCount(6);
+    Mesh parallel = mesh.clone();
+    parallel.transform(m);
+
+    EXPECT_TRUE(sameBits(serial.vertices(), parallel.vertices()));
+    EXPECT_TRUE(sameBits(serial.bounds(), parallel.bounds()));
+
+    // Same result as the plain GLM expression
+    for (usize i = 0; i < mesh.vertices().size(); i += 997) {
+        const Vertex& src = mesh.vertices()[i];
+        Vec4 p = m * Vec4(src.position, 1.0f);
+        const Vec3& got = parallel.vertices()[i].position;
+        EXPECT_FLOAT_EQ(got.x, p.x);
+        EXPECT_FLOAT_EQ(got.y, p.y);
+        EXPECT_FLOAT_EQ(got.z, p.z);
+        EXPECT_NEAR(glm::length(parallel.vertices()[i].normal), 1.0f, 1e-5f);
+    }
+
+    // Fused bounds equal a fresh recompute
+    AABB fused = parallel.bounds();
+    parallel.recalculateBounds();
+    EXPECT_TRUE(sameBits(fused, parallel.bounds()));
+}
+
+TEST_F(MeshParallelTest, BoundsMatchSequentialExpand) {
+    Mesh mesh = makeSoup(120);
+    AABB expected;
+    for (const auto& v : mesh.vertices())
+        expected.expand(v.position);
+
+    for (usize threads : {1u, 3u}) {
+        setParallelThreadCount(threads);
+        mesh.recalculateBounds();
+        EXPECT_TRUE(sameBits(mesh.bounds(), expected)) << "threads=" << threads;
+    }
+}
+
+TEST_F(MeshParallelTest, PlanarUVsIndependentOfThreadCount) {
+    setParallelThreadCount(1);
+    Mesh serial = makeWeldedGrid(150);
+    serial.generatePlanarUVs(30.0f);
+    setParallelThreadCount(4);
+    Mesh parallel = makeWeldedGrid(150);
+    parallel.generatePlanarUVs(30.0f);
+    EXPECT_TRUE(sameBits(serial.vertices(), parallel.vertices()));
+}
+
+TEST_F(MeshParallelTest, AutoOrientIndependentOfThreadCount) {
+    Mesh tall = makeWeldedGrid(150);
+    // Stand the relief up so autoOrient has to permute axes
+    Mat4 swapYZ(1.0f);
+    swapYZ[1] = Vec4{0.0f, 0.0f, 1.0f, 0.0f};
+    swapYZ[2] = Vec4{0.0f, 1.0f, 0.0f, 0.0f};
+    tall.transform(swapYZ);
+    tall.recalculateNormals();
+
+    setParallelThreadCount(1);
+    Mesh serial = tall.clone();
+    f32 yawSerial = serial.autoOrient();
+    setParallelThreadCount(4);
+    Mesh parallel = tall.clone();
+    f32 yawParallel = parallel.autoOrient();
+
+    EXPECT_EQ(yawSerial, yawParallel);
+    EXPECT_TRUE(sameBits(serial.vertices(), parallel.vertices()));
+}
+
+TEST_F(MeshParallelTest, ValidationCountsAcrossChunks) {
+    Mesh mesh = makeSoup(100);
+    ASSERT_TRUE(mesh.validate());
+
+    const f32 nan = std::numeric_limits<f32>::quiet_NaN();
+    const f32 inf = std::numeric_limits<f32>::infinity();
+    mesh.vertices()[5].position.x = nan;
+    mesh.vertices()[40000].position.z = -inf;
+    mesh.indices()[3] = 1u << 30;
+
+    setParallelThreadCount(4);
+    EXPECT_FALSE(mesh.validateGeometry());
+    EXPECT_FALSE(mesh.validate());
+    EXPECT_EQ(mesh_kernels::countNonFinitePositions(mesh.vertices().data(), mesh.vertices().size()),
+              2u);
+}
+
+TEST_F(MeshParallelTest, NonFiniteKernelChecksEachAxis) {
+    const f32 inf = std::numeric_limits<f32>::infinity();
+    std::vector<Vertex> verts = {
+        Vertex(Vec3{1.0f, 2.0f, 3.0f}, Vec3{inf, inf, inf}), // Normals are not checked
+        Vertex(Vec3{inf, 0.0f, 0.0f}),
+        Vertex(Vec3{0.0f, -inf, 0.0f}),
+        Vertex(Vec3{0.0f, 0.0f, std::numeric_limits<f32>::quiet_NaN()}),
+        Vertex(Vec3{std::numeric_limits<f32>::max(), 0.0f, 0.0f}),
+    };
+    EXPECT_EQ(mesh_kernels::countNonFinitePositions(verts.data(), verts.size()), 3u);
+}
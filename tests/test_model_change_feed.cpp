@@ -0,0 +1,91 @@
+// Digital Workshop - Model Change Feed Tests
+
+#include <gtest/gtest.h>
+
+#include "core/database/database.h"
+#include "core/database/model_change_feed.h"
+#include "core/database/model_repository.h"
+#include "core/database/schema.h"
+
+using namespace dw;
+
+namespace {
+
+const ModelChange* findChange(const ModelChangeBatch& batch, i64 modelId) {
+    for (const auto& c : batch.changes) {
+        if (c.modelId == modelId)
+            return &c;
+    }
+    return nullptr;
+}
+
+} // namespace
+
+TEST(ModelChangeFeed, VersionsIncrease) {
+    ModelChangeFeed feed;
+    EXPECT_EQ(feed.currentVersion(), 0u);
+    u64 v1 = feed.publish(ModelChangeKind::Added, 1);
+    u64 v2 = feed.publish(ModelChangeKind::Updated, 2);
+    EXPECT_LT(v1, v2);
+    EXPECT_EQ(feed.currentVersion(), v2);
+
+    auto batch = feed.changesSince(v2);
+    EXPECT_TRUE(batch.changes.empty());
+    EXPECT_FALSE(batch.overflowed);
+}
+
+TEST(ModelChangeFeed, CoalescesPerModel) {
+    ModelChangeFeed feed;
+    feed.publish(ModelChangeKind::Added, 1);
+    feed.publish(ModelChangeKind::Updated, 1);
+    feed.publish(ModelChangeKind::Updated, 2);
+    feed.publish(ModelChangeKind::Removed, 2);
+
+    auto batch = feed.changesSince(0);
+    ASSERT_EQ(batch.changes.size(), 2u);
+    EXPECT_EQ(findChange(batch, 1)->kind, ModelChangeKind::Added);
+    EXPECT_EQ(findChange(batch, 2)->kind, ModelChangeKind::Removed);
+    EXPECT_EQ(batch.latestVersion, 4u);
+}
+
+TEST(ModelChangeFeed, OverflowWhenBehindWindow) {
+    ModelChangeFeed feed(3);
+    for (i64 i = 1; i <= 5; ++i)
+        feed.publish(ModelChangeKind::Updated, i);
+
+    EXPECT_TRUE(feed.changesSince(0).overflowed);
+    auto batch = feed.changesSince(2);
+    EXPECT_FALSE(batch.overflowed);
+    EXPECT_EQ(batch.changes.size(), 3u);
+}
+
+TEST(ModelChangeFeed, RepositoryPublishesWrites) {
+    Database db;
+    ASSERT_TRUE(db.open(":memory:"));
+    ASSERT_TRUE(Schema::initialize(db));
+    ModelRepository repo(db);
+    auto& feed = ModelChangeFeed::instance();
+
+    ModelRecord rec;
+    rec.hash = "feed_hash";
+    rec.name = "feed_model";
+    u64 start = feed.currentVersion();
+    auto id = repo.insert(rec);
+    ASSERT_TRUE(id);
+    auto batch = feed.changesSince(start);
+    ASSERT_NE(findChange(batch, *id), nullptr);
+    EXPECT_EQ(findChange(batch, *id)->kind, ModelChangeKind::Added);
+
+    start = feed.currentVersion();
+    ASSERT_TRUE(repo.updateThumbnail(*id, "/thumbs/x.tga"));
+    EXPECT_EQ(findChange(feed.changesSince(start), *id)->kind, ModelChangeKind::Updated);
+
+    // No-op write (missing row) publishes nothing
+    start = feed.currentVersion();
+    ASSERT_TRUE(repo.updateThumbnail(*id + 1000, "/thumbs/y.tga"));
+    EXPECT_EQ(feed.currentVersion(), start);
+
+    start = feed.currentVersion();
+    ASSERT_TRUE(repo.removeByHash("feed_hash"));
+    EXPECT_EQ(findChange(feed.changesSince(start), *id)->kind, ModelChangeKind::Removed);
+}
@@ -236,3 +236,95 @@ TEST_F(ModelRepoTest, Count) {
     m_repo->insert(makeModel("h2", "b"));
     EXPECT_EQ(m_repo->count(), 2);
 }
+
+// --- Paged queries ---
+
+TEST_F(ModelRepoTest, FindPage_KeysetCoversAllRowsOnce) {
+    for (int i = 0; i < 7; ++i) {
+        ASSERT_TRUE(m_repo->insert(makeModel("h" + std::to_string(i), "m" + std::to_string(i))));
+    }
+
+    dw::ModelPageQuery query;
+    query.limit = 3;
+    std::vector<dw::i64> seen;
+    int pages = 0;
+    while (true) {
+        auto page = m_repo->findPage(query);
+        ++pages;
+        for (const auto& row : page.rows)
+            seen.push_back(row.id);
+        if (!page.next)
+            break;
+        query.after = page.next;
+    }
+
+    ASSERT_EQ(seen.size(), 7u);
+    EXPECT_EQ(pages, 3);
+    // Same imported_at timestamp -> newest ID first
+    for (size_t i = 1; i < seen.size(); ++i)
+        EXPECT_GT(seen[i - 1], seen[i]);
+}
+
+TEST_F(ModelRepoTest, FindPage_SummaryColumns) {
+    auto rec = makeModel("hs", "summary");
+    auto id = m_repo->insert(rec);
+    ASSERT_TRUE(id);
+    ASSERT_TRUE(m_repo->updateDescriptor(*id, "t", "d", "hover text"));
+
+    auto page = m_repo->findPage({});
+    ASSERT_EQ(page.rows.size(), 1u);
+    EXPECT_FALSE(page.next.has_value());
+    EXPECT_EQ(page.rows[0].name, "summary");
+    EXPECT_EQ(page.rows[0].triangleCount, 50u);
+    EXPECT_EQ(page.rows[0].descriptorHover, "hover text");
+}
+
+TEST_F(ModelRepoTest, FindPage_FiltersByNameAndCategory) {
+    auto a = m_repo->insert(makeModel("a", "chair_leg"));
+    auto b = m_repo->insert(makeModel("b", "chair_back"));
+    auto c = m_repo->insert(makeModel("c", "table_top"));
+    ASSERT_TRUE(a && b && c);
+    auto furniture = m_repo->createCategory("Furniture");
+    auto chairs = m_repo->createCategory("Chairs", furniture);
+    ASSERT_TRUE(furniture && chairs);
+    ASSERT_TRUE(m_repo->assignCategory(*a, *chairs));
+    ASSERT_TRUE(m_repo->assignCategory(*c, *furniture));
+
+    dw::ModelPageQuery query;
+    query.search = "chair";
+    query.useFTS = false;
+    EXPECT_EQ(m_repo->findPage(query).rows.size(), 2u);
+
+    // Subtree: Furniture includes Chairs
+    query.categoryId = *furniture;
+    auto page = m_repo->findPage(query);
+    ASSERT_EQ(page.rows.size(), 1u);
+    EXPECT_EQ(page.rows[0].id, *a);
+
+    query.search.clear();
+    EXPECT_EQ(m_repo->findPage(query).rows.size(), 2u);
+
+    EXPECT_TRUE(m_repo->findSummary(*c, query).has_value());
+    EXPECT_FALSE(m_repo->findSummary(*b, query).has_value());
+}
+
+TEST_F(ModelRepoTest, FindPage_FTSPagesByRank) {
+    for (int i = 0; i < 5; ++i) {
+        auto name = "bracket" + std::to_string(i);
+        ASSERT_TRUE(m_repo->insert(makeModel("f" + std::to_string(i), name)));
+    }
+    ASSERT_TRUE(m_repo->insert(makeModel("g", "gear")));
+
+    dw::ModelPageQuery query;
+    query.search = "bracket";
+    query.limit = 2;
+    size_t total = 0;
+    while (true) {
+        auto page = m_repo->findPage(query);
+        total += page.rows.size();
+        if (!page.next)
+            break;
+        query.after = page.next;
+    }
+    EXPECT_EQ(total, 5u);
+}
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "core/optimizer/multi_stock_optimizer.h"
+#include "core/threading/parallel_for.h"
 
 using namespace dw;
 using namespace dw::optimizer;
@@ -174,3 +175,142 @@ TEST(MultiStock, TotalCostAggregated) {
     EXPECT_GT(result.totalCost, 0.0f);
     EXPECT_GT(result.totalSheetsUsed, 0);
 }
+
+TEST(MultiStock, UsesAsManySheetsAsNeeded) {
+    // Stock is unlimited: ten parts that each fill most of a sheet need ten sheets
+    std::vector<Part> parts;
+    Part p(2000.0f, 1000.0f, 10);
+    p.materialId = 1;
+    parts.push_back(p);
+
+    Sheet stock(2440.0f, 1220.0f, 45.0f);
+    std::vector<MaterialGroup> materials = {
+        {1, "Plywood", {}, {stock}},
+    };
+
+    MultiStockResult result = optimizeMultiStock(
+        parts, materials, Algorithm::Guillotine, true, 0.0f, 0.0f);
+
+    ASSERT_EQ(result.groups.size(), 1u);
+    EXPECT_TRUE(result.groups[0].plan.isComplete());
+    EXPECT_EQ(result.groups[0].plan.sheetsUsed, 10);
+    EXPECT_NEAR(result.totalCost, 450.0f, 0.01f);
+}
+
+TEST(MultiStock, MixesCheaperStockForLastSheet) {
+    // Five 500x500 parts: two large sheets (200) or five small ones (300);
+    // one large sheet plus one small sheet for the fifth part costs 160
+    std::vector<Part> parts;
+    Part p(500.0f, 500.0f, 5);
+    p.materialId = 1;
+    parts.push_back(p);
+
+    Sheet large(1000.0f, 1000.0f, 100.0f);
+    large.name = "Large";
+    Sheet small(500.0f, 500.0f, 60.0f);
+    small.name = "Small";
+
+    std::vector<MaterialGroup> materials = {
+        {1, "Plywood", {}, {large, small}},
+    };
+
+    MultiStockResult result = optimizeMultiStock(
+        parts, materials, Algorithm::Guillotine, false, 0.0f, 0.0f);
+
+    ASSERT_EQ(result.groups.size(), 1u);
+    const auto& g = result.groups[0];
+    EXPECT_TRUE(g.plan.isComplete());
+    ASSERT_TRUE(g.mixedStock());
+    ASSERT_EQ(g.sheetStock.size(), 2u);
+    EXPECT_EQ(g.usedSheet.name, "Large");
+    EXPECT_EQ(g.stockFor(0).name, "Large");
+    EXPECT_EQ(g.stockFor(1).name, "Small");
+    EXPECT_NEAR(g.plan.totalCost, 160.0f, 0.01f);
+    EXPECT_NEAR(result.totalCost, 160.0f, 0.01f);
+    EXPECT_EQ(result.totalSheetsUsed, 2);
+}
+
+TEST(MultiStock, UnplaceablePartKeepsIncompletePlan) {
+    // No stock can hold the part; the group still reports it as unplaced
+    std::vector<Part> parts;
+    Part p(3000.0f, 3000.0f, 1);
+    p.materialId = 1;
+    parts.push_back(p);
+    Part q(100.0f, 100.0f, 3);
+    q.materialId = 1;
+    parts.push_back(q);
+
+    Sheet a(2440.0f, 1220.0f, 45.0f);
+    Sheet b(1220.0f, 610.0f, 20.0f);
+    std::vector<MaterialGroup> materials = {
+        {1, "Plywood", {}, {a, b}},
+    };
+
+    MultiStockResult result = optimizeMultiStock(
+        parts, materials, Algorithm::Guillotine, true, 0.0f, 0.0f);
+
+    ASSERT_EQ(result.groups.size(), 1u);
+    EXPECT_FALSE(result.groups[0].plan.isComplete());
+    EXPECT_EQ(result.groups[0].plan.unplacedParts.size(), 1u);
+    EXPECT_EQ(result.groups[0].plan.sheetsUsed, 1);
+}
+
+TEST(MultiStock, SameResultForAnyThreadCount) {
+    // Several groups and stock sizes, so trials prune each other
+    std::vector<Part> parts;
+    u32 seed = 12345u;
+    auto next = [&seed](f32 lo, f32 hi) {
+        seed = seed * 1664525u + 1013904223u;
+        return lo + (hi - lo) * static_cast<f32>(seed >> 8) / 16777216.0f;
+    };
+    for (int i = 0; i < 90; ++i) {
+        Part p(next(80.0f, 900.0f), next(80.0f, 600.0f), 1 + i % 3);
+        p.materialId = 1 + i % 3;
+        parts.push_back(p);
+    }
+
+    std::vector<Sheet> stock = {
+        Sheet(2440.0f, 1220.0f, 50.0f),
+        Sheet(1830.0f, 1220.0f, 40.0f),
+        Sheet(1220.0f, 1220.0f, 30.0f),
+        Sheet(1220.0f, 610.0f, 12.0f),
+    };
+    std::vector<MaterialGroup> materials = {
+        {1, "Plywood", {}, stock},
+        {2, "MDF", {}, stock},
+        {3, "Birch", {}, stock},
+    };
+
+    auto run = [&](usize threads) {
+        setParallelThreadCount(threads);
+        auto result = optimizeMultiStock(parts, materials, Algorithm::Guillotine, true, 3.0f, 5.0f);
+        setParallelThreadCount(0);
+        return result;
+    };
+    const MultiStockResult serial = run(1);
+    const MultiStockResult parallel = run(4);
+
+    ASSERT_EQ(serial.groups.size(), 3u);
+    ASSERT_EQ(parallel.groups.size(), serial.groups.size());
+    EXPECT_EQ(parallel.totalCost, serial.totalCost);
+    EXPECT_EQ(parallel.totalSheetsUsed, serial.totalSheetsUsed);
+    for (usize g = 0; g < serial.groups.size(); ++g) {
+        const auto& a = serial.groups[g];
+        const auto& b = parallel.groups[g];
+        EXPECT_TRUE(a.plan.isComplete());
+        EXPECT_EQ(b.usedSheet.width, a.usedSheet.width);
+        EXPECT_EQ(b.sheetStock.size(), a.sheetStock.size());
+        ASSERT_EQ(b.plan.sheets.size(), a.plan.sheets.size());
+        for (usize s = 0; s < a.plan.sheets.size(); ++s) {
+            const auto& pa = a.plan.sheets[s].placements;
+            const auto& pb = b.plan.sheets[s].placements;
+            ASSERT_EQ(pb.size(), pa.size());
+            for (usize i = 0; i < pa.size(); ++i) {
+                EXPECT_EQ(pb[i].partIndex, pa[i].partIndex);
+                EXPECT_EQ(pb[i].x, pa[i].x);
+                EXPECT_EQ(pb[i].y, pa[i].y);
+                EXPECT_EQ(pb[i].rotated, pa[i].rotated);
+            }
+        }
+    }
+}
@@ -384,3 +384,47 @@ TEST(Guillotine, NonZeroEfficiency) {
     EXPECT_GT(plan.overallEfficiency(), 0.0f);
     EXPECT_LE(plan.overallEfficiency(), 1.0f);
 }
+
+TEST(Guillotine, ReusedOptimizerMatchesFresh) {
+    // Deterministic mixed part sets of different sizes
+    auto makeParts = [](unsigned seed, int count) {
+        std::vector<Part> parts;
+        for (int i = 0; i < count; ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            const dw::f32 w = 40.0f + static_cast<dw::f32>(seed % 400u);
+            seed = seed * 1664525u + 1013904223u;
+            const dw::f32 h = 30.0f + static_cast<dw::f32>(seed % 300u);
+            parts.push_back(Part(w, h, 1 + static_cast<int>(seed % 3u)));
+        }
+        return parts;
+    };
+    const std::vector<Sheet> sheets(8, Sheet(1220.0f, 2440.0f));
+
+    GuillotineOptimizer reused;
+    reused.setKerf(3.2f);
+    reused.setMargin(10.0f);
+    for (int run = 0; run < 4; ++run) {
+        const auto parts = makeParts(static_cast<unsigned>(run % 2 + 1), run % 2 == 0 ? 60 : 15);
+
+        GuillotineOptimizer fresh;
+        fresh.setKerf(3.2f);
+        fresh.setMargin(10.0f);
+        const CutPlan expected = fresh.optimize(parts, sheets);
+        const CutPlan actual = reused.optimize(parts, sheets);
+
+        ASSERT_EQ(actual.sheets.size(), expected.sheets.size()) << "run " << run;
+        EXPECT_EQ(actual.unplacedParts.size(), expected.unplacedParts.size());
+        for (size_t s = 0; s < expected.sheets.size(); ++s) {
+            const auto& a = actual.sheets[s].placements;
+            const auto& e = expected.sheets[s].placements;
+            ASSERT_EQ(a.size(), e.size()) << "run " << run << " sheet " << s;
+            for (size_t p = 0; p < e.size(); ++p) {
+                EXPECT_EQ(a[p].partIndex, e[p].partIndex);
+                EXPECT_EQ(a[p].instanceIndex, e[p].instanceIndex);
+                EXPECT_EQ(a[p].x, e[p].x);
+                EXPECT_EQ(a[p].y, e[p].y);
+                EXPECT_EQ(a[p].rotated, e[p].rotated);
+            }
+        }
+    }
+}
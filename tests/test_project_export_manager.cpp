@@ -11,6 +11,7 @@
 #include "core/database/project_repository.h"
 #include "core/database/schema.h"
 #include "core/export/project_export_manager.h"
+#include "core/mesh/hash.h"
 #include "core/paths/app_paths.h"
 #include "core/paths/path_resolver.h"
 #include "core/project/project.h"
@@ -589,3 +590,73 @@ TEST_F(ProjectExportTest, RoundTripAllAssetTypes) {
     EXPECT_FLOAT_EQ(importedPlans[0].kerf, 3.2f);
     EXPECT_FALSE(importedPlans[0].sheetConfigJson.empty());
 }
+
+TEST_F(ProjectExportTest, ExportStoresPrecompressedBlobsAndRecordsContentHash) {
+    dw::ProjectRepository projRepo(m_db);
+    dw::ProjectRecord projRec;
+    projRec.name = "Mixed Formats";
+    auto projId = projRepo.insert(projRec);
+    ASSERT_TRUE(projId.has_value());
+    ASSERT_TRUE(projRepo.addModel(*projId, insertModelWithFile("hash_3mf_0001", "Packed", ".3mf")));
+    ASSERT_TRUE(projRepo.addModel(*projId, insertModelWithFile("hash_stl_0001", "Plain", ".stl")));
+
+    dw::Project project;
+    project.record().id = *projId;
+    project.record().name = "Mixed Formats";
+
+    dw::ProjectExportManager exporter(m_db);
+    auto result = exporter.exportProject(project, m_archivePath);
+    ASSERT_TRUE(result.success) << result.error;
+
+    mz_zip_archive zip{};
+    ASSERT_TRUE(mz_zip_reader_init_file(&zip, m_archivePath.c_str(), 0));
+    auto methodOf = [&zip](const char* name) {
+        int index = mz_zip_reader_locate_file(&zip, name, nullptr, 0);
+        EXPECT_GE(index, 0) << name;
+        mz_zip_archive_file_stat stat{};
+        EXPECT_TRUE(mz_zip_reader_file_stat(&zip, static_cast<mz_uint>(index), &stat));
+        return static_cast<int>(stat.m_method);
+    };
+    EXPECT_EQ(methodOf("models/hash_3mf_0001.3mf"), 0);
+    EXPECT_EQ(methodOf("models/hash_stl_0001.stl"), MZ_DEFLATED);
+
+    size_t manifestSize = 0;
+    void* manifestData =
+        mz_zip_reader_extract_file_to_heap(&zip, "manifest.json", &manifestSize, 0);
+    ASSERT_NE(manifestData, nullptr);
+    auto j = nlohmann::json::parse(
+        std::string(static_cast<const char*>(manifestData), manifestSize));
+    mz_free(manifestData);
+    mz_zip_reader_end(&zip);
+
+    for (const auto& m : j["models"]) {
+        std::string content = "BINARYDATA_" + m["hash"].get<std::string>();
+        EXPECT_EQ(m["content_hash"].get<std::string>(),
+                  dw::hash::computeBuffer(dw::ByteBuffer(content.begin(), content.end())));
+    }
+}
+
+TEST_F(ProjectExportTest, ImportRejectsBlobWithWrongContentHash) {
+    nlohmann::json manifest;
+    manifest["format_version"] = 2;
+    manifest["project_name"] = "Tampered";
+
+    nlohmann::json model;
+    model["name"] = "Tampered Model";
+    model["hash"] = "tampered_hash_01";
+    model["content_hash"] = "0123456789abcdef";
+    model["file_in_archive"] = "models/tampered_hash_01.stl";
+    model["file_format"] = "stl";
+    manifest["models"] = nlohmann::json::array({model});
+
+    createArchiveWithManifest(
+        m_archivePath, manifest, {{"models/tampered_hash_01.stl", "not what the hash says"}});
+
+    dw::ProjectExportManager importer(m_db);
+    auto result = importer.importProject(m_archivePath);
+    ASSERT_TRUE(result.success) << result.error;
+    EXPECT_EQ(result.modelCount, 0);
+
+    dw::ModelRepository modelRepo(m_db);
+    EXPECT_FALSE(modelRepo.exists("tampered_hash_01"));
+}
@@ -0,0 +1,341 @@
+// Digital Workshop - Stock Material Removal Simulation Tests
+
+#include <gtest/gtest.h>
+
+#include "core/carve/stock_simulator.h"
+#include "core/threading/parallel_for.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+using dw::f32;
+using dw::Vec3;
+using dw::carve::StockConfig;
+using dw::carve::StockSimulator;
+using dw::carve::ToolProfile;
+
+dw::gcode::PathSegment seg(Vec3 a, Vec3 b, bool rapid = false, int tool = 1) {
+    dw::gcode::PathSegment s;
+    s.start = a;
+    s.end = b;
+    s.isRapid = rapid;
+    s.toolNumber = tool;
+    return s;
+}
+
+// 20 x 20 mm stock, top at Z0, 0.1 mm cells (cell centers at .05, .15, ...)
+StockConfig squareStock() {
+    StockConfig config;
+    config.min = Vec3{0.0f, 0.0f, -10.0f};
+    config.max = Vec3{20.0f, 20.0f, 0.0f};
+    config.resolutionMm = 0.1f;
+    return config;
+}
+
+// Zigzag raster with a wavy depth, enough segments to cross checkpoints
+dw::gcode::Program raster(int lines) {
+    dw::gcode::Program program;
+    for (int i = 0; i < lines; ++i) {
+        f32 y = 1.0f + static_cast<f32>(i) * 0.06f;
+        f32 z = -1.0f - 0.5f * std::sin(static_cast<f32>(i) * 0.3f);
+        bool forward = (i % 2) == 0;
+        program.path.push_back(seg({forward ? 1.0f : 19.0f, y, z}, {forward ? 19.0f : 1.0f, y, z}));
+        if (i + 1 < lines) {
+            f32 ny = y + 0.06f;
+            f32 nz = -1.0f - 0.5f * std::sin(static_cast<f32>(i + 1) * 0.3f);
+            f32 x = forward ? 19.0f : 1.0f;
+            program.path.push_back(seg({x, y, z}, {x, ny, nz}));
+        }
+    }
+    return program;
+}
+
+int cellOf(f32 mm) {
+    return static_cast<int>(std::floor(mm / 0.1f));
+}
+
+} // namespace
+
+TEST(ToolProfile, ShapeHeights) {
+    auto flat = ToolProfile::flat(6.0f);
+    EXPECT_FLOAT_EQ(flat.heightAt(0.0f), 0.0f);
+    EXPECT_FLOAT_EQ(flat.heightAt(3.0f), 0.0f);
+
+    auto ball = ToolProfile::ball(6.0f);
+    EXPECT_FLOAT_EQ(ball.heightAt(0.0f), 0.0f);
+    EXPECT_NEAR(ball.heightAt(3.0f), 3.0f, 1e-5f);
+    EXPECT_NEAR(ball.heightAt(1.5f), 3.0f - std::sqrt(9.0f - 2.25f), 1e-5f);
+
+    auto vbit = ToolProfile::vBit(12.0f, 90.0f);
+    EXPECT_NEAR(vbit.heightAt(2.0f), 2.0f, 1e-5f);  // 45 deg flank
+    EXPECT_NEAR(vbit.heightAt(50.0f), 6.0f, 1e-5f); // Clamped to radius
+
+    auto bull = ToolProfile::flat(6.0f, 1.0f);
+    EXPECT_FLOAT_EQ(bull.heightAt(2.0f), 0.0f);
+    EXPECT_NEAR(bull.heightAt(3.0f), 1.0f, 1e-5f);
+}
+
+TEST(ToolProfile, FromGeometryConvertsImperial) {
+    dw::VtdbToolGeometry g;
+    g.tool_type = dw::VtdbToolType::EndMill;
+    g.units = dw::VtdbUnits::Imperial;
+    g.diameter = 0.25;
+    auto p = ToolProfile::fromGeometry(g);
+    EXPECT_EQ(p.shape, ToolProfile::Shape::Flat);
+    EXPECT_NEAR(p.radius, 3.175f, 1e-4f);
+
+    g.tool_type = dw::VtdbToolType::VBit;
+    g.units = dw::VtdbUnits::Metric;
+    g.diameter = 10.0;
+    g.included_angle = 60.0;
+    p = ToolProfile::fromGeometry(g);
+    EXPECT_EQ(p.shape, ToolProfile::Shape::VBit);
+    EXPECT_NEAR(p.slope, 1.0f / std::tan(30.0f * 3.14159265f / 180.0f), 1e-4f);
+}
+
+TEST(StockSimulator, FlatEndMillCutsSlot) {
+    dw::gcode::Program program;
+    program.path.push_back(seg({2.0f, 10.0f, 5.0f}, {2.0f, 10.0f, -1.0f}));
+    program.path.push_back(seg({2.0f, 10.0f, -1.0f}, {18.0f, 10.0f, -1.0f}));
+
+    StockSimulator sim;
+    sim.reset(squareStock());
+    sim.setProgram(program);
+    sim.setToolProfiles({}, ToolProfile::flat(2.0f));
+    sim.simulateTo(program.path.size());
+
+    EXPECT_FLOAT_EQ(sim.at(cellOf(10.0f), cellOf(10.0f)), -1.0f);
+    EXPECT_FLOAT_EQ(sim.at(cellOf(10.0f), cellOf(10.5f)), -1.0f);
+    EXPECT_FLOAT_EQ(sim.at(cellOf(10.0f), cellOf(11.5f)), 0.0f); // Outside radius
+    EXPECT_FLOAT_EQ(sim.at(cellOf(19.5f), cellOf(10.0f)), 0.0f); // Past the end
+    EXPECT_EQ(sim.simulatedSegments(), 2u);
+}
+
+TEST(StockSimulator, BallNoseLeavesRoundGroove) {
+    dw::gcode::Program program;
+    program.path.push_back(seg({2.0f, 10.0f, -2.0f}, {18.0f, 10.0f, -2.0f}));
+
+    StockSimulator sim;
+    sim.reset(squareStock());
+    sim.setProgram(program);
+    sim.setToolProfiles({{1, ToolProfile::ball(4.0f)}}, ToolProfile::flat(1.0f));
+    sim.simulateTo(1);
+
+    for (f32 off : {0.05f, 0.55f, 1.05f, 1.55f}) {
+        f32 expected = -2.0f + (2.0f - std::sqrt(4.0f - off * off));
+        EXPECT_NEAR(sim.at(cellOf(10.0f), cellOf(10.0f + off)), expected, 1e-3f) << off;
+    }
+}
+
+TEST(StockSimulator, SlopedPassTakesLowestCutterPoint) {
+    // V-bit descending along X: each cell sees the lowest point of the cone
+    dw::gcode::Program program;
+    program.path.push_back(seg({5.0f, 10.0f, 0.0f}, {15.0f, 10.0f, -2.0f}));
+
+    StockSimulator sim;
+    sim.reset(squareStock());
+    sim.setProgram(program);
+    sim.setToolProfiles({}, ToolProfile::vBit(10.0f, 90.0f));
+    sim.simulateTo(1);
+
+    // Cell center (10.05, 10.05) sits 0.05 mm off the centerline. The tip drops
+    // 0.2 mm per mm, so the lowest flank point is slightly past the cell:
+    // min_s -0.2 (5.05 + s) + sqrt(s^2 + 0.05^2) = -1.01 + 0.05 sqrt(1 - 0.04)
+    EXPECT_NEAR(sim.at(cellOf(10.0f), cellOf(10.0f)),
+                -1.01f + 0.05f * std::sqrt(0.96f),
+                1e-4f);
+    // Beyond the end, the cone flank from the final position
+    EXPECT_NEAR(sim.at(cellOf(16.0f), cellOf(10.0f)),
+                -2.0f + std::sqrt(1.05f * 1.05f + 0.05f * 0.05f),
+                1e-4f);
+}
+
+TEST(StockSimulator, TaperedBallOverStepFindsLowestPoint) {
+    // Steep step down with a tapered ball (3 mm tip, 30 deg taper): where the
+    // ball meets the taper the cutter surface has two local minima per cell
+    dw::VtdbToolGeometry g;
+    g.tool_type = dw::VtdbToolType::TaperedBallNose;
+    g.units = dw::VtdbUnits::Metric;
+    g.diameter = 6.0;
+    g.tip_radius = 1.5;
+    g.included_angle = 30.0;
+    const ToolProfile tool = ToolProfile::fromGeometry(g);
+    const Vec3 a{9.0f, 10.0f, 0.0f};
+    const Vec3 b{11.0f, 10.0f, -6.0f};
+
+    dw::gcode::Program program;
+    program.path.push_back(seg(a, b));
+    StockSimulator sim;
+    sim.reset(squareStock());
+    sim.setProgram(program);
+    sim.setToolProfiles({}, tool);
+    sim.simulateTo(1);
+
+    // Reference: dense sampling of the cutter along the segment
+    auto lowest = [&](f32 x, f32 y) {
+        f32 z = 0.0f;
+        for (int i = 0; i <= 20000; ++i) {
+            const f32 t = static_cast<f32>(i) / 20000.0f;
+            const f32 px = a.x + (b.x - a.x) * t;
+            const f32 d = std::hypot(x - px, y - a.y);
+            if (d <= tool.radius)
+                z = std::min(z, a.z + (b.z - a.z) * t + tool.heightAt(d));
+        }
+        return z;
+    };
+    for (f32 y : {10.05f, 10.65f, 11.05f, 11.45f}) {
+        for (f32 x : {8.55f, 9.15f, 9.75f, 10.35f}) {
+            EXPECT_NEAR(sim.at(cellOf(x), cellOf(y)), lowest(x, y), 2e-3f) << x << ", " << y;
+        }
+    }
+}
+
+TEST(StockSimulator, PartialProgressCutsPrefix) {
+    dw::gcode::Program program;
+    program.path.push_back(seg({2.0f, 10.0f, -1.0f}, {18.0f, 10.0f, -1.0f}));
+
+    StockSimulator sim;
+    sim.reset(squareStock());
+    sim.setProgram(program);
+    sim.setToolProfiles({}, ToolProfile::flat(1.0f));
+    sim.simulateTo(0, 0.5f);
+
+    EXPECT_FLOAT_EQ(sim.at(cellOf(5.0f), cellOf(10.0f)), -1.0f);
+    EXPECT_FLOAT_EQ(sim.at(cellOf(15.0f), cellOf(10.0f)), 0.0f);
+
+    sim.simulateTo(0, 0.25f); // Backwards within the same segment
+    EXPECT_FLOAT_EQ(sim.at(cellOf(5.0f), cellOf(10.0f)), -1.0f);
+    EXPECT_FLOAT_EQ(sim.at(cellOf(9.0f), cellOf(10.0f)), 0.0f);
+}
+
+TEST(StockSimulator, RapidsAboveStockAreIgnored) {
+    dw::gcode::Program program;
+    program.path.push_back(seg({0.0f, 0.0f, 5.0f}, {20.0f, 20.0f, 5.0f}, true));
+
+    StockSimulator sim;
+    sim.reset(squareStock());
+    sim.setProgram(program);
+    (void)sim.takeDirtyRegion();
+    sim.simulateTo(1);
+    EXPECT_TRUE(sim.takeDirtyRegion().empty());
+}
+
+TEST(StockSimulator, DirtyRegionTracksSweeps) {
+    dw::gcode::Program program;
+    program.path.push_back(seg({5.0f, 5.0f, -1.0f}, {6.0f, 5.0f, -1.0f}));
+
+    StockSimulator sim;
+    sim.reset(squareStock());
+    sim.setProgram(program);
+    sim.setToolProfiles({}, ToolProfile::flat(1.0f));
+
+    auto all = sim.takeDirtyRegion(); // Fresh stock: whole grid
+    EXPECT_EQ(all.col1, sim.cols());
+    EXPECT_EQ(all.row1, sim.rows());
+    EXPECT_TRUE(sim.takeDirtyRegion().empty());
+
+    sim.simulateTo(1);
+    auto dirty = sim.takeDirtyRegion();
+    EXPECT_LE(dirty.col0, cellOf(4.5f) + 1);
+    EXPECT_GE(dirty.col1, cellOf(6.5f));
+    EXPECT_LE(dirty.row0, cellOf(4.5f) + 1);
+    EXPECT_GE(dirty.row1, cellOf(5.5f));
+    EXPECT_LT(dirty.col1 - dirty.col0, 40);
+}
+
+TEST(StockSimulator, ScrubBackwardMatchesFreshRun) {
+    auto program = raster(300); // ~600 segments, several checkpoints
+    StockSimulator scrubbed;
+    scrubbed.reset(squareStock());
+    scrubbed.setProgram(program);
+    scrubbed.setToolProfiles({}, ToolProfile::ball(1.0f));
+    scrubbed.simulateTo(program.path.size());
+    scrubbed.simulateTo(333, 0.4f);
+
+    StockSimulator fresh;
+    fresh.reset(squareStock());
+    fresh.setProgram(program);
+    fresh.setToolProfiles({}, ToolProfile::ball(1.0f));
+    fresh.simulateTo(333, 0.4f);
+
+    ASSERT_EQ(scrubbed.heights().size(), fresh.heights().size());
+    EXPECT_EQ(std::memcmp(scrubbed.heights().data(),
+                          fresh.heights().data(),
+                          fresh.heights().size() * sizeof(f32)),
+              0);
+}
+
+TEST(StockSimulator, ResultIndependentOfThreadCount) {
+    auto program = raster(120);
+    std::vector<f32> reference;
+    for (dw::usize threads : {1u, 4u}) {
+        dw::setParallelThreadCount(threads);
+        StockSimulator sim;
+        sim.reset(squareStock());
+        sim.setProgram(program);
+        sim.setToolProfiles({}, ToolProfile::vBit(3.0f, 60.0f));
+        sim.simulateTo(program.path.size());
+        if (reference.empty()) {
+            reference = sim.heights();
+        } else {
+            EXPECT_EQ(std::memcmp(reference.data(),
+                                  sim.heights().data(),
+                                  reference.size() * sizeof(f32)),
+                      0);
+        }
+    }
+    dw::setParallelThreadCount(0);
+}
+
+TEST(StockSimulator, DeviationAgainstTarget) {
+    // Target: flat surface at Z = -0.5 over the whole stock
+    std::vector<dw::Vertex> verts = {
+        dw::Vertex({0.0f, 0.0f, -0.5f}),
+        dw::Vertex({20.0f, 0.0f, -0.5f}),
+        dw::Vertex({20.0f, 20.0f, -0.5f}),
+        dw::Vertex({0.0f, 20.0f, -0.5f}),
+    };
+    std::vector<dw::u32> indices = {0, 1, 2, 0, 2, 3};
+    dw::carve::Heightmap target;
+    dw::carve::HeightmapConfig hmConfig;
+    hmConfig.resolutionMm = 0.5f;
+    target.build(verts, indices, Vec3{0.0f, 0.0f, -0.5f}, Vec3{20.0f, 20.0f, -0.5f}, hmConfig);
+
+    dw::gcode::Program program;
+    program.path.push_back(seg({2.0f, 10.0f, -1.0f}, {18.0f, 10.0f, -1.0f}));
+
+    StockSimulator sim;
+    sim.reset(squareStock());
+    sim.setProgram(program);
+    sim.setToolProfiles({}, ToolProfile::flat(2.0f));
+    sim.simulateTo(1);
+
+    dw::carve::DeviationStats stats;
+    auto deviation = sim.deviationMap(target, 0.01f, &stats);
+    ASSERT_EQ(deviation.size(), sim.heights().size());
+    EXPECT_GT(stats.comparedCells, 0u);
+    EXPECT_NEAR(stats.minDeviation, -0.5f, 1e-4f); // Gouged slot
+    EXPECT_NEAR(stats.maxDeviation, 0.5f, 1e-4f);  // Uncut stock above target
+    EXPECT_GT(stats.gougeCells, 0u);
+    EXPECT_NEAR(deviation[static_cast<size_t>(cellOf(10.0f) * sim.cols() + cellOf(10.0f))],
+                -0.5f,
+                1e-4f);
+}
+
+TEST(StockConfigTest, FromProgram) {
+    dw::gcode::Program program;
+    program.path.push_back(seg({0.0f, 0.0f, 5.0f}, {10.0f, 4.0f, 5.0f}, true));
+    program.path.push_back(seg({10.0f, 4.0f, 5.0f}, {10.0f, 4.0f, -3.0f}));
+    program.boundsMin = Vec3{0.0f, 0.0f, -3.0f};
+    program.boundsMax = Vec3{10.0f, 4.0f, 5.0f};
+
+    auto config = StockConfig::fromProgram(program, 2.0f);
+    EXPECT_FLOAT_EQ(config.max.z, 0.0f); // Cuts below zero: Z0 is the top
+    EXPECT_FLOAT_EQ(config.min.z, -4.0f);
+    EXPECT_FLOAT_EQ(config.min.x, -2.0f);
+    EXPECT_FLOAT_EQ(config.max.y, 6.0f);
+}
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <chrono>
 #include <fstream>
 
@@ -124,6 +125,45 @@ TEST_F(StorageManagerTest, StoreFileHashMismatch) {
     }
 }
 
+TEST_F(StorageManagerTest, StoreStreamVerifiesHash) {
+    const std::string content = "streamed blob content, written in pieces";
+    ByteBuffer bytes(content.begin(), content.end());
+    std::string contentHash = hash::computeBuffer(bytes);
+
+    auto producePieces = [&content](const StorageManager::BlobSink& sink) {
+        for (usize i = 0; i < content.size(); i += 7) {
+            usize n = std::min<usize>(7, content.size() - i);
+            if (!sink(content.data() + i, n))
+                return false;
+        }
+        return true;
+    };
+
+    std::string error;
+    Path stored = mgr->storeStream(contentHash, "stl", producePieces, error);
+    ASSERT_FALSE(stored.empty()) << error;
+    EXPECT_EQ(hash::computeFile(stored), contentHash);
+
+    // Existing blob: producer is not invoked
+    bool called = false;
+    Path again = mgr->storeStream(
+        contentHash,
+        "stl",
+        [&called](const StorageManager::BlobSink&) {
+            called = true;
+            return true;
+        },
+        error);
+    EXPECT_EQ(again, stored);
+    EXPECT_FALSE(called);
+
+    // Wrong hash is rejected and leaves nothing behind
+    Path bad = mgr->storeStream("deadbeef12345678", "stl", producePieces, error);
+    EXPECT_TRUE(bad.empty());
+    EXPECT_NE(error.find("Hash verification failed"), std::string::npos) << "Error was: " << error;
+    EXPECT_FALSE(fs::exists(mgr->blobPath("deadbeef12345678", "stl")));
+}
+
 TEST_F(StorageManagerTest, MoveFileBasic) {
     Path source = createTestFile("test_move.stl", "move content");
     std::string fileHash = hash::computeFile(source);
@@ -0,0 +1,266 @@
+// Digital Workshop - Thumbnail Cache Tests
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+
+#include "core/library/thumbnail_cache.h"
+
+using namespace dw;
+
+namespace {
+
+class ThumbnailCacheTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        m_dir = std::filesystem::temp_directory_path() / "dw_test_thumbnail_cache";
+        std::filesystem::remove_all(m_dir);
+        std::filesystem::create_directories(m_dir);
+    }
+
+    void TearDown() override { std::filesystem::remove_all(m_dir); }
+
+    // Write a 32bpp BGRA TGA with a deterministic gradient
+    Path writeTGA(const std::string& name, int w, int h) {
+        Path p = m_dir / name;
+        std::ofstream f(p, std::ios::binary);
+        u8 header[18] = {0};
+        header[2] = 2;
+        header[12] = static_cast<u8>(w & 0xFF);
+        header[13] = static_cast<u8>(w >> 8);
+        header[14] = static_cast<u8>(h & 0xFF);
+        header[15] = static_cast<u8>(h >> 8);
+        header[16] = 32;
+        header[17] = 0x20;
+        f.write(reinterpret_cast<const char*>(header), 18);
+        for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                u8 px[4] = {static_cast<u8>(x), static_cast<u8>(y), 200, 255}; // B, G, R, A
+                f.write(reinterpret_cast<const char*>(px), 4);
+            }
+        }
+        return p;
+    }
+
+    static ThumbnailImage solid(int w, int h, u8 value) {
+        ThumbnailImage img;
+        img.width = w;
+        img.height = h;
+        img.rgba.assign(static_cast<usize>(w) * static_cast<usize>(h) * 4, value);
+        return img;
+    }
+
+    // Pseudo-random pixels, so the stored record barely compresses
+    static ThumbnailImage noise(int w, int h, u32 seed) {
+        ThumbnailImage img = solid(w, h, 0);
+        for (auto& b : img.rgba) {
+            seed = seed * 1664525u + 1013904223u;
+            b = static_cast<u8>(seed >> 24);
+        }
+        return img;
+    }
+
+    Path m_dir;
+};
+
+} // namespace
+
+// --- Decode ---
+
+TEST_F(ThumbnailCacheTest, DecodeTGA_SwapsToRGBA) {
+    auto path = writeTGA("a.tga", 8, 4);
+    auto img = thumbnail::decodeTGA(path);
+    ASSERT_TRUE(img.has_value());
+    EXPECT_EQ(img->width, 8);
+    EXPECT_EQ(img->height, 4);
+    ASSERT_EQ(img->rgba.size(), 8u * 4u * 4u);
+
+    // Pixel (3, 2): B=3, G=2, R=200 on disk -> R=200, G=2, B=3
+    usize o = (2 * 8 + 3) * 4;
+    EXPECT_EQ(img->rgba[o + 0], 200);
+    EXPECT_EQ(img->rgba[o + 1], 2);
+    EXPECT_EQ(img->rgba[o + 2], 3);
+    EXPECT_EQ(img->rgba[o + 3], 255);
+}
+
+TEST_F(ThumbnailCacheTest, DecodeTGA_MissingFile) {
+    EXPECT_FALSE(thumbnail::decodeTGA(m_dir / "missing.tga").has_value());
+}
+
+// --- Mip chain ---
+
+TEST_F(ThumbnailCacheTest, MipChain_HalvesDownToMinSize) {
+    auto chain = thumbnail::buildMipChain(solid(512, 512, 100), 64);
+    ASSERT_EQ(chain.size(), 4u);
+    EXPECT_EQ(chain[0].width, 512);
+    EXPECT_EQ(chain[1].width, 256);
+    EXPECT_EQ(chain[2].width, 128);
+    EXPECT_EQ(chain[3].width, 64);
+    // Box filter of a solid image stays solid
+    EXPECT_EQ(chain[3].rgba[0], 100);
+}
+
+TEST_F(ThumbnailCacheTest, SelectMipLevel_SmallestSufficient) {
+    std::vector<int> widths = {512, 256, 128, 64};
+    EXPECT_EQ(thumbnail::selectMipLevel(widths, 48.0f), 3u);
+    EXPECT_EQ(thumbnail::selectMipLevel(widths, 96.0f), 2u);
+    EXPECT_EQ(thumbnail::selectMipLevel(widths, 200.0f), 1u);
+    EXPECT_EQ(thumbnail::selectMipLevel(widths, 900.0f), 0u);
+}
+
+// --- Atlas ---
+
+TEST_F(ThumbnailCacheTest, Atlas_StoreAndLoadRoundtrip) {
+    ThumbnailAtlas atlas;
+    ASSERT_TRUE(atlas.open(m_dir / "thumbs.dwtc"));
+
+    ThumbnailStamp stamp{1234, 99};
+    auto chain = thumbnail::buildMipChain(solid(128, 128, 42), 32);
+    ASSERT_TRUE(atlas.store(7, stamp, chain));
+
+    auto widths = atlas.levelWidths(7, stamp);
+    ASSERT_EQ(widths.size(), 3u);
+    EXPECT_EQ(widths[2], 32);
+
+    auto img = atlas.load(7, stamp, 1);
+    ASSERT_TRUE(img.has_value());
+    EXPECT_EQ(img->width, 64);
+    EXPECT_EQ(img->rgba, chain[1].rgba);
+}
+
+TEST_F(ThumbnailCacheTest, Atlas_StaleStampMisses) {
+    ThumbnailAtlas atlas;
+    ASSERT_TRUE(atlas.open(m_dir / "thumbs.dwtc"));
+    ASSERT_TRUE(atlas.store(1, ThumbnailStamp{10, 1}, {solid(16, 16, 1)}));
+
+    EXPECT_TRUE(atlas.levelWidths(1, ThumbnailStamp{10, 2}).empty());
+    EXPECT_FALSE(atlas.load(1, ThumbnailStamp{10, 2}, 0).has_value());
+}
+
+TEST_F(ThumbnailCacheTest, Atlas_PersistsAcrossReopen) {
+    Path path = m_dir / "thumbs.dwtc";
+    ThumbnailStamp stamp{5, 5};
+    {
+        ThumbnailAtlas atlas;
+        ASSERT_TRUE(atlas.open(path));
+        ASSERT_TRUE(atlas.store(1, stamp, {solid(16, 16, 1)}));
+        ASSERT_TRUE(atlas.store(2, stamp, {solid(16, 16, 2)}));
+        ASSERT_TRUE(atlas.store(1, stamp, {solid(16, 16, 3)})); // Replaces model 1
+        atlas.invalidate(2);
+    }
+
+    ThumbnailAtlas reopened;
+    ASSERT_TRUE(reopened.open(path));
+    EXPECT_EQ(reopened.entryCount(), 1u);
+    auto img = reopened.load(1, stamp, 0);
+    ASSERT_TRUE(img.has_value());
+    EXPECT_EQ(img->rgba[0], 3);
+    EXPECT_GT(reopened.deadBytes(), 0u);
+}
+
+TEST_F(ThumbnailCacheTest, Atlas_IgnoresTruncatedTail) {
+    Path path = m_dir / "thumbs.dwtc";
+    ThumbnailStamp stamp{5, 5};
+    u64 goodSize = 0;
+    {
+        ThumbnailAtlas atlas;
+        ASSERT_TRUE(atlas.open(path));
+        ASSERT_TRUE(atlas.store(1, stamp, {solid(16, 16, 1)}));
+        goodSize = atlas.fileBytes();
+    }
+    {
+        std::ofstream f(path, std::ios::binary | std::ios::app);
+        f.write("\x02\x00\x00\x00garbage", 11);
+    }
+
+    ThumbnailAtlas reopened;
+    ASSERT_TRUE(reopened.open(path));
+    EXPECT_EQ(reopened.entryCount(), 1u);
+    EXPECT_EQ(reopened.fileBytes(), goodSize);
+    EXPECT_EQ(std::filesystem::file_size(path), goodSize);
+}
+
+TEST_F(ThumbnailCacheTest, Atlas_CompactReclaimsDeadBytes) {
+    Path path = m_dir / "thumbs.dwtc";
+    ThumbnailStamp stamp{5, 5};
+    ThumbnailAtlas atlas;
+    ASSERT_TRUE(atlas.open(path));
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(atlas.store(1, stamp, {solid(32, 32, static_cast<u8>(i))}));
+    }
+    ASSERT_TRUE(atlas.store(2, stamp, {solid(32, 32, 9)}));
+    u64 before = atlas.fileBytes();
+
+    ASSERT_TRUE(atlas.compact());
+    EXPECT_LT(atlas.fileBytes(), before);
+    EXPECT_EQ(atlas.deadBytes(), 0u);
+
+    auto a = atlas.load(1, stamp, 0);
+    auto b = atlas.load(2, stamp, 0);
+    ASSERT_TRUE(a.has_value());
+    ASSERT_TRUE(b.has_value());
+    EXPECT_EQ(a->rgba[0], 3);
+    EXPECT_EQ(b->rgba[0], 9);
+}
+
+TEST_F(ThumbnailCacheTest, Atlas_CompactsOnOpenWhenMostlyDead) {
+    Path path = m_dir / "thumbs.dwtc";
+    ThumbnailStamp stamp{5, 5};
+    u64 grownSize = 0;
+    {
+        ThumbnailAtlas atlas;
+        ASSERT_TRUE(atlas.open(path));
+        for (u32 i = 0; i < 8; ++i) {
+            ASSERT_TRUE(atlas.store(1, stamp, {noise(64, 64, i)})); // 16 KB each
+        }
+        grownSize = atlas.fileBytes();
+        EXPECT_GT(atlas.deadBytes(), grownSize / 2);
+    }
+
+    ThumbnailAtlas reopened;
+    ASSERT_TRUE(reopened.open(path));
+    EXPECT_EQ(reopened.deadBytes(), 0u);
+    EXPECT_LT(reopened.fileBytes(), grownSize / 4);
+    EXPECT_EQ(std::filesystem::file_size(path), reopened.fileBytes());
+    auto img = reopened.load(1, stamp, 0);
+    ASSERT_TRUE(img.has_value());
+    EXPECT_EQ(img->rgba, noise(64, 64, 7).rgba);
+}
+
+// --- LRU ---
+
+TEST_F(ThumbnailCacheTest, Lru_EvictsLeastRecentlyUsed) {
+    ThumbnailLru lru(2);
+    EXPECT_TRUE(lru.insert(1, {101, 64}).empty());
+    EXPECT_TRUE(lru.insert(2, {102, 64}).empty());
+
+    ASSERT_NE(lru.touch(1), nullptr); // 2 is now the oldest
+    auto evicted = lru.insert(3, {103, 64});
+    ASSERT_EQ(evicted.size(), 1u);
+    EXPECT_EQ(evicted[0], 102u);
+    EXPECT_EQ(lru.peek(2), nullptr);
+    EXPECT_NE(lru.peek(1), nullptr);
+}
+
+TEST_F(ThumbnailCacheTest, Lru_ReplaceReleasesOldHandle) {
+    ThumbnailLru lru(4);
+    (void)lru.insert(1, {101, 64});
+    auto released = lru.insert(1, {201, 128});
+    ASSERT_EQ(released.size(), 1u);
+    EXPECT_EQ(released[0], 101u);
+    EXPECT_EQ(lru.peek(1)->width, 128);
+    EXPECT_EQ(lru.erase(1), 201u);
+    EXPECT_EQ(lru.size(), 0u);
+}
+
+TEST_F(ThumbnailCacheTest, Lru_ShrinkCapacityEvicts) {
+    ThumbnailLru lru(4);
+    for (i64 i = 1; i <= 4; ++i) {
+        (void)lru.insert(i, {static_cast<u32>(100 + i), 64});
+    }
+    auto evicted = lru.setCapacity(2);
+    EXPECT_EQ(evicted.size(), 2u);
+    EXPECT_EQ(lru.size(), 2u);
+    EXPECT_EQ(lru.clear().size(), 2u);
+}
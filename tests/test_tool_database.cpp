@@ -407,6 +407,33 @@ TEST_F(ToolDatabaseTest, Entity_NullMaterialMeansAllMaterials) {
     EXPECT_TRUE(forGeom[0].material_id.empty());
 }
 
+TEST_F(ToolDatabaseTest, Entity_FindGeometryByToolNumber) {
+    dw::VtdbMachine mach; mach.id = "mach-tn"; mach.name = "Router3";
+    EXPECT_TRUE(m_toolDb.insertMachine(mach));
+
+    dw::VtdbToolGeometry geom;
+    geom.id = "geom-tn"; geom.name_format = "VB"; geom.tool_type = dw::VtdbToolType::VBit;
+    geom.diameter = 12.0; geom.included_angle = 60.0;
+    EXPECT_TRUE(m_toolDb.insertGeometry(geom));
+
+    dw::VtdbCuttingData cd;
+    cd.id = "cd-tn"; cd.rate_units = 4; cd.tool_number = 7;
+    EXPECT_TRUE(m_toolDb.insertCuttingData(cd));
+
+    dw::VtdbToolEntity ent;
+    ent.id = "ent-tn";
+    ent.machine_id = "mach-tn";
+    ent.tool_geometry_id = "geom-tn";
+    ent.tool_cutting_data_id = "cd-tn";
+    EXPECT_TRUE(m_toolDb.insertEntity(ent));
+
+    auto found = m_toolDb.findGeometryByToolNumber(7);
+    ASSERT_TRUE(found.has_value());
+    EXPECT_EQ(found->id, "geom-tn");
+    EXPECT_DOUBLE_EQ(found->included_angle, 60.0);
+    EXPECT_FALSE(m_toolDb.findGeometryByToolNumber(8).has_value());
+}
+
 // --- getToolView ---
 
 TEST_F(ToolDatabaseTest, GetToolView_AssemblesAllParts) {
@@ -1,9 +1,12 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <cmath>
+#include <stdexcept>
 
 #include "core/carve/toolpath_generator.h"
 #include "core/cnc/cnc_tool.h"
+#include "core/threading/parallel_for.h"
 
 using namespace dw;
 using namespace dw::carve;
@@ -354,10 +357,9 @@ static IslandResult makeSingleIsland(const Heightmap& hm,
     const Vec3 bmin = hm.boundsMin();
 
     for (int r = r0; r <= r1; ++r) {
-        for (int c = c0; c <= c1; ++c) {
+        for (int c = c0; c <= c1; ++c)
             result.islandMask[r * result.maskCols + c] = 0;
-            island.cells.push_back({c, r});
-        }
+        island.spans.push_back({r, c0, c1 + 1});
     }
 
     island.boundsMin = {bmin.x + static_cast<f32>(c0) * res,
@@ -529,11 +531,11 @@ TEST(ClearingPass, MultipleIslands)
                     (is0.boundsMin.y + is0.boundsMax.y) * 0.5f};
     is0.areaMm2 = 9.0f;
     is0.minClearDiameter = 2.0f;
-    for (int r = 2; r <= 5; ++r)
-        for (int c = 2; c <= 5; ++c) {
+    for (int r = 2; r <= 5; ++r) {
+        for (int c = 2; c <= 5; ++c)
             islands.islandMask[r * islands.maskCols + c] = 0;
-            is0.cells.push_back({c, r});
-        }
+        is0.spans.push_back({r, 2, 6});
+    }
 
     // Island 1: cols 12-16, rows 12-16
     Island is1;
@@ -547,11 +549,11 @@ TEST(ClearingPass, MultipleIslands)
                     (is1.boundsMin.y + is1.boundsMax.y) * 0.5f};
     is1.areaMm2 = 16.0f;
     is1.minClearDiameter = 2.0f;
-    for (int r = 12; r <= 16; ++r)
-        for (int c = 12; c <= 16; ++c) {
+    for (int r = 12; r <= 16; ++r) {
+        for (int c = 12; c <= 16; ++c)
             islands.islandMask[r * islands.maskCols + c] = 1;
-            is1.cells.push_back({c, r});
-        }
+        is1.spans.push_back({r, 12, 17});
+    }
 
     islands.islands.push_back(is0);
     islands.islands.push_back(is1);
@@ -858,3 +860,275 @@ TEST(ToolpathGen, ScanLineCountXThenY)
     // XThenY should have twice the scan lines (symmetric heightmap)
     EXPECT_EQ(xThenY.scanLineCount, xOnly.scanLineCount * 2);
 }
+
+// ---------------------------------------------------------------------------
+// Cached stages
+// ---------------------------------------------------------------------------
+
+// Helper: ramp that slopes along X so tool offsets are non-trivial
+static Heightmap makeRampHeightmap()
+{
+    std::vector<Vertex> verts(4);
+    verts[0].position = {0.0f, 0.0f, 0.0f};
+    verts[1].position = {20.0f, 0.0f, -8.0f};
+    verts[2].position = {20.0f, 20.0f, -8.0f};
+    verts[3].position = {0.0f, 20.0f, 0.0f};
+    std::vector<u32> indices = {0, 1, 2, 0, 2, 3};
+
+    HeightmapConfig cfg;
+    cfg.resolutionMm = 0.5f;
+    cfg.defaultZ = -8.0f;
+
+    Heightmap hm;
+    hm.build(verts, indices, {0.0f, 0.0f, -8.0f}, {20.0f, 20.0f, 0.0f}, cfg);
+    return hm;
+}
+
+static void expectSameToolpath(const Toolpath& a, const Toolpath& b)
+{
+    ASSERT_EQ(a.points.size(), b.points.size());
+    for (size_t i = 0; i < a.points.size(); ++i) {
+        ASSERT_EQ(a.points[i].rapid, b.points[i].rapid) << "point " << i;
+        ASSERT_EQ(a.points[i].position, b.points[i].position) << "point " << i;
+    }
+    EXPECT_EQ(a.scanLineCount, b.scanLineCount);
+    EXPECT_EQ(a.lineCount, b.lineCount);
+    EXPECT_FLOAT_EQ(a.totalDistanceMm, b.totalDistanceMm);
+    EXPECT_FLOAT_EQ(a.estimatedTimeSec, b.estimatedTimeSec);
+}
+
+TEST(ToolpathStages, MatchesFreshGenerationAcrossEdits)
+{
+    Heightmap hm = makeRampHeightmap();
+    const VtdbToolGeometry ball = makeBallNose(3.0);
+
+    ToolpathConfig cfg;
+    cfg.axis = ScanAxis::XOnly;
+    cfg.stepoverPreset = StepoverPreset::Rough;
+
+    ToolpathGenerator gen;
+    ToolpathStages stages;
+    Toolpath staged = gen.generateFinishing(hm, cfg, 3.0f, ball, stages);
+    expectSameToolpath(staged, gen.generateFinishing(hm, cfg, 3.0f, ball));
+    const int firstLines = stages.linesComputed();
+    EXPECT_GT(firstLines, 0);
+    EXPECT_EQ(stages.linesReused(), 0);
+
+    // Feed, safe Z and direction edits reuse every compensated line
+    cfg.feedRateMmMin = 2500.0f;
+    expectSameToolpath(gen.generateFinishing(hm, cfg, 3.0f, ball, stages),
+                       gen.generateFinishing(hm, cfg, 3.0f, ball));
+    cfg.safeZMm = 12.0f;
+    expectSameToolpath(gen.generateFinishing(hm, cfg, 3.0f, ball, stages),
+                       gen.generateFinishing(hm, cfg, 3.0f, ball));
+    cfg.direction = MillDirection::Conventional;
+    expectSameToolpath(gen.generateFinishing(hm, cfg, 3.0f, ball, stages),
+                       gen.generateFinishing(hm, cfg, 3.0f, ball));
+    EXPECT_EQ(stages.linesComputed(), 0);
+    EXPECT_EQ(stages.linesReused(), firstLines);
+
+    // Adding the Y pass only compensates the new lines
+    cfg.axis = ScanAxis::XThenY;
+    expectSameToolpath(gen.generateFinishing(hm, cfg, 3.0f, ball, stages),
+                       gen.generateFinishing(hm, cfg, 3.0f, ball));
+    EXPECT_EQ(stages.linesReused(), firstLines);
+    EXPECT_GT(stages.linesComputed(), 0);
+
+    // Halving the stepover keeps the lines that still fall on the new spacing
+    cfg.axis = ScanAxis::XOnly;
+    cfg.customStepoverPct = 12.5f;
+    expectSameToolpath(gen.generateFinishing(hm, cfg, 3.0f, ball, stages),
+                       gen.generateFinishing(hm, cfg, 3.0f, ball));
+    EXPECT_EQ(stages.linesReused(), firstLines);
+
+    // A different tool recompensates everything
+    const VtdbToolGeometry endMill = makeEndMill(3.0);
+    expectSameToolpath(gen.generateFinishing(hm, cfg, 3.0f, endMill, stages),
+                       gen.generateFinishing(hm, cfg, 3.0f, endMill));
+    EXPECT_EQ(stages.linesReused(), 0);
+}
+
+TEST(ToolpathStages, ClearingFeedChangeKeepsGeometry)
+{
+    Heightmap hm = makeFlatHeightmap(-5.0f, 20.0f, 20.0f, 1.0f);
+    IslandResult islands = makeSingleIsland(hm, 5, 5, 14, 14, -5.0f, -2.0f);
+
+    ToolpathConfig cfg;
+    ToolpathGenerator gen;
+    ToolpathStages stages;
+    Toolpath slow = gen.generateClearing(hm, islands, cfg, 3.0f, stages);
+    ASSERT_FALSE(slow.points.empty());
+
+    cfg.feedRateMmMin *= 2.0f;
+    Toolpath fast = gen.generateClearing(hm, islands, cfg, 3.0f, stages);
+    expectSameToolpath(fast, gen.generateClearing(hm, islands, cfg, 3.0f));
+    EXPECT_LT(fast.estimatedTimeSec, slow.estimatedTimeSec);
+
+    // New islands invalidate the cached geometry
+    IslandResult smaller = makeSingleIsland(hm, 8, 8, 11, 11, -5.0f, -2.0f);
+    stages.clearClearing();
+    expectSameToolpath(gen.generateClearing(hm, smaller, cfg, 3.0f, stages),
+                       gen.generateClearing(hm, smaller, cfg, 3.0f));
+}
+
+// ---------------------------------------------------------------------------
+// Parallel generation
+// ---------------------------------------------------------------------------
+
+TEST(ToolpathGen, ParallelOutputMatchesSingleThread)
+{
+    Heightmap hm = makeRampHeightmap();
+    IslandResult islands = makeSingleIsland(hm, 4, 4, 30, 30, -6.0f, -1.0f);
+
+    ToolpathConfig cfg;
+    cfg.axis = ScanAxis::XThenY;
+    cfg.stepoverPreset = StepoverPreset::Fine;
+
+    ToolpathGenerator gen;
+    dw::setParallelThreadCount(1);
+    Toolpath serialFinish = gen.generateFinishing(hm, cfg, 3.0f, makeBallNose(3.0));
+    Toolpath serialClear = gen.generateClearing(hm, islands, cfg, 2.0f);
+    dw::setParallelThreadCount(4);
+    Toolpath parallelFinish = gen.generateFinishing(hm, cfg, 3.0f, makeBallNose(3.0));
+    Toolpath parallelClear = gen.generateClearing(hm, islands, cfg, 2.0f);
+    dw::setParallelThreadCount(0);
+
+    ASSERT_FALSE(serialClear.points.empty());
+    expectSameToolpath(serialFinish, parallelFinish);
+    expectSameToolpath(serialClear, parallelClear);
+}
+
+TEST(ToolpathGen, ProgressCallbackCancels)
+{
+    Heightmap hm = makeRampHeightmap();
+    ToolpathConfig cfg;
+    cfg.stepoverPreset = StepoverPreset::UltraFine;
+    const VtdbToolGeometry ball = makeBallNose(3.0);
+
+    ToolpathGenerator gen;
+    ToolpathStages stages;
+    f32 lastProgress = 0.0f;
+    gen.setProgressCallback([&](f32 p) {
+        EXPECT_GE(p, lastProgress);
+        lastProgress = p;
+        if (p >= 0.5f) throw std::runtime_error("Cancelled");
+    });
+    EXPECT_THROW(gen.generateFinishing(hm, cfg, 3.0f, ball, stages), std::runtime_error);
+    EXPECT_GE(lastProgress, 0.5f);
+
+    // The interrupted stages recover on the next call
+    gen.setProgressCallback(nullptr);
+    expectSameToolpath(gen.generateFinishing(hm, cfg, 3.0f, ball, stages),
+                       gen.generateFinishing(hm, cfg, 3.0f, ball));
+}
+
+// ---------------------------------------------------------------------------
+// Point decimation
+// ---------------------------------------------------------------------------
+
+// Helper: cut points of each scan line, in emitted order
+static std::vector<std::vector<Vec3>> scanLineCuts(const Toolpath& path)
+{
+    std::vector<std::vector<Vec3>> lines;
+    bool inLine = false;
+    for (const auto& pt : path.points) {
+        if (pt.rapid) {
+            inLine = false;
+            continue;
+        }
+        if (!inLine) lines.emplace_back();
+        lines.back().push_back(pt.position);
+        inLine = true;
+    }
+    return lines;
+}
+
+TEST(Decimation, FlatLinesCollapseToEndpoints)
+{
+    Heightmap hm = makeFlatHeightmap(-1.0f, 10.0f, 10.0f, 0.5f);
+
+    ToolpathConfig cfg;
+    cfg.axis = ScanAxis::XOnly;
+    cfg.customStepoverPct = 50.0f;
+
+    ToolpathGenerator gen;
+    Toolpath uniform = gen.generateFinishing(hm, cfg, 4.0f, defaultTool());
+    EXPECT_GT(uniform.sampledPointCount, 0);
+    EXPECT_EQ(uniform.cutPointCount, uniform.sampledPointCount);
+
+    cfg.toleranceMm = 0.01f;
+    Toolpath decimated = gen.generateFinishing(hm, cfg, 4.0f, defaultTool());
+    EXPECT_EQ(decimated.scanLineCount, uniform.scanLineCount);
+    EXPECT_EQ(decimated.sampledPointCount, uniform.sampledPointCount);
+    EXPECT_EQ(decimated.cutPointCount, 2 * decimated.scanLineCount);
+    EXPECT_LT(decimated.lineCount, uniform.lineCount);
+    EXPECT_NEAR(decimated.totalDistanceMm, uniform.totalDistanceMm, 0.01f);
+}
+
+TEST(Decimation, DeviationStaysWithinTolerance)
+{
+    // Rolling surface with a narrow groove down the middle
+    constexpr int kCells = 80;
+    constexpr f32 kRes = 0.25f;
+    std::vector<f32> grid(static_cast<size_t>(kCells) * kCells);
+    for (int r = 0; r < kCells; ++r) {
+        for (int c = 0; c < kCells; ++c) {
+            const f32 x = (static_cast<f32>(c) + 0.5f) * kRes;
+            const f32 y = (static_cast<f32>(r) + 0.5f) * kRes;
+            const f32 groove = std::abs(x - 10.0f) < 1.0f ? -0.5f * (1.0f - std::abs(x - 10.0f)) : 0.0f;
+            grid[static_cast<size_t>(r) * kCells + c] =
+                std::sin(x * 0.4f) * std::cos(y * 0.3f) - 3.0f + groove;
+        }
+    }
+    Heightmap hm = Heightmap::fromGrid(kCells, kCells, kRes, {0.0f, 0.0f, -5.0f},
+                                       {kCells * kRes, kCells * kRes, -1.0f}, grid);
+
+    ToolpathConfig cfg;
+    cfg.axis = ScanAxis::XThenY;
+    cfg.stepoverPreset = StepoverPreset::Rough;
+    const VtdbToolGeometry ball = makeBallNose(3.0);
+
+    ToolpathGenerator gen;
+    ToolpathStages stages;
+    Toolpath uniform = gen.generateFinishing(hm, cfg, 3.0f, ball, stages);
+
+    constexpr f32 kTolerance = 0.02f;
+    cfg.toleranceMm = kTolerance;
+    Toolpath decimated = gen.generateFinishing(hm, cfg, 3.0f, ball, stages);
+    expectSameToolpath(decimated, gen.generateFinishing(hm, cfg, 3.0f, ball));
+    EXPECT_EQ(stages.linesComputed(), 0);
+    EXPECT_EQ(decimated.sampledPointCount, uniform.cutPointCount);
+    EXPECT_LT(decimated.cutPointCount, uniform.cutPointCount);
+
+    // Every uniform sample lies within tolerance of the decimated polyline
+    const auto uniformLines = scanLineCuts(uniform);
+    const auto decimatedLines = scanLineCuts(decimated);
+    ASSERT_EQ(uniformLines.size(), decimatedLines.size());
+    for (size_t i = 0; i < uniformLines.size(); ++i) {
+        const auto& dense = uniformLines[i];
+        const auto& sparse = decimatedLines[i];
+        ASSERT_GE(sparse.size(), 2u);
+        EXPECT_EQ(sparse.front(), dense.front());
+        EXPECT_EQ(sparse.back(), dense.back());
+        // Scan coordinate: whichever of X/Y varies along the line
+        const bool alongX = dense.front().y == dense.back().y;
+        auto scan = [alongX](const Vec3& p) { return alongX ? p.x : p.y; };
+        size_t seg = 0;
+        for (const auto& p : dense) {
+            auto past = [&](size_t s) {
+                return std::abs(scan(p) - scan(sparse[s])) > std::abs(scan(sparse[s + 1]) - scan(sparse[s]));
+            };
+            while (seg + 2 < sparse.size() && past(seg))
+                ++seg;
+            const Vec3& a = sparse[seg];
+            const Vec3& b = sparse[seg + 1];
+            const f32 t = (scan(p) - scan(a)) / (scan(b) - scan(a));
+            const f32 z = a.z + t * (b.z - a.z);
+            ASSERT_NEAR(p.z, z, kTolerance + 1e-4f) << "line " << i;
+        }
+    }
+
+    // Back to uniform restores the undecimated path
+    cfg.toleranceMm = 0.0f;
+    expectSameToolpath(gen.generateFinishing(hm, cfg, 3.0f, ball, stages), uniform);
+}
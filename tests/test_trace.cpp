@@ -0,0 +1,191 @@
+// Digital Workshop - Tracing Tests
+
+#include <gtest/gtest.h>
+
+#include "core/utils/trace.h"
+
+#include <atomic>
+#include <cstring>
+#include <nlohmann/json.hpp>
+#include <thread>
+
+namespace {
+
+class TraceTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        dw::trace::setEnabled(true);
+        dw::trace::clear();
+    }
+    void TearDown() override {
+        dw::trace::setEnabled(true);
+        dw::trace::clear();
+    }
+
+    static const dw::trace::ThreadTrace* findThread(
+        const std::vector<dw::trace::ThreadTrace>& threads, const std::string& name) {
+        for (const auto& t : threads)
+            if (t.name == name)
+                return &t;
+        return nullptr;
+    }
+
+    static size_t countNamed(const dw::trace::ThreadTrace& thread, const char* name) {
+        size_t n = 0;
+        for (const auto& e : thread.events)
+            if (e.name && std::strcmp(e.name, name) == 0)
+                ++n;
+        return n;
+    }
+};
+
+} // namespace
+
+TEST_F(TraceTest, RecordsNestedZonesAndCounters) {
+    dw::trace::setThreadName("TraceTest main");
+    {
+        DW_TRACE_ZONE("outer");
+        {
+            DW_TRACE_ZONE("inner");
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        DW_TRACE_COUNTER("queued", 7);
+    }
+
+    auto threads = dw::trace::snapshot();
+    const auto* self = findThread(threads, "TraceTest main");
+    ASSERT_NE(self, nullptr);
+    ASSERT_EQ(self->events.size(), 3u);
+
+    // Zones are recorded on close: inner first
+    const auto& inner = self->events[0];
+    const auto& counter = self->events[1];
+    const auto& outer = self->events[2];
+    EXPECT_STREQ(inner.name, "inner");
+    EXPECT_STREQ(outer.name, "outer");
+    EXPECT_GE(inner.durationNs, 2000000u);
+    EXPECT_LE(outer.startNs, inner.startNs);
+    EXPECT_GE(outer.startNs + outer.durationNs, inner.startNs + inner.durationNs);
+    EXPECT_EQ(counter.type, dw::trace::EventType::Counter);
+    EXPECT_DOUBLE_EQ(counter.value, 7.0);
+
+    auto stats = dw::trace::summarize(threads);
+    ASSERT_FALSE(stats.empty());
+    EXPECT_STREQ(stats[0].name, "outer");
+    EXPECT_EQ(stats[0].calls, 1u);
+}
+
+TEST_F(TraceTest, RuntimeSwitchSkipsRecording) {
+    dw::trace::setThreadName("TraceTest disabled");
+    dw::trace::setEnabled(false);
+    {
+        DW_TRACE_ZONE("ignored");
+        DW_TRACE_COUNTER("ignored", 1);
+    }
+    dw::trace::setEnabled(true);
+
+    auto threads = dw::trace::snapshot();
+    const auto* self = findThread(threads, "TraceTest disabled");
+    if (self) {
+        EXPECT_TRUE(self->events.empty());
+    }
+}
+
+TEST_F(TraceTest, RingKeepsNewestEventsWhenFull) {
+    dw::trace::setThreadName("TraceTest ring");
+    const size_t total = dw::trace::kRingCapacity + 100;
+    for (size_t i = 0; i < total; ++i)
+        dw::trace::recordCounter("n", static_cast<double>(i));
+
+    auto threads = dw::trace::snapshot();
+    const auto* self = findThread(threads, "TraceTest ring");
+    ASSERT_NE(self, nullptr);
+    ASSERT_EQ(self->events.size(), dw::trace::kRingCapacity);
+    EXPECT_EQ(self->dropped, 100u);
+    EXPECT_DOUBLE_EQ(self->events.front().value, 100.0);
+    EXPECT_DOUBLE_EQ(self->events.back().value, static_cast<double>(total - 1));
+}
+
+TEST_F(TraceTest, SnapshotWhileWriterLapsRingIsConsistent) {
+    // Each zone's start and duration both encode its index, so a torn copy
+    // or a lapped slot shows up as a mismatch or a gap
+    std::atomic<bool> stop{false};
+    std::thread writer([&stop]() {
+        dw::trace::setThreadName("TraceTest lapping");
+        for (dw::u64 i = 1; !stop.load(std::memory_order_relaxed); ++i)
+            dw::trace::recordZone("lap", i, i * 2);
+    });
+
+    size_t checked = 0;
+    for (int round = 0; round < 200 || checked == 0; ++round) {
+        auto threads = dw::trace::snapshot();
+        const auto* self = findThread(threads, "TraceTest lapping");
+        if (!self || self->events.empty())
+            continue;
+        ASSERT_LE(self->events.size(), dw::trace::kRingCapacity);
+        for (size_t k = 0; k < self->events.size(); ++k) {
+            const auto& e = self->events[k];
+            ASSERT_EQ(e.durationNs, e.startNs);
+            if (k > 0) {
+                ASSERT_EQ(e.startNs, self->events[k - 1].startNs + 1);
+            }
+        }
+        EXPECT_EQ(self->dropped + 1, self->events.front().startNs);
+        ++checked;
+    }
+    stop = true;
+    writer.join();
+}
+
+TEST_F(TraceTest, ThreadsRecordIntoSeparateBuffers) {
+    auto worker = [](const std::string& name, int zones) {
+        dw::trace::setThreadName(name);
+        for (int i = 0; i < zones; ++i) {
+            DW_TRACE_ZONE("work");
+        }
+    };
+    std::thread a(worker, "TraceTest A", 50);
+    std::thread b(worker, "TraceTest B", 70);
+    a.join();
+    b.join();
+
+    auto threads = dw::trace::snapshot();
+    const auto* ta = findThread(threads, "TraceTest A");
+    const auto* tb = findThread(threads, "TraceTest B");
+    ASSERT_NE(ta, nullptr);
+    ASSERT_NE(tb, nullptr);
+    EXPECT_NE(ta->threadId, tb->threadId);
+    EXPECT_EQ(countNamed(*ta, "work"), 50u);
+    EXPECT_EQ(countNamed(*tb, "work"), 70u);
+}
+
+TEST_F(TraceTest, ChromeTraceJsonIsWellFormed) {
+    dw::trace::setThreadName("TraceTest \"json\"");
+    {
+        DW_TRACE_ZONE("zone");
+    }
+    DW_TRACE_COUNTER("count", 3);
+    dw::trace::markFrame();
+    dw::trace::markFrame();
+
+    auto json = nlohmann::json::parse(dw::trace::toChromeTraceJson(dw::trace::snapshot()));
+    ASSERT_TRUE(json.contains("traceEvents"));
+
+    bool sawName = false, sawZone = false, sawCounter = false, sawFrame = false;
+    for (const auto& e : json["traceEvents"]) {
+        std::string ph = e["ph"];
+        if (ph == "M" && e["args"]["name"] == "TraceTest \"json\"")
+            sawName = true;
+        if (ph == "X" && e["name"] == "zone")
+            sawZone = e.contains("dur") && e.contains("ts");
+        if (ph == "C" && e["name"] == "count")
+            sawCounter = e["args"]["value"] == 3.0;
+        if (ph == "X" && e["name"] == "Frame")
+            sawFrame = true;
+    }
+    EXPECT_TRUE(sawName);
+    EXPECT_TRUE(sawZone);
+    EXPECT_TRUE(sawCounter);
+    EXPECT_TRUE(sawFrame);
+    EXPECT_EQ(dw::trace::frameTimes().size(), 1u);
+}
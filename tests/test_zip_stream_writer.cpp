@@ -0,0 +1,155 @@
+// Digital Workshop - Streaming ZIP Writer Tests
+
+#include <gtest/gtest.h>
+
+#include "core/export/zip_stream_writer.h"
+#include "core/mesh/hash.h"
+#include "core/threading/parallel_for.h"
+#include "core/utils/file_utils.h"
+
+#include <filesystem>
+#include <miniz.h>
+#include <string>
+
+namespace {
+
+using dw::ZipStreamWriter;
+
+class ZipStreamWriterTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        m_dir = std::filesystem::temp_directory_path() / "dw_test_zip_stream";
+        std::filesystem::create_directories(m_dir);
+        m_archive = m_dir / "out.zip";
+    }
+
+    void TearDown() override { std::filesystem::remove_all(m_dir); }
+
+    // Compressible text spanning several deflate blocks
+    static std::string gcodeText(size_t minSize) {
+        std::string text;
+        for (int i = 0; text.size() < minSize; ++i) {
+            text += "G1 X" + std::to_string(i % 977) + " Y" + std::to_string(i % 313) +
+                    " F1200\n";
+        }
+        return text;
+    }
+
+    // Incompressible bytes
+    static std::string noise(size_t size) {
+        std::string out(size, '\0');
+        dw::u32 state = 1;
+        for (auto& c : out) {
+            state = state * 1664525u + 1013904223u;
+            c = static_cast<char>(state >> 24);
+        }
+        return out;
+    }
+
+    std::string readEntry(mz_zip_archive& zip, const char* name) {
+        size_t size = 0;
+        void* data = mz_zip_reader_extract_file_to_heap(&zip, name, &size, 0);
+        EXPECT_NE(data, nullptr) << name;
+        if (!data)
+            return {};
+        std::string out(static_cast<const char*>(data), size);
+        mz_free(data);
+        return out;
+    }
+
+    int entryMethod(mz_zip_archive& zip, const char* name) {
+        int index = mz_zip_reader_locate_file(&zip, name, nullptr, 0);
+        EXPECT_GE(index, 0) << name;
+        mz_zip_archive_file_stat stat{};
+        EXPECT_TRUE(mz_zip_reader_file_stat(&zip, static_cast<mz_uint>(index), &stat));
+        return stat.m_method;
+    }
+
+    dw::Path m_dir;
+    dw::Path m_archive;
+};
+
+} // namespace
+
+TEST_F(ZipStreamWriterTest, RoundTripsDeflatedAndStoredEntries) {
+    const std::string text = gcodeText(3 * ZipStreamWriter::kBlockSize + 12345);
+    const std::string blob = noise(ZipStreamWriter::kBlockSize + 7);
+    dw::Path textPath = m_dir / "toolpath.nc";
+    dw::Path blobPath = m_dir / "part.3mf";
+    ASSERT_TRUE(dw::file::writeText(textPath, text));
+    ASSERT_TRUE(dw::file::writeBinary(blobPath, blob.data(), blob.size()));
+
+    ZipStreamWriter writer;
+    ASSERT_TRUE(writer.open(m_archive));
+    ZipStreamWriter::EntryInfo textInfo;
+    ZipStreamWriter::EntryInfo blobInfo;
+    ASSERT_TRUE(writer.addFile("gcode/1.nc", textPath, ZipStreamWriter::Method::Deflate, &textInfo));
+    ASSERT_TRUE(writer.addFile(
+        "models/part.3mf", blobPath, ZipStreamWriter::methodForExtension(".3mf"), &blobInfo));
+    ASSERT_TRUE(writer.addMemory("empty.txt", "", 0, ZipStreamWriter::Method::Deflate));
+    ASSERT_TRUE(writer.addMemory("manifest.json", "{}", 2, ZipStreamWriter::Method::Deflate));
+    ASSERT_TRUE(writer.finalize()) << writer.lastError();
+
+    EXPECT_EQ(textInfo.uncompressedSize, text.size());
+    EXPECT_LT(textInfo.compressedSize * 3, textInfo.uncompressedSize);
+    EXPECT_EQ(blobInfo.compressedSize, blob.size());
+    EXPECT_EQ(textInfo.contentHash,
+              dw::hash::computeBuffer(dw::ByteBuffer(text.begin(), text.end())));
+
+    mz_zip_archive zip{};
+    ASSERT_TRUE(mz_zip_reader_init_file(&zip, m_archive.string().c_str(), 0));
+    EXPECT_EQ(mz_zip_reader_get_num_files(&zip), 4u);
+    EXPECT_EQ(readEntry(zip, "gcode/1.nc"), text);
+    EXPECT_EQ(readEntry(zip, "models/part.3mf"), blob);
+    EXPECT_EQ(readEntry(zip, "empty.txt"), "");
+    EXPECT_EQ(readEntry(zip, "manifest.json"), "{}");
+    EXPECT_EQ(entryMethod(zip, "gcode/1.nc"), MZ_DEFLATED);
+    EXPECT_EQ(entryMethod(zip, "models/part.3mf"), 0);
+    mz_zip_reader_end(&zip);
+}
+
+TEST_F(ZipStreamWriterTest, ExactBlockMultipleAndThreadCountIndependent) {
+    const std::string text = gcodeText(8 * ZipStreamWriter::kBlockSize).substr(
+        0, 2 * ZipStreamWriter::kBlockSize);
+
+    ZipStreamWriter::EntryInfo single;
+    ZipStreamWriter::EntryInfo multi;
+    for (dw::usize threads : {dw::usize{1}, dw::usize{4}}) {
+        dw::setParallelThreadCount(threads);
+        ZipStreamWriter writer;
+        ASSERT_TRUE(writer.open(m_archive));
+        ASSERT_TRUE(writer.addMemory("a.nc",
+                                     text.data(),
+                                     text.size(),
+                                     ZipStreamWriter::Method::Deflate,
+                                     threads == 1 ? &single : &multi));
+        ASSERT_TRUE(writer.finalize());
+    }
+    dw::setParallelThreadCount(0);
+
+    EXPECT_EQ(single.compressedSize, multi.compressedSize);
+    EXPECT_EQ(single.crc32, multi.crc32);
+
+    mz_zip_archive zip{};
+    ASSERT_TRUE(mz_zip_reader_init_file(&zip, m_archive.string().c_str(), 0));
+    EXPECT_EQ(readEntry(zip, "a.nc"), text);
+    mz_zip_reader_end(&zip);
+}
+
+TEST_F(ZipStreamWriterTest, MissingSourceFailsAndDiscardRemovesArchive) {
+    ZipStreamWriter writer;
+    ASSERT_TRUE(writer.open(m_archive));
+    EXPECT_FALSE(
+        writer.addFile("x.stl", m_dir / "does_not_exist.stl", ZipStreamWriter::Method::Deflate));
+    EXPECT_FALSE(writer.lastError().empty());
+    writer.discard();
+    EXPECT_FALSE(std::filesystem::exists(m_archive));
+}
+
+TEST(ZipStreamWriter, PrecompressedExtensions) {
+    EXPECT_TRUE(ZipStreamWriter::isPrecompressed(".3mf"));
+    EXPECT_TRUE(ZipStreamWriter::isPrecompressed(".PNG"));
+    EXPECT_TRUE(ZipStreamWriter::isPrecompressed(".dwmat"));
+    EXPECT_FALSE(ZipStreamWriter::isPrecompressed(".stl"));
+    EXPECT_EQ(ZipStreamWriter::methodForExtension(".obj"), ZipStreamWriter::Method::Deflate);
+}
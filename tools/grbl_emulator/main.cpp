@@ -0,0 +1,106 @@
+// Digital Workshop - GRBL emulator
+//
+// Serves a GRBL 1.1 controller on a pseudo-terminal or a local TCP port so a
+// sender (this app, or any other) can stream against realistic RX-buffer,
+// planner and baud-rate limits without a machine attached.
+//
+//   dw_grbl_emulator [--pty | --tcp PORT] [--baud N] [--time-scale X]
+//
+// Runs until interrupted, then prints the streaming counters.
+
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#include "core/cnc/grbl_emulator.h"
+#include "core/utils/log.h"
+
+namespace {
+
+volatile std::sig_atomic_t g_stop = 0;
+
+void onSignal(int) {
+    g_stop = 1;
+}
+
+void printUsage(const char* argv0) {
+    std::fprintf(stderr,
+                 "usage: %s [--pty | --tcp PORT] [--baud N] [--time-scale X]\n"
+                 "  --pty            serve on a new pseudo-terminal (default)\n"
+                 "  --tcp PORT       serve on 127.0.0.1:PORT (0 picks a free port)\n"
+                 "  --baud N         link speed in baud, 0 for unthrottled (default 115200)\n"
+                 "  --time-scale X   run motion X times faster than real time (default 1)\n",
+                 argv0);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    dw::GrblEmulatorConfig config;
+    bool tcp = false;
+    int port = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(arg, "--pty") == 0) {
+            tcp = false;
+        } else if (std::strcmp(arg, "--tcp") == 0 && hasValue) {
+            tcp = true;
+            port = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--baud") == 0 && hasValue) {
+            config.baudRate = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--time-scale") == 0 && hasValue) {
+            config.timeScale = static_cast<dw::f32>(std::atof(argv[++i]));
+        } else {
+            printUsage(argv[0]);
+            return 2;
+        }
+    }
+    if (config.baudRate < 0 || config.timeScale <= 0.0f) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    dw::log::setLevel(dw::log::Level::Warning);
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    dw::GrblEmulator emulator(config);
+    if (tcp) {
+        const int bound = emulator.listenTcp(port);
+        if (bound == 0)
+            return 1;
+        std::printf("GRBL emulator listening on 127.0.0.1:%d\n", bound);
+    } else {
+        const std::string device = emulator.openPty();
+        if (device.empty())
+            return 1;
+        std::printf("GRBL emulator serving on %s\n", device.c_str());
+    }
+    std::printf("Baud %d, motion x%.1f. Ctrl+C to stop.\n", config.baudRate,
+                static_cast<double>(config.timeScale));
+    std::fflush(stdout);
+
+    while (!g_stop)
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    const auto stats = emulator.stats();
+    emulator.stop();
+
+    std::printf("\nbytes received     %llu (%llu dropped on RX overflow)\n",
+                static_cast<unsigned long long>(stats.bytesReceived),
+                static_cast<unsigned long long>(stats.rxOverflowBytes));
+    std::printf("peak RX used       %zu / %zu\n", stats.peakRxUsed, config.rxBufferSize);
+    std::printf("lines              %llu (%llu ok, %llu error)\n",
+                static_cast<unsigned long long>(stats.linesProcessed),
+                static_cast<unsigned long long>(stats.okCount),
+                static_cast<unsigned long long>(stats.errorCount));
+    std::printf("planner blocks     %llu\n", static_cast<unsigned long long>(stats.blocksPlanned));
+    std::printf("motion time        %.3f s\n", stats.motionSeconds);
+    std::printf("planner starved    %.3f s over %u gaps\n", stats.starvedSeconds, stats.starvations);
+    return 0;
+}